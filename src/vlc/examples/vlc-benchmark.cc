@@ -0,0 +1,398 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+
+// This program benchmarks the VLC MAC and PHY.  One run simulates a star,
+// a grid or a mobile topology with saturated or Poisson traffic, and
+// prints one CSV line with:
+//
+//  - the wall clock time, in total and per simulated second,
+//  - the number of simulator events processed and the events per second,
+//  - the frames sent and delivered and the delivered frames per CPU second,
+//  - the peak resident set size (RSS) of the process, and the growth of the
+//    peak RSS from before the nodes are built, in total and per node.
+//
+// With --matrix, every combination of the three topologies, the two
+// traffic models and 10, 100, 1000 and 10000 nodes (up to --maxNodes) is
+// run, each one in its own process so that the peak resident set size is
+// not inherited from the previous run.  Where the build found no fork ()
+// (VLC_SWEEP_FORK undefined), the matrix runs in one process instead, and
+// the RSS growth of a run only counts what exceeds the peaks of the
+// previous runs.  Every frame reaches every node of
+// the channel, so the cost of a simulated second grows with the square of
+// the node count; the matrix therefore simulates 10 / nodes seconds per
+// run (at most --duration), and stops at 1000 nodes unless --maxNodes is
+// raised.  The nodes share a VlcSpectrumChannel with the Lambertian line
+// of sight loss model, as created by VlcHelper; --channel=single runs them
+// on a SingleModelSpectrumChannel instead, and the culling of the
+// VlcSpectrumChannel is configured with its attributes, e.g.
+// --ns3::VlcSpectrumChannel::MaxRange=20.  The output is meant to be
+// stored and compared across commits, e.g.
+//
+//   ./waf --run "vlc-benchmark --matrix" > vlc-benchmark-$(git rev-parse --short HEAD).csv
+#include <ns3/log.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/map-scheduler.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/random-walk-2d-mobility-model.h>
+#include <ns3/packet.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#ifdef VLC_SWEEP_FORK
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("VlcBenchmark");
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * \brief a map scheduler counting the events it hands to the simulator
+ */
+class VlcBenchmarkScheduler : public MapScheduler
+{
+public:
+  /**
+   * Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual Scheduler::Event RemoveNext (void);
+
+  static uint64_t g_events; //!< the number of events processed
+};
+
+NS_OBJECT_ENSURE_REGISTERED (VlcBenchmarkScheduler);
+
+uint64_t VlcBenchmarkScheduler::g_events = 0;
+
+TypeId
+VlcBenchmarkScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcBenchmarkScheduler")
+    .SetParent<MapScheduler> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcBenchmarkScheduler> ()
+  ;
+  return tid;
+}
+
+Scheduler::Event
+VlcBenchmarkScheduler::RemoveNext (void)
+{
+  g_events++;
+  return MapScheduler::RemoveNext ();
+}
+
+} // namespace ns3
+
+static uint32_t g_packetSize = 50;
+static double g_rate = 100;
+static std::string g_channel = "vlc";
+static uint64_t g_sent = 0;
+static uint64_t g_delivered = 0;
+static Ptr<ExponentialRandomVariable> g_interval;
+
+static void
+DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  g_delivered++;
+}
+
+/**
+ * Hand a frame to the MAC.
+ * \param mac the MAC of the sender
+ * \param dst the destination
+ */
+static void
+SendFrame (Ptr<VlcMac> mac, Mac16Address dst)
+{
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = dst;
+  params.m_msduHandle = static_cast<uint8_t> (g_sent);
+  params.m_txOptions = 0;
+  g_sent++;
+  mac->McpsDataRequest (params, Create<Packet> (g_packetSize));
+}
+
+/**
+ * Saturated traffic: send the next frame as soon as the previous one is
+ * confirmed, whatever its status.
+ * \param mac the MAC of the sender
+ * \param dst the destination
+ * \param params the confirm parameters
+ */
+static void
+SaturatedConfirm (Ptr<VlcMac> mac, Mac16Address dst, McpsDataConfirmParams params)
+{
+  SendFrame (mac, dst);
+}
+
+/**
+ * Poisson traffic: send a frame and schedule the next one.
+ * \param mac the MAC of the sender
+ * \param dst the destination
+ */
+static void
+PoissonSend (Ptr<VlcMac> mac, Mac16Address dst)
+{
+  SendFrame (mac, dst);
+  Simulator::Schedule (Seconds (g_interval->GetValue ()), &PoissonSend, mac, dst);
+}
+
+/**
+ * Make the short address of a node.
+ * \param i the index of the node
+ * \return the short address
+ */
+static Mac16Address
+MakeAddress (uint32_t i)
+{
+  uint8_t address[2] = {static_cast<uint8_t> ((i + 1) >> 8), static_cast<uint8_t> (i + 1)};
+  Mac16Address shortAddress;
+  shortAddress.CopyFrom (address);
+  return shortAddress;
+}
+
+/**
+ * Build and run one configuration and print its CSV line.
+ * \param topology star, grid or mobile
+ * \param traffic saturated or poisson
+ * \param nNodes the number of nodes
+ * \param duration the simulated time (s)
+ */
+static void
+RunBenchmark (std::string topology, std::string traffic, uint32_t nNodes, double duration)
+{
+  NS_ABORT_MSG_IF (topology != "star" && topology != "grid" && topology != "mobile",
+                   "Unknown topology " << topology);
+  NS_ABORT_MSG_IF (traffic != "saturated" && traffic != "poisson",
+                   "Unknown traffic " << traffic);
+  NS_ABORT_MSG_IF (nNodes < 2, "At least two nodes are needed");
+  NS_ABORT_MSG_IF (g_channel != "vlc" && g_channel != "single",
+                   "Unknown channel " << g_channel);
+
+  ObjectFactory scheduler;
+  scheduler.SetTypeId (VlcBenchmarkScheduler::GetTypeId ());
+  Simulator::SetScheduler (scheduler);
+  VlcBenchmarkScheduler::g_events = 0;
+  g_sent = 0;
+  g_delivered = 0;
+  g_interval = CreateObject<ExponentialRandomVariable> ();
+  g_interval->SetAttribute ("Mean", DoubleValue (1 / g_rate));
+
+  // The peak RSS so far: the libraries, the process image and, without
+  // fork (), the previous runs.
+  struct rusage baseline;
+  getrusage (RUSAGE_SELF, &baseline);
+
+  Ptr<SpectrumChannel> channel;
+  if (g_channel == "vlc")
+    {
+      channel = CreateObject<VlcSpectrumChannel> ();
+    }
+  else
+    {
+      channel = CreateObject<SingleModelSpectrumChannel> ();
+    }
+  channel->AddPropagationLossModel (CreateObject<VlcLambertianPropagationLossModel> ());
+
+  // Star: a coordinator with the other nodes on a 5 m circle around it,
+  // all sending to the coordinator.  Grid: nodes 2 m apart, each sending
+  // to its neighbour in the same row.  Mobile: the grid area with random
+  // walking nodes sending to a coordinator in the middle.
+  uint32_t side = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (nNodes))));
+  double spacing = 2;
+  double half = side * spacing / 2;
+  Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable> ();
+  position->SetAttribute ("Min", DoubleValue (-half));
+  position->SetAttribute ("Max", DoubleValue (half));
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  start->SetAttribute ("Max", DoubleValue (0.01));
+
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Node> node = CreateObject <Node> ();
+      Ptr<VlcNetDevice> dev = CreateObject<VlcNetDevice> ();
+      dev->SetAddress (MakeAddress (i));
+      dev->SetChannel (channel);
+      node->AddDevice (dev);
+      nodes.push_back (node);
+
+      Ptr<MobilityModel> mobility;
+      Mac16Address dst = MakeAddress (0);
+      if (topology == "star")
+        {
+          double angle = 2 * M_PI * i / (nNodes - 1);
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (i == 0 ? Vector (0, 0, 0) : Vector (5 * std::cos (angle), 5 * std::sin (angle), 0));
+        }
+      else if (topology == "grid")
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector ((i % side) * spacing - half, (i / side) * spacing - half, 0));
+          uint32_t neighbour = (i % side == side - 1 || i + 1 == nNodes) ? i - 1 : i + 1;
+          dst = MakeAddress (neighbour);
+        }
+      else
+        {
+          Ptr<RandomWalk2dMobilityModel> walk = CreateObject<RandomWalk2dMobilityModel> ();
+          walk->SetAttribute ("Bounds", RectangleValue (Rectangle (-half, half, -half, half)));
+          walk->SetAttribute ("Speed", StringValue ("ns3::ConstantRandomVariable[Constant=1.4]"));
+          walk->SetPosition (i == 0 ? Vector (0, 0, 0) : Vector (position->GetValue (), position->GetValue (), 0));
+          mobility = walk;
+        }
+      node->AggregateObject (mobility);
+      dev->GetPhy ()->SetMobility (mobility);
+      dev->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&DataIndication));
+
+      // In the star and mobile topologies the coordinator only receives.
+      if (topology != "grid" && i == 0)
+        {
+          continue;
+        }
+      if (traffic == "saturated")
+        {
+          dev->GetMac ()->SetMcpsDataConfirmCallback (MakeBoundCallback (&SaturatedConfirm, dev->GetMac (), dst));
+          Simulator::Schedule (Seconds (start->GetValue ()), &SendFrame, dev->GetMac (), dst);
+        }
+      else
+        {
+          Simulator::Schedule (Seconds (g_interval->GetValue ()), &PoissonSend, dev->GetMac (), dst);
+        }
+    }
+
+  Simulator::Stop (Seconds (duration));
+
+  struct rusage before;
+  getrusage (RUSAGE_SELF, &before);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t wallMs = clock.End ();
+  struct rusage after;
+  getrusage (RUSAGE_SELF, &after);
+
+  double cpu = (after.ru_utime.tv_sec - before.ru_utime.tv_sec)
+    + (after.ru_stime.tv_sec - before.ru_stime.tv_sec)
+    + ((after.ru_utime.tv_usec - before.ru_utime.tv_usec)
+       + (after.ru_stime.tv_usec - before.ru_stime.tv_usec)) / 1e6;
+  // ru_maxrss is in kilobytes on Linux.
+  long peakRssKb = after.ru_maxrss;
+  long nodesRssKb = after.ru_maxrss - baseline.ru_maxrss;
+
+  std::cout << topology << "," << traffic << "," << g_channel << "," << nNodes << "," << duration
+            << "," << wallMs
+            << "," << wallMs / duration
+            << "," << VlcBenchmarkScheduler::g_events
+            << "," << static_cast<uint64_t> (VlcBenchmarkScheduler::g_events * 1000.0 / std::max<int64_t> (wallMs, 1))
+            << "," << g_sent
+            << "," << g_delivered
+            << "," << g_delivered / std::max (cpu, 1e-3)
+            << "," << peakRssKb
+            << "," << nodesRssKb
+            << "," << static_cast<double> (nodesRssKb) / nNodes
+            << std::endl;
+
+  Simulator::Destroy ();
+  g_interval = 0;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string topology = "star";
+  std::string traffic = "saturated";
+  uint32_t nNodes = 10;
+  double duration = 1;
+  bool header = true;
+  bool matrix = false;
+  uint32_t maxNodes = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("topology", "star, grid or mobile", topology);
+  cmd.AddValue ("traffic", "saturated or poisson", traffic);
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("duration", "simulated time (s)", duration);
+  cmd.AddValue ("channel", "vlc (VlcSpectrumChannel) or single (SingleModelSpectrumChannel)", g_channel);
+  cmd.AddValue ("rate", "Poisson traffic rate per node (frames/s)", g_rate);
+  cmd.AddValue ("packetSize", "packet (MSDU) size (bytes)", g_packetSize);
+  cmd.AddValue ("header", "print the CSV header", header);
+  cmd.AddValue ("matrix", "run every topology, traffic and node count", matrix);
+  cmd.AddValue ("maxNodes", "largest node count of the matrix", maxNodes);
+  cmd.Parse (argc, argv);
+
+  if (header)
+    {
+      std::cout << "topology,traffic,channel,nodes,duration_s,wall_ms,wall_ms_per_sim_s,events,events_per_s,"
+                << "frames_sent,frames_delivered,delivered_per_cpu_s,peak_rss_kb,nodes_rss_kb,nodes_rss_kb_per_node"
+                << std::endl;
+    }
+
+  if (!matrix)
+    {
+      RunBenchmark (topology, traffic, nNodes, duration);
+      return 0;
+    }
+
+  const char *topologies[] = { "star", "grid", "mobile" };
+  const char *traffics[] = { "saturated", "poisson" };
+  for (uint32_t n = 10; n <= maxNodes; n *= 10)
+    {
+      for (uint32_t t = 0; t < 3; t++)
+        {
+          for (uint32_t k = 0; k < 2; k++)
+            {
+#ifdef VLC_SWEEP_FORK
+              // One process per run, one run at a time, so that neither the
+              // peak RSS nor the timings are disturbed by another run.
+              std::cout.flush ();
+              pid_t pid = fork ();
+              NS_ABORT_MSG_IF (pid < 0, "fork () failed");
+              if (pid == 0)
+                {
+                  RunBenchmark (topologies[t], traffics[k], n, std::min (duration, 10.0 / n));
+                  std::cout.flush ();
+                  _exit (0);
+                }
+              int status;
+              waitpid (pid, &status, 0);
+              NS_ABORT_MSG_IF (!WIFEXITED (status) || WEXITSTATUS (status) != 0,
+                               "Benchmark " << topologies[t] << " " << traffics[k] << " " << n << " failed");
+#else
+              RunBenchmark (topologies[t], traffics[k], n, std::min (duration, 10.0 / n));
+#endif
+            }
+        }
+    }
+
+  return 0;
+}
@@ -98,8 +98,7 @@ int main (int argc, char *argv[])
   // Each device must be attached to the same channel
   Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
 
-  //TODO : CHECK
-  Ptr<LogDistancePropagationLossModel> propModel = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<VlcLambertianPropagationLossModel> propModel = CreateObject<VlcLambertianPropagationLossModel> ();
 
   Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
   channel->AddPropagationLossModel (propModel);
@@ -18,23 +18,37 @@
 
 // This program produces a gnuplot file that plots the packet success rate
 // as a function of distance for the 802.15.7 models, assuming a default
-// LogDistance propagation loss model, the 15MHz OOK error model, a
+// Lambertian line of sight propagation loss model, the 15MHz OOK error model, a
 // default transmit power of 0 dBm, and a default packet size of 20 bytes of
 // 802.15.4 payload.
-#include <ns3/test.h>
+//
+// Every distance is simulated once per RNG run, and the (distance, run)
+// pairs are spread over a pool of worker processes by VlcSweepHelper.  The
+// plot shows the mean packet success rate with its 95% confidence
+// interval; the same results are written to 802.15.7-psr-distance.csv.
+//
+// With --linkBudget, the frames are not simulated: VlcLinkBudget draws the
+// reception of every frame from the packet success rate of the link, which
+// gives the same distribution of the number of frames received as the
+// simulation of this interference-free link, without running the
+// simulator.
 #include <ns3/log.h>
 #include <ns3/callback.h>
 #include <ns3/packet.h>
 #include <ns3/simulator.h>
 #include <ns3/vlc-error-model.h>
-#include <ns3/propagation-loss-model.h>
+#include <ns3/vlc-link-budget.h>
+#include <ns3/vlc-receiver-noise-model.h>
+#include <ns3/vlc-lambertian-propagation-loss-model.h>
 #include <ns3/vlc-net-device.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/vlc-spectrum-value-helper.h>
+#include <ns3/vlc-sweep-helper.h>
 #include <ns3/vlc-mac.h>
+#include <ns3/vlc-mac-header.h>
+#include <ns3/vlc-mac-trailer.h>
 #include <ns3/node.h>
 #include <ns3/net-device.h>
-#include <ns3/single-model-spectrum-channel.h>
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/mac16-address.h>
 #include <ns3/constant-position-mobility-model.h>
@@ -52,43 +66,31 @@
 using namespace ns3;
 using namespace std;
 
-static uint32_t g_received = 0;
-
 NS_LOG_COMPONENT_DEFINE ("VlcErrorDistancePlot");
 
+static int g_maxPackets = 1000;
+static int g_packetSize = 20;
+static double g_txPower = 0;
+static uint32_t g_channelNumber = 1;
+static bool g_linkBudget = false;
+static bool g_noise = false;
+
 static void
-VlcErrorDistanceCallback (McpsDataIndicationParams params, Ptr<Packet> p)
+VlcErrorDistanceCallback (uint32_t *received, McpsDataIndicationParams params, Ptr<Packet> p)
 {
-  g_received++;
+  (*received)++;
 }
 
-int main (int argc, char *argv[])
+/**
+ * Simulate one distance for one run.
+ * \param distance the distance between the two devices (m)
+ * \param run the RNG run number
+ * \return the packet success rate
+ */
+static double
+VlcErrorDistanceTrial (double distance, uint32_t run)
 {
-  std::ostringstream os;
-  std::ofstream berfile ("802.15.7-psr-distance.plt");
-
-  int minDistance = 1;
-  //int maxDistance = 200;  // meters
-  int maxDistance = 2;
-  int increment = 1;
-  int maxPackets = 1000;
-  int packetSize = 20;
-  double txPower = 0;
-  // uint32_t channelNumber = 11;
-  uint32_t channelNumber = 1;
-
-  CommandLine cmd;
-
-  cmd.AddValue ("txPower", "transmit power (dBm)", txPower);
-  cmd.AddValue ("packetSize", "packet (MSDU) size (bytes)", packetSize);
-  cmd.AddValue ("channelNumber", "channel number", channelNumber);
-
-  cmd.Parse (argc, argv);
-
-  os << "Packet (MSDU) size = " << packetSize << " bytes; tx power = " << txPower << " dBm; channel = " << channelNumber;
-
-  Gnuplot psrplot = Gnuplot ("802.15.7-psr-distance.eps");
-  Gnuplot2dDataset psrdataset ("802.15.7-psr-vs-distance");
+  uint32_t received = 0;
 
   Ptr<Node> n0 = CreateObject <Node> ();
   Ptr<Node> n1 = CreateObject <Node> ();
@@ -97,7 +99,7 @@ int main (int argc, char *argv[])
   dev0->SetAddress (Mac16Address ("00:01"));
   dev1->SetAddress (Mac16Address ("00:02"));
   Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
-  Ptr<LogDistancePropagationLossModel> model = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<VlcLambertianPropagationLossModel> model = CreateObject<VlcLambertianPropagationLossModel> ();
   channel->AddPropagationLossModel (model);
   dev0->SetChannel (channel);
   dev1->SetChannel (channel);
@@ -109,11 +111,15 @@ int main (int argc, char *argv[])
   dev1->GetPhy ()->SetMobility (mob1);
 
   VlcSpectrumValueHelper svh;
-  Ptr<SpectrumValue> psd = svh.CreateTxPowerSpectralDensity (txPower, channelNumber);
+  Ptr<SpectrumValue> psd = svh.CreateTxPowerSpectralDensity (g_txPower, g_channelNumber);
   dev0->GetPhy ()->SetTxPowerSpectralDensity (psd);
+  if (g_noise)
+    {
+      dev1->GetPhy ()->SetNoiseModel (CreateObject<VlcReceiverNoiseModel> ());
+    }
 
   McpsDataIndicationCallback cb0;
-  cb0 = MakeCallback (&VlcErrorDistanceCallback);
+  cb0 = MakeBoundCallback (&VlcErrorDistanceCallback, &received);
   dev1->GetMac ()->SetMcpsDataIndicationCallback (cb0);
 
   McpsDataRequestParams params;
@@ -124,27 +130,81 @@ int main (int argc, char *argv[])
   params.m_msduHandle = 0;
   params.m_txOptions = 0;
 
-  Ptr<Packet> p;
   mob0->SetPosition (Vector (0,0,0));
-  mob1->SetPosition (Vector (minDistance,0,0));
-  for (int j = minDistance; j < maxDistance;  )
+  mob1->SetPosition (Vector (distance,0,0));
+  if (g_linkBudget)
+    {
+      // The PSDU is the MSDU in a data frame with short addresses.
+      VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_DATA, 0);
+      macHdr.SetSrcAddrMode (params.m_srcAddrMode);
+      macHdr.SetSrcAddrFields (0, Mac16Address ("00:01"));
+      macHdr.SetDstAddrMode (params.m_dstAddrMode);
+      macHdr.SetDstAddrFields (params.m_dstVpanId, params.m_dstAddr);
+      uint32_t psduSize = macHdr.GetSerializedSize () + g_packetSize + VlcMacTrailer ().GetSerializedSize ();
+
+      Ptr<VlcLinkBudget> budget = CreateObject<VlcLinkBudget> ();
+      budget->SetPropagationLossModel (model);
+      received = budget->GetReceivedFrames (dev0->GetPhy (), dev1->GetPhy (), psduSize, g_maxPackets);
+      Simulator::Destroy ();
+      return received / static_cast<double> (g_maxPackets);
+    }
+
+  for (int i = 0; i < g_maxPackets; i++)
     {
-      for (int i = 0; i < maxPackets; i++)
-        {
-          p = Create<Packet> (packetSize);
-          Simulator::Schedule (Seconds (i),
-                               &VlcMac::McpsDataRequest,
-                               dev0->GetMac (), params, p);
-        }
-      Simulator::Run ();
-      NS_LOG_DEBUG ("Received " << g_received << " packets for distance " << j);
-      psrdataset.Add (j, g_received / 1000.0);
-      g_received = 0;
-      j += increment;
-      mob1->SetPosition (Vector (j,0,0));
+      Ptr<Packet> p = Create<Packet> (g_packetSize);
+      Simulator::Schedule (Seconds (i),
+                           &VlcMac::McpsDataRequest,
+                           dev0->GetMac (), params, p);
     }
+  Simulator::Run ();
+  NS_LOG_DEBUG ("Received " << received << " packets for distance " << distance << " run " << run);
+  Simulator::Destroy ();
+
+  return received / static_cast<double> (g_maxPackets);
+}
+
+int main (int argc, char *argv[])
+{
+  std::ostringstream os;
+  std::ofstream berfile ("802.15.7-psr-distance.plt");
+  std::ofstream csvfile ("802.15.7-psr-distance.csv");
 
-  psrplot.AddDataset (psrdataset);
+  double minDistance = 1;
+  //double maxDistance = 200;  // meters
+  double maxDistance = 2;
+  double increment = 1;
+  uint32_t runs = 5;
+  uint32_t workers = 0;
+
+  CommandLine cmd;
+
+  cmd.AddValue ("txPower", "transmit power (dBm)", g_txPower);
+  cmd.AddValue ("packetSize", "packet (MSDU) size (bytes)", g_packetSize);
+  cmd.AddValue ("channelNumber", "channel number", g_channelNumber);
+  cmd.AddValue ("maxPackets", "packets sent per distance and run", g_maxPackets);
+  cmd.AddValue ("minDistance", "first distance (m)", minDistance);
+  cmd.AddValue ("maxDistance", "last distance (m)", maxDistance);
+  cmd.AddValue ("increment", "distance increment (m)", increment);
+  cmd.AddValue ("runs", "RNG runs per distance", runs);
+  cmd.AddValue ("workers", "worker processes, 0 for one per processor", workers);
+  cmd.AddValue ("noise", "add the default photodiode noise to the receiver", g_noise);
+  cmd.AddValue ("linkBudget", "draw the frames from the link budget instead of simulating them", g_linkBudget);
+
+  cmd.Parse (argc, argv);
+
+  os << "Packet (MSDU) size = " << g_packetSize << " bytes; tx power = " << g_txPower << " dBm; channel = " << g_channelNumber;
+
+  VlcSweepHelper sweep;
+  sweep.SetTrialCallback (MakeCallback (&VlcErrorDistanceTrial));
+  sweep.SetWorkers (workers);
+  sweep.SetRuns (1, runs);
+  sweep.AddPoints (minDistance, maxDistance, increment);
+  sweep.Run ();
+  sweep.WriteCsv (csvfile);
+  csvfile.close ();
+
+  Gnuplot psrplot = Gnuplot ("802.15.7-psr-distance.eps");
+  psrplot.AddDataset (sweep.GetDataset ("802.15.7-psr-vs-distance"));
 
   psrplot.SetTitle (os.str ());
   psrplot.SetTerminal ("postscript eps color enh \"Times-BoldItalic\"");
@@ -157,6 +217,5 @@ set style increment user");
   psrplot.GenerateOutput (berfile);
   berfile.close ();
 
-  Simulator::Destroy ();
   return 0;
 }
@@ -24,6 +24,7 @@
 #include <ns3/command-line.h>
 #include <ns3/gnuplot.h>
 #include <ns3/vlc-error-model.h>
+#include <ns3/vlc-sweep-helper.h>
 
 #include <fstream>
 #include <iostream>
@@ -35,29 +36,61 @@ using namespace std;
 
 NS_LOG_COMPONENT_DEFINE ("VlcErrorModelPlot");
 
+/**
+ * Compute the bit error rate of one modulation at one SNR.
+ * \param modulation the modulation
+ * \param snr the SNR (dB)
+ * \param run the RNG run number, unused since the BER is analytic
+ * \return the bit error rate
+ */
+static double
+VlcErrorModelTrial (VlcModulation modulation, double snr, uint32_t run)
+{
+  Ptr<VlcErrorModel> vlcError = CreateObject<VlcErrorModel> ();
+  vlcError->SetModulation (modulation);
+  double ber = 1.0 - vlcError->GetChunkSuccessRate (pow (10.0,snr / 10.0), 1);
+  NS_LOG_DEBUG (snr << "(dB) " << ber << " (" << (modulation == VLC_MODULATION_OOK ? "OOK" : "VPPM") << " BER)");
+  return ber;
+}
+
 //
-// Plot 802.15.4 BER curve (compare against Figure E.2 of IEEE-802.15.4-2006)
+// Plot the 802.15.7 OOK and VPPM BER curves
 //
 int main (int argc, char *argv[])
 {
   std::ofstream berfile ("802.15.7-ber.plt");
-  Ptr<VlcErrorModel>  vlcError = CreateObject<VlcErrorModel> ();
 
   double increment = 0.1;
   double minSnr = -10;  //dB
-  double maxSnr = 5;
+  double maxSnr = 15;
+  uint32_t workers = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("workers", "worker processes, 0 for one per processor", workers);
+  cmd.Parse (argc, argv);
 
   Gnuplot berplot = Gnuplot ("802.15.7-ber.eps");
-  Gnuplot2dDataset berdataset ("802.15.7");
 
-  for (double snr = minSnr; snr <= maxSnr; snr += increment)
-    {
-      double ber = 1.0 - vlcError->GetChunkSuccessRate (pow (10.0,snr / 10.0), 1);
-      NS_LOG_DEBUG (snr << "(dB) " << ber << " (BER)");
-      berdataset.Add (snr, ber);
-    }
+  VlcSweepHelper ook;
+  ook.SetTrialCallback (MakeBoundCallback (&VlcErrorModelTrial, VLC_MODULATION_OOK));
+  ook.SetWorkers (workers);
+  ook.AddPoints (minSnr, maxSnr, increment);
+  ook.Run ();
+  Gnuplot2dDataset ookdataset = ook.GetDataset ("802.15.7 OOK 8B10B");
+  ookdataset.SetErrorBars (Gnuplot2dDataset::NONE);
+  ookdataset.SetStyle (Gnuplot2dDataset::LINES);
+
+  VlcSweepHelper vppm;
+  vppm.SetTrialCallback (MakeBoundCallback (&VlcErrorModelTrial, VLC_MODULATION_VPPM));
+  vppm.SetWorkers (workers);
+  vppm.AddPoints (minSnr, maxSnr, increment);
+  vppm.Run ();
+  Gnuplot2dDataset vppmdataset = vppm.GetDataset ("802.15.7 VPPM 4B6B");
+  vppmdataset.SetErrorBars (Gnuplot2dDataset::NONE);
+  vppmdataset.SetStyle (Gnuplot2dDataset::LINES);
 
-  berplot.AddDataset (berdataset);
+  berplot.AddDataset (ookdataset);
+  berplot.AddDataset (vppmdataset);
 
   berplot.SetTerminal ("postscript eps color enh \"Times-BoldItalic\"");
   berplot.SetLegend ("SNR (dB)", "Bit Error Rate (BER)");
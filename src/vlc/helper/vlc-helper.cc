@@ -19,7 +19,11 @@
 #include "vlc-helper.h"
 #include <ns3/vlc-csmaca.h>
 #include <ns3/vlc-error-model.h>
+#include <ns3/vlc-lambertian-propagation-loss-model.h>
+#include <ns3/vlc-spectrum-channel.h>
 #include <ns3/vlc-net-device.h>
+#include <ns3/vlc-handover-manager.h>
+#include <ns3/vlc-receiver-noise-model.h>
 #include <ns3/mobility-model.h>
 #include <ns3/single-model-spectrum-channel.h>
 #include <ns3/multi-model-spectrum-channel.h>
@@ -62,13 +66,16 @@ AsciiVlcMacTransmitSinkWithoutContext (
 
 VlcHelper::VlcHelper (void)
 {
-  m_channel = CreateObject<SingleModelSpectrumChannel> ();
+  m_channel = CreateObject<VlcSpectrumChannel> ();
 
-  Ptr<LogDistancePropagationLossModel> lossModel = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<VlcLambertianPropagationLossModel> lossModel = CreateObject<VlcLambertianPropagationLossModel> ();
   m_channel->AddPropagationLossModel (lossModel);
 
   Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
   m_channel->SetPropagationDelayModel (delayModel);
+
+  m_handoverManagerFactory.SetTypeId ("ns3::VlcHandoverManager");
+  m_noiseModelFactory.SetTypeId ("ns3::VlcReceiverNoiseModel");
 }
 
 VlcHelper::VlcHelper (bool useMultiModelSpectrumChannel)
@@ -81,11 +88,14 @@ VlcHelper::VlcHelper (bool useMultiModelSpectrumChannel)
     {
       m_channel = CreateObject<SingleModelSpectrumChannel> ();
     }
-  Ptr<LogDistancePropagationLossModel> lossModel = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<VlcLambertianPropagationLossModel> lossModel = CreateObject<VlcLambertianPropagationLossModel> ();
   m_channel->AddPropagationLossModel (lossModel);
 
   Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
   m_channel->SetPropagationDelayModel (delayModel);
+
+  m_handoverManagerFactory.SetTypeId ("ns3::VlcHandoverManager");
+  m_noiseModelFactory.SetTypeId ("ns3::VlcReceiverNoiseModel");
 }
 
 VlcHelper::~VlcHelper (void)
@@ -252,6 +262,83 @@ VlcHelper::AssociateToVpan (NetDeviceContainer c, uint16_t vpanId)
   return;
 }
 
+void
+VlcHelper::SetSixLowPanAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_sixLowPanHelper.SetDeviceAttribute (n1, v1);
+}
+
+NetDeviceContainer
+VlcHelper::InstallSixLowPan (NetDeviceContainer c)
+{
+  NetDeviceContainer vlcDevices;
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); i++)
+    {
+      NS_ASSERT_MSG (DynamicCast<VlcNetDevice> (*i), "6LoWPAN stacked on a device other than a VlcNetDevice");
+      vlcDevices.Add (*i);
+    }
+  return m_sixLowPanHelper.Install (vlcDevices);
+}
+
+void
+VlcHelper::SetHandoverManagerAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_handoverManagerFactory.Set (n1, v1);
+}
+
+void
+VlcHelper::InstallHandoverManager (NetDeviceContainer c)
+{
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); i++)
+    {
+      Ptr<VlcNetDevice> device = DynamicCast<VlcNetDevice> (*i);
+      NS_ASSERT_MSG (device, "Handover manager on a device other than a VlcNetDevice");
+      Ptr<VlcHandoverManager> manager = m_handoverManagerFactory.Create<VlcHandoverManager> ();
+      manager->SetMac (device->GetMac ());
+      device->AggregateObject (manager);
+    }
+}
+
+void
+VlcHelper::SetReceiverNoiseModelAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_noiseModelFactory.Set (n1, v1);
+}
+
+void
+VlcHelper::InstallReceiverNoiseModel (NetDeviceContainer c)
+{
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); i++)
+    {
+      Ptr<VlcNetDevice> device = DynamicCast<VlcNetDevice> (*i);
+      NS_ASSERT_MSG (device, "Receiver noise model on a device other than a VlcNetDevice");
+      device->GetPhy ()->SetNoiseModel (m_noiseModelFactory.Create<VlcReceiverNoiseModel> ());
+    }
+}
+
+NetDeviceContainer
+VlcHelper::InstallHybrid (NetDeviceContainer vlcDevices, NetDeviceContainer uplinkDevices,
+                          VlcHybridNetDevice::Role role)
+{
+  NS_ASSERT_MSG (vlcDevices.GetN () == uplinkDevices.GetN (), "One uplink device per VlcNetDevice needed");
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < vlcDevices.GetN (); i++)
+    {
+      Ptr<VlcNetDevice> vlcDevice = DynamicCast<VlcNetDevice> (vlcDevices.Get (i));
+      NS_ASSERT_MSG (vlcDevice, "Hybrid device on a device other than a VlcNetDevice");
+      Ptr<NetDevice> uplinkDevice = uplinkDevices.Get (i);
+      NS_ASSERT_MSG (vlcDevice->GetNode () == uplinkDevice->GetNode (), "Uplink device on another node");
+
+      Ptr<VlcHybridNetDevice> device = CreateObject<VlcHybridNetDevice> ();
+      device->SetRole (role);
+      device->SetVlcDevice (vlcDevice);
+      device->SetUplinkDevice (uplinkDevice);
+      vlcDevice->GetNode ()->AddDevice (device);
+      devices.Add (device);
+    }
+  return devices;
+}
+
 /**
  * @brief Write a packet in a PCAP file
  * @param file the output file
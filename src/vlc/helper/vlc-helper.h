@@ -22,7 +22,10 @@
 #include <ns3/node-container.h>
 #include <ns3/vlc-phy.h>
 #include <ns3/vlc-mac.h>
+#include <ns3/vlc-hybrid-net-device.h>
 #include <ns3/trace-helper.h>
+#include <ns3/sixlowpan-helper.h>
+#include <ns3/object-factory.h>
 
 namespace ns3 {
 
@@ -49,8 +52,8 @@ class VlcHelper : public PcapHelperForDevice,
 public:
   /**
    * \brief Create a Vlc helper in an empty state.  By default, a
-   * SingleModelSpectrumChannel is created, with a
-   * LogDistancePropagationLossModel and a ConstantSpeedPropagationDelayModel.
+   * VlcSpectrumChannel is created, with a
+   * VlcLambertianPropagationLossModel and a ConstantSpeedPropagationDelayModel.
    *
    * To change the channel type, loss model, or delay model, the Get/Set
    * Channel methods may be used.
@@ -62,7 +65,7 @@ public:
    * SingleModelSpectrumChannel or a MultiModelSpectrumChannel.
    * \param useMultiModelSpectrumChannel use a MultiModelSpectrumChannel if true, a SingleModelSpectrumChannel otherwise
    *
-   * A LogDistancePropagationLossModel and a
+   * A VlcLambertianPropagationLossModel and a
    * ConstantSpeedPropagationDelayModel are added to the channel.
    */
   VlcHelper (bool useMultiModelSpectrumChannel);
@@ -109,6 +112,78 @@ public:
    */
   void AssociateToVpan (NetDeviceContainer c, uint16_t vpanId);
 
+  /**
+   * \brief Set an attribute on each SixLowPanNetDevice created by
+   * InstallSixLowPan, e.g. Rfc6282 to choose between IPHC and HC1.
+   *
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   */
+  void SetSixLowPanAttribute (std::string n1, const AttributeValue &v1);
+
+  /**
+   * \brief Stack a SixLowPanNetDevice on top of each VlcNetDevice, which
+   * compresses the IPv6 headers and fragments the packets larger than the
+   * MTU of the VlcNetDevice.
+   *
+   * The internet stack should be installed on the nodes, and the IPv6
+   * addresses assigned to the returned net devices.
+   *
+   * \param c the VlcNetDevices, as returned by Install
+   * \returns A container holding the added SixLowPanNetDevices.
+   */
+  NetDeviceContainer InstallSixLowPan (NetDeviceContainer c);
+
+  /**
+   * \brief Set an attribute on each VlcHandoverManager created by
+   * InstallHandoverManager, e.g. Mode or Hysteresis.
+   *
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   */
+  void SetHandoverManagerAttribute (std::string n1, const AttributeValue &v1);
+
+  /**
+   * \brief Aggregate a VlcHandoverManager to each VlcNetDevice, which hands
+   * the device over between the coordinators it hears.
+   *
+   * \param c the VlcNetDevices of the mobile devices
+   */
+  void InstallHandoverManager (NetDeviceContainer c);
+
+  /**
+   * \brief Set an attribute on each VlcReceiverNoiseModel created by
+   * InstallReceiverNoiseModel, e.g. Responsivity or AmbientPower.
+   *
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   */
+  void SetReceiverNoiseModelAttribute (std::string n1, const AttributeValue &v1);
+
+  /**
+   * \brief Set a VlcReceiverNoiseModel on the PHY of each VlcNetDevice, so
+   * that the SINR of the received frames accounts for the photodiode noise.
+   *
+   * \param c the VlcNetDevices
+   */
+  void InstallReceiverNoiseModel (NetDeviceContainer c);
+
+  /**
+   * \brief Pair each VlcNetDevice with the uplink device of the same node
+   * in a VlcHybridNetDevice, added to the node.
+   *
+   * Upper layers should be installed on the returned devices, and the
+   * terminals pointed to the uplink address of the access point with
+   * VlcHybridNetDevice::SetUplinkPeer unless the uplink is broadcast.
+   *
+   * \param vlcDevices the VlcNetDevices, as returned by Install
+   * \param uplinkDevices the uplink devices, one per VlcNetDevice
+   * \param role the side of the VLC link of all the devices
+   * \returns A container holding the added VlcHybridNetDevices.
+   */
+  NetDeviceContainer InstallHybrid (NetDeviceContainer vlcDevices, NetDeviceContainer uplinkDevices,
+                                    VlcHybridNetDevice::Role role);
+
   /**
    * Helper to enable all Vlc log components with one statement
    */
@@ -183,6 +258,9 @@ private:
 
 private:
   Ptr<SpectrumChannel> m_channel; //!< channel to be used for the devices
+  SixLowPanHelper m_sixLowPanHelper; //!< helper for the 6LoWPAN adaptation layer
+  ObjectFactory m_handoverManagerFactory; //!< factory of the handover managers
+  ObjectFactory m_noiseModelFactory; //!< factory of the receiver noise models
 
 };
 
@@ -0,0 +1,89 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-radio-energy-model-helper.h"
+#include <ns3/vlc-net-device.h>
+#include <ns3/vlc-phy.h>
+
+namespace ns3 {
+
+VlcRadioEnergyModelHelper::VlcRadioEnergyModelHelper (void)
+{
+  m_radioEnergy.SetTypeId ("ns3::VlcRadioEnergyModel");
+  m_depletionCallback.Nullify ();
+  m_rechargedCallback.Nullify ();
+}
+
+VlcRadioEnergyModelHelper::~VlcRadioEnergyModelHelper (void)
+{
+}
+
+void
+VlcRadioEnergyModelHelper::Set (std::string name, const AttributeValue &v)
+{
+  m_radioEnergy.Set (name, v);
+}
+
+void
+VlcRadioEnergyModelHelper::SetDepletionCallback (VlcRadioEnergyModel::VlcRadioEnergyDepletionCallback callback)
+{
+  m_depletionCallback = callback;
+}
+
+void
+VlcRadioEnergyModelHelper::SetRechargedCallback (VlcRadioEnergyModel::VlcRadioEnergyRechargedCallback callback)
+{
+  m_rechargedCallback = callback;
+}
+
+Ptr<DeviceEnergyModel>
+VlcRadioEnergyModelHelper::DoInstall (Ptr<NetDevice> device,
+                                      Ptr<EnergySource> source) const
+{
+  NS_ASSERT (device != 0);
+  NS_ASSERT (source != 0);
+  Ptr<VlcNetDevice> vlcDevice = DynamicCast<VlcNetDevice> (device);
+  if (vlcDevice == 0)
+    {
+      NS_FATAL_ERROR ("NetDevice type is not VlcNetDevice!");
+    }
+  Ptr<VlcPhy> phy = vlcDevice->GetPhy ();
+  Ptr<VlcRadioEnergyModel> model = m_radioEnergy.Create<VlcRadioEnergyModel> ();
+
+  if (m_depletionCallback.IsNull ())
+    {
+      model->SetEnergyDepletionCallback (MakeCallback (&VlcPhy::SetOffMode, phy));
+    }
+  else
+    {
+      model->SetEnergyDepletionCallback (m_depletionCallback);
+    }
+  if (m_rechargedCallback.IsNull ())
+    {
+      model->SetEnergyRechargedCallback (MakeCallback (&VlcPhy::ResumeFromOff, phy));
+    }
+  else
+    {
+      model->SetEnergyRechargedCallback (m_rechargedCallback);
+    }
+  source->AppendDeviceEnergyModel (model);
+  model->SetEnergySource (source);
+  model->SetPhy (phy);
+  return model;
+}
+
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_RADIO_ENERGY_MODEL_HELPER_H
+#define VLC_RADIO_ENERGY_MODEL_HELPER_H
+
+#include <ns3/energy-model-helper.h>
+#include <ns3/vlc-radio-energy-model.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * \brief installs a VlcRadioEnergyModel on VlcNetDevices
+ *
+ * Unless other callbacks are set, the PHY of the device is switched off
+ * when the energy source is depleted and back on when it is recharged.
+ */
+class VlcRadioEnergyModelHelper : public DeviceEnergyModelHelper
+{
+public:
+  VlcRadioEnergyModelHelper (void);
+  ~VlcRadioEnergyModelHelper (void);
+
+  /**
+   * \param name the name of the attribute to set
+   * \param v the value of the attribute
+   *
+   * Set an attribute of the VlcRadioEnergyModel objects created.
+   */
+  void Set (std::string name, const AttributeValue &v);
+
+  /**
+   * \param callback the callback invoked when the energy is depleted
+   */
+  void SetDepletionCallback (VlcRadioEnergyModel::VlcRadioEnergyDepletionCallback callback);
+
+  /**
+   * \param callback the callback invoked when the energy is recharged
+   */
+  void SetRechargedCallback (VlcRadioEnergyModel::VlcRadioEnergyRechargedCallback callback);
+
+private:
+  /**
+   * \param device the VlcNetDevice
+   * \param source the energy source of its node
+   * \return the VlcRadioEnergyModel installed
+   */
+  virtual Ptr<DeviceEnergyModel> DoInstall (Ptr<NetDevice> device,
+                                            Ptr<EnergySource> source) const;
+
+  ObjectFactory m_radioEnergy;                                             //!< the model factory
+  VlcRadioEnergyModel::VlcRadioEnergyDepletionCallback m_depletionCallback; //!< the depletion callback
+  VlcRadioEnergyModel::VlcRadioEnergyRechargedCallback m_rechargedCallback; //!< the recharged callback
+};
+
+} // namespace ns3
+
+#endif /* VLC_RADIO_ENERGY_MODEL_HELPER_H */
@@ -0,0 +1,320 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors:
+ *  Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-sweep-helper.h"
+#include <ns3/rng-seed-manager.h>
+#include <ns3/log.h>
+#include <ns3/abort.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#ifdef VLC_SWEEP_FORK
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcSweepHelper");
+
+/**
+ * \brief A trial running in a worker process.
+ */
+struct VlcSweepTrial
+{
+  uint32_t point; //!< the index of the sweep point
+  uint32_t run;   //!< the run number
+  int fd;         //!< the read end of the result pipe
+};
+
+VlcSweepHelper::VlcSweepHelper (void)
+  : m_workers (0),
+    m_firstRun (1),
+    m_runs (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VlcSweepHelper::SetTrialCallback (TrialCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_trial = cb;
+}
+
+void
+VlcSweepHelper::SetWorkers (uint32_t workers)
+{
+  NS_LOG_FUNCTION (this << workers);
+  m_workers = workers;
+}
+
+uint32_t
+VlcSweepHelper::GetWorkers (void) const
+{
+  if (m_workers != 0)
+    {
+      return m_workers;
+    }
+#ifdef VLC_SWEEP_FORK
+  long n = sysconf (_SC_NPROCESSORS_ONLN);
+  return n > 0 ? static_cast<uint32_t> (n) : 1;
+#else
+  return 1;
+#endif
+}
+
+void
+VlcSweepHelper::SetRuns (uint32_t firstRun, uint32_t runs)
+{
+  NS_LOG_FUNCTION (this << firstRun << runs);
+  NS_ABORT_MSG_IF (runs == 0, "At least one run per point is needed");
+  m_firstRun = firstRun;
+  m_runs = runs;
+}
+
+void
+VlcSweepHelper::AddPoint (double x)
+{
+  NS_LOG_FUNCTION (this << x);
+  m_points.push_back (x);
+}
+
+void
+VlcSweepHelper::AddPoints (double min, double max, double step)
+{
+  NS_LOG_FUNCTION (this << min << max << step);
+  NS_ABORT_MSG_IF (step <= 0, "The sweep step must be positive");
+  // Count the points instead of accumulating the step, so that rounding
+  // errors neither add nor drop the last point.
+  uint32_t n = static_cast<uint32_t> (std::floor ((max - min) / step + 1e-9)) + 1;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_points.push_back (min + i * step);
+    }
+}
+
+double
+VlcSweepHelper::RunTrial (double x, uint32_t run) const
+{
+  RngSeedManager::SetRun (run);
+  return m_trial (x, run);
+}
+
+#ifdef VLC_SWEEP_FORK
+void
+VlcSweepHelper::RunTrials (std::vector<std::vector<double> > &samples) const
+{
+  uint32_t workers = GetWorkers ();
+  std::map<pid_t, VlcSweepTrial> running;
+  uint32_t nTrials = m_points.size () * m_runs;
+  uint32_t next = 0;
+
+  // Buffered output would otherwise be written again by every child.
+  std::cout.flush ();
+  std::cerr.flush ();
+  fflush (0);
+
+  while (next < nTrials || !running.empty ())
+    {
+      while (next < nTrials && running.size () < workers)
+        {
+          VlcSweepTrial trial;
+          trial.point = next / m_runs;
+          trial.run = m_firstRun + next % m_runs;
+          int fds[2];
+          NS_ABORT_MSG_IF (pipe (fds) != 0, "pipe () failed: errno " << errno);
+          pid_t pid = fork ();
+          NS_ABORT_MSG_IF (pid < 0, "fork () failed: errno " << errno);
+          if (pid == 0)
+            {
+              // Only the parent reads the result pipes: close the read end
+              // of this trial and the ones inherited from the trials still
+              // running.
+              close (fds[0]);
+              for (std::map<pid_t, VlcSweepTrial>::const_iterator it = running.begin ();
+                   it != running.end (); ++it)
+                {
+                  close (it->second.fd);
+                }
+              double y = RunTrial (m_points[trial.point], trial.run);
+              bool ok = write (fds[1], &y, sizeof (y)) == sizeof (y);
+              close (fds[1]);
+              std::cout.flush ();
+              std::cerr.flush ();
+              _exit (ok ? 0 : 1);
+            }
+          close (fds[1]);
+          trial.fd = fds[0];
+          running[pid] = trial;
+          next++;
+        }
+
+      // Wait for a result pipe to become readable rather than for any
+      // child: waitpid (-1) would also reap the other children of the
+      // caller. The write end of a worker closes when it exits, so a
+      // worker that fails also wakes the poll up.
+      std::vector<struct pollfd> fds;
+      std::vector<pid_t> pids;
+      for (std::map<pid_t, VlcSweepTrial>::const_iterator it = running.begin ();
+           it != running.end (); ++it)
+        {
+          struct pollfd pfd;
+          pfd.fd = it->second.fd;
+          pfd.events = POLLIN;
+          pfd.revents = 0;
+          fds.push_back (pfd);
+          pids.push_back (it->first);
+        }
+      int nReady = poll (&fds[0], fds.size (), -1);
+      if (nReady < 0 && errno == EINTR)
+        {
+          continue;
+        }
+      NS_ABORT_MSG_IF (nReady < 0, "poll () failed: errno " << errno);
+      for (uint32_t i = 0; i < fds.size (); i++)
+        {
+          if (fds[i].revents == 0)
+            {
+              continue;
+            }
+          std::map<pid_t, VlcSweepTrial>::iterator it = running.find (pids[i]);
+          VlcSweepTrial trial = it->second;
+          running.erase (it);
+          double y;
+          bool ok = read (trial.fd, &y, sizeof (y)) == sizeof (y);
+          close (trial.fd);
+          int status;
+          pid_t pid;
+          do
+            {
+              pid = waitpid (pids[i], &status, 0);
+            }
+          while (pid < 0 && errno == EINTR);
+          NS_ABORT_MSG_IF (pid < 0, "waitpid () failed: errno " << errno);
+          ok = ok && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+          NS_ABORT_MSG_IF (!ok, "Trial for point " << m_points[trial.point]
+                           << " and run " << trial.run << " failed");
+          NS_LOG_DEBUG ("Point " << m_points[trial.point] << " run " << trial.run << ": " << y);
+          samples[trial.point][trial.run - m_firstRun] = y;
+        }
+    }
+}
+#else
+void
+VlcSweepHelper::RunTrials (std::vector<std::vector<double> > &samples) const
+{
+  for (uint32_t i = 0; i < m_points.size (); i++)
+    {
+      for (uint32_t j = 0; j < m_runs; j++)
+        {
+          samples[i][j] = RunTrial (m_points[i], m_firstRun + j);
+          NS_LOG_DEBUG ("Point " << m_points[i] << " run " << m_firstRun + j << ": " << samples[i][j]);
+        }
+    }
+}
+#endif
+
+void
+VlcSweepHelper::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_trial.IsNull (), "No trial callback set");
+
+  // Samples are stored by run rather than in completion order, so that
+  // the results do not depend on the scheduling of the workers.
+  std::vector<std::vector<double> > samples (m_points.size (), std::vector<double> (m_runs));
+  RunTrials (samples);
+
+  m_results.clear ();
+  for (uint32_t i = 0; i < m_points.size (); i++)
+    {
+      Result r;
+      r.x = m_points[i];
+      r.runs = samples[i].size ();
+      double sum = 0;
+      for (uint32_t j = 0; j < r.runs; j++)
+        {
+          sum += samples[i][j];
+        }
+      r.mean = sum / r.runs;
+      r.halfWidth = 0;
+      if (r.runs > 1)
+        {
+          double sq = 0;
+          for (uint32_t j = 0; j < r.runs; j++)
+            {
+              sq += (samples[i][j] - r.mean) * (samples[i][j] - r.mean);
+            }
+          double stddev = std::sqrt (sq / (r.runs - 1));
+          r.halfWidth = GetStudentT95 (r.runs - 1) * stddev / std::sqrt (r.runs);
+        }
+      m_results.push_back (r);
+    }
+}
+
+const std::vector<VlcSweepHelper::Result> &
+VlcSweepHelper::GetResults (void) const
+{
+  return m_results;
+}
+
+void
+VlcSweepHelper::WriteCsv (std::ostream &os) const
+{
+  os << "x,mean,ci95,runs" << std::endl;
+  for (std::vector<Result>::const_iterator it = m_results.begin (); it != m_results.end (); ++it)
+    {
+      os << it->x << "," << it->mean << "," << it->halfWidth << "," << it->runs << std::endl;
+    }
+}
+
+Gnuplot2dDataset
+VlcSweepHelper::GetDataset (std::string title) const
+{
+  Gnuplot2dDataset dataset (title);
+  dataset.SetStyle (Gnuplot2dDataset::LINES_POINTS);
+  dataset.SetErrorBars (Gnuplot2dDataset::Y);
+  for (std::vector<Result>::const_iterator it = m_results.begin (); it != m_results.end (); ++it)
+    {
+      dataset.Add (it->x, it->mean, it->halfWidth);
+    }
+  return dataset;
+}
+
+double
+VlcSweepHelper::GetStudentT95 (uint32_t degreesOfFreedom)
+{
+  static const double t95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  NS_ASSERT (degreesOfFreedom > 0);
+  if (degreesOfFreedom <= 30)
+    {
+      return t95[degreesOfFreedom - 1];
+    }
+  return 1.960;
+}
+
+} // namespace ns3
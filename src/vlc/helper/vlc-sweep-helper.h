@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors:
+ *  Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_SWEEP_HELPER_H
+#define VLC_SWEEP_HELPER_H
+
+#include <ns3/callback.h>
+#include <ns3/gnuplot.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * \brief runs a parameter sweep over a pool of worker processes
+ *
+ * Each sweep point is evaluated once per RNG run number.  Every (point,
+ * run) pair is an independent trial, executed in a child process forked
+ * from the caller, so that the simulator singleton and the global random
+ * stream counter start from the same state for every trial.  At most
+ * "workers" trials are running at any time.
+ *
+ * Worker processes need fork () and waitpid (), which the build looks for
+ * in <sys/wait.h>.  Where they are missing, the trials are run one after
+ * the other in the calling process and the number of workers is ignored.
+ * The trials then share the global random stream counter, so a trial
+ * draws different streams than in a worker process.
+ *
+ * The trial callback receives the sweep value and the run number, must
+ * build its own scenario, run it, call Simulator::Destroy () and return
+ * the measured metric (e.g. a packet success rate).  The run number has
+ * already been passed to RngSeedManager::SetRun () when the callback is
+ * called.
+ *
+ * The results are the mean of the metric over the runs and the half
+ * width of its 95% confidence interval (Student's t distribution), and
+ * can be written as CSV or as a gnuplot dataset with error bars.
+ */
+class VlcSweepHelper
+{
+public:
+  /**
+   * Trial callback: takes the sweep value and the run number, returns
+   * the measured metric.
+   */
+  typedef Callback<double, double, uint32_t> TrialCallback;
+
+  /**
+   * \brief The result of one sweep point.
+   */
+  struct Result
+  {
+    double x;         //!< the sweep value
+    double mean;      //!< the mean of the metric over the runs
+    double halfWidth; //!< the half width of the 95% confidence interval
+    uint32_t runs;    //!< the number of runs
+  };
+
+  /**
+   * \brief Create a sweep helper with no point, one run per point and one
+   * worker per online processor.
+   */
+  VlcSweepHelper (void);
+
+  /**
+   * \brief Set the trial callback.
+   * \param cb the trial callback
+   */
+  void SetTrialCallback (TrialCallback cb);
+
+  /**
+   * \brief Set the number of worker processes.
+   * \param workers the number of workers, 0 for one per online processor
+   * (ignored without worker processes)
+   */
+  void SetWorkers (uint32_t workers);
+
+  /**
+   * \brief Get the number of worker processes.
+   * \return the number of workers
+   */
+  uint32_t GetWorkers (void) const;
+
+  /**
+   * \brief Set the run numbers used for every point.
+   * \param firstRun the first run number
+   * \param runs the number of runs, each point uses runs firstRun to
+   * firstRun + runs - 1
+   */
+  void SetRuns (uint32_t firstRun, uint32_t runs);
+
+  /**
+   * \brief Add a sweep point.
+   * \param x the sweep value
+   */
+  void AddPoint (double x);
+
+  /**
+   * \brief Add the sweep points min, min + step, ... up to max included.
+   * \param min the first sweep value
+   * \param max the last sweep value
+   * \param step the increment between two points
+   */
+  void AddPoints (double min, double max, double step);
+
+  /**
+   * \brief Run every trial and compute the results.
+   */
+  void Run (void);
+
+  /**
+   * \brief Get the results of the last Run, in the order of the points.
+   * \return the results
+   */
+  const std::vector<Result> & GetResults (void) const;
+
+  /**
+   * \brief Write the results as CSV, with a "x,mean,ci95,runs" header.
+   * \param os the output stream
+   */
+  void WriteCsv (std::ostream &os) const;
+
+  /**
+   * \brief Get the results as a gnuplot dataset with Y error bars.
+   * \param title the title of the dataset
+   * \return the dataset
+   */
+  Gnuplot2dDataset GetDataset (std::string title) const;
+
+  /**
+   * \brief Get the two-sided 95% quantile of Student's t distribution.
+   * \param degreesOfFreedom the degrees of freedom
+   * \return the quantile, the normal quantile above 30 degrees of freedom
+   */
+  static double GetStudentT95 (uint32_t degreesOfFreedom);
+
+private:
+  /**
+   * \brief Run one trial in the calling process.
+   * \param x the sweep value
+   * \param run the run number
+   * \return the metric
+   */
+  double RunTrial (double x, uint32_t run) const;
+
+  /**
+   * \brief Run every trial, in worker processes where available.
+   * \param samples the metric of each trial, by point and by run
+   */
+  void RunTrials (std::vector<std::vector<double> > &samples) const;
+
+  TrialCallback m_trial;           //!< the trial callback
+  uint32_t m_workers;              //!< the number of worker processes
+  uint32_t m_firstRun;             //!< the first run number
+  uint32_t m_runs;                 //!< the number of runs per point
+  std::vector<double> m_points;    //!< the sweep values
+  std::vector<Result> m_results;   //!< the results of the last Run
+};
+
+} // namespace ns3
+
+#endif /* VLC_SWEEP_HELPER_H */
@@ -171,11 +171,17 @@ namespace ns3 {
   {
     NS_LOG_FUNCTION (this);
 
-    // TODO: Calculate the offset to the next slot.
-
-    return Seconds (0);
-
+    // Backoff periods are aligned with the start of the superframe.
+    Time unit = Seconds (m_aUnitBackoffPeriod / m_mac->GetPhy ()->GetDataOrSymbolRate (false));
+    Time elapsed = Simulator::Now () - m_mac->GetSuperframeStart ();
+    Time offset = elapsed - (elapsed / unit) * unit;
+    if (offset.IsZero ())
+      {
+        return Seconds (0);
+      }
+    return unit - offset;
   }
+
   void
   VlcCsmaCa::Start ()
 
@@ -193,7 +199,7 @@ namespace ns3 {
           {
             m_BE = m_macMinBE;
           }
-        //TODO: for slotted, locate backoff period boundary. i.e. delay to the next slot boundary
+        // For slotted, locate backoff period boundary. i.e. delay to the next slot boundary
         Time backoffBoundary = GetTimeToNextSlot ();
         m_randomBackoffEvent = Simulator::Schedule (backoffBoundary, &VlcCsmaCa::RandomBackoffDelay, this);
       }
@@ -218,6 +224,7 @@ namespace ns3 {
     m_randomBackoffEvent.Cancel ();
     m_requestCcaEvent.Cancel ();
     m_canProceedEvent.Cancel ();
+    m_ccaRequestRunning = false;
   }
 
   /*
@@ -252,31 +259,30 @@ namespace ns3 {
       }
   }
 
-  // TODO : Determine if transmission can be completed before end of CAP for the slotted csmaca
-  //        If not delay to the next CAP
+  /*
+   * Determine if the CCAs and the transaction can be completed before the end of the CAP.
+   * If not, delay to the next CAP
+   */
   void
   VlcCsmaCa::CanProceed ()
   {
     NS_LOG_FUNCTION (this);
 
-    bool canProceed = true;
-
-    if (m_BLE)
-      {
-      }
-    else
-      {
-      }
+    // Perform CCA on backoff period boundary i.e. delay to next slot boundary
+    Time backoffBoundary = GetTimeToNextSlot ();
+    Time unit = Seconds (m_aUnitBackoffPeriod / m_mac->GetPhy ()->GetDataOrSymbolRate (false));
+    Time start = Simulator::Now () + backoffBoundary;
+    Time end = start + static_cast<int64_t> (m_CW) * unit + m_mac->GetTransactionDuration ();
+    bool canProceed = start >= m_mac->GetCapStart () && end <= m_mac->GetCapEnd ();
 
     if (canProceed)
       {
-        // TODO: For slotted, Perform CCA on backoff period boundary i.e. delay to next slot boundary
-        Time backoffBoundary = GetTimeToNextSlot ();
         m_requestCcaEvent = Simulator::Schedule (backoffBoundary, &VlcCsmaCa::RequestCCA, this);
       }
     else
       {
-        Time nextCap = Seconds (0);
+        Time nextCap = m_mac->GetNextCapStart () - Simulator::Now ();
+        NS_LOG_LOGIC ("Slotted:  deferring to the next CAP in " << nextCap.GetMicroSeconds () << " us");
         m_randomBackoffEvent = Simulator::Schedule (nextCap, &VlcCsmaCa::RandomBackoffDelay, this);
       }
   }
@@ -320,7 +326,8 @@ namespace ns3 {
                 else
                   {
                     NS_LOG_LOGIC ("Perform CCA again, m_CW = " << m_CW);
-                    m_requestCcaEvent = Simulator::ScheduleNow (&VlcCsmaCa::RequestCCA, this); // Perform CCA again
+                    // Perform CCA again, on the next backoff period boundary
+                    m_requestCcaEvent = Simulator::Schedule (GetTimeToNextSlot (), &VlcCsmaCa::RequestCCA, this);
                   }
               }
             else
@@ -17,8 +17,11 @@
  */
 #include "vlc-error-model.h"
 #include <ns3/log.h>
+#include <ns3/double.h>
 
+#include <algorithm>
 #include <cmath>
+#include <map>
 
 namespace ns3 {
 
@@ -26,6 +29,65 @@ NS_LOG_COMPONENT_DEFINE ("VlcErrorModel");
 
 NS_OBJECT_ENSURE_REGISTERED (VlcErrorModel);
 
+namespace {
+
+/**
+ * The parameters a bit error rate table depends on.
+ */
+struct TableKey
+{
+  VlcModulation modulation;   //!< the modulation scheme
+  uint32_t fecN;              //!< symbols per Reed-Solomon code word
+  uint32_t fecK;              //!< data symbols per Reed-Solomon code word
+  uint32_t fecSymbolBits;     //!< bits per Reed-Solomon symbol
+  double dimmingLevel;        //!< the dimming level
+  double resolution;          //!< step of sqrt (SNR) between table entries
+  double maxSqrtSnr;          //!< sqrt (SNR) of the last table entry
+
+  /**
+   * Order the keys lexicographically.
+   *
+   * \param o another key
+   * \return true if this key comes before the other one
+   */
+  bool operator< (const TableKey &o) const
+  {
+    if (modulation != o.modulation)
+      {
+        return modulation < o.modulation;
+      }
+    if (fecN != o.fecN)
+      {
+        return fecN < o.fecN;
+      }
+    if (fecK != o.fecK)
+      {
+        return fecK < o.fecK;
+      }
+    if (fecSymbolBits != o.fecSymbolBits)
+      {
+        return fecSymbolBits < o.fecSymbolBits;
+      }
+    if (dimmingLevel != o.dimmingLevel)
+      {
+        return dimmingLevel < o.dimmingLevel;
+      }
+    if (resolution != o.resolution)
+      {
+        return resolution < o.resolution;
+      }
+    return maxSqrtSnr < o.maxSqrtSnr;
+  }
+};
+
+/**
+ * The bit error rate tables built so far, shared by all error models. The
+ * elements of a map do not move, so the error models keep pointers to them.
+ */
+std::map<TableKey, std::vector<double> > g_logSuccessTables;
+
+} // anonymous namespace
+
 TypeId
 VlcErrorModel::GetTypeId (void)
 {
@@ -33,46 +95,255 @@ VlcErrorModel::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("Vlc")
     .AddConstructor<VlcErrorModel> ()
+    .AddAttribute ("TableResolution",
+                   "The step of the square root of the linear SNR between two "
+                   "entries of the bit error rate table.",
+                   DoubleValue (0.005),
+                   MakeDoubleAccessor (&VlcErrorModel::SetTableResolution,
+                                       &VlcErrorModel::GetTableResolution),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 VlcErrorModel::VlcErrorModel (void)
+  : m_modulation (VLC_MODULATION_OOK),
+    m_fecN (0),
+    m_fecK (0),
+    m_fecSymbolBits (0),
+    m_dimmingLevel (0.5),
+    m_resolution (0.005),
+    m_maxSqrtSnr (14.0),
+    m_logSuccessTable (0)
+{
+  UpdateTable ();
+}
+
+void
+VlcErrorModel::SetModulation (VlcModulation modulation)
+{
+  NS_LOG_FUNCTION (this << modulation);
+  if (modulation != m_modulation)
+    {
+      m_modulation = modulation;
+      UpdateTable ();
+    }
+}
+
+VlcModulation
+VlcErrorModel::GetModulation (void) const
+{
+  return m_modulation;
+}
+
+void
+VlcErrorModel::SetFec (uint32_t n, uint32_t k, uint32_t symbolBits)
+{
+  NS_LOG_FUNCTION (this << n << k << symbolBits);
+  NS_ASSERT (k <= n);
+  if (n == m_fecN && k == m_fecK && symbolBits == m_fecSymbolBits)
+    {
+      return;
+    }
+  m_fecN = n;
+  m_fecK = k;
+  m_fecSymbolBits = symbolBits;
+  UpdateTable ();
+}
+
+void
+VlcErrorModel::Configure (VlcModulation modulation, uint32_t n, uint32_t k, uint32_t symbolBits,
+                          double dimmingLevel)
 {
-  m_binomialCoefficients[0]  = 1;
-  m_binomialCoefficients[1]  = -16;
-  m_binomialCoefficients[2]  = 120;
-  m_binomialCoefficients[3]  = -560;
-  m_binomialCoefficients[4]  = 1820;
-  m_binomialCoefficients[5]  = -4368;
-  m_binomialCoefficients[6]  = 8008;
-  m_binomialCoefficients[7]  = -11440;
-  m_binomialCoefficients[8]  = 12870;
-  m_binomialCoefficients[9]  = -11440;
-  m_binomialCoefficients[10] = 8008;
-  m_binomialCoefficients[11] = -4368;
-  m_binomialCoefficients[12] = 1820;
-  m_binomialCoefficients[13] = -560;
-  m_binomialCoefficients[14] = 120;
-  m_binomialCoefficients[15] = -16;
-  m_binomialCoefficients[16] = 1;
+  NS_LOG_FUNCTION (this << modulation << n << k << symbolBits << dimmingLevel);
+  NS_ASSERT (k <= n);
+  NS_ASSERT (dimmingLevel > 0 && dimmingLevel < 1);
+  if (modulation == m_modulation && n == m_fecN && k == m_fecK && symbolBits == m_fecSymbolBits
+      && dimmingLevel == m_dimmingLevel)
+    {
+      return;
+    }
+  m_modulation = modulation;
+  m_fecN = n;
+  m_fecK = k;
+  m_fecSymbolBits = symbolBits;
+  m_dimmingLevel = dimmingLevel;
+  UpdateTable ();
+}
+
+void
+VlcErrorModel::SetDimmingLevel (double dimmingLevel)
+{
+  NS_LOG_FUNCTION (this << dimmingLevel);
+  NS_ASSERT (dimmingLevel > 0 && dimmingLevel < 1);
+  if (dimmingLevel != m_dimmingLevel)
+    {
+      m_dimmingLevel = dimmingLevel;
+      UpdateTable ();
+    }
 }
 
 double
-VlcErrorModel::GetChunkSuccessRate (double snr, uint32_t nbits) const
+VlcErrorModel::GetDimmingLevel (void) const
+{
+  return m_dimmingLevel;
+}
+
+void
+VlcErrorModel::SetTableResolution (double resolution)
+{
+  NS_LOG_FUNCTION (this << resolution);
+  NS_ASSERT (resolution > 0);
+  m_resolution = resolution;
+  UpdateTable ();
+}
+
+double
+VlcErrorModel::GetTableResolution (void) const
+{
+  return m_resolution;
+}
+
+double
+VlcErrorModel::GetLineCodeRate (void) const
+{
+  switch (m_modulation)
+    {
+    case VLC_MODULATION_VPPM:
+      // 4B6B
+      return 4.0 / 6.0;
+    case VLC_MODULATION_OOK:
+    default:
+      // 8B10B
+      return 8.0 / 10.0;
+    }
+}
+
+double
+VlcErrorModel::GetDimmingSnrFactor (void) const
+{
+  switch (m_modulation)
+    {
+    case VLC_MODULATION_VPPM:
+      return std::min (m_dimmingLevel, 1 - m_dimmingLevel) / m_dimmingLevel;
+    case VLC_MODULATION_OOK:
+    default:
+      return 0.5 / m_dimmingLevel;
+    }
+}
+
+double
+VlcErrorModel::GetDecodedBer (double p) const
+{
+  uint32_t n = m_fecN;
+  uint32_t t = (m_fecN - m_fecK) / 2;
+  uint32_t m = m_fecSymbolBits;
+
+  // Symbol error rate before decoding.
+  double ps = -std::expm1 (m * std::log1p (-p));
+  if (ps <= 0.0)
+    {
+      return 0.0;
+    }
+  if (ps >= 1.0)
+    {
+      return 1.0;
+    }
+
+  // Symbol error rate after decoding: a code word with i > t symbol errors
+  // is assumed to leave all i symbols in error.
+  double psDecoded = 0.0;
+  for (uint32_t i = t + 1; i <= n; i++)
+    {
+      double logTerm = std::lgamma (n + 1.0) - std::lgamma (i + 1.0) - std::lgamma (n - i + 1.0)
+        + i * std::log (ps) + (n - i) * std::log1p (-ps);
+      psDecoded += i * std::exp (logTerm);
+    }
+  psDecoded /= n;
+
+  // Bit errors within an erroneous symbol.
+  double symbols = std::pow (2.0, m);
+  return std::min (psDecoded * (symbols / 2) / (symbols - 1), 1.0);
+}
+
+double
+VlcErrorModel::GetBer (double snr) const
+{
+  double x = std::sqrt (std::max (snr * GetDimmingSnrFactor (), 0.0));
+  if (m_modulation == VLC_MODULATION_VPPM)
+    {
+      x /= std::sqrt (2.0);
+    }
+  // Q (x)
+  double p = 0.5 * std::erfc (x / std::sqrt (2.0));
+
+  // All channel bits carrying a data bit have to be correct.
+  double ber = -std::expm1 (std::log1p (-p) / GetLineCodeRate ());
+
+  if (m_fecN > m_fecK)
+    {
+      ber = GetDecodedBer (ber);
+    }
+  return ber;
+}
+
+void
+VlcErrorModel::UpdateTable (void)
 {
-  double ber = 0.0;
+  NS_LOG_FUNCTION (this);
 
-  for (uint32_t k = 2; k <= 16; k++)
+  TableKey key;
+  key.modulation = m_modulation;
+  key.fecN = m_fecN;
+  key.fecK = m_fecK;
+  key.fecSymbolBits = m_fecSymbolBits;
+  key.dimmingLevel = m_dimmingLevel;
+  key.resolution = m_resolution;
+  key.maxSqrtSnr = m_maxSqrtSnr;
+  std::vector<double> &table = g_logSuccessTables[key];
+  if (table.empty ())
     {
-      ber += m_binomialCoefficients[k] * exp (20.0 * snr * (1.0 / k - 1.0));
+      NS_LOG_LOGIC ("Build the table of modulation " << m_modulation << ", RS (" << m_fecN << ", " << m_fecK
+                    << "), dimming level " << m_dimmingLevel);
+      uint32_t size = std::ceil (m_maxSqrtSnr / m_resolution) + 1;
+      table.resize (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          double x = i * m_resolution;
+          table[i] = std::log1p (-std::min (GetBer (x * x), 1.0 - 1e-16));
+        }
     }
+  m_logSuccessTable = &table;
+}
 
-  ber = ber * 8.0 / 15.0 / 16.0;
+double
+VlcErrorModel::GetTabulatedBer (double snr) const
+{
+  double x = std::sqrt (std::max (snr, 0.0)) / m_resolution;
+  const std::vector<double> &table = *m_logSuccessTable;
+  if (x + 1 >= table.size ())
+    {
+      return 0.0;
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double frac = x - i;
+  double logSuccess = table[i] + frac * (table[i + 1] - table[i]);
+  return -std::expm1 (logSuccess);
+}
 
-  ber = std::min (ber, 1.0);
-  double retval = pow (1.0 - ber, nbits);
-  return retval;
+double
+VlcErrorModel::GetChunkSuccessRate (double snr, uint32_t nbits) const
+{
+  double x = std::sqrt (std::max (snr, 0.0)) / m_resolution;
+  const std::vector<double> &table = *m_logSuccessTable;
+  if (x + 1 >= table.size ())
+    {
+      return 1.0;
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double frac = x - i;
+  double logSuccess = table[i] + frac * (table[i + 1] - table[i]);
+  return std::exp (nbits * logSuccess);
 }
 
 } // namespace ns3
@@ -20,26 +20,206 @@
 
 #include <ns3/object.h>
 
+#include <vector>
+
 namespace ns3 {
 
 /**
  * \ingroup vlc
  *
- * Model the error rate for IEEE 802.15.7 2.4 GHz AWGN channel for phyII-OOK
+ * Modulation schemes supported by VlcErrorModel.
+ */
+typedef enum
+{
+  VLC_MODULATION_OOK = 0,   //!< On-off keying
+  VLC_MODULATION_VPPM = 1   //!< Variable pulse position modulation
+} VlcModulation;
+
+/**
+ * \ingroup vlc
+ *
+ * Model the error rate of the IEEE 802.15.7 OOK and VPPM PHYs in an AWGN
+ * channel.
+ *
+ * The raw bit error rate of a channel bit is \f$ Q(\sqrt{SNR}) \f$ for OOK
+ * and \f$ Q(\sqrt{SNR / 2}) \f$ for VPPM. A data bit is carried by
+ * 1 / r channel bits of the run length limited line code (8B10B with
+ * r = 4/5 for OOK, 4B6B with r = 2/3 for VPPM), all of which have to be
+ * received correctly. Optionally, the data is protected by a Reed-Solomon
+ * code RS(n, k) over GF(2^m), which corrects up to (n - k) / 2 symbol
+ * errors per code word.
+ *
+ * Since GetChunkSuccessRate is called on every interference update, the
+ * bit error rates are precomputed in a table indexed by the square root of
+ * the linear SNR and linearly interpolated. Beyond the end of the table, the
+ * bit error rate is considered to be zero. A table is built once for every
+ * combination of modulation, FEC, dimming level and resolution, and shared
+ * by all error models, so that a receiver switching between schemes only
+ * switches between tables.
+ *
+ * The SNR is the one of the average optical power of the frame. A dimmed
+ * frame at dimming level d averages d times the peak power instead of half
+ * of it. OOK reaches the level with compensation symbols around data sent
+ * at a 50% duty cycle, so the data sees the SNR divided by 2d. VPPM sends
+ * every bit as a pulse of width d, and the two pulse positions differ over
+ * min (d, 1 - d) of the bit, which scales the SNR by min (d, 1 - d) / d.
+ * Both factors are 1 at the undimmed level 0.5.
  */
 class VlcErrorModel : public Object
 {
 public:
 
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
   static TypeId GetTypeId (void);
 
   VlcErrorModel (void);
 
+  /**
+   * Get the probability that a chunk of data bits is received correctly,
+   * using the precomputed table.
+   *
+   * \param snr the linear signal to noise ratio
+   * \param nbits the number of data bits in the chunk
+   * \return the chunk success rate
+   */
   double GetChunkSuccessRate (double snr, uint32_t nbits) const;
 
+  /**
+   * Get the bit error rate of a data bit, evaluating the closed form
+   * expressions.
+   *
+   * \param snr the linear signal to noise ratio
+   * \return the bit error rate
+   */
+  double GetBer (double snr) const;
+
+  /**
+   * Get the bit error rate of a data bit, interpolated from the precomputed
+   * table.
+   *
+   * \param snr the linear signal to noise ratio
+   * \return the bit error rate
+   */
+  double GetTabulatedBer (double snr) const;
+
+  /**
+   * Set the modulation scheme.
+   *
+   * \param modulation the modulation scheme
+   */
+  void SetModulation (VlcModulation modulation);
+
+  /**
+   * Get the modulation scheme.
+   *
+   * \return the modulation scheme
+   */
+  VlcModulation GetModulation (void) const;
+
+  /**
+   * Set the Reed-Solomon code protecting the data. A code with n = k
+   * disables forward error correction.
+   *
+   * \param n the number of symbols per code word
+   * \param k the number of data symbols per code word
+   * \param symbolBits the number of bits per symbol
+   */
+  void SetFec (uint32_t n, uint32_t k, uint32_t symbolBits);
+
+  /**
+   * Set the modulation, the Reed-Solomon code and the dimming level at once,
+   * switching the bit error rate table only once.
+   *
+   * \param modulation the modulation scheme
+   * \param n the number of symbols per code word
+   * \param k the number of data symbols per code word
+   * \param symbolBits the number of bits per symbol
+   * \param dimmingLevel the average optical power relative to the peak
+   * power, strictly between 0 and 1
+   */
+  void Configure (VlcModulation modulation, uint32_t n, uint32_t k, uint32_t symbolBits,
+                  double dimmingLevel);
+
+  /**
+   * Set the dimming level of the frames.
+   *
+   * \param dimmingLevel the average optical power relative to the peak
+   * power, strictly between 0 and 1
+   */
+  void SetDimmingLevel (double dimmingLevel);
+
+  /**
+   * Get the dimming level of the frames.
+   *
+   * \return the average optical power relative to the peak power
+   */
+  double GetDimmingLevel (void) const;
+
+  /**
+   * Set the resolution of the bit error rate table.
+   *
+   * \param resolution the step of the square root of the linear SNR between
+   * two table entries
+   */
+  void SetTableResolution (double resolution);
+
+  /**
+   * Get the resolution of the bit error rate table.
+   *
+   * \return the step of the square root of the linear SNR between two table
+   * entries
+   */
+  double GetTableResolution (void) const;
+
 private:
 
-  double m_binomialCoefficients[17];
+  /**
+   * Get the rate of the line code of the modulation scheme.
+   *
+   * \return the number of data bits per channel bit
+   */
+  double GetLineCodeRate (void) const;
+
+  /**
+   * Get the ratio of the SNR of the data to the SNR of the average optical
+   * power, for the modulation scheme and the dimming level.
+   *
+   * \return the SNR factor
+   */
+  double GetDimmingSnrFactor (void) const;
+
+  /**
+   * Get the bit error rate after Reed-Solomon decoding.
+   *
+   * \param p the bit error rate before decoding
+   * \return the bit error rate after decoding
+   */
+  double GetDecodedBer (double p) const;
+
+  /**
+   * Select the bit error rate table of the current parameters, building it
+   * on first use.
+   */
+  void UpdateTable (void);
+
+  VlcModulation m_modulation;   //!< the modulation scheme
+  uint32_t m_fecN;              //!< symbols per Reed-Solomon code word
+  uint32_t m_fecK;              //!< data symbols per Reed-Solomon code word
+  uint32_t m_fecSymbolBits;     //!< bits per Reed-Solomon symbol
+  double m_dimmingLevel;        //!< the dimming level of the frames
+  double m_resolution;          //!< step of sqrt (SNR) between table entries
+  double m_maxSqrtSnr;          //!< sqrt (SNR) of the last table entry
+
+  /**
+   * Logarithm of the bit success rate, ln (1 - BER), at
+   * sqrt (SNR) = i * m_resolution. Storing the logarithm turns the chunk
+   * success rate into a single exponentiation.
+   */
+  const std::vector<double> *m_logSuccessTable;
 
 };
 
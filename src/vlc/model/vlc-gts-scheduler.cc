@@ -0,0 +1,150 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-gts-scheduler.h"
+#include <ns3/log.h>
+#include <ns3/uinteger.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcGtsScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcGtsScheduler);
+
+const uint8_t VlcGtsScheduler::NUM_SUPERFRAME_SLOTS = 16;
+
+TypeId
+VlcGtsScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcGtsScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcGtsScheduler> ()
+    .AddAttribute ("MaxGts",
+                   "The maximum number of GTSs of a superframe.",
+                   UintegerValue (VlcMacBeaconHeader::MAX_GTS_DESCRIPTORS),
+                   MakeUintegerAccessor (&VlcGtsScheduler::m_maxGts),
+                   MakeUintegerChecker<uint32_t> (0, VlcMacBeaconHeader::MAX_GTS_DESCRIPTORS))
+  ;
+  return tid;
+}
+
+VlcGtsScheduler::VlcGtsScheduler (void)
+  : m_minCapSlots (1),
+    m_maxGts (VlcMacBeaconHeader::MAX_GTS_DESCRIPTORS)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcGtsScheduler::~VlcGtsScheduler (void)
+{
+}
+
+void
+VlcGtsScheduler::SetMinCapSlots (uint8_t minCapSlots)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (minCapSlots));
+  NS_ASSERT (minCapSlots >= 1 && minCapSlots <= NUM_SUPERFRAME_SLOTS);
+  m_minCapSlots = minCapSlots;
+}
+
+uint8_t
+VlcGtsScheduler::GetMinCapSlots (void) const
+{
+  return m_minCapSlots;
+}
+
+bool
+VlcGtsScheduler::Allocate (Mac16Address address, uint8_t length, VlcGtsDirection direction,
+                           VlcGtsDescriptor &descriptor)
+{
+  NS_LOG_FUNCTION (this << address << static_cast<uint32_t> (length) << direction);
+
+  if (length == 0 || m_allocations.size () >= m_maxGts
+      || GetFinalCapSlot () + 1 - length < m_minCapSlots)
+    {
+      NS_LOG_DEBUG ("No room for a GTS of " << static_cast<uint32_t> (length) << " slots");
+      return false;
+    }
+  for (uint32_t i = 0; i < m_allocations.size (); i++)
+    {
+      if (m_allocations[i].m_address == address && m_allocations[i].m_direction == direction)
+        {
+          NS_LOG_DEBUG ("Device " << address << " already has a GTS in this direction");
+          return false;
+        }
+    }
+
+  descriptor.m_address = address;
+  descriptor.m_length = length;
+  descriptor.m_direction = direction;
+  descriptor.m_startingSlot = GetFinalCapSlot () + 1 - length;
+  m_allocations.push_back (descriptor);
+  return true;
+}
+
+bool
+VlcGtsScheduler::Deallocate (Mac16Address address, VlcGtsDirection direction)
+{
+  NS_LOG_FUNCTION (this << address << direction);
+
+  for (std::vector<VlcGtsDescriptor>::iterator it = m_allocations.begin (); it != m_allocations.end (); ++it)
+    {
+      if (it->m_address == address && it->m_direction == direction)
+        {
+          m_allocations.erase (it);
+          Compact ();
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+VlcGtsScheduler::Clear (void)
+{
+  m_allocations.clear ();
+}
+
+uint8_t
+VlcGtsScheduler::GetFinalCapSlot (void) const
+{
+  if (m_allocations.empty ())
+    {
+      return NUM_SUPERFRAME_SLOTS - 1;
+    }
+  return m_allocations.back ().m_startingSlot - 1;
+}
+
+const std::vector<VlcGtsDescriptor>&
+VlcGtsScheduler::GetAllocations (void) const
+{
+  return m_allocations;
+}
+
+void
+VlcGtsScheduler::Compact (void)
+{
+  uint8_t slot = NUM_SUPERFRAME_SLOTS;
+  for (uint32_t i = 0; i < m_allocations.size (); i++)
+    {
+      slot -= m_allocations[i].m_length;
+      m_allocations[i].m_startingSlot = slot;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_GTS_SCHEDULER_H
+#define VLC_GTS_SCHEDULER_H
+
+#include "vlc-mac-beacon-header.h"
+#include <ns3/object.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The coordinator's allocation of guaranteed time slots.
+ *
+ * Requests are served first come, first served. The contention free period
+ * grows from the end of the active period: every new GTS is placed right
+ * before the GTSs already allocated, as long as at least MinCapSlots slots
+ * remain for the contention access period and at most MaxGts GTSs exist.
+ * After a deallocation the remaining GTSs are moved towards the end of the
+ * superframe, so that the contention access period is as long as possible.
+ */
+class VlcGtsScheduler : public Object
+{
+public:
+  /**
+   * The number of slots of a superframe.
+   */
+  static const uint8_t NUM_SUPERFRAME_SLOTS;
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcGtsScheduler (void);
+  virtual ~VlcGtsScheduler (void);
+
+  /**
+   * \param minCapSlots the number of slots required for the contention
+   * access period, at least 1 for the beacon
+   */
+  void SetMinCapSlots (uint8_t minCapSlots);
+
+  /**
+   * \return the number of slots required for the contention access period
+   */
+  uint8_t GetMinCapSlots (void) const;
+
+  /**
+   * Allocate a GTS.
+   *
+   * \param address the short address of the device
+   * \param length the number of slots
+   * \param direction the direction of the GTS
+   * \param [out] descriptor the allocated GTS
+   * \return true, if the GTS has been allocated
+   */
+  bool Allocate (Mac16Address address, uint8_t length, VlcGtsDirection direction,
+                 VlcGtsDescriptor &descriptor);
+
+  /**
+   * Deallocate a GTS and compact the contention free period.
+   *
+   * \param address the short address of the device
+   * \param direction the direction of the GTS
+   * \return true, if the device had a GTS in this direction
+   */
+  bool Deallocate (Mac16Address address, VlcGtsDirection direction);
+
+  /**
+   * Deallocate all GTSs.
+   */
+  void Clear (void);
+
+  /**
+   * \return the last slot of the contention access period
+   */
+  uint8_t GetFinalCapSlot (void) const;
+
+  /**
+   * \return the allocated GTSs, in order of allocation
+   */
+  const std::vector<VlcGtsDescriptor>& GetAllocations (void) const;
+
+private:
+  /**
+   * Assign the starting slots of the allocated GTSs from the end of the
+   * superframe.
+   */
+  void Compact (void);
+
+  std::vector<VlcGtsDescriptor> m_allocations;   //!< the allocated GTSs
+  uint8_t m_minCapSlots;                         //!< the minimum CAP length in slots
+  uint32_t m_maxGts;                             //!< the maximum number of GTSs
+};
+
+} // namespace ns3
+
+#endif /* VLC_GTS_SCHEDULER_H */
@@ -0,0 +1,256 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-handover-manager.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/enum.h>
+
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcHandoverManager");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcHandoverManager);
+
+TypeId
+VlcHandoverManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcHandoverManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcHandoverManager> ()
+    .AddAttribute ("Metric", "The measurement of the beacons the coordinators are compared on.",
+                   EnumValue (RX_POWER),
+                   MakeEnumAccessor (&VlcHandoverManager::m_metric),
+                   MakeEnumChecker (RX_POWER, "RxPower",
+                                    WQI, "Wqi"))
+    .AddAttribute ("Mode", "Break-before-make (Hard) or make-before-break (Soft) handovers.",
+                   EnumValue (HARD),
+                   MakeEnumAccessor (&VlcHandoverManager::m_mode),
+                   MakeEnumChecker (HARD, "Hard",
+                                    SOFT, "Soft"))
+    .AddAttribute ("Hysteresis",
+                   "The margin of the target over the serving coordinator, "
+                   "in dB for the received power, in WQI steps for the WQI.",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&VlcHandoverManager::m_hysteresis),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("TimeToTrigger", "How long the margin must hold before a handover.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&VlcHandoverManager::m_timeToTrigger),
+                   MakeTimeChecker ())
+    .AddAttribute ("FilterCoefficient",
+                   "The weight of the past in the filtered metric, zero to "
+                   "use the last beacon only.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&VlcHandoverManager::m_filterCoefficient),
+                   MakeDoubleChecker<double> (0, 0.99))
+    .AddAttribute ("CellTimeout", "How long a coordinator is remembered after its last beacon.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&VlcHandoverManager::m_cellTimeout),
+                   MakeTimeChecker ())
+    .AddTraceSource ("HandoverStart",
+                     "A handover has been requested.",
+                     MakeTraceSourceAccessor (&VlcHandoverManager::m_handoverStartTrace),
+                     "ns3::VlcHandoverManager::HandoverTracedCallback")
+    .AddTraceSource ("HandoverEnd",
+                     "A handover has completed.",
+                     MakeTraceSourceAccessor (&VlcHandoverManager::m_handoverEndTrace),
+                     "ns3::VlcHandoverManager::HandoverTracedCallback")
+    .AddTraceSource ("HandoverLatency",
+                     "The time from the request to the first beacon of the target.",
+                     MakeTraceSourceAccessor (&VlcHandoverManager::m_handoverLatencyTrace),
+                     "ns3::VlcHandoverManager::DurationTracedCallback")
+    .AddTraceSource ("InterruptionTime",
+                     "The time the MAC held its frames during a handover.",
+                     MakeTraceSourceAccessor (&VlcHandoverManager::m_interruptionTrace),
+                     "ns3::VlcHandoverManager::DurationTracedCallback")
+  ;
+  return tid;
+}
+
+VlcHandoverManager::VlcHandoverManager (void)
+  : m_metric (RX_POWER),
+    m_mode (HARD),
+    m_hysteresis (3.0),
+    m_timeToTrigger (MilliSeconds (100)),
+    m_filterCoefficient (0.5),
+    m_cellTimeout (Seconds (1)),
+    m_handoverPending (false),
+    m_sourceVpanId (0),
+    m_targetVpanId (0),
+    m_nHandovers (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcHandoverManager::~VlcHandoverManager (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VlcHandoverManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_mac != 0)
+    {
+      m_mac->SetMlmeBeaconNotifyIndicationCallback (MakeNullCallback<void, MlmeBeaconNotifyIndicationParams> ());
+      m_mac->SetMlmeHandoverConfirmCallback (MakeNullCallback<void, MlmeHandoverConfirmParams> ());
+    }
+  m_mac = 0;
+  m_cells.clear ();
+  Object::DoDispose ();
+}
+
+void
+VlcHandoverManager::SetMac (Ptr<VlcMac> mac)
+{
+  NS_LOG_FUNCTION (this << mac);
+  m_mac = mac;
+  m_mac->SetMlmeBeaconNotifyIndicationCallback (MakeCallback (&VlcHandoverManager::BeaconNotify, this));
+  m_mac->SetMlmeHandoverConfirmCallback (MakeCallback (&VlcHandoverManager::HandoverConfirm, this));
+}
+
+Ptr<VlcMac>
+VlcHandoverManager::GetMac (void) const
+{
+  return m_mac;
+}
+
+double
+VlcHandoverManager::GetMetric (uint16_t vpanId) const
+{
+  std::map<uint16_t, Cell>::const_iterator it = m_cells.find (vpanId);
+  if (it == m_cells.end () || Simulator::Now () - it->second.m_lastSeen > m_cellTimeout)
+    {
+      return -std::numeric_limits<double>::max ();
+    }
+  return it->second.m_metric;
+}
+
+uint32_t
+VlcHandoverManager::GetNHandovers (void) const
+{
+  return m_nHandovers;
+}
+
+void
+VlcHandoverManager::BeaconNotify (MlmeBeaconNotifyIndicationParams params)
+{
+  NS_LOG_FUNCTION (this << params.m_coordVpanId << static_cast<uint32_t> (params.m_linkQuality)
+                        << params.m_rxPower);
+
+  double sample = m_metric == RX_POWER ? params.m_rxPower : params.m_linkQuality;
+  std::map<uint16_t, Cell>::iterator it = m_cells.find (params.m_coordVpanId);
+  if (it == m_cells.end () || Simulator::Now () - it->second.m_lastSeen > m_cellTimeout)
+    {
+      Cell cell;
+      cell.m_metric = sample;
+      cell.m_better = false;
+      it = m_cells.insert (std::make_pair (params.m_coordVpanId, cell)).first;
+    }
+  else
+    {
+      it->second.m_metric = m_filterCoefficient * it->second.m_metric + (1 - m_filterCoefficient) * sample;
+    }
+  it->second.m_coordShortAddr = params.m_coordShortAddr;
+  it->second.m_lastSeen = Simulator::Now ();
+
+  Evaluate ();
+}
+
+void
+VlcHandoverManager::Evaluate (void)
+{
+  Time now = Simulator::Now ();
+  uint16_t servingVpanId = m_mac->GetVpanId ();
+  double servingMetric = GetMetric (servingVpanId);
+
+  std::map<uint16_t, Cell>::iterator best = m_cells.end ();
+  for (std::map<uint16_t, Cell>::iterator it = m_cells.begin (); it != m_cells.end (); it++)
+    {
+      Cell &cell = it->second;
+      if (it->first == servingVpanId || now - cell.m_lastSeen > m_cellTimeout
+          || cell.m_metric <= servingMetric + m_hysteresis)
+        {
+          cell.m_better = false;
+          continue;
+        }
+      if (!cell.m_better)
+        {
+          cell.m_better = true;
+          cell.m_betterSince = now;
+        }
+      if (now - cell.m_betterSince >= m_timeToTrigger
+          && (best == m_cells.end () || cell.m_metric > best->second.m_metric))
+        {
+          best = it;
+        }
+    }
+
+  if (best == m_cells.end () || m_handoverPending)
+    {
+      return;
+    }
+
+  NS_LOG_DEBUG ("Hand over from VPAN " << servingVpanId << " to VPAN " << best->first);
+  m_handoverPending = true;
+  m_sourceVpanId = servingVpanId;
+  m_targetVpanId = best->first;
+  m_handoverStart = now;
+  m_handoverStartTrace (m_sourceVpanId, m_targetVpanId);
+
+  MlmeHandoverRequestParams params;
+  params.m_vpanId = best->first;
+  params.m_coordShortAddr = best->second.m_coordShortAddr;
+  params.m_makeBeforeBreak = m_mode == SOFT;
+  // The request follows the processing of the beacon just measured.
+  Simulator::ScheduleNow (&VlcMac::MlmeHandoverRequest, m_mac, params);
+}
+
+void
+VlcHandoverManager::HandoverConfirm (MlmeHandoverConfirmParams params)
+{
+  NS_LOG_FUNCTION (this << params.m_status << params.m_vpanId);
+
+  if (!m_handoverPending)
+    {
+      return;
+    }
+  m_handoverPending = false;
+  for (std::map<uint16_t, Cell>::iterator it = m_cells.begin (); it != m_cells.end (); it++)
+    {
+      it->second.m_better = false;
+    }
+  if (params.m_status != MLME_SUCCESS)
+    {
+      NS_LOG_DEBUG ("Handover to VPAN " << m_targetVpanId << " failed, status " << params.m_status);
+      return;
+    }
+
+  m_nHandovers++;
+  Time latency = Simulator::Now () - m_handoverStart;
+  m_handoverEndTrace (m_sourceVpanId, m_targetVpanId);
+  m_handoverLatencyTrace (latency);
+  m_interruptionTrace (params.m_interruption);
+}
+
+} // namespace ns3
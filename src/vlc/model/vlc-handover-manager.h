@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_HANDOVER_MANAGER_H
+#define VLC_HANDOVER_MANAGER_H
+
+#include "vlc-mac.h"
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/traced-callback.h>
+
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * Attocell handover of a mobile VLC device.
+ *
+ * The manager measures the beacons of every coordinator the device hears,
+ * through the MLME-BEACON-NOTIFY.indication of its VlcMac, and keeps a
+ * filtered metric per coordinator: the received power in dBm or the WQI.
+ * When another coordinator stays better than the serving one by the
+ * Hysteresis for the TimeToTrigger, the manager hands the device over to the
+ * best such coordinator with an MLME-HANDOVER.request, break-before-make for
+ * a hard handover, make-before-break for a soft one. A coordinator not heard
+ * for CellTimeout is forgotten, so that any coordinator heard replaces a
+ * lost serving one.
+ *
+ * The handover latency runs from the request to the first beacon of the
+ * target. The interruption time is the part of it the MAC actually holds
+ * its frames, as reported in the MLME-HANDOVER.confirm: for a hard
+ * handover, from the end of the transaction in progress at the request to
+ * the first beacon of the target; a soft handover keeps sending.
+ */
+class VlcHandoverManager : public Object
+{
+public:
+  /**
+   * The measurement the coordinators are compared on.
+   */
+  enum Metric
+  {
+    RX_POWER,   //!< the received power of the beacons, in dBm
+    WQI         //!< the WQI of the beacons
+  };
+
+  /**
+   * The kind of handover.
+   */
+  enum Mode
+  {
+    HARD,       //!< break-before-make
+    SOFT        //!< make-before-break
+  };
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcHandoverManager (void);
+  virtual ~VlcHandoverManager (void);
+
+  /**
+   * TracedCallback signature for the start and end of a handover.
+   *
+   * \param [in] sourceVpanId the VPAN of the serving coordinator
+   * \param [in] targetVpanId the VPAN of the target coordinator
+   */
+  typedef void (* HandoverTracedCallback)(uint16_t sourceVpanId, uint16_t targetVpanId);
+
+  /**
+   * TracedCallback signature for the handover latency and the interruption
+   * time.
+   *
+   * \param [in] duration the duration
+   */
+  typedef void (* DurationTracedCallback)(Time duration);
+
+  /**
+   * Manage the handovers of a device. The manager takes the beacon notify
+   * and handover confirm callbacks of the MAC.
+   *
+   * \param mac the MAC of the device
+   */
+  void SetMac (Ptr<VlcMac> mac);
+
+  /**
+   * \return the MAC of the device
+   */
+  Ptr<VlcMac> GetMac (void) const;
+
+  /**
+   * \param vpanId the VPAN of a coordinator
+   * \return the filtered metric of the coordinator, or the lowest double if
+   * it has not been heard for CellTimeout
+   */
+  double GetMetric (uint16_t vpanId) const;
+
+  /**
+   * \return the number of completed handovers
+   */
+  uint32_t GetNHandovers (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * The measurements of a coordinator.
+   */
+  struct Cell
+  {
+    Mac16Address m_coordShortAddr;  //!< the short address of the coordinator
+    double m_metric;                //!< the filtered metric
+    Time m_lastSeen;                //!< the time of the last beacon
+    bool m_better;                  //!< whether it beats the serving coordinator
+    Time m_betterSince;             //!< since when it beats the serving coordinator
+  };
+
+  /**
+   * Measure a beacon and evaluate the handover criterion.
+   *
+   * \param params the indication parameters of the beacon
+   */
+  void BeaconNotify (MlmeBeaconNotifyIndicationParams params);
+
+  /**
+   * Finish the handover in progress.
+   *
+   * \param params the confirm parameters
+   */
+  void HandoverConfirm (MlmeHandoverConfirmParams params);
+
+  /**
+   * Hand over to the best coordinator beating the serving one for the
+   * TimeToTrigger, if any.
+   */
+  void Evaluate (void);
+
+  Ptr<VlcMac> m_mac;                  //!< the MAC of the device
+  std::map<uint16_t, Cell> m_cells;   //!< the coordinators heard, by VPAN
+  Metric m_metric;                    //!< the measurement compared
+  Mode m_mode;                        //!< the kind of handover
+  double m_hysteresis;                //!< the margin of the target over the serving coordinator
+  Time m_timeToTrigger;               //!< how long the margin must hold
+  double m_filterCoefficient;         //!< the weight of the past in the filtered metric
+  Time m_cellTimeout;                 //!< how long a coordinator is remembered
+  bool m_handoverPending;             //!< whether a handover is in progress
+  uint16_t m_sourceVpanId;            //!< the serving VPAN of the handover in progress
+  uint16_t m_targetVpanId;            //!< the target VPAN of the handover in progress
+  Time m_handoverStart;               //!< the start of the handover in progress
+  uint32_t m_nHandovers;              //!< the number of completed handovers
+
+  TracedCallback<uint16_t, uint16_t> m_handoverStartTrace;  //!< a handover started
+  TracedCallback<uint16_t, uint16_t> m_handoverEndTrace;    //!< a handover completed
+  TracedCallback<Time> m_handoverLatencyTrace;              //!< the latency of a completed handover
+  TracedCallback<Time> m_interruptionTrace;                 //!< the interruption time of a completed handover
+};
+
+} // namespace ns3
+
+#endif /* VLC_HANDOVER_MANAGER_H */
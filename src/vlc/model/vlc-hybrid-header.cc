@@ -0,0 +1,129 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-hybrid-header.h"
+#include <ns3/address-utils.h>
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (VlcHybridHeader);
+
+VlcHybridHeader::VlcHybridHeader (void)
+  : m_frameType (DATA),
+    m_protocol (0)
+{
+}
+
+TypeId
+VlcHybridHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcHybridHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcHybridHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VlcHybridHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VlcHybridHeader::Print (std::ostream &os) const
+{
+  os << "Type = " << (m_frameType == ACK ? "ACK" : "DATA")
+     << ", Protocol = " << m_protocol
+     << ", Src = " << m_src << ", Dst = " << m_dst;
+}
+
+uint32_t
+VlcHybridHeader::GetSerializedSize (void) const
+{
+  return 7;
+}
+
+void
+VlcHybridHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteU8 (m_frameType);
+  start.WriteHtolsbU16 (m_protocol);
+  WriteTo (start, m_src);
+  WriteTo (start, m_dst);
+}
+
+uint32_t
+VlcHybridHeader::Deserialize (Buffer::Iterator start)
+{
+  m_frameType = start.ReadU8 ();
+  m_protocol = start.ReadLsbtohU16 ();
+  ReadFrom (start, m_src);
+  ReadFrom (start, m_dst);
+  return GetSerializedSize ();
+}
+
+void
+VlcHybridHeader::SetFrameType (FrameType type)
+{
+  m_frameType = type;
+}
+
+VlcHybridHeader::FrameType
+VlcHybridHeader::GetFrameType (void) const
+{
+  return static_cast<FrameType> (m_frameType);
+}
+
+void
+VlcHybridHeader::SetProtocol (uint16_t protocol)
+{
+  m_protocol = protocol;
+}
+
+uint16_t
+VlcHybridHeader::GetProtocol (void) const
+{
+  return m_protocol;
+}
+
+void
+VlcHybridHeader::SetSrc (Mac16Address addr)
+{
+  m_src = addr;
+}
+
+Mac16Address
+VlcHybridHeader::GetSrc (void) const
+{
+  return m_src;
+}
+
+void
+VlcHybridHeader::SetDst (Mac16Address addr)
+{
+  m_dst = addr;
+}
+
+Mac16Address
+VlcHybridHeader::GetDst (void) const
+{
+  return m_dst;
+}
+
+} // namespace ns3
@@ -0,0 +1,119 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_HYBRID_HEADER_H
+#define VLC_HYBRID_HEADER_H
+
+#include <ns3/header.h>
+#include <ns3/mac16-address.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The header of the frames a VlcHybridNetDevice sends over the uplink.
+ *
+ * The uplink device has its own addresses, so the header carries the short
+ * addresses of the VLC link, along with the protocol number of the payload
+ * and whether the payload is data or the ACK of a downlink frame.
+ */
+class VlcHybridHeader : public Header
+{
+public:
+  /**
+   * The payload of the frame.
+   */
+  enum FrameType
+  {
+    DATA = 0,   //!< an upper layer packet
+    ACK = 1     //!< a MAC ACK frame of the VLC link
+  };
+
+  VlcHybridHeader (void);
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * Set the payload type.
+   *
+   * \param type the payload type
+   */
+  void SetFrameType (FrameType type);
+
+  /**
+   * \return the payload type
+   */
+  FrameType GetFrameType (void) const;
+
+  /**
+   * Set the protocol number of a data payload.
+   *
+   * \param protocol the protocol number
+   */
+  void SetProtocol (uint16_t protocol);
+
+  /**
+   * \return the protocol number of a data payload
+   */
+  uint16_t GetProtocol (void) const;
+
+  /**
+   * Set the short address of the sender.
+   *
+   * \param addr the address
+   */
+  void SetSrc (Mac16Address addr);
+
+  /**
+   * \return the short address of the sender
+   */
+  Mac16Address GetSrc (void) const;
+
+  /**
+   * Set the short address of the receiver.
+   *
+   * \param addr the address
+   */
+  void SetDst (Mac16Address addr);
+
+  /**
+   * \return the short address of the receiver
+   */
+  Mac16Address GetDst (void) const;
+
+private:
+  uint8_t m_frameType;  //!< the payload type
+  uint16_t m_protocol;  //!< the protocol number of a data payload
+  Mac16Address m_src;   //!< the short address of the sender
+  Mac16Address m_dst;   //!< the short address of the receiver
+};
+
+} // namespace ns3
+
+#endif /* VLC_HYBRID_HEADER_H */
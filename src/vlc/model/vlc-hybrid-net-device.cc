@@ -0,0 +1,486 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-hybrid-net-device.h"
+#include "vlc-net-device.h"
+#include <ns3/abort.h>
+#include <ns3/node.h>
+#include <ns3/channel.h>
+#include <ns3/log.h>
+#include <ns3/boolean.h>
+#include <ns3/enum.h>
+#include <ns3/uinteger.h>
+#include <ns3/packet.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcHybridNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcHybridNetDevice);
+
+VlcHybridCounters::VlcHybridCounters (void)
+  : m_txPackets (0),
+    m_txBytes (0),
+    m_rxPackets (0),
+    m_rxBytes (0),
+    m_txAcks (0),
+    m_rxAcks (0)
+{
+}
+
+TypeId
+VlcHybridNetDevice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcHybridNetDevice")
+    .SetParent<NetDevice> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcHybridNetDevice> ()
+    .AddAttribute ("Role", "The side of the VLC link.",
+                   EnumValue (ACCESS_POINT),
+                   MakeEnumAccessor (&VlcHybridNetDevice::SetRole,
+                                     &VlcHybridNetDevice::GetRole),
+                   MakeEnumChecker (ACCESS_POINT, "AccessPoint",
+                                    TERMINAL, "Terminal"))
+    .AddAttribute ("UplinkProtocol",
+                   "The protocol number of the frames sent over the uplink device.",
+                   UintegerValue (0x88B5),
+                   MakeUintegerAccessor (&VlcHybridNetDevice::m_uplinkProtocol),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddTraceSource ("DownlinkTx",
+                     "A packet has been sent over the VLC link.",
+                     MakeTraceSourceAccessor (&VlcHybridNetDevice::m_downlinkTxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("DownlinkRx",
+                     "A packet has been received over the VLC link.",
+                     MakeTraceSourceAccessor (&VlcHybridNetDevice::m_downlinkRxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("UplinkTx",
+                     "A packet has been sent over the uplink.",
+                     MakeTraceSourceAccessor (&VlcHybridNetDevice::m_uplinkTxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("UplinkRx",
+                     "A packet has been received over the uplink.",
+                     MakeTraceSourceAccessor (&VlcHybridNetDevice::m_uplinkRxTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+VlcHybridNetDevice::VlcHybridNetDevice ()
+  : m_role (ACCESS_POINT),
+    m_uplinkProtocol (0x88B5),
+    m_mtu (0),
+    m_configComplete (false),
+    m_ifIndex (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcHybridNetDevice::~VlcHybridNetDevice ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VlcHybridNetDevice::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_vlcDevice = 0;
+  m_uplinkDevice = 0;
+  m_node = 0;
+  m_receiveCallback.Nullify ();
+  NetDevice::DoDispose ();
+}
+
+void
+VlcHybridNetDevice::CompleteConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_vlcDevice == 0
+      || m_uplinkDevice == 0
+      || m_node == 0
+      || m_configComplete)
+    {
+      return;
+    }
+  m_vlcDevice->SetAttribute ("UseLlcSnap", BooleanValue (true));
+  m_node->RegisterProtocolHandler (MakeCallback (&VlcHybridNetDevice::ReceiveFromVlc, this),
+                                   0, m_vlcDevice);
+  m_node->RegisterProtocolHandler (MakeCallback (&VlcHybridNetDevice::ReceiveFromUplink, this),
+                                   m_uplinkProtocol, m_uplinkDevice);
+  if (m_role == TERMINAL)
+    {
+      m_vlcDevice->GetMac ()->SetAckRelayCallback (MakeCallback (&VlcHybridNetDevice::RelayAck, this));
+    }
+  m_configComplete = true;
+}
+
+void
+VlcHybridNetDevice::SetVlcDevice (Ptr<VlcNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_vlcDevice = device;
+  CompleteConfig ();
+}
+
+Ptr<VlcNetDevice>
+VlcHybridNetDevice::GetVlcDevice (void) const
+{
+  return m_vlcDevice;
+}
+
+void
+VlcHybridNetDevice::SetUplinkDevice (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_uplinkDevice = device;
+  CompleteConfig ();
+}
+
+Ptr<NetDevice>
+VlcHybridNetDevice::GetUplinkDevice (void) const
+{
+  return m_uplinkDevice;
+}
+
+void
+VlcHybridNetDevice::SetRole (Role role)
+{
+  NS_LOG_FUNCTION (this << role);
+  NS_ABORT_MSG_IF (m_configComplete, "The role can not change once the device is configured");
+  m_role = role;
+}
+
+VlcHybridNetDevice::Role
+VlcHybridNetDevice::GetRole (void) const
+{
+  return m_role;
+}
+
+void
+VlcHybridNetDevice::SetUplinkPeer (Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_uplinkPeer = address;
+}
+
+const VlcHybridCounters &
+VlcHybridNetDevice::GetDownlinkCounters (void) const
+{
+  return m_downlink;
+}
+
+const VlcHybridCounters &
+VlcHybridNetDevice::GetUplinkCounters (void) const
+{
+  return m_uplink;
+}
+
+void
+VlcHybridNetDevice::SetIfIndex (const uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  m_ifIndex = index;
+}
+
+uint32_t
+VlcHybridNetDevice::GetIfIndex (void) const
+{
+  return m_ifIndex;
+}
+
+Ptr<Channel>
+VlcHybridNetDevice::GetChannel (void) const
+{
+  return m_vlcDevice->GetChannel ();
+}
+
+void
+VlcHybridNetDevice::SetAddress (Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_vlcDevice->SetAddress (address);
+}
+
+Address
+VlcHybridNetDevice::GetAddress (void) const
+{
+  return m_vlcDevice->GetAddress ();
+}
+
+bool
+VlcHybridNetDevice::SetMtu (const uint16_t mtu)
+{
+  NS_LOG_FUNCTION (this << mtu);
+  uint16_t oldMtu = m_mtu;
+  m_mtu = 0;
+  if (mtu > GetMtu ())
+    {
+      NS_LOG_ERROR ("MTU " << mtu << " larger than the largest packet " << GetMtu ());
+      m_mtu = oldMtu;
+      return false;
+    }
+  m_mtu = mtu;
+  return true;
+}
+
+uint16_t
+VlcHybridNetDevice::GetMtu (void) const
+{
+  if (m_mtu != 0)
+    {
+      return m_mtu;
+    }
+  uint16_t uplinkMtu = m_uplinkDevice->GetMtu () - VlcHybridHeader ().GetSerializedSize ();
+  return std::min (m_vlcDevice->GetMtu (), uplinkMtu);
+}
+
+bool
+VlcHybridNetDevice::IsLinkUp (void) const
+{
+  return m_vlcDevice != 0 && m_vlcDevice->IsLinkUp ()
+         && m_uplinkDevice != 0 && m_uplinkDevice->IsLinkUp ();
+}
+
+void
+VlcHybridNetDevice::AddLinkChangeCallback (Callback<void> callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_vlcDevice->AddLinkChangeCallback (callback);
+  m_uplinkDevice->AddLinkChangeCallback (callback);
+}
+
+bool
+VlcHybridNetDevice::IsBroadcast (void) const
+{
+  return true;
+}
+
+Address
+VlcHybridNetDevice::GetBroadcast (void) const
+{
+  return Mac16Address ("ff:ff");
+}
+
+bool
+VlcHybridNetDevice::IsMulticast (void) const
+{
+  return true;
+}
+
+Address
+VlcHybridNetDevice::GetMulticast (Ipv4Address multicastGroup) const
+{
+  return m_vlcDevice->GetMulticast (multicastGroup);
+}
+
+Address
+VlcHybridNetDevice::GetMulticast (Ipv6Address addr) const
+{
+  return m_vlcDevice->GetMulticast (addr);
+}
+
+bool
+VlcHybridNetDevice::IsBridge (void) const
+{
+  return false;
+}
+
+bool
+VlcHybridNetDevice::IsPointToPoint (void) const
+{
+  return false;
+}
+
+bool
+VlcHybridNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << dest << protocolNumber);
+
+  if (packet->GetSize () > GetMtu ())
+    {
+      NS_LOG_ERROR ("Fragmentation is needed for this packet, drop the packet ");
+      return false;
+    }
+
+  uint32_t size = packet->GetSize ();
+  if (m_role == ACCESS_POINT)
+    {
+      m_downlinkTxTrace (packet);
+      if (!m_vlcDevice->Send (packet, dest, protocolNumber))
+        {
+          return false;
+        }
+      m_downlink.m_txPackets++;
+      m_downlink.m_txBytes += size;
+      return true;
+    }
+
+  VlcHybridHeader hdr;
+  hdr.SetFrameType (VlcHybridHeader::DATA);
+  hdr.SetProtocol (protocolNumber);
+  hdr.SetSrc (Mac16Address::ConvertFrom (GetAddress ()));
+  hdr.SetDst (Mac16Address::ConvertFrom (dest));
+  m_uplinkTxTrace (packet);
+  if (!SendUplink (packet, hdr))
+    {
+      return false;
+    }
+  m_uplink.m_txPackets++;
+  m_uplink.m_txBytes += size;
+  return true;
+}
+
+bool
+VlcHybridNetDevice::SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << source << dest << protocolNumber);
+  if (source != GetAddress ())
+    {
+      NS_LOG_ERROR ("Can not send from " << source << ", drop the packet");
+      return false;
+    }
+  return Send (packet, dest, protocolNumber);
+}
+
+bool
+VlcHybridNetDevice::SendUplink (Ptr<Packet> packet, const VlcHybridHeader &hdr)
+{
+  NS_LOG_FUNCTION (this << packet);
+  packet->AddHeader (hdr);
+  Address peer = m_uplinkPeer.IsInvalid () ? m_uplinkDevice->GetBroadcast () : m_uplinkPeer;
+  return m_uplinkDevice->Send (packet, peer, m_uplinkProtocol);
+}
+
+void
+VlcHybridNetDevice::RelayAck (McpsDataIndicationParams params, Ptr<Packet> ack)
+{
+  NS_LOG_FUNCTION (this << ack);
+  VlcHybridHeader hdr;
+  hdr.SetFrameType (VlcHybridHeader::ACK);
+  hdr.SetSrc (Mac16Address::ConvertFrom (GetAddress ()));
+  hdr.SetDst (params.m_srcAddr);
+  if (SendUplink (ack, hdr))
+    {
+      m_uplink.m_txAcks++;
+    }
+}
+
+void
+VlcHybridNetDevice::ReceiveFromVlc (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                    const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  NS_LOG_FUNCTION (this << device << packet << protocol << from);
+  if (m_role != TERMINAL)
+    {
+      // The terminals never send over the VLC link.
+      return;
+    }
+  m_downlink.m_rxPackets++;
+  m_downlink.m_rxBytes += packet->GetSize ();
+  m_downlinkRxTrace (packet);
+  if (!m_receiveCallback.IsNull ())
+    {
+      m_receiveCallback (this, packet, protocol, from);
+    }
+}
+
+void
+VlcHybridNetDevice::ReceiveFromUplink (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                       const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  NS_LOG_FUNCTION (this << device << packet << protocol << from);
+  if (m_role != ACCESS_POINT)
+    {
+      // Only the access point listens on the uplink.
+      return;
+    }
+
+  Ptr<Packet> p = packet->Copy ();
+  VlcHybridHeader hdr;
+  if (p->GetSize () < hdr.GetSerializedSize ())
+    {
+      NS_LOG_ERROR ("Frame without a hybrid header, drop the packet");
+      return;
+    }
+  p->RemoveHeader (hdr);
+
+  Mac16Address self = Mac16Address::ConvertFrom (GetAddress ());
+  if (hdr.GetFrameType () == VlcHybridHeader::ACK)
+    {
+      if (hdr.GetDst () == self)
+        {
+          m_uplink.m_rxAcks++;
+          m_vlcDevice->GetMac ()->ReceiveRelayedAck (p);
+        }
+      return;
+    }
+
+  if (hdr.GetDst () != self && hdr.GetDst () != Mac16Address ("ff:ff"))
+    {
+      return;
+    }
+  m_uplink.m_rxPackets++;
+  m_uplink.m_rxBytes += p->GetSize ();
+  m_uplinkRxTrace (p);
+  if (!m_receiveCallback.IsNull ())
+    {
+      m_receiveCallback (this, p, hdr.GetProtocol (), hdr.GetSrc ());
+    }
+}
+
+Ptr<Node>
+VlcHybridNetDevice::GetNode (void) const
+{
+  return m_node;
+}
+
+void
+VlcHybridNetDevice::SetNode (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this);
+  m_node = node;
+  CompleteConfig ();
+}
+
+bool
+VlcHybridNetDevice::NeedsArp (void) const
+{
+  return true;
+}
+
+void
+VlcHybridNetDevice::SetReceiveCallback (ReceiveCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_receiveCallback = cb;
+}
+
+void
+VlcHybridNetDevice::SetPromiscReceiveCallback (PromiscReceiveCallback cb)
+{
+  NS_LOG_WARN ("Unsupported; use the callbacks of the VLC and uplink devices instead");
+}
+
+bool
+VlcHybridNetDevice::SupportsSendFrom (void) const
+{
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,272 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_HYBRID_NET_DEVICE_H
+#define VLC_HYBRID_NET_DEVICE_H
+
+#include <ns3/net-device.h>
+#include <ns3/traced-callback.h>
+#include <ns3/vlc-mac.h>
+#include <ns3/vlc-hybrid-header.h>
+
+namespace ns3 {
+
+class VlcNetDevice;
+class Node;
+
+/**
+ * \ingroup vlc
+ *
+ * The packets and octets a VlcHybridNetDevice sent and received in one
+ * direction.
+ */
+struct VlcHybridCounters
+{
+  VlcHybridCounters (void);
+
+  uint32_t m_txPackets;  //!< upper layer packets sent
+  uint64_t m_txBytes;    //!< octets of the upper layer packets sent
+  uint32_t m_rxPackets;  //!< upper layer packets received
+  uint64_t m_rxBytes;    //!< octets of the upper layer packets received
+  uint32_t m_txAcks;     //!< MAC ACKs of the VLC link relayed
+  uint32_t m_rxAcks;     //!< MAC ACKs of the VLC link received over the relay
+};
+
+/**
+ * \ingroup vlc
+ *
+ * \brief An asymmetric device with a VLC downlink and an uplink over another
+ * NetDevice, e.g. Wi-Fi or IR.
+ *
+ * The access point sends over its VlcNetDevice and receives over its uplink
+ * device. A terminal receives over its VlcNetDevice and sends over its uplink
+ * device, to the uplink address of the access point. The MAC ACKs of the
+ * downlink frames are relayed over the uplink too, so the optical medium only
+ * carries the downlink and the access point keeps sending while the ACKs of
+ * its earlier frames come back.
+ *
+ * Both devices are added to the node on their own, their packets reach this
+ * device through protocol handlers. The VLC device carries the protocol
+ * number in an LLC/SNAP header, the uplink frames are sent with the
+ * UplinkProtocol protocol number and a VlcHybridHeader.
+ */
+class VlcHybridNetDevice : public NetDevice
+{
+public:
+  /**
+   * The side of the VLC link.
+   */
+  enum Role
+  {
+    ACCESS_POINT,  //!< sends over the VLC link, receives over the uplink
+    TERMINAL       //!< receives over the VLC link, sends over the uplink
+  };
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcHybridNetDevice (void);
+  virtual ~VlcHybridNetDevice (void);
+
+  /**
+   * Set the device of the VLC link.
+   *
+   * \param device the VlcNetDevice
+   */
+  void SetVlcDevice (Ptr<VlcNetDevice> device);
+
+  /**
+   * \return the device of the VLC link
+   */
+  Ptr<VlcNetDevice> GetVlcDevice (void) const;
+
+  /**
+   * Set the device of the uplink.
+   *
+   * \param device the device
+   */
+  void SetUplinkDevice (Ptr<NetDevice> device);
+
+  /**
+   * \return the device of the uplink
+   */
+  Ptr<NetDevice> GetUplinkDevice (void) const;
+
+  /**
+   * Set the side of the VLC link, before the device is configured.
+   *
+   * \param role the side
+   */
+  void SetRole (Role role);
+
+  /**
+   * \return the side of the VLC link
+   */
+  Role GetRole (void) const;
+
+  /**
+   * Set the uplink address a terminal sends to, the broadcast address of
+   * the uplink device by default.
+   *
+   * \param address the uplink address of the access point
+   */
+  void SetUplinkPeer (Address address);
+
+  /**
+   * \return the counters of the VLC link
+   */
+  const VlcHybridCounters & GetDownlinkCounters (void) const;
+
+  /**
+   * \return the counters of the uplink
+   */
+  const VlcHybridCounters & GetUplinkCounters (void) const;
+
+  // From class NetDevice
+  virtual void SetIfIndex (const uint32_t index);
+  virtual uint32_t GetIfIndex (void) const;
+  virtual Ptr<Channel> GetChannel (void) const;
+  /**
+   * This method indirects to VlcNetDevice::SetAddress ()
+   * \param address The short address.
+   */
+  virtual void SetAddress (Address address);
+  /**
+   * This method indirects to VlcNetDevice::GetAddress ()
+   * \returns The short address.
+   */
+  virtual Address GetAddress (void) const;
+  virtual bool SetMtu (const uint16_t mtu);
+  /**
+   * The MTU is the smaller of the MTU of the VLC device and the MTU of the
+   * uplink device less the VlcHybridHeader, unless a smaller MTU was set.
+   *
+   * \returns the MTU
+   */
+  virtual uint16_t GetMtu (void) const;
+  virtual bool IsLinkUp (void) const;
+  virtual void AddLinkChangeCallback (Callback<void> callback);
+  virtual bool IsBroadcast (void) const;
+  virtual Address GetBroadcast (void) const;
+  virtual bool IsMulticast (void) const;
+  virtual Address GetMulticast (Ipv4Address multicastGroup) const;
+  virtual Address GetMulticast (Ipv6Address addr) const;
+  virtual bool IsBridge (void) const;
+  virtual bool IsPointToPoint (void) const;
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+  /**
+   * Only packets from the short address of this device are accepted.
+   *
+   * \param packet the packet
+   * \param source the source address, the short address of this device
+   * \param dest the destination address
+   * \param protocolNumber the protocol number
+   * \returns false if the packet is too large or the source address differs
+   */
+  virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+  virtual Ptr<Node> GetNode (void) const;
+  virtual void SetNode (Ptr<Node> node);
+  virtual bool NeedsArp (void) const;
+
+  virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
+  virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
+  virtual bool SupportsSendFrom (void) const;
+
+private:
+  // Inherited from NetDevice/Object
+  virtual void DoDispose (void);
+
+  /**
+   * Register the protocol handlers and the ACK relay once the node and
+   * both devices are known.
+   */
+  void CompleteConfig (void);
+
+  /**
+   * Receive a packet of the VLC device.
+   *
+   * \param device the VLC device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender
+   * \param to the receiver
+   * \param packetType the packet type
+   */
+  void ReceiveFromVlc (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                       const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  /**
+   * Receive a packet of the uplink device.
+   *
+   * \param device the uplink device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender
+   * \param to the receiver
+   * \param packetType the packet type
+   */
+  void ReceiveFromUplink (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                          const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  /**
+   * Relay the ACK of a frame the VLC device received over the uplink.
+   *
+   * \param params the indication parameters of the acknowledged frame
+   * \param ack the ACK frame
+   */
+  void RelayAck (McpsDataIndicationParams params, Ptr<Packet> ack);
+
+  /**
+   * Send a frame over the uplink.
+   *
+   * \param packet the payload
+   * \param hdr the header of the frame
+   * \returns whether the uplink device accepted the frame
+   */
+  bool SendUplink (Ptr<Packet> packet, const VlcHybridHeader &hdr);
+
+  Ptr<VlcNetDevice> m_vlcDevice;  //!< the device of the VLC link
+  Ptr<NetDevice> m_uplinkDevice;  //!< the device of the uplink
+  Ptr<Node> m_node;               //!< the node of the device
+  Role m_role;                    //!< the side of the VLC link
+  Address m_uplinkPeer;           //!< the uplink address of the access point
+  uint16_t m_uplinkProtocol;      //!< the protocol number of the uplink frames
+  uint16_t m_mtu;                 //!< the MTU set, zero for the largest
+  bool m_configComplete;          //!< whether the handlers are registered
+  uint32_t m_ifIndex;             //!< the interface index of the device
+
+  VlcHybridCounters m_downlink;   //!< the counters of the VLC link
+  VlcHybridCounters m_uplink;     //!< the counters of the uplink
+
+  /**
+   * Upper layer callback used for notification of new data packet arrivals.
+   */
+  ReceiveCallback m_receiveCallback;
+
+  TracedCallback<Ptr<const Packet> > m_downlinkTxTrace;  //!< packets sent over the VLC link
+  TracedCallback<Ptr<const Packet> > m_downlinkRxTrace;  //!< packets received over the VLC link
+  TracedCallback<Ptr<const Packet> > m_uplinkTxTrace;    //!< packets sent over the uplink
+  TracedCallback<Ptr<const Packet> > m_uplinkRxTrace;    //!< packets received over the uplink
+};
+
+} // namespace ns3
+
+#endif /* VLC_HYBRID_NET_DEVICE_H */
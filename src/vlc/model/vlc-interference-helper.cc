@@ -17,19 +17,26 @@
  *  Abhay Sheel Anand <abhaysheelanand@gmail.com>
  */
 #include "vlc-interference-helper.h"
+#include "vlc-spectrum-value-helper.h"
 #include <ns3/spectrum-value.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/log.h>
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("VlcInterferenceHelper");
 
 VlcInterferenceHelper::VlcInterferenceHelper (Ptr<const SpectrumModel> spectrumModel)
   : m_spectrumModel (spectrumModel),
-    m_dirty (false)
+    m_dirty (false),
+    m_incremental (true),
+    m_resummationInterval (64),
+    m_removals (0)
 {
   m_signal = Create<SpectrumValue> (m_spectrumModel);
+  m_compensation.resize (m_spectrumModel->GetNumBands ());
 }
 
 VlcInterferenceHelper::~VlcInterferenceHelper (void)
@@ -48,10 +55,16 @@ VlcInterferenceHelper::AddSignal (Ptr<const SpectrumValue> signal)
 
   if (signal->GetSpectrumModel () == m_spectrumModel)
     {
-      result = m_signals.insert (signal).second;
-      if (result && !m_dirty)
+      // The vector only holds pointers, so a linear search is cheap compared
+      // to the PSD arithmetic below.
+      result = (std::find (m_signals.begin (), m_signals.end (), signal) == m_signals.end ());
+      if (result)
         {
-          *m_signal += *signal;
+          m_signals.push_back (signal);
+          if (!m_dirty)
+            {
+              *m_signal += *signal;
+            }
         }
     }
   return result;
@@ -66,10 +79,33 @@ VlcInterferenceHelper::RemoveSignal (Ptr<const SpectrumValue> signal)
 
   if (signal->GetSpectrumModel () == m_spectrumModel)
     {
-      result = (m_signals.erase (signal) == 1);
+      std::vector<Ptr<const SpectrumValue> >::iterator it;
+      it = std::find (m_signals.begin (), m_signals.end (), signal);
+      result = (it != m_signals.end ());
       if (result)
         {
-          m_dirty = true;
+          *it = m_signals.back ();
+          m_signals.pop_back ();
+
+          if (m_signals.empty ())
+            {
+              // No need to accumulate rounding errors, the sum is exactly zero.
+              *m_signal = 0.0;
+              m_removals = 0;
+              m_dirty = false;
+            }
+          else if (m_incremental && !m_dirty)
+            {
+              *m_signal -= *signal;
+              if (++m_removals >= m_resummationInterval)
+                {
+                  m_dirty = true;
+                }
+            }
+          else
+            {
+              m_dirty = true;
+            }
         }
     }
   return result;
@@ -81,7 +117,9 @@ VlcInterferenceHelper::ClearSignals (void)
   NS_LOG_FUNCTION (this);
 
   m_signals.clear ();
-  m_dirty = true;
+  *m_signal = 0.0;
+  m_removals = 0;
+  m_dirty = false;
 }
 
 Ptr<SpectrumValue>
@@ -89,19 +127,133 @@ VlcInterferenceHelper::GetSignalPsd (void) const
 {
   NS_LOG_FUNCTION (this);
 
+  UpdateSignalPsd ();
+
+  return m_signal->Copy ();
+}
+
+double
+VlcInterferenceHelper::GetSignalPower (uint32_t channel) const
+{
+  NS_LOG_FUNCTION (this << channel);
+
+  UpdateSignalPsd ();
+
+  return VlcSpectrumValueHelper::TotalAvgPower (m_signal, channel);
+}
+
+double
+VlcInterferenceHelper::GetInterferencePower (Ptr<const SpectrumValue> signal, uint32_t channel) const
+{
+  NS_LOG_FUNCTION (this << signal << channel);
+
+  UpdateSignalPsd ();
+
+  // The in-band power is linear in the PSD, so the power of the difference
+  // is the difference of the powers.
+  double interference = VlcSpectrumValueHelper::TotalAvgPower (m_signal, channel)
+    - VlcSpectrumValueHelper::TotalAvgPower (signal, channel);
+
+  // Guard against rounding errors when the wanted signal is the only one.
+  return std::max (interference, 0.0);
+}
+
+double
+VlcInterferenceHelper::GetSignalPower (const SpectrumValue &filter) const
+{
+  NS_LOG_FUNCTION (this);
+
+  UpdateSignalPsd ();
+
+  return VlcSpectrumValueHelper::TotalAvgPower (m_signal, filter);
+}
+
+double
+VlcInterferenceHelper::GetInterferencePower (Ptr<const SpectrumValue> signal, const SpectrumValue &filter) const
+{
+  NS_LOG_FUNCTION (this << signal);
+
+  UpdateSignalPsd ();
+
+  double interference = VlcSpectrumValueHelper::TotalAvgPower (m_signal, filter)
+    - VlcSpectrumValueHelper::TotalAvgPower (signal, filter);
+  return std::max (interference, 0.0);
+}
+
+void
+VlcInterferenceHelper::UpdateSignalPsd (void) const
+{
   if (m_dirty)
     {
-      // Sum up the current interference PSD.
-      std::set<Ptr<const SpectrumValue> >::const_iterator it;
-      m_signal = Create<SpectrumValue> (m_spectrumModel);
+      // Sum up the current interference PSD, reusing the existing buffer.
+      *m_signal = 0.0;
+      std::fill (m_compensation.begin (), m_compensation.end (), 0.0);
+      std::vector<Ptr<const SpectrumValue> >::const_iterator it;
       for (it = m_signals.begin (); it != m_signals.end (); ++it)
         {
-          *m_signal += *(*it);
+          Values::const_iterator in = (*it)->ConstValuesBegin ();
+          Values::iterator sum = m_signal->ValuesBegin ();
+          std::vector<double>::iterator c = m_compensation.begin ();
+          for (; sum != m_signal->ValuesEnd (); ++in, ++sum, ++c)
+            {
+              double y = *in - *c;
+              double t = *sum + y;
+              *c = (t - *sum) - y;
+              *sum = t;
+            }
         }
+      m_removals = 0;
       m_dirty = false;
     }
+}
 
-  return m_signal->Copy ();
+Ptr<const SpectrumModel>
+VlcInterferenceHelper::GetSpectrumModel (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_spectrumModel;
+}
+
+void
+VlcInterferenceHelper::SetIncremental (bool incremental)
+{
+  NS_LOG_FUNCTION (this << incremental);
+
+  m_incremental = incremental;
+}
+
+bool
+VlcInterferenceHelper::IsIncremental (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_incremental;
+}
+
+void
+VlcInterferenceHelper::SetResummationInterval (uint32_t interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  NS_ASSERT (interval > 0);
+
+  m_resummationInterval = interval;
+}
+
+uint32_t
+VlcInterferenceHelper::GetResummationInterval (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_resummationInterval;
+}
+
+uint32_t
+VlcInterferenceHelper::GetNSignals (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_signals.size ();
 }
 
 }
@@ -21,7 +21,7 @@
 
 #include <ns3/simple-ref-count.h>
 #include <ns3/ptr.h>
-#include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -72,12 +72,98 @@ public:
    */
   Ptr<SpectrumValue> GetSignalPsd (void) const;
 
+  /**
+   * Get the in-band power of the sum of all accumulated signals.
+   *
+   * In contrast to GetSignalPsd, no copy of the accumulated signals is made.
+   *
+   * \param channel the channel to integrate the power over
+   * \return the total power in W
+   */
+  double GetSignalPower (uint32_t channel) const;
+
+  /**
+   * Get the in-band power of all accumulated signals except the given one,
+   * i.e. the interference seen by a receiver synchronized to that signal.
+   *
+   * The power is computed from the sum of the signals and the given signal
+   * directly, without materializing their difference as a SpectrumValue.
+   *
+   * \param signal the wanted signal, which is expected to be accumulated
+   * \param channel the channel to integrate the power over
+   * \return the interference power in W
+   */
+  double GetInterferencePower (Ptr<const SpectrumValue> signal, uint32_t channel) const;
+
+  /**
+   * Get the power of the sum of all accumulated signals behind an optical
+   * filter.
+   *
+   * \param filter the power response of the filter
+   * \return the total power in W
+   */
+  double GetSignalPower (const SpectrumValue &filter) const;
+
+  /**
+   * Get the power of all accumulated signals except the given one behind an
+   * optical filter.
+   *
+   * \param signal the wanted signal, which is expected to be accumulated
+   * \param filter the power response of the filter
+   * \return the interference power in W
+   */
+  double GetInterferencePower (Ptr<const SpectrumValue> signal, const SpectrumValue &filter) const;
+
   /**
    * Get the SpectrumModel used by the helper.
    *
    * \return the helpers SpectrumModel
    */
   Ptr<const SpectrumModel> GetSpectrumModel (void) const;
+
+  /**
+   * Enable or disable incremental maintenance of the sum of the signals.
+   *
+   * In incremental mode, a removed signal is subtracted from the sum, so
+   * updating and querying the sum does not depend on the number of
+   * accumulated signals. To bound the floating point drift of repeated
+   * subtractions, the sum is recomputed from scratch after a configurable
+   * number of removals. Otherwise, every removal triggers a full
+   * recomputation on the next query. Incremental mode is enabled by default.
+   *
+   * \param incremental true to enable incremental mode
+   */
+  void SetIncremental (bool incremental);
+
+  /**
+   * Check whether incremental maintenance of the sum is enabled.
+   *
+   * \return true, if incremental mode is enabled
+   */
+  bool IsIncremental (void) const;
+
+  /**
+   * Set the number of removals after which the sum of the signals is
+   * recomputed from scratch in incremental mode.
+   *
+   * \param interval the number of removals, at least 1
+   */
+  void SetResummationInterval (uint32_t interval);
+
+  /**
+   * Get the number of removals after which the sum of the signals is
+   * recomputed from scratch in incremental mode.
+   *
+   * \return the number of removals
+   */
+  uint32_t GetResummationInterval (void) const;
+
+  /**
+   * Get the number of currently accumulated signals.
+   *
+   * \return the number of signals
+   */
+  uint32_t GetNSignals (void) const;
 private:
   // Disable implicit copy constructors
   /**
@@ -89,15 +175,24 @@ private:
    * \returns
    */
   VlcInterferenceHelper& operator= (VlcInterferenceHelper const &);
+
+  /**
+   * Recompute m_signal from the accumulated signals, if it is marked dirty.
+   * Kahan summation is used to keep the rounding error independent of the
+   * number of signals.
+   */
+  void UpdateSignalPsd (void) const;
+
   /**
    * The helpers SpectrumModel.
    */
   Ptr<const SpectrumModel> m_spectrumModel;
 
   /**
-   * The set of accumulated signals.
+   * The accumulated signals, in no particular order. A signal is removed by
+   * moving the last element into its slot.
    */
-  std::set<Ptr<const SpectrumValue> > m_signals;
+  std::vector<Ptr<const SpectrumValue> > m_signals;
 
   /**
    * The precomputed sum of all accumulated signals.
@@ -109,6 +204,27 @@ private:
    * to be recomputed before next use.
    */
   mutable bool m_dirty;
+
+  /**
+   * Per band compensation terms used while recomputing m_signal, kept to
+   * avoid an allocation on every recomputation.
+   */
+  mutable std::vector<double> m_compensation;
+
+  /**
+   * Subtract removed signals from m_signal instead of marking it dirty.
+   */
+  bool m_incremental;
+
+  /**
+   * Number of removals after which m_signal is recomputed in incremental mode.
+   */
+  uint32_t m_resummationInterval;
+
+  /**
+   * Number of signals subtracted from m_signal since it was last recomputed.
+   */
+  mutable uint32_t m_removals;
 };
 
 }
@@ -0,0 +1,387 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-lambertian-propagation-loss-model.h"
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/mobility-model.h>
+#include <ns3/constant-position-mobility-model.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcLambertianPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcLambertianPropagationLossModel);
+
+TypeId
+VlcLambertianPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcLambertianPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcLambertianPropagationLossModel> ()
+    .AddAttribute ("SemiAngle",
+                   "The semi-angle at half power of the emitter (degrees).",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&VlcLambertianPropagationLossModel::SetSemiAngle,
+                                       &VlcLambertianPropagationLossModel::GetSemiAngle),
+                   MakeDoubleChecker<double> (0.0, 90.0))
+    .AddAttribute ("PhotodetectorArea",
+                   "The physical area of the photodetector (m^2).",
+                   DoubleValue (1.0e-4),
+                   MakeDoubleAccessor (&VlcLambertianPropagationLossModel::SetPhotodetectorArea,
+                                       &VlcLambertianPropagationLossModel::GetPhotodetectorArea),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FieldOfView",
+                   "The field of view (half angle) of the receiver (degrees).",
+                   DoubleValue (70.0),
+                   MakeDoubleAccessor (&VlcLambertianPropagationLossModel::SetFieldOfView,
+                                       &VlcLambertianPropagationLossModel::GetFieldOfView),
+                   MakeDoubleChecker<double> (0.0, 90.0))
+    .AddAttribute ("FilterGain",
+                   "The linear gain of the optical filter.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&VlcLambertianPropagationLossModel::SetFilterGain,
+                                       &VlcLambertianPropagationLossModel::GetFilterGain),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("RefractiveIndex",
+                   "The refractive index of the optical concentrator.",
+                   DoubleValue (1.5),
+                   MakeDoubleAccessor (&VlcLambertianPropagationLossModel::SetRefractiveIndex,
+                                       &VlcLambertianPropagationLossModel::GetRefractiveIndex),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("TxNormal",
+                   "The orientation of the emitter. A zero vector lets the emitter face the receiver.",
+                   VectorValue (Vector (0.0, 0.0, 0.0)),
+                   MakeVectorAccessor (&VlcLambertianPropagationLossModel::SetTxNormal,
+                                       &VlcLambertianPropagationLossModel::GetTxNormal),
+                   MakeVectorChecker ())
+    .AddAttribute ("RxNormal",
+                   "The orientation of the photodetector. A zero vector lets the photodetector face the emitter.",
+                   VectorValue (Vector (0.0, 0.0, 0.0)),
+                   MakeVectorAccessor (&VlcLambertianPropagationLossModel::SetRxNormal,
+                                       &VlcLambertianPropagationLossModel::GetRxNormal),
+                   MakeVectorChecker ())
+    .AddAttribute ("CacheGains",
+                   "Cache the gain of links between ConstantPositionMobilityModel endpoints.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&VlcLambertianPropagationLossModel::SetCacheEnabled,
+                                        &VlcLambertianPropagationLossModel::IsCacheEnabled),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+VlcLambertianPropagationLossModel::VlcLambertianPropagationLossModel (void)
+  : m_semiAngle (60.0),
+    m_area (1.0e-4),
+    m_fov (70.0),
+    m_filterGain (1.0),
+    m_refractiveIndex (1.5),
+    m_txNormal (0.0, 0.0, 0.0),
+    m_rxNormal (0.0, 0.0, 0.0),
+    m_cacheEnabled (true)
+{
+  NS_LOG_FUNCTION (this);
+  UpdateParameters ();
+}
+
+VlcLambertianPropagationLossModel::~VlcLambertianPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VlcLambertianPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  ClearCache ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+VlcLambertianPropagationLossModel::SetSemiAngle (double semiAngle)
+{
+  NS_LOG_FUNCTION (this << semiAngle);
+  m_semiAngle = semiAngle;
+  UpdateParameters ();
+}
+
+double
+VlcLambertianPropagationLossModel::GetSemiAngle (void) const
+{
+  return m_semiAngle;
+}
+
+void
+VlcLambertianPropagationLossModel::SetPhotodetectorArea (double area)
+{
+  NS_LOG_FUNCTION (this << area);
+  m_area = area;
+  UpdateParameters ();
+}
+
+double
+VlcLambertianPropagationLossModel::GetPhotodetectorArea (void) const
+{
+  return m_area;
+}
+
+void
+VlcLambertianPropagationLossModel::SetFieldOfView (double fov)
+{
+  NS_LOG_FUNCTION (this << fov);
+  m_fov = fov;
+  UpdateParameters ();
+}
+
+double
+VlcLambertianPropagationLossModel::GetFieldOfView (void) const
+{
+  return m_fov;
+}
+
+void
+VlcLambertianPropagationLossModel::SetFilterGain (double gain)
+{
+  NS_LOG_FUNCTION (this << gain);
+  m_filterGain = gain;
+  UpdateParameters ();
+}
+
+double
+VlcLambertianPropagationLossModel::GetFilterGain (void) const
+{
+  return m_filterGain;
+}
+
+void
+VlcLambertianPropagationLossModel::SetRefractiveIndex (double index)
+{
+  NS_LOG_FUNCTION (this << index);
+  m_refractiveIndex = index;
+  UpdateParameters ();
+}
+
+double
+VlcLambertianPropagationLossModel::GetRefractiveIndex (void) const
+{
+  return m_refractiveIndex;
+}
+
+void
+VlcLambertianPropagationLossModel::SetTxNormal (const Vector &normal)
+{
+  NS_LOG_FUNCTION (this << normal);
+  m_txNormal = normal;
+  UpdateParameters ();
+}
+
+Vector
+VlcLambertianPropagationLossModel::GetTxNormal (void) const
+{
+  return m_txNormal;
+}
+
+void
+VlcLambertianPropagationLossModel::SetRxNormal (const Vector &normal)
+{
+  NS_LOG_FUNCTION (this << normal);
+  m_rxNormal = normal;
+  UpdateParameters ();
+}
+
+Vector
+VlcLambertianPropagationLossModel::GetRxNormal (void) const
+{
+  return m_rxNormal;
+}
+
+void
+VlcLambertianPropagationLossModel::SetCacheEnabled (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_cacheEnabled = enable;
+  if (!m_cacheEnabled)
+    {
+      ClearCache ();
+    }
+}
+
+bool
+VlcLambertianPropagationLossModel::IsCacheEnabled (void) const
+{
+  return m_cacheEnabled;
+}
+
+void
+VlcLambertianPropagationLossModel::UpdateParameters (void)
+{
+  double semiAngle = m_semiAngle * M_PI / 180.0;
+  double fov = m_fov * M_PI / 180.0;
+
+  m_lambertianOrder = -std::log (2.0) / std::log (std::cos (semiAngle));
+  m_cosFov = std::cos (fov);
+
+  double concentratorGain = m_refractiveIndex * m_refractiveIndex / std::pow (std::sin (fov), 2);
+  m_constantGain = (m_lambertianOrder + 1) * m_area * m_filterGain * concentratorGain / (2 * M_PI);
+
+  // Every cached gain depends on the parameters.
+  std::vector<std::vector<double> >::iterator row;
+  for (row = m_gainDb.begin (); row != m_gainDb.end (); ++row)
+    {
+      std::fill (row->begin (), row->end (), std::numeric_limits<double>::quiet_NaN ());
+    }
+}
+
+double
+VlcLambertianPropagationLossModel::CalcGainDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  Vector los = b->GetPosition () - a->GetPosition ();
+  double distance = los.GetLength ();
+  if (distance == 0)
+    {
+      return 0.0;
+    }
+
+  double cosIrradiance = 1.0;
+  double txNormalLength = m_txNormal.GetLength ();
+  if (txNormalLength > 0)
+    {
+      cosIrradiance = (m_txNormal.x * los.x + m_txNormal.y * los.y + m_txNormal.z * los.z)
+        / (txNormalLength * distance);
+    }
+
+  double cosIncidence = 1.0;
+  double rxNormalLength = m_rxNormal.GetLength ();
+  if (rxNormalLength > 0)
+    {
+      cosIncidence = -(m_rxNormal.x * los.x + m_rxNormal.y * los.y + m_rxNormal.z * los.z)
+        / (rxNormalLength * distance);
+    }
+
+  if (cosIrradiance <= 0 || cosIncidence < m_cosFov || cosIncidence <= 0)
+    {
+      // Behind the emitter or outside the field of view of the receiver.
+      return -std::numeric_limits<double>::infinity ();
+    }
+
+  double gain = m_constantGain * std::pow (cosIrradiance, m_lambertianOrder) * cosIncidence
+    / (distance * distance);
+
+  // The receiver can not collect more than the emitted power.
+  return 10 * std::log10 (std::min (gain, 1.0));
+}
+
+double
+VlcLambertianPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                  Ptr<MobilityModel> a,
+                                                  Ptr<MobilityModel> b) const
+{
+  uint32_t i;
+  uint32_t j;
+
+  if (m_cacheEnabled && GetCacheIndex (a, i) && GetCacheIndex (b, j))
+    {
+      double &gainDb = m_gainDb[i][j];
+      if (std::isnan (gainDb))
+        {
+          gainDb = CalcGainDb (a, b);
+          NS_LOG_DEBUG ("cached gain " << i << " -> " << j << ": " << gainDb << " dB");
+        }
+      return txPowerDbm + gainDb;
+    }
+
+  return txPowerDbm + CalcGainDb (a, b);
+}
+
+int64_t
+VlcLambertianPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+bool
+VlcLambertianPropagationLossModel::GetCacheIndex (Ptr<MobilityModel> m, uint32_t &index) const
+{
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_cacheIndex.find (PeekPointer (m));
+  if (it != m_cacheIndex.end ())
+    {
+      index = it->second;
+      return true;
+    }
+
+  if (DynamicCast<ConstantPositionMobilityModel> (m) == 0)
+    {
+      return false;
+    }
+
+  // Grow the matrix by one row and one column.
+  index = m_cachedModels.size ();
+  m_cacheIndex[PeekPointer (m)] = index;
+  m_cachedModels.push_back (m);
+  std::vector<std::vector<double> >::iterator row;
+  for (row = m_gainDb.begin (); row != m_gainDb.end (); ++row)
+    {
+      row->push_back (std::numeric_limits<double>::quiet_NaN ());
+    }
+  m_gainDb.push_back (std::vector<double> (index + 1, std::numeric_limits<double>::quiet_NaN ()));
+
+  m->TraceConnectWithoutContext ("CourseChange",
+                                 MakeCallback (&VlcLambertianPropagationLossModel::CourseChanged, this));
+  return true;
+}
+
+void
+VlcLambertianPropagationLossModel::CourseChanged (Ptr<const MobilityModel> m) const
+{
+  NS_LOG_FUNCTION (this << m);
+
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_cacheIndex.find (PeekPointer (m));
+  if (it != m_cacheIndex.end ())
+    {
+      uint32_t index = it->second;
+      std::fill (m_gainDb[index].begin (), m_gainDb[index].end (), std::numeric_limits<double>::quiet_NaN ());
+      for (uint32_t i = 0; i < m_gainDb.size (); i++)
+        {
+          m_gainDb[i][index] = std::numeric_limits<double>::quiet_NaN ();
+        }
+    }
+}
+
+void
+VlcLambertianPropagationLossModel::ClearCache (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<Ptr<MobilityModel> >::iterator it;
+  for (it = m_cachedModels.begin (); it != m_cachedModels.end (); ++it)
+    {
+      (*it)->TraceDisconnectWithoutContext ("CourseChange",
+                                            MakeCallback (&VlcLambertianPropagationLossModel::CourseChanged, this));
+    }
+  m_cachedModels.clear ();
+  m_cacheIndex.clear ();
+  m_gainDb.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,273 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_LAMBERTIAN_PROPAGATION_LOSS_MODEL_H
+#define VLC_LAMBERTIAN_PROPAGATION_LOSS_MODEL_H
+
+#include <ns3/propagation-loss-model.h>
+#include <ns3/vector.h>
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup vlc
+ *
+ * Line of sight channel gain of an optical link between a Lambertian emitter
+ * and a photodetector:
+ *
+ * \f[
+ *   H = \frac{(m + 1) A}{2 \pi d^2} \cos^m(\phi) T_s g(\psi) \cos(\psi),
+ *   \quad 0 \le \psi \le \Psi_c
+ * \f]
+ *
+ * where \f$ m = -\ln 2 / \ln(\cos \Phi_{1/2}) \f$ is the Lambertian order of
+ * the emitter with semi-angle at half power \f$ \Phi_{1/2} \f$, A the
+ * photodetector area, \f$ \phi \f$ the angle of irradiance, \f$ \psi \f$
+ * the angle of incidence, \f$ T_s \f$ the optical filter gain,
+ * \f$ g(\psi) = n^2 / \sin^2 \Psi_c \f$ the gain of a concentrator with
+ * refractive index n and \f$ \Psi_c \f$ the field of view of the receiver.
+ * Outside the field of view the gain is zero. The gain never exceeds one.
+ *
+ * The transmitter and receiver orientations are given by the TxNormal and
+ * RxNormal attributes. A zero vector means the device faces its peer, i.e.
+ * the corresponding angle is zero.
+ *
+ * The gain of links between two ConstantPositionMobilityModel endpoints is
+ * cached in a dense matrix, so only the first packet on such a link pays for
+ * the trigonometry. A cached row and column are invalidated when the
+ * corresponding mobility model reports a course change.
+ */
+class VlcLambertianPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcLambertianPropagationLossModel (void);
+  virtual ~VlcLambertianPropagationLossModel (void);
+
+  /**
+   * Set the semi-angle at half power of the emitter.
+   *
+   * \param semiAngle the semi-angle in degrees
+   */
+  void SetSemiAngle (double semiAngle);
+
+  /**
+   * Get the semi-angle at half power of the emitter.
+   *
+   * \return the semi-angle in degrees
+   */
+  double GetSemiAngle (void) const;
+
+  /**
+   * Set the physical area of the photodetector.
+   *
+   * \param area the area in square meters
+   */
+  void SetPhotodetectorArea (double area);
+
+  /**
+   * Get the physical area of the photodetector.
+   *
+   * \return the area in square meters
+   */
+  double GetPhotodetectorArea (void) const;
+
+  /**
+   * Set the field of view of the receiver.
+   *
+   * \param fov the field of view (half angle) in degrees
+   */
+  void SetFieldOfView (double fov);
+
+  /**
+   * Get the field of view of the receiver.
+   *
+   * \return the field of view (half angle) in degrees
+   */
+  double GetFieldOfView (void) const;
+
+  /**
+   * Set the gain of the optical filter.
+   *
+   * \param gain the linear filter gain
+   */
+  void SetFilterGain (double gain);
+
+  /**
+   * Get the gain of the optical filter.
+   *
+   * \return the linear filter gain
+   */
+  double GetFilterGain (void) const;
+
+  /**
+   * Set the refractive index of the optical concentrator.
+   *
+   * \param index the refractive index
+   */
+  void SetRefractiveIndex (double index);
+
+  /**
+   * Get the refractive index of the optical concentrator.
+   *
+   * \return the refractive index
+   */
+  double GetRefractiveIndex (void) const;
+
+  /**
+   * Set the orientation of the emitter.
+   *
+   * \param normal the normal vector of the emitter, or a zero vector to let
+   * the emitter face the receiver
+   */
+  void SetTxNormal (const Vector &normal);
+
+  /**
+   * Get the orientation of the emitter.
+   *
+   * \return the normal vector of the emitter
+   */
+  Vector GetTxNormal (void) const;
+
+  /**
+   * Set the orientation of the photodetector.
+   *
+   * \param normal the normal vector of the photodetector, or a zero vector to
+   * let the photodetector face the emitter
+   */
+  void SetRxNormal (const Vector &normal);
+
+  /**
+   * Get the orientation of the photodetector.
+   *
+   * \return the normal vector of the photodetector
+   */
+  Vector GetRxNormal (void) const;
+
+  /**
+   * Enable or disable caching of the gain between static endpoints.
+   *
+   * \param enable true to enable caching
+   */
+  void SetCacheEnabled (bool enable);
+
+  /**
+   * Check whether caching of the gain between static endpoints is enabled.
+   *
+   * \return true, if caching is enabled
+   */
+  bool IsCacheEnabled (void) const;
+
+  /**
+   * Compute the channel gain between two positions, bypassing the cache.
+   *
+   * \param a the mobility model of the transmitter
+   * \param b the mobility model of the receiver
+   * \return the channel gain in dB
+   */
+  double CalcGainDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor - defined and not implemented.
+   */
+  VlcLambertianPropagationLossModel (const VlcLambertianPropagationLossModel &);
+  /**
+   * \brief Copy constructor - defined and not implemented.
+   * \returns
+   */
+  VlcLambertianPropagationLossModel & operator = (const VlcLambertianPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * Get the index of the given mobility model in the gain matrix. Static
+   * mobility models are added to the matrix on first use.
+   *
+   * \param m the mobility model
+   * \param [out] index the index of the mobility model
+   * \return false, if the mobility model can not be cached, true otherwise
+   */
+  bool GetCacheIndex (Ptr<MobilityModel> m, uint32_t &index) const;
+
+  /**
+   * Invalidate the cached gains of a mobility model.
+   *
+   * \param m the mobility model that changed its course
+   */
+  void CourseChanged (Ptr<const MobilityModel> m) const;
+
+  /**
+   * Drop all cached gains and disconnect from the mobility models.
+   */
+  void ClearCache (void);
+
+  /**
+   * Recompute the derived parameters and drop all cached gains.
+   */
+  void UpdateParameters (void);
+
+  double m_semiAngle;        //!< semi-angle at half power of the emitter (degrees)
+  double m_area;             //!< photodetector area (m^2)
+  double m_fov;              //!< receiver field of view (degrees)
+  double m_filterGain;       //!< optical filter gain
+  double m_refractiveIndex;  //!< refractive index of the concentrator
+  Vector m_txNormal;         //!< orientation of the emitter
+  Vector m_rxNormal;         //!< orientation of the photodetector
+  bool m_cacheEnabled;       //!< cache the gain between static endpoints
+
+  double m_lambertianOrder;  //!< Lambertian order m of the emitter
+  double m_cosFov;           //!< cosine of the field of view
+  double m_constantGain;     //!< (m + 1) A Ts g / (2 pi)
+
+  /**
+   * Index of the cached mobility models in the gain matrix.
+   */
+  mutable std::map<const MobilityModel *, uint32_t> m_cacheIndex;
+
+  /**
+   * The cached mobility models, in order of their index.
+   */
+  mutable std::vector<Ptr<MobilityModel> > m_cachedModels;
+
+  /**
+   * The cached gains in dB, indexed by transmitter and receiver. NaN marks a
+   * gain that still has to be computed.
+   */
+  mutable std::vector<std::vector<double> > m_gainDb;
+};
+
+} // namespace ns3
+
+#endif /* VLC_LAMBERTIAN_PROPAGATION_LOSS_MODEL_H */
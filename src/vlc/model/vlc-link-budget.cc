@@ -0,0 +1,214 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-link-budget.h"
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/pointer.h>
+#include <ns3/angles.h>
+#include <ns3/antenna-model.h>
+#include <ns3/mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/spectrum-value.h>
+
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcLinkBudget");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcLinkBudget);
+
+TypeId
+VlcLinkBudget::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcLinkBudget")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcLinkBudget> ()
+    .AddAttribute ("PropagationLossModel",
+                   "The propagation loss model of the channel.",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcLinkBudget::SetPropagationLossModel,
+                                        &VlcLinkBudget::GetPropagationLossModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("MaxLossDb",
+                   "The maximum loss in dB for which frames can be received, "
+                   "as the MaxLossDb attribute of VlcSpectrumChannel.",
+                   DoubleValue (1.0e9),
+                   MakeDoubleAccessor (&VlcLinkBudget::m_maxLossDb),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+VlcLinkBudget::VlcLinkBudget (void)
+  : m_maxLossDb (1.0e9)
+{
+  NS_LOG_FUNCTION (this);
+  m_random = CreateObject<UniformRandomVariable> ();
+}
+
+VlcLinkBudget::~VlcLinkBudget (void)
+{
+}
+
+void
+VlcLinkBudget::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_propagationLoss = 0;
+  m_random = 0;
+  Object::DoDispose ();
+}
+
+void
+VlcLinkBudget::SetPropagationLossModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_propagationLoss = model;
+}
+
+Ptr<PropagationLossModel>
+VlcLinkBudget::GetPropagationLossModel (void) const
+{
+  return m_propagationLoss;
+}
+
+Ptr<SpectrumValue>
+VlcLinkBudget::GetRxPowerSpectralDensity (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx) const
+{
+  return GetRxPowerSpectralDensity (tx, rx, tx->GetDimmingLevel ());
+}
+
+Ptr<SpectrumValue>
+VlcLinkBudget::GetRxPowerSpectralDensity (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, double dimmingLevel) const
+{
+  NS_LOG_FUNCTION (this << tx << rx << dimmingLevel);
+  NS_ASSERT (tx->GetTxPowerSpectralDensity ());
+
+  // Same path gain as VlcSpectrumChannel::Deliver; the transmitter has no
+  // antenna.
+  Ptr<MobilityModel> txMobility = tx->GetMobility ();
+  Ptr<MobilityModel> rxMobility = rx->GetMobility ();
+  double pathGainLinear = 1.0;
+  if (txMobility && rxMobility)
+    {
+      double pathLossDb = 0;
+      Ptr<AntennaModel> rxAntenna = rx->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+          pathLossDb -= rxAntenna->GetGainDb (rxAngles);
+        }
+      if (m_propagationLoss)
+        {
+          pathLossDb -= m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+        }
+      if (pathLossDb > m_maxLossDb)
+        {
+          return 0;
+        }
+      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+    }
+
+  Ptr<SpectrumValue> rxPsd = tx->GetTxPowerSpectralDensity ()->Copy ();
+  *rxPsd *= pathGainLinear * VlcPhy::GetDimmingPowerFactor (dimmingLevel);
+  return rxPsd;
+}
+
+double
+VlcLinkBudget::GetPacketSuccessRate (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize) const
+{
+  NS_LOG_FUNCTION (this << tx << rx << psduSize);
+  Ptr<SpectrumValue> rxPsd = GetRxPowerSpectralDensity (tx, rx);
+  if (rxPsd == 0)
+    {
+      return 0;
+    }
+  return rx->GetPacketSuccessRate (rxPsd, psduSize, tx->GetMcs (), tx->GetDimmingLevel ());
+}
+
+uint32_t
+VlcLinkBudget::GetReceivedFrames (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize, uint32_t nFrames)
+{
+  NS_LOG_FUNCTION (this << tx << rx << psduSize << nFrames);
+  double per = 1.0 - GetPacketSuccessRate (tx, rx, psduSize);
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      // The decision rule of VlcPhy::CheckInterference.
+      if (!(m_random->GetValue () < per))
+        {
+          received++;
+        }
+    }
+  return received;
+}
+
+double
+VlcLinkBudget::GetGoodput (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize, VlcPhyMcs mcs,
+                           double dimmingLevel) const
+{
+  NS_LOG_FUNCTION (this << tx << rx << psduSize << mcs << dimmingLevel);
+  Ptr<SpectrumValue> rxPsd = GetRxPowerSpectralDensity (tx, rx, dimmingLevel);
+  if (rxPsd == 0)
+    {
+      return 0;
+    }
+  double psr = rx->GetPacketSuccessRate (rxPsd, psduSize, mcs, dimmingLevel);
+  return psr * psduSize * 8.0 / VlcPhy::GetPpduDuration (mcs, psduSize, dimmingLevel).GetSeconds ();
+}
+
+VlcPhyMcs
+VlcLinkBudget::GetBestMcs (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize, double dimmingLevel) const
+{
+  NS_LOG_FUNCTION (this << tx << rx << psduSize << dimmingLevel);
+  uint8_t phyType = VlcPhy::GetMcsParameters (tx->GetMcs ()).phyType;
+  VlcPhyMcs best = IEEE_802_15_7_INVALID_MCS;
+  double bestGoodput = -1;
+  for (uint32_t i = 0; i < IEEE_802_15_7_INVALID_MCS; i++)
+    {
+      VlcPhyMcs mcs = VlcPhyMcs (i);
+      const VlcPhyMcsParameters &params = VlcPhy::GetMcsParameters (mcs);
+      if (params.phyType != phyType)
+        {
+          continue;
+        }
+      double goodput = GetGoodput (tx, rx, psduSize, mcs, dimmingLevel);
+      if (goodput > bestGoodput
+          || (goodput == bestGoodput && params.bitRate < VlcPhy::GetMcsParameters (best).bitRate))
+        {
+          best = mcs;
+          bestGoodput = goodput;
+        }
+    }
+  NS_LOG_DEBUG ("Best scheme at dimming level " << dimmingLevel << ": " << best
+                << ", " << bestGoodput << " b/s");
+  return best;
+}
+
+int64_t
+VlcLinkBudget::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_random->SetStream (stream);
+  return 1;
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_LINK_BUDGET_H
+#define VLC_LINK_BUDGET_H
+
+#include <ns3/object.h>
+#include <ns3/vlc-phy.h>
+
+namespace ns3 {
+
+class PropagationLossModel;
+class SpectrumValue;
+class UniformRandomVariable;
+
+/**
+ * \ingroup vlc
+ *
+ * Link budget of a pair of PHYs, evaluated without running the simulator.
+ *
+ * The received power spectral density is computed as VlcSpectrumChannel
+ * does for a transmission of the first PHY, and the packet success rate is
+ * the one of VlcPhy::GetPacketSuccessRate for a frame that no other signal
+ * overlaps. Frames can also be drawn one by one with the same decision rule
+ * as the receive path, which gives the same distribution of the number of
+ * received frames as a simulation of an interference-free link, at the cost
+ * of one random draw per frame.
+ *
+ * Frames are sent at the dimming level of the first PHY. For a dimming
+ * target, GetBestMcs selects the scheme of the PHY type with the highest
+ * goodput, trading the compensation symbols of OOK against the pulse width
+ * of VPPM.
+ */
+class VlcLinkBudget : public Object
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcLinkBudget (void);
+  virtual ~VlcLinkBudget (void);
+
+  /**
+   * \param model the propagation loss model of the channel, or 0 for none
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> model);
+
+  /**
+   * \return the propagation loss model of the channel
+   */
+  Ptr<PropagationLossModel> GetPropagationLossModel (void) const;
+
+  /**
+   * Get the power spectral density received by a PHY from another one, at
+   * the dimming level of the transmitting PHY.
+   *
+   * \param tx the transmitting PHY
+   * \param rx the receiving PHY
+   * \return the received power spectral density, or 0 beyond MaxLossDb
+   */
+  Ptr<SpectrumValue> GetRxPowerSpectralDensity (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx) const;
+
+  /**
+   * Get the probability that a frame sent by a PHY with its current
+   * modulation and coding scheme is received by another one.
+   *
+   * \param tx the transmitting PHY
+   * \param rx the receiving PHY
+   * \param psduSize the size of the PSDU in octets
+   * \return the packet success rate
+   */
+  double GetPacketSuccessRate (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize) const;
+
+  /**
+   * Draw the reception of frames sent by a PHY to another one.
+   *
+   * \param tx the transmitting PHY
+   * \param rx the receiving PHY
+   * \param psduSize the size of the PSDU in octets
+   * \param nFrames the number of frames sent
+   * \return the number of frames received
+   */
+  uint32_t GetReceivedFrames (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize, uint32_t nFrames);
+
+  /**
+   * Get the goodput of frames sent back to back by a PHY to another one.
+   *
+   * \param tx the transmitting PHY
+   * \param rx the receiving PHY
+   * \param psduSize the size of the PSDU in octets
+   * \param mcs the modulation and coding scheme of the frames
+   * \param dimmingLevel the dimming level of the frames, see
+   * VlcPhy::GetDimmingLevel
+   * \return the PSDU bits received per second of airtime
+   */
+  double GetGoodput (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize, VlcPhyMcs mcs,
+                     double dimmingLevel) const;
+
+  /**
+   * Select the modulation and coding scheme with the highest goodput at a
+   * dimming target, among the schemes of the PHY type of the current scheme
+   * of the transmitting PHY.
+   *
+   * \param tx the transmitting PHY
+   * \param rx the receiving PHY
+   * \param psduSize the size of the PSDU in octets
+   * \param dimmingLevel the dimming target
+   * \return the scheme, the slowest one of equal goodput
+   */
+  VlcPhyMcs GetBestMcs (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, uint32_t psduSize, double dimmingLevel) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Get the power spectral density received by a PHY from another one.
+   *
+   * \param tx the transmitting PHY
+   * \param rx the receiving PHY
+   * \param dimmingLevel the dimming level of the transmitting PHY
+   * \return the received power spectral density, or 0 beyond MaxLossDb
+   */
+  Ptr<SpectrumValue> GetRxPowerSpectralDensity (Ptr<VlcPhy> tx, Ptr<VlcPhy> rx, double dimmingLevel) const;
+
+  Ptr<PropagationLossModel> m_propagationLoss; //!< the propagation loss model
+  double m_maxLossDb;                          //!< the loss beyond which no frame is received
+  Ptr<UniformRandomVariable> m_random;         //!< the random variable deciding the receptions
+};
+
+} // namespace ns3
+
+#endif /* VLC_LINK_BUDGET_H */
@@ -0,0 +1,275 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-mac-beacon-header.h"
+#include <ns3/address-utils.h>
+#include <ns3/assert.h>
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (VlcMacBeaconHeader);
+
+const uint32_t VlcMacBeaconHeader::MAX_GTS_DESCRIPTORS = 7;
+const uint32_t VlcMacBeaconHeader::MAX_PENDING_ADDRESSES = 7;
+
+VlcMacBeaconHeader::VlcMacBeaconHeader (void)
+  : m_beaconOrder (15),
+    m_superframeOrder (15),
+    m_finalCapSlot (15),
+    m_vpanCoordinator (false),
+    m_gtsPermit (false)
+{
+}
+
+TypeId
+VlcMacBeaconHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMacBeaconHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMacBeaconHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VlcMacBeaconHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VlcMacBeaconHeader::Print (std::ostream &os) const
+{
+  os << "Beacon Order = " << static_cast<uint32_t> (m_beaconOrder)
+     << ", Superframe Order = " << static_cast<uint32_t> (m_superframeOrder)
+     << ", Final CAP Slot = " << static_cast<uint32_t> (m_finalCapSlot)
+     << ", VPAN Coordinator = " << m_vpanCoordinator
+     << ", GTS Permit = " << m_gtsPermit;
+  for (uint32_t i = 0; i < m_descriptors.size (); i++)
+    {
+      os << ", GTS " << m_descriptors[i].m_address
+         << " slot " << static_cast<uint32_t> (m_descriptors[i].m_startingSlot)
+         << " length " << static_cast<uint32_t> (m_descriptors[i].m_length)
+         << " direction " << m_descriptors[i].m_direction;
+    }
+  for (uint32_t i = 0; i < m_pendingShort.size (); i++)
+    {
+      os << ", Pending " << m_pendingShort[i];
+    }
+  for (uint32_t i = 0; i < m_pendingExt.size (); i++)
+    {
+      os << ", Pending " << m_pendingExt[i];
+    }
+}
+
+uint32_t
+VlcMacBeaconHeader::GetSerializedSize (void) const
+{
+  // Superframe specification, GTS specification, GTS directions and list,
+  // pending address specification.
+  uint32_t size = 2 + 1 + 1;
+  if (!m_descriptors.empty ())
+    {
+      size += 1 + 3 * m_descriptors.size ();
+    }
+  size += 2 * m_pendingShort.size () + 8 * m_pendingExt.size ();
+  return size;
+}
+
+void
+VlcMacBeaconHeader::Serialize (Buffer::Iterator start) const
+{
+  uint16_t superframeSpec = (m_beaconOrder & 0x0f)
+    | ((m_superframeOrder & 0x0f) << 4)
+    | ((m_finalCapSlot & 0x0f) << 8)
+    | (m_vpanCoordinator ? (1 << 14) : 0);
+  start.WriteHtolsbU16 (superframeSpec);
+
+  start.WriteU8 ((m_descriptors.size () & 0x07) | (m_gtsPermit ? 0x80 : 0));
+  if (!m_descriptors.empty ())
+    {
+      uint8_t directions = 0;
+      for (uint32_t i = 0; i < m_descriptors.size (); i++)
+        {
+          directions |= (m_descriptors[i].m_direction == GTS_RECEIVE) << i;
+        }
+      start.WriteU8 (directions);
+      for (uint32_t i = 0; i < m_descriptors.size (); i++)
+        {
+          WriteTo (start, m_descriptors[i].m_address);
+          start.WriteU8 ((m_descriptors[i].m_startingSlot & 0x0f) | ((m_descriptors[i].m_length & 0x0f) << 4));
+        }
+    }
+
+  start.WriteU8 ((m_pendingShort.size () & 0x07) | ((m_pendingExt.size () & 0x07) << 4));
+  for (uint32_t i = 0; i < m_pendingShort.size (); i++)
+    {
+      WriteTo (start, m_pendingShort[i]);
+    }
+  for (uint32_t i = 0; i < m_pendingExt.size (); i++)
+    {
+      WriteTo (start, m_pendingExt[i]);
+    }
+}
+
+uint32_t
+VlcMacBeaconHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  uint16_t superframeSpec = i.ReadLsbtohU16 ();
+  m_beaconOrder = superframeSpec & 0x0f;
+  m_superframeOrder = (superframeSpec >> 4) & 0x0f;
+  m_finalCapSlot = (superframeSpec >> 8) & 0x0f;
+  m_vpanCoordinator = (superframeSpec >> 14) & 0x01;
+
+  uint8_t gtsSpec = i.ReadU8 ();
+  m_gtsPermit = (gtsSpec & 0x80) != 0;
+  m_descriptors.resize (gtsSpec & 0x07);
+  if (!m_descriptors.empty ())
+    {
+      uint8_t directions = i.ReadU8 ();
+      for (uint32_t j = 0; j < m_descriptors.size (); j++)
+        {
+          ReadFrom (i, m_descriptors[j].m_address);
+          uint8_t slots = i.ReadU8 ();
+          m_descriptors[j].m_startingSlot = slots & 0x0f;
+          m_descriptors[j].m_length = (slots >> 4) & 0x0f;
+          m_descriptors[j].m_direction = ((directions >> j) & 0x01) ? GTS_RECEIVE : GTS_TRANSMIT;
+        }
+    }
+
+  uint8_t pendingSpec = i.ReadU8 ();
+  m_pendingShort.resize (pendingSpec & 0x07);
+  m_pendingExt.resize ((pendingSpec >> 4) & 0x07);
+  for (uint32_t j = 0; j < m_pendingShort.size (); j++)
+    {
+      ReadFrom (i, m_pendingShort[j]);
+    }
+  for (uint32_t j = 0; j < m_pendingExt.size (); j++)
+    {
+      ReadFrom (i, m_pendingExt[j]);
+    }
+  return i.GetDistanceFrom (start);
+}
+
+void
+VlcMacBeaconHeader::SetBeaconOrder (uint8_t beaconOrder)
+{
+  m_beaconOrder = beaconOrder;
+}
+
+uint8_t
+VlcMacBeaconHeader::GetBeaconOrder (void) const
+{
+  return m_beaconOrder;
+}
+
+void
+VlcMacBeaconHeader::SetSuperframeOrder (uint8_t superframeOrder)
+{
+  m_superframeOrder = superframeOrder;
+}
+
+uint8_t
+VlcMacBeaconHeader::GetSuperframeOrder (void) const
+{
+  return m_superframeOrder;
+}
+
+void
+VlcMacBeaconHeader::SetFinalCapSlot (uint8_t finalCapSlot)
+{
+  m_finalCapSlot = finalCapSlot;
+}
+
+uint8_t
+VlcMacBeaconHeader::GetFinalCapSlot (void) const
+{
+  return m_finalCapSlot;
+}
+
+void
+VlcMacBeaconHeader::SetVpanCoordinator (bool vpanCoordinator)
+{
+  m_vpanCoordinator = vpanCoordinator;
+}
+
+bool
+VlcMacBeaconHeader::IsVpanCoordinator (void) const
+{
+  return m_vpanCoordinator;
+}
+
+void
+VlcMacBeaconHeader::SetGtsPermit (bool gtsPermit)
+{
+  m_gtsPermit = gtsPermit;
+}
+
+bool
+VlcMacBeaconHeader::IsGtsPermit (void) const
+{
+  return m_gtsPermit;
+}
+
+void
+VlcMacBeaconHeader::AddGtsDescriptor (const VlcGtsDescriptor &descriptor)
+{
+  NS_ASSERT (m_descriptors.size () < MAX_GTS_DESCRIPTORS);
+  m_descriptors.push_back (descriptor);
+}
+
+const std::vector<VlcGtsDescriptor>&
+VlcMacBeaconHeader::GetGtsDescriptors (void) const
+{
+  return m_descriptors;
+}
+
+void
+VlcMacBeaconHeader::AddPendingShortAddress (Mac16Address address)
+{
+  NS_ASSERT (GetNPendingAddresses () < MAX_PENDING_ADDRESSES);
+  m_pendingShort.push_back (address);
+}
+
+void
+VlcMacBeaconHeader::AddPendingExtAddress (Mac64Address address)
+{
+  NS_ASSERT (GetNPendingAddresses () < MAX_PENDING_ADDRESSES);
+  m_pendingExt.push_back (address);
+}
+
+const std::vector<Mac16Address>&
+VlcMacBeaconHeader::GetPendingShortAddresses (void) const
+{
+  return m_pendingShort;
+}
+
+const std::vector<Mac64Address>&
+VlcMacBeaconHeader::GetPendingExtAddresses (void) const
+{
+  return m_pendingExt;
+}
+
+uint32_t
+VlcMacBeaconHeader::GetNPendingAddresses (void) const
+{
+  return m_pendingShort.size () + m_pendingExt.size ();
+}
+
+} // namespace ns3
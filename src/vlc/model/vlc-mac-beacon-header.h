@@ -0,0 +1,187 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_MAC_BEACON_HEADER_H
+#define VLC_MAC_BEACON_HEADER_H
+
+#include <ns3/header.h>
+#include <ns3/mac16-address.h>
+#include <ns3/mac64-address.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * The direction of a guaranteed time slot, seen from the device.
+ */
+typedef enum
+{
+  GTS_TRANSMIT = 0,   //!< the device transmits to the coordinator
+  GTS_RECEIVE = 1     //!< the device receives from the coordinator
+} VlcGtsDirection;
+
+/**
+ * A GTS descriptor of a beacon. A starting slot of 0 denies a request.
+ */
+struct VlcGtsDescriptor
+{
+  Mac16Address m_address;        //!< the short address of the device
+  uint8_t m_startingSlot;        //!< the first slot of the GTS
+  uint8_t m_length;              //!< the number of slots of the GTS
+  VlcGtsDirection m_direction;   //!< the direction of the GTS
+};
+
+/**
+ * \ingroup vlc
+ *
+ * The payload of a beacon frame: the superframe specification, the GTS
+ * fields and the pending address fields. The beacon payload proper is empty.
+ */
+class VlcMacBeaconHeader : public Header
+{
+public:
+  /**
+   * The maximum number of GTS descriptors of a beacon.
+   */
+  static const uint32_t MAX_GTS_DESCRIPTORS;
+
+  /**
+   * The maximum number of pending addresses of a beacon, short and
+   * extended together.
+   */
+  static const uint32_t MAX_PENDING_ADDRESSES;
+
+  VlcMacBeaconHeader (void);
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \param beaconOrder the beacon order, 15 without beacons
+   */
+  void SetBeaconOrder (uint8_t beaconOrder);
+
+  /**
+   * \return the beacon order
+   */
+  uint8_t GetBeaconOrder (void) const;
+
+  /**
+   * \param superframeOrder the superframe order
+   */
+  void SetSuperframeOrder (uint8_t superframeOrder);
+
+  /**
+   * \return the superframe order
+   */
+  uint8_t GetSuperframeOrder (void) const;
+
+  /**
+   * \param finalCapSlot the last slot of the contention access period
+   */
+  void SetFinalCapSlot (uint8_t finalCapSlot);
+
+  /**
+   * \return the last slot of the contention access period
+   */
+  uint8_t GetFinalCapSlot (void) const;
+
+  /**
+   * \param vpanCoordinator whether the beacon is sent by the VPAN coordinator
+   */
+  void SetVpanCoordinator (bool vpanCoordinator);
+
+  /**
+   * \return true, if the beacon is sent by the VPAN coordinator
+   */
+  bool IsVpanCoordinator (void) const;
+
+  /**
+   * \param gtsPermit whether the coordinator accepts GTS requests
+   */
+  void SetGtsPermit (bool gtsPermit);
+
+  /**
+   * \return true, if the coordinator accepts GTS requests
+   */
+  bool IsGtsPermit (void) const;
+
+  /**
+   * Add a GTS descriptor.
+   *
+   * \param descriptor the descriptor
+   */
+  void AddGtsDescriptor (const VlcGtsDescriptor &descriptor);
+
+  /**
+   * \return the GTS descriptors
+   */
+  const std::vector<VlcGtsDescriptor>& GetGtsDescriptors (void) const;
+
+  /**
+   * Announce pending data for a device with a short address.
+   *
+   * \param address the short address of the device
+   */
+  void AddPendingShortAddress (Mac16Address address);
+
+  /**
+   * Announce pending data for a device with an extended address.
+   *
+   * \param address the extended address of the device
+   */
+  void AddPendingExtAddress (Mac64Address address);
+
+  /**
+   * \return the short addresses with pending data
+   */
+  const std::vector<Mac16Address>& GetPendingShortAddresses (void) const;
+
+  /**
+   * \return the extended addresses with pending data
+   */
+  const std::vector<Mac64Address>& GetPendingExtAddresses (void) const;
+
+  /**
+   * \return the number of pending addresses, short and extended
+   */
+  uint32_t GetNPendingAddresses (void) const;
+
+private:
+  uint8_t m_beaconOrder;                         //!< the beacon order
+  uint8_t m_superframeOrder;                     //!< the superframe order
+  uint8_t m_finalCapSlot;                        //!< the final CAP slot
+  bool m_vpanCoordinator;                        //!< the VPAN coordinator bit
+  bool m_gtsPermit;                              //!< the GTS permit bit
+  std::vector<VlcGtsDescriptor> m_descriptors;   //!< the GTS descriptors
+  std::vector<Mac16Address> m_pendingShort;      //!< the pending short addresses
+  std::vector<Mac64Address> m_pendingExt;        //!< the pending extended addresses
+};
+
+} // namespace ns3
+
+#endif /* VLC_MAC_BEACON_HEADER_H */
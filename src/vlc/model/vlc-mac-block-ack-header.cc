@@ -0,0 +1,99 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-mac-block-ack-header.h"
+#include <ns3/assert.h>
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (VlcMacBlockAckHeader);
+
+const uint32_t VlcMacBlockAckHeader::MAX_SUBFRAMES = 32;
+
+VlcMacBlockAckHeader::VlcMacBlockAckHeader (void)
+  : m_bitmap (0)
+{
+}
+
+TypeId
+VlcMacBlockAckHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMacBlockAckHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMacBlockAckHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VlcMacBlockAckHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VlcMacBlockAckHeader::Print (std::ostream &os) const
+{
+  os << "Bitmap = " << std::hex << m_bitmap << std::dec;
+}
+
+uint32_t
+VlcMacBlockAckHeader::GetSerializedSize (void) const
+{
+  return 4;
+}
+
+void
+VlcMacBlockAckHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteHtolsbU32 (m_bitmap);
+}
+
+uint32_t
+VlcMacBlockAckHeader::Deserialize (Buffer::Iterator start)
+{
+  m_bitmap = start.ReadLsbtohU32 ();
+  return GetSerializedSize ();
+}
+
+void
+VlcMacBlockAckHeader::SetReceived (uint32_t index)
+{
+  NS_ASSERT (index < MAX_SUBFRAMES);
+  m_bitmap |= (1u << index);
+}
+
+bool
+VlcMacBlockAckHeader::IsReceived (uint32_t index) const
+{
+  return index < MAX_SUBFRAMES && (m_bitmap & (1u << index)) != 0;
+}
+
+void
+VlcMacBlockAckHeader::SetBitmap (uint32_t bitmap)
+{
+  m_bitmap = bitmap;
+}
+
+uint32_t
+VlcMacBlockAckHeader::GetBitmap (void) const
+{
+  return m_bitmap;
+}
+
+} // namespace ns3
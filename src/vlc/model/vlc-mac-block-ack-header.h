@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_MAC_BLOCK_ACK_HEADER_H
+#define VLC_MAC_BLOCK_ACK_HEADER_H
+
+#include <ns3/header.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The payload of a block acknowledgment, i.e. of an acknowledgment frame
+ * with the aggregation bit or the block ACK bit set. With the aggregation
+ * bit, bit i of the bitmap acknowledges the i-th subframe of the aggregated
+ * frame with the sequence number of the acknowledgment. With the block ACK
+ * bit, bit i acknowledges the frame whose sequence number is the one of the
+ * acknowledgment minus i.
+ */
+class VlcMacBlockAckHeader : public Header
+{
+public:
+  /**
+   * The maximum number of subframes that can be acknowledged.
+   */
+  static const uint32_t MAX_SUBFRAMES;
+
+  VlcMacBlockAckHeader (void);
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * Mark a subframe as received.
+   *
+   * \param index the position of the subframe in the aggregated frame
+   */
+  void SetReceived (uint32_t index);
+
+  /**
+   * \param index the position of the subframe in the aggregated frame
+   * \return true, if the subframe has been received
+   */
+  bool IsReceived (uint32_t index) const;
+
+  /**
+   * \param bitmap the bitmap of received subframes
+   */
+  void SetBitmap (uint32_t bitmap);
+
+  /**
+   * \return the bitmap of received subframes
+   */
+  uint32_t GetBitmap (void) const;
+
+private:
+  uint32_t m_bitmap;   //!< the bitmap of received subframes
+};
+
+} // namespace ns3
+
+#endif /* VLC_MAC_BLOCK_ACK_HEADER_H */
@@ -0,0 +1,124 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-mac-command-header.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (VlcMacCommandHeader);
+
+VlcMacCommandHeader::VlcMacCommandHeader (void)
+  : m_commandId (DATA_REQUEST),
+    m_gtsCharacteristics (0)
+{
+}
+
+VlcMacCommandHeader::VlcMacCommandHeader (enum CommandIdentifier commandId)
+  : m_commandId (commandId),
+    m_gtsCharacteristics (0)
+{
+}
+
+TypeId
+VlcMacCommandHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMacCommandHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMacCommandHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VlcMacCommandHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VlcMacCommandHeader::Print (std::ostream &os) const
+{
+  os << "Command Id = " << static_cast<uint32_t> (m_commandId);
+  if (m_commandId == GTS_REQUEST)
+    {
+      os << ", GTS Length = " << static_cast<uint32_t> (GetGtsLength ())
+         << ", Direction = " << GetGtsDirection ()
+         << ", Allocation = " << IsGtsAllocation ();
+    }
+}
+
+uint32_t
+VlcMacCommandHeader::GetSerializedSize (void) const
+{
+  return m_commandId == GTS_REQUEST ? 2 : 1;
+}
+
+void
+VlcMacCommandHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteU8 (m_commandId);
+  if (m_commandId == GTS_REQUEST)
+    {
+      start.WriteU8 (m_gtsCharacteristics);
+    }
+}
+
+uint32_t
+VlcMacCommandHeader::Deserialize (Buffer::Iterator start)
+{
+  m_commandId = static_cast<enum CommandIdentifier> (start.ReadU8 ());
+  if (m_commandId == GTS_REQUEST)
+    {
+      m_gtsCharacteristics = start.ReadU8 ();
+    }
+  return GetSerializedSize ();
+}
+
+VlcMacCommandHeader::CommandIdentifier
+VlcMacCommandHeader::GetCommandId (void) const
+{
+  return m_commandId;
+}
+
+void
+VlcMacCommandHeader::SetGtsCharacteristics (uint8_t length, VlcGtsDirection direction, bool allocation)
+{
+  m_gtsCharacteristics = (length & 0x0f)
+    | (direction == GTS_RECEIVE ? 0x10 : 0)
+    | (allocation ? 0x20 : 0);
+}
+
+uint8_t
+VlcMacCommandHeader::GetGtsLength (void) const
+{
+  return m_gtsCharacteristics & 0x0f;
+}
+
+VlcGtsDirection
+VlcMacCommandHeader::GetGtsDirection (void) const
+{
+  return (m_gtsCharacteristics & 0x10) ? GTS_RECEIVE : GTS_TRANSMIT;
+}
+
+bool
+VlcMacCommandHeader::IsGtsAllocation (void) const
+{
+  return (m_gtsCharacteristics & 0x20) != 0;
+}
+
+} // namespace ns3
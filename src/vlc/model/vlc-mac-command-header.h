@@ -0,0 +1,110 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_MAC_COMMAND_HEADER_H
+#define VLC_MAC_COMMAND_HEADER_H
+
+#include "vlc-mac-beacon-header.h"
+#include <ns3/header.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The payload of a MAC command frame: the command frame identifier and the
+ * fields of the command. Of the command fields, only the GTS characteristics
+ * of the GTS request are modelled.
+ */
+class VlcMacCommandHeader : public Header
+{
+public:
+  /**
+   * The command frame identifiers, see IEEE 802.15.7.
+   */
+  enum CommandIdentifier
+  {
+    ASSOCIATION_REQUEST = 0x01,
+    ASSOCIATION_RESPONSE = 0x02,
+    DISASSOCIATION_NOTIFICATION = 0x03,
+    DATA_REQUEST = 0x04,
+    VPAN_ID_CONFLICT_NOTIFICATION = 0x05,
+    ORPHAN_NOTIFICATION = 0x06,
+    BEACON_REQUEST = 0x07,
+    COORDINATOR_REALIGNMENT = 0x08,
+    GTS_REQUEST = 0x09
+  };
+
+  VlcMacCommandHeader (void);
+
+  /**
+   * Constructor.
+   *
+   * \param commandId the command frame identifier
+   */
+  VlcMacCommandHeader (enum CommandIdentifier commandId);
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \return the command frame identifier
+   */
+  enum CommandIdentifier GetCommandId (void) const;
+
+  /**
+   * Set the GTS characteristics of a GTS request.
+   *
+   * \param length the number of slots
+   * \param direction the direction of the GTS
+   * \param allocation true to allocate, false to deallocate
+   */
+  void SetGtsCharacteristics (uint8_t length, VlcGtsDirection direction, bool allocation);
+
+  /**
+   * \return the number of slots of a GTS request
+   */
+  uint8_t GetGtsLength (void) const;
+
+  /**
+   * \return the direction of a GTS request
+   */
+  VlcGtsDirection GetGtsDirection (void) const;
+
+  /**
+   * \return true for an allocation, false for a deallocation
+   */
+  bool IsGtsAllocation (void) const;
+
+private:
+  enum CommandIdentifier m_commandId;   //!< the command frame identifier
+  uint8_t m_gtsCharacteristics;         //!< the GTS characteristics of a GTS request
+};
+
+} // namespace ns3
+
+#endif /* VLC_MAC_COMMAND_HEADER_H */
@@ -95,7 +95,7 @@ VlcMacHeader::GetFrameControl (void) const
 bool
 VlcMacHeader::IsSecEnable (void) const
 {
-  return (m_fctrlSecU == 0);
+  return (m_fctrlSecU == 1);
 }
 
 bool
@@ -311,6 +311,42 @@ VlcMacHeader::SetNoAckReq (void)
   m_fctrlAckReq = 0;
 }
 
+void
+VlcMacHeader::SetAggregation (void)
+{
+  m_fctrlReserved |= 0x01;
+}
+
+void
+VlcMacHeader::SetNoAggregation (void)
+{
+  m_fctrlReserved &= ~0x01;
+}
+
+bool
+VlcMacHeader::IsAggregation (void) const
+{
+  return (m_fctrlReserved & 0x01) != 0;
+}
+
+void
+VlcMacHeader::SetBlockAck (void)
+{
+  m_fctrlReserved |= 0x02;
+}
+
+void
+VlcMacHeader::SetNoBlockAck (void)
+{
+  m_fctrlReserved &= ~0x02;
+}
+
+bool
+VlcMacHeader::IsBlockAck (void) const
+{
+  return (m_fctrlReserved & 0x02) != 0;
+}
+
 void
 VlcMacHeader::SetFrmCtrlRes (uint8_t res)
 {
@@ -553,6 +589,8 @@ VlcMacHeader::GetSerializedSize (void) const
         {
           size += 2;
         } */
+      // The source VPAN Id is only present, if there is no destination VPAN Id.
+      size += (m_fctrlDstAddrMode > 0) ? 2 : 4;
       break;
     case EXTADDR:
       // check if PAN Id compression is enabled
@@ -564,6 +602,7 @@ VlcMacHeader::GetSerializedSize (void) const
         {
           size += 8;
         } */
+      size += (m_fctrlDstAddrMode > 0) ? 8 : 10;
       break;
     }
 
@@ -623,7 +662,10 @@ VlcMacHeader::Serialize (Buffer::Iterator start) const
         {
           i.WriteHtolsbU16 (GetSrcPanId ());
         }*/
-      i.WriteHtolsbU16 (GetSrcVpanId());
+      if (m_fctrlDstAddrMode == 0)
+        {
+          i.WriteHtolsbU16 (GetSrcVpanId ());
+        }
       WriteTo (i, m_addrShortSrcAddr);
       break;
     case EXTADDR:
@@ -631,7 +673,10 @@ VlcMacHeader::Serialize (Buffer::Iterator start) const
         {
           i.WriteHtolsbU16 (GetSrcPanId ());
         }*/
-      i.WriteHtolsbU16 (GetSrcVpanId ());
+      if (m_fctrlDstAddrMode == 0)
+        {
+          i.WriteHtolsbU16 (GetSrcVpanId ());
+        }
       WriteTo (i, m_addrExtSrcAddr);
       break;
     }
@@ -154,6 +154,23 @@ public:
 
    bool IsCommand (void) const;
 
+   /**
+    * The aggregation bit is the first of the reserved bits of the frame
+    * control field. It marks aggregated data frames and block ACKs.
+    *
+    * \return true, if the aggregation bit is set
+    */
+   bool IsAggregation (void) const;
+
+   /**
+    * The block ACK bit is the second of the reserved bits of the frame
+    * control field. It marks data frames acknowledged by a block ACK over a
+    * window of frames, and the block ACKs of such windows.
+    *
+    * \return true, if the block ACK bit is set
+    */
+   bool IsBlockAck (void) const;
+
    void SetType (enum VlcMacType vlcMacType);
 
    void SetFrameControl (uint16_t frameControl);
@@ -170,6 +187,14 @@ public:
 
    void SetNoAckReq (void);
 
+   void SetAggregation (void);
+
+   void SetNoAggregation (void);
+
+   void SetBlockAck (void);
+
+   void SetNoBlockAck (void);
+
    //void SetVpanIdComp (void);
 
    //void SetNoVpanIdComp (void);
@@ -0,0 +1,440 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-mac-queue.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/enum.h>
+
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcMacQueue");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcMacQueue);
+
+TypeId
+VlcMacQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMacQueue")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMacQueue> ()
+    .AddAttribute ("MaxPackets",
+                   "The maximum number of MSDUs in the queue, 0 for no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&VlcMacQueue::SetMaxPackets,
+                                         &VlcMacQueue::GetMaxPackets),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxBytes",
+                   "The maximum number of bytes in the queue, 0 for no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&VlcMacQueue::SetMaxBytes,
+                                         &VlcMacQueue::GetMaxBytes),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DropPolicy",
+                   "The policy for dropping MSDUs.",
+                   EnumValue (DROP_TAIL),
+                   MakeEnumAccessor (&VlcMacQueue::SetDropPolicy,
+                                     &VlcMacQueue::GetDropPolicy),
+                   MakeEnumChecker (DROP_TAIL, "DropTail",
+                                    DROP_HEAD, "DropHead",
+                                    CODEL, "CoDel"))
+    .AddAttribute ("Target",
+                   "The CoDel target sojourn time.",
+                   TimeValue (MilliSeconds (5)),
+                   MakeTimeAccessor (&VlcMacQueue::m_target),
+                   MakeTimeChecker ())
+    .AddAttribute ("Interval",
+                   "The CoDel interval.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&VlcMacQueue::m_interval),
+                   MakeTimeChecker ())
+    .AddTraceSource ("PacketsInQueue",
+                     "Number of MSDUs currently stored in the queue",
+                     MakeTraceSourceAccessor (&VlcMacQueue::m_nPackets),
+                     "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("BytesInQueue",
+                     "Number of bytes currently stored in the queue",
+                     MakeTraceSourceAccessor (&VlcMacQueue::m_nBytes),
+                     "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("Enqueue",
+                     "Trace source indicating an MSDU has been enqueued",
+                     MakeTraceSourceAccessor (&VlcMacQueue::m_traceEnqueue),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Dequeue",
+                     "Trace source indicating an MSDU has been dequeued",
+                     MakeTraceSourceAccessor (&VlcMacQueue::m_traceDequeue),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Drop",
+                     "Trace source indicating an MSDU has been dropped by the queue",
+                     MakeTraceSourceAccessor (&VlcMacQueue::m_traceDrop),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("SojournTime",
+                     "The time a dequeued MSDU has spent in the queue",
+                     MakeTraceSourceAccessor (&VlcMacQueue::m_traceSojournTime),
+                     "ns3::VlcMacQueue::SojournTracedCallback")
+  ;
+  return tid;
+}
+
+VlcMacQueue::VlcMacQueue (void)
+  : m_ring (16),
+    m_head (0),
+    m_maxPackets (0),
+    m_maxBytes (0),
+    m_policy (DROP_TAIL),
+    m_nTotalDropped (0),
+    m_dropCount (0),
+    m_lastDropCount (0),
+    m_dropping (false),
+    m_nPackets (0),
+    m_nBytes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcMacQueue::~VlcMacQueue (void)
+{
+}
+
+void
+VlcMacQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_dropCallback = MakeNullCallback<void, Ptr<const Packet>, uint8_t> ();
+  Object::DoDispose ();
+}
+
+bool
+VlcMacQueue::Fits (uint32_t size) const
+{
+  if (m_maxPackets != 0 && m_nPackets + 1 > m_maxPackets)
+    {
+      return false;
+    }
+  if (m_maxBytes != 0 && m_nBytes + size > m_maxBytes)
+    {
+      return false;
+    }
+  return true;
+}
+
+bool
+VlcMacQueue::Enqueue (Ptr<Packet> packet, uint8_t msduHandle)
+{
+  NS_LOG_FUNCTION (this << packet << static_cast<uint32_t> (msduHandle));
+
+  uint32_t size = packet->GetSize ();
+  if (m_policy == DROP_HEAD && (m_maxBytes == 0 || size <= m_maxBytes))
+    {
+      Entry head;
+      while (!Fits (size))
+        {
+          PopHead (head);
+          Drop (head);
+        }
+    }
+
+  Entry entry;
+  entry.packet = packet;
+  entry.msduHandle = msduHandle;
+  entry.enqueueTime = Simulator::Now ();
+
+  if (!Fits (size))
+    {
+      NS_LOG_DEBUG ("Queue full, dropping the arriving MSDU");
+      Drop (entry);
+      return false;
+    }
+
+  if (m_nPackets == m_ring.size ())
+    {
+      // Grow the ring and move the entries to the front, in order.
+      std::vector<Entry> ring (2 * m_ring.size ());
+      for (uint32_t i = 0; i < m_nPackets; i++)
+        {
+          ring[i] = m_ring[(m_head + i) % m_ring.size ()];
+        }
+      m_ring.swap (ring);
+      m_head = 0;
+    }
+
+  m_ring[(m_head + m_nPackets) % m_ring.size ()] = entry;
+  m_nPackets++;
+  m_nBytes += size;
+  m_traceEnqueue (packet);
+  return true;
+}
+
+void
+VlcMacQueue::PopHead (Entry &entry)
+{
+  NS_ASSERT (!IsEmpty ());
+
+  Entry &head = m_ring[m_head];
+  entry = head;
+  // Release the packet, the slot itself is reused.
+  head.packet = 0;
+  m_head = (m_head + 1) % m_ring.size ();
+  m_nPackets--;
+  m_nBytes -= entry.packet->GetSize ();
+}
+
+void
+VlcMacQueue::Drop (const Entry &entry)
+{
+  NS_LOG_FUNCTION (this << entry.packet);
+
+  m_nTotalDropped++;
+  m_traceDrop (entry.packet);
+  if (!m_dropCallback.IsNull ())
+    {
+      m_dropCallback (entry.packet, entry.msduHandle);
+    }
+}
+
+bool
+VlcMacQueue::CoDelOkToDrop (Time sojourn, Time now)
+{
+  // An empty queue cannot build a standing delay.
+  if (sojourn < m_target || IsEmpty ())
+    {
+      m_firstAboveTime = Time (0);
+      return false;
+    }
+  if (m_firstAboveTime.IsZero ())
+    {
+      m_firstAboveTime = now + m_interval;
+      return false;
+    }
+  return now >= m_firstAboveTime;
+}
+
+Time
+VlcMacQueue::CoDelControlLaw (Time t) const
+{
+  return t + Seconds (m_interval.GetSeconds () / std::sqrt (static_cast<double> (m_dropCount)));
+}
+
+bool
+VlcMacQueue::Dequeue (Ptr<Packet> &packet, uint8_t &msduHandle)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (IsEmpty ())
+    {
+      m_dropping = false;
+      m_firstAboveTime = Time (0);
+      return false;
+    }
+
+  Time now = Simulator::Now ();
+  Entry entry;
+  PopHead (entry);
+
+  if (m_policy == CODEL)
+    {
+      bool okToDrop = CoDelOkToDrop (now - entry.enqueueTime, now);
+      if (m_dropping)
+        {
+          if (!okToDrop)
+            {
+              m_dropping = false;
+            }
+          while (m_dropping && now >= m_dropNext)
+            {
+              Drop (entry);
+              m_dropCount++;
+              if (IsEmpty ())
+                {
+                  m_dropping = false;
+                  m_firstAboveTime = Time (0);
+                  return false;
+                }
+              PopHead (entry);
+              if (!CoDelOkToDrop (now - entry.enqueueTime, now))
+                {
+                  m_dropping = false;
+                }
+              else
+                {
+                  m_dropNext = CoDelControlLaw (m_dropNext);
+                }
+            }
+        }
+      else if (okToDrop)
+        {
+          Drop (entry);
+          m_dropping = true;
+          // Start with the drop rate of the last dropping state, if it ended
+          // recently.
+          uint32_t delta = m_dropCount - m_lastDropCount;
+          m_dropCount = 1;
+          if (delta > 1 && now - m_dropNext < 16 * m_interval)
+            {
+              m_dropCount = delta;
+            }
+          m_dropNext = CoDelControlLaw (now);
+          m_lastDropCount = m_dropCount;
+          if (IsEmpty ())
+            {
+              return false;
+            }
+          PopHead (entry);
+          CoDelOkToDrop (now - entry.enqueueTime, now);
+        }
+    }
+
+  m_traceSojournTime (now - entry.enqueueTime);
+  m_traceDequeue (entry.packet);
+  packet = entry.packet;
+  msduHandle = entry.msduHandle;
+  return true;
+}
+
+bool
+VlcMacQueue::DequeueHead (Ptr<Packet> &packet, uint8_t &msduHandle)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (IsEmpty ())
+    {
+      return false;
+    }
+
+  Entry entry;
+  PopHead (entry);
+  m_traceSojournTime (Simulator::Now () - entry.enqueueTime);
+  m_traceDequeue (entry.packet);
+  packet = entry.packet;
+  msduHandle = entry.msduHandle;
+  return true;
+}
+
+Ptr<const Packet>
+VlcMacQueue::Peek (void) const
+{
+  if (IsEmpty ())
+    {
+      return 0;
+    }
+  return m_ring[m_head].packet;
+}
+
+void
+VlcMacQueue::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Entry entry;
+  while (!IsEmpty ())
+    {
+      PopHead (entry);
+    }
+  m_head = 0;
+  m_dropping = false;
+  m_firstAboveTime = Time (0);
+}
+
+void
+VlcMacQueue::ForEach (Callback<void, Ptr<Packet> > f)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (uint32_t i = 0; i < m_nPackets; i++)
+    {
+      Ptr<Packet> packet = m_ring[(m_head + i) % m_ring.size ()].packet;
+      uint32_t size = packet->GetSize ();
+      f (packet);
+      NS_ASSERT_MSG (packet->GetSize () == size, "The size of a queued MPDU changed");
+    }
+}
+
+bool
+VlcMacQueue::IsEmpty (void) const
+{
+  return m_nPackets.Get () == 0;
+}
+
+uint32_t
+VlcMacQueue::GetNPackets (void) const
+{
+  return m_nPackets;
+}
+
+uint32_t
+VlcMacQueue::GetNBytes (void) const
+{
+  return m_nBytes;
+}
+
+uint32_t
+VlcMacQueue::GetTotalDroppedPackets (void) const
+{
+  return m_nTotalDropped;
+}
+
+void
+VlcMacQueue::SetMaxPackets (uint32_t maxPackets)
+{
+  NS_LOG_FUNCTION (this << maxPackets);
+  m_maxPackets = maxPackets;
+}
+
+uint32_t
+VlcMacQueue::GetMaxPackets (void) const
+{
+  return m_maxPackets;
+}
+
+void
+VlcMacQueue::SetMaxBytes (uint32_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << maxBytes);
+  m_maxBytes = maxBytes;
+}
+
+uint32_t
+VlcMacQueue::GetMaxBytes (void) const
+{
+  return m_maxBytes;
+}
+
+void
+VlcMacQueue::SetDropPolicy (DropPolicy policy)
+{
+  NS_LOG_FUNCTION (this << policy);
+  m_policy = policy;
+}
+
+VlcMacQueue::DropPolicy
+VlcMacQueue::GetDropPolicy (void) const
+{
+  return m_policy;
+}
+
+void
+VlcMacQueue::SetDropCallback (DropCallback c)
+{
+  m_dropCallback = c;
+}
+
+} // namespace ns3
@@ -0,0 +1,284 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_MAC_QUEUE_H
+#define VLC_MAC_QUEUE_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/packet.h>
+#include <ns3/callback.h>
+#include <ns3/traced-callback.h>
+#include <ns3/traced-value.h>
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The transaction queue of the VLC MAC.
+ *
+ * The queue holds the MSDUs waiting for channel access together with their
+ * MSDU handles. It can be bounded in packets and in bytes; both bounds are
+ * off by default, so that the queue is unbounded like the transaction list
+ * it replaces. The queue applies one of the following policies when it
+ * overflows or builds up a standing delay:
+ * - DropTail: an arriving MSDU that does not fit is dropped,
+ * - DropHead: the oldest MSDUs are dropped until the arriving one fits,
+ * - CoDel: MSDUs are dropped at dequeue time when their sojourn time stays
+ *   above Target for at least Interval (RFC 8289); on overflow the arriving
+ *   MSDU is dropped.
+ *
+ * Entries are kept by value in a ring buffer, which only grows when it is
+ * full, so that enqueueing and dequeueing do not allocate once the queue has
+ * reached its working size.
+ */
+class VlcMacQueue : public Object
+{
+public:
+  /**
+   * The drop policy of the queue.
+   */
+  enum DropPolicy
+  {
+    DROP_TAIL,
+    DROP_HEAD,
+    CODEL
+  };
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcMacQueue (void);
+  virtual ~VlcMacQueue (void);
+
+  /**
+   * Callback invoked for every MSDU dropped by the queue, with the packet and
+   * its MSDU handle.
+   */
+  typedef Callback<void, Ptr<const Packet>, uint8_t> DropCallback;
+
+  /**
+   * TracedCallback signature for the sojourn time of a dequeued MSDU.
+   *
+   * \param [in] sojourn the time the MSDU spent in the queue
+   */
+  typedef void (* SojournTracedCallback)(Time sojourn);
+
+  /**
+   * Enqueue an MSDU. Depending on the drop policy, the MSDU itself or the
+   * oldest MSDUs in the queue are dropped if the limits are exceeded.
+   *
+   * \param packet the MPDU to enqueue
+   * \param msduHandle the MSDU handle of the request
+   * \return true, if the MSDU has been enqueued
+   */
+  bool Enqueue (Ptr<Packet> packet, uint8_t msduHandle);
+
+  /**
+   * Dequeue the MSDU at the head of the queue. With the CoDel policy, MSDUs
+   * may be dropped before one is returned.
+   *
+   * \param [out] packet the dequeued MPDU
+   * \param [out] msduHandle the MSDU handle of the dequeued MPDU
+   * \return true, if an MSDU has been dequeued
+   */
+  bool Dequeue (Ptr<Packet> &packet, uint8_t &msduHandle);
+
+  /**
+   * Dequeue the MSDU at the head of the queue without applying the drop
+   * policy, e.g. to add it to an MSDU that has already been dequeued.
+   *
+   * \param [out] packet the dequeued MPDU
+   * \param [out] msduHandle the MSDU handle of the dequeued MPDU
+   * \return true, if an MSDU has been dequeued
+   */
+  bool DequeueHead (Ptr<Packet> &packet, uint8_t &msduHandle);
+
+  /**
+   * Get the MSDU at the head of the queue without removing it.
+   *
+   * \return the MPDU, or 0 if the queue is empty
+   */
+  Ptr<const Packet> Peek (void) const;
+
+  /**
+   * Drop all MSDUs in the queue without notifying the drop callback.
+   */
+  void Flush (void);
+
+  /**
+   * Apply a function to every MPDU in the queue, from the head, e.g. to
+   * rewrite their MAC headers. The function must not change their size.
+   *
+   * \param f the function
+   */
+  void ForEach (Callback<void, Ptr<Packet> > f);
+
+  /**
+   * \return true, if the queue is empty
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * \return the number of MSDUs in the queue
+   */
+  uint32_t GetNPackets (void) const;
+
+  /**
+   * \return the number of bytes in the queue
+   */
+  uint32_t GetNBytes (void) const;
+
+  /**
+   * \return the number of MSDUs dropped by the queue so far
+   */
+  uint32_t GetTotalDroppedPackets (void) const;
+
+  /**
+   * Set the maximum number of MSDUs in the queue.
+   *
+   * \param maxPackets the limit, 0 for no limit
+   */
+  void SetMaxPackets (uint32_t maxPackets);
+
+  /**
+   * \return the maximum number of MSDUs in the queue, 0 for no limit
+   */
+  uint32_t GetMaxPackets (void) const;
+
+  /**
+   * Set the maximum number of bytes in the queue.
+   *
+   * \param maxBytes the limit, 0 for no limit
+   */
+  void SetMaxBytes (uint32_t maxBytes);
+
+  /**
+   * \return the maximum number of bytes in the queue, 0 for no limit
+   */
+  uint32_t GetMaxBytes (void) const;
+
+  /**
+   * Set the drop policy.
+   *
+   * \param policy the drop policy
+   */
+  void SetDropPolicy (DropPolicy policy);
+
+  /**
+   * \return the drop policy
+   */
+  DropPolicy GetDropPolicy (void) const;
+
+  /**
+   * Set the callback invoked for dropped MSDUs.
+   *
+   * \param c the callback
+   */
+  void SetDropCallback (DropCallback c);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * An MSDU in the queue.
+   */
+  struct Entry
+  {
+    Ptr<Packet> packet;      //!< the MPDU
+    uint8_t msduHandle;      //!< the MSDU handle
+    Time enqueueTime;        //!< the time the MSDU has been enqueued
+  };
+
+  /**
+   * Check whether an MSDU of the given size fits into the queue.
+   *
+   * \param size the size of the MSDU in bytes
+   * \return true, if the MSDU fits
+   */
+  bool Fits (uint32_t size) const;
+
+  /**
+   * Remove the entry at the head of the ring buffer.
+   *
+   * \param [out] entry the removed entry
+   */
+  void PopHead (Entry &entry);
+
+  /**
+   * Drop an entry that has been removed from the queue.
+   *
+   * \param entry the entry
+   */
+  void Drop (const Entry &entry);
+
+  /**
+   * Decide whether CoDel drops an MSDU with the given sojourn time, see
+   * RFC 8289 dodequeue.
+   *
+   * \param sojourn the sojourn time of the MSDU
+   * \param now the current time
+   * \return true, if the MSDU may be dropped
+   */
+  bool CoDelOkToDrop (Time sojourn, Time now);
+
+  /**
+   * The CoDel control law: the time of the next drop.
+   *
+   * \param t the time of the last drop
+   * \return the time of the next drop
+   */
+  Time CoDelControlLaw (Time t) const;
+
+  std::vector<Entry> m_ring;    //!< the entries, used as a ring buffer
+  uint32_t m_head;              //!< the index of the head entry in the ring
+
+  uint32_t m_maxPackets;        //!< maximum number of MSDUs, 0 for no limit
+  uint32_t m_maxBytes;          //!< maximum number of bytes, 0 for no limit
+  DropPolicy m_policy;          //!< the drop policy
+  uint32_t m_nTotalDropped;     //!< number of dropped MSDUs
+
+  Time m_target;                //!< CoDel target sojourn time
+  Time m_interval;              //!< CoDel interval
+  Time m_firstAboveTime;        //!< CoDel time when the sojourn time is above target for an interval
+  Time m_dropNext;              //!< CoDel time of the next drop in the dropping state
+  uint32_t m_dropCount;         //!< CoDel number of drops in the current dropping state
+  uint32_t m_lastDropCount;     //!< CoDel number of drops in the last dropping state
+  bool m_dropping;              //!< CoDel dropping state
+
+  DropCallback m_dropCallback;  //!< callback for dropped MSDUs
+
+  TracedValue<uint32_t> m_nPackets;   //!< number of MSDUs in the queue
+  TracedValue<uint32_t> m_nBytes;     //!< number of bytes in the queue
+
+  TracedCallback<Ptr<const Packet> > m_traceEnqueue;   //!< enqueued MSDUs
+  TracedCallback<Ptr<const Packet> > m_traceDequeue;   //!< dequeued MSDUs
+  TracedCallback<Ptr<const Packet> > m_traceDrop;      //!< dropped MSDUs
+  TracedCallback<Time> m_traceSojournTime;             //!< sojourn time of dequeued MSDUs
+};
+
+} // namespace ns3
+
+#endif /* VLC_MAC_QUEUE_H */
@@ -0,0 +1,98 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-mac-subframe-header.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (VlcMacSubframeHeader);
+
+VlcMacSubframeHeader::VlcMacSubframeHeader (void)
+  : m_length (0),
+    m_seqNum (0)
+{
+}
+
+TypeId
+VlcMacSubframeHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMacSubframeHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMacSubframeHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VlcMacSubframeHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VlcMacSubframeHeader::Print (std::ostream &os) const
+{
+  os << "Length = " << m_length << ", Sequence Num = " << static_cast<uint32_t> (m_seqNum);
+}
+
+uint32_t
+VlcMacSubframeHeader::GetSerializedSize (void) const
+{
+  return 3;
+}
+
+void
+VlcMacSubframeHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteHtolsbU16 (m_length);
+  start.WriteU8 (m_seqNum);
+}
+
+uint32_t
+VlcMacSubframeHeader::Deserialize (Buffer::Iterator start)
+{
+  m_length = start.ReadLsbtohU16 ();
+  m_seqNum = start.ReadU8 ();
+  return GetSerializedSize ();
+}
+
+void
+VlcMacSubframeHeader::SetLength (uint16_t length)
+{
+  m_length = length;
+}
+
+uint16_t
+VlcMacSubframeHeader::GetLength (void) const
+{
+  return m_length;
+}
+
+void
+VlcMacSubframeHeader::SetSeqNum (uint8_t seqNum)
+{
+  m_seqNum = seqNum;
+}
+
+uint8_t
+VlcMacSubframeHeader::GetSeqNum (void) const
+{
+  return m_seqNum;
+}
+
+} // namespace ns3
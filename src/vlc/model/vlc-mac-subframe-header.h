@@ -0,0 +1,85 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_MAC_SUBFRAME_HEADER_H
+#define VLC_MAC_SUBFRAME_HEADER_H
+
+#include <ns3/header.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The header of a subframe of an aggregated MAC frame.
+ *
+ * An aggregated frame consists of a MAC header with the aggregation bit set,
+ * a sequence of subframes and a MAC trailer, whose FCS only covers the MAC
+ * header. Each subframe is this header, followed by the MSDU and an FCS over
+ * the subframe header and the MSDU, so that a corrupted subframe does not
+ * invalidate the others.
+ */
+class VlcMacSubframeHeader : public Header
+{
+public:
+  VlcMacSubframeHeader (void);
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * Set the length of the MSDU following the header.
+   *
+   * \param length the length in octets
+   */
+  void SetLength (uint16_t length);
+
+  /**
+   * \return the length of the MSDU following the header in octets
+   */
+  uint16_t GetLength (void) const;
+
+  /**
+   * Set the sequence number of the MSDU.
+   *
+   * \param seqNum the sequence number
+   */
+  void SetSeqNum (uint8_t seqNum);
+
+  /**
+   * \return the sequence number of the MSDU
+   */
+  uint8_t GetSeqNum (void) const;
+
+private:
+  uint16_t m_length;   //!< the length of the MSDU
+  uint8_t m_seqNum;    //!< the sequence number of the MSDU
+};
+
+} // namespace ns3
+
+#endif /* VLC_MAC_SUBFRAME_HEADER_H */
@@ -21,6 +21,90 @@
 
 namespace ns3 {
 
+namespace {
+
+/**
+ * The slicing-by-8 tables of the CRC-16. table[0] is the usual byte-wise
+ * table, table[k][b] is the CRC of byte b followed by k zero bytes.
+ */
+struct Crc16Tables
+{
+  Crc16Tables (void)
+  {
+    for (uint32_t b = 0; b < 256; b++)
+      {
+        uint16_t crc = b;
+        for (uint32_t bit = 0; bit < 8; bit++)
+          {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+          }
+        table[0][b] = crc;
+      }
+    for (uint32_t k = 1; k < 8; k++)
+      {
+        for (uint32_t b = 0; b < 256; b++)
+          {
+            table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xff];
+          }
+      }
+  }
+
+  uint16_t table[8][256]; //!< the tables
+};
+
+/**
+ * \return the CRC-16 tables, built on first use
+ */
+const Crc16Tables &
+GetCrc16Tables (void)
+{
+  static Crc16Tables tables;
+  return tables;
+}
+
+/**
+ * Packets do not expose their buffer, but hand an iterator over all of it
+ * to a header being peeked. This header does not deserialize anything, it
+ * computes the CRC-16 over the whole packet in place.
+ */
+class VlcMacFcsCalculator : public Header
+{
+public:
+  VlcMacFcsCalculator (void)
+    : m_crc (0)
+  {
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return Header::GetTypeId ();
+  }
+  virtual void Print (std::ostream &os) const
+  {
+    os << "CRC = " << m_crc;
+  }
+  virtual uint32_t GetSerializedSize (void) const
+  {
+    return 0;
+  }
+  virtual void Serialize (Buffer::Iterator start) const
+  {
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator start)
+  {
+    m_crc = VlcMacTrailer::GenerateCrc16 (start, start.GetSize ());
+    return 0;
+  }
+  uint16_t GetCrc (void) const
+  {
+    return m_crc;
+  }
+
+private:
+  uint16_t m_crc; //!< the CRC of the peeked packet
+};
+
+} // anonymous namespace
+
 NS_OBJECT_ENSURE_REGISTERED (VlcMacTrailer);
 
 const uint16_t VlcMacTrailer::VLC_MAC_FCS_LENGTH = 2;
@@ -88,13 +172,7 @@ VlcMacTrailer::SetFcs (Ptr<const Packet> p)
 {
   if (m_calcFcs)
     {
-      uint16_t size = p->GetSize ();
-      uint8_t *serial_packet = new uint8_t[size];
-
-      p->CopyData (serial_packet, size);
-
-      m_fcs = GenerateCrc16 (serial_packet, size);
-      delete[] serial_packet;
+      m_fcs = GenerateCrc16 (p);
     }
 }
 
@@ -109,15 +187,7 @@ VlcMacTrailer::CheckFcs (Ptr<const Packet> p)
     }
   else
     {
-      uint16_t checkFcs;
-      uint16_t size = p->GetSize ();
-      uint8_t *serial_packet = new uint8_t[size];
-
-      p->CopyData (serial_packet, size);
-
-      checkFcs = GenerateCrc16 (serial_packet, size);
-      delete[] serial_packet;
-      return (checkFcs == GetFcs ());
+      return (GenerateCrc16 (p) == GetFcs ());
     }
 }
 
@@ -138,21 +208,32 @@ VlcMacTrailer::IsFcsEnabled (void)
 }
 
 uint16_t
-VlcMacTrailer::GenerateCrc16 (uint8_t *data, int length)
+VlcMacTrailer::GenerateCrc16 (Buffer::Iterator start, uint32_t length)
 {
-  int i;
-  uint16_t accumulator = 0;
+  const uint16_t (*table)[256] = GetCrc16Tables ().table;
+  uint16_t crc = 0;
 
-  for (i = 0; i < length; ++i)
+  for (; length >= 8; length -= 8)
+    {
+      uint64_t data = start.ReadLsbtohU64 () ^ crc;
+      crc = table[7][data & 0xff] ^ table[6][(data >> 8) & 0xff]
+        ^ table[5][(data >> 16) & 0xff] ^ table[4][(data >> 24) & 0xff]
+        ^ table[3][(data >> 32) & 0xff] ^ table[2][(data >> 40) & 0xff]
+        ^ table[1][(data >> 48) & 0xff] ^ table[0][data >> 56];
+    }
+  for (; length > 0; length--)
     {
-      accumulator ^= *data;
-      accumulator  = (accumulator >> 8) | (accumulator << 8);
-      accumulator ^= (accumulator & 0xff00) << 4;
-      accumulator ^= (accumulator >> 8) >> 4;
-      accumulator ^= (accumulator & 0xff00) >> 5;
-      ++data;
+      crc = (crc >> 8) ^ table[0][(crc ^ start.ReadU8 ()) & 0xff];
     }
-  return accumulator;
+  return crc;
+}
+
+uint16_t
+VlcMacTrailer::GenerateCrc16 (Ptr<const Packet> p)
+{
+  VlcMacFcsCalculator calculator;
+  p->PeekHeader (calculator);
+  return calculator.GetCrc ();
 }
 
 } //namespace ns3
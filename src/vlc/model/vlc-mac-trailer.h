@@ -52,9 +52,26 @@ public:
 
   bool IsFcsEnabled (void);
 
+  /**
+   * Compute the ITU-T CRC-16 used as FCS (polynomial x^16 + x^12 + x^5 + 1,
+   * LSB first, initial value 0) over the bytes following an iterator. The
+   * data is read in place, eight bytes at a time, using slicing-by-8 tables.
+   *
+   * \param start the iterator pointing to the first byte
+   * \param length the number of bytes
+   * \return the CRC
+   */
+  static uint16_t GenerateCrc16 (Buffer::Iterator start, uint32_t length);
+
 private:
 
-  uint16_t GenerateCrc16 (uint8_t *data, int length);
+  /**
+   * Compute the CRC-16 over a whole packet without copying it.
+   *
+   * \param p the packet
+   * \return the CRC
+   */
+  static uint16_t GenerateCrc16 (Ptr<const Packet> p);
 
   uint16_t m_fcs;
 
@@ -20,6 +20,9 @@
 #include "vlc-csmaca.h"
 #include "vlc-mac-header.h"
 #include "vlc-mac-trailer.h"
+#include "vlc-mac-subframe-header.h"
+#include "vlc-mcs-tag.h"
+#include "vlc-mac-command-header.h"
 #include <ns3/simulator.h>
 #include <ns3/log.h>
 #include <ns3/uinteger.h>
@@ -27,6 +30,9 @@
 #include <ns3/packet.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/double.h>
+#include <ns3/pointer.h>
+#include <ns3/boolean.h>
+#include <algorithm>
 
 #undef NS_LOG_APPEND_CONTEXT
 #define NS_LOG_APPEND_CONTEXT                                   \
@@ -39,6 +45,9 @@ NS_LOG_COMPONENT_DEFINE ("VlcMac");
 NS_OBJECT_ENSURE_REGISTERED (VlcMac);
 
 const uint32_t VlcMac::aMinMPDUOverhead = 9;
+const uint32_t VlcMac::aGtsDescPersistenceTime = 4;
+const uint32_t VlcMac::aMaxLostBeacons = 4;
+const uint32_t VlcMac::aMinCapLength = 440;
 
 TypeId
 VlcMac::GetTypeId (void)
@@ -51,6 +60,77 @@ VlcMac::GetTypeId (void)
                    UintegerValue (),
                    MakeUintegerAccessor (&VlcMac::m_macVpanId),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("TxQueue", "The transaction queue of the MAC",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcMac::GetTxQueue),
+                   MakePointerChecker<VlcMacQueue> ())
+    .AddAttribute ("Aggregation",
+                   "Pack MSDUs queued for the same destination into one PSDU "
+                   "with a subframe per MSDU, acknowledged by a block ACK",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&VlcMac::m_aggregation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxAggregateSize",
+                   "The largest aggregated PSDU in octets, further limited "
+                   "by the MaxPsduSize of the PHY",
+                   UintegerValue (1023),
+                   MakeUintegerAccessor (&VlcMac::m_maxAggregateSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxSubframes",
+                   "The largest number of MSDUs in an aggregated PSDU",
+                   UintegerValue (VlcMacBlockAckHeader::MAX_SUBFRAMES),
+                   MakeUintegerAccessor (&VlcMac::m_maxSubframes),
+                   MakeUintegerChecker<uint32_t> (1, VlcMacBlockAckHeader::MAX_SUBFRAMES))
+    .AddAttribute ("BlockAck",
+                   "Send acknowledged unicast data frames in windows, "
+                   "only the last frame of a window requests an ACK and the "
+                   "receiver answers with a block ACK of the whole window",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&VlcMac::m_blockAck),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BlockAckWindow",
+                   "The largest number of frames acknowledged by one block ACK",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&VlcMac::m_blockAckWindow),
+                   MakeUintegerChecker<uint32_t> (1, VlcMacBlockAckHeader::MAX_SUBFRAMES))
+    .AddAttribute ("RateControl",
+                   "The link adaptation of acknowledged unicast data frames, "
+                   "none to send all frames at the Mcs of the PHY",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcMac::SetRateControl,
+                                        &VlcMac::GetRateControl),
+                   MakePointerChecker<VlcRateControl> ())
+    .AddAttribute ("GtsTxQueue", "The queue of the MSDUs sent in the GTS of the device",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcMac::GetGtsTxQueue),
+                   MakePointerChecker<VlcMacQueue> ())
+    .AddAttribute ("GtsScheduler", "The GTS allocation of the coordinator",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcMac::GetGtsScheduler),
+                   MakePointerChecker<VlcGtsScheduler> ())
+    .AddAttribute ("PendingTransactionTable",
+                   "The transactions the coordinator keeps for indirect transmission",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcMac::GetPendingTransactionTable),
+                   MakePointerChecker<VlcPendingTransactionTable> ())
+    .AddAttribute ("TransactionPersistenceTime",
+                   "The time an indirect transaction is kept, in beacon intervals, "
+                   "or in base superframe durations without beacons",
+                   UintegerValue (0x01f4),
+                   MakeUintegerAccessor (&VlcMac::m_transactionPersistenceTime),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("AutoRequest",
+                   "Send a data request command to the coordinator when its "
+                   "beacon announces pending data for this device",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&VlcMac::m_autoRequest),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AckRelayDelay",
+                   "The additional time to wait for an ACK relayed over "
+                   "another link by the receiver of a frame",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&VlcMac::m_ackRelayDelay),
+                   MakeTimeChecker ())
     .AddTraceSource ("MacTxEnqueue",
                      "Trace source indicating a packet has been "
                      "enqueued in the transaction queue",
@@ -118,6 +198,26 @@ VlcMac::GetTypeId (void)
                      "the sent packet",
                      MakeTraceSourceAccessor (&VlcMac::m_sentPktTrace),
                      "ns3::VlcMac::SentTracedCallback")
+    .AddTraceSource ("MacTxAggregate",
+                     "The number of MSDUs and the size of each PSDU "
+                     "built in aggregation mode",
+                     MakeTraceSourceAccessor (&VlcMac::m_aggregationTrace),
+                     "ns3::VlcMac::AggregationTracedCallback")
+    .AddTraceSource ("BlockAckAirtimeSaved",
+                     "The number of frames acknowledged by a block ACK "
+                     "window and the airtime saved over one ACK per frame",
+                     MakeTraceSourceAccessor (&VlcMac::m_blockAckTrace),
+                     "ns3::VlcMac::BlockAckTracedCallback")
+    .AddTraceSource ("MacBeaconTx",
+                     "Trace source indicating a beacon has been sent "
+                     "by the coordinator",
+                     MakeTraceSourceAccessor (&VlcMac::m_macBeaconTxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("MacBeaconRx",
+                     "Trace source indicating a beacon of the coordinator "
+                     "has been received",
+                     MakeTraceSourceAccessor (&VlcMac::m_macBeaconRxTrace),
+                     "ns3::Packet::TracedCallback")
   ;
   return tid;
 }
@@ -136,11 +236,55 @@ VlcMac::VlcMac ()
   m_retransmission = 0;
   m_numCsmacaRetry = 0;
   m_txPkt = 0;
+  m_aggregation = false;
+  m_maxAggregateSize = 1023;
+  m_maxSubframes = VlcMacBlockAckHeader::MAX_SUBFRAMES;
+  m_blockAck = false;
+  m_blockAckWindow = 8;
+  m_txBlockAckRetries = 0;
+  m_txMcs = IEEE_802_15_7_INVALID_MCS;
+  m_txQueue = CreateObject<VlcMacQueue> ();
+  m_txQueue->SetDropCallback (MakeCallback (&VlcMac::TxQueueDrop, this));
+  m_gtsQueue = CreateObject<VlcMacQueue> ();
+  m_gtsQueue->SetDropCallback (MakeCallback (&VlcMac::TxQueueDrop, this));
+  m_gtsScheduler = CreateObject<VlcGtsScheduler> ();
+  m_pendingTable = CreateObject<VlcPendingTransactionTable> ();
+  m_pendingTable->SetExpireCallback (MakeCallback (&VlcMac::PendingTransactionExpired, this));
+  m_indirectTx.m_msduHandle = 0;
+  m_transactionPersistenceTime = 0x01f4;
+  m_autoRequest = true;
+  m_pollPending = false;
+  m_pollConfirm = false;
+  m_ackFramePending = false;
+  m_handoverPending = false;
+  m_awaitingBeacon = false;
+  m_holdingFrames = false;
+  m_prevVpanId = 0;
+  m_ackRelayDelay = Seconds (0);
+
+  m_aBaseSlotDuration = 60;
+  m_aNumSuperframeSlots = 16;
+  m_aBaseSuperFrameDuration = m_aBaseSlotDuration * m_aNumSuperframeSlots;
+  m_macBeaconOrder = 15;
+  m_macSupeframeOrder = 15;
+  m_vpanCoordinator = false;
+  m_beaconTracking = false;
+  m_finalCapSlot = m_aNumSuperframeSlots - 1;
+  m_superframeStart = Seconds (0);
+  m_beaconDuration = Seconds (0);
+  m_lostBeacons = 0;
+  m_gts.m_startingSlot = 0;
+  m_gts.m_length = 0;
+  m_gts.m_direction = GTS_TRANSMIT;
+  m_inGts = false;
+  m_gtsRequestPending = false;
+  m_gtsRequestBeacons = -1;
 
   Ptr<UniformRandomVariable> uniformVar = CreateObject<UniformRandomVariable> ();
   uniformVar->SetAttribute ("Min", DoubleValue (0.0));
   uniformVar->SetAttribute ("Max", DoubleValue (255.0));
   m_macDsn = SequenceNumber8 (uniformVar->GetValue ());
+  m_macBsn = SequenceNumber8 (uniformVar->GetValue ());
   m_shortAddress = Mac16Address ("00:00");
 }
 
@@ -172,15 +316,47 @@ VlcMac::DoDispose ()
       m_csmaCa = 0;
     }
   m_txPkt = 0;
-  for (uint32_t i = 0; i < m_txQueue.size (); i++)
+  m_txQElements.clear ();
+  m_txPsdu = 0;
+  m_blockAckPending.clear ();
+  m_blockAckRetry.clear ();
+  m_blockAckScoreboards.clear ();
+  m_txQueue->Dispose ();
+  m_txQueue = 0;
+  m_gtsQueue->Dispose ();
+  m_gtsQueue = 0;
+  m_gtsScheduler->Dispose ();
+  m_gtsScheduler = 0;
+  m_pendingTable->Dispose ();
+  m_pendingTable = 0;
+  m_extracted.clear ();
+  m_indirectTx.m_packet = 0;
+  m_pollTimeout.Cancel ();
+  m_handoverTimeout.Cancel ();
+  m_capTransaction.elements.clear ();
+  m_capTransaction.psdu = 0;
+  m_gtsTransaction.elements.clear ();
+  m_gtsTransaction.psdu = 0;
+  m_beaconEvent.Cancel ();
+  m_beaconTrackingEvent.Cancel ();
+  m_gtsStartEvent.Cancel ();
+  m_gtsEndEvent.Cancel ();
+  m_phy = 0;
+  if (m_rateControl != 0)
     {
-      m_txQueue[i]->txQPkt = 0;
-      delete m_txQueue[i];
+      m_rateControl->Dispose ();
     }
-  m_txQueue.clear ();
-  m_phy = 0;
+  m_rateControl = 0;
   m_mcpsDataIndicationCallback = MakeNullCallback< void, McpsDataIndicationParams, Ptr<Packet> > ();
   m_mcpsDataConfirmCallback = MakeNullCallback< void, McpsDataConfirmParams > ();
+  m_mlmeStartConfirmCallback = MakeNullCallback< void, MlmeStartConfirmParams > ();
+  m_mlmeSyncLossIndicationCallback = MakeNullCallback< void, MlmeSyncLossIndicationParams > ();
+  m_mlmeGtsConfirmCallback = MakeNullCallback< void, MlmeGtsConfirmParams > ();
+  m_mlmeGtsIndicationCallback = MakeNullCallback< void, MlmeGtsIndicationParams > ();
+  m_mlmePollConfirmCallback = MakeNullCallback< void, MlmePollConfirmParams > ();
+  m_mlmeHandoverConfirmCallback = MakeNullCallback< void, MlmeHandoverConfirmParams > ();
+  m_mlmeBeaconNotifyIndicationCallback = MakeNullCallback< void, MlmeBeaconNotifyIndicationParams > ();
+  m_ackRelayCallback = MakeNullCallback< void, McpsDataIndicationParams, Ptr<Packet> > ();
 
   Object::DoDispose ();
 }
@@ -253,7 +429,7 @@ VlcMac::McpsDataRequest (McpsDataRequestParams params, Ptr<Packet> p)
   VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_DATA, m_macDsn.GetValue ());
   m_macDsn++;
 
-  if (p->GetSize () > VlcPhy::aMaxPhyPacketSize - aMinMPDUOverhead)
+  if (p->GetSize () > m_phy->GetMaxPsduSize () - aMinMPDUOverhead)
     {
       // Note, this is just testing maximum theoretical frame size per the spec
       // The frame could still be too large once headers are put on
@@ -360,15 +536,26 @@ VlcMac::McpsDataRequest (McpsDataRequestParams params, Ptr<Packet> p)
     }
 
   //if is Slotted CSMA means its beacon enabled
+  bool gtsTransmission = false;
   if (m_csmaCa->IsSlottedCsmaCa ())
     {
       if (b1 == TX_OPTION_GTS)
         {
-          //TODO:GTS Transmission
+          if (m_gts.m_length == 0)
+            {
+              NS_LOG_ERROR (this << " no transmit GTS allocated to this device");
+              confirmParams.m_status = IEEE_802_15_7_INVALID_GTS;
+              if (!m_mcpsDataConfirmCallback.IsNull ())
+                {
+                  m_mcpsDataConfirmCallback (confirmParams);
+                }
+              return;
+            }
+          gtsTransmission = true;
         }
       else if (b1 == 0)
         {
-          //TODO:CAP Transmission
+          // CAP transmission, through slotted CSMA-CA.
         }
       else
         {
@@ -395,15 +582,16 @@ VlcMac::McpsDataRequest (McpsDataRequestParams params, Ptr<Packet> p)
         }
     }
 
+  bool indirect = false;
   if (b2 == TX_OPTION_INDIRECT)
     {
-      //TODO :indirect tx
+      // Only a coordinator keeps transactions for its devices, others and
+      // broadcast frames are sent directly.
+      indirect = m_vpanCoordinator && !gtsTransmission
+        && ((macHdr.GetDstAddrMode () == SHORT_ADDR && macHdr.GetShortDstAddr () != Mac16Address ("ff:ff"))
+            || macHdr.GetDstAddrMode () == EXT_ADDR);
     }
-  else if (b2 == 0)
-    {
-      //TODO :direct tx
-    }
-  else
+  else if (b2 != 0)
     {
       NS_LOG_ERROR (this << "Incorrect TxOptions bit 2 not 0/1");
       confirmParams.m_status = IEEE_802_15_7_INVALID_PARAMETER;
@@ -427,166 +615,1619 @@ VlcMac::McpsDataRequest (McpsDataRequestParams params, Ptr<Packet> p)
 
   m_macTxEnqueueTrace (p);
 
-  TxQueueElement *txQElement = new TxQueueElement;
-  txQElement->txQMsduHandle = params.m_msduHandle;
-  txQElement->txQPkt = p;
-  m_txQueue.push_back (txQElement);
+  if (indirect)
+    {
+      // The MSDU waits for a data request command of its destination.
+      uint64_t unitSymbols = static_cast<uint64_t> (m_aBaseSuperFrameDuration)
+        << (IsBeaconEnabled () ? m_macBeaconOrder : 0);
+      Time persistence = Seconds (static_cast<double> (unitSymbols) * m_transactionPersistenceTime
+                                  / m_phy->GetDataOrSymbolRate (false));
+      if (!m_pendingTable->Enqueue (p, params.m_msduHandle, persistence))
+        {
+          m_macTxDropTrace (p);
+          confirmParams.m_status = IEEE_802_15_7_TRANSACTION_OVERFLOW;
+          if (!m_mcpsDataConfirmCallback.IsNull ())
+            {
+              m_mcpsDataConfirmCallback (confirmParams);
+            }
+        }
+      return;
+    }
 
-  CheckQueue ();
+  Ptr<VlcMacQueue> queue = gtsTransmission ? m_gtsQueue : m_txQueue;
+  if (queue->Enqueue (p, params.m_msduHandle))
+    {
+      CheckQueue ();
+    }
 }
 
 void
-VlcMac::CheckQueue ()
+VlcMac::MlmeStartRequest (MlmeStartRequestParams params)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << params.m_vpanId << static_cast<uint32_t> (params.m_beaconOrder)
+                        << static_cast<uint32_t> (params.m_superframeOrder));
 
-  // Pull a packet from the queue and start sending, if we are not already sending.
-  if (m_vlcMacState == MAC_IDLE && !m_txQueue.empty () && m_txPkt == 0 && !m_setMacState.IsRunning ())
+  MlmeStartConfirmParams confirmParams;
+  if (params.m_beaconOrder > 15 || params.m_superframeOrder > params.m_beaconOrder)
     {
-      TxQueueElement *txQElement = m_txQueue.front ();
-      m_txPkt = txQElement->txQPkt;
-      m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_CSMA);
+      NS_LOG_ERROR (this << " invalid beacon or superframe order");
+      confirmParams.m_status = MLME_INVALID_PARAMETER;
+      if (!m_mlmeStartConfirmCallback.IsNull ())
+        {
+          m_mlmeStartConfirmCallback (confirmParams);
+        }
+      return;
+    }
+
+  m_vpanCoordinator = true;
+  SetVpanId (params.m_vpanId);
+  m_macBeaconOrder = params.m_beaconOrder;
+  m_macSupeframeOrder = params.m_superframeOrder;
+  m_beaconEvent.Cancel ();
+  m_gtsScheduler->Clear ();
+  m_gtsDenials.clear ();
+  m_finalCapSlot = m_aNumSuperframeSlots - 1;
+
+  if (IsBeaconEnabled ())
+    {
+      // The CAP keeps aMinCapLength symbols after the largest beacon.
+      VlcMacBeaconHeader beaconHdr;
+      VlcGtsDescriptor descriptor;
+      descriptor.m_startingSlot = 1;
+      descriptor.m_length = 1;
+      descriptor.m_direction = GTS_TRANSMIT;
+      for (uint32_t i = 0; i < VlcMacBeaconHeader::MAX_GTS_DESCRIPTORS; i++)
+        {
+          beaconHdr.AddGtsDescriptor (descriptor);
+        }
+      for (uint32_t i = 0; i < VlcMacBeaconHeader::MAX_PENDING_ADDRESSES; i++)
+        {
+          beaconHdr.AddPendingExtAddress (Mac64Address ());
+        }
+      VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_BEACON, 0);
+      macHdr.SetSrcAddrMode (SHORT_ADDR);
+      macHdr.SetSrcAddrFields (GetVpanId (), GetShortAddress ());
+      macHdr.SetDstAddrMode (NO_VPANID_ADDR);
+      uint32_t beaconSize = macHdr.GetSerializedSize () + beaconHdr.GetSerializedSize ()
+        + VlcMacTrailer::VLC_MAC_FCS_LENGTH;
+      double symbolRate = m_phy->GetDataOrSymbolRate (false);
+      double capSymbols = aMinCapLength
+        + VlcPhy::GetPpduDuration (m_phy->GetMcs (), beaconSize,
+                                   m_phy->GetDimmingLevel ()).GetSeconds () * symbolRate;
+      uint64_t slotSymbols = m_aBaseSlotDuration << m_macSupeframeOrder;
+      uint64_t minCapSlots = std::min<uint64_t> (ceil (capSymbols / slotSymbols), m_aNumSuperframeSlots);
+      m_gtsScheduler->SetMinCapSlots (minCapSlots);
+
+      m_csmaCa->SetSlottedCsmaCa ();
+      m_superframeStart = Simulator::Now ();
+      m_beaconEvent = Simulator::ScheduleNow (&VlcMac::SendBeacon, this);
+    }
+  else
+    {
+      m_csmaCa->SetUnSlottedCsmaCa ();
+    }
+
+  confirmParams.m_status = MLME_SUCCESS;
+  if (!m_mlmeStartConfirmCallback.IsNull ())
+    {
+      m_mlmeStartConfirmCallback (confirmParams);
     }
 }
 
 void
-VlcMac::SetCsmaCa (Ptr<VlcCsmaCa> csmaCa)
+VlcMac::MlmeSyncRequest (MlmeSyncRequestParams params)
 {
-  m_csmaCa = csmaCa;
+  NS_LOG_FUNCTION (this << params.m_trackBeacon);
+
+  // Search the first beacon during the longest beacon interval.
+  m_beaconTracking = params.m_trackBeacon;
+  m_lostBeacons = 0;
+  m_beaconTrackingEvent.Cancel ();
+  m_beaconTrackingEvent = Simulator::Schedule (GetBeaconSearchTime (), &VlcMac::BeaconLost, this);
+}
+
+Time
+VlcMac::GetBeaconSearchTime (void) const
+{
+  uint64_t searchSymbols = m_aBaseSuperFrameDuration * ((1 << 14) + 1);
+  return Seconds (searchSymbols / m_phy->GetDataOrSymbolRate (false));
 }
 
 void
-VlcMac::SetPhy (Ptr<VlcPhy> phy)
+VlcMac::MlmeHandoverRequest (MlmeHandoverRequestParams params)
 {
-  m_phy = phy;
+  NS_LOG_FUNCTION (this << params.m_vpanId << params.m_coordShortAddr << params.m_makeBeforeBreak);
+
+  if (m_vpanCoordinator || m_handoverPending || params.m_vpanId == m_macVpanId)
+    {
+      NS_LOG_ERROR (this << " can not hand over to VPAN " << params.m_vpanId);
+      if (!m_mlmeHandoverConfirmCallback.IsNull ())
+        {
+          MlmeHandoverConfirmParams confirmParams;
+          confirmParams.m_status = MLME_INVALID_PARAMETER;
+          confirmParams.m_vpanId = m_macVpanId;
+          m_mlmeHandoverConfirmCallback (confirmParams);
+        }
+      return;
+    }
+
+  m_handoverRequest = params;
+  m_handoverPending = true;
+  m_beaconTracking = true;
+  if (!params.m_makeBeforeBreak)
+    {
+      // Stop tracking the beacons of the current coordinator, the
+      // superframe timing is kept for the transaction in progress.
+      m_beaconTrackingEvent.Cancel ();
+      m_lostBeacons = 0;
+      m_awaitingBeacon = true;
+      SwitchCoordinator ();
+      // Starts to hold the frames, unless a transaction is in progress.
+      CheckQueue ();
+    }
+  m_handoverTimeout = Simulator::Schedule (GetBeaconSearchTime (), &VlcMac::HandoverTimeout, this);
 }
 
-Ptr<VlcPhy>
-VlcMac::GetPhy (void)
+void
+VlcMac::SwitchCoordinator (void)
 {
-  return m_phy;
+  NS_LOG_FUNCTION (this << m_macVpanId << m_handoverRequest.m_vpanId);
+
+  m_prevVpanId = m_macVpanId;
+  m_prevCoordShortAddress = m_coordShortAddress;
+  m_macVpanId = m_handoverRequest.m_vpanId;
+  m_coordShortAddress = m_handoverRequest.m_coordShortAddr;
+  m_txQueue->ForEach (MakeCallback (&VlcMac::ReaddressFrame, this));
+  m_gtsQueue->ForEach (MakeCallback (&VlcMac::ReaddressFrame, this));
+  // The frames of a block ACK window are sent again to the new coordinator.
+  for (uint32_t i = 0; i < m_blockAckPending.size (); i++)
+    {
+      ReaddressFrame (m_blockAckPending[i].element.txQPkt);
+    }
+  for (uint32_t i = 0; i < m_blockAckRetry.size (); i++)
+    {
+      ReaddressFrame (m_blockAckRetry[i].element.txQPkt);
+    }
+
+  // The GTS were allocated by the previous coordinator.
+  m_gts.m_length = 0;
+  m_gtsStartEvent.Cancel ();
+  if (m_inGts)
+    {
+      m_gtsEndEvent.Cancel ();
+      EndGts ();
+    }
+  if (m_gtsRequestPending)
+    {
+      ConfirmGtsRequest (MLME_NO_BEACON);
+    }
 }
 
 void
-VlcMac::SetMcpsDataIndicationCallback (McpsDataIndicationCallback c)
+VlcMac::ReaddressFrame (Ptr<Packet> p)
 {
-  m_mcpsDataIndicationCallback = c;
+  VlcMacTrailer macTrailer;
+  p->RemoveTrailer (macTrailer);
+  VlcMacHeader macHdr;
+  p->RemoveHeader (macHdr);
+
+  if (macHdr.GetSrcVpanId () == m_prevVpanId)
+    {
+      if (macHdr.GetSrcAddrMode () == SHORT_ADDR)
+        {
+          macHdr.SetSrcAddrFields (m_macVpanId, macHdr.GetShortSrcAddr ());
+        }
+      else if (macHdr.GetSrcAddrMode () == EXT_ADDR)
+        {
+          macHdr.SetSrcAddrFields (m_macVpanId, macHdr.GetExtSrcAddr ());
+        }
+    }
+  if (macHdr.GetDstVpanId () == m_prevVpanId)
+    {
+      if (macHdr.GetDstAddrMode () == SHORT_ADDR)
+        {
+          Mac16Address dstAddr = macHdr.GetShortDstAddr ();
+          macHdr.SetDstAddrFields (m_macVpanId, dstAddr == m_prevCoordShortAddress ? m_coordShortAddress : dstAddr);
+        }
+      else if (macHdr.GetDstAddrMode () == EXT_ADDR)
+        {
+          macHdr.SetDstAddrFields (m_macVpanId, macHdr.GetExtDstAddr ());
+        }
+    }
+
+  p->AddHeader (macHdr);
+  if (Node::ChecksumEnabled ())
+    {
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (p);
+    }
+  p->AddTrailer (macTrailer);
 }
 
 void
-VlcMac::SetMcpsDataConfirmCallback (McpsDataConfirmCallback c)
+VlcMac::ConfirmHandover (VlcMlmeStatus status)
 {
-  m_mcpsDataConfirmCallback = c;
+  NS_LOG_FUNCTION (this << status);
+
+  m_handoverTimeout.Cancel ();
+  m_handoverPending = false;
+  bool resume = m_awaitingBeacon;
+  m_awaitingBeacon = false;
+  // The frames are sent again from now on.
+  Time interruption = m_holdingFrames ? Simulator::Now () - m_holdStart : Time (0);
+  m_holdingFrames = false;
+
+  if (!m_mlmeHandoverConfirmCallback.IsNull ())
+    {
+      MlmeHandoverConfirmParams confirmParams;
+      confirmParams.m_status = status;
+      confirmParams.m_vpanId = m_macVpanId;
+      confirmParams.m_interruption = interruption;
+      m_mlmeHandoverConfirmCallback (confirmParams);
+    }
+  if (resume)
+    {
+      CheckQueue ();
+    }
 }
 
 void
-VlcMac::PdDataIndication (uint32_t psduLength, Ptr<Packet> p, uint8_t wqi)
+VlcMac::HandoverTimeout (void)
 {
-  NS_ASSERT (m_vlcMacState == MAC_IDLE || m_vlcMacState == MAC_ACK_PENDING || m_vlcMacState == MAC_CSMA);
+  NS_LOG_FUNCTION (this);
 
-  NS_LOG_FUNCTION (this << psduLength << p << (uint16_t)wqi);
+  bool broken = m_awaitingBeacon;
+  ConfirmHandover (MLME_NO_BEACON);
+  if (broken)
+    {
+      // Neither coordinator is tracked any more.
+      m_beaconTracking = false;
+      BeaconLost ();
+    }
+}
 
-  bool acceptFrame;
+void
+VlcMac::MlmeGtsRequest (MlmeGtsRequestParams params)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (params.m_gtsLength) << params.m_direction
+                        << params.m_allocation);
 
-  Ptr<Packet> originalPkt = p->Copy (); // because we will strip headers
+  VlcMlmeStatus status = MLME_SUCCESS;
+  if (m_gtsRequestPending || params.m_gtsLength == 0
+      || params.m_gtsLength >= m_aNumSuperframeSlots)
+    {
+      status = MLME_INVALID_PARAMETER;
+    }
+  else if (m_shortAddress == Mac16Address ("ff:fe") || m_shortAddress == Mac16Address ("ff:ff"))
+    {
+      status = MLME_NO_SHORT_ADDRESS;
+    }
+  else if (m_vpanCoordinator || !IsBeaconEnabled ())
+    {
+      status = MLME_NO_BEACON;
+    }
+  if (status != MLME_SUCCESS)
+    {
+      NS_LOG_ERROR (this << " can not request a GTS, status " << status);
+      if (!m_mlmeGtsConfirmCallback.IsNull ())
+        {
+          MlmeGtsConfirmParams confirmParams;
+          confirmParams.m_status = status;
+          confirmParams.m_gtsLength = params.m_gtsLength;
+          confirmParams.m_direction = params.m_direction;
+          confirmParams.m_allocation = params.m_allocation;
+          m_mlmeGtsConfirmCallback (confirmParams);
+        }
+      return;
+    }
 
-  m_promiscSnifferTrace (originalPkt);
+  m_gtsRequest = params;
+  m_gtsRequestPending = true;
+  m_gtsRequestBeacons = -1;
 
-  m_macPromiscRxTrace (originalPkt);
-  // XXX no rejection tracing (to macRxDropTrace) being performed below
+  // The request is sent in the CAP, addressed to the coordinator.
+  VlcMacCommandHeader commandHdr (VlcMacCommandHeader::GTS_REQUEST);
+  commandHdr.SetGtsCharacteristics (params.m_gtsLength, params.m_direction, params.m_allocation);
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_COMMAND, m_macDsn.GetValue ());
+  m_macDsn++;
+  macHdr.SetSrcAddrMode (SHORT_ADDR);
+  macHdr.SetSrcAddrFields (GetVpanId (), GetShortAddress ());
+  macHdr.SetDstAddrMode (SHORT_ADDR);
+  macHdr.SetDstAddrFields (GetVpanId (), m_coordShortAddress);
+  macHdr.SetSecDisable ();
+  macHdr.SetAckReq ();
 
-  VlcMacTrailer receivedMacTrailer;
-  p->RemoveTrailer (receivedMacTrailer);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (commandHdr);
+  p->AddHeader (macHdr);
+  VlcMacTrailer macTrailer;
   if (Node::ChecksumEnabled ())
     {
-      receivedMacTrailer.EnableFcs (true);
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (p);
     }
+  p->AddTrailer (macTrailer);
 
-  // level 1 filtering
-  if (!receivedMacTrailer.CheckFcs (p))
+  m_macTxEnqueueTrace (p);
+  if (m_txQueue->Enqueue (p, 0))
     {
-      m_macRxDropTrace (originalPkt);
+      CheckQueue ();
     }
-  else
-    {
-      VlcMacHeader receivedMacHdr;
-      p->RemoveHeader (receivedMacHdr);
+}
 
-      McpsDataIndicationParams params;
-      params.m_dsn = receivedMacHdr.GetSeqNum ();
-      params.m_mpduLinkQuality = wqi;
-      params.m_srcVpanId = receivedMacHdr.GetSrcVpanId ();
-      params.m_srcAddrMode = receivedMacHdr.GetSrcAddrMode ();
-      switch (params.m_srcAddrMode)
-        {
-        case SHORT_ADDR:
-          params.m_srcAddr = receivedMacHdr.GetShortSrcAddr ();
-          NS_LOG_DEBUG ("Packet from " << params.m_srcAddr);
-          break;
-        case EXT_ADDR:
-          params.m_srcExtAddr = receivedMacHdr.GetExtSrcAddr ();
-          NS_LOG_DEBUG ("Packet from " << params.m_srcExtAddr);
-          break;
-        default:
-          break;
-        }
-      params.m_dstVpanId = receivedMacHdr.GetDstVpanId ();
-      params.m_dstAddrMode = receivedMacHdr.GetDstAddrMode ();
-      switch (params.m_dstAddrMode)
-        {
-        case SHORT_ADDR:
-          params.m_dstAddr = receivedMacHdr.GetShortDstAddr ();
-          NS_LOG_DEBUG ("Packet to " << params.m_dstAddr);
-          break;
-        case EXT_ADDR:
-          params.m_dstExtAddr = receivedMacHdr.GetExtDstAddr ();
-          NS_LOG_DEBUG ("Packet to " << params.m_dstExtAddr);
-          break;
-        default:
-          break;
-        }
+void
+VlcMac::SetMlmeStartConfirmCallback (MlmeStartConfirmCallback c)
+{
+  m_mlmeStartConfirmCallback = c;
+}
 
-      if (m_macPromiscuousMode)
+void
+VlcMac::SetMlmeSyncLossIndicationCallback (MlmeSyncLossIndicationCallback c)
+{
+  m_mlmeSyncLossIndicationCallback = c;
+}
+
+void
+VlcMac::SetMlmeGtsConfirmCallback (MlmeGtsConfirmCallback c)
+{
+  m_mlmeGtsConfirmCallback = c;
+}
+
+void
+VlcMac::SetMlmeGtsIndicationCallback (MlmeGtsIndicationCallback c)
+{
+  m_mlmeGtsIndicationCallback = c;
+}
+
+void
+VlcMac::MlmePollRequest (MlmePollRequestParams params)
+{
+  NS_LOG_FUNCTION (this << params.m_coordAddrMode << params.m_coordShortAddr << params.m_coordExtAddr);
+
+  if (m_pollPending || m_vpanCoordinator
+      || (params.m_coordAddrMode != SHORT_ADDR && params.m_coordAddrMode != EXT_ADDR))
+    {
+      NS_LOG_ERROR (this << " can not poll the coordinator");
+      if (!m_mlmePollConfirmCallback.IsNull ())
         {
-          //level 2 filtering
-          if (!m_mcpsDataIndicationCallback.IsNull ())
-            {
-              NS_LOG_DEBUG ("promiscuous mode, forwarding up");
-              m_mcpsDataIndicationCallback (params, p);
-            }
-          else
-            {
-              NS_LOG_ERROR (this << " Data Indication Callback not initialised");
-            }
+          MlmePollConfirmParams confirmParams;
+          confirmParams.m_status = MLME_INVALID_PARAMETER;
+          m_mlmePollConfirmCallback (confirmParams);
         }
-      else
-        {
-          //level 3 frame filtering
-          acceptFrame = (receivedMacHdr.GetType () != VlcMacHeader::VLC_MAC_RESERVED);
+      return;
+    }
 
-          if (acceptFrame)
-            {
-              acceptFrame = (receivedMacHdr.GetFrameVer () <= 1);
-            }
+  m_pollConfirm = true;
+  SendDataRequest (params);
+}
 
-          if (acceptFrame
-              && (receivedMacHdr.GetDstAddrMode () > 1))
-            {
-              acceptFrame = receivedMacHdr.GetDstVpanId () == m_macVpanId
-                || receivedMacHdr.GetDstVpanId () == 0xffff;
-            }
+void
+VlcMac::SetMlmePollConfirmCallback (MlmePollConfirmCallback c)
+{
+  m_mlmePollConfirmCallback = c;
+}
 
-          if (acceptFrame
-              && (receivedMacHdr.GetDstAddrMode () == 2))
-            {
-              acceptFrame = receivedMacHdr.GetShortDstAddr () == m_shortAddress
-                || receivedMacHdr.GetShortDstAddr () == Mac16Address ("ff:ff");        // check for broadcast addrs
-            }
+void
+VlcMac::SetMlmeHandoverConfirmCallback (MlmeHandoverConfirmCallback c)
+{
+  m_mlmeHandoverConfirmCallback = c;
+}
 
-          if (acceptFrame
-              && (receivedMacHdr.GetDstAddrMode () == 3))
-            {
-              acceptFrame = (receivedMacHdr.GetExtDstAddr () == m_selfExt);
+void
+VlcMac::SetMlmeBeaconNotifyIndicationCallback (MlmeBeaconNotifyIndicationCallback c)
+{
+  m_mlmeBeaconNotifyIndicationCallback = c;
+}
+
+Ptr<VlcPendingTransactionTable>
+VlcMac::GetPendingTransactionTable (void) const
+{
+  return m_pendingTable;
+}
+
+Ptr<VlcGtsScheduler>
+VlcMac::GetGtsScheduler (void) const
+{
+  return m_gtsScheduler;
+}
+
+Ptr<VlcMacQueue>
+VlcMac::GetGtsTxQueue (void) const
+{
+  return m_gtsQueue;
+}
+
+bool
+VlcMac::IsBeaconEnabled (void) const
+{
+  return m_macBeaconOrder < 15;
+}
+
+Time
+VlcMac::GetSlotDuration (void) const
+{
+  uint64_t slotSymbols = m_aBaseSlotDuration << m_macSupeframeOrder;
+  return Seconds (slotSymbols / m_phy->GetDataOrSymbolRate (false));
+}
+
+Time
+VlcMac::GetBeaconInterval (void) const
+{
+  uint64_t intervalSymbols = m_aBaseSuperFrameDuration << m_macBeaconOrder;
+  return Seconds (intervalSymbols / m_phy->GetDataOrSymbolRate (false));
+}
+
+Time
+VlcMac::GetUnitBackoffTime (void) const
+{
+  return Seconds (m_csmaCa->GetUnitBackoffPeriod () / m_phy->GetDataOrSymbolRate (false));
+}
+
+Time
+VlcMac::GetSuperframeStart (void) const
+{
+  // Superframes follow each other every beacon interval, also when a
+  // beacon has been missed.
+  Time start = m_superframeStart;
+  if (IsBeaconEnabled () && Simulator::Now () > start)
+    {
+      Time interval = GetBeaconInterval ();
+      start += ((Simulator::Now () - start) / interval) * interval;
+    }
+  return start;
+}
+
+Time
+VlcMac::GetCapStart (void) const
+{
+  return GetSuperframeStart () + m_beaconDuration;
+}
+
+Time
+VlcMac::GetCapEnd (void) const
+{
+  return GetSuperframeStart () + static_cast<int64_t> (m_finalCapSlot + 1) * GetSlotDuration ();
+}
+
+Time
+VlcMac::GetNextCapStart (void) const
+{
+  Time capStart = GetCapStart ();
+  if (Simulator::Now () < capStart)
+    {
+      return capStart;
+    }
+  return capStart + GetBeaconInterval ();
+}
+
+Time
+VlcMac::GetAckWaitTime (bool aggregation) const
+{
+  uint64_t ackWaitDuration = GetMacAckWaitDuration ();
+  if (aggregation)
+    {
+      // A block ACK is longer by its bitmap.
+      ackWaitDuration += ceil (VlcMacBlockAckHeader ().GetSerializedSize () * m_phy->GetPhySymbolsPerOctet ());
+    }
+  return Seconds (ackWaitDuration / m_phy->GetDataOrSymbolRate (false)) + m_ackRelayDelay;
+}
+
+Time
+VlcMac::GetTransactionDuration (void) const
+{
+  NS_ASSERT (m_txPkt);
+  return GetTransactionDuration (m_txPkt);
+}
+
+Time
+VlcMac::GetTransactionDuration (Ptr<const Packet> p) const
+{
+  VlcMcsTag mcsTag (m_phy->GetMcs ());
+  p->PeekPacketTag (mcsTag);
+  Time duration = Seconds (m_phy->aTurnaroundTime_RX_TX / m_phy->GetDataOrSymbolRate (false))
+    + VlcPhy::GetPpduDuration (mcsTag.Get (), p->GetSize (), m_phy->GetDimmingLevel ());
+
+  VlcMacHeader macHdr;
+  p->PeekHeader (macHdr);
+  if (macHdr.IsAckReq ())
+    {
+      duration += GetAckWaitTime (macHdr.IsAggregation () || macHdr.IsBlockAck ());
+    }
+  return duration;
+}
+
+Time
+VlcMac::GetMaxFrameTotalWaitTime (void) const
+{
+  // Every CSMA-CA attempt of the coordinator takes its backoff and up to
+  // two unit backoff periods for the CCA.
+  uint64_t unitBackoffs = 0;
+  uint8_t be = m_csmaCa->GetMacMinBE ();
+  for (uint32_t nb = 0; nb <= m_csmaCa->GetMacMaxCSMABackoffs (); nb++)
+    {
+      unitBackoffs += (1 << be) - 1 + 2;
+      be = std::min (static_cast<uint8_t> (be + 1), m_csmaCa->GetMacMaxBE ());
+    }
+  Time turnaround = Seconds (m_phy->aTurnaroundTime_RX_TX / m_phy->GetDataOrSymbolRate (false));
+  return GetUnitBackoffTime () * static_cast<int64_t> (unitBackoffs) + turnaround
+         + VlcPhy::GetPpduDuration (m_phy->GetMcs (), m_phy->GetMaxPsduSize (), m_phy->GetDimmingLevel ());
+}
+
+bool
+VlcMac::IsBusy (void) const
+{
+  return m_vlcMacState == MAC_SENDING || m_vlcMacState == MAC_ACK_PENDING
+         || m_setMacState.IsRunning ();
+}
+
+void
+VlcMac::SuspendTransaction (TxTransaction &transaction)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsBusy ());
+  NS_ASSERT (transaction.elements.empty ());
+
+  if (m_vlcMacState == MAC_CSMA)
+    {
+      m_csmaCa->Cancel ();
+      ChangeMacState (MAC_IDLE);
+    }
+  if (m_txQElements.empty ())
+    {
+      return;
+    }
+  transaction.elements.swap (m_txQElements);
+  transaction.psdu = m_txPsdu;
+  transaction.retransmission = m_retransmission;
+  transaction.numCsmacaRetry = m_numCsmacaRetry;
+  m_txPsdu = 0;
+  m_txPkt = 0;
+  m_retransmission = 0;
+  m_numCsmacaRetry = 0;
+}
+
+void
+VlcMac::ResumeTransaction (TxTransaction &transaction)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_txQElements.empty ());
+
+  m_txQElements.swap (transaction.elements);
+  m_txPsdu = transaction.psdu;
+  m_retransmission = transaction.retransmission;
+  m_numCsmacaRetry = transaction.numCsmacaRetry;
+  transaction.psdu = 0;
+}
+
+void
+VlcMac::SendBeacon (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // The beacon waits for the frame or ACK on the air.
+  if (IsBusy ())
+    {
+      m_beaconEvent = Simulator::Schedule (GetUnitBackoffTime (), &VlcMac::SendBeacon, this);
+      return;
+    }
+  SuspendTransaction (m_capTransaction);
+
+  // Every beacon lists all GTSs, followed by the recent denials.
+  VlcMacBeaconHeader beaconHdr;
+  beaconHdr.SetBeaconOrder (m_macBeaconOrder);
+  beaconHdr.SetSuperframeOrder (m_macSupeframeOrder);
+  m_finalCapSlot = m_gtsScheduler->GetFinalCapSlot ();
+  beaconHdr.SetFinalCapSlot (m_finalCapSlot);
+  beaconHdr.SetVpanCoordinator (true);
+  beaconHdr.SetGtsPermit (true);
+  const std::vector<VlcGtsDescriptor> &allocations = m_gtsScheduler->GetAllocations ();
+  for (uint32_t i = 0; i < allocations.size (); i++)
+    {
+      beaconHdr.AddGtsDescriptor (allocations[i]);
+    }
+  std::vector<std::pair<VlcGtsDescriptor, uint32_t> >::iterator it = m_gtsDenials.begin ();
+  while (it != m_gtsDenials.end ())
+    {
+      if (beaconHdr.GetGtsDescriptors ().size () < VlcMacBeaconHeader::MAX_GTS_DESCRIPTORS)
+        {
+          beaconHdr.AddGtsDescriptor (it->first);
+        }
+      if (--it->second == 0)
+        {
+          it = m_gtsDenials.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+
+  // The devices with pending transactions, which of them come first.
+  std::vector<Mac16Address> pendingShort;
+  std::vector<Mac64Address> pendingExt;
+  m_pendingTable->GetPendingAddresses (VlcMacBeaconHeader::MAX_PENDING_ADDRESSES, pendingShort, pendingExt);
+  for (uint32_t i = 0; i < pendingShort.size (); i++)
+    {
+      beaconHdr.AddPendingShortAddress (pendingShort[i]);
+    }
+  for (uint32_t i = 0; i < pendingExt.size (); i++)
+    {
+      beaconHdr.AddPendingExtAddress (pendingExt[i]);
+    }
+
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_BEACON, m_macBsn.GetValue ());
+  m_macBsn++;
+  macHdr.SetSrcAddrMode (SHORT_ADDR);
+  macHdr.SetSrcAddrFields (GetVpanId (), GetShortAddress ());
+  macHdr.SetDstAddrMode (NO_VPANID_ADDR);
+  macHdr.SetSecDisable ();
+  macHdr.SetNoAckReq ();
+
+  Ptr<Packet> beacon = Create<Packet> ();
+  beacon->AddHeader (beaconHdr);
+  beacon->AddHeader (macHdr);
+  VlcMacTrailer macTrailer;
+  if (Node::ChecksumEnabled ())
+    {
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (beacon);
+    }
+  beacon->AddTrailer (macTrailer);
+
+  // The superframe starts when the transmitter is enabled.
+  m_txPkt = beacon;
+  ChangeMacState (MAC_SENDING);
+  m_phy->PlmeSetTRXStateRequest (IEEE_802_15_7_PHY_TX_ON);
+}
+
+void
+VlcMac::ReceiveBeacon (const VlcMacHeader &receivedMacHdr, Ptr<Packet> p, uint32_t psduLength)
+{
+  NS_LOG_FUNCTION (this << p << psduLength);
+
+  if (m_vpanCoordinator || !(m_beaconTracking || m_beaconTrackingEvent.IsRunning ()))
+    {
+      return;
+    }
+  m_macBeaconRxTrace (p);
+
+  VlcMacBeaconHeader beaconHdr;
+  p->RemoveHeader (beaconHdr);
+  if (beaconHdr.GetBeaconOrder () >= 15
+      || beaconHdr.GetSuperframeOrder () > beaconHdr.GetBeaconOrder ())
+    {
+      NS_LOG_DEBUG ("Beacon of a VPAN without superframes");
+      return;
+    }
+
+  // The superframe started with the first symbol of the beacon, sent at the
+  // dimming level of the coordinator.
+  VlcMcsTag mcsTag (m_phy->GetMcs ());
+  p->PeekPacketTag (mcsTag);
+  m_beaconDuration = VlcPhy::GetPpduDuration (mcsTag.Get (), psduLength, m_phy->GetRxDimmingLevel ());
+  m_superframeStart = Simulator::Now () - m_beaconDuration;
+  m_macBeaconOrder = beaconHdr.GetBeaconOrder ();
+  m_macSupeframeOrder = beaconHdr.GetSuperframeOrder ();
+  m_finalCapSlot = beaconHdr.GetFinalCapSlot ();
+  m_coordShortAddress = receivedMacHdr.GetShortSrcAddr ();
+  m_lostBeacons = 0;
+  m_csmaCa->SetSlottedCsmaCa ();
+
+  m_beaconTrackingEvent.Cancel ();
+  if (m_beaconTracking)
+    {
+      Time interval = GetBeaconInterval ();
+      m_beaconTrackingEvent = Simulator::Schedule (interval + interval / 2, &VlcMac::BeaconLost, this);
+    }
+
+  // Look for the transmit GTS of this device, and for the answer to its
+  // pending request in the requested direction.
+  bool listed = false;
+  bool granted = false;
+  bool denied = false;
+  const std::vector<VlcGtsDescriptor> &descriptors = beaconHdr.GetGtsDescriptors ();
+  for (uint32_t i = 0; i < descriptors.size (); i++)
+    {
+      if (descriptors[i].m_address != m_shortAddress)
+        {
+          continue;
+        }
+      bool requested = descriptors[i].m_direction == m_gtsRequest.m_direction;
+      if (descriptors[i].m_startingSlot == 0)
+        {
+          denied = denied || requested;
+          continue;
+        }
+      granted = granted || requested;
+      if (descriptors[i].m_direction == GTS_TRANSMIT)
+        {
+          listed = true;
+          m_gts = descriptors[i];
+        }
+    }
+  if (!listed)
+    {
+      m_gts.m_length = 0;
+    }
+
+  if (m_gtsRequestPending && m_gtsRequest.m_allocation && m_gtsRequestBeacons >= 0)
+    {
+      if (granted)
+        {
+          ConfirmGtsRequest (MLME_SUCCESS);
+        }
+      else if (denied)
+        {
+          ConfirmGtsRequest (MLME_DENIED);
+        }
+      else if (++m_gtsRequestBeacons >= static_cast<int32_t> (aGtsDescPersistenceTime))
+        {
+          ConfirmGtsRequest (MLME_NO_DATA);
+        }
+    }
+
+  m_gtsStartEvent.Cancel ();
+  if (m_gts.m_length != 0)
+    {
+      Time slot = GetSlotDuration ();
+      Time gtsStart = m_superframeStart + static_cast<int64_t> (m_gts.m_startingSlot) * slot;
+      m_gtsEnd = gtsStart + static_cast<int64_t> (m_gts.m_length) * slot;
+      m_gtsStartEvent = Simulator::Schedule (gtsStart - Simulator::Now (), &VlcMac::StartGts, this);
+    }
+
+  // Ask for the data the coordinator keeps for this device.
+  const std::vector<Mac16Address> &pendingShort = beaconHdr.GetPendingShortAddresses ();
+  const std::vector<Mac64Address> &pendingExt = beaconHdr.GetPendingExtAddresses ();
+  bool pending = std::find (pendingShort.begin (), pendingShort.end (), m_shortAddress) != pendingShort.end ()
+    || std::find (pendingExt.begin (), pendingExt.end (), m_selfExt) != pendingExt.end ();
+  if (pending && m_autoRequest && !m_pollPending)
+    {
+      MlmePollRequestParams pollParams;
+      pollParams.m_coordAddrMode = SHORT_ADDR;
+      pollParams.m_coordVpanId = receivedMacHdr.GetSrcVpanId ();
+      pollParams.m_coordShortAddr = m_coordShortAddress;
+      SendDataRequest (pollParams);
+    }
+
+  if (m_handoverPending && m_macVpanId == m_handoverRequest.m_vpanId)
+    {
+      ConfirmHandover (MLME_SUCCESS);
+    }
+}
+
+void
+VlcMac::BeaconLost (void)
+{
+  NS_LOG_FUNCTION (this << m_lostBeacons);
+
+  m_lostBeacons++;
+  if (IsBeaconEnabled () && m_beaconTracking && m_lostBeacons < aMaxLostBeacons)
+    {
+      m_beaconTrackingEvent = Simulator::Schedule (GetBeaconInterval (), &VlcMac::BeaconLost, this);
+      return;
+    }
+
+  NS_LOG_DEBUG ("Lost the synchronization with the coordinator");
+  m_beaconTracking = false;
+  m_lostBeacons = 0;
+  m_macBeaconOrder = 15;
+  m_macSupeframeOrder = 15;
+  m_finalCapSlot = m_aNumSuperframeSlots - 1;
+  m_csmaCa->SetUnSlottedCsmaCa ();
+  m_gts.m_length = 0;
+  m_gtsStartEvent.Cancel ();
+  if (m_inGts)
+    {
+      m_gtsEndEvent.Cancel ();
+      EndGts ();
+    }
+  if (m_gtsRequestPending)
+    {
+      ConfirmGtsRequest (MLME_NO_BEACON);
+    }
+
+  if (!m_mlmeSyncLossIndicationCallback.IsNull ())
+    {
+      MlmeSyncLossIndicationParams indicationParams;
+      indicationParams.m_vpanId = m_macVpanId;
+      m_mlmeSyncLossIndicationCallback (indicationParams);
+    }
+}
+
+void
+VlcMac::ReceiveCommand (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  VlcMacCommandHeader commandHdr;
+  p->RemoveHeader (commandHdr);
+  if (commandHdr.GetCommandId () == VlcMacCommandHeader::DATA_REQUEST && m_vpanCoordinator)
+    {
+      ReceiveDataRequest (params);
+      return;
+    }
+  if (commandHdr.GetCommandId () != VlcMacCommandHeader::GTS_REQUEST
+      || !m_vpanCoordinator || !IsBeaconEnabled () || params.m_srcAddrMode != SHORT_ADDR)
+    {
+      NS_LOG_DEBUG ("Command " << commandHdr.GetCommandId () << " not handled");
+      return;
+    }
+
+  MlmeGtsIndicationParams indicationParams;
+  indicationParams.m_devAddress = params.m_srcAddr;
+  indicationParams.m_gtsLength = commandHdr.GetGtsLength ();
+  indicationParams.m_direction = commandHdr.GetGtsDirection ();
+  indicationParams.m_allocation = commandHdr.IsGtsAllocation ();
+  if (commandHdr.IsGtsAllocation ())
+    {
+      // Only transmit GTSs are supported, the coordinator has no GTS queue.
+      VlcGtsDescriptor descriptor;
+      if (commandHdr.GetGtsDirection () != GTS_TRANSMIT
+          || !m_gtsScheduler->Allocate (params.m_srcAddr, commandHdr.GetGtsLength (),
+                                        commandHdr.GetGtsDirection (), descriptor))
+        {
+          NS_LOG_DEBUG ("GTS request of " << params.m_srcAddr << " denied");
+          descriptor.m_address = params.m_srcAddr;
+          descriptor.m_startingSlot = 0;
+          descriptor.m_length = commandHdr.GetGtsLength ();
+          descriptor.m_direction = commandHdr.GetGtsDirection ();
+          m_gtsDenials.push_back (std::make_pair (descriptor, aGtsDescPersistenceTime));
+          return;
+        }
+    }
+  else if (!m_gtsScheduler->Deallocate (params.m_srcAddr, commandHdr.GetGtsDirection ()))
+    {
+      return;
+    }
+  if (!m_mlmeGtsIndicationCallback.IsNull ())
+    {
+      m_mlmeGtsIndicationCallback (indicationParams);
+    }
+}
+
+void
+VlcMac::ConfirmCommand (Ptr<const Packet> p, VlcMcpsDataConfirmStatus status)
+{
+  NS_LOG_FUNCTION (this << p << status);
+
+  Ptr<Packet> frame = p->Copy ();
+  VlcMacHeader macHdr;
+  frame->RemoveHeader (macHdr);
+  VlcMacCommandHeader commandHdr;
+  frame->RemoveHeader (commandHdr);
+  if (commandHdr.GetCommandId () == VlcMacCommandHeader::DATA_REQUEST && m_pollPending)
+    {
+      if (status != IEEE_802_15_7_SUCCESS)
+        {
+          ConfirmPoll (status == IEEE_802_15_7_NO_ACK ? MLME_NO_ACK : MLME_CHANNEL_ACCESS_FAILURE);
+        }
+      else if (!m_ackFramePending)
+        {
+          ConfirmPoll (MLME_NO_DATA);
+        }
+      else
+        {
+          // The receiver stays on until the data frame arrives.
+          m_pollTimeout = Simulator::Schedule (GetMaxFrameTotalWaitTime (), &VlcMac::ConfirmPoll, this, MLME_NO_DATA);
+        }
+      return;
+    }
+  if (commandHdr.GetCommandId () != VlcMacCommandHeader::GTS_REQUEST || !m_gtsRequestPending)
+    {
+      return;
+    }
+
+  if (status != IEEE_802_15_7_SUCCESS)
+    {
+      ConfirmGtsRequest (status == IEEE_802_15_7_NO_ACK ? MLME_NO_ACK : MLME_CHANNEL_ACCESS_FAILURE);
+    }
+  else if (!m_gtsRequest.m_allocation)
+    {
+      // The GTS is released as soon as the coordinator has the request.
+      if (m_gtsRequest.m_direction == GTS_TRANSMIT)
+        {
+          m_gts.m_length = 0;
+          m_gtsStartEvent.Cancel ();
+        }
+      ConfirmGtsRequest (MLME_SUCCESS);
+    }
+  else
+    {
+      // The allocation is confirmed by the following beacons.
+      m_gtsRequestBeacons = 0;
+    }
+}
+
+void
+VlcMac::ConfirmGtsRequest (VlcMlmeStatus status)
+{
+  NS_LOG_FUNCTION (this << status);
+
+  m_gtsRequestPending = false;
+  m_gtsRequestBeacons = -1;
+  if (!m_mlmeGtsConfirmCallback.IsNull ())
+    {
+      MlmeGtsConfirmParams confirmParams;
+      confirmParams.m_status = status;
+      confirmParams.m_gtsLength = m_gtsRequest.m_gtsLength;
+      confirmParams.m_direction = m_gtsRequest.m_direction;
+      confirmParams.m_allocation = m_gtsRequest.m_allocation;
+      m_mlmeGtsConfirmCallback (confirmParams);
+    }
+}
+
+void
+VlcMac::SendDataRequest (const MlmePollRequestParams &params)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_pollPending = true;
+  m_pollRequest = params;
+
+  VlcMacCommandHeader commandHdr (VlcMacCommandHeader::DATA_REQUEST);
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_COMMAND, m_macDsn.GetValue ());
+  m_macDsn++;
+  // A device without short address is known by its extended address.
+  if (m_shortAddress == Mac16Address ("ff:fe") || m_shortAddress == Mac16Address ("ff:ff"))
+    {
+      macHdr.SetSrcAddrMode (EXT_ADDR);
+      macHdr.SetSrcAddrFields (GetVpanId (), GetExtendedAddress ());
+    }
+  else
+    {
+      macHdr.SetSrcAddrMode (SHORT_ADDR);
+      macHdr.SetSrcAddrFields (GetVpanId (), GetShortAddress ());
+    }
+  macHdr.SetDstAddrMode (params.m_coordAddrMode);
+  if (params.m_coordAddrMode == SHORT_ADDR)
+    {
+      macHdr.SetDstAddrFields (params.m_coordVpanId, params.m_coordShortAddr);
+    }
+  else
+    {
+      macHdr.SetDstAddrFields (params.m_coordVpanId, params.m_coordExtAddr);
+    }
+  macHdr.SetSecDisable ();
+  macHdr.SetAckReq ();
+
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (commandHdr);
+  p->AddHeader (macHdr);
+  VlcMacTrailer macTrailer;
+  if (Node::ChecksumEnabled ())
+    {
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (p);
+    }
+  p->AddTrailer (macTrailer);
+
+  m_macTxEnqueueTrace (p);
+  if (m_txQueue->Enqueue (p, 0))
+    {
+      CheckQueue ();
+    }
+}
+
+void
+VlcMac::ReceiveDataRequest (const McpsDataIndicationParams &params)
+{
+  NS_LOG_FUNCTION (this);
+
+  VlcPendingTransaction transaction;
+  bool found = false;
+  if (params.m_srcAddrMode == SHORT_ADDR)
+    {
+      found = m_pendingTable->Extract (params.m_srcAddr, transaction);
+    }
+  else if (params.m_srcAddrMode == EXT_ADDR)
+    {
+      found = m_pendingTable->Extract (params.m_srcExtAddr, transaction);
+    }
+  if (!found)
+    {
+      NS_LOG_DEBUG ("No transaction pending for the device");
+      return;
+    }
+
+  // The frame pending bit tells the device to ask again.
+  Ptr<Packet> p = transaction.m_packet;
+  VlcMacTrailer macTrailer;
+  p->RemoveTrailer (macTrailer);
+  VlcMacHeader macHdr;
+  p->RemoveHeader (macHdr);
+  if (IsPendingFor (params))
+    {
+      macHdr.SetFrmPend ();
+    }
+  else
+    {
+      macHdr.SetNoFrmPend ();
+    }
+  p->AddHeader (macHdr);
+  if (Node::ChecksumEnabled ())
+    {
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (p);
+    }
+  p->AddTrailer (macTrailer);
+
+  m_extracted.push_back (transaction);
+  CheckQueue ();
+}
+
+bool
+VlcMac::IsPendingFor (const McpsDataIndicationParams &params) const
+{
+  if (!m_vpanCoordinator)
+    {
+      return false;
+    }
+  if (params.m_srcAddrMode == SHORT_ADDR)
+    {
+      return m_pendingTable->IsPending (params.m_srcAddr);
+    }
+  if (params.m_srcAddrMode == EXT_ADDR)
+    {
+      return m_pendingTable->IsPending (params.m_srcExtAddr);
+    }
+  return false;
+}
+
+void
+VlcMac::ConfirmPoll (VlcMlmeStatus status)
+{
+  NS_LOG_FUNCTION (this << status);
+
+  m_pollTimeout.Cancel ();
+  m_pollPending = false;
+  bool confirm = m_pollConfirm;
+  m_pollConfirm = false;
+
+  // Switch the receiver off again, unless a frame is on its way.
+  if (!m_macRxOnWhenIdle && m_vlcMacState == MAC_IDLE && !m_setMacState.IsRunning ())
+    {
+      m_phy->PlmeSetTRXStateRequest (IEEE_802_15_7_PHY_TRX_OFF);
+    }
+
+  if (confirm && !m_mlmePollConfirmCallback.IsNull ())
+    {
+      MlmePollConfirmParams confirmParams;
+      confirmParams.m_status = status;
+      m_mlmePollConfirmCallback (confirmParams);
+    }
+}
+
+void
+VlcMac::PendingTransactionExpired (Ptr<const Packet> p, uint8_t msduHandle)
+{
+  NS_LOG_FUNCTION (this << p << static_cast<uint32_t> (msduHandle));
+
+  m_macTxDropTrace (p);
+  if (!m_mcpsDataConfirmCallback.IsNull ())
+    {
+      McpsDataConfirmParams confirmParams;
+      confirmParams.m_msduHandle = msduHandle;
+      confirmParams.m_status = IEEE_802_15_7_TRANSACTION_EXPIRED;
+      m_mcpsDataConfirmCallback (confirmParams);
+    }
+}
+
+bool
+VlcMac::RestoreIndirectTransaction (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_indirectTx.m_packet == 0 || m_txQElements.size () != 1
+      || m_txQElements.front ().txQPkt != m_indirectTx.m_packet)
+    {
+      return false;
+    }
+
+  ReportTxResult (false);
+  if (!m_pendingTable->Restore (m_indirectTx))
+    {
+      ConfirmTxQElements (m_indirectTx.m_expiry <= Simulator::Now ()
+                          ? IEEE_802_15_7_TRANSACTION_EXPIRED : IEEE_802_15_7_TRANSACTION_OVERFLOW);
+    }
+  RemoveTxQElements ();
+  return true;
+}
+
+void
+VlcMac::StartGts (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Wait for the frame or ACK on the air.
+  if (IsBusy ())
+    {
+      if (Simulator::Now () + GetUnitBackoffTime () < m_gtsEnd)
+        {
+          m_gtsStartEvent = Simulator::Schedule (GetUnitBackoffTime (), &VlcMac::StartGts, this);
+        }
+      return;
+    }
+
+  // The CAP transaction continues in the next CAP.
+  SuspendTransaction (m_capTransaction);
+  m_inGts = true;
+  m_gtsEndEvent = Simulator::Schedule (m_gtsEnd - Simulator::Now (), &VlcMac::EndGts, this);
+  CheckQueue ();
+}
+
+void
+VlcMac::EndGts (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Wait for the frame or ACK on the air.
+  if (IsBusy ())
+    {
+      m_gtsEndEvent = Simulator::Schedule (GetUnitBackoffTime (), &VlcMac::EndGts, this);
+      return;
+    }
+
+  // A GTS transaction that did not fit continues in the next GTS.
+  m_inGts = false;
+  SuspendTransaction (m_gtsTransaction);
+  CheckQueue ();
+}
+
+void
+VlcMac::CheckQueue ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Pull a packet from the queue and start sending, if we are not already sending.
+  // An MSDU interrupted by sending an ACK is resumed before the next one is
+  // taken from the queue.
+  if (m_awaitingBeacon)
+    {
+      // The device left its coordinator, the frames wait for the next one
+      // once the transaction in progress is over.
+      if (!m_holdingFrames && m_vlcMacState == MAC_IDLE && m_txPkt == 0 && !m_setMacState.IsRunning ())
+        {
+          m_holdingFrames = true;
+          m_holdStart = Simulator::Now ();
+        }
+      return;
+    }
+  if (m_vlcMacState == MAC_IDLE && m_txPkt == 0 && !m_setMacState.IsRunning ())
+    {
+      // A transaction put aside for a beacon or a GTS comes first.
+      TxTransaction &suspended = m_inGts ? m_gtsTransaction : m_capTransaction;
+      if (m_txQElements.empty () && !suspended.elements.empty ())
+        {
+          ResumeTransaction (suspended);
+        }
+      else if (m_txQElements.empty () && m_inGts)
+        {
+          // Only a frame completing before the end of the GTS is sent.
+          Ptr<const Packet> next = m_gtsQueue->Peek ();
+          if (next == 0 || Simulator::Now () + GetTransactionDuration (next) > m_gtsEnd)
+            {
+              return;
+            }
+          TxQueueElement txQElement;
+          m_gtsQueue->DequeueHead (txQElement.txQPkt, txQElement.txQMsduHandle);
+          m_txQElements.push_back (txQElement);
+          BuildTxPsdu ();
+        }
+      else if (m_txQElements.empty () && !m_extracted.empty ())
+        {
+          // Extracted indirect transactions answer a data request, they
+          // are sent before the transaction queue.
+          m_indirectTx = m_extracted.front ();
+          m_extracted.erase (m_extracted.begin ());
+          TxQueueElement txQElement;
+          txQElement.txQPkt = m_indirectTx.m_packet;
+          txQElement.txQMsduHandle = m_indirectTx.m_msduHandle;
+          m_txQElements.push_back (txQElement);
+          BuildTxPsdu ();
+        }
+      else if (m_txQElements.empty ())
+        {
+          TxQueueElement txQElement;
+          bool dequeued = false;
+          m_txBlockAckRetries = 0;
+          // The frames missing from a block ACK go before the queue.
+          Ptr<const Packet> next = m_txQueue->Peek ();
+          if (!m_blockAckRetry.empty ())
+            {
+              next = m_blockAckRetry.front ().element.txQPkt;
+            }
+          if (!m_blockAckPending.empty ()
+              && !IsBlockAckNext (next, m_blockAckPending.front ().element.txQPkt))
+            {
+              // Nothing more joins the window, its last frame is sent
+              // again to request the block ACK.
+              txQElement = m_blockAckPending.back ().element;
+              m_txBlockAckRetries = m_blockAckPending.back ().retries;
+              m_blockAckPending.pop_back ();
+            }
+          else if (!m_blockAckRetry.empty ())
+            {
+              txQElement = m_blockAckRetry.front ().element;
+              m_txBlockAckRetries = m_blockAckRetry.front ().retries;
+              m_blockAckRetry.pop_front ();
+            }
+          else if (m_txQueue->Dequeue (txQElement.txQPkt, txQElement.txQMsduHandle))
+            {
+              dequeued = true;
+            }
+          else
+            {
+              return;
+            }
+          m_txQElements.push_back (txQElement);
+          if (m_aggregation && dequeued && m_blockAckPending.empty ())
+            {
+              AggregateTxQElements ();
+            }
+          BuildTxPsdu ();
+          if (m_blockAck && m_txQElements.size () == 1 && IsBlockAckEligible (txQElement.txQPkt))
+            {
+              // The frame closes the window when it is full or when the
+              // next frame cannot join it.
+              Ptr<const Packet> first = m_blockAckPending.empty () ? txQElement.txQPkt
+                : m_blockAckPending.front ().element.txQPkt;
+              next = m_txQueue->Peek ();
+              if (!m_blockAckRetry.empty ())
+                {
+                  next = m_blockAckRetry.front ().element.txQPkt;
+                }
+              bool request = m_blockAckPending.size () + 1 >= m_blockAckWindow
+                || !IsBlockAckNext (next, first);
+              m_txPsdu = CreateBlockAckFrame (txQElement.txQPkt, request);
+            }
+        }
+      m_txPkt = m_txPsdu;
+      m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_CSMA);
+    }
+}
+
+void
+VlcMac::TxQueueDrop (Ptr<const Packet> p, uint8_t msduHandle)
+{
+  NS_LOG_FUNCTION (this << p << static_cast<uint32_t> (msduHandle));
+
+  m_macTxDropTrace (p);
+  // The queue may be in the middle of a dequeue operation, so the upper
+  // layer is notified once it has finished.
+  VlcMacHeader hdr;
+  p->PeekHeader (hdr);
+  if (hdr.IsCommand ())
+    {
+      Simulator::ScheduleNow (&VlcMac::ConfirmCommand, this, p, IEEE_802_15_7_TRANSACTION_OVERFLOW);
+    }
+  else
+    {
+      Simulator::ScheduleNow (&VlcMac::ConfirmTxQueueDrop, this, msduHandle);
+    }
+}
+
+void
+VlcMac::ConfirmTxQueueDrop (uint8_t msduHandle)
+{
+  if (!m_mcpsDataConfirmCallback.IsNull ())
+    {
+      McpsDataConfirmParams confirmParams;
+      confirmParams.m_msduHandle = msduHandle;
+      confirmParams.m_status = IEEE_802_15_7_TRANSACTION_OVERFLOW;
+      m_mcpsDataConfirmCallback (confirmParams);
+    }
+}
+
+void
+VlcMac::AggregateTxQElements (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  VlcMacHeader firstHdr;
+  Ptr<const Packet> first = m_txQElements.front ().txQPkt;
+  uint32_t firstHdrSize = first->PeekHeader (firstHdr);
+  if (!firstHdr.IsData ())
+    {
+      return;
+    }
+
+  // Every MSDU is carried in a subframe, which replaces the MAC header of
+  // the queued MPDU by a subframe header. The aggregated frame adds one MAC
+  // header and trailer.
+  VlcMacSubframeHeader subframeHdr;
+  uint32_t maxSize = std::min (m_maxAggregateSize, m_phy->GetMaxPsduSize ());
+  uint32_t size = firstHdrSize + VlcMacTrailer::VLC_MAC_FCS_LENGTH
+    + first->GetSize () - firstHdrSize + subframeHdr.GetSerializedSize ();
+
+  while (m_txQElements.size () < m_maxSubframes)
+    {
+      Ptr<const Packet> next = m_txQueue->Peek ();
+      if (next == 0)
+        {
+          break;
+        }
+      VlcMacHeader hdr;
+      uint32_t hdrSize = next->PeekHeader (hdr);
+      if (!hdr.IsData () || hdr.IsAckReq () != firstHdr.IsAckReq ()
+          || !IsSameDestination (hdr, firstHdr))
+        {
+          break;
+        }
+      uint32_t subframeSize = next->GetSize () - hdrSize + subframeHdr.GetSerializedSize ();
+      if (size + subframeSize > maxSize)
+        {
+          break;
+        }
+      TxQueueElement txQElement;
+      m_txQueue->DequeueHead (txQElement.txQPkt, txQElement.txQMsduHandle);
+      m_txQElements.push_back (txQElement);
+      size += subframeSize;
+    }
+}
+
+bool
+VlcMac::IsSameDestination (const VlcMacHeader &a, const VlcMacHeader &b)
+{
+  return a.GetDstAddrMode () == b.GetDstAddrMode ()
+         && a.GetDstVpanId () == b.GetDstVpanId ()
+         && (a.GetDstAddrMode () != SHORT_ADDR || a.GetShortDstAddr () == b.GetShortDstAddr ())
+         && (a.GetDstAddrMode () != EXT_ADDR || a.GetExtDstAddr () == b.GetExtDstAddr ());
+}
+
+void
+VlcMac::BuildTxPsdu (void)
+{
+  NS_LOG_FUNCTION (this << m_txQElements.size ());
+  NS_ASSERT (!m_txQElements.empty ());
+
+  if (m_txQElements.size () == 1)
+    {
+      m_txPsdu = m_txQElements.front ().txQPkt;
+    }
+  else
+    {
+      VlcMacHeader macHdr;
+      m_txQElements.front ().txQPkt->PeekHeader (macHdr);
+      macHdr.SetSeqNum (m_macDsn.GetValue ());
+      m_macDsn++;
+      macHdr.SetAggregation ();
+
+      m_txPsdu = Create<Packet> ();
+      for (uint32_t i = 0; i < m_txQElements.size (); i++)
+        {
+          Ptr<Packet> subframe = m_txQElements[i].txQPkt->Copy ();
+          VlcMacHeader hdr;
+          subframe->RemoveHeader (hdr);
+          VlcMacTrailer trailer;
+          subframe->RemoveTrailer (trailer);
+
+          VlcMacSubframeHeader subframeHdr;
+          subframeHdr.SetLength (subframe->GetSize ());
+          subframeHdr.SetSeqNum (hdr.GetSeqNum ());
+          subframe->AddHeader (subframeHdr);
+          VlcMacTrailer subframeTrailer;
+          if (Node::ChecksumEnabled ())
+            {
+              subframeTrailer.EnableFcs (true);
+              subframeTrailer.SetFcs (subframe);
+            }
+          subframe->AddTrailer (subframeTrailer);
+          m_txPsdu->AddAtEnd (subframe);
+        }
+
+      // The FCS of the aggregated frame only covers the MAC header.
+      VlcMacTrailer macTrailer;
+      if (Node::ChecksumEnabled ())
+        {
+          Ptr<Packet> mhr = Create<Packet> ();
+          mhr->AddHeader (macHdr);
+          macTrailer.EnableFcs (true);
+          macTrailer.SetFcs (mhr);
+        }
+      m_txPsdu->AddHeader (macHdr);
+      m_txPsdu->AddTrailer (macTrailer);
+    }
+
+  if (m_aggregation)
+    {
+      m_aggregationTrace (m_txQElements.size (), m_txPsdu->GetSize ());
+    }
+}
+
+Ptr<VlcMacQueue>
+VlcMac::GetTxQueue (void) const
+{
+  return m_txQueue;
+}
+
+void
+VlcMac::SetCsmaCa (Ptr<VlcCsmaCa> csmaCa)
+{
+  m_csmaCa = csmaCa;
+}
+
+void
+VlcMac::SetPhy (Ptr<VlcPhy> phy)
+{
+  m_phy = phy;
+  if (m_rateControl != 0)
+    {
+      m_rateControl->SetupPhy (m_phy);
+    }
+}
+
+Ptr<VlcPhy>
+VlcMac::GetPhy (void)
+{
+  return m_phy;
+}
+
+void
+VlcMac::SetRateControl (Ptr<VlcRateControl> rateControl)
+{
+  m_rateControl = rateControl;
+  if (m_rateControl != 0 && m_phy != 0)
+    {
+      m_rateControl->SetupPhy (m_phy);
+    }
+}
+
+Ptr<VlcRateControl>
+VlcMac::GetRateControl (void) const
+{
+  return m_rateControl;
+}
+
+void
+VlcMac::SetMcpsDataIndicationCallback (McpsDataIndicationCallback c)
+{
+  m_mcpsDataIndicationCallback = c;
+}
+
+void
+VlcMac::SetMcpsDataConfirmCallback (McpsDataConfirmCallback c)
+{
+  m_mcpsDataConfirmCallback = c;
+}
+
+void
+VlcMac::PdDataIndication (uint32_t psduLength, Ptr<Packet> p, uint8_t wqi)
+{
+  NS_ASSERT (m_vlcMacState == MAC_IDLE || m_vlcMacState == MAC_ACK_PENDING || m_vlcMacState == MAC_CSMA);
+
+  NS_LOG_FUNCTION (this << psduLength << p << (uint16_t)wqi);
+
+  bool acceptFrame;
+
+  Ptr<Packet> originalPkt = p->Copy (); // because we will strip headers
+
+  m_promiscSnifferTrace (originalPkt);
+
+  m_macPromiscRxTrace (originalPkt);
+  // XXX no rejection tracing (to macRxDropTrace) being performed below
+
+  VlcMacTrailer receivedMacTrailer;
+  p->RemoveTrailer (receivedMacTrailer);
+  if (Node::ChecksumEnabled ())
+    {
+      receivedMacTrailer.EnableFcs (true);
+    }
+
+  // The FCS of an aggregated frame only covers the MAC header, the
+  // subframes are checked one by one.
+  Ptr<const Packet> fcsPkt = p;
+  VlcMacHeader peekedMacHdr;
+  uint32_t peekedMacHdrSize = p->PeekHeader (peekedMacHdr);
+  if (peekedMacHdr.IsData () && peekedMacHdr.IsAggregation ())
+    {
+      fcsPkt = p->CreateFragment (0, peekedMacHdrSize);
+    }
+
+  // level 1 filtering
+  if (!receivedMacTrailer.CheckFcs (fcsPkt))
+    {
+      m_macRxDropTrace (originalPkt);
+    }
+  else
+    {
+      VlcMacHeader receivedMacHdr;
+      p->RemoveHeader (receivedMacHdr);
+
+      McpsDataIndicationParams params;
+      params.m_dsn = receivedMacHdr.GetSeqNum ();
+      params.m_mpduLinkQuality = wqi;
+      params.m_srcVpanId = receivedMacHdr.GetSrcVpanId ();
+      params.m_srcAddrMode = receivedMacHdr.GetSrcAddrMode ();
+      switch (params.m_srcAddrMode)
+        {
+        case SHORT_ADDR:
+          params.m_srcAddr = receivedMacHdr.GetShortSrcAddr ();
+          NS_LOG_DEBUG ("Packet from " << params.m_srcAddr);
+          break;
+        case EXT_ADDR:
+          params.m_srcExtAddr = receivedMacHdr.GetExtSrcAddr ();
+          NS_LOG_DEBUG ("Packet from " << params.m_srcExtAddr);
+          break;
+        default:
+          break;
+        }
+      params.m_dstVpanId = receivedMacHdr.GetDstVpanId ();
+      params.m_dstAddrMode = receivedMacHdr.GetDstAddrMode ();
+      switch (params.m_dstAddrMode)
+        {
+        case SHORT_ADDR:
+          params.m_dstAddr = receivedMacHdr.GetShortDstAddr ();
+          NS_LOG_DEBUG ("Packet to " << params.m_dstAddr);
+          break;
+        case EXT_ADDR:
+          params.m_dstExtAddr = receivedMacHdr.GetExtDstAddr ();
+          NS_LOG_DEBUG ("Packet to " << params.m_dstExtAddr);
+          break;
+        default:
+          break;
+        }
+
+      if (receivedMacHdr.IsBeacon () && !m_vpanCoordinator)
+        {
+          if (!m_mlmeBeaconNotifyIndicationCallback.IsNull ())
+            {
+              MlmeBeaconNotifyIndicationParams notifyParams;
+              notifyParams.m_coordVpanId = receivedMacHdr.GetSrcVpanId ();
+              notifyParams.m_coordShortAddr = receivedMacHdr.GetShortSrcAddr ();
+              notifyParams.m_linkQuality = wqi;
+              notifyParams.m_rxPower = 10 * log10 (m_phy->GetRxPower ()) + 30;
+              m_mlmeBeaconNotifyIndicationCallback (notifyParams);
+            }
+          // Make-before-break, the device moves with the first beacon of
+          // the target, which is then received as the beacon of its VPAN.
+          if (m_handoverPending && m_handoverRequest.m_makeBeforeBreak
+              && receivedMacHdr.GetSrcVpanId () == m_handoverRequest.m_vpanId)
+            {
+              SwitchCoordinator ();
+            }
+        }
+
+      if (m_macPromiscuousMode)
+        {
+          //level 2 filtering
+          if (!m_mcpsDataIndicationCallback.IsNull ())
+            {
+              NS_LOG_DEBUG ("promiscuous mode, forwarding up");
+              m_mcpsDataIndicationCallback (params, p);
+            }
+          else
+            {
+              NS_LOG_ERROR (this << " Data Indication Callback not initialised");
+            }
+        }
+      else
+        {
+          //level 3 frame filtering
+          acceptFrame = (receivedMacHdr.GetType () != VlcMacHeader::VLC_MAC_RESERVED);
+
+          if (acceptFrame)
+            {
+              acceptFrame = (receivedMacHdr.GetFrameVer () <= 1);
+            }
+
+          if (acceptFrame
+              && (receivedMacHdr.GetDstAddrMode () > 1))
+            {
+              acceptFrame = receivedMacHdr.GetDstVpanId () == m_macVpanId
+                || receivedMacHdr.GetDstVpanId () == 0xffff;
+            }
+
+          if (acceptFrame
+              && (receivedMacHdr.GetDstAddrMode () == 2))
+            {
+              acceptFrame = receivedMacHdr.GetShortDstAddr () == m_shortAddress
+                || receivedMacHdr.GetShortDstAddr () == Mac16Address ("ff:ff");        // check for broadcast addrs
+            }
+
+          if (acceptFrame
+              && (receivedMacHdr.GetDstAddrMode () == 3))
+            {
+              acceptFrame = (receivedMacHdr.GetExtDstAddr () == m_selfExt);
             }
 
           if (acceptFrame
@@ -603,113 +2244,563 @@ VlcMac::PdDataIndication (uint32_t psduLength, Ptr<Packet> p, uint8_t wqi)
                 }
             }
 
-          if (acceptFrame
-              && ((receivedMacHdr.GetType () == VlcMacHeader::VLC_MAC_DATA)
-                  || (receivedMacHdr.GetType () == VlcMacHeader::VLC_MAC_COMMAND))
-              && (receivedMacHdr.GetSrcAddrMode () > 1))
-            {
-              acceptFrame = receivedMacHdr.GetSrcVpanId () == m_macVpanId; // \todo need to check if PAN coord
-            }
+          if (acceptFrame
+              && ((receivedMacHdr.GetType () == VlcMacHeader::VLC_MAC_DATA)
+                  || (receivedMacHdr.GetType () == VlcMacHeader::VLC_MAC_COMMAND))
+              && (receivedMacHdr.GetSrcAddrMode () > 1))
+            {
+              acceptFrame = receivedMacHdr.GetSrcVpanId () == m_macVpanId; // \todo need to check if PAN coord
+            }
+
+          if (acceptFrame)
+            {
+              m_macRxTrace (originalPkt);
+
+              if (m_rateControl != 0)
+                {
+                  // ACKs carry no source address, they come from the
+                  // destination of the attempt in progress.
+                  if (receivedMacHdr.IsAcknowledgment ())
+                    {
+                      if (m_txMcs != IEEE_802_15_7_INVALID_MCS)
+                        {
+                          m_rateControl->ReportRxWqi (m_txStation, wqi);
+                        }
+                    }
+                  else if (params.m_srcAddrMode == SHORT_ADDR)
+                    {
+                      m_rateControl->ReportRxWqi (params.m_srcAddr, wqi);
+                    }
+                  else if (params.m_srcAddrMode == EXT_ADDR)
+                    {
+                      m_rateControl->ReportRxWqi (params.m_srcExtAddr, wqi);
+                    }
+                }
+
+              bool aggregate = receivedMacHdr.IsData () && receivedMacHdr.IsAggregation ();
+              VlcMacBlockAckHeader blockAck;
+              if (aggregate)
+                {
+                  blockAck = ReceiveAggregate (params, p);
+                }
+
+              // The frames of a block ACK window are recorded for the block
+              // ACK, a frame received before is not forwarded again.
+              bool window = receivedMacHdr.IsData () && receivedMacHdr.IsBlockAck () && !aggregate;
+              bool duplicate = false;
+              if (window)
+                {
+                  Address originator = params.m_srcAddrMode == SHORT_ADDR ? Address (params.m_srcAddr)
+                    : Address (params.m_srcExtAddr);
+                  duplicate = !RecordBlockAckFrame (originator, receivedMacHdr.GetSeqNum ());
+                  blockAck = GetBlockAckScoreboard (originator, receivedMacHdr.GetSeqNum ());
+                }
+
+              // \todo: What should we do if we receive a frame while waiting for an ACK?
+              //        Especially if this frame has the ACK request bit set, should we reply with an ACK, possibly missing the pending ACK?
+
+              // If the received frame is a frame with the ACK request bit set, we immediately send back an ACK.
+              // If we are currently waiting for a pending ACK, we assume the ACK was lost and trigger a retransmission after sending the ACK.
+              if ((receivedMacHdr.IsData () || receivedMacHdr.IsCommand ()) && receivedMacHdr.IsAckReq ()
+                  && !(receivedMacHdr.GetDstAddrMode () == SHORT_ADDR && receivedMacHdr.GetShortDstAddr () == "ff:ff"))
+                {
+                  // The ACK of a data request tells whether data follows.
+                  bool framePending = false;
+                  if (receivedMacHdr.IsCommand ())
+                    {
+                      VlcMacCommandHeader commandHdr;
+                      p->PeekHeader (commandHdr);
+                      framePending = commandHdr.GetCommandId () == VlcMacCommandHeader::DATA_REQUEST
+                        && IsPendingFor (params);
+                    }
+
+                  if (!m_ackRelayCallback.IsNull ())
+                    {
+                      // The ACK goes over another link, the medium access
+                      // and the pending ACK of this MAC are left alone.
+                      m_ackRelayCallback (params, aggregate || window ? CreateBlockAck (receivedMacHdr.GetSeqNum (), blockAck, window)
+                                          : CreateAck (receivedMacHdr.GetSeqNum (), framePending));
+                    }
+                  else
+                    {
+                      // If this is a data or mac command frame, which is not a broadcast,
+                      // with ack req set, generate and send an ack frame.
+                      // If there is a CSMA medium access in progress we cancel the medium access
+                      // for sending the ACK frame. A new transmission attempt will be started
+                      // after the ACK was send.
+                      if (m_vlcMacState == MAC_ACK_PENDING)
+                        {
+                          m_ackWaitTimeout.Cancel ();
+                          PrepareRetransmission ();
+                        }
+                      else if (m_vlcMacState == MAC_CSMA)
+                        {
+                          // \todo: If we receive a packet while doing CSMA/CA, should  we drop the packet because of channel busy,
+                          //        or should we restart CSMA/CA for the packet after sending the ACK?
+                          // Currently we simply restart CSMA/CA after sending the ACK.
+                          m_csmaCa->Cancel ();
+                        }
+                      // Cancel any pending MAC state change, ACKs have higher priority.
+                      m_setMacState.Cancel ();
+                      ChangeMacState (MAC_IDLE);
+                      if (aggregate || window)
+                        {
+                          m_setMacState = Simulator::ScheduleNow (&VlcMac::SendBlockAck, this, receivedMacHdr.GetSeqNum (),
+                                                                  blockAck, window);
+                        }
+                      else
+                        {
+                          m_setMacState = Simulator::ScheduleNow (&VlcMac::SendAck, this, receivedMacHdr.GetSeqNum (),
+                                                                  framePending);
+                        }
+                    }
+                }
+
+              if (receivedMacHdr.IsData () && m_pollTimeout.IsRunning ()
+                  && ((m_pollRequest.m_coordAddrMode == SHORT_ADDR && params.m_srcAddrMode == SHORT_ADDR
+                       && params.m_srcAddr == m_pollRequest.m_coordShortAddr)
+                      || (m_pollRequest.m_coordAddrMode == EXT_ADDR && params.m_srcAddrMode == EXT_ADDR
+                          && params.m_srcExtAddr == m_pollRequest.m_coordExtAddr)))
+                {
+                  // The data the coordinator kept for this device, ask for
+                  // the next one if more is pending.
+                  ConfirmPoll (MLME_SUCCESS);
+                  if (receivedMacHdr.IsFrmPend ())
+                    {
+                      SendDataRequest (m_pollRequest);
+                    }
+                }
+
+              if (receivedMacHdr.IsData () && !aggregate && !duplicate && !m_mcpsDataIndicationCallback.IsNull ())
+                {
+                  // If it is a data frame, push it up the stack.
+                  NS_LOG_DEBUG ("PdDataIndication():  Packet is for me; forwarding up");
+                  m_mcpsDataIndicationCallback (params, p);
+                }
+              else if (receivedMacHdr.IsBeacon ())
+                {
+                  ReceiveBeacon (receivedMacHdr, p, psduLength);
+                }
+              else if (receivedMacHdr.IsCommand ())
+                {
+                  ReceiveCommand (params, p);
+                }
+              else if (receivedMacHdr.IsAcknowledgment () && m_txPkt && m_vlcMacState == MAC_ACK_PENDING)
+                {
+                  ReceiveAck (receivedMacHdr, p);
+                }
+            }
+          else
+            {
+              m_macRxDropTrace (originalPkt);
+            }
+        }
+    }
+}
+
+void
+VlcMac::ReceiveAck (const VlcMacHeader &receivedMacHdr, Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  VlcMacHeader macHdr;
+  m_txPkt->PeekHeader (macHdr);
+  if (receivedMacHdr.GetSeqNum () == macHdr.GetSeqNum ()
+      && receivedMacHdr.IsAggregation () == macHdr.IsAggregation ()
+      && receivedMacHdr.IsBlockAck () == macHdr.IsBlockAck ())
+    {
+      // If it is an ACK with the expected sequence number, finish the transmission
+      // and notify the upper layer.
+      m_ackWaitTimeout.Cancel ();
+      VlcMacState nextState = MAC_IDLE;
+      if (receivedMacHdr.IsAggregation ())
+        {
+          // A block ACK: retransmit the subframes that were not received.
+          VlcMacBlockAckHeader receivedBlockAck;
+          p->RemoveHeader (receivedBlockAck);
+          if (!ReceiveBlockAck (receivedBlockAck))
+            {
+              ReportTxResult (true);
+            }
+          else if (PrepareRetransmission ())
+            {
+              nextState = MAC_CSMA;
+            }
+        }
+      else if (receivedMacHdr.IsBlockAck ())
+        {
+          // The block ACK of a window.
+          VlcMacBlockAckHeader receivedBlockAck;
+          p->RemoveHeader (receivedBlockAck);
+          ReportTxResult (true);
+          ReceiveWindowBlockAck (receivedMacHdr.GetSeqNum (), receivedBlockAck);
+        }
+      else
+        {
+          m_ackFramePending = receivedMacHdr.IsFrmPend ();
+          ReportTxResult (true);
+          ConfirmTxQElements (IEEE_802_15_7_SUCCESS);
+          RemoveTxQElements ();
+        }
+      m_setMacState.Cancel ();
+      m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, nextState);
+    }
+  else
+    {
+      // If it is an ACK with an unexpected sequence number, mark the current transmission as failed and start a retransmit. (cf 7.5.6.4.3)
+      m_ackWaitTimeout.Cancel ();
+      if (!PrepareRetransmission ())
+        {
+          m_setMacState.Cancel ();
+          m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_IDLE);
+        }
+      else
+        {
+          m_setMacState.Cancel ();
+          m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_CSMA);
+        }
+    }
+}
+
+void
+VlcMac::SetAckRelayCallback (AckRelayCallback c)
+{
+  m_ackRelayCallback = c;
+}
+
+void
+VlcMac::ReceiveRelayedAck (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  Ptr<Packet> ackPacket = p->Copy ();
+  VlcMacTrailer receivedMacTrailer;
+  ackPacket->RemoveTrailer (receivedMacTrailer);
+  if (Node::ChecksumEnabled ())
+    {
+      receivedMacTrailer.EnableFcs (true);
+    }
+
+  VlcMacHeader receivedMacHdr;
+  ackPacket->PeekHeader (receivedMacHdr);
+  if (!receivedMacTrailer.CheckFcs (ackPacket) || !receivedMacHdr.IsAcknowledgment ())
+    {
+      m_macRxDropTrace (p);
+      return;
+    }
+  ackPacket->RemoveHeader (receivedMacHdr);
+
+  m_macRxTrace (p);
+  if (m_txPkt && m_vlcMacState == MAC_ACK_PENDING)
+    {
+      ReceiveAck (receivedMacHdr, ackPacket);
+    }
+}
+
+VlcMacBlockAckHeader
+VlcMac::ReceiveAggregate (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  VlcMacBlockAckHeader blockAck;
+  VlcMacSubframeHeader subframeHdr;
+  uint32_t subframeHdrSize = subframeHdr.GetSerializedSize ();
+  for (uint32_t i = 0; p->GetSize () >= subframeHdrSize + VlcMacTrailer::VLC_MAC_FCS_LENGTH; i++)
+    {
+      p->PeekHeader (subframeHdr);
+      uint32_t size = subframeHdrSize + subframeHdr.GetLength () + VlcMacTrailer::VLC_MAC_FCS_LENGTH;
+      if (size > p->GetSize ())
+        {
+          NS_LOG_DEBUG ("Truncated subframe " << i);
+          break;
+        }
+      Ptr<Packet> subframe = p->CreateFragment (0, size);
+      p->RemoveAtStart (size);
+
+      VlcMacTrailer subframeTrailer;
+      subframe->RemoveTrailer (subframeTrailer);
+      if (Node::ChecksumEnabled ())
+        {
+          subframeTrailer.EnableFcs (true);
+        }
+      if (!subframeTrailer.CheckFcs (subframe))
+        {
+          NS_LOG_DEBUG ("FCS error in subframe " << i);
+          continue;
+        }
+      subframe->RemoveHeader (subframeHdr);
+      if (i < VlcMacBlockAckHeader::MAX_SUBFRAMES)
+        {
+          blockAck.SetReceived (i);
+        }
+      if (!m_mcpsDataIndicationCallback.IsNull ())
+        {
+          params.m_dsn = subframeHdr.GetSeqNum ();
+          m_mcpsDataIndicationCallback (params, subframe);
+        }
+    }
+  return blockAck;
+}
+
+bool
+VlcMac::ReceiveBlockAck (const VlcMacBlockAckHeader &blockAck)
+{
+  NS_LOG_FUNCTION (this << blockAck.GetBitmap ());
+
+  std::vector<TxQueueElement> missing;
+  for (uint32_t i = 0; i < m_txQElements.size (); i++)
+    {
+      if (blockAck.IsReceived (i))
+        {
+          m_macTxOkTrace (m_txQElements[i].txQPkt);
+          if (!m_mcpsDataConfirmCallback.IsNull ())
+            {
+              McpsDataConfirmParams confirmParams;
+              confirmParams.m_msduHandle = m_txQElements[i].txQMsduHandle;
+              confirmParams.m_status = IEEE_802_15_7_SUCCESS;
+              m_mcpsDataConfirmCallback (confirmParams);
+            }
+          FinishTxQElement (m_txQElements[i]);
+        }
+      else
+        {
+          missing.push_back (m_txQElements[i]);
+        }
+    }
+
+  if (missing.empty ())
+    {
+      RemoveTxQElements ();
+      return false;
+    }
+  m_txQElements.swap (missing);
+  BuildTxPsdu ();
+  m_txPkt = m_txPsdu;
+  return true;
+}
+
+bool
+VlcMac::IsBlockAckEligible (Ptr<const Packet> p) const
+{
+  VlcMacHeader hdr;
+  p->PeekHeader (hdr);
+  return hdr.IsData () && hdr.IsAckReq () && !hdr.IsAggregation ()
+         && (hdr.GetDstAddrMode () == EXT_ADDR
+             || (hdr.GetDstAddrMode () == SHORT_ADDR && hdr.GetShortDstAddr () != Mac16Address ("ff:ff")));
+}
+
+bool
+VlcMac::IsBlockAckNext (Ptr<const Packet> next, Ptr<const Packet> first) const
+{
+  if (next == 0 || !IsBlockAckEligible (next))
+    {
+      return false;
+    }
+  VlcMacHeader nextHdr;
+  next->PeekHeader (nextHdr);
+  VlcMacHeader firstHdr;
+  first->PeekHeader (firstHdr);
+  // The block ACK covers MAX_SUBFRAMES sequence numbers back from the last
+  // frame of the window.
+  uint8_t span = nextHdr.GetSeqNum () - firstHdr.GetSeqNum ();
+  return IsSameDestination (nextHdr, firstHdr) && span < VlcMacBlockAckHeader::MAX_SUBFRAMES;
+}
+
+Ptr<Packet>
+VlcMac::CreateBlockAckFrame (Ptr<const Packet> p, bool request) const
+{
+  Ptr<Packet> frame = p->Copy ();
+  VlcMacTrailer macTrailer;
+  frame->RemoveTrailer (macTrailer);
+  VlcMacHeader macHdr;
+  frame->RemoveHeader (macHdr);
+  macHdr.SetBlockAck ();
+  if (request)
+    {
+      macHdr.SetAckReq ();
+    }
+  else
+    {
+      macHdr.SetNoAckReq ();
+    }
+  frame->AddHeader (macHdr);
+  if (Node::ChecksumEnabled ())
+    {
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (frame);
+    }
+  frame->AddTrailer (macTrailer);
+  return frame;
+}
+
+void
+VlcMac::AddToBlockAckWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_txQElements.size () == 1);
 
-          if (acceptFrame)
-            {
-              m_macRxTrace (originalPkt);
-              // \todo: What should we do if we receive a frame while waiting for an ACK?
-              //        Especially if this frame has the ACK request bit set, should we reply with an ACK, possibly missing the pending ACK?
+  VlcMacHeader macHdr;
+  m_txPkt->PeekHeader (macHdr);
+  BlockAckElement e;
+  e.element = m_txQElements.front ();
+  e.seqNum = macHdr.GetSeqNum ();
+  e.retries = m_txBlockAckRetries;
+  m_blockAckPending.push_back (e);
+
+  // The rate control learns the outcome from the block ACK of the window.
+  m_txMcs = IEEE_802_15_7_INVALID_MCS;
+  m_txQElements.clear ();
+  m_txPsdu = 0;
+  m_txPkt = 0;
+  m_retransmission = 0;
+  m_numCsmacaRetry = 0;
+  m_txBlockAckRetries = 0;
+}
 
-              // If the received frame is a frame with the ACK request bit set, we immediately send back an ACK.
-              // If we are currently waiting for a pending ACK, we assume the ACK was lost and trigger a retransmission after sending the ACK.
-              if ((receivedMacHdr.IsData () || receivedMacHdr.IsCommand ()) && receivedMacHdr.IsAckReq ()
-                  && !(receivedMacHdr.GetDstAddrMode () == SHORT_ADDR && receivedMacHdr.GetShortDstAddr () == "ff:ff"))
-                {
-                  // If this is a data or mac command frame, which is not a broadcast,
-                  // with ack req set, generate and send an ack frame.
-                  // If there is a CSMA medium access in progress we cancel the medium access
-                  // for sending the ACK frame. A new transmission attempt will be started
-                  // after the ACK was send.
-                  if (m_vlcMacState == MAC_ACK_PENDING)
-                    {
-                      m_ackWaitTimeout.Cancel ();
-                      PrepareRetransmission ();
-                    }
-                  else if (m_vlcMacState == MAC_CSMA)
-                    {
-                      // \todo: If we receive a packet while doing CSMA/CA, should  we drop the packet because of channel busy,
-                      //        or should we restart CSMA/CA for the packet after sending the ACK?
-                      // Currently we simply restart CSMA/CA after sending the ACK.
-                      m_csmaCa->Cancel ();
-                    }
-                  // Cancel any pending MAC state change, ACKs have higher priority.
-                  m_setMacState.Cancel ();
-                  ChangeMacState (MAC_IDLE);
-                  m_setMacState = Simulator::ScheduleNow (&VlcMac::SendAck, this, receivedMacHdr.GetSeqNum ());
-                }
+void
+VlcMac::ReceiveWindowBlockAck (uint8_t seqno, const VlcMacBlockAckHeader &blockAck)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (seqno) << blockAck.GetBitmap ());
 
-              if (receivedMacHdr.IsData () && !m_mcpsDataIndicationCallback.IsNull ())
-                {
-                  // If it is a data frame, push it up the stack.
-                  NS_LOG_DEBUG ("PdDataIndication():  Packet is for me; forwarding up");
-                  m_mcpsDataIndicationCallback (params, p);
-                }
-              else if (receivedMacHdr.IsAcknowledgment () && m_txPkt && m_vlcMacState == MAC_ACK_PENDING)
-                {
-                  VlcMacHeader macHdr;
-                  m_txPkt->PeekHeader (macHdr);
-                  if (receivedMacHdr.GetSeqNum () == macHdr.GetSeqNum ())
-                    {
-                      m_macTxOkTrace (m_txPkt);
-                      // If it is an ACK with the expected sequence number, finish the transmission
-                      // and notify the upper layer.
-                      m_ackWaitTimeout.Cancel ();
-                      if (!m_mcpsDataConfirmCallback.IsNull ())
-                        {
-                          TxQueueElement *txQElement = m_txQueue.front ();
-                          McpsDataConfirmParams confirmParams;
-                          confirmParams.m_msduHandle = txQElement->txQMsduHandle;
-                          confirmParams.m_status = IEEE_802_15_7_SUCCESS;
-                          m_mcpsDataConfirmCallback (confirmParams);
-                        }
-                      RemoveFirstTxQElement ();
-                      m_setMacState.Cancel ();
-                      m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_IDLE);
-                    }
-                  else
-                    {
-                      // If it is an ACK with an unexpected sequence number, mark the current transmission as failed and start a retransmit. (cf 7.5.6.4.3)
-                      m_ackWaitTimeout.Cancel ();
-                      if (!PrepareRetransmission ())
-                        {
-                          m_setMacState.Cancel ();
-                          m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_IDLE);
-                        }
-                      else
-                        {
-                          m_setMacState.Cancel ();
-                          m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_CSMA);
-                        }
-                    }
-                }
-            }
-          else
-            {
-              m_macRxDropTrace (originalPkt);
-            }
+  uint32_t nFrames = m_blockAckPending.size () + 1;
+  for (uint32_t i = 0; i < m_blockAckPending.size (); i++)
+    {
+      BlockAckElement &e = m_blockAckPending[i];
+      if (blockAck.IsReceived (static_cast<uint8_t> (seqno - e.seqNum)))
+        {
+          FinishBlockAckElement (e, IEEE_802_15_7_SUCCESS);
+        }
+      else if (e.retries >= m_macMaxFrameRetries)
+        {
+          FinishBlockAckElement (e, IEEE_802_15_7_NO_ACK);
+        }
+      else
+        {
+          e.retries++;
+          m_blockAckRetry.push_back (e);
         }
     }
+  m_blockAckPending.clear ();
+
+  // The frame requesting the block ACK has been received.
+  ConfirmTxQElements (IEEE_802_15_7_SUCCESS);
+  RemoveTxQElements ();
+
+  // Every frame of the window would have been acknowledged on its own.
+  Time saved = GetAckAirtime (CreateAck (seqno, false)) * nFrames
+    - GetAckAirtime (CreateBlockAck (seqno, blockAck, true));
+  m_blockAckTrace (nFrames, saved);
 }
 
 void
-VlcMac::SendAck (uint8_t seqno)
+VlcMac::FailBlockAckWindow (void)
 {
-  NS_LOG_FUNCTION (this << static_cast<uint32_t> (seqno));
+  NS_LOG_FUNCTION (this << m_blockAckPending.size ());
 
-  NS_ASSERT (m_vlcMacState == MAC_IDLE);
+  for (uint32_t i = 0; i < m_blockAckPending.size (); i++)
+    {
+      FinishBlockAckElement (m_blockAckPending[i], IEEE_802_15_7_NO_ACK);
+    }
+  m_blockAckPending.clear ();
+}
+
+void
+VlcMac::FinishBlockAckElement (const BlockAckElement &e, VlcMcpsDataConfirmStatus status)
+{
+  Ptr<const Packet> p = e.element.txQPkt;
+  if (status == IEEE_802_15_7_SUCCESS)
+    {
+      m_macTxOkTrace (p);
+    }
+  else
+    {
+      m_macTxDropTrace (p);
+    }
+  if (!m_mcpsDataConfirmCallback.IsNull ())
+    {
+      McpsDataConfirmParams confirmParams;
+      confirmParams.m_msduHandle = e.element.txQMsduHandle;
+      confirmParams.m_status = status;
+      m_mcpsDataConfirmCallback (confirmParams);
+    }
+  m_sentPktTrace (p, e.retries + 1, 0);
+  m_macTxDequeueTrace (p);
+}
+
+bool
+VlcMac::RecordBlockAckFrame (const Address &originator, uint8_t seqNum)
+{
+  NS_LOG_FUNCTION (this << originator << static_cast<uint32_t> (seqNum));
+
+  std::map<Address, BlockAckScoreboard>::iterator it = m_blockAckScoreboards.find (originator);
+  if (it == m_blockAckScoreboards.end ())
+    {
+      BlockAckScoreboard scoreboard;
+      scoreboard.lastSeqNum = seqNum;
+      scoreboard.bitmap = 1;
+      m_blockAckScoreboards[originator] = scoreboard;
+      return true;
+    }
+
+  BlockAckScoreboard &scoreboard = it->second;
+  uint8_t ahead = seqNum - scoreboard.lastSeqNum;
+  uint8_t behind = scoreboard.lastSeqNum - seqNum;
+  if (ahead != 0 && ahead < 128)
+    {
+      // A newer frame, the scoreboard moves on.
+      scoreboard.bitmap = ahead < VlcMacBlockAckHeader::MAX_SUBFRAMES ? scoreboard.bitmap << ahead : 0;
+      scoreboard.bitmap |= 1;
+      scoreboard.lastSeqNum = seqNum;
+      return true;
+    }
+  if (behind >= VlcMacBlockAckHeader::MAX_SUBFRAMES)
+    {
+      // Too old for any window in progress, the originator started over.
+      scoreboard.lastSeqNum = seqNum;
+      scoreboard.bitmap = 1;
+      return true;
+    }
+  bool received = (scoreboard.bitmap & (1u << behind)) != 0;
+  scoreboard.bitmap |= 1u << behind;
+  return !received;
+}
+
+VlcMacBlockAckHeader
+VlcMac::GetBlockAckScoreboard (const Address &originator, uint8_t seqNum) const
+{
+  VlcMacBlockAckHeader blockAck;
+  std::map<Address, BlockAckScoreboard>::const_iterator it = m_blockAckScoreboards.find (originator);
+  if (it != m_blockAckScoreboards.end ())
+    {
+      uint8_t behind = it->second.lastSeqNum - seqNum;
+      if (behind < VlcMacBlockAckHeader::MAX_SUBFRAMES)
+        {
+          blockAck.SetBitmap (it->second.bitmap >> behind);
+        }
+    }
+  return blockAck;
+}
+
+Time
+VlcMac::GetAckAirtime (Ptr<const Packet> ack) const
+{
+  return Seconds (m_phy->aTurnaroundTime_RX_TX / m_phy->GetDataOrSymbolRate (false))
+         + VlcPhy::GetPpduDuration (m_phy->GetMcs (), ack->GetSize (), m_phy->GetDimmingLevel ());
+}
 
+Ptr<Packet>
+VlcMac::CreateAck (uint8_t seqno, bool framePending) const
+{
   // Generate a corresponding ACK Frame.
   VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_ACKNOWLEDGMENT, seqno);
-  VlcMacTrailer macTrailer;
+  if (framePending)
+    {
+      macHdr.SetFrmPend ();
+    }
   Ptr<Packet> ackPacket = Create<Packet> (0);
   ackPacket->AddHeader (macHdr);
+
+  VlcMacTrailer macTrailer;
   // Calculate FCS if the global attribute ChecksumEnable is set.
   if (Node::ChecksumEnabled ())
     {
@@ -717,6 +2808,57 @@ VlcMac::SendAck (uint8_t seqno)
       macTrailer.SetFcs (ackPacket);
     }
   ackPacket->AddTrailer (macTrailer);
+  return ackPacket;
+}
+
+Ptr<Packet>
+VlcMac::CreateBlockAck (uint8_t seqno, const VlcMacBlockAckHeader &blockAck, bool window) const
+{
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_ACKNOWLEDGMENT, seqno);
+  if (window)
+    {
+      macHdr.SetBlockAck ();
+    }
+  else
+    {
+      macHdr.SetAggregation ();
+    }
+  Ptr<Packet> ackPacket = Create<Packet> (0);
+  ackPacket->AddHeader (blockAck);
+  ackPacket->AddHeader (macHdr);
+
+  VlcMacTrailer macTrailer;
+  if (Node::ChecksumEnabled ())
+    {
+      macTrailer.EnableFcs (true);
+      macTrailer.SetFcs (ackPacket);
+    }
+  ackPacket->AddTrailer (macTrailer);
+  return ackPacket;
+}
+
+void
+VlcMac::SendAck (uint8_t seqno, bool framePending)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (seqno) << framePending);
+
+  SendAckPacket (CreateAck (seqno, framePending));
+}
+
+void
+VlcMac::SendBlockAck (uint8_t seqno, const VlcMacBlockAckHeader &blockAck, bool window)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (seqno) << blockAck.GetBitmap () << window);
+
+  SendAckPacket (CreateBlockAck (seqno, blockAck, window));
+}
+
+void
+VlcMac::SendAckPacket (Ptr<Packet> ackPacket)
+{
+  NS_LOG_FUNCTION (this << ackPacket);
+
+  NS_ASSERT (m_vlcMacState == MAC_IDLE);
 
   // Enqueue the ACK packet for further processing
   // when the transmitter is activated.
@@ -728,38 +2870,79 @@ VlcMac::SendAck (uint8_t seqno)
 }
 
 void
-VlcMac::RemoveFirstTxQElement ()
+VlcMac::RemoveTxQElements (void)
 {
-  TxQueueElement *txQElement = m_txQueue.front ();
-  Ptr<const Packet> p = txQElement->txQPkt;
   m_numCsmacaRetry += m_csmaCa->GetNB () + 1;
-
-  Ptr<Packet> pkt = p->Copy ();
-  VlcMacHeader hdr;
-  pkt->RemoveHeader (hdr);
-  if (hdr.GetShortDstAddr () != Mac16Address ("ff:ff"))
+  for (uint32_t i = 0; i < m_txQElements.size (); i++)
     {
-      m_sentPktTrace (p, m_retransmission + 1, m_numCsmacaRetry);
+      FinishTxQElement (m_txQElements[i]);
     }
 
-  txQElement->txQPkt = 0;
-  delete txQElement;
-  m_txQueue.pop_front ();
+  m_txQElements.clear ();
+  m_txPsdu = 0;
   m_txPkt = 0;
+  m_indirectTx.m_packet = 0;
   m_retransmission = 0;
   m_numCsmacaRetry = 0;
+}
+
+void
+VlcMac::FinishTxQElement (const TxQueueElement &txQElement)
+{
+  Ptr<const Packet> p = txQElement.txQPkt;
+
+  VlcMacHeader hdr;
+  p->PeekHeader (hdr);
+  if (hdr.GetShortDstAddr () != Mac16Address ("ff:ff"))
+    {
+      m_sentPktTrace (p, m_retransmission + 1, m_numCsmacaRetry);
+    }
   m_macTxDequeueTrace (p);
 }
 
+void
+VlcMac::ConfirmTxQElements (VlcMcpsDataConfirmStatus status)
+{
+  NS_ASSERT_MSG (!m_txQElements.empty (), "No MSDU in transmission");
+
+  for (uint32_t i = 0; i < m_txQElements.size (); i++)
+    {
+      if (status == IEEE_802_15_7_SUCCESS)
+        {
+          m_macTxOkTrace (m_txQElements[i].txQPkt);
+        }
+      else
+        {
+          m_macTxDropTrace (m_txQElements[i].txQPkt);
+        }
+      VlcMacHeader hdr;
+      m_txQElements[i].txQPkt->PeekHeader (hdr);
+      if (hdr.IsCommand ())
+        {
+          ConfirmCommand (m_txQElements[i].txQPkt, status);
+        }
+      else if (!m_mcpsDataConfirmCallback.IsNull ())
+        {
+          McpsDataConfirmParams confirmParams;
+          confirmParams.m_msduHandle = m_txQElements[i].txQMsduHandle;
+          confirmParams.m_status = status;
+          m_mcpsDataConfirmCallback (confirmParams);
+        }
+    }
+}
+
 void
 VlcMac::AckWaitTimeout (void)
 {
   NS_LOG_FUNCTION (this);
 
-  // TODO: If we are a PAN coordinator and this was an indirect transmission,
-  //       we will not initiate a retransmission. Instead we wait for the data
-  //       being extracted after a new data request command.
-  if (!PrepareRetransmission ())
+  // An indirect transaction is not retransmitted, it waits for the next
+  // data request command of the device.
+  if (RestoreIndirectTransaction ())
+    {
+      SetVlcMacState (MAC_IDLE);
+    }
+  else if (!PrepareRetransmission ())
     {
       SetVlcMacState (MAC_IDLE);
     }
@@ -769,25 +2952,49 @@ VlcMac::AckWaitTimeout (void)
     }
 }
 
+void
+VlcMac::ReportTxResult (bool success)
+{
+  NS_LOG_FUNCTION (this << success);
+
+  if (m_rateControl == 0 || m_txMcs == IEEE_802_15_7_INVALID_MCS)
+    {
+      return;
+    }
+  if (success)
+    {
+      m_rateControl->ReportDataOk (m_txStation, m_txMcs);
+    }
+  else
+    {
+      m_rateControl->ReportDataFailed (m_txStation, m_txMcs);
+      if (m_retransmission >= m_macMaxFrameRetries)
+        {
+          m_rateControl->ReportFinalDataFailed (m_txStation);
+        }
+    }
+  m_txMcs = IEEE_802_15_7_INVALID_MCS;
+}
+
 bool
 VlcMac::PrepareRetransmission (void)
 {
   NS_LOG_FUNCTION (this);
 
+  ReportTxResult (false);
   if (m_retransmission >= m_macMaxFrameRetries)
     {
       // Maximum number of retransmissions has been reached.
       // remove the copy of the packet that was just sent
-      TxQueueElement *txQElement = m_txQueue.front ();
-      m_macTxDropTrace (txQElement->txQPkt);
-      if (!m_mcpsDataConfirmCallback.IsNull ())
+      VlcMacHeader macHdr;
+      m_txPkt->PeekHeader (macHdr);
+      if (macHdr.IsData () && macHdr.IsBlockAck ())
         {
-          McpsDataConfirmParams confirmParams;
-          confirmParams.m_msduHandle = txQElement->txQMsduHandle;
-          confirmParams.m_status = IEEE_802_15_7_NO_ACK;
-          m_mcpsDataConfirmCallback (confirmParams);
+          // No block ACK acknowledges the window.
+          FailBlockAckWindow ();
         }
-      RemoveFirstTxQElement ();
+      ConfirmTxQElements (IEEE_802_15_7_NO_ACK);
+      RemoveTxQElements ();
       return false;
     }
   else
@@ -804,13 +3011,18 @@ VlcMac::PdDataConfirm (VlcPhyEnumeration status)
 {
   NS_ASSERT (m_vlcMacState == MAC_SENDING);
 
-  NS_LOG_FUNCTION (this << status << m_txQueue.size ());
+  NS_LOG_FUNCTION (this << status << m_txQueue->GetNPackets ());
 
   VlcMacHeader macHdr;
   m_txPkt->PeekHeader (macHdr);
   if (status == IEEE_802_15_7_PHY_SUCCESS)
     {
-      if (!macHdr.IsAcknowledgment ())
+      if (macHdr.IsBeacon ())
+        {
+          m_macBeaconTxTrace (m_txPkt);
+          m_txPkt = 0;
+        }
+      else if (!macHdr.IsAcknowledgment ())
         {
           // We have just send a regular data packet, check if we have to wait
           // for an ACK.
@@ -818,27 +3030,23 @@ VlcMac::PdDataConfirm (VlcPhyEnumeration status)
             {
               // wait for the ack or the next retransmission timeout
               // start retransmission timer
-              Time waitTime = MicroSeconds (GetMacAckWaitDuration () * 1000 * 1000 / m_phy->GetDataOrSymbolRate (false));
+              Time waitTime = GetAckWaitTime (macHdr.IsAggregation () || macHdr.IsBlockAck ());
               NS_ASSERT (m_ackWaitTimeout.IsExpired ());
               m_ackWaitTimeout = Simulator::Schedule (waitTime, &VlcMac::AckWaitTimeout, this);
               m_setMacState.Cancel ();
               m_setMacState = Simulator::ScheduleNow (&VlcMac::SetVlcMacState, this, MAC_ACK_PENDING);
               return;
             }
+          else if (macHdr.IsData () && macHdr.IsBlockAck ())
+            {
+              // The frame is acknowledged by the block ACK of its window.
+              AddToBlockAckWindow ();
+            }
           else
             {
-              m_macTxOkTrace (m_txPkt);
               // remove the copy of the packet that was just sent
-              if (!m_mcpsDataConfirmCallback.IsNull ())
-                {
-                  McpsDataConfirmParams confirmParams;
-                  NS_ASSERT_MSG (m_txQueue.size () > 0, "TxQsize = 0");
-                  TxQueueElement *txQElement = m_txQueue.front ();
-                  confirmParams.m_msduHandle = txQElement->txQMsduHandle;
-                  confirmParams.m_status = IEEE_802_15_7_SUCCESS;
-                  m_mcpsDataConfirmCallback (confirmParams);
-                }
-              RemoveFirstTxQElement ();
+              ConfirmTxQElements (IEEE_802_15_7_SUCCESS);
+              RemoveTxQElements ();
             }
         }
       else
@@ -850,19 +3058,15 @@ VlcMac::PdDataConfirm (VlcPhyEnumeration status)
   else if (status == IEEE_802_15_7_PHY_UNSPECIFIED)
     {
 
-      if (!macHdr.IsAcknowledgment ())
+      if (macHdr.IsBeacon ())
         {
-          NS_ASSERT_MSG (m_txQueue.size () > 0, "TxQsize = 0");
-          TxQueueElement *txQElement = m_txQueue.front ();
-          m_macTxDropTrace (txQElement->txQPkt);
-          if (!m_mcpsDataConfirmCallback.IsNull ())
-            {
-              McpsDataConfirmParams confirmParams;
-              confirmParams.m_msduHandle = txQElement->txQMsduHandle;
-              confirmParams.m_status = IEEE_802_15_7_FRAME_TOO_LONG;
-              m_mcpsDataConfirmCallback (confirmParams);
-            }
-          RemoveFirstTxQElement ();
+          NS_LOG_ERROR ("Unable to send beacon");
+          m_txPkt = 0;
+        }
+      else if (!macHdr.IsAcknowledgment ())
+        {
+          ConfirmTxQElements (IEEE_802_15_7_FRAME_TOO_LONG);
+          RemoveTxQElements ();
         }
       else
         {
@@ -912,6 +3116,44 @@ VlcMac::PlmeSetTRXStateConfirm (VlcPhyEnumeration status)
     {
       NS_ASSERT (m_txPkt);
 
+      // Let the rate control select the scheme of acknowledged unicast data.
+      m_txMcs = IEEE_802_15_7_INVALID_MCS;
+      VlcMacHeader macHdr;
+      m_txPkt->PeekHeader (macHdr);
+      if (macHdr.IsBeacon ())
+        {
+          // The superframe starts with its beacon. The next beacon is
+          // prepared one RX-to-TX turnaround early so that it goes on air
+          // exactly one beacon interval later.
+          VlcMcsTag mcsTag (m_phy->GetMcs ());
+          m_txPkt->PeekPacketTag (mcsTag);
+          m_superframeStart = Simulator::Now ();
+          m_beaconDuration = VlcPhy::GetPpduDuration (mcsTag.Get (), m_txPkt->GetSize (), m_phy->GetDimmingLevel ());
+          Time turnaround = Seconds (m_phy->aTurnaroundTime_RX_TX / m_phy->GetDataOrSymbolRate (false));
+          m_beaconEvent = Simulator::Schedule (GetBeaconInterval () - turnaround, &VlcMac::SendBeacon, this);
+        }
+      if (m_rateControl != 0 && macHdr.IsData () && macHdr.IsAckReq ())
+        {
+          if (macHdr.GetDstAddrMode () == SHORT_ADDR && macHdr.GetShortDstAddr () != Mac16Address ("ff:ff"))
+            {
+              m_txStation = macHdr.GetShortDstAddr ();
+            }
+          else if (macHdr.GetDstAddrMode () == EXT_ADDR)
+            {
+              m_txStation = macHdr.GetExtDstAddr ();
+            }
+          else
+            {
+              m_txStation = Address ();
+            }
+          if (!m_txStation.IsInvalid ())
+            {
+              m_txMcs = m_rateControl->GetDataMcs (m_txStation, m_txPkt->GetSize (), m_retransmission);
+              VlcMcsTag mcsTag (m_txMcs);
+              m_txPkt->ReplacePacketTag (mcsTag);
+            }
+        }
+
       // Start sending if we are in state SENDING and the PHY transmitter was enabled.
       m_promiscSnifferTrace (m_txPkt);
       m_snifferTrace (m_txPkt);
@@ -953,13 +3195,12 @@ VlcMac::SetVlcMacState (VlcMacState macState)
 {
   NS_LOG_FUNCTION (this << "mac state = " << macState);
 
-  McpsDataConfirmParams confirmParams;
-
   if (macState == MAC_IDLE)
     {
       ChangeMacState (MAC_IDLE);
 
-      if (m_macRxOnWhenIdle)
+      // A device waiting for its data keeps the receiver on.
+      if (m_macRxOnWhenIdle || m_pollPending)
         {
           m_phy->PlmeSetTRXStateRequest (IEEE_802_15_7_PHY_RX_ON);
         }
@@ -979,6 +3220,22 @@ VlcMac::SetVlcMacState (VlcMacState macState)
     {
       NS_ASSERT (m_vlcMacState == MAC_IDLE || m_vlcMacState == MAC_ACK_PENDING);
 
+      if (m_inGts)
+        {
+          // No contention in the GTS, the frame is sent if it completes
+          // in time and waits for the next GTS otherwise.
+          if (Simulator::Now () + GetTransactionDuration () <= m_gtsEnd)
+            {
+              ChangeMacState (MAC_SENDING);
+              m_phy->PlmeSetTRXStateRequest (IEEE_802_15_7_PHY_TX_ON);
+            }
+          else
+            {
+              ChangeMacState (MAC_IDLE);
+              m_phy->PlmeSetTRXStateRequest (IEEE_802_15_7_PHY_RX_ON);
+            }
+          return;
+        }
       ChangeMacState (MAC_CSMA);
       m_phy->PlmeSetTRXStateRequest (IEEE_802_15_7_PHY_RX_ON);
     }
@@ -994,15 +3251,12 @@ VlcMac::SetVlcMacState (VlcMacState macState)
 
       // cannot find a clear channel, drop the current packet.
       NS_LOG_DEBUG ( this << " cannot find clear channel");
-      confirmParams.m_msduHandle = m_txQueue.front ()->txQMsduHandle;
-      confirmParams.m_status = IEEE_802_15_7_CHANNEL_ACCESS_FAILURE;
-      m_macTxDropTrace (m_txPkt);
-      if (!m_mcpsDataConfirmCallback.IsNull ())
+      if (!RestoreIndirectTransaction ())
         {
-          m_mcpsDataConfirmCallback (confirmParams);
+          ConfirmTxQElements (IEEE_802_15_7_CHANNEL_ACCESS_FAILURE);
+          // remove the copy of the packet that was just sent
+          RemoveTxQElements ();
         }
-      // remove the copy of the packet that was just sent
-      RemoveFirstTxQElement ();
 
       ChangeMacState (MAC_IDLE);
     }
@@ -1045,8 +3299,9 @@ VlcMac::ChangeMacState (VlcMacState newState)
 uint64_t
 VlcMac::GetMacAckWaitDuration (void) const
 {
+  // The ACK frame is 5 octets, preceded by the SHR and the PHR.
   return m_csmaCa->GetUnitBackoffPeriod () + m_phy->aTurnaroundTime_RX_TX + m_phy->GetPhySHRDuration ()
-         + ceil (6 * m_phy->GetPhySymbolsPerOctet ());
+         + m_phy->GetPhyPhrDuration () + ceil (5 * m_phy->GetPhySymbolsPerOctet ());
 }
 
 uint8_t
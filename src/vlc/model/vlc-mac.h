@@ -27,12 +27,22 @@
 #include <ns3/sequence-number.h>
 #include <ns3/vlc-phy.h>
 #include <ns3/event-id.h>
+#include <ns3/vlc-mac-queue.h>
+#include <ns3/vlc-mac-block-ack-header.h>
+#include <ns3/vlc-rate-control.h>
+#include <ns3/vlc-mac-beacon-header.h>
+#include <ns3/vlc-gts-scheduler.h>
+#include <ns3/vlc-pending-transaction-table.h>
+#include <ns3/nstime.h>
+#include <vector>
 #include <deque>
+#include <map>
 
 namespace ns3 {
 
 class Packet;
 class VlcCsmaCa;
+class VlcMacHeader;
 
 // TX-OPTIONS
 typedef enum
@@ -136,11 +146,190 @@ struct McpsDataIndicationParams
   uint8_t m_dsn;          //!< The DSN of the received data frame
 };
 
+/**
+ * The status of the MLME confirm primitives.
+ */
+typedef enum
+{
+  MLME_SUCCESS = 0,                 //!< the request succeeded
+  MLME_DENIED = 1,                  //!< the coordinator denied the request
+  MLME_NO_SHORT_ADDRESS = 2,        //!< the device has no short address
+  MLME_NO_DATA = 3,                 //!< no answer of the coordinator in time
+  MLME_NO_ACK = 4,                  //!< the request has not been acknowledged
+  MLME_CHANNEL_ACCESS_FAILURE = 5,  //!< the request could not be sent
+  MLME_INVALID_PARAMETER = 6,       //!< invalid request parameters
+  MLME_NO_BEACON = 7                //!< the VPAN sends no beacons
+} VlcMlmeStatus;
+
+/**
+ * MLME-START.request parameters.
+ */
+struct MlmeStartRequestParams
+{
+  MlmeStartRequestParams ()
+    : m_vpanId (0),
+      m_beaconOrder (15),
+      m_superframeOrder (15)
+  {
+  }
+  uint16_t m_vpanId;            //!< VPAN identifier
+  uint8_t m_beaconOrder;        //!< Beacon order, 15 without beacons
+  uint8_t m_superframeOrder;    //!< Superframe order, at most the beacon order
+};
+
+/**
+ * MLME-START.confirm parameters.
+ */
+struct MlmeStartConfirmParams
+{
+  VlcMlmeStatus m_status;       //!< The status of the request
+};
+
+/**
+ * MLME-SYNC.request parameters.
+ */
+struct MlmeSyncRequestParams
+{
+  MlmeSyncRequestParams ()
+    : m_trackBeacon (true)
+  {
+  }
+  bool m_trackBeacon;           //!< Keep tracking beacons after the first one
+};
+
+/**
+ * MLME-SYNC-LOSS.indication parameters.
+ */
+struct MlmeSyncLossIndicationParams
+{
+  uint16_t m_vpanId;            //!< The VPAN identifier of the lost coordinator
+};
+
+/**
+ * MLME-GTS.request parameters.
+ */
+struct MlmeGtsRequestParams
+{
+  MlmeGtsRequestParams ()
+    : m_gtsLength (1),
+      m_direction (GTS_TRANSMIT),
+      m_allocation (true)
+  {
+  }
+  uint8_t m_gtsLength;          //!< The number of slots
+  VlcGtsDirection m_direction;  //!< The direction of the GTS
+  bool m_allocation;            //!< true to allocate, false to deallocate
+};
+
+/**
+ * MLME-GTS.confirm parameters.
+ */
+struct MlmeGtsConfirmParams
+{
+  VlcMlmeStatus m_status;       //!< The status of the request
+  uint8_t m_gtsLength;          //!< The number of slots
+  VlcGtsDirection m_direction;  //!< The direction of the GTS
+  bool m_allocation;            //!< true for an allocation
+};
+
+/**
+ * MLME-GTS.indication parameters, at the coordinator.
+ */
+struct MlmeGtsIndicationParams
+{
+  Mac16Address m_devAddress;    //!< The short address of the device
+  uint8_t m_gtsLength;          //!< The number of slots
+  VlcGtsDirection m_direction;  //!< The direction of the GTS
+  bool m_allocation;            //!< true for an allocation
+};
+
+/**
+ * MLME-POLL.request parameters.
+ */
+struct MlmePollRequestParams
+{
+  MlmePollRequestParams ()
+    : m_coordAddrMode (SHORT_ADDR),
+      m_coordVpanId (0)
+  {
+  }
+  VlcAddressMode m_coordAddrMode;  //!< The address mode of the coordinator
+  uint16_t m_coordVpanId;          //!< The VPAN identifier of the coordinator
+  Mac16Address m_coordShortAddr;   //!< The short address of the coordinator
+  Mac64Address m_coordExtAddr;     //!< The extended address of the coordinator
+};
+
+/**
+ * MLME-POLL.confirm parameters.
+ */
+struct MlmePollConfirmParams
+{
+  VlcMlmeStatus m_status;       //!< The status of the request
+};
+
+/**
+ * MLME-BEACON-NOTIFY.indication parameters, for every beacon a device
+ * receives, whatever its VPAN.
+ */
+struct MlmeBeaconNotifyIndicationParams
+{
+  uint16_t m_coordVpanId;          //!< The VPAN identifier of the coordinator
+  Mac16Address m_coordShortAddr;   //!< The short address of the coordinator
+  uint8_t m_linkQuality;           //!< The WQI of the beacon
+  double m_rxPower;                //!< The received power of the beacon in dBm
+};
+
+/**
+ * MLME-HANDOVER.request parameters.
+ */
+struct MlmeHandoverRequestParams
+{
+  MlmeHandoverRequestParams ()
+    : m_vpanId (0),
+      m_makeBeforeBreak (false)
+  {
+  }
+  uint16_t m_vpanId;               //!< The VPAN identifier of the target coordinator
+  Mac16Address m_coordShortAddr;   //!< The short address of the target coordinator
+  bool m_makeBeforeBreak;          //!< Stay with the current coordinator until the first beacon of the target
+};
+
+/**
+ * MLME-HANDOVER.confirm parameters.
+ */
+struct MlmeHandoverConfirmParams
+{
+  VlcMlmeStatus m_status;       //!< The status of the request
+  uint16_t m_vpanId;            //!< The VPAN identifier after the request
+  Time m_interruption;          //!< How long the MAC held its frames for the handover
+};
+
 typedef Callback<void, McpsDataConfirmParams> McpsDataConfirmCallback;
 
+typedef Callback<void, MlmeStartConfirmParams> MlmeStartConfirmCallback;
+
+typedef Callback<void, MlmeSyncLossIndicationParams> MlmeSyncLossIndicationCallback;
+
+typedef Callback<void, MlmeGtsConfirmParams> MlmeGtsConfirmCallback;
+
+typedef Callback<void, MlmeGtsIndicationParams> MlmeGtsIndicationCallback;
+
+typedef Callback<void, MlmePollConfirmParams> MlmePollConfirmCallback;
+
+typedef Callback<void, MlmeBeaconNotifyIndicationParams> MlmeBeaconNotifyIndicationCallback;
+
+typedef Callback<void, MlmeHandoverConfirmParams> MlmeHandoverConfirmCallback;
+
 typedef Callback<void, McpsDataIndicationParams, Ptr<Packet> >
     McpsDataIndicationCallback;
 
+/**
+ * The callback relaying the ACK of a received frame over another link:
+ * the indication parameters of the acknowledged frame and the ACK frame,
+ * including its MAC header and trailer.
+ */
+typedef Callback<void, McpsDataIndicationParams, Ptr<Packet> > AckRelayCallback;
+
 class VlcMac : public Object
 {
 public:
@@ -149,6 +338,22 @@ public:
 
   static const uint32_t aMinMPDUOverhead;
 
+  /**
+   * The number of superframes a GTS denial is announced in the beacons.
+   */
+  static const uint32_t aGtsDescPersistenceTime;
+
+  /**
+   * The number of missed beacons after which a device loses the
+   * synchronization.
+   */
+  static const uint32_t aMaxLostBeacons;
+
+  /**
+   * The minimum length of the contention access period in symbols.
+   */
+  static const uint32_t aMinCapLength;
+
   VlcMac (void);
   virtual ~VlcMac (void);
 
@@ -174,12 +379,167 @@ public:
 
   void SetPhy (Ptr<VlcPhy> phy);
 
+  Ptr<VlcMacQueue> GetTxQueue (void) const;
+
   Ptr<VlcPhy> GetPhy (void);
 
+  /**
+   * Set the link adaptation of acknowledged unicast data frames. Without a
+   * rate control, all frames use the Mcs attribute of the PHY.
+   *
+   * \param rateControl the rate control, may be null
+   */
+  void SetRateControl (Ptr<VlcRateControl> rateControl);
+
+  /**
+   * \return the rate control, null if none is used
+   */
+  Ptr<VlcRateControl> GetRateControl (void) const;
+
   void SetMcpsDataIndicationCallback (McpsDataIndicationCallback c);
 
   void SetMcpsDataConfirmCallback (McpsDataConfirmCallback c);
 
+  /**
+   * Relay the ACKs of the received frames over another link instead of
+   * sending them over the PHY. The reception of a frame then does not
+   * interrupt the transmissions of this MAC.
+   *
+   * \param c the callback, a null callback sends the ACKs over the PHY
+   */
+  void SetAckRelayCallback (AckRelayCallback c);
+
+  /**
+   * Handle an ACK relayed over another link by the receiver of a frame of
+   * this MAC, as if the PHY had received it.
+   *
+   * \param p the ACK frame, including its MAC header and trailer
+   */
+  void ReceiveRelayedAck (Ptr<Packet> p);
+
+  /**
+   * Start a VPAN as its coordinator. With a beacon order below 15 the
+   * coordinator sends a beacon every beacon interval, the MAC uses slotted
+   * CSMA-CA in the contention access period and serves GTS requests.
+   *
+   * \param params the request parameters
+   */
+  void MlmeStartRequest (MlmeStartRequestParams params);
+
+  /**
+   * Synchronize with the beacons of the coordinator of the VPAN. The
+   * superframe structure is learned from the first beacon received.
+   *
+   * \param params the request parameters
+   */
+  void MlmeSyncRequest (MlmeSyncRequestParams params);
+
+  /**
+   * Request the allocation or deallocation of a GTS from the coordinator.
+   * An allocation is confirmed once the GTS appears in a beacon.
+   *
+   * \param params the request parameters
+   */
+  void MlmeGtsRequest (MlmeGtsRequestParams params);
+
+  void SetMlmeStartConfirmCallback (MlmeStartConfirmCallback c);
+
+  void SetMlmeSyncLossIndicationCallback (MlmeSyncLossIndicationCallback c);
+
+  void SetMlmeGtsConfirmCallback (MlmeGtsConfirmCallback c);
+
+  void SetMlmeGtsIndicationCallback (MlmeGtsIndicationCallback c);
+
+  /**
+   * Ask the coordinator for the data it keeps for this device with a data
+   * request command. The receiver stays on while the coordinator announces
+   * pending data in the ACK, until the data frame arrives or the longest
+   * channel access and frame of the coordinator would have ended.
+   *
+   * \param params the request parameters
+   */
+  void MlmePollRequest (MlmePollRequestParams params);
+
+  void SetMlmePollConfirmCallback (MlmePollConfirmCallback c);
+
+  /**
+   * Move the device to the VPAN of another coordinator. The frames in the
+   * transaction queues are kept, their VPAN identifiers and the address of
+   * the current coordinator are rewritten for the target. A transaction in
+   * progress is finished with the current coordinator.
+   *
+   * Break-before-make, the device leaves the current coordinator at once and
+   * holds its frames until the first beacon of the target. Make-before-break,
+   * it stays with the current coordinator until the first beacon of the
+   * target. The handover is confirmed with that beacon.
+   *
+   * \param params the request parameters
+   */
+  void MlmeHandoverRequest (MlmeHandoverRequestParams params);
+
+  void SetMlmeHandoverConfirmCallback (MlmeHandoverConfirmCallback c);
+
+  void SetMlmeBeaconNotifyIndicationCallback (MlmeBeaconNotifyIndicationCallback c);
+
+  /**
+   * \return the transactions the coordinator keeps for indirect
+   * transmission
+   */
+  Ptr<VlcPendingTransactionTable> GetPendingTransactionTable (void) const;
+
+  /**
+   * \return the GTS allocation of the coordinator
+   */
+  Ptr<VlcGtsScheduler> GetGtsScheduler (void) const;
+
+  /**
+   * \return the queue of the MSDUs sent in the GTS of the device
+   */
+  Ptr<VlcMacQueue> GetGtsTxQueue (void) const;
+
+  /**
+   * \return true, if the MAC is the coordinator of a beacon-enabled VPAN
+   * or is synchronized with its beacons
+   */
+  bool IsBeaconEnabled (void) const;
+
+  /**
+   * \return the start of the beacon of the current superframe, extrapolated
+   * from the last beacon
+   */
+  Time GetSuperframeStart (void) const;
+
+  /**
+   * \return the start of the contention access period of the current
+   * superframe, right after its beacon
+   */
+  Time GetCapStart (void) const;
+
+  /**
+   * \return the end of the contention access period of the current
+   * superframe, in the past outside of the contention access period
+   */
+  Time GetCapEnd (void) const;
+
+  /**
+   * \return the start of the contention access period in progress or of
+   * the next one
+   */
+  Time GetNextCapStart (void) const;
+
+  /**
+   * \return the time needed to send the frame in transmission, including
+   * the turnaround and the wait for its ACK
+   */
+  Time GetTransactionDuration (void) const;
+
+  /**
+   * \param p a MAC frame
+   * \return the time needed to send the frame, including the turnaround
+   * and the wait for its ACK
+   */
+  Time GetTransactionDuration (Ptr<const Packet> p) const;
+
   void PdDataIndication (uint32_t psduLength, Ptr<Packet> p, uint8_t wqi);
 
   void PdDataConfirm (VlcPhyEnumeration status);
@@ -243,6 +603,25 @@ public:
   typedef void (* StateTracedCallback)
     (VlcMacState olsState, VlcMacState newState);
 
+  /**
+   * TracedCallback signature for transmitted PSDUs in aggregation mode.
+   *
+   * \param [in] nMsdus the number of MSDUs carried by the PSDU
+   * \param [in] psduSize the size of the PSDU in octets
+   */
+  typedef void (* AggregationTracedCallback)
+    (uint32_t nMsdus, uint32_t psduSize);
+
+  /**
+   * TracedCallback signature for block ACKs closing a window.
+   *
+   * \param [in] nFrames the number of frames in the window
+   * \param [in] airtimeSaved the airtime of the ACKs of the frames, less
+   * the airtime of the block ACK
+   */
+  typedef void (* BlockAckTracedCallback)
+    (uint32_t nFrames, Time airtimeSaved);
+
 protected:
   virtual void DoInitialize (void);
   virtual void DoDispose (void);
@@ -255,9 +634,183 @@ private:
     Ptr<Packet> txQPkt;
   };
 
-  void SendAck (uint8_t seqno);
+  /**
+   * Create an ACK frame.
+   *
+   * \param seqno the sequence number of the acknowledged frame
+   * \param framePending whether the coordinator keeps data for the
+   * originator of a data request command
+   * \return the ACK frame, including its MAC header and trailer
+   */
+  Ptr<Packet> CreateAck (uint8_t seqno, bool framePending) const;
+
+  /**
+   * Create a block ACK frame.
+   *
+   * \param seqno the sequence number of the acknowledged frame
+   * \param blockAck the subframes or frames received
+   * \param window whether it acknowledges a block ACK window rather than
+   * the subframes of an aggregated frame
+   * \return the block ACK frame, including its MAC header and trailer
+   */
+  Ptr<Packet> CreateBlockAck (uint8_t seqno, const VlcMacBlockAckHeader &blockAck, bool window) const;
+
+  /**
+   * Send an ACK.
+   *
+   * \param seqno the sequence number of the acknowledged frame
+   * \param framePending whether the coordinator keeps data for the
+   * originator of a data request command
+   */
+  void SendAck (uint8_t seqno, bool framePending);
+
+  void SendBlockAck (uint8_t seqno, const VlcMacBlockAckHeader &blockAck, bool window);
+
+  void SendAckPacket (Ptr<Packet> ackPacket);
+
+  /**
+   * Finish or retry the frame in transmission on an ACK.
+   *
+   * \param receivedMacHdr the MAC header of the ACK
+   * \param p the ACK without MAC header and trailer
+   */
+  void ReceiveAck (const VlcMacHeader &receivedMacHdr, Ptr<Packet> p);
+
+  void RemoveTxQElements (void);
+
+  void FinishTxQElement (const TxQueueElement &txQElement);
+
+  void ConfirmTxQElements (VlcMcpsDataConfirmStatus status);
+
+  /**
+   * Move further MSDUs from the queue to the MSDUs in transmission, as long
+   * as they go to the same destination and fit into an aggregated frame.
+   */
+  void AggregateTxQElements (void);
+
+  /**
+   * Build the PSDU carrying the MSDUs in transmission: the queued MPDU for
+   * a single MSDU, an aggregated frame otherwise.
+   */
+  void BuildTxPsdu (void);
+
+  /**
+   * Handle a block ACK for the aggregated frame in transmission.
+   *
+   * \param blockAck the block ACK
+   * \return true, if MSDUs are left for retransmission
+   */
+  bool ReceiveBlockAck (const VlcMacBlockAckHeader &blockAck);
+
+  /**
+   * Forward the valid subframes of an aggregated frame up the stack.
+   *
+   * \param params the indication parameters of the aggregated frame
+   * \param p the aggregated frame without MAC header and trailer
+   * \return the block ACK for the frame
+   */
+  VlcMacBlockAckHeader ReceiveAggregate (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * A frame sent in a block ACK window, waiting for the block ACK.
+   */
+  struct BlockAckElement
+  {
+    TxQueueElement element;   //!< the MSDU and its queued MPDU
+    uint8_t seqNum;           //!< the sequence number of the MPDU
+    uint8_t retries;          //!< the retransmissions so far
+  };
+
+  /**
+   * The frames of the block ACK windows received from an originator.
+   */
+  struct BlockAckScoreboard
+  {
+    uint8_t lastSeqNum;   //!< the newest sequence number received
+    uint32_t bitmap;      //!< bit i is set if frame lastSeqNum - i was received
+  };
 
-  void RemoveFirstTxQElement ();
+  /**
+   * \param p a queued MPDU
+   * \return true, if the MPDU may be sent in a block ACK window
+   */
+  bool IsBlockAckEligible (Ptr<const Packet> p) const;
+
+  /**
+   * \param a the MAC header of a frame
+   * \param b the MAC header of another frame
+   * \return true, if both frames go to the same destination
+   */
+  static bool IsSameDestination (const VlcMacHeader &a, const VlcMacHeader &b);
+
+  /**
+   * Whether a frame may follow the frames of the window in progress.
+   *
+   * \param next the queued MPDU of the candidate, 0 if there is none
+   * \param first the queued MPDU of the first frame of the window
+   * \return true, if the candidate may join the window
+   */
+  bool IsBlockAckNext (Ptr<const Packet> next, Ptr<const Packet> first) const;
+
+  /**
+   * Mark the queued MPDU of a frame of a block ACK window.
+   *
+   * \param p the queued MPDU
+   * \param request whether the frame closes the window and requests the
+   * block ACK
+   * \return a copy of the MPDU with the block ACK bit set
+   */
+  Ptr<Packet> CreateBlockAckFrame (Ptr<const Packet> p, bool request) const;
+
+  /**
+   * Move the frame in transmission, sent without ACK request, to the
+   * frames waiting for the block ACK.
+   */
+  void AddToBlockAckWindow (void);
+
+  /**
+   * Handle the block ACK closing the window: confirm the frames received,
+   * schedule the missing ones for retransmission.
+   *
+   * \param seqno the sequence number of the block ACK
+   * \param blockAck the frames received
+   */
+  void ReceiveWindowBlockAck (uint8_t seqno, const VlcMacBlockAckHeader &blockAck);
+
+  /**
+   * Fail the frames waiting for a block ACK that will not come.
+   */
+  void FailBlockAckWindow (void);
+
+  /**
+   * Confirm a frame of a block ACK window to the upper layer.
+   *
+   * \param e the frame
+   * \param status the outcome of its transmission
+   */
+  void FinishBlockAckElement (const BlockAckElement &e, VlcMcpsDataConfirmStatus status);
+
+  /**
+   * Record a frame of a block ACK window in the scoreboard of its originator.
+   *
+   * \param originator the source address of the frame
+   * \param seqNum the sequence number of the frame
+   * \return false, if the frame is a retransmission already received
+   */
+  bool RecordBlockAckFrame (const Address &originator, uint8_t seqNum);
+
+  /**
+   * \param originator the source address of the frames
+   * \param seqNum the sequence number of the frame requesting the block ACK
+   * \return the frames received in the window, relative to seqNum
+   */
+  VlcMacBlockAckHeader GetBlockAckScoreboard (const Address &originator, uint8_t seqNum) const;
+
+  /**
+   * \param ack an ACK frame
+   * \return the turnaround time and the PPDU duration of the ACK
+   */
+  Time GetAckAirtime (Ptr<const Packet> ack) const;
 
   void ChangeMacState (VlcMacState newState);
 
@@ -267,6 +820,198 @@ private:
 
   void CheckQueue (void);
 
+  void TxQueueDrop (Ptr<const Packet> p, uint8_t msduHandle);
+
+  void ConfirmTxQueueDrop (uint8_t msduHandle);
+
+  /**
+   * A transaction put aside for a beacon or a GTS.
+   */
+  struct TxTransaction
+  {
+    std::vector<TxQueueElement> elements;   //!< the MSDUs in transmission
+    Ptr<Packet> psdu;                       //!< the PSDU carrying them
+    uint8_t retransmission;                 //!< the retransmissions so far
+    uint8_t numCsmacaRetry;                 //!< the CSMA-CA attempts so far
+  };
+
+  /**
+   * Put the transaction in progress aside.
+   *
+   * \param transaction the storage of the transaction
+   */
+  void SuspendTransaction (TxTransaction &transaction);
+
+  /**
+   * Continue a transaction put aside.
+   *
+   * \param transaction the storage of the transaction
+   */
+  void ResumeTransaction (TxTransaction &transaction);
+
+  /**
+   * \return true while a frame or its ACK is on the air or a MAC state
+   * change is pending
+   */
+  bool IsBusy (void) const;
+
+  /**
+   * \return the duration of a superframe slot
+   */
+  Time GetSlotDuration (void) const;
+
+  /**
+   * \return the beacon interval
+   */
+  Time GetBeaconInterval (void) const;
+
+  /**
+   * \return the duration of a unit backoff period
+   */
+  Time GetUnitBackoffTime (void) const;
+
+  /**
+   * \param aggregation whether the frame is aggregated
+   * \return the time to wait for the ACK of a frame
+   */
+  Time GetAckWaitTime (bool aggregation) const;
+
+  /**
+   * Send a beacon and schedule the next one.
+   */
+  void SendBeacon (void);
+
+  /**
+   * Handle a beacon of the coordinator.
+   *
+   * \param receivedMacHdr the MAC header of the beacon
+   * \param p the beacon without MAC header and trailer
+   * \param psduLength the size of the beacon PSDU
+   */
+  void ReceiveBeacon (const VlcMacHeader &receivedMacHdr, Ptr<Packet> p, uint32_t psduLength);
+
+  /**
+   * Count a missed beacon, lose the synchronization after aMaxLostBeacons.
+   */
+  void BeaconLost (void);
+
+  /**
+   * \return the time to wait for the first beacon of a coordinator, the
+   * longest beacon interval
+   */
+  Time GetBeaconSearchTime (void) const;
+
+  /**
+   * Leave the current coordinator for the target of the handover in
+   * progress and rewrite the queued frames for it.
+   */
+  void SwitchCoordinator (void);
+
+  /**
+   * Rewrite a queued frame for the target of the handover in progress.
+   *
+   * \param p the MPDU, with its MAC header and trailer
+   */
+  void ReaddressFrame (Ptr<Packet> p);
+
+  /**
+   * Report the outcome of the handover in progress.
+   *
+   * \param status the status of the handover
+   */
+  void ConfirmHandover (VlcMlmeStatus status);
+
+  /**
+   * Give up a handover whose target sent no beacon in time.
+   */
+  void HandoverTimeout (void);
+
+  /**
+   * Handle a MAC command frame.
+   *
+   * \param params the indication parameters of the frame
+   * \param p the frame without MAC header and trailer
+   */
+  void ReceiveCommand (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Finish a command frame sent by this MAC.
+   *
+   * \param p the command frame
+   * \param status the outcome of the transmission
+   */
+  void ConfirmCommand (Ptr<const Packet> p, VlcMcpsDataConfirmStatus status);
+
+  /**
+   * Report the outcome of the pending GTS request.
+   *
+   * \param status the status of the request
+   */
+  void ConfirmGtsRequest (VlcMlmeStatus status);
+
+  /**
+   * Send a data request command to the coordinator.
+   *
+   * \param params the coordinator
+   */
+  void SendDataRequest (const MlmePollRequestParams &params);
+
+  /**
+   * Handle a data request command at the coordinator: the oldest pending
+   * transaction of the device is sent next.
+   *
+   * \param params the indication parameters of the command
+   */
+  void ReceiveDataRequest (const McpsDataIndicationParams &params);
+
+  /**
+   * Check whether the coordinator keeps data for the originator of a frame.
+   *
+   * \param params the indication parameters of the frame
+   * \return true, if a transaction is pending for the originator
+   */
+  bool IsPendingFor (const McpsDataIndicationParams &params) const;
+
+  /**
+   * Report the outcome of the pending poll.
+   *
+   * \param status the status of the poll
+   */
+  void ConfirmPoll (VlcMlmeStatus status);
+
+  /**
+   * Report an expired indirect transaction.
+   *
+   * \param p the MPDU
+   * \param msduHandle the MSDU handle of the request
+   */
+  void PendingTransactionExpired (Ptr<const Packet> p, uint8_t msduHandle);
+
+  /**
+   * Put the indirect transaction in transmission back into the pending
+   * transactions, instead of retransmitting it.
+   *
+   * \return true, if the frame in transmission is an indirect transaction
+   */
+  bool RestoreIndirectTransaction (void);
+
+  /**
+   * \return the longest time the coordinator may take to send a frame
+   * after a data request command: its longest channel access, the
+   * turnaround and the largest frame.
+   */
+  Time GetMaxFrameTotalWaitTime (void) const;
+
+  /**
+   * Start the transmit GTS of the device.
+   */
+  void StartGts (void);
+
+  /**
+   * End the transmit GTS of the device.
+   */
+  void EndGts (void);
+
   TracedCallback<Ptr<const Packet>, uint8_t, uint8_t > m_sentPktTrace;
 
   TracedCallback<Ptr<const Packet> > m_macTxEnqueueTrace;
@@ -291,6 +1036,14 @@ private:
 
   TracedCallback<VlcMacState, VlcMacState> m_macStateLogger;
 
+  TracedCallback<uint32_t, uint32_t> m_aggregationTrace;
+
+  TracedCallback<uint32_t, Time> m_blockAckTrace;
+
+  TracedCallback<Ptr<const Packet> > m_macBeaconTxTrace;
+
+  TracedCallback<Ptr<const Packet> > m_macBeaconRxTrace;
+
   Ptr<VlcPhy> m_phy;
 
   Ptr<VlcCsmaCa> m_csmaCa;
@@ -299,6 +1052,27 @@ private:
 
   McpsDataConfirmCallback m_mcpsDataConfirmCallback;
 
+  MlmeStartConfirmCallback m_mlmeStartConfirmCallback;
+
+  MlmeSyncLossIndicationCallback m_mlmeSyncLossIndicationCallback;
+
+  MlmeGtsConfirmCallback m_mlmeGtsConfirmCallback;
+
+  MlmeGtsIndicationCallback m_mlmeGtsIndicationCallback;
+
+  MlmePollConfirmCallback m_mlmePollConfirmCallback;
+
+  MlmeHandoverConfirmCallback m_mlmeHandoverConfirmCallback;
+
+  MlmeBeaconNotifyIndicationCallback m_mlmeBeaconNotifyIndicationCallback;
+
+  AckRelayCallback m_ackRelayCallback;
+
+  /**
+   * The additional time to wait for an ACK relayed over another link.
+   */
+  Time m_ackRelayDelay;
+
   TracedValue<VlcMacState> m_vlcMacState;
 
   VlcAssociationStatus m_associationStatus;
@@ -309,12 +1083,231 @@ private:
 
   Mac64Address m_selfExt;
 
-  std::deque<TxQueueElement*> m_txQueue;
+  Ptr<VlcMacQueue> m_txQueue;
+
+  /**
+   * The MSDUs in transmission, more than one in an aggregated frame.
+   */
+  std::vector<TxQueueElement> m_txQElements;
+
+  /**
+   * The PSDU carrying the MSDUs in transmission.
+   */
+  Ptr<Packet> m_txPsdu;
+
+  bool m_aggregation;
+
+  uint32_t m_maxAggregateSize;
+
+  uint32_t m_maxSubframes;
+
+  bool m_blockAck;
+
+  uint32_t m_blockAckWindow;
+
+  /**
+   * The frames sent in the block ACK window in progress, oldest first.
+   */
+  std::vector<BlockAckElement> m_blockAckPending;
+
+  /**
+   * The frames missing from the last block ACK, sent before the queue.
+   */
+  std::deque<BlockAckElement> m_blockAckRetry;
+
+  /**
+   * The retransmissions of the frame in transmission in earlier windows.
+   */
+  uint8_t m_txBlockAckRetries;
+
+  /**
+   * The frames received in block ACK windows, per originator.
+   */
+  std::map<Address, BlockAckScoreboard> m_blockAckScoreboards;
 
   uint8_t m_retransmission;
 
   uint8_t m_numCsmacaRetry;
 
+  /**
+   * Report the outcome of the transmission attempt of m_txPkt to the rate
+   * control, if it selected its scheme.
+   *
+   * \param success whether the attempt has been acknowledged
+   */
+  void ReportTxResult (bool success);
+
+  Ptr<VlcRateControl> m_rateControl;
+
+  /**
+   * The scheme selected by the rate control for the attempt in progress,
+   * IEEE_802_15_7_INVALID_MCS if none.
+   */
+  VlcPhyMcs m_txMcs;
+
+  /**
+   * The destination of the attempt in progress.
+   */
+  Address m_txStation;
+
+  /**
+   * The queue of the MSDUs sent in the GTS of the device.
+   */
+  Ptr<VlcMacQueue> m_gtsQueue;
+
+  /**
+   * The GTS allocation of the coordinator.
+   */
+  Ptr<VlcGtsScheduler> m_gtsScheduler;
+
+  /**
+   * GTS denials announced in the beacons, with the remaining number of
+   * beacons.
+   */
+  std::vector<std::pair<VlcGtsDescriptor, uint32_t> > m_gtsDenials;
+
+  bool m_vpanCoordinator;
+
+  bool m_beaconTracking;
+
+  SequenceNumber8 m_macBsn;
+
+  uint8_t m_finalCapSlot;
+
+  Time m_superframeStart;
+
+  Time m_beaconDuration;
+
+  uint32_t m_lostBeacons;
+
+  Mac16Address m_coordShortAddress;
+
+  /**
+   * The transmit GTS of the device, valid if m_gts.m_length is not 0.
+   */
+  VlcGtsDescriptor m_gts;
+
+  bool m_inGts;
+
+  Time m_gtsEnd;
+
+  MlmeGtsRequestParams m_gtsRequest;
+
+  bool m_gtsRequestPending;
+
+  /**
+   * The beacons received since the GTS request has been acknowledged, -1
+   * before.
+   */
+  int32_t m_gtsRequestBeacons;
+
+  /**
+   * The CAP transaction put aside during a beacon or a GTS.
+   */
+  TxTransaction m_capTransaction;
+
+  /**
+   * The GTS transaction left at the end of the GTS.
+   */
+  TxTransaction m_gtsTransaction;
+
+  /**
+   * The transactions kept by the coordinator for indirect transmission.
+   */
+  Ptr<VlcPendingTransactionTable> m_pendingTable;
+
+  /**
+   * Indirect transactions extracted by data request commands, sent before
+   * the transaction queue.
+   */
+  std::vector<VlcPendingTransaction> m_extracted;
+
+  /**
+   * The indirect transaction in transmission, without packet if none.
+   */
+  VlcPendingTransaction m_indirectTx;
+
+  /**
+   * The time persistence of indirect transactions, in unit periods: beacon
+   * intervals, or base superframe durations without beacons.
+   */
+  uint16_t m_transactionPersistenceTime;
+
+  /**
+   * Send a data request command when a beacon announces pending data.
+   */
+  bool m_autoRequest;
+
+  /**
+   * Whether a data request command is in progress.
+   */
+  bool m_pollPending;
+
+  /**
+   * Whether the poll has been requested by the next higher layer.
+   */
+  bool m_pollConfirm;
+
+  /**
+   * The coordinator polled by the data request in progress.
+   */
+  MlmePollRequestParams m_pollRequest;
+
+  /**
+   * The frame pending bit of the last ACK received.
+   */
+  bool m_ackFramePending;
+
+  /**
+   * The handover in progress.
+   */
+  MlmeHandoverRequestParams m_handoverRequest;
+
+  /**
+   * Whether a handover is in progress.
+   */
+  bool m_handoverPending;
+
+  /**
+   * Whether the device left its coordinator and holds its frames until the
+   * first beacon of the next one.
+   */
+  bool m_awaitingBeacon;
+
+  /**
+   * Whether the MAC holds its frames: it awaits the first beacon of the
+   * next coordinator, and the transaction in progress at the handover is
+   * over.
+   */
+  bool m_holdingFrames;
+
+  /**
+   * The time the MAC started to hold its frames.
+   */
+  Time m_holdStart;
+
+  /**
+   * The VPAN identifier before the handover in progress.
+   */
+  uint16_t m_prevVpanId;
+
+  /**
+   * The short address of the coordinator before the handover in progress.
+   */
+  Mac16Address m_prevCoordShortAddress;
+
+  EventId m_pollTimeout;
+
+  EventId m_handoverTimeout;
+
+  EventId m_beaconEvent;
+
+  EventId m_beaconTrackingEvent;
+
+  EventId m_gtsStartEvent;
+
+  EventId m_gtsEndEvent;
+
   EventId m_ackWaitTimeout;
 
   EventId m_setMacState;
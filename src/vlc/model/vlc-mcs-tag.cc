@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:
+ *  Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-mcs-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (VlcMcsTag);
+
+TypeId
+VlcMcsTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMcsTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMcsTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+VlcMcsTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+VlcMcsTag::VlcMcsTag (void)
+  : m_mcs (IEEE_802_15_7_PHY_II_OOK_6_MBPS)
+{
+}
+
+VlcMcsTag::VlcMcsTag (VlcPhyMcs mcs)
+  : m_mcs (mcs)
+{
+}
+
+uint32_t
+VlcMcsTag::GetSerializedSize (void) const
+{
+  return sizeof (uint8_t);
+}
+
+void
+VlcMcsTag::Serialize (TagBuffer i) const
+{
+  i.WriteU8 (m_mcs);
+}
+
+void
+VlcMcsTag::Deserialize (TagBuffer i)
+{
+  m_mcs = static_cast<VlcPhyMcs> (i.ReadU8 ());
+}
+
+void
+VlcMcsTag::Print (std::ostream &os) const
+{
+  os << "mcs = " << static_cast<uint32_t> (m_mcs);
+}
+
+void
+VlcMcsTag::Set (VlcPhyMcs mcs)
+{
+  m_mcs = mcs;
+}
+
+VlcPhyMcs
+VlcMcsTag::Get (void) const
+{
+  return m_mcs;
+}
+}
@@ -0,0 +1,86 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:
+ *  Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_MCS_TAG_H
+#define VLC_MCS_TAG_H
+
+#include "vlc-phy.h"
+#include <ns3/tag.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * The modulation and coding scheme of a frame, as signalled by the MCS ID
+ * field of the PHR. A MAC adds the tag to select the scheme of a single
+ * frame, otherwise the PHY adds the tag with its configured scheme before
+ * transmission. The receiving PHY reads it to decode the frame.
+ */
+class VlcMcsTag : public Tag
+{
+public:
+ /**
+  * Get the type ID.
+  *
+  * \return the object TypeId
+  */
+ static TypeId GetTypeId (void);
+
+ virtual TypeId GetInstanceTypeId (void) const;
+
+ /**
+  * Create a VlcMcsTag with the default MCS of VlcPhy.
+  */
+ VlcMcsTag (void);
+
+ /**
+  * Create a VlcMcsTag with the given MCS.
+  *
+  * \param mcs the modulation and coding scheme
+  */
+ VlcMcsTag (VlcPhyMcs mcs);
+
+ virtual uint32_t GetSerializedSize (void) const;
+ virtual void Serialize (TagBuffer i) const;
+ virtual void Deserialize (TagBuffer i);
+ virtual void Print (std::ostream &os) const;
+
+ /**
+  * Set the modulation and coding scheme.
+  *
+  * \param mcs the modulation and coding scheme
+  */
+ void Set (VlcPhyMcs mcs);
+
+ /**
+  * Get the modulation and coding scheme.
+  *
+  * \return the modulation and coding scheme
+  */
+ VlcPhyMcs Get (void) const;
+private:
+ /**
+  * The modulation and coding scheme of the tag.
+  */
+ VlcPhyMcs m_mcs;
+};
+
+
+}
+#endif /* VLC_MCS_TAG_H */
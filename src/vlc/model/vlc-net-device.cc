@@ -26,8 +26,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/pointer.h>
 #include <ns3/boolean.h>
+#include <ns3/uinteger.h>
 #include <ns3/mobility-model.h>
 #include <ns3/packet.h>
+#include <ns3/llc-snap-header.h>
 
 
 namespace ns3 {
@@ -61,12 +63,26 @@ VlcNetDevice::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&VlcNetDevice::m_useAcks),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseLlcSnap",
+                   "Carry the protocol number of every packet in an LLC/SNAP header. "
+                   "Without it, packets are delivered with protocol number 0.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&VlcNetDevice::m_useLlcSnap),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Mtu", "The MAC-level MTU, zero for the largest MSDU.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&VlcNetDevice::SetMtu,
+                                         &VlcNetDevice::GetMtu),
+                   MakeUintegerChecker<uint16_t> ())
   ;
   return tid;
 }
 
 VlcNetDevice::VlcNetDevice ()
-  : m_configComplete (false)
+  : m_configComplete (false),
+    m_useLlcSnap (false),
+    m_mtu (0),
+    m_linkUp (false)
 {
   NS_LOG_FUNCTION (this);
   m_mac = CreateObject<VlcMac> ();
@@ -145,6 +161,7 @@ VlcNetDevice::CompleteConfig (void)
   m_csmaca->SetVlcMacStateCallback (MakeCallback (&VlcMac::SetVlcMacState, m_mac));
   m_phy->SetPlmeCcaConfirmCallback (MakeCallback (&VlcCsmaCa::PlmeCcaConfirm, m_csmaca));
   m_configComplete = true;
+  LinkUp ();
 }
 
 void
@@ -261,19 +278,44 @@ VlcNetDevice::GetAddress (void) const
 bool
 VlcNetDevice::SetMtu (const uint16_t mtu)
 {
-  NS_ABORT_MSG ("Unsupported");
-  return false;
+  NS_LOG_FUNCTION (this << mtu);
+  uint16_t oldMtu = m_mtu;
+  m_mtu = 0;
+  if (mtu > GetMtu ())
+    {
+      NS_LOG_ERROR ("MTU " << mtu << " larger than the largest MSDU " << GetMtu ());
+      m_mtu = oldMtu;
+      return false;
+    }
+  m_mtu = mtu;
+  return true;
 }
 
 uint16_t
 VlcNetDevice::GetMtu (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_mtu != 0)
+    {
+      return m_mtu;
+    }
   // Maximum payload size is: max psdu - frame control - seqno - addressing - security - fcs
-  //                        = 127      - 2             - 1     - (2+2+2+2)  - 0        - 2
-  //                        = 114
-  // assuming no security and addressing with only 16 bit addresses without pan id compression.
-  return 114;
+  //                        = max psdu - 2             - 1     - (2+2+2+2)  - 0        - 2
+  //                        = max psdu - 13
+  // assuming no security and addressing with only 16 bit addresses without pan id compression,
+  // i.e. 187 with the default MaxPsduSize of 200. A PSDU too short for the overhead leaves no
+  // payload.
+  uint32_t overhead = 13;
+  if (m_useLlcSnap)
+    {
+      overhead += LlcSnapHeader ().GetSerializedSize ();
+    }
+  uint32_t maxPsduSize = m_phy->GetMaxPsduSize ();
+  if (maxPsduSize <= overhead)
+    {
+      return 0;
+    }
+  return maxPsduSize - overhead;
 }
 
 bool
@@ -368,11 +410,9 @@ VlcNetDevice::IsPointToPoint (void) const
 bool
 VlcNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
 {
-  // This method basically assumes an 802.3-compliant device, but a raw
-  // 802.15.4 device does not have an ethertype, and requires specific
-  // McpsDataRequest parameters.
-  // For further study:  how to support these methods somehow, such as
-  // inventing a fake ethertype and packet tag for McpsDataRequest
+  // A raw 802.15.7 frame does not have an ethertype. Unless the LLC/SNAP
+  // header is used, the protocol number is lost and the receiver relies on
+  // the payload to identify it, like 6LoWPAN does with its dispatch octet.
   NS_LOG_FUNCTION (this << packet << dest << protocolNumber);
 
   if (packet->GetSize () > GetMtu ())
@@ -381,6 +421,13 @@ VlcNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNu
       return false;
     }
 
+  if (m_useLlcSnap)
+    {
+      LlcSnapHeader llc;
+      llc.SetType (protocolNumber);
+      packet->AddHeader (llc);
+    }
+
   McpsDataRequestParams m_mcpsDataRequestParams;
   m_mcpsDataRequestParams.m_dstAddr = Mac16Address::ConvertFrom (dest);
   m_mcpsDataRequestParams.m_dstAddrMode = SHORT_ADDR;
@@ -400,9 +447,14 @@ VlcNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNu
 bool
 VlcNetDevice::SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber)
 {
-  NS_ABORT_MSG ("Unsupported");
-  // TODO: To support SendFrom, the MACs McpsDataRequest has to use the provided source address, instead of to local one.
-  return false;
+  NS_LOG_FUNCTION (this << packet << source << dest << protocolNumber);
+  // The MCPS-DATA.request has no source address, the MAC always uses its own.
+  if (source != GetAddress ())
+    {
+      NS_LOG_ERROR ("Can not send from " << source << ", drop the packet");
+      return false;
+    }
+  return Send (packet, dest, protocolNumber);
 }
 
 Ptr<Node>
@@ -449,14 +501,31 @@ void
 VlcNetDevice::McpsDataIndication (McpsDataIndicationParams params, Ptr<Packet> pkt)
 {
   NS_LOG_FUNCTION (this);
+  uint16_t protocol = 0;
+  if (m_useLlcSnap)
+    {
+      LlcSnapHeader llc;
+      if (pkt->GetSize () < llc.GetSerializedSize ())
+        {
+          NS_LOG_ERROR ("Frame without an LLC/SNAP header, drop the packet");
+          return;
+        }
+      pkt->RemoveHeader (llc);
+      protocol = llc.GetType ();
+    }
   // TODO: Use the PromiscReceiveCallback if the MAC is in promiscuous mode.
-  m_receiveCallback (this, pkt, 0, params.m_srcAddr);
+  if (!m_receiveCallback.IsNull ())
+    {
+      m_receiveCallback (this, pkt, protocol, params.m_srcAddr);
+    }
 }
 
 bool
 VlcNetDevice::SupportsSendFrom (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
+  // SendFrom only accepts the address of this device, so bridging is not
+  // possible.
   return false;
 }
 
@@ -467,6 +536,10 @@ VlcNetDevice::AssignStreams (int64_t stream)
   int64_t streamIndex = stream;
   streamIndex += m_csmaca->AssignStreams (stream);
   streamIndex += m_phy->AssignStreams (stream);
+  if (m_mac->GetRateControl () != 0)
+    {
+      streamIndex += m_mac->GetRateControl ()->AssignStreams (streamIndex);
+    }
   NS_LOG_DEBUG ("Number of assigned RV streams:  " << (streamIndex - stream));
   return (streamIndex - stream);
 }
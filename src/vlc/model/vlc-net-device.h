@@ -114,7 +114,20 @@ public:
    * \returns The short address.
    */
   virtual Address GetAddress (void) const;
+  /**
+   * Limit the MTU below the largest MSDU the MAC and PHY can carry.
+   *
+   * \param mtu the MTU, zero to use the largest MSDU
+   * \returns false if the MTU is larger than the largest MSDU
+   */
   virtual bool SetMtu (const uint16_t mtu);
+  /**
+   * The MTU is the largest MSDU of a data frame with short addresses and
+   * without security, less the LLC/SNAP header if the protocol numbers are
+   * carried, unless a smaller MTU was set.
+   *
+   * \returns the MTU
+   */
   virtual uint16_t GetMtu (void) const;
   virtual bool IsLinkUp (void) const;
   virtual void AddLinkChangeCallback (Callback<void> callback);
@@ -126,6 +139,16 @@ public:
   virtual bool IsBridge (void) const;
   virtual bool IsPointToPoint (void) const;
   virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+  /**
+   * The MAC always sends with its own short address, so only packets from
+   * that address are accepted.
+   *
+   * \param packet the packet
+   * \param source the source address, the short address of this device
+   * \param dest the destination address
+   * \param protocolNumber the protocol number
+   * \returns false if the packet is too large or the source address differs
+   */
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
@@ -213,6 +236,18 @@ private:
    */
   bool m_useAcks;
 
+  /**
+   * Carry the protocol number of every packet in an LLC/SNAP header, so that
+   * several protocols can share the link. Otherwise, packets are delivered
+   * with protocol number 0, which is enough for 6LoWPAN.
+   */
+  bool m_useLlcSnap;
+
+  /**
+   * The MTU set by the upper layers, zero for the largest MSDU.
+   */
+  uint16_t m_mtu;
+
   /**
    * Is the link/device currently up and running?
    */
@@ -0,0 +1,393 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-pending-transaction-table.h"
+#include "vlc-mac-header.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcPendingTransactionTable");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcPendingTransactionTable);
+
+namespace {
+
+/**
+ * Remove the oldest transaction of a destination.
+ *
+ * \param queues the transactions per destination
+ * \param address the destination
+ * \param [out] transaction the transaction
+ * \return true, if a transaction was pending for the destination
+ */
+template <class Queues, class Address>
+bool
+PopFront (Queues &queues, const Address &address, VlcPendingTransaction &transaction)
+{
+  typename Queues::iterator it = queues.find (address);
+  if (it == queues.end ())
+    {
+      return false;
+    }
+  transaction = it->second.front ().transaction;
+  it->second.pop_front ();
+  if (it->second.empty ())
+    {
+      queues.erase (it);
+    }
+  return true;
+}
+
+/**
+ * Move the expired transactions of all destinations to a list.
+ *
+ * \param queues the transactions per destination
+ * \param now the current time
+ * \param [out] expired the expired transactions
+ */
+template <class Queues, class Entries>
+void
+RemoveExpired (Queues &queues, Time now, Entries &expired)
+{
+  typename Queues::iterator it = queues.begin ();
+  while (it != queues.end ())
+    {
+      typename Queues::mapped_type &queue = it->second;
+      typename Queues::mapped_type::iterator entry = queue.begin ();
+      while (entry != queue.end ())
+        {
+          if (entry->transaction.m_expiry <= now)
+            {
+              expired.push_back (*entry);
+              entry = queue.erase (entry);
+            }
+          else
+            {
+              ++entry;
+            }
+        }
+      if (queue.empty ())
+        {
+          queues.erase (it++);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+/**
+ * Get the earliest expiry of the transactions of all destinations.
+ *
+ * \param queues the transactions per destination
+ * \param [in,out] expiry the earliest expiry so far
+ */
+template <class Queues>
+void
+GetFirstExpiry (const Queues &queues, Time &expiry)
+{
+  for (typename Queues::const_iterator it = queues.begin (); it != queues.end (); ++it)
+    {
+      for (typename Queues::mapped_type::const_iterator entry = it->second.begin ();
+           entry != it->second.end (); ++entry)
+        {
+          expiry = std::min (expiry, entry->transaction.m_expiry);
+        }
+    }
+}
+
+/**
+ * Order entries by arrival.
+ *
+ * \param a an entry
+ * \param b another entry
+ * \return true, if a arrived before b
+ */
+template <class Entry>
+bool
+ArrivedBefore (const Entry &a, const Entry &b)
+{
+  return a.sequence < b.sequence;
+}
+
+} // anonymous namespace
+
+TypeId
+VlcPendingTransactionTable::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcPendingTransactionTable")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcPendingTransactionTable> ()
+    .AddAttribute ("MaxTransactions",
+                   "The maximum number of pending transactions, for all "
+                   "devices together.",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&VlcPendingTransactionTable::m_maxTransactions),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+VlcPendingTransactionTable::VlcPendingTransactionTable (void)
+  : m_nTransactions (0),
+    m_nextSequence (0),
+    m_restoredSequence (0),
+    m_maxTransactions (16)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcPendingTransactionTable::~VlcPendingTransactionTable (void)
+{
+}
+
+void
+VlcPendingTransactionTable::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_expireCallback = MakeNullCallback<void, Ptr<const Packet>, uint8_t> ();
+  Object::DoDispose ();
+}
+
+bool
+VlcPendingTransactionTable::Add (const Entry &entry, bool front)
+{
+  VlcMacHeader macHdr;
+  entry.transaction.m_packet->PeekHeader (macHdr);
+  Queue *queue;
+  if (macHdr.GetDstAddrMode () == VlcMacHeader::SHORTADDR)
+    {
+      queue = &m_shortQueues[macHdr.GetShortDstAddr ()];
+    }
+  else if (macHdr.GetDstAddrMode () == VlcMacHeader::EXTADDR)
+    {
+      queue = &m_extQueues[macHdr.GetExtDstAddr ()];
+    }
+  else
+    {
+      return false;
+    }
+  if (front)
+    {
+      queue->push_front (entry);
+    }
+  else
+    {
+      queue->push_back (entry);
+    }
+  m_nTransactions++;
+  if (!m_expireEvent.IsRunning ()
+      || entry.transaction.m_expiry < Simulator::Now () + Simulator::GetDelayLeft (m_expireEvent))
+    {
+      ScheduleExpiry ();
+    }
+  return true;
+}
+
+bool
+VlcPendingTransactionTable::Enqueue (Ptr<Packet> packet, uint8_t msduHandle, Time persistence)
+{
+  NS_LOG_FUNCTION (this << packet << static_cast<uint32_t> (msduHandle) << persistence);
+
+  if (m_nTransactions >= m_maxTransactions)
+    {
+      NS_LOG_DEBUG ("Table full, transaction rejected");
+      return false;
+    }
+  Entry entry;
+  entry.transaction.m_packet = packet;
+  entry.transaction.m_msduHandle = msduHandle;
+  entry.transaction.m_expiry = Simulator::Now () + persistence;
+  entry.sequence = m_nextSequence;
+  if (!Add (entry, false))
+    {
+      NS_LOG_DEBUG ("Transaction without destination address rejected");
+      return false;
+    }
+  m_nextSequence++;
+  return true;
+}
+
+bool
+VlcPendingTransactionTable::Restore (const VlcPendingTransaction &transaction)
+{
+  NS_LOG_FUNCTION (this << transaction.m_packet);
+
+  if (m_nTransactions >= m_maxTransactions || transaction.m_expiry <= Simulator::Now ())
+    {
+      return false;
+    }
+  // The destination of a restored transaction is announced first.
+  Entry entry;
+  entry.transaction = transaction;
+  entry.sequence = m_restoredSequence - 1;
+  if (!Add (entry, true))
+    {
+      return false;
+    }
+  m_restoredSequence--;
+  return true;
+}
+
+bool
+VlcPendingTransactionTable::Extract (Mac16Address address, VlcPendingTransaction &transaction)
+{
+  NS_LOG_FUNCTION (this << address);
+
+  if (!PopFront (m_shortQueues, address, transaction))
+    {
+      return false;
+    }
+  m_nTransactions--;
+  return true;
+}
+
+bool
+VlcPendingTransactionTable::Extract (Mac64Address address, VlcPendingTransaction &transaction)
+{
+  NS_LOG_FUNCTION (this << address);
+
+  if (!PopFront (m_extQueues, address, transaction))
+    {
+      return false;
+    }
+  m_nTransactions--;
+  return true;
+}
+
+bool
+VlcPendingTransactionTable::IsPending (Mac16Address address) const
+{
+  return m_shortQueues.find (address) != m_shortQueues.end ();
+}
+
+bool
+VlcPendingTransactionTable::IsPending (Mac64Address address) const
+{
+  return m_extQueues.find (address) != m_extQueues.end ();
+}
+
+void
+VlcPendingTransactionTable::GetPendingAddresses (uint32_t maxAddresses,
+                                                 std::vector<Mac16Address> &shortAddresses,
+                                                 std::vector<Mac64Address> &extAddresses) const
+{
+  shortAddresses.clear ();
+  extAddresses.clear ();
+
+  // Order the destinations by the arrival of their oldest transaction.
+  std::map<int64_t, Mac16Address> shortOldest;
+  for (std::map<Mac16Address, Queue>::const_iterator it = m_shortQueues.begin (); it != m_shortQueues.end (); ++it)
+    {
+      shortOldest[it->second.front ().sequence] = it->first;
+    }
+  std::map<int64_t, Mac64Address> extOldest;
+  for (std::map<Mac64Address, Queue>::const_iterator it = m_extQueues.begin (); it != m_extQueues.end (); ++it)
+    {
+      extOldest[it->second.front ().sequence] = it->first;
+    }
+
+  std::map<int64_t, Mac16Address>::const_iterator shortIt = shortOldest.begin ();
+  std::map<int64_t, Mac64Address>::const_iterator extIt = extOldest.begin ();
+  while ((shortIt != shortOldest.end () || extIt != extOldest.end ())
+         && shortAddresses.size () + extAddresses.size () < maxAddresses)
+    {
+      if (extIt == extOldest.end () || (shortIt != shortOldest.end () && shortIt->first < extIt->first))
+        {
+          shortAddresses.push_back (shortIt->second);
+          ++shortIt;
+        }
+      else
+        {
+          extAddresses.push_back (extIt->second);
+          ++extIt;
+        }
+    }
+}
+
+void
+VlcPendingTransactionTable::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_shortQueues.clear ();
+  m_extQueues.clear ();
+  m_nTransactions = 0;
+  m_expireEvent.Cancel ();
+}
+
+uint32_t
+VlcPendingTransactionTable::GetNTransactions (void) const
+{
+  return m_nTransactions;
+}
+
+bool
+VlcPendingTransactionTable::IsEmpty (void) const
+{
+  return m_nTransactions == 0;
+}
+
+void
+VlcPendingTransactionTable::SetExpireCallback (ExpireCallback c)
+{
+  m_expireCallback = c;
+}
+
+void
+VlcPendingTransactionTable::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<Entry> expired;
+  RemoveExpired (m_shortQueues, Simulator::Now (), expired);
+  RemoveExpired (m_extQueues, Simulator::Now (), expired);
+  m_nTransactions -= expired.size ();
+  std::sort (expired.begin (), expired.end (), ArrivedBefore<Entry>);
+  for (std::vector<Entry>::const_iterator it = expired.begin (); it != expired.end (); ++it)
+    {
+      NS_LOG_DEBUG ("Transaction " << static_cast<uint32_t> (it->transaction.m_msduHandle) << " expired");
+      if (!m_expireCallback.IsNull ())
+        {
+          m_expireCallback (it->transaction.m_packet, it->transaction.m_msduHandle);
+        }
+    }
+  ScheduleExpiry ();
+}
+
+void
+VlcPendingTransactionTable::ScheduleExpiry (void)
+{
+  m_expireEvent.Cancel ();
+  if (m_nTransactions == 0)
+    {
+      return;
+    }
+  Time expiry = Time::Max ();
+  GetFirstExpiry (m_shortQueues, expiry);
+  GetFirstExpiry (m_extQueues, expiry);
+  m_expireEvent = Simulator::Schedule (expiry - Simulator::Now (), &VlcPendingTransactionTable::Expire, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,210 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_PENDING_TRANSACTION_TABLE_H
+#define VLC_PENDING_TRANSACTION_TABLE_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/packet.h>
+#include <ns3/callback.h>
+#include <ns3/event-id.h>
+#include <ns3/mac16-address.h>
+#include <ns3/mac64-address.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * An MSDU kept by the coordinator until its destination asks for it.
+ */
+struct VlcPendingTransaction
+{
+  Ptr<Packet> m_packet;     //!< the MPDU
+  uint8_t m_msduHandle;     //!< the MSDU handle of the request
+  Time m_expiry;            //!< the time the transaction expires
+};
+
+/**
+ * \ingroup vlc
+ *
+ * The pending transactions of a coordinator for indirect transmission.
+ *
+ * An MSDU sent with TX_OPTION_INDIRECT is kept here until its destination
+ * extracts it with a data request command, instead of being sent to a
+ * device whose receiver may be off. Transactions are queued per short or
+ * extended destination address of their MAC header, so a lookup does not
+ * depend on the transactions of other devices, and are extracted in order
+ * of arrival. The table holds at most MaxTransactions transactions; a
+ * transaction that is not extracted before its expiry time is removed and
+ * reported to the expire callback.
+ */
+class VlcPendingTransactionTable : public Object
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcPendingTransactionTable (void);
+  virtual ~VlcPendingTransactionTable (void);
+
+  /**
+   * Callback invoked for every expired transaction, with the packet and its
+   * MSDU handle.
+   */
+  typedef Callback<void, Ptr<const Packet>, uint8_t> ExpireCallback;
+
+  /**
+   * Add a transaction.
+   *
+   * \param packet the MPDU, addressed with a short or extended address
+   * \param msduHandle the MSDU handle of the request
+   * \param persistence the time the transaction is kept
+   * \return true, if the table had room for the transaction
+   */
+  bool Enqueue (Ptr<Packet> packet, uint8_t msduHandle, Time persistence);
+
+  /**
+   * Put an extracted transaction back, e.g. when its transmission has not
+   * been acknowledged. It is extracted again before the other transactions
+   * of its destination.
+   *
+   * \param transaction the transaction
+   * \return true, if the transaction has not expired and the table had room
+   * for it
+   */
+  bool Restore (const VlcPendingTransaction &transaction);
+
+  /**
+   * Remove the oldest transaction of a device.
+   *
+   * \param address the short address of the device
+   * \param [out] transaction the transaction
+   * \return true, if a transaction was pending for the device
+   */
+  bool Extract (Mac16Address address, VlcPendingTransaction &transaction);
+
+  /**
+   * Remove the oldest transaction of a device.
+   *
+   * \param address the extended address of the device
+   * \param [out] transaction the transaction
+   * \return true, if a transaction was pending for the device
+   */
+  bool Extract (Mac64Address address, VlcPendingTransaction &transaction);
+
+  /**
+   * \param address the short address of a device
+   * \return true, if a transaction is pending for the device
+   */
+  bool IsPending (Mac16Address address) const;
+
+  /**
+   * \param address the extended address of a device
+   * \return true, if a transaction is pending for the device
+   */
+  bool IsPending (Mac64Address address) const;
+
+  /**
+   * Get the destinations of the pending transactions, in order of their
+   * oldest transaction, as announced in a beacon.
+   *
+   * \param maxAddresses the maximum number of addresses, short and extended
+   * \param [out] shortAddresses the short addresses
+   * \param [out] extAddresses the extended addresses
+   */
+  void GetPendingAddresses (uint32_t maxAddresses, std::vector<Mac16Address> &shortAddresses,
+                            std::vector<Mac64Address> &extAddresses) const;
+
+  /**
+   * Drop all transactions without notifying the expire callback.
+   */
+  void Flush (void);
+
+  /**
+   * \return the number of pending transactions
+   */
+  uint32_t GetNTransactions (void) const;
+
+  /**
+   * \return true, if no transaction is pending
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * \param c the callback invoked for every expired transaction
+   */
+  void SetExpireCallback (ExpireCallback c);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * A transaction with its order of arrival in the table.
+   */
+  struct Entry
+  {
+    VlcPendingTransaction transaction;   //!< the transaction
+    int64_t sequence;                    //!< the order of arrival, restored transactions first
+  };
+
+  /**
+   * The transactions of a destination, oldest first.
+   */
+  typedef std::deque<Entry> Queue;
+
+  /**
+   * Add an entry to the queue of the destination of its MPDU.
+   *
+   * \param entry the entry
+   * \param front whether to add it before the other transactions of the
+   * destination
+   * \return true, if the MPDU has a short or extended destination
+   */
+  bool Add (const Entry &entry, bool front);
+
+  /**
+   * Remove the expired transactions and schedule the next expiry.
+   */
+  void Expire (void);
+
+  /**
+   * Schedule the expiry of the transaction expiring first.
+   */
+  void ScheduleExpiry (void);
+
+  std::map<Mac16Address, Queue> m_shortQueues;   //!< the transactions per short destination
+  std::map<Mac64Address, Queue> m_extQueues;     //!< the transactions per extended destination
+  uint32_t m_nTransactions;          //!< the number of transactions
+  int64_t m_nextSequence;            //!< the order of arrival of the next transaction
+  int64_t m_restoredSequence;        //!< the order of arrival of the last restored transaction
+  uint32_t m_maxTransactions;        //!< the maximum number of transactions
+  EventId m_expireEvent;             //!< the next expiry
+  ExpireCallback m_expireCallback;   //!< the expire callback
+};
+
+} // namespace ns3
+
+#endif /* VLC_PENDING_TRANSACTION_TABLE_H */
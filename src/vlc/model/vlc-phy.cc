@@ -18,9 +18,11 @@
  */
 #include "vlc-phy.h"
 #include "vlc-wqi-tag.h"
+#include "vlc-mcs-tag.h"
 #include "vlc-spectrum-signal-parameters.h"
 #include "vlc-spectrum-value-helper.h"
 #include "vlc-error-model.h"
+#include "vlc-receiver-noise-model.h"
 #include "vlc-net-device.h"
 #include <ns3/log.h>
 #include <ns3/abort.h>
@@ -30,15 +32,59 @@
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-channel.h>
 #include <ns3/packet.h>
-#include <ns3/packet-burst.h>
 #include <ns3/net-device.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/enum.h>
+#include <ns3/pointer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("VlcPhy");
 
+VlcPhyColorFunction::VlcPhyColorFunction (void)
+{
+  memset (m_entries, 0, sizeof (m_entries));
+}
+
+uint32_t
+VlcPhyColorFunction::Get (uint8_t index, uint8_t component) const
+{
+  NS_ASSERT (component < 3);
+  return m_entries[index][component];
+}
+
+void
+VlcPhyColorFunction::Set (uint8_t index, uint8_t component, uint32_t value)
+{
+  NS_ASSERT (component < 3);
+  m_entries[index][component] = value;
+}
+
+Ptr<VlcPhyColorFunction>
+VlcPhyColorFunction::Copy (void) const
+{
+  return Create<VlcPhyColorFunction> (*this);
+}
+
+bool
+VlcPhyColorFunction::IsEqual (const VlcPhyColorFunction &other) const
+{
+  return this == &other || memcmp (m_entries, other.m_entries, sizeof (m_entries)) == 0;
+}
+
+Ptr<const VlcPhyColorFunction>
+VlcPhyColorFunction::GetDefault (void)
+{
+  static Ptr<const VlcPhyColorFunction> colorFunction = Create<VlcPhyColorFunction> ();
+  return colorFunction;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (VlcPhy);
 
 // Table 22 in section 6.4.1 of ieee802.15.4
@@ -46,18 +92,106 @@ const uint32_t VlcPhy::aMaxPhyPacketSize = 200; // max PSDU in octets
 const uint32_t VlcPhy::aTurnaroundTime_TX_RX = 0;  // RX-to-TX or TX-to-RX in symbol periods
 const uint32_t VlcPhy::aTurnaroundTime_RX_TX = 5120;
 
-// IEEE802.15.4-2006 Table 2 in section 6.1.2 (kb/s and ksymbol/s)
-// The index follows VlcPhyOption
-const VlcPhyDataAndSymbolRates
-VlcPhy::dataSymbolRates[2] = { { 1250.0, 1250.0},
-                                  { 6000.0, 6000.0}};
-// IEEE802.15.4-2006 Table 19 and Table 20 in section 6.3.
-// The PHR is 1 octet and it follows phySymbolsPerOctet in Table 23
-// The index follows VlcPhyOption
-// TODO : CHECK
+// IEEE802.15.7-2011 Table 73 (PHY I), Table 74 (PHY II) and Table 75 (PHY III)
+// (optical clock in kHz, data rate in kb/s, outer Reed-Solomon code).
+// The index follows VlcPhyMcs. The inner convolutional code of PHY I only
+// enters through the data rate.
+const VlcPhyMcsParameters
+VlcPhy::mcsParameters[IEEE_802_15_7_INVALID_MCS] = {
+  { IEEE_802_15_7_8B10B_OOK, 1, 200.0, 11.67, 15, 7, 4 },
+  { IEEE_802_15_7_8B10B_OOK, 1, 200.0, 24.44, 15, 11, 4 },
+  { IEEE_802_15_7_8B10B_OOK, 1, 200.0, 48.89, 15, 11, 4 },
+  { IEEE_802_15_7_8B10B_OOK, 1, 200.0, 73.3, 15, 11, 4 },
+  { IEEE_802_15_7_8B10B_OOK, 1, 200.0, 100.0, 0, 0, 0 },
+  { IEEE_802_15_7_4B6B_VPPM, 1, 400.0, 35.56, 15, 2, 4 },
+  { IEEE_802_15_7_4B6B_VPPM, 1, 400.0, 71.11, 15, 4, 4 },
+  { IEEE_802_15_7_4B6B_VPPM, 1, 400.0, 124.4, 15, 7, 4 },
+  { IEEE_802_15_7_4B6B_VPPM, 1, 400.0, 266.6, 0, 0, 0 },
+  { IEEE_802_15_7_4B6B_VPPM, 2, 3750.0, 1250.0, 64, 32, 8 },
+  { IEEE_802_15_7_4B6B_VPPM, 2, 3750.0, 2000.0, 160, 128, 8 },
+  { IEEE_802_15_7_4B6B_VPPM, 2, 7500.0, 2500.0, 64, 32, 8 },
+  { IEEE_802_15_7_4B6B_VPPM, 2, 7500.0, 4000.0, 160, 128, 8 },
+  { IEEE_802_15_7_4B6B_VPPM, 2, 7500.0, 5000.0, 0, 0, 0 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 15000.0, 6000.0, 64, 32, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 15000.0, 9600.0, 160, 128, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 30000.0, 12000.0, 64, 32, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 30000.0, 19200.0, 160, 128, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 60000.0, 24000.0, 64, 32, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 60000.0, 38400.0, 160, 128, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 120000.0, 48000.0, 64, 32, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 120000.0, 76800.0, 160, 128, 8 },
+  { IEEE_802_15_7_8B10B_OOK, 2, 120000.0, 96000.0, 0, 0, 0 },
+  { IEEE_802_15_7_CSK, 3, 12000.0, 12000.0, 64, 32, 8 },
+  { IEEE_802_15_7_CSK, 3, 12000.0, 18000.0, 64, 32, 8 },
+  { IEEE_802_15_7_CSK, 3, 24000.0, 24000.0, 64, 32, 8 },
+  { IEEE_802_15_7_CSK, 3, 24000.0, 36000.0, 64, 32, 8 },
+  { IEEE_802_15_7_CSK, 3, 24000.0, 48000.0, 64, 32, 8 },
+  { IEEE_802_15_7_CSK, 3, 24000.0, 72000.0, 0, 0, 0 },
+  { IEEE_802_15_7_CSK, 3, 24000.0, 96000.0, 0, 0, 0 }
+};
+// IEEE802.15.7-2011 section 10.6: the preamble is a fast locking pattern of
+// 64 clocks and four topology dependent patterns of 15 clocks. The PHR of
+// 32 bits and its HCS of 16 bits are counted as one clock per bit.
 const VlcPhyPpduHeaderSymbolNumber
-VlcPhy::ppduHeaderSymbolNumbers[2] = { { 124.0, 32.0, 16.0 },
-                                          { 124.0, 32.0, 16.0}};
+VlcPhy::ppduHeaderSymbolNumbers = { 124.0, 32.0, 16.0 };
+
+namespace {
+
+/**
+ * The largest PSDU size covered by the airtime tables, the 10 bit frame
+ * length of the PHR.
+ */
+const uint32_t g_maxTabulatedPsduSize = 1023;
+
+/**
+ * The attribute names of the modulation and coding schemes, indexed by
+ * VlcPhyMcs.
+ */
+const char *g_mcsNames[IEEE_802_15_7_INVALID_MCS] = {
+  "PhyIOok11.67Kbps",
+  "PhyIOok24.44Kbps",
+  "PhyIOok48.89Kbps",
+  "PhyIOok73.3Kbps",
+  "PhyIOok100Kbps",
+  "PhyIVppm35.56Kbps",
+  "PhyIVppm71.11Kbps",
+  "PhyIVppm124.4Kbps",
+  "PhyIVppm266.6Kbps",
+  "PhyIIVppm1.25Mbps",
+  "PhyIIVppm2Mbps",
+  "PhyIIVppm2.5Mbps",
+  "PhyIIVppm4Mbps",
+  "PhyIIVppm5Mbps",
+  "PhyIIOok6Mbps",
+  "PhyIIOok9.6Mbps",
+  "PhyIIOok12Mbps",
+  "PhyIIOok19.2Mbps",
+  "PhyIIOok24Mbps",
+  "PhyIIOok38.4Mbps",
+  "PhyIIOok48Mbps",
+  "PhyIIOok76.8Mbps",
+  "PhyIIOok96Mbps",
+  "PhyIII4Csk12Mbps",
+  "PhyIII8Csk18Mbps",
+  "PhyIII4Csk24Mbps",
+  "PhyIII8Csk36Mbps",
+  "PhyIII16Csk48Mbps",
+  "PhyIII8Csk72Mbps",
+  "PhyIII16Csk96Mbps"
+};
+
+} // anonymous namespace
+
+Ptr<const AttributeChecker>
+MakeVlcPhyMcsChecker (void)
+{
+  Ptr<EnumChecker> checker = Create<EnumChecker> ();
+  for (uint32_t i = 0; i < IEEE_802_15_7_INVALID_MCS; i++)
+    {
+      checker->Add (i, g_mcsNames[i]);
+    }
+  return checker;
+}
 
 TypeId
 VlcPhy::GetTypeId (void)
@@ -66,6 +200,38 @@ VlcPhy::GetTypeId (void)
     .SetParent<SpectrumPhy> ()
     .SetGroupName ("Vlc")
     .AddConstructor<VlcPhy> ()
+    .AddAttribute ("Mcs",
+                   "The modulation and coding scheme of frames without a VlcMcsTag.",
+                   EnumValue (IEEE_802_15_7_PHY_II_OOK_6_MBPS),
+                   MakeEnumAccessor (&VlcPhy::SetMcs,
+                                     &VlcPhy::GetMcs),
+                   MakeVlcPhyMcsChecker ())
+    .AddAttribute ("MaxPsduSize",
+                   "The largest PSDU accepted for transmission, in octets. "
+                   "PHY II and PHY III frames may be longer than aMaxPhyPacketSize.",
+                   UintegerValue (aMaxPhyPacketSize),
+                   MakeUintegerAccessor (&VlcPhy::m_maxPsduSize),
+                   MakeUintegerChecker<uint32_t> (1, 1023))
+    .AddAttribute ("TxPower",
+                   "The optical transmit power in dBm, emitted in the colour band of the current channel.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&VlcPhy::SetTxPower,
+                                       &VlcPhy::GetTxPower),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("AdjacentBandGain",
+                   "The linear gain of the optical filter of the receiver in the colour bands "
+                   "next to the band of the current channel, 0 for an ideal filter.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&VlcPhy::SetAdjacentBandGain,
+                                       &VlcPhy::GetAdjacentBandGain),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("NoiseModel",
+                   "The noise model of the photodiode receiver, "
+                   "none to limit the SINR by the interference only",
+                   PointerValue (),
+                   MakePointerAccessor (&VlcPhy::SetNoiseModel,
+                                        &VlcPhy::GetNoiseModel),
+                   MakePointerChecker<VlcReceiverNoiseModel> ())
     .AddTraceSource ("TrxStateValue",
                      "The state of the transceiver",
                      MakeTraceSourceAccessor (&VlcPhy::m_trxState),
@@ -74,6 +240,10 @@ VlcPhy::GetTypeId (void)
                      "The state of the transceiver",
                      MakeTraceSourceAccessor (&VlcPhy::m_trxStateLogger),
                      "ns3::VlcPhy::StateTracedCallback")
+    .AddTraceSource ("DimmingLevel",
+                     "The dimming level set by the phyDim PIB attribute",
+                     MakeTraceSourceAccessor (&VlcPhy::m_dimmingLevelTrace),
+                     "ns3::TracedValueCallback::Double")
     .AddTraceSource ("PhyTxBegin",
                      "Trace source indicating a packet has "
                      "begun transmitting over the channel medium",
@@ -116,6 +286,8 @@ VlcPhy::VlcPhy (void)
 {
   m_trxState = IEEE_802_15_7_PHY_TRX_OFF;
   m_trxStatePending = IEEE_802_15_7_PHY_IDLE;
+  m_off = false;
+  m_offRequest = IEEE_802_15_7_PHY_IDLE;
 
   // default PHY PIB attributes
   m_phyPIBAttributes.phyCurrentChannel = 1;
@@ -126,7 +298,16 @@ VlcPhy::VlcPhy (void)
   //    m_phyPIBAttributes.phyChannelsSupported[i] = 0x07ffffff;
   //  }
   m_phyPIBAttributes.phyCCAMode = 1;
-
+  m_phyPIBAttributes.phyDim = 0;
+  m_phyPIBAttributes.phyUseExtendedMode = 0;
+  m_phyPIBAttributes.phyColorFunction = VlcPhyColorFunction::GetDefault ();
+  m_phyPIBAttributes.phyBlinkingNotificationFrequency = 0;
+  m_maxPsduSize = aMaxPhyPacketSize;
+
+  m_mcs = IEEE_802_15_7_PHY_II_OOK_6_MBPS;
+  m_rxMcs = m_mcs;
+  m_rxDimmingLevel = 0.5;
+  m_rxPower = 0;
   SetMyPhyOption ();
 
   // TODO : CHECK
@@ -139,9 +320,13 @@ VlcPhy::VlcPhy (void)
   VlcSpectrumValueHelper psdHelper;
   // m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_phyPIBAttributes.phyTransmitPower,
   //                                                   m_phyPIBAttributes.phyCurrentChannel);
-  m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_phyPIBAttributes.phyCurrentChannel, 0);
+  m_txPower = 0;
+  m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_txPower, m_phyPIBAttributes.phyCurrentChannel);
+  m_adjacentBandGain = 0;
+  m_rxFilter = VlcSpectrumValueHelper::CreateRxFilterResponse (m_phyPIBAttributes.phyCurrentChannel, m_adjacentBandGain);
   //m_noise = psdHelper.CreateNoisePowerSpectralDensity (m_phyPIBAttributes.phyCurrentChannel);
   //m_signal = Create<VlcInterferenceHelper> (m_noise->GetSpectrumModel ());
+  m_signal = Create<VlcInterferenceHelper> (m_txPsd->GetSpectrumModel ());
   m_rxLastUpdate = Seconds (0);
   Ptr<Packet> none_packet = 0;
   Ptr<VlcSpectrumSignalParameters> none_params = 0;
@@ -175,9 +360,11 @@ VlcPhy::DoDispose (void)
   m_device = 0;
   m_channel = 0;
   m_txPsd = 0;
-  //m_noise = 0;
+  m_rxFilter = 0;
+  m_noiseModel = 0;
   m_signal = 0;
   m_errorModel = 0;
+  m_psrErrorModel = 0;
   m_pdDataIndicationCallback = MakeNullCallback< void, uint32_t, Ptr<Packet>, uint8_t > ();
   m_pdDataConfirmCallback = MakeNullCallback< void, VlcPhyEnumeration > ();
   m_plmeCcaConfirmCallback = MakeNullCallback< void, VlcPhyEnumeration > ();
@@ -282,9 +469,7 @@ VlcPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
       //m_edPower.lastUpdate = now;
     //}
 
-  Ptr<VlcSpectrumSignalParameters> vlcRxParams = DynamicCast<VlcSpectrumSignalParameters> (spectrumRxParams);
-
-  if (vlcRxParams == 0)
+  if (!VlcSpectrumSignalParameters::IsVlcSignal (spectrumRxParams))
     {
       CheckInterference ();
       m_signal->AddSignal (spectrumRxParams->psd);
@@ -292,7 +477,7 @@ VlcPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
       // Update peak power if CCA is in progress.
       if (!m_ccaRequest.IsExpired ())
         {
-          double power = VlcSpectrumValueHelper::TotalAvgPower (m_signal->GetSignalPsd (), m_phyPIBAttributes.phyCurrentChannel);
+          double power = m_signal->GetSignalPower (*m_rxFilter);
           if (m_ccaPeakPower < power)
             {
               m_ccaPeakPower = power;
@@ -303,7 +488,8 @@ VlcPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
       return;
     }
 
-  Ptr<Packet> p = (vlcRxParams->packetBurst->GetPackets ()).front ();
+  Ptr<VlcSpectrumSignalParameters> vlcRxParams = StaticCast<VlcSpectrumSignalParameters> (spectrumRxParams);
+  Ptr<Packet> p = vlcRxParams->packet;
   NS_ASSERT (p != 0);
 
   // Prevent PHY from receiving another packet while switching the transceiver state.
@@ -325,12 +511,9 @@ VlcPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
 
       // Add any incoming packet to the current interference before checking the
       // SINR.
-      NS_LOG_DEBUG (this << " receiving packet with power: " << 10 * log10(VlcSpectrumValueHelper::TotalAvgPower (vlcRxParams->psd, m_phyPIBAttributes.phyCurrentChannel)) + 30 << "dBm");
+      NS_LOG_DEBUG (this << " receiving packet with power: " << 10 * log10(VlcSpectrumValueHelper::TotalAvgPower (vlcRxParams->psd, *m_rxFilter)) + 30 << "dBm");
       m_signal->AddSignal (vlcRxParams->psd);
-      Ptr<SpectrumValue> interferenceAndNoise = m_signal->GetSignalPsd ();
-      *interferenceAndNoise -= *vlcRxParams->psd;
-    //  *interferenceAndNoise += *m_noise;
-      double sinr = VlcSpectrumValueHelper::TotalAvgPower (vlcRxParams->psd, m_phyPIBAttributes.phyCurrentChannel) / VlcSpectrumValueHelper::TotalAvgPower (interferenceAndNoise, m_phyPIBAttributes.phyCurrentChannel);
+      double sinr = CalculateSinr (vlcRxParams->psd);
 
       // Std. 802.15.4-2006, appendix E, Figure E.2
       // At SNR < -5 the BER is less than 10e-1.
@@ -339,6 +522,12 @@ VlcPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
         {
           ChangeTrxState (IEEE_802_15_7_PHY_BUSY_RX);
           m_currentRxPacket = std::make_pair (vlcRxParams, false);
+          VlcMcsTag mcsTag (m_mcs);
+          p->PeekPacketTag (mcsTag);
+          m_rxMcs = mcsTag.Get ();
+          m_rxDimmingLevel = vlcRxParams->dimmingLevel;
+          m_rxPower = VlcSpectrumValueHelper::TotalAvgPower (vlcRxParams->psd, *m_rxFilter);
+          ConfigureErrorModel (m_errorModel, m_rxMcs, m_rxDimmingLevel);
           m_phyRxBeginTrace (p);
 
           m_rxLastUpdate = Simulator::Now ();
@@ -375,7 +564,7 @@ VlcPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
   // Update peak power if CCA is in progress.
   if (!m_ccaRequest.IsExpired ())
     {
-      double power = VlcSpectrumValueHelper::TotalAvgPower (m_signal->GetSignalPsd (), m_phyPIBAttributes.phyCurrentChannel);
+      double power = m_signal->GetSignalPower (*m_rxFilter);
       if (m_ccaPeakPower < power)
         {
           m_ccaPeakPower = power;
@@ -400,16 +589,18 @@ VlcPhy::CheckInterference (void)
     {
       // NS_ASSERT (currentRxParams && !m_currentRxPacket.second);
 
-      Ptr<Packet> currentPacket = currentRxParams->packetBurst->GetPackets ().front ();
+      Ptr<Packet> currentPacket = currentRxParams->packet;
       if (m_errorModel != 0)
         {
+          // SetMcs may have configured the error model for the transmitted
+          // frames since the start of the reception.
+          ConfigureErrorModel (m_errorModel, m_rxMcs, m_rxDimmingLevel);
+
           // How many bits did we receive since the last calculation?
           double t = (Simulator::Now () - m_rxLastUpdate).ToDouble (Time::MS);
-          uint32_t chunkSize = ceil (t * (GetDataOrSymbolRate (true) / 1000));
-          Ptr<SpectrumValue> interferenceAndNoise = m_signal->GetSignalPsd ();
-          *interferenceAndNoise -= *currentRxParams->psd;
-          //*interferenceAndNoise += *m_noise;
-          double sinr = VlcSpectrumValueHelper::TotalAvgPower (currentRxParams->psd, m_phyPIBAttributes.phyCurrentChannel) / VlcSpectrumValueHelper::TotalAvgPower (interferenceAndNoise, m_phyPIBAttributes.phyCurrentChannel);
+          uint32_t chunkSize = ceil (t * mcsParameters[m_rxMcs].bitRate
+                                     * GetDimmingRateFactor (m_rxMcs, m_rxDimmingLevel));
+          double sinr = CalculateSinr (currentRxParams->psd);
           double per = 1.0 - m_errorModel->GetChunkSuccessRate (sinr, chunkSize);
 
           // The LQI is the total packet success rate scaled to 0-255.
@@ -439,8 +630,6 @@ VlcPhy::EndRx (Ptr<SpectrumSignalParameters> par)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<VlcSpectrumSignalParameters> params = DynamicCast<VlcSpectrumSignalParameters> (par);
-
   // TODO : CHECK
   //if (!m_edRequest.IsExpired ())
     //{
@@ -450,8 +639,11 @@ VlcPhy::EndRx (Ptr<SpectrumSignalParameters> par)
       //m_edPower.lastUpdate = now;
     //}
 
+  // Signals other than the current frame only interfere, no need to know
+  // their type.
   Ptr<VlcSpectrumSignalParameters> currentRxParams = m_currentRxPacket.first;
-  if (currentRxParams == params)
+  bool isCurrentRx = currentRxParams != 0 && PeekPointer (par) == PeekPointer (currentRxParams);
+  if (isCurrentRx)
     {
       CheckInterference ();
     }
@@ -459,16 +651,10 @@ VlcPhy::EndRx (Ptr<SpectrumSignalParameters> par)
   // Update the interference.
   m_signal->RemoveSignal (par->psd);
 
-  if (params == 0)
-    {
-      NS_LOG_LOGIC ("Node: " << m_device->GetAddress() << " Removing interferent: " << *(par->psd));
-      return;
-    }
-
   // If this is the end of the currently received packet, check if reception was successful.
-  if (currentRxParams == params)
+  if (isCurrentRx)
     {
-      Ptr<Packet> currentPacket = currentRxParams->packetBurst->GetPackets ().front ();
+      Ptr<Packet> currentPacket = currentRxParams->packet;
       NS_ASSERT (currentPacket != 0);
 
       // If there is no error model attached to the PHY, we always report the maximum LQI value.
@@ -500,12 +686,7 @@ VlcPhy::EndRx (Ptr<SpectrumSignalParameters> par)
           if (!m_setTRXState.IsRunning ())
             {
               NS_LOG_LOGIC ("Apply pending state change to " << m_trxStatePending);
-              ChangeTrxState (m_trxStatePending);
-              m_trxStatePending = IEEE_802_15_7_PHY_IDLE;
-              if (!m_plmeSetTRXStateConfirmCallback.IsNull ())
-                {
-                  m_plmeSetTRXStateConfirmCallback (IEEE_802_15_7_PHY_SUCCESS);
-                }
+              ApplyPendingTrxState ();
             }
         }
       else
@@ -520,7 +701,7 @@ VlcPhy::PdDataRequest (const uint32_t psduLength, Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << psduLength << p);
 
-  if (psduLength > aMaxPhyPacketSize)
+  if (psduLength > m_maxPsduSize)
     {
       if (!m_pdDataConfirmCallback.IsNull ())
         {
@@ -542,6 +723,12 @@ VlcPhy::PdDataRequest (const uint32_t psduLength, Ptr<Packet> p)
           VlcWqiTag wqiTag;
           p->RemovePacketTag (wqiTag);
 
+          // Signal the modulation and coding scheme in the PHR, unless the
+          // MAC has selected one for this frame.
+          VlcMcsTag mcsTag (m_mcs);
+          p->PeekPacketTag (mcsTag);
+          p->ReplacePacketTag (mcsTag);
+
           m_phyTxBeginTrace (p);
           m_currentTxPacket.first = p;
           m_currentTxPacket.second = false;
@@ -549,11 +736,10 @@ VlcPhy::PdDataRequest (const uint32_t psduLength, Ptr<Packet> p)
           Ptr<VlcSpectrumSignalParameters> txParams = Create<VlcSpectrumSignalParameters> ();
           txParams->duration = CalculateTxTime (p);
           txParams->txPhy = GetObject<SpectrumPhy> ();
-          txParams->psd = m_txPsd;
+          txParams->psd = GetDimmedTxPowerSpectralDensity ();
           //txParams->txAntenna = m_antenna;
-          Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
-          pb->AddPacket (p);
-          txParams->packetBurst = pb;
+          txParams->packet = p;
+          txParams->dimmingLevel = GetDimmingLevel ();
           m_channel->StartTx (txParams);
           m_pdDataRequest = Simulator::Schedule (txParams->duration, &VlcPhy::EndTx, this);
           ChangeTrxState (IEEE_802_15_7_PHY_BUSY_TX);
@@ -677,8 +863,31 @@ VlcPhy::PlmeGetAttributeRequest (VlcPibAttributeIdentifier id)
     }
   if (!m_plmeGetAttributeConfirmCallback.IsNull ())
     {
+      // Only the requested attribute is returned.
       VlcPhyPibAttributes retValue;
-      memcpy (&retValue, &m_phyPIBAttributes, sizeof(VlcPhyPibAttributes));
+      switch (id)
+        {
+        case phyCurrentChannel:
+          retValue.phyCurrentChannel = m_phyPIBAttributes.phyCurrentChannel;
+          break;
+        case phyCCAMode:
+          retValue.phyCCAMode = m_phyPIBAttributes.phyCCAMode;
+          break;
+        case phyDim:
+          retValue.phyDim = m_phyPIBAttributes.phyDim;
+          break;
+        case phyUseExtendedMode:
+          retValue.phyUseExtendedMode = m_phyPIBAttributes.phyUseExtendedMode;
+          break;
+        case phyColorFunction:
+          retValue.phyColorFunction = m_phyPIBAttributes.phyColorFunction;
+          break;
+        case phyBlinkingNotificationFrequency:
+          retValue.phyBlinkingNotificationFrequency = m_phyPIBAttributes.phyBlinkingNotificationFrequency;
+          break;
+        default:
+          break;
+        }
       m_plmeGetAttributeConfirmCallback (status,id,&retValue);
     }
 }
@@ -695,6 +904,13 @@ VlcPhy::PlmeSetTRXStateRequest (VlcPhyEnumeration state)
                 && (state != IEEE_802_15_7_PHY_FORCE_TRX_OFF)
                 && (state != IEEE_802_15_7_PHY_TX_ON) );
 
+  if (m_off && (state == IEEE_802_15_7_PHY_RX_ON || state == IEEE_802_15_7_PHY_TX_ON))
+    {
+      NS_LOG_DEBUG ("Transceiver off, request deferred");
+      m_offRequest = state;
+      return;
+    }
+
   NS_LOG_LOGIC ("Trying to set m_trxState from " << m_trxState << " to " << state);
   // this method always overrides previous state setting attempts
   if (!m_setTRXState.IsExpired ())
@@ -876,18 +1092,9 @@ bool
 VlcPhy::ChannelSupported (uint8_t channel)
 {
   NS_LOG_FUNCTION (this << channel);
-  bool retValue = false;
 
-  // for (uint32_t i = 0; i < 32; i++)
-  //   {
-  //     if ((m_phyPIBAttributes.phyChannelsSupported[i] & (1 << channel)) != 0)
-  //       {
-  //         retValue = true;
-  //         break;
-  //       }
-  //   }
-
-  return retValue;
+  // One channel per colour band.
+  return channel < VlcSpectrumValueHelper::GetNChannels ();
 }
 
 void
@@ -906,7 +1113,7 @@ VlcPhy::PlmeSetAttributeRequest (VlcPibAttributeIdentifier id,
           {
             status = IEEE_802_15_7_PHY_INVALID_PARAMETER;
           }
-        if (m_phyPIBAttributes.phyCurrentChannel != attribute->phyCurrentChannel)
+        else if (m_phyPIBAttributes.phyCurrentChannel != attribute->phyCurrentChannel)
           {
             // Cancel a pending transceiver state change.
             // Switch off the transceiver.
@@ -940,7 +1147,9 @@ VlcPhy::PlmeSetAttributeRequest (VlcPibAttributeIdentifier id,
             m_phyPIBAttributes.phyCurrentChannel = attribute->phyCurrentChannel;
             VlcSpectrumValueHelper psdHelper;
             // m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_phyPIBAttributes.phyTransmitPower, m_phyPIBAttributes.phyCurrentChannel);
-            m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_phyPIBAttributes.phyCurrentChannel , 0);
+            m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_txPower, m_phyPIBAttributes.phyCurrentChannel);
+            m_rxFilter = VlcSpectrumValueHelper::CreateRxFilterResponse (m_phyPIBAttributes.phyCurrentChannel,
+                                                                         m_adjacentBandGain);
           }
         break;
       }
@@ -982,6 +1191,39 @@ VlcPhy::PlmeSetAttributeRequest (VlcPibAttributeIdentifier id,
           }
         break;
       }
+    case phyDim:
+      {
+        // In steps of 0.1%, a light source at its full power cannot send.
+        if (attribute->phyDim >= 1000)
+          {
+            status = IEEE_802_15_7_PHY_INVALID_PARAMETER;
+          }
+        else if (m_phyPIBAttributes.phyDim != attribute->phyDim)
+          {
+            double oldLevel = GetDimmingLevel ();
+            m_phyPIBAttributes.phyDim = attribute->phyDim;
+            m_dimmingLevelTrace (oldLevel, GetDimmingLevel ());
+          }
+        break;
+      }
+    case phyColorFunction:
+      {
+        Ptr<const VlcPhyColorFunction> colorFunction = attribute->phyColorFunction;
+        if (colorFunction == 0)
+          {
+            status = IEEE_802_15_7_PHY_INVALID_PARAMETER;
+          }
+        else if (colorFunction->IsEqual (*VlcPhyColorFunction::GetDefault ()))
+          {
+            // Keep sharing the default instead of holding another copy.
+            m_phyPIBAttributes.phyColorFunction = VlcPhyColorFunction::GetDefault ();
+          }
+        else
+          {
+            m_phyPIBAttributes.phyColorFunction = colorFunction;
+          }
+        break;
+      }
     default:
       {
         status = IEEE_802_15_7_PHY_UNSUPPORTED_ATTRIBUTE;
@@ -1048,6 +1290,11 @@ VlcPhy::SetPlmeSetAttributeConfirmCallback (PlmeSetAttributeConfirmCallback c)
 void
 VlcPhy::ChangeTrxState (VlcPhyEnumeration newState)
 {
+  if (m_off && (newState == IEEE_802_15_7_PHY_RX_ON || newState == IEEE_802_15_7_PHY_TX_ON))
+    {
+      // A frame on air in the off mode has ended.
+      newState = IEEE_802_15_7_PHY_TRX_OFF;
+    }
   NS_LOG_LOGIC (this << " state: " << m_trxState << " -> " << newState);
   m_trxStateLogger (Simulator::Now (), m_trxState, newState);
   m_trxState = newState;
@@ -1118,7 +1365,7 @@ VlcPhy::EndCca (void)
   VlcPhyEnumeration sensedChannelState = IEEE_802_15_7_PHY_UNSPECIFIED;
 
   // Update peak power.
-  double power = VlcSpectrumValueHelper::TotalAvgPower (m_signal->GetSignalPsd (), m_phyPIBAttributes.phyCurrentChannel);
+  double power = m_signal->GetSignalPower (*m_rxFilter);
   if (m_ccaPeakPower < power)
     {
       m_ccaPeakPower = power;
@@ -1200,6 +1447,79 @@ VlcPhy::EndSetTRXState (void)
     }
 }
 
+void
+VlcPhy::ApplyPendingTrxState (void)
+{
+  NS_LOG_FUNCTION (this << m_trxStatePending);
+
+  VlcPhyEnumeration state = m_trxStatePending;
+  m_trxStatePending = IEEE_802_15_7_PHY_IDLE;
+  if (m_off && state != IEEE_802_15_7_PHY_TRX_OFF)
+    {
+      // The request is carried out when the transceiver is back.
+      m_offRequest = state;
+      ChangeTrxState (IEEE_802_15_7_PHY_TRX_OFF);
+      return;
+    }
+  ChangeTrxState (state);
+  if (!m_plmeSetTRXStateConfirmCallback.IsNull ())
+    {
+      m_plmeSetTRXStateConfirmCallback (IEEE_802_15_7_PHY_SUCCESS);
+    }
+}
+
+void
+VlcPhy::SetOffMode (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_off)
+    {
+      return;
+    }
+  m_off = true;
+  if (m_setTRXState.IsRunning ())
+    {
+      m_setTRXState.Cancel ();
+      m_offRequest = m_trxStatePending;
+      m_trxStatePending = IEEE_802_15_7_PHY_IDLE;
+    }
+  if (m_trxState == IEEE_802_15_7_PHY_RX_ON || m_trxState == IEEE_802_15_7_PHY_TX_ON)
+    {
+      ChangeTrxState (IEEE_802_15_7_PHY_TRX_OFF);
+    }
+}
+
+void
+VlcPhy::ResumeFromOff (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_off)
+    {
+      return;
+    }
+  m_off = false;
+  VlcPhyEnumeration request = m_offRequest;
+  m_offRequest = IEEE_802_15_7_PHY_IDLE;
+  if (request != IEEE_802_15_7_PHY_IDLE)
+    {
+      PlmeSetTRXStateRequest (request);
+    }
+}
+
+bool
+VlcPhy::IsOff (void) const
+{
+  return m_off;
+}
+
+VlcPhyEnumeration
+VlcPhy::GetTrxState (void) const
+{
+  return m_trxState;
+}
+
 void
 VlcPhy::EndTx (void)
 {
@@ -1239,12 +1559,7 @@ VlcPhy::EndTx (void)
       if (!m_setTRXState.IsRunning ())
         {
           NS_LOG_LOGIC ("Apply pending state change to " << m_trxStatePending);
-          ChangeTrxState (m_trxStatePending);
-          m_trxStatePending = IEEE_802_15_7_PHY_IDLE;
-          if (!m_plmeSetTRXStateConfirmCallback.IsNull ())
-            {
-              m_plmeSetTRXStateConfirmCallback (IEEE_802_15_7_PHY_SUCCESS);
-            }
+          ApplyPendingTrxState ();
         }
     }
   else
@@ -1261,12 +1576,94 @@ VlcPhy::CalculateTxTime (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
 
-  bool isData = true;
-  Time txTime = GetPpduHeaderTxTime ();
+  VlcMcsTag mcsTag (m_mcs);
+  packet->PeekPacketTag (mcsTag);
+  return GetPpduDuration (mcsTag.Get (), packet->GetSize (), GetDimmingLevel ());
+}
+
+Time
+VlcPhy::GetPpduDuration (VlcPhyMcs mcs, uint32_t psduSize)
+{
+  NS_ASSERT (mcs < IEEE_802_15_7_INVALID_MCS);
+
+  // The airtime of every PSDU size of an MCS is computed once, on first use
+  // of the MCS, so that the transmit path only looks it up.
+  static std::vector<Time> txTimes[IEEE_802_15_7_INVALID_MCS];
+  std::vector<Time> &table = txTimes[mcs];
+  const VlcPhyMcsParameters &params = mcsParameters[mcs];
+  double headerSymbols = ppduHeaderSymbolNumbers.shrPreamble
+    + ppduHeaderSymbolNumbers.phrPhyHeader
+    + ppduHeaderSymbolNumbers.phrHcs;
+
+  if (psduSize > g_maxTabulatedPsduSize)
+    {
+      return Seconds (headerSymbols / (params.opticalClockRate * 1000.0)
+                      + psduSize * 8.0 / (params.bitRate * 1000.0));
+    }
+  if (table.empty ())
+    {
+      table.resize (g_maxTabulatedPsduSize + 1);
+      for (uint32_t i = 0; i <= g_maxTabulatedPsduSize; i++)
+        {
+          table[i] = Seconds (headerSymbols / (params.opticalClockRate * 1000.0)
+                              + i * 8.0 / (params.bitRate * 1000.0));
+        }
+    }
+  return table[psduSize];
+}
+
+Time
+VlcPhy::GetPpduDuration (VlcPhyMcs mcs, uint32_t psduSize, double dimmingLevel)
+{
+  NS_ASSERT (mcs < IEEE_802_15_7_INVALID_MCS);
+
+  double rateFactor = GetDimmingRateFactor (mcs, dimmingLevel);
+  if (rateFactor == 1)
+    {
+      return GetPpduDuration (mcs, psduSize);
+    }
+  const VlcPhyMcsParameters &params = mcsParameters[mcs];
+  double headerSymbols = ppduHeaderSymbolNumbers.shrPreamble
+    + ppduHeaderSymbolNumbers.phrPhyHeader
+    + ppduHeaderSymbolNumbers.phrHcs;
+  return Seconds (headerSymbols / (params.opticalClockRate * 1000.0)
+                  + psduSize * 8.0 / (params.bitRate * 1000.0 * rateFactor));
+}
+
+double
+VlcPhy::GetDimmingRateFactor (VlcPhyMcs mcs, double dimmingLevel)
+{
+  NS_ASSERT (mcs < IEEE_802_15_7_INVALID_MCS);
+  NS_ASSERT (dimmingLevel > 0 && dimmingLevel < 1);
+
+  // CSK keeps the total power of the colours constant.
+  if (mcsParameters[mcs].phyOption != IEEE_802_15_7_8B10B_OOK)
+    {
+      return 1;
+    }
+  return 2 * std::min (dimmingLevel, 1 - dimmingLevel);
+}
+
+double
+VlcPhy::GetDimmingPowerFactor (double dimmingLevel)
+{
+  return 2 * dimmingLevel;
+}
 
-  txTime += Seconds (packet->GetSize () * 8.0 / GetDataOrSymbolRate (isData));
+double
+VlcPhy::GetDimmingLevel (void) const
+{
+  if (m_phyPIBAttributes.phyDim == 0)
+    {
+      return 0.5;
+    }
+  return m_phyPIBAttributes.phyDim / 1000.0;
+}
 
-  return txTime;
+double
+VlcPhy::GetRxDimmingLevel (void) const
+{
+  return m_rxDimmingLevel;
 }
 
 double
@@ -1276,15 +1673,15 @@ VlcPhy::GetDataOrSymbolRate (bool isData)
 
   double rate = 0.0;
 
-  NS_ASSERT (m_phyOption < IEEE_802_15_7_INVALID_PHY_OPTION);
+  NS_ASSERT (m_mcs < IEEE_802_15_7_INVALID_MCS);
 
   if (isData)
     {
-      rate = dataSymbolRates [m_phyOption].bitRate;
+      rate = mcsParameters[m_mcs].bitRate * GetDimmingRateFactor (m_mcs, GetDimmingLevel ());
     }
   else
     {
-      rate = dataSymbolRates [m_phyOption].symbolRate;
+      rate = mcsParameters[m_mcs].opticalClockRate;
     }
 
   return (rate * 1000.0);
@@ -1294,70 +1691,38 @@ Time
 VlcPhy::GetPpduHeaderTxTime (void)
 {
   NS_LOG_FUNCTION (this);
+  return GetPpduDuration (m_mcs, 0);
+}
 
-  bool isData = false;
-  double totalPpduHdrSymbols;
-// TODO : CHECK
-
-  NS_ASSERT (m_phyOption < IEEE_802_15_7_INVALID_PHY_OPTION);
+void
+VlcPhy::SetMcs (VlcPhyMcs mcs)
+{
+  NS_LOG_FUNCTION (this << mcs);
+  NS_ASSERT (mcs < IEEE_802_15_7_INVALID_MCS);
+  m_mcs = mcs;
+  SetMyPhyOption ();
+}
 
-  // totalPpduHdrSymbols = ppduHeaderSymbolNumbers[m_phyOption].shrPreamble
-  //   + ppduHeaderSymbolNumbers[m_phyOption].shrSfd
-  //   + ppduHeaderSymbolNumbers[m_phyOption].phr;
-  totalPpduHdrSymbols = ppduHeaderSymbolNumbers[m_phyOption].shrPreamble\
-    +ppduHeaderSymbolNumbers[m_phyOption].phrPhyHeader
-    + ppduHeaderSymbolNumbers[m_phyOption].phrHcs;
+VlcPhyMcs
+VlcPhy::GetMcs (void) const
+{
+  return m_mcs;
+}
 
-  return Seconds (totalPpduHdrSymbols / GetDataOrSymbolRate (isData));
+const VlcPhyMcsParameters&
+VlcPhy::GetMcsParameters (VlcPhyMcs mcs)
+{
+  NS_ASSERT (mcs < IEEE_802_15_7_INVALID_MCS);
+  return mcsParameters[mcs];
 }
 
-// IEEE802.15.4-2006 Table 2 in section 6.1.2
 void
 VlcPhy::SetMyPhyOption (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_phyOption = IEEE_802_15_7_INVALID_PHY_OPTION;
-
-  m_phyOption = IEEE_802_15_7_8B10B_OOK;
-
-  // if (m_phyPIBAttributes.phyCurrentPage == 0)
-  //   {
-  //     if (m_phyPIBAttributes.phyCurrentChannel == 0)
-  //       {  // 868 MHz BPSK
-  //         m_phyOption = IEEE_802_15_4_868MHZ_BPSK;
-  //       }
-  //     else if (m_phyPIBAttributes.phyCurrentChannel <= 10)
-  //       {  // 915 MHz BPSK
-  //         m_phyOption = IEEE_802_15_4_915MHZ_BPSK;
-  //       }
-  //     else if (m_phyPIBAttributes.phyCurrentChannel <= 26)
-  //       {  // 2.4 GHz MHz O-QPSK
-  //         m_phyOption = IEEE_802_15_4_2_4GHZ_OQPSK;
-  //       }
-  //   }
-  // else if (m_phyPIBAttributes.phyCurrentPage == 1)
-  //   {
-  //     if (m_phyPIBAttributes.phyCurrentChannel == 0)
-  //       {  // 868 MHz ASK
-  //         m_phyOption = IEEE_802_15_4_868MHZ_ASK;
-  //       }
-  //     else if (m_phyPIBAttributes.phyCurrentChannel <= 10)
-  //       {  // 915 MHz ASK
-  //         m_phyOption = IEEE_802_15_4_915MHZ_ASK;
-  //       }
-  //   }
-  // else if (m_phyPIBAttributes.phyCurrentPage == 2)
-  //   {
-  //     if (m_phyPIBAttributes.phyCurrentChannel == 0)
-  //       {  // 868 MHz O-QPSK
-  //         m_phyOption = IEEE_802_15_4_868MHZ_OQPSK;
-  //       }
-  //     else if (m_phyPIBAttributes.phyCurrentChannel <= 10)
-  //       {  // 915 MHz O-QPSK
-  //         m_phyOption = IEEE_802_15_4_915MHZ_OQPSK;
-  //       }
-  //   }
+  m_phyOption = mcsParameters[m_mcs].phyOption;
+  ConfigureErrorModel (m_errorModel, m_mcs, GetDimmingLevel ());
 }
 
 VlcPhyOption
@@ -1367,6 +1732,27 @@ VlcPhy::GetMyPhyOption (void)
   return m_phyOption;
 }
 
+void
+VlcPhy::ConfigureErrorModel (Ptr<VlcErrorModel> errorModel, VlcPhyMcs mcs, double dimmingLevel)
+{
+  NS_LOG_FUNCTION (errorModel << mcs << dimmingLevel);
+
+  if (errorModel == 0)
+    {
+      return;
+    }
+
+  // CSK is approximated by the bit error rate of OOK. The tables of all
+  // schemes are built once, so a new scheme only switches the table.
+  const VlcPhyMcsParameters &params = mcsParameters[mcs];
+  VlcModulation modulation = VLC_MODULATION_OOK;
+  if (params.phyOption == IEEE_802_15_7_4B6B_VPPM)
+    {
+      modulation = VLC_MODULATION_VPPM;
+    }
+  errorModel->Configure (modulation, params.fecN, params.fecK, params.fecSymbolBits, dimmingLevel);
+}
+
 void
 VlcPhy::SetTxPowerSpectralDensity (Ptr<SpectrumValue> txPsd)
 {
@@ -1376,6 +1762,133 @@ VlcPhy::SetTxPowerSpectralDensity (Ptr<SpectrumValue> txPsd)
   NS_LOG_INFO ("\t computed tx_psd: " << *txPsd << "\t stored tx_psd: " << *m_txPsd);
 }
 
+void
+VlcPhy::SetTxPower (double txPower)
+{
+  NS_LOG_FUNCTION (this << txPower);
+  m_txPower = txPower;
+  VlcSpectrumValueHelper psdHelper;
+  m_txPsd = psdHelper.CreateTxPowerSpectralDensity (m_txPower, m_phyPIBAttributes.phyCurrentChannel);
+}
+
+Ptr<const SpectrumValue>
+VlcPhy::GetTxPowerSpectralDensity (void) const
+{
+  return m_txPsd;
+}
+
+Ptr<SpectrumValue>
+VlcPhy::GetDimmedTxPowerSpectralDensity (void) const
+{
+  double dimmingLevel = GetDimmingLevel ();
+  if (dimmingLevel == 0.5)
+    {
+      return m_txPsd;
+    }
+  Ptr<SpectrumValue> psd = m_txPsd->Copy ();
+  *psd *= GetDimmingPowerFactor (dimmingLevel);
+  return psd;
+}
+
+double
+VlcPhy::GetTxPower (void) const
+{
+  return m_txPower;
+}
+
+void
+VlcPhy::SetAdjacentBandGain (double gain)
+{
+  NS_LOG_FUNCTION (this << gain);
+  m_adjacentBandGain = gain;
+  m_rxFilter = VlcSpectrumValueHelper::CreateRxFilterResponse (m_phyPIBAttributes.phyCurrentChannel, gain);
+}
+
+double
+VlcPhy::GetAdjacentBandGain (void) const
+{
+  return m_adjacentBandGain;
+}
+
+void
+VlcPhy::SetNoiseModel (Ptr<VlcReceiverNoiseModel> noiseModel)
+{
+  NS_LOG_FUNCTION (this << noiseModel);
+  m_noiseModel = noiseModel;
+}
+
+Ptr<VlcReceiverNoiseModel>
+VlcPhy::GetNoiseModel (void) const
+{
+  return m_noiseModel;
+}
+
+double
+VlcPhy::CalculateSinr (Ptr<const SpectrumValue> psd) const
+{
+  double signal = VlcSpectrumValueHelper::TotalAvgPower (psd, *m_rxFilter);
+  if (signal <= 0)
+    {
+      // A signal in another colour band.
+      return 0;
+    }
+  return CalculateSinr (signal, m_signal->GetInterferencePower (psd, *m_rxFilter));
+}
+
+double
+VlcPhy::CalculateSinr (double signal, double interference) const
+{
+  double interferenceAndNoise = interference;
+  if (m_noiseModel != 0)
+    {
+      interferenceAndNoise += m_noiseModel->GetNoisePower (signal);
+    }
+  return signal / interferenceAndNoise;
+}
+
+double
+VlcPhy::GetPacketSuccessRate (Ptr<const SpectrumValue> rxPsd, uint32_t psduSize, VlcPhyMcs mcs)
+{
+  return GetPacketSuccessRate (rxPsd, psduSize, mcs, 0.5);
+}
+
+double
+VlcPhy::GetPacketSuccessRate (Ptr<const SpectrumValue> rxPsd, uint32_t psduSize, VlcPhyMcs mcs,
+                              double dimmingLevel)
+{
+  NS_LOG_FUNCTION (this << rxPsd << psduSize << mcs << dimmingLevel);
+  NS_ASSERT (mcs < IEEE_802_15_7_INVALID_MCS);
+
+  // Same decisions as StartRx, CheckInterference and EndRx for a frame that
+  // no other signal overlaps: a single chunk spanning the whole PPDU.
+  double signal = VlcSpectrumValueHelper::TotalAvgPower (rxPsd, *m_rxFilter);
+  if (signal <= 0)
+    {
+      return 0;
+    }
+  double sinr = CalculateSinr (signal, 0);
+  if (10 * log10 (sinr) <= -5)
+    {
+      return 0;
+    }
+  if (m_errorModel == 0)
+    {
+      return 1;
+    }
+  if (m_psrErrorModel == 0)
+    {
+      m_psrErrorModel = CreateObject<VlcErrorModel> ();
+    }
+  if (m_psrErrorModel->GetTableResolution () != m_errorModel->GetTableResolution ())
+    {
+      m_psrErrorModel->SetTableResolution (m_errorModel->GetTableResolution ());
+    }
+  ConfigureErrorModel (m_psrErrorModel, mcs, dimmingLevel);
+  double t = GetPpduDuration (mcs, psduSize, dimmingLevel).ToDouble (Time::MS);
+  uint32_t chunkSize = ceil (t * mcsParameters[mcs].bitRate * GetDimmingRateFactor (mcs, dimmingLevel));
+  return m_psrErrorModel->GetChunkSuccessRate (sinr, chunkSize);
+}
+
 //void
 // VlcPhy::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
 // {
@@ -1398,6 +1911,7 @@ VlcPhy::SetErrorModel (Ptr<VlcErrorModel> e)
   NS_LOG_FUNCTION (this << e);
   NS_ASSERT (e);
   m_errorModel = e;
+  ConfigureErrorModel (m_errorModel, m_mcs, GetDimmingLevel ());
 }
 
 Ptr<VlcErrorModel>
@@ -1411,20 +1925,36 @@ uint64_t
 VlcPhy::GetPhySHRDuration (void) const
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_phyOption < IEEE_802_15_7_INVALID_PHY_OPTION);
+  return ppduHeaderSymbolNumbers.shrPreamble;
+}
 
-  // return ppduHeaderSymbolNumbers[m_phyOption].shrPreamble
-  //        + ppduHeaderSymbolNumbers[m_phyOption].shrSfd;
-  return ppduHeaderSymbolNumbers[m_phyOption].shrPreamble;
+uint64_t
+VlcPhy::GetPhyPhrDuration (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return ppduHeaderSymbolNumbers.phrPhyHeader + ppduHeaderSymbolNumbers.phrHcs;
 }
 
 double
 VlcPhy::GetPhySymbolsPerOctet (void) const
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_phyOption < IEEE_802_15_7_INVALID_PHY_OPTION);
+  NS_ASSERT (m_mcs < IEEE_802_15_7_INVALID_MCS);
 
-  return dataSymbolRates [m_phyOption].symbolRate / (dataSymbolRates [m_phyOption].bitRate / 8);
+  return mcsParameters[m_mcs].opticalClockRate
+         / (mcsParameters[m_mcs].bitRate * GetDimmingRateFactor (m_mcs, GetDimmingLevel ()) / 8);
+}
+
+uint32_t
+VlcPhy::GetMaxPsduSize (void) const
+{
+  return m_maxPsduSize;
+}
+
+double
+VlcPhy::GetRxPower (void) const
+{
+  return m_rxPower;
 }
 
 int64_t
@@ -24,12 +24,15 @@
 #include <ns3/traced-callback.h>
 #include <ns3/traced-value.h>
 #include <ns3/event-id.h>
+#include <ns3/simple-ref-count.h>
+#include <ns3/attribute.h>
 
 namespace ns3 {
 
 class Packet;
 class SpectrumValue;
 class VlcErrorModel;
+class VlcReceiverNoiseModel;
 struct VlcSpectrumSignalParameters;
 class MobilityModel;
 class SpectrumChannel;
@@ -45,18 +48,12 @@ class UniformRandomVariable;
 //  Time measurementLength; //!< Total measuremement period
 //} VlcEdPower;
 
-typedef  struct
-{
-  double bitRate;    //!< bit rate
-  double symbolRate; //!< symbol rate
-} VlcPhyDataAndSymbolRates;
-
 typedef  struct
 {
   double shrPreamble; //!< Number of symbols for the SHR preamble
   //double shrSfd;      //!< Number of symbols for the SHR SFD
   double phrPhyHeader;         //!< Number of symbols for the PHR
-  double phrHcs;       // TODO : Check
+  double phrHcs;       //!< Number of symbols for the HCS of the PHR
 } VlcPhyPpduHeaderSymbolNumber;
 
 typedef enum
@@ -70,9 +67,72 @@ typedef enum
   //IEEE_802_15_4_2_4GHZ_OQPSK        = 6,
   IEEE_802_15_7_4B6B_VPPM             =1,
   IEEE_802_15_7_8B10B_OOK             =2,
-  IEEE_802_15_7_INVALID_PHY_OPTION  = 3
+  IEEE_802_15_7_CSK                   =3,
+  IEEE_802_15_7_INVALID_PHY_OPTION  = 4
 } VlcPhyOption;
 
+/**
+ * The modulation and coding schemes of the IEEE 802.15.7-2011 PHY I, PHY II
+ * and PHY III, see Table 73, Table 74 and Table 75. The names give the data
+ * rate.
+ */
+typedef enum
+{
+  IEEE_802_15_7_PHY_I_OOK_11_67_KBPS = 0,
+  IEEE_802_15_7_PHY_I_OOK_24_44_KBPS = 1,
+  IEEE_802_15_7_PHY_I_OOK_48_89_KBPS = 2,
+  IEEE_802_15_7_PHY_I_OOK_73_3_KBPS = 3,
+  IEEE_802_15_7_PHY_I_OOK_100_KBPS = 4,
+  IEEE_802_15_7_PHY_I_VPPM_35_56_KBPS = 5,
+  IEEE_802_15_7_PHY_I_VPPM_71_11_KBPS = 6,
+  IEEE_802_15_7_PHY_I_VPPM_124_4_KBPS = 7,
+  IEEE_802_15_7_PHY_I_VPPM_266_6_KBPS = 8,
+  IEEE_802_15_7_PHY_II_VPPM_1_25_MBPS = 9,
+  IEEE_802_15_7_PHY_II_VPPM_2_MBPS = 10,
+  IEEE_802_15_7_PHY_II_VPPM_2_5_MBPS = 11,
+  IEEE_802_15_7_PHY_II_VPPM_4_MBPS = 12,
+  IEEE_802_15_7_PHY_II_VPPM_5_MBPS = 13,
+  IEEE_802_15_7_PHY_II_OOK_6_MBPS = 14,
+  IEEE_802_15_7_PHY_II_OOK_9_6_MBPS = 15,
+  IEEE_802_15_7_PHY_II_OOK_12_MBPS = 16,
+  IEEE_802_15_7_PHY_II_OOK_19_2_MBPS = 17,
+  IEEE_802_15_7_PHY_II_OOK_24_MBPS = 18,
+  IEEE_802_15_7_PHY_II_OOK_38_4_MBPS = 19,
+  IEEE_802_15_7_PHY_II_OOK_48_MBPS = 20,
+  IEEE_802_15_7_PHY_II_OOK_76_8_MBPS = 21,
+  IEEE_802_15_7_PHY_II_OOK_96_MBPS = 22,
+  IEEE_802_15_7_PHY_III_4CSK_12_MBPS = 23,
+  IEEE_802_15_7_PHY_III_8CSK_18_MBPS = 24,
+  IEEE_802_15_7_PHY_III_4CSK_24_MBPS = 25,
+  IEEE_802_15_7_PHY_III_8CSK_36_MBPS = 26,
+  IEEE_802_15_7_PHY_III_16CSK_48_MBPS = 27,
+  IEEE_802_15_7_PHY_III_8CSK_72_MBPS = 28,
+  IEEE_802_15_7_PHY_III_16CSK_96_MBPS = 29,
+  IEEE_802_15_7_INVALID_MCS = 30
+} VlcPhyMcs;
+
+/**
+ * Make a checker for an EnumValue holding a VlcPhyMcs. There are more
+ * schemes than MakeEnumChecker takes arguments.
+ *
+ * \return the checker
+ */
+Ptr<const AttributeChecker> MakeVlcPhyMcsChecker (void);
+
+/**
+ * The parameters of a modulation and coding scheme.
+ */
+typedef struct
+{
+  VlcPhyOption phyOption;       //!< the modulation and line code
+  uint8_t phyType;              //!< the PHY type, 1 to 3
+  double opticalClockRate;      //!< the optical clock rate in kHz, the symbol rate
+  double bitRate;               //!< the data rate in kb/s
+  uint32_t fecN;                //!< symbols per Reed-Solomon code word, 0 without RS code
+  uint32_t fecK;                //!< data symbols per Reed-Solomon code word
+  uint32_t fecSymbolBits;       //!< bits per Reed-Solomon symbol
+} VlcPhyMcsParameters;
+
 typedef enum
 {
   IEEE_802_15_7_PHY_BUSY  = 0x00,
@@ -107,6 +167,64 @@ typedef enum
   phyBlinkingNotificationFrequency = 0x05,
 } VlcPibAttributeIdentifier;
 
+/**
+ * \ingroup vlc
+ *
+ * The phyColorFunction PIB attribute: three values for each of the 256
+ * entries of the colour function.
+ *
+ * The table is large compared to the other attributes and mostly left at
+ * its default, so PHYs only keep a pointer to an immutable instance. All
+ * PHYs with the default colour function share the same instance, and
+ * setting the attribute shares the instance passed in. To modify a colour
+ * function in use, Copy () it, change the copy and set the copy.
+ */
+class VlcPhyColorFunction : public SimpleRefCount<VlcPhyColorFunction>
+{
+public:
+  /**
+   * Create a colour function with all entries zero.
+   */
+  VlcPhyColorFunction (void);
+
+  /**
+   * Get a value of the colour function.
+   *
+   * \param index the entry
+   * \param component the component of the entry, 0 to 2
+   * \return the value
+   */
+  uint32_t Get (uint8_t index, uint8_t component) const;
+
+  /**
+   * Set a value of the colour function.
+   *
+   * \param index the entry
+   * \param component the component of the entry, 0 to 2
+   * \param value the value
+   */
+  void Set (uint8_t index, uint8_t component, uint32_t value);
+
+  /**
+   * \return a modifiable copy of this colour function
+   */
+  Ptr<VlcPhyColorFunction> Copy (void) const;
+
+  /**
+   * \param other another colour function
+   * \return true, if both colour functions have the same entries
+   */
+  bool IsEqual (const VlcPhyColorFunction &other) const;
+
+  /**
+   * \return the default colour function shared by all PHYs
+   */
+  static Ptr<const VlcPhyColorFunction> GetDefault (void);
+
+private:
+  uint32_t m_entries[256][3]; //!< the entries
+};
+
 typedef struct
 {
   uint8_t phyCurrentChannel;
@@ -115,7 +233,7 @@ typedef struct
   double phyCCAMode;
   uint32_t phyDim;
   uint8_t phyUseExtendedMode;
-  uint32_t phyColorFunction[256][3];
+  Ptr<const VlcPhyColorFunction> phyColorFunction;
   uint32_t phyBlinkingNotificationFrequency;
 
 } VlcPhyPibAttributes;
@@ -199,6 +317,53 @@ public:
 
  void SetTxPowerSpectralDensity (Ptr<SpectrumValue> txPsd);
 
+ /**
+  * Get the transmit power spectral density.
+  *
+  * \return the transmit power spectral density
+  */
+ Ptr<const SpectrumValue> GetTxPowerSpectralDensity (void) const;
+
+ /**
+  * Get the power spectral density of the frames at the dimming level.
+  * The transmit power spectral density is the one of an undimmed frame,
+  * and scales with the average optical power.
+  *
+  * \return the power spectral density of the frames
+  */
+ Ptr<SpectrumValue> GetDimmedTxPowerSpectralDensity (void) const;
+
+ /**
+  * Set the transmit power, emitted in the colour band of the current
+  * channel. This replaces the transmit power spectral density.
+  *
+  * \param txPower the optical transmit power in dBm
+  */
+ void SetTxPower (double txPower);
+
+ /**
+  * Get the transmit power.
+  *
+  * \return the optical transmit power in dBm
+  */
+ double GetTxPower (void) const;
+
+ /**
+  * Set the gain of the optical filter of the receiver in the colour bands
+  * next to the band of the current channel.
+  *
+  * \param gain the linear gain, 0 for an ideal filter
+  */
+ void SetAdjacentBandGain (double gain);
+
+ /**
+  * Get the gain of the optical filter of the receiver in the colour bands
+  * next to the band of the current channel.
+  *
+  * \return the linear gain
+  */
+ double GetAdjacentBandGain (void) const;
+
  void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
  Ptr<const SpectrumValue> GetNoisePowerSpectralDensity (void);
@@ -239,30 +404,202 @@ public:
 
  double GetDataOrSymbolRate (bool isData);
 
+ /**
+  * Set the modulation and coding scheme of frames without a VlcMcsTag.
+  *
+  * \param mcs the modulation and coding scheme
+  */
+ void SetMcs (VlcPhyMcs mcs);
+
+ /**
+  * \return the modulation and coding scheme of frames without a VlcMcsTag
+  */
+ VlcPhyMcs GetMcs (void) const;
+
+ /**
+  * Get the parameters of a modulation and coding scheme.
+  *
+  * \param mcs the modulation and coding scheme
+  * \return the parameters
+  */
+ static const VlcPhyMcsParameters& GetMcsParameters (VlcPhyMcs mcs);
+
+ /**
+  * Get the airtime of a PPDU, from the precomputed table of the modulation
+  * and coding scheme.
+  *
+  * \param mcs the modulation and coding scheme
+  * \param psduSize the size of the PSDU in octets
+  * \return the duration of the PPDU, including the SHR and the PHR
+  */
+ static Time GetPpduDuration (VlcPhyMcs mcs, uint32_t psduSize);
+
+ /**
+  * Get the airtime of a PPDU sent at a dimming level.
+  *
+  * OOK keeps the data at a 50% duty cycle and reaches the dimming level d
+  * with compensation symbols, which leave 2 min (d, 1 - d) of the PSDU
+  * airtime to the data. VPPM changes the pulse width instead, at the same
+  * data rate. The SHR and the PHR are not dimmed.
+  *
+  * \param mcs the modulation and coding scheme
+  * \param psduSize the size of the PSDU in octets
+  * \param dimmingLevel the dimming level, see GetDimmingLevel
+  * \return the duration of the PPDU, including the SHR and the PHR
+  */
+ static Time GetPpduDuration (VlcPhyMcs mcs, uint32_t psduSize, double dimmingLevel);
+
+ /**
+  * Get the share of the data rate of a modulation and coding scheme that is
+  * left at a dimming level.
+  *
+  * \param mcs the modulation and coding scheme
+  * \param dimmingLevel the dimming level, see GetDimmingLevel
+  * \return the effective data rate relative to the data rate of the scheme
+  */
+ static double GetDimmingRateFactor (VlcPhyMcs mcs, double dimmingLevel);
+
+ /**
+  * Get the power of the frames at a dimming level, relative to the power
+  * of an undimmed frame. The average optical power, and so the power
+  * spectral density, scales with the dimming level.
+  *
+  * \param dimmingLevel the dimming level, see GetDimmingLevel
+  * \return the power relative to the transmit power spectral density
+  */
+ static double GetDimmingPowerFactor (double dimmingLevel);
+
+ /**
+  * Get the dimming level of the light source, set by the phyDim PIB
+  * attribute in steps of 0.1% of the peak power. A phyDim of 0 leaves the
+  * light source undimmed, at the 50% duty cycle of OOK and VPPM.
+  *
+  * \return the average optical power of a frame relative to the peak power
+  */
+ double GetDimmingLevel (void) const;
+
+ /**
+  * Get the dimming level of the frame currently or last received, as
+  * carried by its signal parameters.
+  *
+  * \return the dimming level of the transmitter of the frame
+  */
+ double GetRxDimmingLevel (void) const;
+
  void SetErrorModel (Ptr<VlcErrorModel> e);
 
  Ptr<VlcErrorModel> GetErrorModel (void) const;
 
  uint64_t GetPhySHRDuration (void) const;
 
+ /**
+  * Get the duration of the PHR and its HCS.
+  *
+  * \return the duration in optical clock periods
+  */
+ uint64_t GetPhyPhrDuration (void) const;
+
  double GetPhySymbolsPerOctet (void) const;
 
+ /**
+  * Get the largest PSDU accepted by PdDataRequest.
+  *
+  * \return the maximum PSDU size in octets
+  */
+ uint32_t GetMaxPsduSize (void) const;
+
+ /**
+  * Get the received power of the last frame the PHY synchronized to, e.g.
+  * of the frame just handed to the MAC.
+  *
+  * \return the average power in W over the current channel
+  */
+ double GetRxPower (void) const;
+
+ /**
+  * Set the noise model of the receiver. Without a noise model, the SINR of
+  * a frame only accounts for the interference.
+  *
+  * \param noiseModel the noise model, or 0
+  */
+ void SetNoiseModel (Ptr<VlcReceiverNoiseModel> noiseModel);
+
+ /**
+  * Get the noise model of the receiver.
+  *
+  * \return the noise model, or 0
+  */
+ Ptr<VlcReceiverNoiseModel> GetNoiseModel (void) const;
+
+ /**
+  * Get the probability that a frame received alone is decoded.
+  *
+  * This is the outcome of the receive path when no other signal overlaps
+  * the frame: the frame is dropped below -5 dB SINR, and otherwise decoded
+  * with the success rate of the error model over the whole PPDU, so the
+  * number of successes of n such frames has the same binomial distribution
+  * as the one of the simulated frames.  No event is scheduled.
+  *
+  * \param rxPsd the received power spectral density
+  * \param psduSize the size of the PSDU in octets
+  * \param mcs the modulation and coding scheme of the frame
+  * \return the packet success rate
+  */
+ double GetPacketSuccessRate (Ptr<const SpectrumValue> rxPsd, uint32_t psduSize, VlcPhyMcs mcs);
+
+ /**
+  * Get the probability that a frame received alone is decoded, for a frame
+  * sent at a dimming level.
+  *
+  * \param rxPsd the received power spectral density, at the dimming level
+  * \param psduSize the size of the PSDU in octets
+  * \param mcs the modulation and coding scheme of the frame
+  * \param dimmingLevel the dimming level of the transmitter
+  * \return the packet success rate
+  */
+ double GetPacketSuccessRate (Ptr<const SpectrumValue> rxPsd, uint32_t psduSize, VlcPhyMcs mcs,
+                              double dimmingLevel);
+
  int64_t AssignStreams (int64_t stream);
 
+ /**
+  * Switch the transceiver off until ResumeFromOff, e.g. when the energy
+  * source of the device is depleted. A frame on air is finished first.
+  * The transceiver state requests in the off mode are not confirmed, the
+  * last one is carried out by ResumeFromOff.
+  */
+ void SetOffMode (void);
+
+ /**
+  * Leave the off mode.
+  */
+ void ResumeFromOff (void);
+
+ /**
+  * \return true, if the transceiver is in the off mode
+  */
+ bool IsOff (void) const;
+
+ /**
+  * \return the current transceiver state
+  */
+ VlcPhyEnumeration GetTrxState (void) const;
+
  typedef void (* StateTracedCallback)
    (Time time, VlcPhyEnumeration oldState, VlcPhyEnumeration newState);
 
 protected:
  /**
-  * The data and symbol rates for the different PHY options.
-  * See Table 2 in section 6.1.2 IEEE 802.15.4-2006
+  * The modulation and coding schemes, indexed by VlcPhyMcs.
+  * See Table 73, Table 74 and Table 75 in section 11 IEEE 802.15.7-2011
   */
- static const VlcPhyDataAndSymbolRates dataSymbolRates[2];
+ static const VlcPhyMcsParameters mcsParameters[IEEE_802_15_7_INVALID_MCS];
  /**
-  * The preamble, SFD, and PHR lengths in symbols for the different PHY options.
-  * See Table 19 and Table 20 in section 6.3 IEEE 802.15.4-2006
+  * The preamble and PHR lengths in optical clock periods, the same for all
+  * modulation and coding schemes.
+  * See section 10.6 IEEE 802.15.7-2011
   */
- static const VlcPhyPpduHeaderSymbolNumber ppduHeaderSymbolNumbers[2];
+ static const VlcPhyPpduHeaderSymbolNumber ppduHeaderSymbolNumbers;
 
 private:
  /**
@@ -281,8 +618,8 @@ private:
  void ChangeTrxState (VlcPhyEnumeration newState);
 
  /**
-  * Configure the PHY option according to the current channel and channel page.
-  * See IEEE 802.15.4-2006, section 6.1.2, Table 2.
+  * Configure the PHY option according to the current modulation and coding
+  * scheme.
   */
  void SetMyPhyOption (void);
 
@@ -294,6 +631,35 @@ private:
   */
  VlcPhyOption GetMyPhyOption (void);
 
+ /**
+  * Configure an error model for the modulation and the FEC of a modulation
+  * and coding scheme, and the dimming level of the frames.
+  *
+  * \param errorModel the error model, or 0
+  * \param mcs the modulation and coding scheme
+  * \param dimmingLevel the dimming level of the frames
+  */
+ static void ConfigureErrorModel (Ptr<VlcErrorModel> errorModel, VlcPhyMcs mcs, double dimmingLevel);
+
+ /**
+  * Calculate the SINR of a signal on the current channel, against the
+  * other signals and the receiver noise.
+  *
+  * \param psd the power spectral density of the signal
+  * \return the SINR
+  */
+ double CalculateSinr (Ptr<const SpectrumValue> psd) const;
+
+ /**
+  * Calculate the SINR of a signal, adding the receiver noise to the given
+  * interference.
+  *
+  * \param signal the power of the signal in W
+  * \param interference the power of the other signals in W
+  * \return the SINR
+  */
+ double CalculateSinr (double signal, double interference) const;
+
  void EndTx (void);
 
  void CheckInterference (void);
@@ -308,6 +674,12 @@ private:
 
  void EndSetTRXState (void);
 
+ /**
+  * Carry out the transceiver state change pending on the end of a frame,
+  * unless the transceiver is in the off mode.
+  */
+ void ApplyPendingTrxState (void);
+
  Time CalculateTxTime (Ptr<const Packet> packet);
 
  Time GetPpduHeaderTxTime (void);
@@ -337,6 +709,12 @@ private:
 
  TracedCallback<Time, VlcPhyEnumeration, VlcPhyEnumeration> m_trxStateLogger;
 
+ /**
+  * The trace source fired when phyDim changes the dimming level, with the
+  * old and the new level.
+  */
+ TracedCallback<double, double> m_dimmingLevelTrace;
+
  /**
   * The mobility model used by the PHY.
   */
@@ -364,16 +742,21 @@ private:
  Ptr<SpectrumValue> m_txPsd;
 
  /**
-  * The spectral density for for the noise.
+  * The noise model of the receiver.
   */
-  // TODO : Check
-// Ptr<const SpectrumValue> m_noise;
+ Ptr<VlcReceiverNoiseModel> m_noiseModel;
 
  /**
   * The error model describing the bit and packet error rates.
   */
  Ptr<VlcErrorModel> m_errorModel;
 
+ /**
+  * The error model of GetPacketSuccessRate, configured for the queried
+  * frames so that the one of the frame received is left alone.
+  */
+ Ptr<VlcErrorModel> m_psrErrorModel;
+
  /**
   * The current PHY PIB attributes.
   */
@@ -383,6 +766,17 @@ private:
 
  VlcPhyEnumeration m_trxStatePending;
 
+ /**
+  * Whether the transceiver is in the off mode.
+  */
+ bool m_off;
+
+ /**
+  * The last transceiver state request in the off mode,
+  * IEEE_802_15_7_PHY_IDLE if none.
+  */
+ VlcPhyEnumeration m_offRequest;
+
  PdDataIndicationCallback m_pdDataIndicationCallback;
 
  PdDataConfirmCallback m_pdDataConfirmCallback;
@@ -404,6 +798,26 @@ private:
   */
  VlcPhyOption m_phyOption;
 
+ /**
+  * The modulation and coding scheme of frames without a VlcMcsTag.
+  */
+ VlcPhyMcs m_mcs;
+
+ /**
+  * The modulation and coding scheme of the frame currently received.
+  */
+ VlcPhyMcs m_rxMcs;
+
+ /**
+  * The dimming level of the frame currently received.
+  */
+ double m_rxDimmingLevel;
+
+ /**
+  * The received power of the frame currently received, in W.
+  */
+ double m_rxPower;
+
  /**
   * Helper value for tracking the average power during ED.
   */
@@ -420,6 +834,27 @@ private:
   */
  double m_rxSensitivity;
 
+ /**
+  * The largest PSDU accepted for transmission, in octets.
+  */
+ uint32_t m_maxPsduSize;
+
+ /**
+  * The optical transmit power in dBm.
+  */
+ double m_txPower;
+
+ /**
+  * The gain of the optical filter in the neighbouring colour bands.
+  */
+ double m_adjacentBandGain;
+
+ /**
+  * The power response of the optical filter of the receiver, tuned to the
+  * current channel.
+  */
+ Ptr<SpectrumValue> m_rxFilter;
+
  /**
   * The accumulated signals currently received by the transceiver, including
   * the signal of a possibly received packet, as well as all signals
@@ -0,0 +1,288 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-radio-energy-model.h"
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/simulator.h>
+#include <ns3/energy-source.h>
+#include <ns3/packet.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcRadioEnergyModel");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcRadioEnergyModel);
+
+TypeId
+VlcRadioEnergyModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcRadioEnergyModel")
+    .SetParent<DeviceEnergyModel> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcRadioEnergyModel> ()
+    .AddAttribute ("SleepCurrentA",
+                   "The current in A drawn with the transceiver off.",
+                   DoubleValue (0.000001),
+                   MakeDoubleAccessor (&VlcRadioEnergyModel::m_sleepCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("RxCurrentA",
+                   "The current in A of the photodiode and its transimpedance "
+                   "amplifier while the receiver is on.",
+                   DoubleValue (0.005),
+                   MakeDoubleAccessor (&VlcRadioEnergyModel::m_rxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("TxCurrentA",
+                   "The current in A of the LED driver electronics while the "
+                   "transmitter is on, without the LED.",
+                   DoubleValue (0.005),
+                   MakeDoubleAccessor (&VlcRadioEnergyModel::m_txCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("LedCurrentA",
+                   "The forward current in A of the LED while it is on.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&VlcRadioEnergyModel::m_ledCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Illumination",
+                   "Whether the LED lights at the dimming level whenever the "
+                   "transceiver is on, as a luminaire does.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&VlcRadioEnergyModel::m_illumination),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("TotalEnergyConsumption",
+                     "The energy consumed by the transceiver in J.",
+                     MakeTraceSourceAccessor (&VlcRadioEnergyModel::m_totalEnergyConsumption),
+                     "ns3::TracedValueCallback::Double")
+  ;
+  return tid;
+}
+
+VlcRadioEnergyModel::VlcRadioEnergyModel (void)
+  : m_sleepCurrentA (0.000001),
+    m_rxCurrentA (0.005),
+    m_txCurrentA (0.005),
+    m_ledCurrentA (0.1),
+    m_illumination (false),
+    m_currentState (IEEE_802_15_7_PHY_TRX_OFF),
+    m_txDimmingLevel (0.5),
+    m_currentA (0),
+    m_depleted (false),
+    m_lastUpdateTime (Seconds (0))
+{
+  NS_LOG_FUNCTION (this);
+  m_currentA = m_sleepCurrentA;
+}
+
+VlcRadioEnergyModel::~VlcRadioEnergyModel (void)
+{
+}
+
+void
+VlcRadioEnergyModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_source = 0;
+  m_phy = 0;
+  m_energyDepletionCallback.Nullify ();
+  m_energyRechargedCallback.Nullify ();
+  DeviceEnergyModel::DoDispose ();
+}
+
+void
+VlcRadioEnergyModel::SetPhy (Ptr<VlcPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  NS_ASSERT (phy != 0);
+
+  m_phy = phy;
+  m_phy->TraceConnectWithoutContext ("TrxState", MakeCallback (&VlcRadioEnergyModel::NotifyTrxState, this));
+  m_phy->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcRadioEnergyModel::NotifyTxBegin, this));
+  m_phy->TraceConnectWithoutContext ("DimmingLevel", MakeCallback (&VlcRadioEnergyModel::NotifyDimmingLevel, this));
+  m_txDimmingLevel = m_phy->GetDimmingLevel ();
+  ChangeState (m_phy->GetTrxState ());
+}
+
+void
+VlcRadioEnergyModel::SetEnergySource (Ptr<EnergySource> source)
+{
+  NS_LOG_FUNCTION (this << source);
+  NS_ASSERT (source != 0);
+  m_source = source;
+  m_lastUpdateTime = Simulator::Now ();
+}
+
+double
+VlcRadioEnergyModel::GetTotalEnergyConsumption (void) const
+{
+  if (m_source == 0)
+    {
+      return m_totalEnergyConsumption;
+    }
+  Time duration = Simulator::Now () - m_lastUpdateTime;
+  return m_totalEnergyConsumption + DoGetCurrentA () * m_source->GetSupplyVoltage () * duration.GetSeconds ();
+}
+
+void
+VlcRadioEnergyModel::ChangeState (int newState)
+{
+  NS_LOG_FUNCTION (this << newState);
+
+  if (m_source != 0)
+    {
+      Time duration = Simulator::Now () - m_lastUpdateTime;
+      NS_ASSERT (!duration.IsStrictlyNegative ());
+      m_totalEnergyConsumption += DoGetCurrentA () * m_source->GetSupplyVoltage () * duration.GetSeconds ();
+      m_lastUpdateTime = Simulator::Now ();
+      // The source accounts the time elapsed at the current of the previous
+      // state.
+      m_source->UpdateEnergySource ();
+    }
+
+  m_currentState = static_cast<VlcPhyEnumeration> (newState);
+  m_currentA = GetStateCurrentA (m_currentState, m_txDimmingLevel);
+  NS_LOG_DEBUG ("State " << m_currentState << ", current " << m_currentA << " A, total "
+                << m_totalEnergyConsumption << " J");
+}
+
+VlcPhyEnumeration
+VlcRadioEnergyModel::GetCurrentState (void) const
+{
+  return m_currentState;
+}
+
+void
+VlcRadioEnergyModel::SetEnergyDepletionCallback (VlcRadioEnergyDepletionCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyDepletionCallback = callback;
+}
+
+void
+VlcRadioEnergyModel::SetEnergyRechargedCallback (VlcRadioEnergyRechargedCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyRechargedCallback = callback;
+}
+
+void
+VlcRadioEnergyModel::HandleEnergyDepletion (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // The energy up to now is drawn at the current of the state, none after.
+  m_totalEnergyConsumption = GetTotalEnergyConsumption ();
+  m_lastUpdateTime = Simulator::Now ();
+  m_depleted = true;
+  // The callback may change the transceiver state, it runs once the source
+  // has finished its update.
+  if (!m_energyDepletionCallback.IsNull ())
+    {
+      Simulator::ScheduleNow (&VlcRadioEnergyModel::InvokeDepletionCallback, this);
+    }
+}
+
+void
+VlcRadioEnergyModel::HandleEnergyRecharged (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_lastUpdateTime = Simulator::Now ();
+  m_depleted = false;
+  if (!m_energyRechargedCallback.IsNull ())
+    {
+      Simulator::ScheduleNow (&VlcRadioEnergyModel::InvokeRechargedCallback, this);
+    }
+}
+
+void
+VlcRadioEnergyModel::InvokeDepletionCallback (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyDepletionCallback ();
+}
+
+void
+VlcRadioEnergyModel::InvokeRechargedCallback (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyRechargedCallback ();
+}
+
+void
+VlcRadioEnergyModel::HandleEnergyChanged (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+double
+VlcRadioEnergyModel::GetStateCurrentA (VlcPhyEnumeration state, double txDimmingLevel) const
+{
+  double illumination = 0;
+  if (m_illumination && m_phy != 0)
+    {
+      illumination = m_ledCurrentA * m_phy->GetDimmingLevel ();
+    }
+  switch (state)
+    {
+    case IEEE_802_15_7_PHY_TRX_OFF:
+    case IEEE_802_15_7_PHY_FORCE_TRX_OFF:
+      return m_sleepCurrentA;
+    case IEEE_802_15_7_PHY_RX_ON:
+    case IEEE_802_15_7_PHY_BUSY_RX:
+      return m_rxCurrentA + illumination;
+    case IEEE_802_15_7_PHY_TX_ON:
+      return m_txCurrentA + illumination;
+    case IEEE_802_15_7_PHY_BUSY_TX:
+      return m_txCurrentA + m_ledCurrentA * txDimmingLevel;
+    default:
+      NS_FATAL_ERROR ("VlcRadioEnergyModel: undefined transceiver state " << state);
+    }
+  return 0;
+}
+
+double
+VlcRadioEnergyModel::DoGetCurrentA (void) const
+{
+  return m_depleted ? 0 : m_currentA;
+}
+
+void
+VlcRadioEnergyModel::NotifyTrxState (Time time, VlcPhyEnumeration oldState, VlcPhyEnumeration newState)
+{
+  ChangeState (newState);
+}
+
+void
+VlcRadioEnergyModel::NotifyTxBegin (Ptr<const Packet> p)
+{
+  // PhyTxBegin fires before the transceiver enters BUSY_TX.
+  m_txDimmingLevel = m_phy->GetDimmingLevel ();
+}
+
+void
+VlcRadioEnergyModel::NotifyDimmingLevel (double oldLevel, double newLevel)
+{
+  NS_LOG_FUNCTION (this << oldLevel << newLevel);
+  // Account the energy at the old level before the current changes.
+  if (m_illumination)
+    {
+      ChangeState (m_currentState);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,186 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_RADIO_ENERGY_MODEL_H
+#define VLC_RADIO_ENERGY_MODEL_H
+
+#include <ns3/device-energy-model.h>
+#include <ns3/traced-value.h>
+#include <ns3/nstime.h>
+#include <ns3/vlc-phy.h>
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup vlc
+ *
+ * Energy consumption of a VLC transceiver, driven by the transceiver state
+ * of its VlcPhy.
+ *
+ * The photodiode and its transimpedance amplifier draw RxCurrentA while the
+ * receiver is on, the LED driver electronics TxCurrentA while the
+ * transmitter is on and the power is cut in the TRX_OFF state, where only
+ * SleepCurrentA remains. During a frame the LED draws LedCurrentA for the
+ * fraction of the time it is on, the dimming level of the PHY when the
+ * frame started: the pulse width of VPPM, and the share of the on time of
+ * OOK with its compensation symbols. With Illumination, the LED also lights
+ * at the current dimming level of the PHY whenever the transceiver is on.
+ *
+ * When the energy source is depleted, the device draws no current and the
+ * depletion callback is invoked, which VlcRadioEnergyModelHelper sets to
+ * VlcPhy::SetOffMode by default.
+ */
+class VlcRadioEnergyModel : public DeviceEnergyModel
+{
+public:
+  /**
+   * Callback type for energy depletion handling.
+   */
+  typedef Callback<void> VlcRadioEnergyDepletionCallback;
+
+  /**
+   * Callback type for energy recharged handling.
+   */
+  typedef Callback<void> VlcRadioEnergyRechargedCallback;
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcRadioEnergyModel (void);
+  virtual ~VlcRadioEnergyModel (void);
+
+  /**
+   * Follow the transceiver state and the frames of a PHY.
+   *
+   * \param phy the PHY
+   */
+  void SetPhy (Ptr<VlcPhy> phy);
+
+  /**
+   * \param source the energy source of the device
+   */
+  virtual void SetEnergySource (Ptr<EnergySource> source);
+
+  /**
+   * \return the energy consumed by the transceiver in J
+   */
+  virtual double GetTotalEnergyConsumption (void) const;
+
+  /**
+   * Account the energy of the previous state and enter a new one.
+   *
+   * \param newState the new transceiver state, a VlcPhyEnumeration
+   */
+  virtual void ChangeState (int newState);
+
+  /**
+   * \return the current transceiver state
+   */
+  VlcPhyEnumeration GetCurrentState (void) const;
+
+  /**
+   * \param callback the callback invoked when the energy source is depleted
+   */
+  void SetEnergyDepletionCallback (VlcRadioEnergyDepletionCallback callback);
+
+  /**
+   * \param callback the callback invoked when the energy source is recharged
+   */
+  void SetEnergyRechargedCallback (VlcRadioEnergyRechargedCallback callback);
+
+  virtual void HandleEnergyDepletion (void);
+
+  virtual void HandleEnergyRecharged (void);
+
+  virtual void HandleEnergyChanged (void);
+
+  /**
+   * Get the current drawn in a transceiver state.
+   *
+   * \param state the transceiver state
+   * \param txDimmingLevel the dimming level of the frame sent in the
+   * BUSY_TX state, the fraction of the time the LED is on
+   * \return the current in A
+   */
+  double GetStateCurrentA (VlcPhyEnumeration state, double txDimmingLevel) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual double DoGetCurrentA (void) const;
+
+  /**
+   * Follow the transceiver state of the PHY.
+   *
+   * \param time the time of the state change
+   * \param oldState the previous state
+   * \param newState the new state
+   */
+  void NotifyTrxState (Time time, VlcPhyEnumeration oldState, VlcPhyEnumeration newState);
+
+  /**
+   * Record the dimming level of a frame going on air.
+   *
+   * \param p the frame
+   */
+  void NotifyTxBegin (Ptr<const Packet> p);
+
+  /**
+   * Follow the dimming level of the PHY.
+   *
+   * \param oldLevel the previous dimming level
+   * \param newLevel the new dimming level
+   */
+  void NotifyDimmingLevel (double oldLevel, double newLevel);
+
+  /**
+   * Invoke the depletion callback.
+   */
+  void InvokeDepletionCallback (void);
+
+  /**
+   * Invoke the recharged callback.
+   */
+  void InvokeRechargedCallback (void);
+
+  Ptr<EnergySource> m_source;             //!< the energy source of the device
+  Ptr<VlcPhy> m_phy;                      //!< the PHY followed
+  double m_sleepCurrentA;                 //!< the current in TRX_OFF
+  double m_rxCurrentA;                    //!< the current of the photodiode and the TIA
+  double m_txCurrentA;                    //!< the current of the LED driver electronics
+  double m_ledCurrentA;                   //!< the LED current while the LED is on
+  bool m_illumination;                    //!< whether the LED lights when not sending
+  VlcPhyEnumeration m_currentState;       //!< the transceiver state
+  double m_txDimmingLevel;                //!< the dimming level of the frame on air
+  double m_currentA;                      //!< the current drawn in the state
+  bool m_depleted;                        //!< whether the energy source is depleted
+  Time m_lastUpdateTime;                  //!< the time of the last energy update
+  TracedValue<double> m_totalEnergyConsumption; //!< the energy consumed in J
+  VlcRadioEnergyDepletionCallback m_energyDepletionCallback; //!< the depletion callback
+  VlcRadioEnergyRechargedCallback m_energyRechargedCallback; //!< the recharged callback
+};
+
+} // namespace ns3
+
+#endif /* VLC_RADIO_ENERGY_MODEL_H */
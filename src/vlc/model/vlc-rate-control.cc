@@ -0,0 +1,619 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-rate-control.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/enum.h>
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcRateControl");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcRateControl);
+NS_OBJECT_ENSURE_REGISTERED (VlcConstantRateControl);
+NS_OBJECT_ENSURE_REGISTERED (VlcArfRateControl);
+NS_OBJECT_ENSURE_REGISTERED (VlcMinstrelRateControl);
+
+namespace {
+
+/**
+ * Order schemes by increasing data rate.
+ *
+ * \param a a scheme
+ * \param b another scheme
+ * \return true if a is slower than b
+ */
+bool
+CompareBitRate (VlcPhyMcs a, VlcPhyMcs b)
+{
+  return VlcPhy::GetMcsParameters (a).bitRate < VlcPhy::GetMcsParameters (b).bitRate;
+}
+
+} // anonymous namespace
+
+TypeId
+VlcRateControl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcRateControl")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddAttribute ("WqiWeight",
+                   "The weight of a new WQI sample in the average WQI of a station.",
+                   DoubleValue (0.25),
+                   MakeDoubleAccessor (&VlcRateControl::m_wqiWeight),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddTraceSource ("TxMcs",
+                     "The modulation and coding scheme selected for a data frame",
+                     MakeTraceSourceAccessor (&VlcRateControl::m_txMcsTrace),
+                     "ns3::VlcRateControl::McsTracedCallback")
+    .AddTraceSource ("TxResult",
+                     "The outcome of a transmission attempt",
+                     MakeTraceSourceAccessor (&VlcRateControl::m_txResultTrace),
+                     "ns3::VlcRateControl::TxResultTracedCallback")
+  ;
+  return tid;
+}
+
+VlcRateControl::VlcRateControl (void)
+  : m_wqiWeight (0.25),
+    m_attempts (IEEE_802_15_7_INVALID_MCS, 0),
+    m_successes (IEEE_802_15_7_INVALID_MCS, 0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcRateControl::~VlcRateControl (void)
+{
+}
+
+void
+VlcRateControl::DoDispose (void)
+{
+  m_phy = 0;
+  Object::DoDispose ();
+}
+
+void
+VlcRateControl::SetupPhy (Ptr<VlcPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  m_phy = phy;
+  if (!m_mcsSet.empty ())
+    {
+      return;
+    }
+  const VlcPhyMcsParameters &base = VlcPhy::GetMcsParameters (phy->GetMcs ());
+  std::vector<VlcPhyMcs> mcsSet;
+  for (uint32_t i = 0; i < IEEE_802_15_7_INVALID_MCS; i++)
+    {
+      const VlcPhyMcsParameters &params = VlcPhy::GetMcsParameters (VlcPhyMcs (i));
+      if (params.phyType == base.phyType && params.phyOption == base.phyOption)
+        {
+          mcsSet.push_back (VlcPhyMcs (i));
+        }
+    }
+  SetMcsSet (mcsSet);
+}
+
+void
+VlcRateControl::SetMcsSet (const std::vector<VlcPhyMcs> &mcsSet)
+{
+  NS_LOG_FUNCTION (this);
+  m_mcsSet = mcsSet;
+  std::stable_sort (m_mcsSet.begin (), m_mcsSet.end (), CompareBitRate);
+}
+
+uint32_t
+VlcRateControl::GetNMcs (void) const
+{
+  return m_mcsSet.size ();
+}
+
+VlcPhyMcs
+VlcRateControl::GetMcs (uint32_t i) const
+{
+  NS_ASSERT (i < m_mcsSet.size ());
+  return m_mcsSet[i];
+}
+
+uint32_t
+VlcRateControl::GetIndex (VlcPhyMcs mcs) const
+{
+  std::vector<VlcPhyMcs>::const_iterator it = std::find (m_mcsSet.begin (), m_mcsSet.end (), mcs);
+  return it - m_mcsSet.begin ();
+}
+
+Time
+VlcRateControl::GetPpduDuration (VlcPhyMcs mcs, uint32_t size) const
+{
+  double dimmingLevel = m_phy != 0 ? m_phy->GetDimmingLevel () : 0.5;
+  return VlcPhy::GetPpduDuration (mcs, size, dimmingLevel);
+}
+
+VlcPhyMcs
+VlcRateControl::GetDataMcs (const Address &station, uint32_t size, uint32_t retry)
+{
+  NS_LOG_FUNCTION (this << station << size << retry);
+  NS_ASSERT_MSG (!m_mcsSet.empty (), "No candidate schemes");
+  uint32_t index = DoGetDataMcs (station, size, retry);
+  NS_ASSERT (index < m_mcsSet.size ());
+  VlcPhyMcs mcs = m_mcsSet[index];
+  m_txMcsTrace (station, mcs);
+  return mcs;
+}
+
+void
+VlcRateControl::ReportDataOk (const Address &station, VlcPhyMcs mcs)
+{
+  NS_LOG_FUNCTION (this << station << mcs);
+  m_attempts[mcs]++;
+  m_successes[mcs]++;
+  m_txResultTrace (station, mcs, true);
+  DoReportDataOk (station, GetIndex (mcs));
+}
+
+void
+VlcRateControl::ReportDataFailed (const Address &station, VlcPhyMcs mcs)
+{
+  NS_LOG_FUNCTION (this << station << mcs);
+  m_attempts[mcs]++;
+  m_txResultTrace (station, mcs, false);
+  DoReportDataFailed (station, GetIndex (mcs));
+}
+
+void
+VlcRateControl::ReportFinalDataFailed (const Address &station)
+{
+  NS_LOG_FUNCTION (this << station);
+  DoReportFinalDataFailed (station);
+}
+
+void
+VlcRateControl::ReportRxWqi (const Address &station, uint8_t wqi)
+{
+  NS_LOG_FUNCTION (this << station << (uint32_t) wqi);
+  std::map<Address, double>::iterator it = m_meanWqi.find (station);
+  if (it == m_meanWqi.end ())
+    {
+      m_meanWqi[station] = wqi;
+    }
+  else
+    {
+      it->second = (1 - m_wqiWeight) * it->second + m_wqiWeight * wqi;
+    }
+}
+
+double
+VlcRateControl::GetMeanWqi (const Address &station) const
+{
+  std::map<Address, double>::const_iterator it = m_meanWqi.find (station);
+  if (it == m_meanWqi.end ())
+    {
+      return 255;
+    }
+  return it->second;
+}
+
+uint32_t
+VlcRateControl::GetAttempts (VlcPhyMcs mcs) const
+{
+  return m_attempts[mcs];
+}
+
+uint32_t
+VlcRateControl::GetSuccesses (VlcPhyMcs mcs) const
+{
+  return m_successes[mcs];
+}
+
+int64_t
+VlcRateControl::AssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+void
+VlcRateControl::DoReportDataOk (const Address &station, uint32_t index)
+{
+}
+
+void
+VlcRateControl::DoReportDataFailed (const Address &station, uint32_t index)
+{
+}
+
+void
+VlcRateControl::DoReportFinalDataFailed (const Address &station)
+{
+}
+
+TypeId
+VlcConstantRateControl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcConstantRateControl")
+    .SetParent<VlcRateControl> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcConstantRateControl> ()
+    .AddAttribute ("DataMcs",
+                   "The modulation and coding scheme of all data frames.",
+                   EnumValue (IEEE_802_15_7_PHY_II_OOK_6_MBPS),
+                   MakeEnumAccessor (&VlcConstantRateControl::SetConstantMcs,
+                                     &VlcConstantRateControl::GetConstantMcs),
+                   MakeVlcPhyMcsChecker ())
+  ;
+  return tid;
+}
+
+VlcConstantRateControl::VlcConstantRateControl (void)
+  : m_dataMcs (IEEE_802_15_7_PHY_II_OOK_6_MBPS)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcConstantRateControl::~VlcConstantRateControl (void)
+{
+}
+
+void
+VlcConstantRateControl::SetConstantMcs (VlcPhyMcs mcs)
+{
+  NS_LOG_FUNCTION (this << mcs);
+  m_dataMcs = mcs;
+  SetMcsSet (std::vector<VlcPhyMcs> (1, mcs));
+}
+
+VlcPhyMcs
+VlcConstantRateControl::GetConstantMcs (void) const
+{
+  return m_dataMcs;
+}
+
+uint32_t
+VlcConstantRateControl::DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry)
+{
+  return 0;
+}
+
+TypeId
+VlcArfRateControl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcArfRateControl")
+    .SetParent<VlcRateControl> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcArfRateControl> ()
+    .AddAttribute ("SuccessThreshold",
+                   "The number of consecutive acknowledged attempts before probing a faster scheme.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&VlcArfRateControl::m_successThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("TimerThreshold",
+                   "The number of attempts at a scheme before probing a faster one.",
+                   UintegerValue (15),
+                   MakeUintegerAccessor (&VlcArfRateControl::m_timerThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxSuccessThreshold",
+                   "The largest success threshold of AARF.",
+                   UintegerValue (60),
+                   MakeUintegerAccessor (&VlcArfRateControl::m_maxSuccessThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Adaptive",
+                   "Double the success threshold after a failed probe (AARF).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&VlcArfRateControl::m_adaptive),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MinWqi",
+                   "The average WQI of the destination required for probing a faster scheme.",
+                   UintegerValue (200),
+                   MakeUintegerAccessor (&VlcArfRateControl::m_minWqi),
+                   MakeUintegerChecker<uint8_t> ())
+  ;
+  return tid;
+}
+
+VlcArfRateControl::VlcArfRateControl (void)
+  : m_successThreshold (10),
+    m_timerThreshold (15),
+    m_maxSuccessThreshold (60),
+    m_adaptive (false),
+    m_minWqi (200)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcArfRateControl::~VlcArfRateControl (void)
+{
+}
+
+VlcArfRateControl::Station&
+VlcArfRateControl::Lookup (const Address &station)
+{
+  std::map<Address, Station>::iterator it = m_stations.find (station);
+  if (it == m_stations.end ())
+    {
+      Station s;
+      s.index = 0;
+      s.success = 0;
+      s.failed = 0;
+      s.timer = 0;
+      s.recovery = false;
+      s.successThreshold = m_successThreshold;
+      s.timerThreshold = m_timerThreshold;
+      it = m_stations.insert (std::make_pair (station, s)).first;
+    }
+  return it->second;
+}
+
+uint32_t
+VlcArfRateControl::DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry)
+{
+  return Lookup (station).index;
+}
+
+void
+VlcArfRateControl::DoReportDataOk (const Address &station, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << station << index);
+  Station &s = Lookup (station);
+  s.timer++;
+  s.success++;
+  s.failed = 0;
+  s.recovery = false;
+  if ((s.success >= s.successThreshold || s.timer >= s.timerThreshold)
+      && s.index + 1 < GetNMcs ()
+      && GetMeanWqi (station) >= m_minWqi)
+    {
+      NS_LOG_DEBUG ("Probe " << GetMcs (s.index + 1) << " for " << station);
+      s.index++;
+      s.success = 0;
+      s.timer = 0;
+      s.recovery = true;
+    }
+}
+
+void
+VlcArfRateControl::DoReportDataFailed (const Address &station, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << station << index);
+  Station &s = Lookup (station);
+  s.timer++;
+  s.failed++;
+  s.success = 0;
+  if (s.recovery)
+    {
+      NS_ASSERT (s.failed >= 1);
+      if (s.failed == 1)
+        {
+          // The probe failed.
+          if (m_adaptive)
+            {
+              s.successThreshold = std::min (s.successThreshold * 2, m_maxSuccessThreshold);
+              s.timerThreshold = s.successThreshold;
+            }
+          if (s.index > 0)
+            {
+              s.index--;
+            }
+          s.timer = 0;
+        }
+      s.recovery = false;
+    }
+  else if (s.failed % 2 == 0)
+    {
+      if (m_adaptive)
+        {
+          s.successThreshold = m_successThreshold;
+          s.timerThreshold = m_timerThreshold;
+        }
+      if (s.index > 0)
+        {
+          s.index--;
+        }
+      s.timer = 0;
+    }
+}
+
+TypeId
+VlcMinstrelRateControl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcMinstrelRateControl")
+    .SetParent<VlcRateControl> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcMinstrelRateControl> ()
+    .AddAttribute ("UpdatePeriod",
+                   "The period of the update of the statistics.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&VlcMinstrelRateControl::m_updatePeriod),
+                   MakeTimeChecker ())
+    .AddAttribute ("LookAroundRate",
+                   "The percentage of the frames sampling another scheme.",
+                   DoubleValue (10),
+                   MakeDoubleAccessor (&VlcMinstrelRateControl::m_lookAroundRate),
+                   MakeDoubleChecker<double> (0, 100))
+    .AddAttribute ("EwmaLevel",
+                   "The weight of the history in the average success rate, in percent.",
+                   DoubleValue (75),
+                   MakeDoubleAccessor (&VlcMinstrelRateControl::m_ewmaLevel),
+                   MakeDoubleChecker<double> (0, 100))
+    .AddAttribute ("PacketSize",
+                   "The PSDU size of the throughput estimate in octets.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&VlcMinstrelRateControl::m_packetSize),
+                   MakeUintegerChecker<uint32_t> (1, 1023))
+  ;
+  return tid;
+}
+
+VlcMinstrelRateControl::VlcMinstrelRateControl (void)
+  : m_updatePeriod (MilliSeconds (100)),
+    m_lookAroundRate (10),
+    m_ewmaLevel (75),
+    m_packetSize (100)
+{
+  NS_LOG_FUNCTION (this);
+  m_random = CreateObject<UniformRandomVariable> ();
+}
+
+VlcMinstrelRateControl::~VlcMinstrelRateControl (void)
+{
+}
+
+int64_t
+VlcMinstrelRateControl::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_random->SetStream (stream);
+  return 1;
+}
+
+VlcMinstrelRateControl::Station&
+VlcMinstrelRateControl::Lookup (const Address &station)
+{
+  std::map<Address, Station>::iterator it = m_stations.find (station);
+  if (it == m_stations.end ())
+    {
+      Station s;
+      RateStats stats;
+      stats.attempts = 0;
+      stats.successes = 0;
+      stats.ewmaProb = 0;
+      stats.sampled = false;
+      stats.throughput = 0;
+      s.rates.assign (GetNMcs (), stats);
+      s.nextUpdate = Simulator::Now () + m_updatePeriod;
+      s.maxTp = 0;
+      s.maxTp2 = 0;
+      s.maxProb = 0;
+      it = m_stations.insert (std::make_pair (station, s)).first;
+    }
+  return it->second;
+}
+
+void
+VlcMinstrelRateControl::UpdateStats (Station &station)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < station.rates.size (); i++)
+    {
+      RateStats &stats = station.rates[i];
+      if (stats.attempts > 0)
+        {
+          double prob = double (stats.successes) / stats.attempts;
+          stats.ewmaProb = stats.sampled
+            ? (prob * (100 - m_ewmaLevel) + stats.ewmaProb * m_ewmaLevel) / 100
+            : prob;
+          stats.sampled = true;
+        }
+      stats.attempts = 0;
+      stats.successes = 0;
+
+      // Below 10 % the scheme is useless, whatever its data rate.
+      stats.throughput = 0;
+      if (stats.ewmaProb >= 0.1)
+        {
+          stats.throughput = stats.ewmaProb * m_packetSize
+            / GetPpduDuration (GetMcs (i), m_packetSize).GetSeconds ();
+        }
+    }
+
+  station.maxTp = 0;
+  station.maxTp2 = 0;
+  station.maxProb = 0;
+  for (uint32_t i = 1; i < station.rates.size (); i++)
+    {
+      if (station.rates[i].throughput > station.rates[station.maxTp].throughput)
+        {
+          station.maxTp2 = station.maxTp;
+          station.maxTp = i;
+        }
+      else if (station.rates[i].throughput > station.rates[station.maxTp2].throughput)
+        {
+          station.maxTp2 = i;
+        }
+      if (station.rates[i].ewmaProb >= station.rates[station.maxProb].ewmaProb)
+        {
+          station.maxProb = i;
+        }
+    }
+  NS_LOG_DEBUG ("Highest throughput " << GetMcs (station.maxTp)
+                << ", second " << GetMcs (station.maxTp2)
+                << ", highest success rate " << GetMcs (station.maxProb));
+}
+
+uint32_t
+VlcMinstrelRateControl::GetMaxThroughputIndex (const Address &station)
+{
+  return Lookup (station).maxTp;
+}
+
+uint32_t
+VlcMinstrelRateControl::DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry)
+{
+  NS_LOG_FUNCTION (this << station << size << retry);
+  Station &s = Lookup (station);
+  if (Simulator::Now () >= s.nextUpdate)
+    {
+      UpdateStats (s);
+      s.nextUpdate = Simulator::Now () + m_updatePeriod;
+    }
+
+  switch (retry)
+    {
+    case 0:
+      if (m_random->GetValue (0, 100) < m_lookAroundRate)
+        {
+          // Sample a random candidate, so that the statistics of the others
+          // follow the link.
+          return m_random->GetInteger (0, GetNMcs () - 1);
+        }
+      return s.maxTp;
+    case 1:
+      return s.maxTp2;
+    case 2:
+      return s.maxProb;
+    default:
+      return 0;
+    }
+}
+
+void
+VlcMinstrelRateControl::DoReportDataOk (const Address &station, uint32_t index)
+{
+  Station &s = Lookup (station);
+  if (index < s.rates.size ())
+    {
+      s.rates[index].attempts++;
+      s.rates[index].successes++;
+    }
+}
+
+void
+VlcMinstrelRateControl::DoReportDataFailed (const Address &station, uint32_t index)
+{
+  Station &s = Lookup (station);
+  if (index < s.rates.size ())
+    {
+      s.rates[index].attempts++;
+    }
+}
+
+} // namespace ns3
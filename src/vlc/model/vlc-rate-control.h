@@ -0,0 +1,436 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_RATE_CONTROL_H
+#define VLC_RATE_CONTROL_H
+
+#include "vlc-phy.h"
+#include <ns3/object.h>
+#include <ns3/address.h>
+#include <ns3/traced-callback.h>
+#include <ns3/nstime.h>
+#include <ns3/random-variable-stream.h>
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * Base class of the link adaptation of VlcMac.
+ *
+ * A rate control picks the modulation and coding scheme of every
+ * acknowledged unicast data frame from a set of candidate schemes, per
+ * destination. It learns from the outcome of each transmission attempt and
+ * from the WQI of the frames received from the destination, mostly its ACKs.
+ * By default the candidates are all schemes of the PHY type and modulation of
+ * the PHY's Mcs attribute.
+ *
+ * The base class keeps the candidate set, a moving average of the WQI per
+ * station and the number of attempts and successes per scheme. Subclasses
+ * implement the selection.
+ */
+class VlcRateControl : public Object
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcRateControl (void);
+  virtual ~VlcRateControl (void);
+
+  /**
+   * TracedCallback signature for the scheme selected for a frame.
+   *
+   * \param [in] station the destination
+   * \param [in] mcs the modulation and coding scheme
+   */
+  typedef void (* McsTracedCallback)(Address station, VlcPhyMcs mcs);
+
+  /**
+   * TracedCallback signature for the outcome of a transmission attempt.
+   *
+   * \param [in] station the destination
+   * \param [in] mcs the modulation and coding scheme of the attempt
+   * \param [in] success whether the attempt has been acknowledged
+   */
+  typedef void (* TxResultTracedCallback)(Address station, VlcPhyMcs mcs, bool success);
+
+  /**
+   * Use all schemes of the PHY type and modulation of the Mcs attribute of
+   * the PHY as candidates, unless a candidate set has been configured. The
+   * airtime estimates follow the dimming level of the PHY.
+   *
+   * \param phy the PHY
+   */
+  void SetupPhy (Ptr<VlcPhy> phy);
+
+  /**
+   * Set the candidate schemes. They are ordered by increasing data rate.
+   *
+   * \param mcsSet the candidate schemes
+   */
+  void SetMcsSet (const std::vector<VlcPhyMcs> &mcsSet);
+
+  /**
+   * \return the number of candidate schemes
+   */
+  uint32_t GetNMcs (void) const;
+
+  /**
+   * \param i the index of the candidate, in order of increasing data rate
+   * \return the candidate scheme
+   */
+  VlcPhyMcs GetMcs (uint32_t i) const;
+
+  /**
+   * Get the airtime of a frame sent with a scheme at the dimming level of
+   * the PHY.
+   *
+   * \param mcs the scheme
+   * \param size the size of the PSDU in octets
+   * \return the duration of the PPDU
+   */
+  Time GetPpduDuration (VlcPhyMcs mcs, uint32_t size) const;
+
+  /**
+   * Select the scheme of a transmission attempt.
+   *
+   * \param station the destination
+   * \param size the size of the PSDU in octets
+   * \param retry the number of previous attempts of the frame
+   * \return the modulation and coding scheme
+   */
+  VlcPhyMcs GetDataMcs (const Address &station, uint32_t size, uint32_t retry);
+
+  /**
+   * Report an acknowledged transmission attempt.
+   *
+   * \param station the destination
+   * \param mcs the scheme of the attempt
+   */
+  void ReportDataOk (const Address &station, VlcPhyMcs mcs);
+
+  /**
+   * Report a transmission attempt that has not been acknowledged.
+   *
+   * \param station the destination
+   * \param mcs the scheme of the attempt
+   */
+  void ReportDataFailed (const Address &station, VlcPhyMcs mcs);
+
+  /**
+   * Report a frame dropped after the last retransmission.
+   *
+   * \param station the destination
+   */
+  void ReportFinalDataFailed (const Address &station);
+
+  /**
+   * Report the WQI of a frame received from a station.
+   *
+   * \param station the source
+   * \param wqi the WQI of the frame
+   */
+  void ReportRxWqi (const Address &station, uint8_t wqi);
+
+  /**
+   * \param station the station
+   * \return the moving average of the WQI of the frames received from the
+   * station, 255 if none has been received
+   */
+  double GetMeanWqi (const Address &station) const;
+
+  /**
+   * \param mcs the modulation and coding scheme
+   * \return the number of transmission attempts with the scheme
+   */
+  uint32_t GetAttempts (VlcPhyMcs mcs) const;
+
+  /**
+   * \param mcs the modulation and coding scheme
+   * \return the number of acknowledged transmission attempts with the scheme
+   */
+  uint32_t GetSuccesses (VlcPhyMcs mcs) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  virtual int64_t AssignStreams (int64_t stream);
+
+private:
+  /**
+   * Select the index of the candidate scheme of a transmission attempt.
+   *
+   * \param station the destination
+   * \param size the size of the PSDU in octets
+   * \param retry the number of previous attempts of the frame
+   * \return the index of the scheme
+   */
+  virtual uint32_t DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry) = 0;
+
+  /**
+   * Learn from an acknowledged transmission attempt.
+   *
+   * \param station the destination
+   * \param index the index of the scheme of the attempt, GetNMcs () if it
+   * is not a candidate
+   */
+  virtual void DoReportDataOk (const Address &station, uint32_t index);
+
+  /**
+   * Learn from a transmission attempt that has not been acknowledged.
+   *
+   * \param station the destination
+   * \param index the index of the scheme of the attempt, GetNMcs () if it
+   * is not a candidate
+   */
+  virtual void DoReportDataFailed (const Address &station, uint32_t index);
+
+  /**
+   * Learn from a frame dropped after the last retransmission.
+   *
+   * \param station the destination
+   */
+  virtual void DoReportFinalDataFailed (const Address &station);
+
+  /**
+   * Get the index of a scheme in the candidate set.
+   *
+   * \param mcs the scheme
+   * \return the index, GetNMcs () if it is not a candidate
+   */
+  uint32_t GetIndex (VlcPhyMcs mcs) const;
+
+  virtual void DoDispose (void);
+
+  Ptr<VlcPhy> m_phy;                          //!< the PHY, for its dimming level
+  std::vector<VlcPhyMcs> m_mcsSet;            //!< the candidate schemes, by increasing data rate
+  std::map<Address, double> m_meanWqi;        //!< the average WQI per station
+  double m_wqiWeight;                         //!< the weight of a new WQI sample in the average
+  std::vector<uint32_t> m_attempts;           //!< the attempts per scheme
+  std::vector<uint32_t> m_successes;          //!< the acknowledged attempts per scheme
+
+  TracedCallback<Address, VlcPhyMcs> m_txMcsTrace;             //!< the selected schemes
+  TracedCallback<Address, VlcPhyMcs, bool> m_txResultTrace;    //!< the outcome of the attempts
+};
+
+/**
+ * \ingroup vlc
+ *
+ * A rate control that always uses the same scheme.
+ */
+class VlcConstantRateControl : public VlcRateControl
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcConstantRateControl (void);
+  virtual ~VlcConstantRateControl (void);
+
+  /**
+   * Set the scheme of all data frames, which becomes the only candidate.
+   *
+   * \param mcs the modulation and coding scheme
+   */
+  void SetConstantMcs (VlcPhyMcs mcs);
+
+  /**
+   * \return the scheme of all data frames
+   */
+  VlcPhyMcs GetConstantMcs (void) const;
+
+private:
+  virtual uint32_t DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry);
+
+  VlcPhyMcs m_dataMcs;    //!< the scheme of all data frames
+};
+
+/**
+ * \ingroup vlc
+ *
+ * Adaptive Rate Fallback, optionally Adaptive ARF (AARF).
+ *
+ * After SuccessThreshold consecutive acknowledged attempts, or TimerThreshold
+ * attempts at the current scheme, the next faster candidate is probed. The
+ * scheme falls back after two consecutive failures, or after the first
+ * failure of a probe. With AARF, a failed probe doubles the number of
+ * successes required for the next probe, up to MaxSuccessThreshold.
+ *
+ * A probe additionally requires the average WQI of the frames received from
+ * the destination to be at least MinWqi: since ACKs are sent at the base
+ * scheme, a degraded WQI shows that the link has no margin for a faster one.
+ *
+ * See M. Lacage, M. H. Manshaei, T. Turletti, "IEEE 802.11 Rate Adaptation:
+ * A Practical Approach", MSWiM 2004.
+ */
+class VlcArfRateControl : public VlcRateControl
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcArfRateControl (void);
+  virtual ~VlcArfRateControl (void);
+
+private:
+  /**
+   * The state of a destination.
+   */
+  struct Station
+  {
+    uint32_t index;              //!< the index of the current scheme
+    uint32_t success;            //!< consecutive acknowledged attempts
+    uint32_t failed;             //!< consecutive failed attempts
+    uint32_t timer;              //!< attempts since the last change of scheme
+    bool recovery;               //!< true, if the last attempt was a probe
+    uint32_t successThreshold;   //!< successes required for a probe
+    uint32_t timerThreshold;     //!< attempts required for a probe
+  };
+
+  /**
+   * Get the state of a destination, creating it at the slowest scheme.
+   *
+   * \param station the destination
+   * \return the state
+   */
+  Station& Lookup (const Address &station);
+
+  virtual uint32_t DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry);
+  virtual void DoReportDataOk (const Address &station, uint32_t index);
+  virtual void DoReportDataFailed (const Address &station, uint32_t index);
+
+  std::map<Address, Station> m_stations;    //!< the state per destination
+  uint32_t m_successThreshold;              //!< initial successes required for a probe
+  uint32_t m_timerThreshold;                //!< initial attempts required for a probe
+  uint32_t m_maxSuccessThreshold;           //!< the largest success threshold of AARF
+  bool m_adaptive;                          //!< true for AARF
+  uint8_t m_minWqi;                         //!< the WQI required for a probe
+};
+
+/**
+ * \ingroup vlc
+ *
+ * A rate control in the spirit of Minstrel, which estimates the throughput of
+ * every candidate scheme from the success rate of the attempts.
+ *
+ * Every UpdatePeriod, the success rate of each scheme in the last period
+ * updates its exponentially weighted moving average, from which the expected
+ * throughput of a PacketSize octet frame follows with the airtime of the
+ * scheme. The first attempt of a frame uses the scheme with the highest
+ * throughput, except for LookAroundRate percent of the frames which sample
+ * another random candidate. Retransmissions go down the chain of the second
+ * highest throughput, the highest success rate and the slowest scheme.
+ *
+ * The WQI is not used: the success rates already measure the data frames.
+ */
+class VlcMinstrelRateControl : public VlcRateControl
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcMinstrelRateControl (void);
+  virtual ~VlcMinstrelRateControl (void);
+
+  virtual int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \param station the destination
+   * \return the index of the scheme with the highest expected throughput
+   */
+  uint32_t GetMaxThroughputIndex (const Address &station);
+
+private:
+  /**
+   * The statistics of a scheme for a destination.
+   */
+  struct RateStats
+  {
+    uint32_t attempts;      //!< attempts in the current period
+    uint32_t successes;     //!< acknowledged attempts in the current period
+    double ewmaProb;        //!< average success rate
+    bool sampled;           //!< true, once the scheme has been attempted
+    double throughput;      //!< expected throughput in octets per second
+  };
+
+  /**
+   * The state of a destination.
+   */
+  struct Station
+  {
+    std::vector<RateStats> rates;   //!< the statistics per candidate
+    Time nextUpdate;                //!< the end of the current period
+    uint32_t maxTp;                 //!< the index with the highest throughput
+    uint32_t maxTp2;                //!< the index with the second highest throughput
+    uint32_t maxProb;               //!< the index with the highest success rate
+  };
+
+  /**
+   * Get the state of a destination, creating it if needed.
+   *
+   * \param station the destination
+   * \return the state
+   */
+  Station& Lookup (const Address &station);
+
+  /**
+   * Update the averages and the retry chain of a destination at the end of a
+   * period.
+   *
+   * \param station the state of the destination
+   */
+  void UpdateStats (Station &station);
+
+  virtual uint32_t DoGetDataMcs (const Address &station, uint32_t size, uint32_t retry);
+  virtual void DoReportDataOk (const Address &station, uint32_t index);
+  virtual void DoReportDataFailed (const Address &station, uint32_t index);
+
+  std::map<Address, Station> m_stations;    //!< the state per destination
+  Time m_updatePeriod;                      //!< the period of the statistics update
+  double m_lookAroundRate;                  //!< the percentage of sampling attempts
+  double m_ewmaLevel;                       //!< the weight of the history in percent
+  uint32_t m_packetSize;                    //!< the frame size of the throughput estimate
+  Ptr<UniformRandomVariable> m_random;      //!< the sampling decisions
+};
+
+} // namespace ns3
+
+#endif /* VLC_RATE_CONTROL_H */
@@ -0,0 +1,215 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-receiver-noise-model.h"
+#include <ns3/log.h>
+#include <ns3/double.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcReceiverNoiseModel");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcReceiverNoiseModel);
+
+/// The elementary charge in C
+static const double ELEMENTARY_CHARGE = 1.602176634e-19;
+/// The Boltzmann constant in J/K
+static const double BOLTZMANN = 1.380649e-23;
+
+TypeId
+VlcReceiverNoiseModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcReceiverNoiseModel")
+    .SetParent<Object> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcReceiverNoiseModel> ()
+    .AddAttribute ("Responsivity",
+                   "The responsivity of the photodiode in A/W.",
+                   DoubleValue (0.54),
+                   MakeDoubleAccessor (&VlcReceiverNoiseModel::SetResponsivity,
+                                       &VlcReceiverNoiseModel::GetResponsivity),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Bandwidth",
+                   "The noise bandwidth of the receiver in Hz.",
+                   DoubleValue (20e6),
+                   MakeDoubleAccessor (&VlcReceiverNoiseModel::SetBandwidth,
+                                       &VlcReceiverNoiseModel::GetBandwidth),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("AmbientPower",
+                   "The optical power of the ambient light received by the photodiode in W.",
+                   DoubleValue (1e-4),
+                   MakeDoubleAccessor (&VlcReceiverNoiseModel::SetAmbientPower,
+                                       &VlcReceiverNoiseModel::GetAmbientPower),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("DarkCurrent",
+                   "The dark current of the photodiode in A.",
+                   DoubleValue (1e-9),
+                   MakeDoubleAccessor (&VlcReceiverNoiseModel::SetDarkCurrent,
+                                       &VlcReceiverNoiseModel::GetDarkCurrent),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Temperature",
+                   "The temperature of the receiver in K.",
+                   DoubleValue (295.0),
+                   MakeDoubleAccessor (&VlcReceiverNoiseModel::SetTemperature,
+                                       &VlcReceiverNoiseModel::GetTemperature),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FeedbackResistance",
+                   "The feedback resistance of the transimpedance amplifier in ohm.",
+                   DoubleValue (10e3),
+                   MakeDoubleAccessor (&VlcReceiverNoiseModel::SetFeedbackResistance,
+                                       &VlcReceiverNoiseModel::GetFeedbackResistance),
+                   MakeDoubleChecker<double> (1e-3))
+  ;
+  return tid;
+}
+
+VlcReceiverNoiseModel::VlcReceiverNoiseModel (void)
+  : m_responsivity (0.54),
+    m_bandwidth (20e6),
+    m_ambientPower (1e-4),
+    m_darkCurrent (1e-9),
+    m_temperature (295.0),
+    m_feedbackResistance (10e3),
+    m_constantVariance (0.0),
+    m_constantVarianceValid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcReceiverNoiseModel::~VlcReceiverNoiseModel (void)
+{
+}
+
+void
+VlcReceiverNoiseModel::SetResponsivity (double responsivity)
+{
+  NS_LOG_FUNCTION (this << responsivity);
+  m_responsivity = responsivity;
+  m_constantVarianceValid = false;
+}
+
+double
+VlcReceiverNoiseModel::GetResponsivity (void) const
+{
+  return m_responsivity;
+}
+
+void
+VlcReceiverNoiseModel::SetBandwidth (double bandwidth)
+{
+  NS_LOG_FUNCTION (this << bandwidth);
+  m_bandwidth = bandwidth;
+  m_constantVarianceValid = false;
+}
+
+double
+VlcReceiverNoiseModel::GetBandwidth (void) const
+{
+  return m_bandwidth;
+}
+
+void
+VlcReceiverNoiseModel::SetAmbientPower (double power)
+{
+  NS_LOG_FUNCTION (this << power);
+  m_ambientPower = power;
+  m_constantVarianceValid = false;
+}
+
+double
+VlcReceiverNoiseModel::GetAmbientPower (void) const
+{
+  return m_ambientPower;
+}
+
+void
+VlcReceiverNoiseModel::SetDarkCurrent (double current)
+{
+  NS_LOG_FUNCTION (this << current);
+  m_darkCurrent = current;
+  m_constantVarianceValid = false;
+}
+
+double
+VlcReceiverNoiseModel::GetDarkCurrent (void) const
+{
+  return m_darkCurrent;
+}
+
+void
+VlcReceiverNoiseModel::SetTemperature (double temperature)
+{
+  NS_LOG_FUNCTION (this << temperature);
+  m_temperature = temperature;
+  m_constantVarianceValid = false;
+}
+
+double
+VlcReceiverNoiseModel::GetTemperature (void) const
+{
+  return m_temperature;
+}
+
+void
+VlcReceiverNoiseModel::SetFeedbackResistance (double resistance)
+{
+  NS_LOG_FUNCTION (this << resistance);
+  m_feedbackResistance = resistance;
+  m_constantVarianceValid = false;
+}
+
+double
+VlcReceiverNoiseModel::GetFeedbackResistance (void) const
+{
+  return m_feedbackResistance;
+}
+
+double
+VlcReceiverNoiseModel::GetConstantNoiseVariance (void) const
+{
+  if (!m_constantVarianceValid)
+    {
+      double shot = 2 * ELEMENTARY_CHARGE * (m_responsivity * m_ambientPower + m_darkCurrent) * m_bandwidth;
+      double thermal = 4 * BOLTZMANN * m_temperature * m_bandwidth / m_feedbackResistance;
+      m_constantVariance = shot + thermal;
+      m_constantVarianceValid = true;
+      NS_LOG_DEBUG ("Shot noise " << shot << " A^2, thermal noise " << thermal << " A^2");
+    }
+  return m_constantVariance;
+}
+
+double
+VlcReceiverNoiseModel::GetNoiseVariance (double rxPower) const
+{
+  return GetConstantNoiseVariance () + 2 * ELEMENTARY_CHARGE * m_responsivity * rxPower * m_bandwidth;
+}
+
+double
+VlcReceiverNoiseModel::GetSnr (double rxPower) const
+{
+  double current = m_responsivity * rxPower;
+  return current * current / GetNoiseVariance (rxPower);
+}
+
+double
+VlcReceiverNoiseModel::GetNoisePower (double rxPower) const
+{
+  NS_ASSERT (rxPower > 0);
+  return rxPower / GetSnr (rxPower);
+}
+
+} // namespace ns3
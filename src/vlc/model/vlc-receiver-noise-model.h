@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_RECEIVER_NOISE_MODEL_H
+#define VLC_RECEIVER_NOISE_MODEL_H
+
+#include <ns3/object.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc
+ *
+ * Noise of a photodiode receiver with a transimpedance front end. The
+ * variance of the noise current is the sum of the shot noise of the signal,
+ * of the ambient light and of the dark current, and of the thermal noise of
+ * the feedback resistor:
+ *
+ * \f[
+ *   \sigma^2 = 2 q (R (P_r + P_{amb}) + I_d) B + \frac{4 k T B}{R_f}
+ * \f]
+ *
+ * where R is the responsivity of the photodiode, \f$ P_r \f$ the received
+ * optical power, \f$ P_{amb} \f$ the received ambient light power,
+ * \f$ I_d \f$ the dark current, B the noise bandwidth, T the temperature
+ * and \f$ R_f \f$ the feedback resistance. The electrical SNR of a signal
+ * is \f$ (R P_r)^2 / \sigma^2 \f$.
+ *
+ * All terms but the shot noise of the signal only depend on the receiver
+ * configuration. Their sum is computed on the first query after a change of
+ * the configuration and reused afterwards.
+ */
+class VlcReceiverNoiseModel : public Object
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VlcReceiverNoiseModel (void);
+  virtual ~VlcReceiverNoiseModel (void);
+
+  /**
+   * \param responsivity the responsivity of the photodiode in A/W
+   */
+  void SetResponsivity (double responsivity);
+
+  /**
+   * \return the responsivity of the photodiode in A/W
+   */
+  double GetResponsivity (void) const;
+
+  /**
+   * \param bandwidth the noise bandwidth of the receiver in Hz
+   */
+  void SetBandwidth (double bandwidth);
+
+  /**
+   * \return the noise bandwidth of the receiver in Hz
+   */
+  double GetBandwidth (void) const;
+
+  /**
+   * \param power the received ambient light power in W
+   */
+  void SetAmbientPower (double power);
+
+  /**
+   * \return the received ambient light power in W
+   */
+  double GetAmbientPower (void) const;
+
+  /**
+   * \param current the dark current of the photodiode in A
+   */
+  void SetDarkCurrent (double current);
+
+  /**
+   * \return the dark current of the photodiode in A
+   */
+  double GetDarkCurrent (void) const;
+
+  /**
+   * \param temperature the temperature of the receiver in K
+   */
+  void SetTemperature (double temperature);
+
+  /**
+   * \return the temperature of the receiver in K
+   */
+  double GetTemperature (void) const;
+
+  /**
+   * \param resistance the feedback resistance of the amplifier in ohm
+   */
+  void SetFeedbackResistance (double resistance);
+
+  /**
+   * \return the feedback resistance of the amplifier in ohm
+   */
+  double GetFeedbackResistance (void) const;
+
+  /**
+   * \param rxPower the received optical power of the signal in W
+   * \return the variance of the noise current in A^2
+   */
+  double GetNoiseVariance (double rxPower) const;
+
+  /**
+   * \param rxPower the received optical power of the signal in W
+   * \return the electrical SNR of the signal, without interference
+   */
+  double GetSnr (double rxPower) const;
+
+  /**
+   * Get the noise as a received power, to be added to the interference
+   * power: the power N for which \f$ P_r / N \f$ equals the electrical SNR.
+   *
+   * \param rxPower the received optical power of the signal in W, positive
+   * \return the noise power in W
+   */
+  double GetNoisePower (double rxPower) const;
+
+private:
+  /**
+   * \return the variance of the noise current which does not depend on the
+   * signal, in A^2
+   */
+  double GetConstantNoiseVariance (void) const;
+
+  double m_responsivity;               //!< The responsivity in A/W
+  double m_bandwidth;                  //!< The noise bandwidth in Hz
+  double m_ambientPower;               //!< The received ambient light power in W
+  double m_darkCurrent;                //!< The dark current in A
+  double m_temperature;                //!< The temperature in K
+  double m_feedbackResistance;         //!< The feedback resistance in ohm
+  mutable double m_constantVariance;   //!< The cached signal independent noise variance in A^2
+  mutable bool m_constantVarianceValid; //!< Whether m_constantVariance is up to date
+};
+
+} // namespace ns3
+
+#endif /* VLC_RECEIVER_NOISE_MODEL_H */
@@ -0,0 +1,522 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-spectrum-channel.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/net-device.h>
+#include <ns3/node.h>
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VlcSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (VlcSpectrumChannel);
+
+TypeId
+VlcSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VlcSpectrumChannel")
+    .SetParent<SpectrumChannel> ()
+    .SetGroupName ("Vlc")
+    .AddConstructor<VlcSpectrumChannel> ()
+    .AddAttribute ("CellSize",
+                   "The edge length of the cells of the receiver grid (m).",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&VlcSpectrumChannel::SetCellSize,
+                                       &VlcSpectrumChannel::GetCellSize),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MaxRange",
+                   "The maximum distance a transmission can reach (m). "
+                   "Zero disables the culling of receivers.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&VlcSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("TxNormal",
+                   "The axis of the illumination cone of the transmitters. "
+                   "A zero vector disables the cone check.",
+                   VectorValue (Vector (0.0, 0.0, 0.0)),
+                   MakeVectorAccessor (&VlcSpectrumChannel::m_txNormal),
+                   MakeVectorChecker ())
+    .AddAttribute ("ConeHalfAngle",
+                   "The half angle of the illumination cone of the transmitters (degrees).",
+                   DoubleValue (90.0),
+                   MakeDoubleAccessor (&VlcSpectrumChannel::m_coneHalfAngle),
+                   MakeDoubleChecker<double> (0.0, 180.0))
+    .AddAttribute ("MaxLossDb",
+                   "The maximum loss in dB for which transmissions will be "
+                   "passed to the receiving PHY.",
+                   DoubleValue (1.0e9),
+                   MakeDoubleAccessor (&VlcSpectrumChannel::m_maxLossDb),
+                   MakeDoubleChecker<double> ())
+    .AddTraceSource ("PathLoss",
+                     "This trace is fired whenever a new path loss value "
+                     "is calculated for a receiver that was not culled.",
+                     MakeTraceSourceAccessor (&VlcSpectrumChannel::m_pathLossTrace),
+                     "ns3::SpectrumChannel::LossTracedCallback")
+  ;
+  return tid;
+}
+
+VlcSpectrumChannel::VlcSpectrumChannel (void)
+  : m_cellSize (5.0),
+    m_maxRange (0.0),
+    m_txNormal (0.0, 0.0, 0.0),
+    m_coneHalfAngle (90.0),
+    m_maxLossDb (1.0e9),
+    m_visited (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VlcSpectrumChannel::~VlcSpectrumChannel (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VlcSpectrumChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<Receiver>::iterator it;
+  for (it = m_receivers.begin (); it != m_receivers.end (); ++it)
+    {
+      if (it->mobility)
+        {
+          it->mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                       MakeCallback (&VlcSpectrumChannel::CourseChanged, this));
+        }
+    }
+  m_receivers.clear ();
+  m_unindexed.clear ();
+  m_grid.clear ();
+  m_mobilityIndex.clear ();
+  m_propagationLoss = 0;
+  m_propagationDelay = 0;
+  m_spectrumPropagationLoss = 0;
+  SpectrumChannel::DoDispose ();
+}
+
+void
+VlcSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+
+  Receiver receiver;
+  receiver.phy = phy;
+  receiver.cell = Cell (0, 0);
+  receiver.room = -1;
+  m_receivers.push_back (receiver);
+
+  // The mobility model of a PHY is usually set after it has been attached to
+  // the channel, so it is looked up on the next transmission.
+  m_unindexed.push_back (m_receivers.size () - 1);
+}
+
+void
+VlcSpectrumChannel::AddRoom (const Box &room)
+{
+  NS_LOG_FUNCTION (this << room);
+
+  m_rooms.push_back (room);
+  RebuildGrid ();
+}
+
+void
+VlcSpectrumChannel::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT (cellSize > 0);
+
+  m_cellSize = cellSize;
+  RebuildGrid ();
+}
+
+double
+VlcSpectrumChannel::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+VlcSpectrumChannel::GetNVisitedReceivers (void) const
+{
+  return m_visited;
+}
+
+VlcSpectrumChannel::Cell
+VlcSpectrumChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+int32_t
+VlcSpectrumChannel::GetRoom (const Vector &position) const
+{
+  for (uint32_t i = 0; i < m_rooms.size (); i++)
+    {
+      if (m_rooms[i].IsInside (position))
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+void
+VlcSpectrumChannel::IndexReceivers (void)
+{
+  std::vector<uint32_t>::iterator it = m_unindexed.begin ();
+  while (it != m_unindexed.end ())
+    {
+      Receiver &receiver = m_receivers[*it];
+      Ptr<MobilityModel> mobility = receiver.phy->GetMobility ();
+      if (mobility)
+        {
+          receiver.mobility = mobility;
+          m_mobilityIndex[PeekPointer (mobility)].push_back (*it);
+          if (m_mobilityIndex[PeekPointer (mobility)].size () == 1)
+            {
+              mobility->TraceConnectWithoutContext ("CourseChange",
+                                                    MakeCallback (&VlcSpectrumChannel::CourseChanged, this));
+            }
+          PlaceReceiver (*it);
+          it = m_unindexed.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+void
+VlcSpectrumChannel::PlaceReceiver (uint32_t index)
+{
+  Receiver &receiver = m_receivers[index];
+  Vector position = receiver.mobility->GetPosition ();
+  receiver.cell = GetCell (position);
+  receiver.room = GetRoom (position);
+  m_grid[receiver.cell].push_back (index);
+}
+
+void
+VlcSpectrumChannel::RebuildGrid (void)
+{
+  m_grid.clear ();
+  for (uint32_t i = 0; i < m_receivers.size (); i++)
+    {
+      if (m_receivers[i].mobility)
+        {
+          PlaceReceiver (i);
+        }
+    }
+}
+
+void
+VlcSpectrumChannel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator it;
+  it = m_mobilityIndex.find (PeekPointer (mobility));
+  if (it == m_mobilityIndex.end ())
+    {
+      return;
+    }
+
+  std::vector<uint32_t>::const_iterator index;
+  for (index = it->second.begin (); index != it->second.end (); ++index)
+    {
+      Receiver &receiver = m_receivers[*index];
+      Vector position = mobility->GetPosition ();
+      receiver.room = GetRoom (position);
+
+      Cell cell = GetCell (position);
+      if (cell != receiver.cell)
+        {
+          std::vector<uint32_t> &oldCell = m_grid[receiver.cell];
+          std::vector<uint32_t>::iterator old = std::find (oldCell.begin (), oldCell.end (), *index);
+          NS_ASSERT (old != oldCell.end ());
+          *old = oldCell.back ();
+          oldCell.pop_back ();
+          if (oldCell.empty ())
+            {
+              m_grid.erase (receiver.cell);
+            }
+          receiver.cell = cell;
+          m_grid[cell].push_back (*index);
+        }
+    }
+}
+
+bool
+VlcSpectrumChannel::IsReachable (const Vector &txPosition, int32_t txRoom, double cosCone,
+                                 const Receiver &receiver) const
+{
+  if (!m_rooms.empty () && receiver.room != txRoom)
+    {
+      return false;
+    }
+
+  Vector los = receiver.mobility->GetPosition () - txPosition;
+  double distance = los.GetLength ();
+  if (distance > m_maxRange)
+    {
+      return false;
+    }
+
+  double normalLength = m_txNormal.GetLength ();
+  if (normalLength > 0 && distance > 0)
+    {
+      double cosAngle = (m_txNormal.x * los.x + m_txNormal.y * los.y + m_txNormal.z * los.z)
+        / (normalLength * distance);
+      if (cosAngle < cosCone)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+VlcSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams->psd << txParams->duration << txParams->txPhy);
+  NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
+  NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
+
+  if (m_spectrumModel == 0)
+    {
+      // first pak, record SpectrumModel
+      m_spectrumModel = txParams->psd->GetSpectrumModel ();
+    }
+  else
+    {
+      // all attached SpectrumPhy instances must use the same SpectrumModel
+      NS_ASSERT (*(txParams->psd->GetSpectrumModel ()) == *m_spectrumModel);
+    }
+
+  if (!m_unindexed.empty ())
+    {
+      IndexReceivers ();
+    }
+
+  m_visited = 0;
+  Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+
+  if (!senderMobility || m_maxRange <= 0)
+    {
+      // Nothing to cull with, visit every receiver.
+      std::vector<Receiver>::const_iterator it;
+      for (it = m_receivers.begin (); it != m_receivers.end (); ++it)
+        {
+          Deliver (txParams, senderMobility, *it);
+        }
+      return;
+    }
+
+  std::vector<uint32_t>::const_iterator index;
+  for (index = m_unindexed.begin (); index != m_unindexed.end (); ++index)
+    {
+      Deliver (txParams, senderMobility, m_receivers[*index]);
+    }
+
+  Vector txPosition = senderMobility->GetPosition ();
+  int32_t txRoom = GetRoom (txPosition);
+  double cosCone = std::cos (m_coneHalfAngle * M_PI / 180.0);
+
+  Cell low = GetCell (Vector (txPosition.x - m_maxRange, txPosition.y - m_maxRange, 0));
+  Cell high = GetCell (Vector (txPosition.x + m_maxRange, txPosition.y + m_maxRange, 0));
+  double nCells = static_cast<double> (high.first - low.first + 1) * (high.second - low.second + 1);
+
+  std::map<Cell, std::vector<uint32_t> >::const_iterator cell;
+  if (nCells > m_grid.size ())
+    {
+      // The range covers more cells than are occupied, walk the occupied ones.
+      for (cell = m_grid.begin (); cell != m_grid.end (); ++cell)
+        {
+          if (cell->first.first < low.first || cell->first.first > high.first
+              || cell->first.second < low.second || cell->first.second > high.second)
+            {
+              continue;
+            }
+          for (index = cell->second.begin (); index != cell->second.end (); ++index)
+            {
+              if (IsReachable (txPosition, txRoom, cosCone, m_receivers[*index]))
+                {
+                  Deliver (txParams, senderMobility, m_receivers[*index]);
+                }
+            }
+        }
+      return;
+    }
+
+  for (int64_t x = low.first; x <= high.first; x++)
+    {
+      for (int64_t y = low.second; y <= high.second; y++)
+        {
+          cell = m_grid.find (Cell (x, y));
+          if (cell == m_grid.end ())
+            {
+              continue;
+            }
+          for (index = cell->second.begin (); index != cell->second.end (); ++index)
+            {
+              if (IsReachable (txPosition, txRoom, cosCone, m_receivers[*index]))
+                {
+                  Deliver (txParams, senderMobility, m_receivers[*index]);
+                }
+            }
+        }
+    }
+}
+
+void
+VlcSpectrumChannel::Deliver (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility,
+                             const Receiver &receiver)
+{
+  if (receiver.phy == txParams->txPhy)
+    {
+      return;
+    }
+  m_visited++;
+
+  Time delay = MicroSeconds (0);
+  double pathGainLinear = 1.0;
+  Ptr<MobilityModel> receiverMobility = receiver.phy->GetMobility ();
+
+  if (senderMobility && receiverMobility)
+    {
+      double pathLossDb = 0;
+      if (txParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+          pathLossDb -= txParams->txAntenna->GetGainDb (txAngles);
+        }
+      Ptr<AntennaModel> rxAntenna = receiver.phy->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+          pathLossDb -= rxAntenna->GetGainDb (rxAngles);
+        }
+      if (m_propagationLoss)
+        {
+          pathLossDb -= m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+        }
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      m_pathLossTrace (txParams->txPhy, receiver.phy, pathLossDb);
+      if (pathLossDb > m_maxLossDb)
+        {
+          // beyond range, do not even copy the signal
+          return;
+        }
+      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
+        }
+    }
+
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  *(rxParams->psd) *= pathGainLinear;
+  if (m_spectrumPropagationLoss && senderMobility && receiverMobility)
+    {
+      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
+    }
+
+  Ptr<NetDevice> netDev = receiver.phy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode = netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &VlcSpectrumChannel::StartRx, this, rxParams, receiver.phy);
+    }
+  else
+    {
+      Simulator::Schedule (delay, &VlcSpectrumChannel::StartRx, this, rxParams, receiver.phy);
+    }
+}
+
+void
+VlcSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this << params);
+  receiver->StartRx (params);
+}
+
+std::size_t
+VlcSpectrumChannel::GetNDevices (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_receivers.size ();
+}
+
+Ptr<NetDevice>
+VlcSpectrumChannel::GetDevice (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  return m_receivers.at (i).phy->GetDevice ()->GetObject<NetDevice> ();
+}
+
+void
+VlcSpectrumChannel::AddPropagationLossModel (Ptr<PropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  if (m_propagationLoss)
+    {
+      loss->SetNext (m_propagationLoss);
+    }
+  m_propagationLoss = loss;
+}
+
+void
+VlcSpectrumChannel::AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  if (m_spectrumPropagationLoss)
+    {
+      loss->SetNext (m_spectrumPropagationLoss);
+    }
+  m_spectrumPropagationLoss = loss;
+}
+
+void
+VlcSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (m_propagationDelay == 0);
+  m_propagationDelay = delay;
+}
+
+} // namespace ns3
@@ -0,0 +1,264 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_SPECTRUM_CHANNEL_H
+#define VLC_SPECTRUM_CHANNEL_H
+
+#include <ns3/spectrum-channel.h>
+#include <ns3/traced-callback.h>
+#include <ns3/vector.h>
+#include <ns3/box.h>
+
+#include <map>
+#include <vector>
+#include <utility>
+
+namespace ns3 {
+
+class MobilityModel;
+class PropagationLossModel;
+class PropagationDelayModel;
+class SpectrumPropagationLossModel;
+class SpectrumModel;
+
+/**
+ * \ingroup vlc
+ *
+ * A single model spectrum channel for visible light, which only visits the
+ * receivers that a transmission can actually reach.
+ *
+ * Receivers with a mobility model are kept in a uniform grid of square cells
+ * in the x-y plane, which is updated whenever a mobility model reports a
+ * course change. A transmission only visits the cells within MaxRange of the
+ * transmitter and, of the receivers found there, only those that are
+ * - within MaxRange of the transmitter,
+ * - inside the illumination cone given by TxNormal and ConeHalfAngle, and
+ * - in the same room as the transmitter, if rooms have been added.
+ *
+ * Light does not pass walls, so a room is modeled as a Box: a receiver
+ * outside of the room of the transmitter never sees the signal. Receivers
+ * without a mobility model are always visited. With the default MaxRange of
+ * zero, no culling takes place and the channel behaves like a
+ * SingleModelSpectrumChannel. In contrast to the latter, the signal
+ * parameters are only copied for receivers within MaxLossDb.
+ */
+class VlcSpectrumChannel : public SpectrumChannel
+{
+public:
+  VlcSpectrumChannel (void);
+  virtual ~VlcSpectrumChannel (void);
+
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from SpectrumChannel
+  virtual void AddPropagationLossModel (Ptr<PropagationLossModel> loss);
+  virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
+  virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+  // inherited from Channel
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+  /**
+   * Add a room. Signals only reach receivers in the same room as the
+   * transmitter. Positions outside of all rooms form a room of their own.
+   *
+   * \param room the extent of the room
+   */
+  void AddRoom (const Box &room);
+
+  /**
+   * Set the edge length of the cells of the receiver grid. A good choice is
+   * in the order of MaxRange.
+   *
+   * \param cellSize the edge length in m
+   */
+  void SetCellSize (double cellSize);
+
+  /**
+   * Get the edge length of the cells of the receiver grid.
+   *
+   * \return the edge length in m
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * Get the number of receivers visited by the last transmission.
+   *
+   * \return the number of visited receivers
+   */
+  uint32_t GetNVisitedReceivers (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * A cell of the receiver grid.
+   */
+  typedef std::pair<int64_t, int64_t> Cell;
+
+  /**
+   * A receiver attached to the channel.
+   */
+  struct Receiver
+  {
+    Ptr<SpectrumPhy> phy;          //!< the receiving PHY
+    Ptr<MobilityModel> mobility;   //!< the mobility model the receiver is indexed with
+    Cell cell;                     //!< the grid cell of the receiver
+    int32_t room;                  //!< the room of the receiver, -1 if outside of all rooms
+  };
+
+  /**
+   * Get the grid cell of a position.
+   *
+   * \param position the position
+   * \return the cell
+   */
+  Cell GetCell (const Vector &position) const;
+
+  /**
+   * Get the room of a position.
+   *
+   * \param position the position
+   * \return the index of the room, -1 if outside of all rooms
+   */
+  int32_t GetRoom (const Vector &position) const;
+
+  /**
+   * Add receivers, whose mobility model has been set since they were
+   * attached, to the grid.
+   */
+  void IndexReceivers (void);
+
+  /**
+   * Put a receiver, which is not in the grid yet, into the grid cell and room
+   * of its current position.
+   *
+   * \param index the index of the receiver
+   */
+  void PlaceReceiver (uint32_t index);
+
+  /**
+   * Recompute the grid cell and room of all indexed receivers.
+   */
+  void RebuildGrid (void);
+
+  /**
+   * Update the grid cell and room of the receivers using a mobility model.
+   *
+   * \param mobility the mobility model that changed its course
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Check whether a receiver can be reached by a transmission.
+   *
+   * \param txPosition the position of the transmitter
+   * \param txRoom the room of the transmitter
+   * \param cosCone the cosine of the half angle of the illumination cone
+   * \param receiver the receiver
+   * \return true, if the receiver is within range, cone and room
+   */
+  bool IsReachable (const Vector &txPosition, int32_t txRoom, double cosCone,
+                    const Receiver &receiver) const;
+
+  /**
+   * Compute the path loss to a receiver and schedule the reception.
+   *
+   * \param txParams the parameters of the transmitted signal
+   * \param senderMobility the mobility model of the transmitter
+   * \param receiver the receiver
+   */
+  void Deliver (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility,
+                const Receiver &receiver);
+
+  /**
+   * Used internally to reschedule transmission after the propagation delay.
+   *
+   * \param params the parameters of the received signal
+   * \param receiver the receiving PHY
+   */
+  void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+
+  /**
+   * All receivers attached to the channel, in order of attachment.
+   */
+  std::vector<Receiver> m_receivers;
+
+  /**
+   * Indices of the receivers without a mobility model.
+   */
+  std::vector<uint32_t> m_unindexed;
+
+  /**
+   * Indices of the receivers in each non-empty grid cell.
+   */
+  std::map<Cell, std::vector<uint32_t> > m_grid;
+
+  /**
+   * Indices of the receivers using each mobility model.
+   */
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_mobilityIndex;
+
+  /**
+   * The rooms.
+   */
+  std::vector<Box> m_rooms;
+
+  double m_cellSize;       //!< edge length of a grid cell (m)
+  double m_maxRange;       //!< maximum range of a transmission (m), 0 to disable culling
+  Vector m_txNormal;       //!< axis of the illumination cone
+  double m_coneHalfAngle;  //!< half angle of the illumination cone (degrees)
+  double m_maxLossDb;      //!< maximum loss for which signals are propagated (dB)
+  uint32_t m_visited;      //!< number of receivers visited by the last transmission
+
+  /**
+   * SpectrumModel that this channel instance is supporting.
+   */
+  Ptr<const SpectrumModel> m_spectrumModel;
+
+  /**
+   * Propagation delay model to be used with this channel.
+   */
+  Ptr<PropagationDelayModel> m_propagationDelay;
+
+  /**
+   * Single-frequency propagation loss model to be used with this channel.
+   */
+  Ptr<PropagationLossModel> m_propagationLoss;
+
+  /**
+   * Frequency-dependent propagation loss model to be used with this channel.
+   */
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+
+  /**
+   * The path loss of each delivered signal, see SingleModelSpectrumChannel.
+   */
+  TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double> m_pathLossTrace;
+};
+
+} // namespace ns3
+
+#endif /* VLC_SPECTRUM_CHANNEL_H */
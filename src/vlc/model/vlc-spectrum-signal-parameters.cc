@@ -17,14 +17,16 @@
  */
 #include "vlc-spectrum-signal-parameters.h"
 #include <ns3/log.h>
-#include <ns3/packet-burst.h>
+#include <ns3/packet.h>
 
+#include <typeinfo>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("VlcSpectrumSignalParameters");
 
 VlcSpectrumSignalParameters::VlcSpectrumSignalParameters (void)
+  : dimmingLevel (0.5)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -33,7 +35,8 @@ VlcSpectrumSignalParameters::VlcSpectrumSignalParameters (const VlcSpectrumSigna
   : SpectrumSignalParameters (p)
 {
   NS_LOG_FUNCTION (this << &p);
-  packetBurst = p.packetBurst->Copy ();
+  packet = p.packet->Copy ();
+  dimmingLevel = p.dimmingLevel;
 }
 
 Ptr<SpectrumSignalParameters>
@@ -43,4 +46,10 @@ VlcSpectrumSignalParameters::Copy (void)
   return Create<VlcSpectrumSignalParameters> (*this);
 }
 
+bool
+VlcSpectrumSignalParameters::IsVlcSignal (Ptr<const SpectrumSignalParameters> params)
+{
+  return typeid (*params) == typeid (VlcSpectrumSignalParameters);
+}
+
 } // namespace ns3
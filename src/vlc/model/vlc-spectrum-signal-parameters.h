@@ -24,8 +24,14 @@
 
 namespace ns3 {
 
-class PacketBurst;
+class Packet;
 
+/**
+ * \ingroup vlc
+ *
+ * Signal parameters of a VLC frame. A frame carries a single packet, so it
+ * is held directly rather than in a PacketBurst.
+ */
 struct VlcSpectrumSignalParameters : public SpectrumSignalParameters
 {
 
@@ -38,15 +44,38 @@ struct VlcSpectrumSignalParameters : public SpectrumSignalParameters
   VlcSpectrumSignalParameters (void);
 
   /**
-   * copy constructor
+   * copy constructor, with a copy of the packet, which the receiver tags
    * \param p the object to copy from.
    */
   VlcSpectrumSignalParameters (const VlcSpectrumSignalParameters& p);
 
   /**
-   * The packet burst being transmitted with this signal
+   * Check whether signal parameters describe a VLC frame.
+   *
+   * Only the dynamic type of the parameters is compared with
+   * VlcSpectrumSignalParameters, there is no walk of the class hierarchy as
+   * in DynamicCast. Parameters of a VLC frame can then be StaticCast.
+   *
+   * The comparison still relies on RTTI (typeid), as DynamicCast does, since
+   * SpectrumSignalParameters carries no type field. The match is exact: a
+   * class derived from VlcSpectrumSignalParameters is not reported as a VLC
+   * signal, and this check has to be revisited before adding one.
+   *
+   * \param params the signal parameters
+   * \return true, if the parameters are VlcSpectrumSignalParameters
+   */
+  static bool IsVlcSignal (Ptr<const SpectrumSignalParameters> params);
+
+  /**
+   * The packet being transmitted with this signal
+   */
+  Ptr<Packet> packet;
+
+  /**
+   * The dimming level of the transmitter, the average optical power of the
+   * frame relative to the peak power. 0.5 for an undimmed frame.
    */
-  Ptr<PacketBurst> packetBurst;
+  double dimmingLevel;
 };
 
 }  // namespace ns3
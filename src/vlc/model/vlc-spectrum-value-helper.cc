@@ -25,6 +25,20 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("VlcSpectrumValueHelper");
 
+/// The colour bands of IEEE 802.15.7, limits in nm
+static const double g_vlcColorBands[][2] = {
+  { 380, 478 },
+  { 478, 540 },
+  { 540, 588 },
+  { 588, 633 },
+  { 633, 679 },
+  { 679, 726 },
+  { 726, 780 }
+};
+
+/// The number of colour bands
+static const uint32_t VLC_N_COLOR_BANDS = sizeof (g_vlcColorBands) / sizeof (g_vlcColorBands[0]);
+
 Ptr<SpectrumModel> g_VlcSpectrumModel; //!< Global object used to initialize the Vlc Spectrum Model
 
 class VlcSpectrumModelInitializer
@@ -34,29 +48,45 @@ public:
   {
     NS_LOG_FUNCTION (this);
 
+    static const double SPEED_OF_LIGHT = 299792458.0;
     Bands bands;
-    // 1 MHz resolution, with center frequency of 2400, 2401, ... 2483
-    // overall frequency span of 2399.5 MHz through 2483.5 MHz (83 bands)
-    // for (int i = -1; i < 83; i++)
-    //   {
-    //     BandInfo bi;
-    //     bi.fl = 2400.5e6 + i * 1.0e6;
-    //     bi.fh = 2400.5e6 + (i + 1) * 1.0e6;
-    //     bi.fc = (bi.fl +  bi.fh) / 2;
-    //     bands.push_back (bi);
-    //   }
-
-    // TODO :CHECK
-    BandInfo bi;
-    bi.fl = 15.5e6 + 1.0e6;
-    bi.fh = 15.5e6 + (2*1.0e6);
-    bi.fc = (bi.fl + bi.fh) / 2;
-    bands.push_back (bi);
+    for (uint32_t i = 0; i < VLC_N_COLOR_BANDS; i++)
+      {
+        BandInfo bi;
+        bi.fl = SPEED_OF_LIGHT / (g_vlcColorBands[i][1] * 1e-9);
+        bi.fh = SPEED_OF_LIGHT / (g_vlcColorBands[i][0] * 1e-9);
+        bi.fc = (bi.fl + bi.fh) / 2;
+        bands.push_back (bi);
+      }
     g_VlcSpectrumModel = Create<SpectrumModel> (bands);
   }
 
 } g_VlcSpectrumModelInitializerInstance; //!< Global object used to initialize the Vlc Spectrum Model
 
+/**
+ * Map a channel number onto the index of the band carrying it.
+ *
+ * \param channel the channel number
+ * \return the band index within g_VlcSpectrumModel
+ */
+static uint32_t
+VlcChannelToBandIndex (uint32_t channel)
+{
+  NS_ASSERT_MSG (channel < VLC_N_COLOR_BANDS, "Invalid VLC channel " << channel);
+  return channel;
+}
+
+/**
+ * \param index the index of a band within g_VlcSpectrumModel
+ * \return the width of the band in Hz
+ */
+static double
+VlcBandWidth (uint32_t index)
+{
+  const BandInfo &band = *(g_VlcSpectrumModel->Begin () + index);
+  return band.fh - band.fl;
+}
+
 VlcSpectrumValueHelper::VlcSpectrumValueHelper (void)
 {
   NS_LOG_FUNCTION (this);
@@ -71,36 +101,16 @@ VlcSpectrumValueHelper::~VlcSpectrumValueHelper (void)
 Ptr<SpectrumValue>
 VlcSpectrumValueHelper::CreateTxPowerSpectralDensity (double txPower, uint32_t channel)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << txPower << channel);
   Ptr<SpectrumValue> txPsd = Create <SpectrumValue> (g_VlcSpectrumModel);
 
   // txPower is expressed in dBm. We must convert it into natural unit (W).
   txPower = pow (10., (txPower - 30) / 10);
 
-  // The effective occupied bandwidth of the signal is modelled to be 2 MHz.
-  // 99.5% of power is within +/- 1MHz of center frequency, and 0.5% is outside.
-  // There are 5 bands containing signal power.  The middle (center) band
-  // contains half of the power.  The two inner side bands contain 49.5%.
-  // The two outer side bands contain roughly 0.5%.
-  double txPowerDensity = txPower / 2.0e6;
-
-  NS_ASSERT_MSG ((channel >= 11 && channel <= 26), "Invalid channel numbers");
-
-  // The channel assignment is in section 6.1.2.1
-  // Channel 11 centered at 2.405 GHz, 12 at 2.410 GHz, ... 26 at 2.480 GHz
-
-  // TODO :CHECK
-  // (*txPsd)[2405 + 5 * (channel - 11) - 2400 - 2] = txPowerDensity * 0.005;
-  // (*txPsd)[2405 + 5 * (channel - 11) - 2400 - 1] = txPowerDensity * 0.495;
-  // (*txPsd)[2405 + 5 * (channel - 11) - 2400] = txPowerDensity; // center
-  // (*txPsd)[2405 + 5 * (channel - 11) - 2400 + 1 ] = txPowerDensity * 0.495;
-  // (*txPsd)[2405 + 5 * (channel - 11) - 2400 + 2 ] = txPowerDensity * 0.005;
-
-  // TODO : CHECK
-  (*txPsd)[15 + 5 * (channel) - 15] = txPowerDensity;
-  // If more power is allocated to more subbands in future revisions of
-  // this model, make sure to renormalize so that the integral of the
-  // txPsd still equals txPower
+  // All power is emitted within the colour band of the channel, so the
+  // integral of the txPsd equals txPower.
+  uint32_t index = VlcChannelToBandIndex (channel);
+  (*txPsd)[index] = txPower / VlcBandWidth (index);
 
   return txPsd;
 }
@@ -108,7 +118,7 @@ VlcSpectrumValueHelper::CreateTxPowerSpectralDensity (double txPower, uint32_t c
 Ptr<SpectrumValue>
 VlcSpectrumValueHelper::CreateNoisePowerSpectralDensity (uint32_t channel)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << channel);
   Ptr<SpectrumValue> noisePsd = Create <SpectrumValue> (g_VlcSpectrumModel);
 
   static const double BOLTZMANN = 1.3803e-23;
@@ -117,40 +127,69 @@ VlcSpectrumValueHelper::CreateNoisePowerSpectralDensity (uint32_t channel)
   // noise Floor (W) which accounts for thermal noise and non-idealities of the receiver
   double noisePowerDensity = m_noiseFactor * Nt;
 
-  NS_ASSERT_MSG ((channel >= 11 && channel <= 26), "Invalid channel numbers");
-
-
-  //TODO : CHECK
-  // (*noisePsd)[2405 + 5 * (channel - 11) - 2400 - 2] = noisePowerDensity;
-  // (*noisePsd)[2405 + 5 * (channel - 11) - 2400 - 1] = noisePowerDensity;
-  // (*noisePsd)[2405 + 5 * (channel - 11) - 2400] = noisePowerDensity;
-  // (*noisePsd)[2405 + 5 * (channel - 11) - 2400 + 1] = noisePowerDensity;
-  // (*noisePsd)[2405 + 5 * (channel - 11) - 2400 + 2] = noisePowerDensity;
-
-  (*noisePsd) [15 + 5*(channel) - 15] = noisePowerDensity;
+  (*noisePsd)[VlcChannelToBandIndex (channel)] = noisePowerDensity;
   return noisePsd;
 }
 
+Ptr<SpectrumValue>
+VlcSpectrumValueHelper::CreateRxFilterResponse (uint32_t channel, double adjacentGain)
+{
+  NS_LOG_FUNCTION (channel << adjacentGain);
+  Ptr<SpectrumValue> filter = Create <SpectrumValue> (g_VlcSpectrumModel);
+
+  uint32_t index = VlcChannelToBandIndex (channel);
+  (*filter)[index] = 1.0;
+  if (index > 0)
+    {
+      (*filter)[index - 1] = adjacentGain;
+    }
+  if (index + 1 < VLC_N_COLOR_BANDS)
+    {
+      (*filter)[index + 1] = adjacentGain;
+    }
+  return filter;
+}
+
 double
 VlcSpectrumValueHelper::TotalAvgPower (Ptr<const SpectrumValue> psd, uint32_t channel)
 {
   NS_LOG_FUNCTION (psd);
-  double totalAvgPower = 0.0;
 
   NS_ASSERT (psd->GetSpectrumModel () == g_VlcSpectrumModel);
 
-  // numerically integrate to get area under psd using 1 MHz resolution
-  // TODO : CHECK
-  // totalAvgPower += (*psd)[2405 + 5 * (channel - 11) - 2400 - 2];
-  // totalAvgPower += (*psd)[2405 + 5 * (channel - 11) - 2400 - 1];
-  // totalAvgPower += (*psd)[2405 + 5 * (channel - 11) - 2400];
-  // totalAvgPower += (*psd)[2405 + 5 * (channel - 11) - 2400 + 1];
-  // totalAvgPower += (*psd)[2405 + 5 * (channel - 11) - 2400 + 2];
+  uint32_t index = VlcChannelToBandIndex (channel);
+  return (*psd)[index] * VlcBandWidth (index);
+}
+
+double
+VlcSpectrumValueHelper::TotalAvgPower (Ptr<const SpectrumValue> psd, const SpectrumValue &filter)
+{
+  NS_LOG_FUNCTION (psd);
 
-  totalAvgPower += (*psd)[15 + 5 * (channel) - 15];
-  totalAvgPower *= 1.0e6;
+  NS_ASSERT (psd->GetSpectrumModel () == g_VlcSpectrumModel);
+  NS_ASSERT (filter.GetSpectrumModel () == g_VlcSpectrumModel);
 
+  double totalAvgPower = 0.0;
+  for (uint32_t i = 0; i < VLC_N_COLOR_BANDS; i++)
+    {
+      if (filter[i] != 0)
+        {
+          totalAvgPower += (*psd)[i] * filter[i] * VlcBandWidth (i);
+        }
+    }
   return totalAvgPower;
 }
 
+Ptr<const SpectrumModel>
+VlcSpectrumValueHelper::GetSpectrumModel (void)
+{
+  return g_VlcSpectrumModel;
+}
+
+uint32_t
+VlcSpectrumValueHelper::GetNChannels (void)
+{
+  return VLC_N_COLOR_BANDS;
+}
+
 } // namespace ns3
@@ -23,7 +23,33 @@
 namespace ns3 {
 
 class SpectrumValue;
+class SpectrumModel;
 
+/**
+ * \ingroup vlc
+ *
+ * Power spectral densities over the optical spectrum of IEEE 802.15.7.
+ *
+ * The spectrum model has one band per colour band of the standard, which
+ * are also the channels of the PHY:
+ *
+ * channel | wavelengths (nm)
+ * ------- | ----------------
+ *    0    | 380 - 478
+ *    1    | 478 - 540
+ *    2    | 540 - 588
+ *    3    | 588 - 633
+ *    4    | 633 - 679
+ *    5    | 679 - 726
+ *    6    | 726 - 780
+ *
+ * Band i of the model is channel i, so the bands are ordered by decreasing
+ * frequency. A transmitter emits its power into the band of its channel.
+ * A receiver sees the power of the band of its channel through an optical
+ * filter, which may let some power of the neighbouring bands through.
+ * Transmitters on different channels of an ideal filter do not interfere,
+ * so several colours can carry parallel streams.
+ */
 class VlcSpectrumValueHelper
 {
 public:
@@ -33,27 +59,56 @@ public:
   /**
    * \brief create spectrum value
    * \param txPower the power transmission in dBm
-   * \param channel the channel number per IEEE802.15.4
+   * \param channel the colour band
    * \return a Ptr to a newly created SpectrumValue instance
    */
   Ptr<SpectrumValue> CreateTxPowerSpectralDensity (double txPower, uint32_t channel);
 
   /**
    * \brief create spectrum value for noise
-   * \param channel the channel number per IEEE802.15.4
+   * \param channel the colour band
    * \return a Ptr to a newly created SpectrumValue instance
    */
   Ptr<SpectrumValue> CreateNoisePowerSpectralDensity (uint32_t channel);
 
+  /**
+   * \brief create the power response of the optical filter of a receiver
+   * \param channel the colour band the receiver is tuned to
+   * \param adjacentGain the linear gain of the filter in the neighbouring
+   * bands, 0 for an ideal filter
+   * \return a Ptr to a newly created SpectrumValue instance, 1 in the band of
+   * the channel
+   */
+  static Ptr<SpectrumValue> CreateRxFilterResponse (uint32_t channel, double adjacentGain);
+
   /**
    * \brief total average power of the signal is the integral of the PSD using
    * the limits of the given channel
    * \param psd spectral density
-   * \param channel the channel number per IEEE802.15.4
-   * \return total power (using composite trap. rule to numerally integrate)
+   * \param channel the colour band
+   * \return total power in W
    */
   static double TotalAvgPower (Ptr<const SpectrumValue> psd, uint32_t channel);
 
+  /**
+   * \brief total average power of the signal behind an optical filter, i.e.
+   * the integral of the PSD weighted by the filter response
+   * \param psd spectral density
+   * \param filter the power response of the filter
+   * \return total power in W
+   */
+  static double TotalAvgPower (Ptr<const SpectrumValue> psd, const SpectrumValue &filter);
+
+  /**
+   * \return the spectrum model of all VLC spectral densities
+   */
+  static Ptr<const SpectrumModel> GetSpectrumModel (void);
+
+  /**
+   * \return the number of colour bands, i.e. of channels
+   */
+  static uint32_t GetNChannels (void);
+
 private:
   /**
    * A scaling factor for the noise power.
@@ -160,6 +160,17 @@ VlcCollisionTestCase::DoRun (void)
   std::cout << "*** Second test " << std::endl;
   m_rxPackets = 0;
   params.m_txOptions = TX_OPTION_ACK;
+  // A transmission starts aTurnaroundTime_RX_TX (5120 optical clocks, 341 us
+  // at the default MCS) after its CCA, longer than the frames and than the
+  // default backoff window of 31 units of 20 clocks. The backoff alone then
+  // never separates two senders, and a retransmission restarts the backoff
+  // at macMinBE. As in IEEE 802.15.4, where aUnitBackoffPeriod is
+  // aTurnaroundTime plus the 8 symbols of the CCA, a backoff unit spans the
+  // turnaround and the CCA here, and the retransmissions back off.
+  dev0->GetCsmaCa ()->SetUnitBackoffPeriod (VlcPhy::aTurnaroundTime_RX_TX + 8);
+  dev1->GetCsmaCa ()->SetUnitBackoffPeriod (VlcPhy::aTurnaroundTime_RX_TX + 8);
+  dev0->GetCsmaCa ()->SetMacMinBE (3);
+  dev1->GetCsmaCa ()->SetMacMinBE (3);
 
   params.m_dstAddr = Mac16Address ("00:02");
   Simulator::Schedule (Seconds (0.1),
@@ -174,6 +185,10 @@ VlcCollisionTestCase::DoRun (void)
   Simulator::Run ();
 
   NS_TEST_EXPECT_MSG_EQ (m_rxPackets, 1, "Received a packet (as expected)");
+  dev0->GetCsmaCa ()->SetUnitBackoffPeriod (20);
+  dev1->GetCsmaCa ()->SetUnitBackoffPeriod (20);
+  dev0->GetCsmaCa ()->SetMacMinBE (0);
+  dev1->GetCsmaCa ()->SetMacMinBE (0);
 
   // Third case: two concurrent tx and no ACKs
   std::cout << "*** Third test " << std::endl;
@@ -184,13 +199,17 @@ VlcCollisionTestCase::DoRun (void)
 //  LogComponentEnable("VlcPhy",LOG_LEVEL_ALL);
 //  LogComponentEnableAll (LOG_PREFIX_TIME);
 
+  // dev2 starts its far, weak frame to dev0 first; it is on the air from
+  // 0.44 ms to 0.6 ms. dev1 runs its CCA 58 us into that frame, finds the
+  // channel busy during all its backoffs and reports a channel access
+  // failure, so that dev0 only receives the frame of dev2.
   params.m_dstAddr = Mac16Address ("00:01");
   Simulator::Schedule (Seconds (0.0001),
                        &VlcMac::McpsDataRequest,
                        dev2->GetMac (), params, p2);
 
   params.m_dstAddr = Mac16Address ("00:01");
-  Simulator::Schedule (Seconds (0.0002),
+  Simulator::Schedule (Seconds (0.0005),
                        &VlcMac::McpsDataRequest,
                        dev1->GetMac (), params, p0);
 
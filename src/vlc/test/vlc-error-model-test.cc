@@ -21,15 +21,22 @@
 #include <ns3/packet.h>
 #include <ns3/simulator.h>
 #include <ns3/vlc-error-model.h>
-#include <ns3/propagation-loss-model.h>
+#include <ns3/vlc-lambertian-propagation-loss-model.h>
+#include <ns3/vlc-receiver-noise-model.h>
 #include <ns3/vlc-net-device.h>
 #include <ns3/vlc-mac.h>
 #include <ns3/node.h>
 #include <ns3/net-device.h>
 #include <ns3/single-model-spectrum-channel.h>
 #include <ns3/mac16-address.h>
-//#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-position-mobility-model.h>
 #include "ns3/rng-seed-manager.h"
+#include <ns3/system-wall-clock-ms.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
 
 using namespace ns3;
 
@@ -119,16 +126,17 @@ VlcErrorTestCase::DoRun (void)
   dev0->SetAddress (Mac16Address ("00:01"));
   dev1->SetAddress (Mac16Address ("00:02"));
   Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
-  Ptr<LogDistancePropagationLossModel> model = CreateObject<LogDistancePropagationLossModel> ();
-  channel->AddPropagationLossModel (model);
+  channel->AddPropagationLossModel (CreateObject<VlcLambertianPropagationLossModel> ());
   dev0->SetChannel (channel);
   dev1->SetChannel (channel);
   n0->AddDevice (dev0);
   n1->AddDevice (dev1);
-  // Ptr<ConstantPositionMobilityModel> mob0 = CreateObject<ConstantPositionMobilityModel> ();
-  // dev0->GetPhy ()->SetMobility (mob0);
-  // Ptr<ConstantPositionMobilityModel> mob1 = CreateObject<ConstantPositionMobilityModel> ();
-  // dev1->GetPhy ()->SetMobility (mob1);
+  Ptr<ConstantPositionMobilityModel> mob0 = CreateObject<ConstantPositionMobilityModel> ();
+  dev0->GetPhy ()->SetMobility (mob0);
+  Ptr<ConstantPositionMobilityModel> mob1 = CreateObject<ConstantPositionMobilityModel> ();
+  dev1->GetPhy ()->SetMobility (mob1);
+  dev0->GetPhy ()->SetTxPower (30);
+  dev1->GetPhy ()->SetNoiseModel (CreateObject<VlcReceiverNoiseModel> ());
 
   McpsDataIndicationCallback cb0;
   cb0 = MakeCallback (&VlcErrorTestCase::Callback, this);
@@ -143,9 +151,8 @@ VlcErrorTestCase::DoRun (void)
   params.m_txOptions = 0;
 
   Ptr<Packet> p;
-  // TODO : CHECK
-//  mob0->SetPosition (Vector (0,0,0));
-//  mob1->SetPosition (Vector (100,0,0));
+  mob0->SetPosition (Vector (0,0,0));
+  mob1->SetPosition (Vector (32,0,0));
   for (int i = 0; i < 1000; i++)
     {
       p = Create<Packet> (20);
@@ -156,9 +163,10 @@ VlcErrorTestCase::DoRun (void)
 
   Simulator::Run ();
 
-  // Test that we received 977 packets out of 1000, at distance of 100 m
-  // with default power of 0
-  NS_TEST_ASSERT_MSG_EQ (GetReceived (), 977, "Model fails");
+  // Test that we received 882 packets out of 1000, at a distance of 32 m
+  // from a 1 W emitter over the Lambertian channel, with the default
+  // receiver noise and OOK
+  NS_TEST_ASSERT_MSG_EQ (GetReceived (), 882, "Model fails");
 
   Simulator::Destroy ();
 }
@@ -176,25 +184,66 @@ VlcErrorModelTestCase::~VlcErrorModelTestCase ()
 void
 VlcErrorModelTestCase::DoRun (void)
 {
-
   Ptr<VlcErrorModel> model = CreateObject<VlcErrorModel> ();
 
-  // Test a few values
-  double snr = 5;
-  double ber = 1.0 - model->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
-  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 7.38e-14, 0.01e-14, "Model fails for SNR = " << snr);
-  snr = 2;
-  ber = 1.0 - model->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
-  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 5.13e-7, 0.01e-7, "Model fails for SNR = " << snr);
-  snr = -1;
-  ber = 1.0 - model->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
-  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 0.00114, 0.00001, "Model fails for SNR = " << snr);
-  snr = -4;
-  ber = 1.0 - model->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
-  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 0.0391, 0.0001, "Model fails for SNR = " << snr);
-  snr = -7;
-  ber = 1.0 - model->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
-  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 0.175, 0.001, "Model fails for SNR = " << snr);
+  // OOK: BER = Q (sqrt (SNR)) per channel bit, 10 channel bits per 8 data bits.
+  NS_TEST_ASSERT_MSG_EQ (model->GetModulation (), VLC_MODULATION_OOK, "OOK is not the default");
+  double snrDb[] = { 0, 5, 10, 13 };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      double snr = pow (10.0, snrDb[i] / 10.0);
+      double p = 0.5 * erfc (sqrt (snr) / sqrt (2.0));
+      double expected = 1.0 - pow (1.0 - p, 10.0 / 8.0);
+      NS_TEST_ASSERT_MSG_EQ_TOL (model->GetBer (snr), expected, expected * 1e-9, "OOK model fails for SNR = " << snrDb[i]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTabulatedBer (snr), expected, expected * 1e-3, "OOK table fails for SNR = " << snrDb[i]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (model->GetChunkSuccessRate (snr, 100), pow (1.0 - expected, 100), 1e-4,
+                                 "OOK chunk success rate fails for SNR = " << snrDb[i]);
+    }
+  double snr = pow (10.0, 10.0 / 10.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetBer (snr), 9.79e-4, 0.01e-4, "OOK model fails for SNR = 10");
+
+  // VPPM: BER = Q (sqrt (SNR / 2)) per channel bit, 6 channel bits per 4 data bits.
+  model->SetModulation (VLC_MODULATION_VPPM);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      double snr = pow (10.0, snrDb[i] / 10.0);
+      double p = 0.5 * erfc (sqrt (snr / 2) / sqrt (2.0));
+      double expected = 1.0 - pow (1.0 - p, 6.0 / 4.0);
+      NS_TEST_ASSERT_MSG_EQ_TOL (model->GetBer (snr), expected, expected * 1e-9, "VPPM model fails for SNR = " << snrDb[i]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTabulatedBer (snr), expected, expected * 1e-3, "VPPM table fails for SNR = " << snrDb[i]);
+    }
+
+  // RS(15,7) over GF(16) corrects up to 4 symbol errors and improves the BER
+  // at moderate SNR.
+  model->SetModulation (VLC_MODULATION_OOK);
+  snr = pow (10.0, 10.0 / 10.0);
+  double uncoded = model->GetBer (snr);
+  model->SetFec (15, 7, 4);
+  double coded = model->GetBer (snr);
+  NS_TEST_ASSERT_MSG_LT (coded, uncoded / 100, "RS(15,7) does not improve the BER");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTabulatedBer (snr), coded, coded * 1e-2, "RS(15,7) table fails");
+
+  // Switching between schemes switches between shared tables: another model
+  // configured for RS(15,7) uses the same table, and switching back and
+  // forth leaves the table of each scheme intact.
+  Ptr<VlcErrorModel> other = CreateObject<VlcErrorModel> ();
+  other->Configure (VLC_MODULATION_OOK, 15, 7, 4, 0.5);
+  NS_TEST_ASSERT_MSG_EQ (other->GetTabulatedBer (snr), model->GetTabulatedBer (snr), "RS(15,7) table not shared");
+  other->Configure (VLC_MODULATION_VPPM, 0, 0, 0, 0.2);
+  other->Configure (VLC_MODULATION_OOK, 15, 7, 4, 0.5);
+  NS_TEST_ASSERT_MSG_EQ_TOL (other->GetTabulatedBer (snr), coded, coded * 1e-2, "RS(15,7) table changed");
+
+  // A finer table is more accurate.
+  model->SetFec (0, 0, 0);
+  model->SetTableResolution (0.05);
+  double coarseError = fabs (model->GetTabulatedBer (snr) - model->GetBer (snr));
+  model->SetTableResolution (0.001);
+  double fineError = fabs (model->GetTabulatedBer (snr) - model->GetBer (snr));
+  NS_TEST_ASSERT_MSG_LT (fineError, coarseError, "Finer table is not more accurate");
+
+  // No errors without noise.
+  NS_TEST_ASSERT_MSG_EQ (model->GetChunkSuccessRate (std::numeric_limits<double>::infinity (), 1000), 1.0,
+                         "Errors in a noise free channel");
 }
 
 /**
@@ -217,3 +266,86 @@ VlcErrorModelTestSuite::VlcErrorModelTestSuite ()
 }
 
 static VlcErrorModelTestSuite g_vlcErrorModelTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Error model Benchmark
+ *
+ * Compares the cost of the tabulated chunk success rate against the
+ * evaluation of the closed form expressions.
+ */
+class VlcErrorModelBenchmarkTestCase : public TestCase
+{
+public:
+  VlcErrorModelBenchmarkTestCase ();
+  virtual ~VlcErrorModelBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcErrorModelBenchmarkTestCase::VlcErrorModelBenchmarkTestCase ()
+  : TestCase ("Benchmark the 802.15.7 error model")
+{
+}
+
+VlcErrorModelBenchmarkTestCase::~VlcErrorModelBenchmarkTestCase ()
+{
+}
+
+void
+VlcErrorModelBenchmarkTestCase::DoRun (void)
+{
+  Ptr<VlcErrorModel> model = CreateObject<VlcErrorModel> ();
+  model->SetFec (15, 7, 4);
+  uint32_t nEvaluations = 200000;
+
+  double tabulated = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nEvaluations; i++)
+    {
+      tabulated += model->GetChunkSuccessRate (1.0 + (i % 1000) * 0.02, 100);
+    }
+  int64_t tabulatedMs = clock.End ();
+
+  double closedForm = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < nEvaluations; i++)
+    {
+      closedForm += pow (1.0 - model->GetBer (1.0 + (i % 1000) * 0.02), 100);
+    }
+  int64_t closedFormMs = clock.End ();
+
+  std::cout << std::setw (15) << "evaluations"
+            << std::setw (20) << "tabulated (ns)"
+            << std::setw (20) << "closed form (ns)" << std::endl;
+  std::cout << std::setw (15) << nEvaluations
+            << std::setw (20) << tabulatedMs * 1e6 / nEvaluations
+            << std::setw (20) << closedFormMs * 1e6 / nEvaluations << std::endl;
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (tabulated / nEvaluations, closedForm / nEvaluations, 1e-3,
+                             "Tabulated and closed form chunk success rates differ");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Error model Benchmark TestSuite
+ */
+class VlcErrorModelBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcErrorModelBenchmarkTestSuite ();
+};
+
+VlcErrorModelBenchmarkTestSuite::VlcErrorModelBenchmarkTestSuite ()
+  : TestSuite ("vlc-error-model-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcErrorModelBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcErrorModelBenchmarkTestSuite g_vlcErrorModelBenchmarkTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,401 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create two beacon-enabled cells, VPAN 1 with coordinator 00:01 at x = 0
+ * and VPAN 2 with coordinator 00:02 at x = 10 m, and a terminal 00:03
+ * tracking the beacons of VPAN 1. The beacons of the cells are 2 ms apart.
+ *
+ * \param terminalMobility the mobility of the terminal
+ * \return the coordinators followed by the terminal
+ */
+static std::vector<Ptr<VlcNetDevice> >
+CreateCells (Ptr<MobilityModel> terminalMobility)
+{
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      position->SetPosition (Vector (10 * i, 0, 0));
+      mobility.push_back (position);
+    }
+  mobility.push_back (terminalMobility);
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestDevices (mobility);
+
+  MlmeStartRequestParams startParams;
+  startParams.m_beaconOrder = 6;
+  startParams.m_superframeOrder = 6;
+  for (uint16_t i = 0; i < 2; i++)
+    {
+      startParams.m_vpanId = i + 1;
+      Simulator::Schedule (MilliSeconds (1 + 2 * i), &VlcMac::MlmeStartRequest, devices[i]->GetMac (), startParams);
+    }
+  devices[2]->GetMac ()->SetVpanId (1);
+  Simulator::ScheduleNow (&VlcMac::MlmeSyncRequest, devices[2]->GetMac (), MlmeSyncRequestParams ());
+  return devices;
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test the MAC handover of a terminal with frames queued for its
+ * coordinator.
+ */
+class VlcMacHandoverTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param makeBeforeBreak whether the handover is soft
+   */
+  VlcMacHandoverTestCase (bool makeBeforeBreak);
+  virtual ~VlcMacHandoverTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Function called when coordinator 00:01 receives a frame.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication1 (McpsDataIndicationParams params, Ptr<Packet> p);
+  /**
+   * Function called when coordinator 00:02 receives a frame.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication2 (McpsDataIndicationParams params, Ptr<Packet> p);
+  /**
+   * Function called when the handover is confirmed.
+   *
+   * \param params the MLME params
+   */
+  void HandoverConfirm (MlmeHandoverConfirmParams params);
+  /**
+   * Function called when the terminal drops a frame.
+   *
+   * \param p the packet
+   */
+  void MacTxDrop (Ptr<const Packet> p);
+
+  bool m_makeBeforeBreak;           //!< Whether the handover is soft
+  std::vector<Time> m_received[2];  //!< The reception times at each coordinator
+  Time m_confirmed;                 //!< The time of the handover confirm
+  Time m_interruption;              //!< The interruption time of the handover confirm
+  VlcMlmeStatus m_status;           //!< The status of the handover confirm
+  uint32_t m_nConfirms;             //!< The number of handover confirms
+  uint32_t m_nDrops;                //!< The number of frames dropped
+};
+
+VlcMacHandoverTestCase::VlcMacHandoverTestCase (bool makeBeforeBreak)
+  : TestCase (makeBeforeBreak ? "Soft handover of a terminal with queued frames"
+              : "Hard handover of a terminal with queued frames"),
+    m_makeBeforeBreak (makeBeforeBreak),
+    m_status (MLME_NO_BEACON),
+    m_nConfirms (0),
+    m_nDrops (0)
+{
+}
+
+VlcMacHandoverTestCase::~VlcMacHandoverTestCase ()
+{
+}
+
+void
+VlcMacHandoverTestCase::DataIndication1 (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received[0].push_back (Simulator::Now ());
+}
+
+void
+VlcMacHandoverTestCase::DataIndication2 (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received[1].push_back (Simulator::Now ());
+}
+
+void
+VlcMacHandoverTestCase::HandoverConfirm (MlmeHandoverConfirmParams params)
+{
+  m_nConfirms++;
+  m_status = params.m_status;
+  m_confirmed = Simulator::Now ();
+  m_interruption = params.m_interruption;
+}
+
+void
+VlcMacHandoverTestCase::MacTxDrop (Ptr<const Packet> p)
+{
+  m_nDrops++;
+}
+
+void
+VlcMacHandoverTestCase::DoRun (void)
+{
+  // Test setup:
+  // A terminal between two cells queues five acknowledged frames for the
+  // coordinator of VPAN 1 and asks for a handover to VPAN 2 at once. The
+  // frame in progress is finished with the old coordinator, the queued
+  // frames are readdressed and none is lost. A hard handover holds them
+  // until the first beacon of VPAN 2, a soft one keeps sending them to the
+  // old coordinator meanwhile. The interruption reported by a hard
+  // handover starts after the frame in progress, a soft one has none.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (7);
+
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (Vector (5, 1, 0));
+  std::vector<Ptr<VlcNetDevice> > devices = CreateCells (mobility);
+  Ptr<VlcMac> terminal = devices[2]->GetMac ();
+  devices[0]->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacHandoverTestCase::DataIndication1, this));
+  devices[1]->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacHandoverTestCase::DataIndication2, this));
+  terminal->SetMlmeHandoverConfirmCallback (MakeCallback (&VlcMacHandoverTestCase::HandoverConfirm, this));
+  terminal->TraceConnectWithoutContext ("MacTxDrop", MakeCallback (&VlcMacHandoverTestCase::MacTxDrop, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 1;
+  params.m_dstAddr = Mac16Address ("00:01");
+  params.m_txOptions = TX_OPTION_ACK;
+  Time request = MilliSeconds (20);
+  for (uint8_t i = 0; i < 5; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::Schedule (request, &VlcMac::McpsDataRequest, terminal, params, Create<Packet> (20));
+    }
+  MlmeHandoverRequestParams handoverParams;
+  handoverParams.m_vpanId = 2;
+  handoverParams.m_coordShortAddr = Mac16Address ("00:02");
+  handoverParams.m_makeBeforeBreak = m_makeBeforeBreak;
+  Simulator::Schedule (request, &VlcMac::MlmeHandoverRequest, terminal, handoverParams);
+
+  Simulator::Stop (MilliSeconds (60));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nConfirms, 1, "Wrong number of handover confirms");
+  NS_TEST_ASSERT_MSG_EQ (m_status, MLME_SUCCESS, "Handover failed");
+  NS_TEST_ASSERT_MSG_EQ (terminal->GetVpanId (), 2, "Terminal not in VPAN 2");
+  NS_TEST_ASSERT_MSG_GT (m_confirmed, request, "Handover confirmed before a beacon of VPAN 2");
+  // During a soft handover, the frames sent over the old link may hide a
+  // beacon of VPAN 2.
+  Time beaconInterval = MicroSeconds (4096);
+  NS_TEST_ASSERT_MSG_LT (m_confirmed, request + (m_makeBeforeBreak ? 2 : 1) * beaconInterval,
+                         "Handover not confirmed at the next beacons");
+  NS_TEST_ASSERT_MSG_EQ (m_nDrops, 0, "Frames dropped during the handover");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0].size () + m_received[1].size (), 5, "Frames lost during the handover");
+  for (uint32_t i = 0; i < m_received[1].size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_received[1][i], m_confirmed, "Frame received by the target before the handover");
+    }
+  if (!m_makeBeforeBreak)
+    {
+      // Only the frame in progress is sent to the old coordinator.
+      NS_TEST_ASSERT_MSG_EQ (m_received[0].size (), 1, "Queued frames sent to the old coordinator");
+      NS_TEST_ASSERT_MSG_GT (m_interruption, Time (0), "Hard handover without interruption");
+      NS_TEST_ASSERT_MSG_LT (m_interruption, m_confirmed - m_received[0].back (),
+                             "Interruption started before the end of the frame in progress");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (m_received[0].size (), 1, "Old link not used during the handover");
+      NS_TEST_ASSERT_MSG_EQ (m_interruption, Time (0), "Soft handover with interruption");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test the handover manager with a terminal moving across two cells.
+ */
+class VlcHandoverManagerTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param mode the handover mode
+   * \param speed the speed of the terminal along x, in m/s
+   * \param nHandovers the expected number of handovers
+   */
+  VlcHandoverManagerTestCase (VlcHandoverManager::Mode mode, double speed, uint32_t nHandovers);
+  virtual ~VlcHandoverManagerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Function called at the end of a handover.
+   *
+   * \param source the VPAN identifier of the source cell
+   * \param target the VPAN identifier of the target cell
+   */
+  void HandoverEnd (uint16_t source, uint16_t target);
+  /**
+   * Function called with the latency of a handover.
+   *
+   * \param latency the latency
+   */
+  void HandoverLatency (Time latency);
+  /**
+   * Function called with the interruption time of a handover.
+   *
+   * \param interruption the interruption time
+   */
+  void InterruptionTime (Time interruption);
+
+  VlcHandoverManager::Mode m_mode;                    //!< The handover mode
+  double m_speed;                                     //!< The speed of the terminal
+  uint32_t m_nHandovers;                              //!< The expected number of handovers
+  std::vector<std::pair<uint16_t, uint16_t> > m_ends; //!< The source and target of the handovers
+  std::vector<Time> m_latencies;                      //!< The handover latencies
+  std::vector<Time> m_interruptions;                  //!< The interruption times
+};
+
+VlcHandoverManagerTestCase::VlcHandoverManagerTestCase (VlcHandoverManager::Mode mode, double speed,
+                                                        uint32_t nHandovers)
+  : TestCase ("Handover manager, mode " + std::string (mode == VlcHandoverManager::HARD ? "hard" : "soft")
+              + (speed > 0 ? ", moving terminal" : ", static terminal")),
+    m_mode (mode),
+    m_speed (speed),
+    m_nHandovers (nHandovers)
+{
+}
+
+VlcHandoverManagerTestCase::~VlcHandoverManagerTestCase ()
+{
+}
+
+void
+VlcHandoverManagerTestCase::HandoverEnd (uint16_t source, uint16_t target)
+{
+  m_ends.push_back (std::make_pair (source, target));
+}
+
+void
+VlcHandoverManagerTestCase::HandoverLatency (Time latency)
+{
+  m_latencies.push_back (latency);
+}
+
+void
+VlcHandoverManagerTestCase::InterruptionTime (Time interruption)
+{
+  m_interruptions.push_back (interruption);
+}
+
+void
+VlcHandoverManagerTestCase::DoRun (void)
+{
+  // Test setup:
+  // A terminal starts at x = 1 m and moves towards the coordinator of
+  // VPAN 2 at x = 10 m, it is handed over exactly once. A static terminal
+  // just past the middle of the cells stays within the hysteresis and is
+  // not handed over.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (8);
+
+  Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+  mobility->SetPosition (Vector (m_speed > 0 ? 1 : 5.2, 1, 0));
+  mobility->SetVelocity (Vector (m_speed, 0, 0));
+  std::vector<Ptr<VlcNetDevice> > devices = CreateCells (mobility);
+
+  VlcHelper helper;
+  helper.SetHandoverManagerAttribute ("Mode", EnumValue (m_mode));
+  NetDeviceContainer terminals;
+  terminals.Add (devices[2]);
+  helper.InstallHandoverManager (terminals);
+  Ptr<VlcHandoverManager> manager = devices[2]->GetObject<VlcHandoverManager> ();
+  NS_TEST_ASSERT_MSG_NE (manager, 0, "Handover manager not aggregated");
+  manager->TraceConnectWithoutContext ("HandoverEnd", MakeCallback (&VlcHandoverManagerTestCase::HandoverEnd, this));
+  manager->TraceConnectWithoutContext ("HandoverLatency",
+                                       MakeCallback (&VlcHandoverManagerTestCase::HandoverLatency, this));
+  manager->TraceConnectWithoutContext ("InterruptionTime",
+                                       MakeCallback (&VlcHandoverManagerTestCase::InterruptionTime, this));
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (manager->GetNHandovers (), m_nHandovers, "Wrong number of handovers");
+  NS_TEST_ASSERT_MSG_EQ (m_ends.size (), m_nHandovers, "Wrong number of handover ends");
+  NS_TEST_ASSERT_MSG_EQ (m_latencies.size (), m_nHandovers, "Wrong number of handover latencies");
+  NS_TEST_ASSERT_MSG_EQ (m_interruptions.size (), m_nHandovers, "Wrong number of interruption times");
+  for (uint32_t i = 0; i < m_ends.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_ends[i].first, 1, "Wrong source cell");
+      NS_TEST_ASSERT_MSG_EQ (m_ends[i].second, 2, "Wrong target cell");
+      // The handover completes at the next beacon of the target.
+      NS_TEST_ASSERT_MSG_GT (m_latencies[i], Time (0), "Handover without latency");
+      NS_TEST_ASSERT_MSG_LT (m_latencies[i], MicroSeconds (4096), "Handover latency above a beacon interval");
+      if (m_mode == VlcHandoverManager::HARD)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_interruptions[i], m_latencies[i], "Hard handover without interruption");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_interruptions[i], Time (0), "Soft handover with interruption");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (devices[2]->GetMac ()->GetVpanId (), (m_nHandovers > 0 ? 2 : 1), "Wrong serving cell");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Handover test suite
+ */
+class VlcHandoverTestSuite : public TestSuite
+{
+public:
+  VlcHandoverTestSuite ();
+};
+
+VlcHandoverTestSuite::VlcHandoverTestSuite ()
+  : TestSuite ("vlc-handover", UNIT)
+{
+  AddTestCase (new VlcMacHandoverTestCase (false), TestCase::QUICK);
+  AddTestCase (new VlcMacHandoverTestCase (true), TestCase::QUICK);
+  AddTestCase (new VlcHandoverManagerTestCase (VlcHandoverManager::HARD, 2, 1), TestCase::QUICK);
+  AddTestCase (new VlcHandoverManagerTestCase (VlcHandoverManager::SOFT, 2, 1), TestCase::QUICK);
+  AddTestCase (new VlcHandoverManagerTestCase (VlcHandoverManager::HARD, 0, 0), TestCase::QUICK);
+}
+
+static VlcHandoverTestSuite g_vlcHandoverTestSuite; //!< Static variable for test initialization
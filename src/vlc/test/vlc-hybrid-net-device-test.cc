@@ -0,0 +1,404 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/node-container.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/simple-channel.h>
+#include <ns3/simple-net-device.h>
+#include <ns3/mac48-address.h>
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create an access point and two terminals 5 m away, linked by VLC
+ * downlinks and an uplink over a SimpleChannel.
+ *
+ * \param helper the helper creating the devices
+ * \param nodes the nodes, the access point first
+ * \return the hybrid devices, the access point first
+ */
+static NetDeviceContainer
+CreateHybridLinks (VlcHelper &helper, NodeContainer &nodes)
+{
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  helper.SetChannel (channel);
+
+  nodes.Create (3);
+  Ptr<SimpleChannel> uplink = CreateObject<SimpleChannel> ();
+  NetDeviceContainer uplinkDevices;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (i == 0 ? Vector (0, 0, 0) : Vector (5.0 * (i % 2), 5.0 * (1 - i % 2), 0));
+      nodes.Get (i)->AggregateObject (mobility);
+
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (uplink);
+      nodes.Get (i)->AddDevice (device);
+      uplinkDevices.Add (device);
+    }
+  NetDeviceContainer vlcDevices = helper.Install (nodes);
+  helper.AssociateToVpan (vlcDevices, 0);
+  helper.AssignStreams (vlcDevices, 0);
+
+  NetDeviceContainer devices;
+  devices.Add (helper.InstallHybrid (NetDeviceContainer (vlcDevices.Get (0)),
+                                     NetDeviceContainer (uplinkDevices.Get (0)),
+                                     VlcHybridNetDevice::ACCESS_POINT));
+  NetDeviceContainer terminals = helper.InstallHybrid (NetDeviceContainer (vlcDevices.Get (1), vlcDevices.Get (2)),
+                                                       NetDeviceContainer (uplinkDevices.Get (1), uplinkDevices.Get (2)),
+                                                       VlcHybridNetDevice::TERMINAL);
+  for (uint32_t i = 0; i < terminals.GetN (); i++)
+    {
+      DynamicCast<VlcHybridNetDevice> (terminals.Get (i))->SetUplinkPeer (uplinkDevices.Get (0)->GetAddress ());
+    }
+  devices.Add (terminals);
+  return devices;
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Hybrid Net Device Test
+ *
+ * Tests that the access point sends over VLC, that the terminals send their
+ * data and the ACKs over the uplink, and the per-direction counters.
+ */
+class VlcHybridNetDeviceTestCase : public TestCase
+{
+public:
+  VlcHybridNetDeviceTestCase ();
+  virtual ~VlcHybridNetDeviceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a packet delivered to a protocol handler.
+   *
+   * \param device the device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the source address
+   * \param to the destination address
+   * \param type the packet type
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType type);
+
+  /**
+   * Count a frame sent over the VLC link.
+   *
+   * \param p the frame
+   */
+  void VlcTx (Ptr<const Packet> p);
+
+  /**
+   * Count a frame acknowledged over the VLC link.
+   *
+   * \param p the frame
+   */
+  void VlcTxOk (Ptr<const Packet> p);
+
+  std::vector<Ptr<NetDevice> > m_devices;  //!< the devices the packets were delivered to
+  std::vector<uint16_t> m_protocols;       //!< the protocols of the delivered packets
+  std::vector<Address> m_sources;          //!< the sources of the delivered packets
+  uint32_t m_vlcTx;                        //!< frames sent over the VLC link
+  uint32_t m_vlcTxOk;                      //!< frames acknowledged over the VLC link
+};
+
+VlcHybridNetDeviceTestCase::VlcHybridNetDeviceTestCase ()
+  : TestCase ("Test the VLC downlink and the uplink of the hybrid device"),
+    m_vlcTx (0),
+    m_vlcTxOk (0)
+{
+}
+
+VlcHybridNetDeviceTestCase::~VlcHybridNetDeviceTestCase ()
+{
+}
+
+void
+VlcHybridNetDeviceTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                                     const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  m_devices.push_back (device);
+  m_protocols.push_back (protocol);
+  m_sources.push_back (from);
+}
+
+void
+VlcHybridNetDeviceTestCase::VlcTx (Ptr<const Packet> p)
+{
+  m_vlcTx++;
+}
+
+void
+VlcHybridNetDeviceTestCase::VlcTxOk (Ptr<const Packet> p)
+{
+  m_vlcTxOk++;
+}
+
+void
+VlcHybridNetDeviceTestCase::DoRun (void)
+{
+  // Test setup:
+  // The access point sends 5 packets to each terminal, each terminal sends 3
+  // packets to the access point.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  VlcHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = CreateHybridLinks (helper, nodes);
+  Ptr<VlcHybridNetDevice> ap = DynamicCast<VlcHybridNetDevice> (devices.Get (0));
+
+  // The LLC/SNAP header carries the protocol numbers over VLC.
+  NS_TEST_ASSERT_MSG_EQ (ap->GetMtu (), 179, "Wrong MTU");
+  NS_TEST_ASSERT_MSG_EQ (ap->GetAddress (), ap->GetVlcDevice ()->GetAddress (), "Wrong address");
+
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<VlcHybridNetDevice> device = DynamicCast<VlcHybridNetDevice> (devices.Get (i));
+      nodes.Get (i)->RegisterProtocolHandler (MakeCallback (&VlcHybridNetDeviceTestCase::Receive, this),
+                                              0, device);
+      Ptr<VlcMac> mac = device->GetVlcDevice ()->GetMac ();
+      if (i == 0)
+        {
+          mac->TraceConnectWithoutContext ("MacTxOk", MakeCallback (&VlcHybridNetDeviceTestCase::VlcTxOk, this));
+        }
+      else
+        {
+          mac->TraceConnectWithoutContext ("MacTx", MakeCallback (&VlcHybridNetDeviceTestCase::VlcTx, this));
+        }
+    }
+
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      for (uint32_t j = 1; j < devices.GetN (); j++)
+        {
+          Simulator::Schedule (MilliSeconds (10 * i + 5 * j), &NetDevice::Send, ap, Create<Packet> (100),
+                               devices.Get (j)->GetAddress (), 0x1234);
+        }
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      for (uint32_t j = 1; j < devices.GetN (); j++)
+        {
+          Simulator::Schedule (MilliSeconds (10 * i + 5 * j + 1), &NetDevice::Send, devices.Get (j),
+                               Create<Packet> (50), ap->GetAddress (), 0x5678);
+        }
+    }
+
+  Simulator::Stop (MilliSeconds (100));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_vlcTx, 0, "Terminal sent over the VLC link");
+  NS_TEST_ASSERT_MSG_EQ (m_vlcTxOk, 10, "Relayed ACKs not received");
+  NS_TEST_ASSERT_MSG_EQ (m_devices.size (), 16, "Wrong number of packets delivered");
+  for (uint32_t i = 0; i < m_devices.size (); i++)
+    {
+      if (m_devices[i] == ap)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_protocols[i], 0x5678, "Wrong protocol of an uplink packet");
+          NS_TEST_ASSERT_MSG_EQ ((m_sources[i] == devices.Get (1)->GetAddress ()
+                                  || m_sources[i] == devices.Get (2)->GetAddress ()), true,
+                                 "Wrong source of an uplink packet");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_protocols[i], 0x1234, "Wrong protocol of a downlink packet");
+          NS_TEST_ASSERT_MSG_EQ (m_sources[i], ap->GetAddress (), "Wrong source of a downlink packet");
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (ap->GetDownlinkCounters ().m_txPackets, 10, "Wrong downlink packets sent");
+  NS_TEST_ASSERT_MSG_EQ (ap->GetDownlinkCounters ().m_txBytes, 1000, "Wrong downlink octets sent");
+  NS_TEST_ASSERT_MSG_EQ (ap->GetUplinkCounters ().m_rxPackets, 6, "Wrong uplink packets received");
+  NS_TEST_ASSERT_MSG_EQ (ap->GetUplinkCounters ().m_rxBytes, 300, "Wrong uplink octets received");
+  NS_TEST_ASSERT_MSG_EQ (ap->GetUplinkCounters ().m_rxAcks, 10, "Wrong ACKs received");
+  for (uint32_t j = 1; j < devices.GetN (); j++)
+    {
+      Ptr<VlcHybridNetDevice> terminal = DynamicCast<VlcHybridNetDevice> (devices.Get (j));
+      NS_TEST_ASSERT_MSG_EQ (terminal->GetDownlinkCounters ().m_rxPackets, 5, "Wrong downlink packets received");
+      NS_TEST_ASSERT_MSG_EQ (terminal->GetDownlinkCounters ().m_rxBytes, 500, "Wrong downlink octets received");
+      NS_TEST_ASSERT_MSG_EQ (terminal->GetUplinkCounters ().m_txPackets, 3, "Wrong uplink packets sent");
+      NS_TEST_ASSERT_MSG_EQ (terminal->GetUplinkCounters ().m_txAcks, 5, "Wrong ACKs relayed");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Hybrid Full Duplex Test
+ *
+ * Tests that the uplink traffic of the terminals leaves the saturated
+ * downlink throughput of the access point unchanged.
+ */
+class VlcHybridFullDuplexTestCase : public TestCase
+{
+public:
+  VlcHybridFullDuplexTestCase ();
+  virtual ~VlcHybridFullDuplexTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Saturate the downlink for one second.
+   *
+   * \param uplinkTraffic whether the terminals send over the uplink
+   * \return the packets acknowledged over the downlink
+   */
+  uint32_t RunDownlink (bool uplinkTraffic);
+
+  /**
+   * Keep a few packets queued at the access point.
+   *
+   * \param ap the access point
+   * \param dest the destination terminal
+   */
+  void Fill (Ptr<VlcHybridNetDevice> ap, Address dest);
+
+  /**
+   * Send a packet over the uplink every millisecond.
+   *
+   * \param terminal the terminal
+   * \param dest the access point
+   */
+  void SendUplink (Ptr<NetDevice> terminal, Address dest);
+
+  /**
+   * Count a frame acknowledged over the VLC link.
+   *
+   * \param p the frame
+   */
+  void VlcTxOk (Ptr<const Packet> p);
+
+  uint32_t m_vlcTxOk;  //!< frames acknowledged over the VLC link
+};
+
+VlcHybridFullDuplexTestCase::VlcHybridFullDuplexTestCase ()
+  : TestCase ("Test the downlink throughput of the hybrid device under uplink traffic"),
+    m_vlcTxOk (0)
+{
+}
+
+VlcHybridFullDuplexTestCase::~VlcHybridFullDuplexTestCase ()
+{
+}
+
+void
+VlcHybridFullDuplexTestCase::VlcTxOk (Ptr<const Packet> p)
+{
+  m_vlcTxOk++;
+}
+
+void
+VlcHybridFullDuplexTestCase::Fill (Ptr<VlcHybridNetDevice> ap, Address dest)
+{
+  if (ap->GetVlcDevice ()->GetMac ()->GetTxQueue ()->GetNPackets () < 4)
+    {
+      ap->Send (Create<Packet> (ap->GetMtu ()), dest, 0x1234);
+    }
+  Simulator::Schedule (MicroSeconds (100), &VlcHybridFullDuplexTestCase::Fill, this, ap, dest);
+}
+
+void
+VlcHybridFullDuplexTestCase::SendUplink (Ptr<NetDevice> terminal, Address dest)
+{
+  terminal->Send (Create<Packet> (100), dest, 0x5678);
+  Simulator::Schedule (MilliSeconds (1), &VlcHybridFullDuplexTestCase::SendUplink, this, terminal, dest);
+}
+
+uint32_t
+VlcHybridFullDuplexTestCase::RunDownlink (bool uplinkTraffic)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+  m_vlcTxOk = 0;
+
+  VlcHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = CreateHybridLinks (helper, nodes);
+  Ptr<VlcHybridNetDevice> ap = DynamicCast<VlcHybridNetDevice> (devices.Get (0));
+  ap->GetVlcDevice ()->GetMac ()->TraceConnectWithoutContext ("MacTxOk",
+                                                               MakeCallback (&VlcHybridFullDuplexTestCase::VlcTxOk, this));
+
+  Simulator::Schedule (MilliSeconds (1), &VlcHybridFullDuplexTestCase::Fill, this, ap, devices.Get (1)->GetAddress ());
+  if (uplinkTraffic)
+    {
+      for (uint32_t j = 1; j < devices.GetN (); j++)
+        {
+          Simulator::Schedule (MilliSeconds (1), &VlcHybridFullDuplexTestCase::SendUplink, this,
+                               devices.Get (j), ap->GetAddress ());
+        }
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_vlcTxOk;
+}
+
+void
+VlcHybridFullDuplexTestCase::DoRun (void)
+{
+  uint32_t idle = RunDownlink (false);
+  uint32_t loaded = RunDownlink (true);
+  NS_TEST_ASSERT_MSG_GT (idle, 500, "Downlink not saturated");
+  NS_TEST_ASSERT_MSG_EQ (loaded, idle, "Uplink traffic changed the downlink throughput");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Hybrid Net Device TestSuite
+ */
+class VlcHybridNetDeviceTestSuite : public TestSuite
+{
+public:
+  VlcHybridNetDeviceTestSuite ();
+};
+
+VlcHybridNetDeviceTestSuite::VlcHybridNetDeviceTestSuite ()
+  : TestSuite ("vlc-hybrid-net-device", UNIT)
+{
+  AddTestCase (new VlcHybridNetDeviceTestCase, TestCase::QUICK);
+  AddTestCase (new VlcHybridFullDuplexTestCase, TestCase::QUICK);
+}
+
+static VlcHybridNetDeviceTestSuite g_vlcHybridNetDeviceTestSuite; //!< Static variable for test initialization
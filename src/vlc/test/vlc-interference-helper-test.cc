@@ -0,0 +1,295 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/vlc-interference-helper.h>
+#include <ns3/vlc-spectrum-value-helper.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/system-wall-clock-ms.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Interference Helper Test
+ */
+class VlcInterferenceHelperTestCase : public TestCase
+{
+public:
+  VlcInterferenceHelperTestCase ();
+  virtual ~VlcInterferenceHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcInterferenceHelperTestCase::VlcInterferenceHelperTestCase ()
+  : TestCase ("Test the 802.15.7 interference helper")
+{
+}
+
+VlcInterferenceHelperTestCase::~VlcInterferenceHelperTestCase ()
+{
+}
+
+void
+VlcInterferenceHelperTestCase::DoRun (void)
+{
+  VlcSpectrumValueHelper psdHelper;
+  uint32_t channel = 0;
+
+  Ptr<SpectrumValue> wanted = psdHelper.CreateTxPowerSpectralDensity (0, channel);
+  Ptr<SpectrumValue> interferer1 = psdHelper.CreateTxPowerSpectralDensity (-10, channel);
+  Ptr<SpectrumValue> interferer2 = psdHelper.CreateTxPowerSpectralDensity (-20, channel);
+
+  Ptr<VlcInterferenceHelper> helper = Create<VlcInterferenceHelper> (wanted->GetSpectrumModel ());
+  NS_TEST_ASSERT_MSG_EQ (helper->AddSignal (wanted), true, "Signal not added");
+  NS_TEST_ASSERT_MSG_EQ (helper->AddSignal (interferer1), true, "Signal not added");
+  NS_TEST_ASSERT_MSG_EQ (helper->AddSignal (interferer2), true, "Signal not added");
+
+  double p0 = VlcSpectrumValueHelper::TotalAvgPower (wanted, channel);
+  double p1 = VlcSpectrumValueHelper::TotalAvgPower (interferer1, channel);
+  double p2 = VlcSpectrumValueHelper::TotalAvgPower (interferer2, channel);
+
+  // The scalar API has to match the result of the SpectrumValue arithmetic.
+  Ptr<SpectrumValue> interference = helper->GetSignalPsd ();
+  *interference -= *wanted;
+  double expected = VlcSpectrumValueHelper::TotalAvgPower (interference, channel);
+  NS_TEST_ASSERT_MSG_EQ_TOL (helper->GetInterferencePower (wanted, channel), expected, expected * 1e-9,
+                             "Interference power does not match the PSD difference");
+  NS_TEST_ASSERT_MSG_EQ_TOL (helper->GetInterferencePower (wanted, channel), p1 + p2, (p1 + p2) * 1e-9,
+                             "Wrong interference power");
+  NS_TEST_ASSERT_MSG_EQ_TOL (helper->GetSignalPower (channel), p0 + p1 + p2, (p0 + p1 + p2) * 1e-9,
+                             "Wrong total power");
+
+  // Removing a signal invalidates the sum, which has to be recomputed.
+  NS_TEST_ASSERT_MSG_EQ (helper->RemoveSignal (interferer1), true, "Signal not removed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (helper->GetInterferencePower (wanted, channel), p2, p2 * 1e-9,
+                             "Wrong interference power after removal");
+
+  // A lone signal sees no interference.
+  NS_TEST_ASSERT_MSG_EQ (helper->RemoveSignal (interferer2), true, "Signal not removed");
+  NS_TEST_ASSERT_MSG_EQ (helper->GetInterferencePower (wanted, channel), 0.0, "Lone signal sees interference");
+
+  helper->ClearSignals ();
+  NS_TEST_ASSERT_MSG_EQ (helper->GetSignalPower (channel), 0.0, "Cleared helper still holds power");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Interference Helper Incremental Mode Test
+ */
+class VlcInterferenceHelperIncrementalTestCase : public TestCase
+{
+public:
+  VlcInterferenceHelperIncrementalTestCase ();
+  virtual ~VlcInterferenceHelperIncrementalTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcInterferenceHelperIncrementalTestCase::VlcInterferenceHelperIncrementalTestCase ()
+  : TestCase ("Test the incremental sum of the 802.15.7 interference helper")
+{
+}
+
+VlcInterferenceHelperIncrementalTestCase::~VlcInterferenceHelperIncrementalTestCase ()
+{
+}
+
+void
+VlcInterferenceHelperIncrementalTestCase::DoRun (void)
+{
+  VlcSpectrumValueHelper psdHelper;
+  uint32_t channel = 0;
+  uint32_t nSignals = 200;
+
+  // Signals spanning several orders of magnitude make the incremental sum
+  // drift, if it is not recomputed from time to time.
+  std::vector<Ptr<SpectrumValue> > signals;
+  for (uint32_t i = 0; i < nSignals; i++)
+    {
+      signals.push_back (psdHelper.CreateTxPowerSpectralDensity (-60.0 + (i % 7) * 10.0, channel));
+    }
+
+  Ptr<VlcInterferenceHelper> incremental = Create<VlcInterferenceHelper> (signals[0]->GetSpectrumModel ());
+  Ptr<VlcInterferenceHelper> full = Create<VlcInterferenceHelper> (signals[0]->GetSpectrumModel ());
+  full->SetIncremental (false);
+  incremental->SetResummationInterval (16);
+  NS_TEST_ASSERT_MSG_EQ (incremental->IsIncremental (), true, "Incremental mode not enabled by default");
+
+  for (uint32_t i = 0; i < nSignals; i++)
+    {
+      incremental->AddSignal (signals[i]);
+      full->AddSignal (signals[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (incremental->AddSignal (signals[0]), false, "Signal added twice");
+  NS_TEST_ASSERT_MSG_EQ (incremental->GetNSignals (), nSignals, "Wrong number of signals");
+
+  // Remove every other signal, interleaved with queries.
+  for (uint32_t i = 0; i < nSignals; i += 2)
+    {
+      NS_TEST_ASSERT_MSG_EQ (incremental->RemoveSignal (signals[i]), true, "Signal not removed");
+      full->RemoveSignal (signals[i]);
+      double expected = full->GetInterferencePower (signals[i + 1], channel);
+      NS_TEST_ASSERT_MSG_EQ_TOL (incremental->GetInterferencePower (signals[i + 1], channel), expected, expected * 1e-9,
+                                 "Incremental sum diverged from the full sum");
+    }
+  NS_TEST_ASSERT_MSG_EQ (incremental->RemoveSignal (signals[0]), false, "Removed signal removed again");
+  NS_TEST_ASSERT_MSG_EQ (incremental->GetNSignals (), nSignals / 2, "Wrong number of signals");
+
+  // Removing the remaining signals leaves an exact zero.
+  for (uint32_t i = 1; i < nSignals; i += 2)
+    {
+      incremental->RemoveSignal (signals[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (incremental->GetSignalPower (channel), 0.0, "Empty helper still holds power");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Interference Helper TestSuite
+ */
+class VlcInterferenceHelperTestSuite : public TestSuite
+{
+public:
+  VlcInterferenceHelperTestSuite ();
+};
+
+VlcInterferenceHelperTestSuite::VlcInterferenceHelperTestSuite ()
+  : TestSuite ("vlc-interference-helper", UNIT)
+{
+  AddTestCase (new VlcInterferenceHelperTestCase, TestCase::QUICK);
+  AddTestCase (new VlcInterferenceHelperIncrementalTestCase, TestCase::QUICK);
+}
+
+static VlcInterferenceHelperTestSuite g_vlcInterferenceHelperTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Interference Helper Benchmark
+ *
+ * Measures the cost of a receiver cycle (add a signal, query the
+ * interference, remove the signal) against the number of signals already
+ * accumulated, with and without incremental maintenance of the sum.
+ */
+class VlcInterferenceHelperBenchmarkTestCase : public TestCase
+{
+public:
+  VlcInterferenceHelperBenchmarkTestCase ();
+  virtual ~VlcInterferenceHelperBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Time a number of add/query/remove cycles.
+   *
+   * \param nSignals the number of background signals
+   * \param incremental true to use incremental mode
+   * \return the time per cycle in ns
+   */
+  double RunCycles (uint32_t nSignals, bool incremental);
+};
+
+VlcInterferenceHelperBenchmarkTestCase::VlcInterferenceHelperBenchmarkTestCase ()
+  : TestCase ("Benchmark the 802.15.7 interference helper")
+{
+}
+
+VlcInterferenceHelperBenchmarkTestCase::~VlcInterferenceHelperBenchmarkTestCase ()
+{
+}
+
+double
+VlcInterferenceHelperBenchmarkTestCase::RunCycles (uint32_t nSignals, bool incremental)
+{
+  VlcSpectrumValueHelper psdHelper;
+  uint32_t channel = 0;
+  uint32_t nCycles = 20000;
+
+  Ptr<SpectrumValue> wanted = psdHelper.CreateTxPowerSpectralDensity (0, channel);
+  Ptr<VlcInterferenceHelper> helper = Create<VlcInterferenceHelper> (wanted->GetSpectrumModel ());
+  helper->SetIncremental (incremental);
+  for (uint32_t i = 0; i < nSignals; i++)
+    {
+      helper->AddSignal (psdHelper.CreateTxPowerSpectralDensity (-30, channel));
+    }
+
+  double sum = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nCycles; i++)
+    {
+      helper->AddSignal (wanted);
+      sum += helper->GetInterferencePower (wanted, channel);
+      helper->RemoveSignal (wanted);
+    }
+  int64_t elapsed = clock.End ();
+
+  NS_TEST_EXPECT_MSG_GT (sum, 0.0, "No interference measured");
+  return elapsed * 1e6 / nCycles;
+}
+
+void
+VlcInterferenceHelperBenchmarkTestCase::DoRun (void)
+{
+  std::cout << std::setw (10) << "signals"
+            << std::setw (20) << "incremental (ns)"
+            << std::setw (20) << "full (ns)" << std::endl;
+  for (uint32_t nSignals = 1; nSignals <= 1000; nSignals *= 10)
+    {
+      std::cout << std::setw (10) << nSignals
+                << std::setw (20) << RunCycles (nSignals, true)
+                << std::setw (20) << RunCycles (nSignals, false) << std::endl;
+    }
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Interference Helper Benchmark TestSuite
+ */
+class VlcInterferenceHelperBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcInterferenceHelperBenchmarkTestSuite ();
+};
+
+VlcInterferenceHelperBenchmarkTestSuite::VlcInterferenceHelperBenchmarkTestSuite ()
+  : TestSuite ("vlc-interference-helper-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcInterferenceHelperBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcInterferenceHelperBenchmarkTestSuite g_vlcInterferenceHelperBenchmarkTestSuite; //!< Static variable for test initialization
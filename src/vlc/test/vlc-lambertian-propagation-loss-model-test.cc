@@ -0,0 +1,126 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/vector.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/vlc-lambertian-propagation-loss-model.h>
+
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Lambertian Propagation Loss Model Test
+ */
+class VlcLambertianPropagationLossModelTestCase : public TestCase
+{
+public:
+  VlcLambertianPropagationLossModelTestCase ();
+  virtual ~VlcLambertianPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcLambertianPropagationLossModelTestCase::VlcLambertianPropagationLossModelTestCase ()
+  : TestCase ("Test the Lambertian line of sight channel gain")
+{
+}
+
+VlcLambertianPropagationLossModelTestCase::~VlcLambertianPropagationLossModelTestCase ()
+{
+}
+
+void
+VlcLambertianPropagationLossModelTestCase::DoRun (void)
+{
+  // A ceiling luminaire at 3 m pointing down and a photodetector on the floor
+  // pointing up.
+  Ptr<VlcLambertianPropagationLossModel> model = CreateObject<VlcLambertianPropagationLossModel> ();
+  model->SetTxNormal (Vector (0, 0, -1));
+  model->SetRxNormal (Vector (0, 0, 1));
+
+  Ptr<ConstantPositionMobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+  tx->SetPosition (Vector (0, 0, 3));
+  rx->SetPosition (Vector (1, 0, 0));
+
+  // Default parameters: semi-angle 60 degrees (m = 1), area 1 cm^2, filter
+  // gain 1, refractive index 1.5 and field of view 70 degrees.
+  double d2 = 10.0;
+  double cosAngle = 3.0 / std::sqrt (d2);
+  double concentratorGain = 1.5 * 1.5 / std::pow (std::sin (70.0 * M_PI / 180.0), 2);
+  double gain = 2 * 1.0e-4 / (2 * M_PI * d2) * cosAngle * concentratorGain * cosAngle;
+  double expected = 10 * std::log10 (gain);
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, tx, rx), expected, 1e-9, "Wrong channel gain");
+  // The second call is served from the cache.
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (10, tx, rx), 10 + expected, 1e-9, "Wrong cached channel gain");
+
+  // Moving the receiver outside the field of view has to invalidate the cache.
+  rx->SetPosition (Vector (10, 0, 0));
+  NS_TEST_ASSERT_MSG_EQ (std::isinf (model->CalcRxPower (0, tx, rx)), true, "Receiver outside the FOV sees light");
+
+  rx->SetPosition (Vector (0, 0, 1));
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, tx, rx), model->CalcGainDb (tx, rx), 1e-9,
+                             "Cached gain not invalidated on course change");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, tx, rx), 10 * std::log10 (2 * 1.0e-4 * concentratorGain / (2 * M_PI * 4.0)), 1e-9,
+                             "Wrong channel gain below the luminaire");
+
+  // Changing a parameter invalidates every cached gain.
+  model->SetFilterGain (0.5);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, tx, rx), 10 * std::log10 (1.0e-4 * concentratorGain / (2 * M_PI * 4.0)), 1e-9,
+                             "Cached gain not invalidated on parameter change");
+
+  // The gain is never larger than one.
+  rx->SetPosition (Vector (0, 0, 3));
+  NS_TEST_ASSERT_MSG_EQ (model->CalcRxPower (0, tx, rx), 0.0, "Gain larger than one");
+
+  // Mobile endpoints are not cached, but give the same result.
+  Ptr<ConstantVelocityMobilityModel> mobile = CreateObject<ConstantVelocityMobilityModel> ();
+  mobile->SetPosition (Vector (1, 0, 0));
+  model->SetFilterGain (1.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, tx, mobile), expected, 1e-9, "Wrong gain for a mobile receiver");
+
+  model->Dispose ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Lambertian Propagation Loss Model TestSuite
+ */
+class VlcLambertianPropagationLossModelTestSuite : public TestSuite
+{
+public:
+  VlcLambertianPropagationLossModelTestSuite ();
+};
+
+VlcLambertianPropagationLossModelTestSuite::VlcLambertianPropagationLossModelTestSuite ()
+  : TestSuite ("vlc-lambertian-propagation-loss-model", UNIT)
+{
+  AddTestCase (new VlcLambertianPropagationLossModelTestCase, TestCase::QUICK);
+}
+
+static VlcLambertianPropagationLossModelTestSuite g_vlcLambertianPropagationLossModelTestSuite; //!< Static variable for test initialization
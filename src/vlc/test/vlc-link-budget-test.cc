@@ -0,0 +1,211 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test that the link budget predicts the frames received by a simulated
+ * interference-free link.
+ */
+class VlcLinkBudgetTestCase : public TestCase
+{
+public:
+  VlcLinkBudgetTestCase ();
+  virtual ~VlcLinkBudgetTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Send frames over a simulated link, count the frames received and
+   * evaluate the link budget of the same link.
+   *
+   * \param distance the length of the link in m
+   * \param nFrames the number of frames to send
+   * \return the number of frames received
+   */
+  uint32_t RunLink (double distance, uint32_t nFrames);
+
+  /**
+   * Function called when a frame is received.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Function called when a frame is handed to the channel.
+   *
+   * \param p the frame
+   */
+  void PhyTxBegin (Ptr<const Packet> p);
+
+  uint32_t m_received;   //!< The number of frames received
+  uint32_t m_psduSize;   //!< The size of the frames sent
+  double m_psr;          //!< The packet success rate of the link budget
+  uint32_t m_drawn;      //!< The frames received drawn by the link budget
+  bool m_rxModelIntact;  //!< Whether the queries left the receiver's error model alone
+};
+
+VlcLinkBudgetTestCase::VlcLinkBudgetTestCase ()
+  : TestCase ("Test the link budget against a simulated link"),
+    m_received (0),
+    m_psduSize (0),
+    m_psr (0),
+    m_drawn (0),
+    m_rxModelIntact (false)
+{
+}
+
+VlcLinkBudgetTestCase::~VlcLinkBudgetTestCase ()
+{
+}
+
+void
+VlcLinkBudgetTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received++;
+}
+
+void
+VlcLinkBudgetTestCase::PhyTxBegin (Ptr<const Packet> p)
+{
+  m_psduSize = p->GetSize ();
+}
+
+uint32_t
+VlcLinkBudgetTestCase::RunLink (double distance, uint32_t nFrames)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (5);
+  m_received = 0;
+
+  Ptr<VlcLambertianPropagationLossModel> loss = CreateObject<VlcLambertianPropagationLossModel> ();
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (loss);
+  Ptr<VlcNetDevice> devices[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      devices[i] = CreateObject<VlcNetDevice> ();
+      devices[i]->AssignStreams (10 * i);
+      devices[i]->SetAddress (i == 0 ? Mac16Address ("00:01") : Mac16Address ("00:02"));
+      devices[i]->SetChannel (channel);
+      node->AddDevice (devices[i]);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i * distance, 0, 0));
+      devices[i]->GetPhy ()->SetMobility (mobility);
+    }
+  devices[0]->GetPhy ()->SetTxPower (30);
+  devices[0]->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcLinkBudgetTestCase::PhyTxBegin, this));
+  devices[1]->GetPhy ()->SetNoiseModel (CreateObject<VlcReceiverNoiseModel> ());
+  devices[1]->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcLinkBudgetTestCase::DataIndication, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = 0;
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::Schedule (MilliSeconds (i), &VlcMac::McpsDataRequest, devices[0]->GetMac (), params, Create<Packet> (20));
+    }
+  Simulator::Run ();
+
+  // Evaluate the link budget before the devices are disposed of.
+  Ptr<VlcLinkBudget> budget = CreateObject<VlcLinkBudget> ();
+  budget->SetPropagationLossModel (loss);
+  budget->AssignStreams (1);
+  m_psr = budget->GetPacketSuccessRate (devices[0]->GetPhy (), devices[1]->GetPhy (), m_psduSize);
+  m_drawn = budget->GetReceivedFrames (devices[0]->GetPhy (), devices[1]->GetPhy (), m_psduSize, nFrames);
+
+  // Sweeping the schemes at another dimming level only queries the PHY.
+  Ptr<VlcErrorModel> rxModel = devices[1]->GetPhy ()->GetErrorModel ();
+  VlcModulation modulation = rxModel->GetModulation ();
+  budget->GetBestMcs (devices[0]->GetPhy (), devices[1]->GetPhy (), m_psduSize, 0.2);
+  m_rxModelIntact = rxModel->GetModulation () == modulation && rxModel->GetDimmingLevel () == 0.5;
+  Simulator::Destroy ();
+  return m_received;
+}
+
+void
+VlcLinkBudgetTestCase::DoRun (void)
+{
+  // Test setup:
+  // A 1 W emitter faces a photodiode with the default receiver noise over a
+  // Lambertian channel, as in the receiver noise test. For every distance,
+  // the frames received in the simulation, the packet success rate of the
+  // link budget and the frames drawn by the link budget must agree within
+  // four standard deviations of the binomial distribution.
+  const uint32_t nFrames = 400;
+  double distances[] = { 10, 30, 31, 32, 33, 34, 40 };
+  bool partial = false;
+  for (uint32_t i = 0; i < sizeof (distances) / sizeof (distances[0]); i++)
+    {
+      uint32_t received = RunLink (distances[i], nFrames);
+      NS_TEST_ASSERT_MSG_GT (m_psduSize, 20, "No frame sent");
+      double expected = nFrames * m_psr;
+      double bound = 4 * std::sqrt (nFrames * m_psr * (1 - m_psr)) + 1;
+      NS_TEST_ASSERT_MSG_EQ_TOL (received, expected, bound, "Simulation and link budget disagree at " << distances[i] << " m");
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_drawn, expected, bound, "Frames drawn by the link budget disagree at " << distances[i] << " m");
+      partial = partial || (m_psr > 0.05 && m_psr < 0.95);
+    }
+  NS_TEST_ASSERT_MSG_EQ (partial, true, "No distance with a partial packet success rate");
+  NS_TEST_ASSERT_MSG_EQ (m_rxModelIntact, true, "Link budget changed the error model of the receiver");
+
+  NS_TEST_ASSERT_MSG_EQ (RunLink (10, 1), 1, "Frame lost at a short distance");
+  NS_TEST_ASSERT_MSG_EQ (m_psr, 1, "Packet success rate not 1 at a short distance");
+  RunLink (60, 1);
+  NS_TEST_ASSERT_MSG_LT (m_psr, 1e-6, "Packet success rate not 0 beyond the range");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Link budget test suite
+ */
+class VlcLinkBudgetTestSuite : public TestSuite
+{
+public:
+  VlcLinkBudgetTestSuite ();
+};
+
+VlcLinkBudgetTestSuite::VlcLinkBudgetTestSuite ()
+  : TestSuite ("vlc-link-budget", UNIT)
+{
+  AddTestCase (new VlcLinkBudgetTestCase, TestCase::QUICK);
+}
+
+static VlcLinkBudgetTestSuite g_vlcLinkBudgetTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,273 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Subframe and Block ACK Header Test
+ */
+class VlcMacAggregationHeaderTestCase : public TestCase
+{
+public:
+  VlcMacAggregationHeaderTestCase ();
+  virtual ~VlcMacAggregationHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcMacAggregationHeaderTestCase::VlcMacAggregationHeaderTestCase ()
+  : TestCase ("Test the serialization of the aggregation headers")
+{
+}
+
+VlcMacAggregationHeaderTestCase::~VlcMacAggregationHeaderTestCase ()
+{
+}
+
+void
+VlcMacAggregationHeaderTestCase::DoRun (void)
+{
+  Ptr<Packet> p = Create<Packet> (10);
+  VlcMacSubframeHeader subframeHdr;
+  subframeHdr.SetLength (10);
+  subframeHdr.SetSeqNum (201);
+  p->AddHeader (subframeHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 13, "Wrong subframe header size");
+
+  VlcMacSubframeHeader receivedSubframeHdr;
+  p->RemoveHeader (receivedSubframeHdr);
+  NS_TEST_ASSERT_MSG_EQ (receivedSubframeHdr.GetLength (), 10, "Wrong subframe length");
+  NS_TEST_ASSERT_MSG_EQ (receivedSubframeHdr.GetSeqNum (), 201, "Wrong subframe sequence number");
+
+  VlcMacBlockAckHeader blockAck;
+  blockAck.SetReceived (0);
+  blockAck.SetReceived (5);
+  blockAck.SetReceived (VlcMacBlockAckHeader::MAX_SUBFRAMES - 1);
+  p->AddHeader (blockAck);
+  VlcMacBlockAckHeader receivedBlockAck;
+  p->RemoveHeader (receivedBlockAck);
+  NS_TEST_ASSERT_MSG_EQ (receivedBlockAck.GetBitmap (), blockAck.GetBitmap (), "Wrong bitmap");
+  NS_TEST_ASSERT_MSG_EQ (receivedBlockAck.IsReceived (5), true, "Subframe not acknowledged");
+  NS_TEST_ASSERT_MSG_EQ (receivedBlockAck.IsReceived (6), false, "Subframe acknowledged");
+  NS_TEST_ASSERT_MSG_EQ (receivedBlockAck.IsReceived (VlcMacBlockAckHeader::MAX_SUBFRAMES - 1), true,
+                         "Last subframe not acknowledged");
+
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_DATA, 0);
+  NS_TEST_ASSERT_MSG_EQ (macHdr.IsAggregation (), false, "Aggregation bit set by default");
+  macHdr.SetAggregation ();
+  p->AddHeader (macHdr);
+  VlcMacHeader receivedMacHdr;
+  p->RemoveHeader (receivedMacHdr);
+  NS_TEST_ASSERT_MSG_EQ (receivedMacHdr.IsAggregation (), true, "Aggregation bit lost");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Aggregation Test
+ */
+class VlcMacAggregationTestCase : public TestCase
+{
+public:
+  VlcMacAggregationTestCase ();
+  virtual ~VlcMacAggregationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario: node 1 sends a burst of MSDUs with ACK request to
+   * node 2.
+   *
+   * \param aggregation whether aggregation is enabled
+   * \param nMsdus the number of MSDUs
+   * \return the time the last MSDU has been confirmed
+   */
+  Time RunBurst (bool aggregation, uint32_t nMsdus);
+
+  /**
+   * Record a received MSDU.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Record a confirmed MSDU.
+   *
+   * \param params the MCPS params
+   */
+  void DataConfirm (McpsDataConfirmParams params);
+
+  /**
+   * Record an aggregated PSDU.
+   *
+   * \param nMsdus the number of MSDUs in the PSDU
+   * \param psduSize the size of the PSDU
+   */
+  void Aggregate (uint32_t nMsdus, uint32_t psduSize);
+
+  std::vector<uint32_t> m_received;   //!< the sizes of the received MSDUs
+  std::vector<uint8_t> m_confirmed;   //!< the handles of the successfully confirmed MSDUs
+  uint32_t m_nPsdus;                  //!< the number of PSDUs built in aggregation mode
+  uint32_t m_nAggregatedMsdus;        //!< the number of MSDUs in these PSDUs
+  uint32_t m_maxPsduSize;             //!< the largest PSDU built in aggregation mode
+  Time m_lastConfirm;                 //!< the time of the last confirm
+};
+
+VlcMacAggregationTestCase::VlcMacAggregationTestCase ()
+  : TestCase ("Test the aggregation of MSDUs and the block ACK"),
+    m_nPsdus (0),
+    m_nAggregatedMsdus (0),
+    m_maxPsduSize (0)
+{
+}
+
+VlcMacAggregationTestCase::~VlcMacAggregationTestCase ()
+{
+}
+
+void
+VlcMacAggregationTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received.push_back (p->GetSize ());
+}
+
+void
+VlcMacAggregationTestCase::DataConfirm (McpsDataConfirmParams params)
+{
+  if (params.m_status == IEEE_802_15_7_SUCCESS)
+    {
+      m_confirmed.push_back (params.m_msduHandle);
+      m_lastConfirm = Simulator::Now ();
+    }
+}
+
+void
+VlcMacAggregationTestCase::Aggregate (uint32_t nMsdus, uint32_t psduSize)
+{
+  m_nPsdus++;
+  m_nAggregatedMsdus += nMsdus;
+  m_maxPsduSize = std::max (m_maxPsduSize, psduSize);
+}
+
+Time
+VlcMacAggregationTestCase::RunBurst (bool aggregation, uint32_t nMsdus)
+{
+  m_received.clear ();
+  m_confirmed.clear ();
+  m_nPsdus = 0;
+  m_nAggregatedMsdus = 0;
+  m_maxPsduSize = 0;
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestLink ();
+  Ptr<VlcNetDevice> dev0 = devices[0];
+  Ptr<VlcNetDevice> dev1 = devices[1];
+
+  dev0->GetPhy ()->SetAttribute ("MaxPsduSize", UintegerValue (1023));
+  dev1->GetPhy ()->SetAttribute ("MaxPsduSize", UintegerValue (1023));
+  dev0->GetMac ()->SetAttribute ("Aggregation", BooleanValue (aggregation));
+  dev0->GetMac ()->TraceConnectWithoutContext ("MacTxAggregate", MakeCallback (&VlcMacAggregationTestCase::Aggregate, this));
+  dev0->GetMac ()->SetMcpsDataConfirmCallback (MakeCallback (&VlcMacAggregationTestCase::DataConfirm, this));
+  dev1->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacAggregationTestCase::DataIndication, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = TX_OPTION_ACK;
+  for (uint32_t i = 0; i < nMsdus; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::ScheduleNow (&VlcMac::McpsDataRequest, dev0->GetMac (), params, Create<Packet> (50 + i));
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_lastConfirm;
+}
+
+void
+VlcMacAggregationTestCase::DoRun (void)
+{
+  // Test setup:
+  // Two nodes well in communication range. Node 1 queues a burst of MSDUs
+  // of about 50 octets with ACK request for node 2, first without and then
+  // with aggregation. With aggregation, several MSDUs share a PSDU larger
+  // than aMaxPhyPacketSize and a block ACK, and the burst completes sooner.
+  const uint32_t nMsdus = 20;
+
+  Time single = RunBurst (false, nMsdus);
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), nMsdus, "MSDUs lost without aggregation");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed.size (), nMsdus, "MSDUs not confirmed without aggregation");
+  NS_TEST_ASSERT_MSG_EQ (m_nPsdus, 0, "Aggregate traced without aggregation");
+
+  Time aggregated = RunBurst (true, nMsdus);
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), nMsdus, "MSDUs lost with aggregation");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed.size (), nMsdus, "MSDUs not confirmed with aggregation");
+  for (uint32_t i = 0; i < nMsdus; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], 50 + i, "MSDU received out of order or corrupted");
+      NS_TEST_ASSERT_MSG_EQ (m_confirmed[i], i, "MSDU confirmed out of order");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_nAggregatedMsdus, nMsdus, "Wrong number of aggregated MSDUs");
+  NS_TEST_ASSERT_MSG_LT (m_nPsdus, nMsdus, "No MSDUs aggregated");
+  NS_TEST_ASSERT_MSG_GT (m_maxPsduSize, 200, "PSDU not larger than aMaxPhyPacketSize");
+  NS_TEST_ASSERT_MSG_LT (m_maxPsduSize, 1024, "PSDU larger than MaxPsduSize");
+  NS_TEST_ASSERT_MSG_LT (aggregated, single, "Aggregation did not speed up the burst");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Aggregation TestSuite
+ */
+class VlcMacAggregationTestSuite : public TestSuite
+{
+public:
+  VlcMacAggregationTestSuite ();
+};
+
+VlcMacAggregationTestSuite::VlcMacAggregationTestSuite ()
+  : TestSuite ("vlc-mac-aggregation", UNIT)
+{
+  AddTestCase (new VlcMacAggregationHeaderTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMacAggregationTestCase, TestCase::QUICK);
+}
+
+static VlcMacAggregationTestSuite g_vlcMacAggregationTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,264 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <set>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Block ACK Window Test
+ */
+class VlcMacBlockAckTestCase : public TestCase
+{
+public:
+  VlcMacBlockAckTestCase ();
+  virtual ~VlcMacBlockAckTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario: node 1 sends a burst of MSDUs with ACK request to
+   * node 2.
+   *
+   * \param blockAck whether the block ACK window is enabled
+   * \param outage whether node 2 misses frames of the second window
+   * \param nMsdus the number of MSDUs
+   */
+  void RunBurst (bool blockAck, bool outage, uint32_t nMsdus);
+
+  /**
+   * Record a received MSDU.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Record a confirmed MSDU.
+   *
+   * \param params the MCPS params
+   */
+  void DataConfirm (McpsDataConfirmParams params);
+
+  /**
+   * Record an MSDU leaving the MAC.
+   *
+   * \param p the MSDU
+   * \param retries the number of transmissions
+   * \param backoffs the number of CSMA-CA attempts
+   */
+  void Sent (Ptr<const Packet> p, uint8_t retries, uint8_t backoffs);
+
+  /**
+   * Record a frame sent by node 2, an ACK in this scenario.
+   *
+   * \param p the frame
+   */
+  void AckTx (Ptr<const Packet> p);
+
+  /**
+   * Record a block ACK closing a window.
+   *
+   * \param nFrames the number of frames in the window
+   * \param saved the airtime saved
+   */
+  void BlockAck (uint32_t nFrames, Time saved);
+
+  std::vector<uint32_t> m_received;   //!< the sizes of the received MSDUs
+  std::vector<uint8_t> m_confirmed;   //!< the handles of the successfully confirmed MSDUs
+  uint32_t m_nRetried;                //!< the MSDUs sent more than once
+  uint32_t m_nAcks;                   //!< the frames sent by node 2
+  uint32_t m_nWindows;                //!< the block ACKs traced
+  uint32_t m_nWindowFrames;           //!< the frames in these windows
+  Time m_saved;                       //!< the airtime saved by these block ACKs
+};
+
+VlcMacBlockAckTestCase::VlcMacBlockAckTestCase ()
+  : TestCase ("Test the block ACK window and the selective retransmission"),
+    m_nRetried (0),
+    m_nAcks (0),
+    m_nWindows (0),
+    m_nWindowFrames (0)
+{
+}
+
+VlcMacBlockAckTestCase::~VlcMacBlockAckTestCase ()
+{
+}
+
+void
+VlcMacBlockAckTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received.push_back (p->GetSize ());
+}
+
+void
+VlcMacBlockAckTestCase::DataConfirm (McpsDataConfirmParams params)
+{
+  if (params.m_status == IEEE_802_15_7_SUCCESS)
+    {
+      m_confirmed.push_back (params.m_msduHandle);
+    }
+}
+
+void
+VlcMacBlockAckTestCase::Sent (Ptr<const Packet> p, uint8_t retries, uint8_t backoffs)
+{
+  if (retries > 1)
+    {
+      m_nRetried++;
+    }
+}
+
+void
+VlcMacBlockAckTestCase::AckTx (Ptr<const Packet> p)
+{
+  m_nAcks++;
+}
+
+void
+VlcMacBlockAckTestCase::BlockAck (uint32_t nFrames, Time saved)
+{
+  m_nWindows++;
+  m_nWindowFrames += nFrames;
+  m_saved += saved;
+}
+
+void
+VlcMacBlockAckTestCase::RunBurst (bool blockAck, bool outage, uint32_t nMsdus)
+{
+  m_received.clear ();
+  m_confirmed.clear ();
+  m_nRetried = 0;
+  m_nAcks = 0;
+  m_nWindows = 0;
+  m_nWindowFrames = 0;
+  m_saved = Time (0);
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (3);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestLink ();
+  Ptr<VlcNetDevice> dev0 = devices[0];
+  Ptr<VlcNetDevice> dev1 = devices[1];
+  if (outage)
+    {
+      // Some frames in the middle of the second window are lost.
+      Simulator::Schedule (MilliSeconds (3), &VlcPhy::PlmeSetTRXStateRequest, dev1->GetPhy (), IEEE_802_15_7_PHY_TRX_OFF);
+      Simulator::Schedule (MicroSeconds (4500), &VlcPhy::PlmeSetTRXStateRequest, dev1->GetPhy (), IEEE_802_15_7_PHY_RX_ON);
+    }
+
+  dev0->GetMac ()->SetAttribute ("BlockAck", BooleanValue (blockAck));
+  dev0->GetMac ()->SetAttribute ("BlockAckWindow", UintegerValue (8));
+  dev0->GetMac ()->SetMacMaxFrameRetries (7);
+  dev0->GetMac ()->TraceConnectWithoutContext ("MacSentPkt", MakeCallback (&VlcMacBlockAckTestCase::Sent, this));
+  dev0->GetMac ()->TraceConnectWithoutContext ("BlockAckAirtimeSaved",
+                                               MakeCallback (&VlcMacBlockAckTestCase::BlockAck, this));
+  dev0->GetMac ()->SetMcpsDataConfirmCallback (MakeCallback (&VlcMacBlockAckTestCase::DataConfirm, this));
+  dev1->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcMacBlockAckTestCase::AckTx, this));
+  dev1->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacBlockAckTestCase::DataIndication, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = TX_OPTION_ACK;
+  for (uint32_t i = 0; i < nMsdus; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::ScheduleNow (&VlcMac::McpsDataRequest, dev0->GetMac (), params, Create<Packet> (50 + i));
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+VlcMacBlockAckTestCase::DoRun (void)
+{
+  // Test setup:
+  // Two nodes, node 1 queues a burst of MSDUs with ACK request for node 2.
+  // With the block ACK window, one block ACK per window of up to 8 frames
+  // replaces the ACK of every frame; the first MSDU is sent alone, before
+  // the others are queued. Then node 2 turns its receiver off for a few frames:
+  // only the missing frames are sent again, every MSDU is delivered once
+  // and confirmed.
+  const uint32_t nMsdus = 20;
+
+  RunBurst (false, false, nMsdus);
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), nMsdus, "MSDUs lost without block ACK");
+  NS_TEST_ASSERT_MSG_EQ (m_nAcks, nMsdus, "Not one ACK per MSDU without block ACK");
+  NS_TEST_ASSERT_MSG_EQ (m_nWindows, 0, "Block ACK traced without block ACK");
+
+  RunBurst (true, false, nMsdus);
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), nMsdus, "MSDUs lost with block ACK");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed.size (), nMsdus, "MSDUs not confirmed with block ACK");
+  for (uint32_t i = 0; i < nMsdus; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], 50 + i, "MSDU received out of order or corrupted");
+      NS_TEST_ASSERT_MSG_EQ (m_confirmed[i], i, "MSDU confirmed out of order");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_nAcks, 4, "Not one block ACK per window");
+  NS_TEST_ASSERT_MSG_EQ (m_nWindows, 4, "Not one block ACK traced per window");
+  NS_TEST_ASSERT_MSG_EQ (m_nWindowFrames, nMsdus, "Wrong number of frames in the windows");
+  NS_TEST_ASSERT_MSG_GT (m_saved, Time (0), "No ACK airtime saved");
+  NS_TEST_ASSERT_MSG_EQ (m_nRetried, 0, "MSDUs retransmitted in good range");
+
+  RunBurst (true, true, nMsdus);
+  std::set<uint32_t> received (m_received.begin (), m_received.end ());
+  std::set<uint8_t> confirmed (m_confirmed.begin (), m_confirmed.end ());
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), nMsdus, "MSDUs lost or duplicated during the outage");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), nMsdus, "MSDUs duplicated during the outage");
+  NS_TEST_ASSERT_MSG_EQ (confirmed.size (), nMsdus, "MSDUs not confirmed during the outage");
+  NS_TEST_ASSERT_MSG_GT (m_nRetried, 0, "No MSDU retransmitted during the outage");
+  NS_TEST_ASSERT_MSG_LT (m_nRetried, 8, "Received MSDUs retransmitted during the outage");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Block ACK TestSuite
+ */
+class VlcMacBlockAckTestSuite : public TestSuite
+{
+public:
+  VlcMacBlockAckTestSuite ();
+};
+
+VlcMacBlockAckTestSuite::VlcMacBlockAckTestSuite ()
+  : TestSuite ("vlc-mac-block-ack", UNIT)
+{
+  AddTestCase (new VlcMacBlockAckTestCase, TestCase::QUICK);
+}
+
+static VlcMacBlockAckTestSuite g_vlcMacBlockAckTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,504 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create an MPDU of a coordinator for a device, as kept for indirect
+ * transmission.
+ *
+ * \param size the MSDU size
+ * \param dst the short address of the device
+ * \return the MPDU
+ */
+static Ptr<Packet>
+CreateMpdu (uint32_t size, Mac16Address dst)
+{
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_DATA, 0);
+  macHdr.SetSrcAddrMode (SHORT_ADDR);
+  macHdr.SetSrcAddrFields (0, Mac16Address ("00:01"));
+  macHdr.SetDstAddrMode (SHORT_ADDR);
+  macHdr.SetDstAddrFields (0, dst);
+  Ptr<Packet> p = Create<Packet> (size);
+  p->AddHeader (macHdr);
+  p->AddTrailer (VlcMacTrailer ());
+  return p;
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Pending Transaction Table Test
+ */
+class VlcPendingTransactionTableTestCase : public TestCase
+{
+public:
+  VlcPendingTransactionTableTestCase ();
+  virtual ~VlcPendingTransactionTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record an expired transaction.
+   *
+   * \param p the packet
+   * \param msduHandle the MSDU handle
+   */
+  void Expired (Ptr<const Packet> p, uint8_t msduHandle);
+
+  std::vector<std::pair<Time, uint8_t> > m_expired; //!< the expiry times and handles
+};
+
+VlcPendingTransactionTableTestCase::VlcPendingTransactionTableTestCase ()
+  : TestCase ("Test the pending transactions of the coordinator")
+{
+}
+
+VlcPendingTransactionTableTestCase::~VlcPendingTransactionTableTestCase ()
+{
+}
+
+void
+VlcPendingTransactionTableTestCase::Expired (Ptr<const Packet> p, uint8_t msduHandle)
+{
+  m_expired.push_back (std::make_pair (Simulator::Now (), msduHandle));
+}
+
+void
+VlcPendingTransactionTableTestCase::DoRun (void)
+{
+  Ptr<VlcPendingTransactionTable> table = CreateObject<VlcPendingTransactionTable> ();
+  table->SetAttribute ("MaxTransactions", UintegerValue (4));
+  table->SetExpireCallback (MakeCallback (&VlcPendingTransactionTableTestCase::Expired, this));
+
+  Mac16Address dev2 ("00:02");
+  Mac16Address dev3 ("00:03");
+  NS_TEST_ASSERT_MSG_EQ (table->Enqueue (CreateMpdu (10, dev2), 1, MilliSeconds (50)), true, "First transaction rejected");
+  NS_TEST_ASSERT_MSG_EQ (table->Enqueue (CreateMpdu (20, dev3), 2, MilliSeconds (10)), true, "Second transaction rejected");
+  NS_TEST_ASSERT_MSG_EQ (table->Enqueue (CreateMpdu (30, dev2), 3, MilliSeconds (50)), true, "Third transaction rejected");
+  NS_TEST_ASSERT_MSG_EQ (table->Enqueue (CreateMpdu (40, dev2), 4, MilliSeconds (50)), true, "Fourth transaction rejected");
+  NS_TEST_ASSERT_MSG_EQ (table->Enqueue (CreateMpdu (50, dev3), 5, MilliSeconds (50)), false, "Table grew beyond its limit");
+  NS_TEST_ASSERT_MSG_EQ (table->GetNTransactions (), 4, "Wrong number of transactions");
+
+  // Every device is announced once, in order of its oldest transaction.
+  std::vector<Mac16Address> shortAddresses;
+  std::vector<Mac64Address> extAddresses;
+  table->GetPendingAddresses (7, shortAddresses, extAddresses);
+  NS_TEST_ASSERT_MSG_EQ (shortAddresses.size (), 2, "Wrong number of pending addresses");
+  NS_TEST_ASSERT_MSG_EQ (shortAddresses[0], dev2, "Wrong first pending address");
+  NS_TEST_ASSERT_MSG_EQ (shortAddresses[1], dev3, "Wrong second pending address");
+  NS_TEST_ASSERT_MSG_EQ (extAddresses.size (), 0, "Extended address pending");
+  table->GetPendingAddresses (1, shortAddresses, extAddresses);
+  NS_TEST_ASSERT_MSG_EQ (shortAddresses.size (), 1, "Pending addresses not limited");
+
+  // Transactions of a device are extracted in order of arrival, a restored
+  // one comes first again.
+  VlcPendingTransaction transaction;
+  NS_TEST_ASSERT_MSG_EQ (table->Extract (dev2, transaction), true, "No transaction of 00:02");
+  NS_TEST_ASSERT_MSG_EQ (transaction.m_msduHandle, 1, "Wrong first transaction of 00:02");
+  NS_TEST_ASSERT_MSG_EQ (table->Restore (transaction), true, "Transaction not restored");
+  NS_TEST_ASSERT_MSG_EQ (table->Extract (dev2, transaction), true, "No transaction of 00:02");
+  NS_TEST_ASSERT_MSG_EQ (transaction.m_msduHandle, 1, "Restored transaction not first");
+  NS_TEST_ASSERT_MSG_EQ (table->Extract (dev2, transaction), true, "No transaction of 00:02");
+  NS_TEST_ASSERT_MSG_EQ (transaction.m_msduHandle, 3, "Wrong second transaction of 00:02");
+  NS_TEST_ASSERT_MSG_EQ (table->IsPending (dev2), true, "Last transaction of 00:02 lost");
+  NS_TEST_ASSERT_MSG_EQ (table->IsPending (Mac16Address ("00:04")), false, "Transaction of an unknown device");
+  NS_TEST_ASSERT_MSG_EQ (table->Extract (Mac64Address ("00:00:00:00:00:00:00:02"), transaction), false,
+                         "Short address matched an extended one");
+
+  // The transactions left expire one after the other.
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired.size (), 2, "Wrong number of expired transactions");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[0].first, MilliSeconds (10), "Wrong expiry time");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[0].second, 2, "Wrong first expired transaction");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[1].first, MilliSeconds (50), "Wrong expiry time");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[1].second, 4, "Wrong second expired transaction");
+  NS_TEST_ASSERT_MSG_EQ (table->IsEmpty (), true, "Expired transactions kept");
+  transaction.m_expiry = Simulator::Now ();
+  NS_TEST_ASSERT_MSG_EQ (table->Restore (transaction), false, "Expired transaction restored");
+
+  // The beacon carries the pending addresses.
+  VlcMacBeaconHeader beaconHdr;
+  beaconHdr.SetBeaconOrder (6);
+  beaconHdr.SetSuperframeOrder (6);
+  beaconHdr.AddPendingShortAddress (dev2);
+  beaconHdr.AddPendingExtAddress (Mac64Address ("00:00:00:00:00:00:00:07"));
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (beaconHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 4 + 2 + 8, "Wrong size of a beacon with pending addresses");
+  VlcMacBeaconHeader receivedBeaconHdr;
+  p->RemoveHeader (receivedBeaconHdr);
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.GetNPendingAddresses (), 2, "Wrong number of pending addresses");
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.GetPendingShortAddresses ()[0], dev2, "Wrong pending short address");
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.GetPendingExtAddresses ()[0], Mac64Address ("00:00:00:00:00:00:00:07"),
+                         "Wrong pending extended address");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Indirect Transmission Test
+ *
+ * Tests the indirect transmission of a coordinator without beacons to a
+ * device that switches its receiver off when idle and polls for its data.
+ */
+class VlcMacIndirectTestCase : public TestCase
+{
+public:
+  VlcMacIndirectTestCase ();
+  virtual ~VlcMacIndirectTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record an MSDU received by the device.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Record the outcome of an MSDU of the coordinator.
+   *
+   * \param params the MCPS params
+   */
+  void DataConfirm (McpsDataConfirmParams params);
+
+  /**
+   * Record the outcome of a poll of the device.
+   *
+   * \param params the MLME params
+   */
+  void PollConfirm (MlmePollConfirmParams params);
+
+  /**
+   * Accumulate the time the receiver of the device is on.
+   *
+   * \param t the time of the state change
+   * \param oldState the previous state
+   * \param newState the new state
+   */
+  void TrxState (Time t, VlcPhyEnumeration oldState, VlcPhyEnumeration newState);
+
+  std::vector<uint32_t> m_received;                        //!< the sizes of the received MSDUs
+  std::map<uint8_t, VlcMcpsDataConfirmStatus> m_confirmed; //!< the status of every MSDU handle
+  std::vector<VlcMlmeStatus> m_polls;                      //!< the status of every poll
+  Time m_onTime;                                           //!< the time the transceiver was on
+  Time m_onSince;                                          //!< the last time it was switched on
+};
+
+VlcMacIndirectTestCase::VlcMacIndirectTestCase ()
+  : TestCase ("Test the indirect transmission to a polling device")
+{
+}
+
+VlcMacIndirectTestCase::~VlcMacIndirectTestCase ()
+{
+}
+
+void
+VlcMacIndirectTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received.push_back (p->GetSize ());
+}
+
+void
+VlcMacIndirectTestCase::DataConfirm (McpsDataConfirmParams params)
+{
+  m_confirmed[params.m_msduHandle] = params.m_status;
+}
+
+void
+VlcMacIndirectTestCase::PollConfirm (MlmePollConfirmParams params)
+{
+  m_polls.push_back (params.m_status);
+}
+
+void
+VlcMacIndirectTestCase::TrxState (Time t, VlcPhyEnumeration oldState, VlcPhyEnumeration newState)
+{
+  if (oldState == IEEE_802_15_7_PHY_TRX_OFF && newState != IEEE_802_15_7_PHY_TRX_OFF)
+    {
+      m_onSince = t;
+    }
+  else if (oldState != IEEE_802_15_7_PHY_TRX_OFF && newState == IEEE_802_15_7_PHY_TRX_OFF)
+    {
+      m_onTime += t - m_onSince;
+    }
+}
+
+void
+VlcMacIndirectTestCase::DoRun (void)
+{
+  // Test setup:
+  // The coordinator keeps two MSDUs for device 00:02, which keeps its
+  // receiver off when idle, and one for device 00:03, which never polls.
+  // The first poll of 00:02 returns both MSDUs, the second one no data.
+  // The MSDU of 00:03 expires, and a direct MSDU to the sleeping 00:02 is
+  // not acknowledged.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestVpan (2);
+  Ptr<VlcMac> coordinator = devices[0]->GetMac ();
+  Ptr<VlcMac> device = devices[1]->GetMac ();
+  coordinator->SetMcpsDataConfirmCallback (MakeCallback (&VlcMacIndirectTestCase::DataConfirm, this));
+  device->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacIndirectTestCase::DataIndication, this));
+  device->SetMlmePollConfirmCallback (MakeCallback (&VlcMacIndirectTestCase::PollConfirm, this));
+  devices[1]->GetPhy ()->TraceConnectWithoutContext ("TrxState", MakeCallback (&VlcMacIndirectTestCase::TrxState, this));
+  Simulator::ScheduleNow (&VlcMac::SetRxOnWhenIdle, device, false);
+
+  MlmeStartRequestParams startParams;
+  Simulator::ScheduleNow (&VlcMac::MlmeStartRequest, coordinator, startParams);
+
+  // The persistence time is 500 base superframes of 64 us.
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = TX_OPTION_ACK | TX_OPTION_INDIRECT;
+  params.m_msduHandle = 1;
+  Simulator::Schedule (MilliSeconds (5), &VlcMac::McpsDataRequest, coordinator, params, Create<Packet> (30));
+  params.m_msduHandle = 2;
+  Simulator::Schedule (MilliSeconds (5), &VlcMac::McpsDataRequest, coordinator, params, Create<Packet> (40));
+  params.m_dstAddr = Mac16Address ("00:03");
+  params.m_msduHandle = 3;
+  Simulator::Schedule (MilliSeconds (5), &VlcMac::McpsDataRequest, coordinator, params, Create<Packet> (50));
+
+  MlmePollRequestParams pollParams;
+  pollParams.m_coordAddrMode = SHORT_ADDR;
+  pollParams.m_coordVpanId = 0;
+  pollParams.m_coordShortAddr = Mac16Address ("00:01");
+  Simulator::Schedule (MilliSeconds (10), &VlcMac::MlmePollRequest, device, pollParams);
+  Simulator::Schedule (MilliSeconds (20), &VlcMac::MlmePollRequest, device, pollParams);
+
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_msduHandle = 4;
+  params.m_txOptions = TX_OPTION_ACK;
+  Simulator::Schedule (MilliSeconds (50), &VlcMac::McpsDataRequest, coordinator, params, Create<Packet> (60));
+
+  Simulator::Stop (MilliSeconds (100));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_polls.size (), 2, "Wrong number of poll confirms");
+  NS_TEST_ASSERT_MSG_EQ (m_polls[0], MLME_SUCCESS, "No data for the first poll");
+  NS_TEST_ASSERT_MSG_EQ (m_polls[1], MLME_NO_DATA, "Data for the second poll");
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "Wrong number of MSDUs received");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], 30, "Wrong first MSDU");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 40, "Wrong second MSDU");
+
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed.size (), 4, "Wrong number of MSDU confirms");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[1], IEEE_802_15_7_SUCCESS, "First indirect MSDU not acknowledged");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[2], IEEE_802_15_7_SUCCESS, "Second indirect MSDU not acknowledged");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[3], IEEE_802_15_7_TRANSACTION_EXPIRED, "Unpolled MSDU did not expire");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[4], IEEE_802_15_7_NO_ACK, "Direct MSDU to a sleeping device acknowledged");
+  NS_TEST_ASSERT_MSG_EQ (coordinator->GetPendingTransactionTable ()->IsEmpty (), true, "Transactions left");
+
+  // The receiver of the device is only on around its polls.
+  NS_TEST_ASSERT_MSG_LT (m_onTime, MilliSeconds (5), "Receiver of the polling device not switched off");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Indirect Transmission with Beacons Test
+ *
+ * Tests that a device tracking the beacons asks for the data announced in
+ * the pending address fields.
+ */
+class VlcMacIndirectBeaconTestCase : public TestCase
+{
+public:
+  VlcMacIndirectBeaconTestCase ();
+  virtual ~VlcMacIndirectBeaconTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the pending addresses of a beacon.
+   *
+   * \param p the beacon payload
+   */
+  void BeaconRx (Ptr<const Packet> p);
+
+  /**
+   * Record an MSDU received by the device.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Record the outcome of an MSDU of the coordinator.
+   *
+   * \param params the MCPS params
+   */
+  void DataConfirm (McpsDataConfirmParams params);
+
+  std::vector<std::pair<Time, uint32_t> > m_beacons;       //!< the times and number of pending addresses
+  std::vector<std::pair<Time, uint32_t> > m_received;      //!< the times and sizes of the received MSDUs
+  std::map<uint8_t, VlcMcpsDataConfirmStatus> m_confirmed; //!< the status of every MSDU handle
+};
+
+VlcMacIndirectBeaconTestCase::VlcMacIndirectBeaconTestCase ()
+  : TestCase ("Test the indirect transmission announced in the beacons")
+{
+}
+
+VlcMacIndirectBeaconTestCase::~VlcMacIndirectBeaconTestCase ()
+{
+}
+
+void
+VlcMacIndirectBeaconTestCase::BeaconRx (Ptr<const Packet> p)
+{
+  VlcMacBeaconHeader beaconHdr;
+  p->PeekHeader (beaconHdr);
+  m_beacons.push_back (std::make_pair (Simulator::Now (), beaconHdr.GetNPendingAddresses ()));
+}
+
+void
+VlcMacIndirectBeaconTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received.push_back (std::make_pair (Simulator::Now (), p->GetSize ()));
+}
+
+void
+VlcMacIndirectBeaconTestCase::DataConfirm (McpsDataConfirmParams params)
+{
+  m_confirmed[params.m_msduHandle] = params.m_status;
+}
+
+void
+VlcMacIndirectBeaconTestCase::DoRun (void)
+{
+  // Test setup:
+  // A coordinator sends beacons with BO = SO = 6, every 4.096 ms. It keeps
+  // an MSDU for device 00:02, which tracks the beacons, and one for device
+  // 00:03, which does not. The next beacon announces both devices, 00:02
+  // asks for its MSDU within that superframe, the MSDU of 00:03 stays
+  // announced.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestVpan (2);
+  Ptr<VlcMac> coordinator = devices[0]->GetMac ();
+  coordinator->SetMcpsDataConfirmCallback (MakeCallback (&VlcMacIndirectBeaconTestCase::DataConfirm, this));
+  devices[1]->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacIndirectBeaconTestCase::DataIndication, this));
+  Simulator::ScheduleNow (&VlcMac::MlmeSyncRequest, devices[1]->GetMac (), MlmeSyncRequestParams ());
+  devices[1]->GetMac ()->TraceConnectWithoutContext ("MacBeaconRx", MakeCallback (&VlcMacIndirectBeaconTestCase::BeaconRx, this));
+
+  MlmeStartRequestParams startParams;
+  startParams.m_beaconOrder = 6;
+  startParams.m_superframeOrder = 6;
+  Simulator::Schedule (MilliSeconds (1), &VlcMac::MlmeStartRequest, coordinator, startParams);
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_txOptions = TX_OPTION_ACK | TX_OPTION_INDIRECT;
+  for (uint8_t i = 1; i < devices.size (); i++)
+    {
+      params.m_dstAddr = Mac16Address::ConvertFrom (devices[i]->GetAddress ());
+      params.m_msduHandle = i;
+      Simulator::Schedule (MilliSeconds (10), &VlcMac::McpsDataRequest, coordinator, params, Create<Packet> (20 * i));
+    }
+
+  Simulator::Stop (MilliSeconds (30));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed.size (), 1, "Wrong number of MSDU confirms");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[1], IEEE_802_15_7_SUCCESS, "MSDU of 00:02 not delivered");
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 1, "Wrong number of MSDUs received");
+  NS_TEST_ASSERT_MSG_EQ (coordinator->GetPendingTransactionTable ()->IsPending (Mac16Address ("00:03")), true,
+                         "MSDU of 00:03 not kept");
+
+  // Both devices are announced by the first beacon after the requests, the
+  // following beacons only announce 00:03.
+  Time announced;
+  for (uint32_t i = 0; i < m_beacons.size (); i++)
+    {
+      if (m_beacons[i].first < MilliSeconds (10))
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_beacons[i].second, 0, "Pending address before the requests");
+        }
+      else if (announced.IsZero ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_beacons[i].second, 2, "Devices not announced");
+          announced = m_beacons[i].first;
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_beacons[i].second, 1, "Extracted MSDU still announced");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (announced.IsZero (), false, "No beacon after the requests");
+  for (uint32_t i = 0; i < m_received.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_received[i].first, announced, "MSDU received before the announcement");
+      NS_TEST_ASSERT_MSG_LT (m_received[i].first, announced + MicroSeconds (4096), "MSDU not received in the superframe");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Indirect Transmission TestSuite
+ */
+class VlcMacIndirectTestSuite : public TestSuite
+{
+public:
+  VlcMacIndirectTestSuite ();
+};
+
+VlcMacIndirectTestSuite::VlcMacIndirectTestSuite ()
+  : TestSuite ("vlc-mac-indirect", UNIT)
+{
+  AddTestCase (new VlcPendingTransactionTableTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMacIndirectTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMacIndirectBeaconTestCase, TestCase::QUICK);
+}
+
+static VlcMacIndirectTestSuite g_vlcMacIndirectTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,231 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/packet.h>
+#include <ns3/uinteger.h>
+#include <ns3/enum.h>
+#include <ns3/vlc-mac-queue.h>
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Queue Test
+ */
+class VlcMacQueueTestCase : public TestCase
+{
+public:
+  VlcMacQueueTestCase ();
+  virtual ~VlcMacQueueTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a dropped MSDU.
+   *
+   * \param p the dropped packet
+   * \param msduHandle the MSDU handle of the dropped packet
+   */
+  void Dropped (Ptr<const Packet> p, uint8_t msduHandle);
+
+  /**
+   * Record a sojourn time.
+   *
+   * \param sojourn the sojourn time
+   */
+  void Sojourn (Time sojourn);
+
+  /**
+   * Enqueue an MSDU of 100 bytes.
+   *
+   * \param queue the queue
+   * \param msduHandle the MSDU handle
+   */
+  void EnqueueOne (Ptr<VlcMacQueue> queue, uint8_t msduHandle);
+
+  /**
+   * Dequeue an MSDU and record its handle.
+   *
+   * \param queue the queue
+   */
+  void DequeueOne (Ptr<VlcMacQueue> queue);
+
+  std::vector<uint8_t> m_dropped;     //!< the handles of the dropped MSDUs
+  std::vector<uint8_t> m_dequeued;    //!< the handles of the dequeued MSDUs
+  std::vector<Time> m_sojourn;        //!< the traced sojourn times
+};
+
+VlcMacQueueTestCase::VlcMacQueueTestCase ()
+  : TestCase ("Test the limits and drop policies of the MAC transaction queue")
+{
+}
+
+VlcMacQueueTestCase::~VlcMacQueueTestCase ()
+{
+}
+
+void
+VlcMacQueueTestCase::Dropped (Ptr<const Packet> p, uint8_t msduHandle)
+{
+  m_dropped.push_back (msduHandle);
+}
+
+void
+VlcMacQueueTestCase::Sojourn (Time sojourn)
+{
+  m_sojourn.push_back (sojourn);
+}
+
+void
+VlcMacQueueTestCase::EnqueueOne (Ptr<VlcMacQueue> queue, uint8_t msduHandle)
+{
+  queue->Enqueue (Create<Packet> (100), msduHandle);
+}
+
+void
+VlcMacQueueTestCase::DequeueOne (Ptr<VlcMacQueue> queue)
+{
+  Ptr<Packet> p;
+  uint8_t msduHandle;
+  if (queue->Dequeue (p, msduHandle))
+    {
+      m_dequeued.push_back (msduHandle);
+    }
+}
+
+void
+VlcMacQueueTestCase::DoRun (void)
+{
+  // The queue is unbounded by default.
+  Ptr<VlcMacQueue> queue = CreateObject<VlcMacQueue> ();
+  queue->SetDropCallback (MakeCallback (&VlcMacQueueTestCase::Dropped, this));
+  for (uint8_t i = 0; i < 200; i++)
+    {
+      EnqueueOne (queue, i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (queue->GetNPackets (), 200, "Default queue is bounded");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped.size (), 0, "Default queue dropped an MSDU");
+
+  // Drop tail with a packet limit.
+  queue->Flush ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (3));
+  for (uint8_t i = 0; i < 5; i++)
+    {
+      EnqueueOne (queue, i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (queue->GetNPackets (), 3, "Packet limit exceeded");
+  NS_TEST_ASSERT_MSG_EQ (queue->GetNBytes (), 300, "Wrong number of bytes");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped.size (), 2, "Wrong number of drops");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[0], 3, "Drop tail dropped the wrong MSDU");
+  NS_TEST_ASSERT_MSG_EQ (queue->Peek ()->GetSize (), 100, "Wrong head");
+  DequeueOne (queue);
+  NS_TEST_ASSERT_MSG_EQ (m_dequeued[0], 0, "Drop tail reordered the queue");
+
+  // Drop head with a byte limit.
+  m_dropped.clear ();
+  m_dequeued.clear ();
+  queue->Flush ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (0));
+  queue->SetAttribute ("MaxBytes", UintegerValue (250));
+  queue->SetAttribute ("DropPolicy", EnumValue (VlcMacQueue::DROP_HEAD));
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      EnqueueOne (queue, i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (queue->GetNBytes (), 200, "Byte limit exceeded");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped.size (), 2, "Wrong number of drops");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[0], 0, "Drop head dropped the wrong MSDU");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[1], 1, "Drop head dropped the wrong MSDU");
+  NS_TEST_ASSERT_MSG_EQ (queue->Enqueue (Create<Packet> (300), 9), false, "Oversized MSDU enqueued");
+  NS_TEST_ASSERT_MSG_EQ (queue->GetNPackets (), 2, "Oversized MSDU flushed the queue");
+
+  // The ring grows beyond its initial size and keeps the order.
+  m_dequeued.clear ();
+  queue->Flush ();
+  queue->SetAttribute ("MaxBytes", UintegerValue (0));
+  for (uint8_t i = 0; i < 40; i++)
+    {
+      EnqueueOne (queue, i);
+      if (i % 3 == 0)
+        {
+          DequeueOne (queue);
+        }
+    }
+  while (!queue->IsEmpty ())
+    {
+      DequeueOne (queue);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_dequeued.size (), 40, "MSDUs lost");
+  for (uint8_t i = 0; i < 40; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_dequeued[i], i, "Queue reordered");
+    }
+
+  // CoDel: 20 MSDUs arrive at once and are served every 20 ms, so the sojourn
+  // time stays above the 5 ms target for more than the 100 ms interval.
+  m_dropped.clear ();
+  m_dequeued.clear ();
+  queue->SetAttribute ("DropPolicy", EnumValue (VlcMacQueue::CODEL));
+  queue->TraceConnectWithoutContext ("SojournTime", MakeCallback (&VlcMacQueueTestCase::Sojourn, this));
+  for (uint8_t i = 0; i < 20; i++)
+    {
+      EnqueueOne (queue, i);
+    }
+  for (uint32_t i = 1; i <= 20; i++)
+    {
+      Simulator::Schedule (MilliSeconds (20 * i), &VlcMacQueueTestCase::DequeueOne, this, queue);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_dropped.size (), 0, "CoDel did not drop");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped.size () + m_dequeued.size (), 20, "MSDUs lost");
+  NS_TEST_ASSERT_MSG_EQ (m_dequeued[0], 0, "CoDel dropped below the target");
+  NS_TEST_ASSERT_MSG_EQ (m_sojourn.size (), m_dequeued.size (), "Wrong number of sojourn times");
+  NS_TEST_ASSERT_MSG_EQ (m_sojourn[0], MilliSeconds (20), "Wrong sojourn time");
+  NS_TEST_ASSERT_MSG_EQ (queue->GetTotalDroppedPackets (), 5 + m_dropped.size (), "Wrong drop counter");
+
+  queue->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Queue TestSuite
+ */
+class VlcMacQueueTestSuite : public TestSuite
+{
+public:
+  VlcMacQueueTestSuite ();
+};
+
+VlcMacQueueTestSuite::VlcMacQueueTestSuite ()
+  : TestSuite ("vlc-mac-queue", UNIT)
+{
+  AddTestCase (new VlcMacQueueTestCase, TestCase::QUICK);
+}
+
+static VlcMacQueueTestSuite g_vlcMacQueueTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,703 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/system-wall-clock-ms.h>
+
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Beacon and Command Header Test
+ */
+class VlcMacSuperframeHeaderTestCase : public TestCase
+{
+public:
+  VlcMacSuperframeHeaderTestCase ();
+  virtual ~VlcMacSuperframeHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcMacSuperframeHeaderTestCase::VlcMacSuperframeHeaderTestCase ()
+  : TestCase ("Test the serialization of the beacon and GTS request headers")
+{
+}
+
+VlcMacSuperframeHeaderTestCase::~VlcMacSuperframeHeaderTestCase ()
+{
+}
+
+void
+VlcMacSuperframeHeaderTestCase::DoRun (void)
+{
+  VlcMacBeaconHeader beaconHdr;
+  beaconHdr.SetBeaconOrder (9);
+  beaconHdr.SetSuperframeOrder (8);
+  beaconHdr.SetFinalCapSlot (11);
+  beaconHdr.SetVpanCoordinator (true);
+  beaconHdr.SetGtsPermit (true);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (beaconHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 4, "Wrong size of a beacon without GTS");
+
+  VlcGtsDescriptor transmit;
+  transmit.m_address = Mac16Address ("00:02");
+  transmit.m_startingSlot = 14;
+  transmit.m_length = 2;
+  transmit.m_direction = GTS_TRANSMIT;
+  VlcGtsDescriptor denial;
+  denial.m_address = Mac16Address ("00:03");
+  denial.m_startingSlot = 0;
+  denial.m_length = 4;
+  denial.m_direction = GTS_RECEIVE;
+  beaconHdr.AddGtsDescriptor (transmit);
+  beaconHdr.AddGtsDescriptor (denial);
+  p = Create<Packet> ();
+  p->AddHeader (beaconHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 11, "Wrong size of a beacon with two GTS descriptors");
+
+  VlcMacBeaconHeader receivedBeaconHdr;
+  p->RemoveHeader (receivedBeaconHdr);
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.GetBeaconOrder (), 9, "Wrong beacon order");
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.GetSuperframeOrder (), 8, "Wrong superframe order");
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.GetFinalCapSlot (), 11, "Wrong final CAP slot");
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.IsVpanCoordinator (), true, "Coordinator bit lost");
+  NS_TEST_ASSERT_MSG_EQ (receivedBeaconHdr.IsGtsPermit (), true, "GTS permit bit lost");
+  const std::vector<VlcGtsDescriptor> &descriptors = receivedBeaconHdr.GetGtsDescriptors ();
+  NS_TEST_ASSERT_MSG_EQ (descriptors.size (), 2, "Wrong number of GTS descriptors");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[0].m_address, Mac16Address ("00:02"), "Wrong GTS address");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[0].m_startingSlot, 14, "Wrong GTS starting slot");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[0].m_length, 2, "Wrong GTS length");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[0].m_direction, GTS_TRANSMIT, "Wrong GTS direction");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[1].m_address, Mac16Address ("00:03"), "Wrong denial address");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[1].m_startingSlot, 0, "Denial not signalled");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[1].m_length, 4, "Wrong denial length");
+  NS_TEST_ASSERT_MSG_EQ (descriptors[1].m_direction, GTS_RECEIVE, "Wrong denial direction");
+
+  VlcMacCommandHeader commandHdr (VlcMacCommandHeader::GTS_REQUEST);
+  commandHdr.SetGtsCharacteristics (3, GTS_RECEIVE, true);
+  p->AddHeader (commandHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 2, "Wrong size of a GTS request");
+  VlcMacCommandHeader receivedCommandHdr;
+  p->RemoveHeader (receivedCommandHdr);
+  NS_TEST_ASSERT_MSG_EQ (receivedCommandHdr.GetCommandId (), VlcMacCommandHeader::GTS_REQUEST, "Wrong command");
+  NS_TEST_ASSERT_MSG_EQ (receivedCommandHdr.GetGtsLength (), 3, "Wrong requested length");
+  NS_TEST_ASSERT_MSG_EQ (receivedCommandHdr.GetGtsDirection (), GTS_RECEIVE, "Wrong requested direction");
+  NS_TEST_ASSERT_MSG_EQ (receivedCommandHdr.IsGtsAllocation (), true, "Wrong request type");
+
+  VlcMacCommandHeader dataRequestHdr (VlcMacCommandHeader::DATA_REQUEST);
+  p->AddHeader (dataRequestHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1, "Wrong size of a data request");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc GTS Scheduler Test
+ */
+class VlcGtsSchedulerTestCase : public TestCase
+{
+public:
+  VlcGtsSchedulerTestCase ();
+  virtual ~VlcGtsSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcGtsSchedulerTestCase::VlcGtsSchedulerTestCase ()
+  : TestCase ("Test the allocation of GTSs by the coordinator")
+{
+}
+
+VlcGtsSchedulerTestCase::~VlcGtsSchedulerTestCase ()
+{
+}
+
+void
+VlcGtsSchedulerTestCase::DoRun (void)
+{
+  Ptr<VlcGtsScheduler> scheduler = CreateObject<VlcGtsScheduler> ();
+  scheduler->SetMinCapSlots (9);
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetFinalCapSlot (), 15, "CAP not the whole superframe");
+
+  // GTSs are allocated from the end of the superframe.
+  VlcGtsDescriptor descriptor;
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (Mac16Address ("00:02"), 2, GTS_TRANSMIT, descriptor), true,
+                         "First GTS denied");
+  NS_TEST_ASSERT_MSG_EQ (descriptor.m_startingSlot, 14, "Wrong starting slot of the first GTS");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (Mac16Address ("00:03"), 3, GTS_TRANSMIT, descriptor), true,
+                         "Second GTS denied");
+  NS_TEST_ASSERT_MSG_EQ (descriptor.m_startingSlot, 11, "Wrong starting slot of the second GTS");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetFinalCapSlot (), 10, "Wrong final CAP slot");
+
+  // Requests shrinking the CAP below its minimum or repeating a GTS are denied.
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (Mac16Address ("00:04"), 3, GTS_TRANSMIT, descriptor), false,
+                         "CAP shrunk below its minimum");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (Mac16Address ("00:02"), 1, GTS_TRANSMIT, descriptor), false,
+                         "Second GTS of a device in the same direction");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (Mac16Address ("00:04"), 0, GTS_TRANSMIT, descriptor), false,
+                         "Empty GTS allocated");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (Mac16Address ("00:04"), 2, GTS_TRANSMIT, descriptor), true,
+                         "Third GTS denied");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetFinalCapSlot (), 8, "Wrong final CAP slot");
+
+  // Releasing a GTS moves the following ones towards the end.
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Deallocate (Mac16Address ("00:03"), GTS_RECEIVE), false,
+                         "Deallocated a GTS in the wrong direction");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Deallocate (Mac16Address ("00:03"), GTS_TRANSMIT), true,
+                         "GTS not deallocated");
+  const std::vector<VlcGtsDescriptor> &allocations = scheduler->GetAllocations ();
+  NS_TEST_ASSERT_MSG_EQ (allocations.size (), 2, "Wrong number of GTSs");
+  NS_TEST_ASSERT_MSG_EQ (allocations[0].m_startingSlot, 14, "First GTS moved");
+  NS_TEST_ASSERT_MSG_EQ (allocations[1].m_address, Mac16Address ("00:04"), "Wrong GTS order");
+  NS_TEST_ASSERT_MSG_EQ (allocations[1].m_startingSlot, 12, "Third GTS not compacted");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetFinalCapSlot (), 11, "Wrong final CAP slot");
+
+  scheduler->Clear ();
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetFinalCapSlot (), 15, "GTSs not cleared");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Superframe Test
+ */
+class VlcMacSuperframeTestCase : public TestCase
+{
+public:
+  VlcMacSuperframeTestCase ();
+  virtual ~VlcMacSuperframeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the start of a superframe.
+   *
+   * \param p the beacon
+   */
+  void BeaconTx (Ptr<const Packet> p);
+
+  /**
+   * Count a received beacon.
+   *
+   * \param p the beacon
+   */
+  void BeaconRx (Ptr<const Packet> p);
+
+  /**
+   * Record an MSDU received by the coordinator.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Record the outcome of an MSDU of the device.
+   *
+   * \param params the MCPS params
+   */
+  void DataConfirm (McpsDataConfirmParams params);
+
+  /**
+   * Record the outcome of the VPAN start.
+   *
+   * \param params the MLME params
+   */
+  void StartConfirm (MlmeStartConfirmParams params);
+
+  /**
+   * Record the outcome of a GTS request of the device.
+   *
+   * \param params the MLME params
+   */
+  void GtsConfirm (MlmeGtsConfirmParams params);
+
+  /**
+   * Record a GTS change at the coordinator.
+   *
+   * \param params the MLME params
+   */
+  void GtsIndication (MlmeGtsIndicationParams params);
+
+  /**
+   * Record the final CAP slot of the coordinator.
+   *
+   * \param mac the MAC of the coordinator
+   */
+  void RecordFinalCapSlot (Ptr<VlcMac> mac);
+
+  Ptr<VlcPhy> m_coordinatorPhy;                      //!< the PHY of the coordinator
+  std::vector<Time> m_superframeStarts;              //!< the starts of the superframes
+  uint32_t m_beaconsReceived;                        //!< the beacons received by the device
+  std::vector<std::pair<Time, uint32_t> > m_received; //!< the times and sizes of the received MSDUs
+  std::map<uint8_t, VlcMcpsDataConfirmStatus> m_confirmed; //!< the status of every MSDU handle
+  VlcMlmeStatus m_startStatus;                       //!< the status of the VPAN start
+  std::vector<MlmeGtsConfirmParams> m_gtsConfirms;   //!< the GTS confirms of the device
+  std::vector<MlmeGtsIndicationParams> m_gtsIndications; //!< the GTS indications of the coordinator
+  uint8_t m_finalCapSlot;                            //!< the final CAP slot with the GTS
+};
+
+VlcMacSuperframeTestCase::VlcMacSuperframeTestCase ()
+  : TestCase ("Test the superframe with CAP and GTS transmissions"),
+    m_beaconsReceived (0),
+    m_startStatus (MLME_INVALID_PARAMETER),
+    m_finalCapSlot (0)
+{
+}
+
+VlcMacSuperframeTestCase::~VlcMacSuperframeTestCase ()
+{
+}
+
+void
+VlcMacSuperframeTestCase::BeaconTx (Ptr<const Packet> p)
+{
+  // The trace is fired at the end of the beacon.
+  m_superframeStarts.push_back (Simulator::Now () - VlcPhy::GetPpduDuration (m_coordinatorPhy->GetMcs (), p->GetSize ()));
+}
+
+void
+VlcMacSuperframeTestCase::BeaconRx (Ptr<const Packet> p)
+{
+  m_beaconsReceived++;
+}
+
+void
+VlcMacSuperframeTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received.push_back (std::make_pair (Simulator::Now (), p->GetSize ()));
+}
+
+void
+VlcMacSuperframeTestCase::DataConfirm (McpsDataConfirmParams params)
+{
+  m_confirmed[params.m_msduHandle] = params.m_status;
+}
+
+void
+VlcMacSuperframeTestCase::StartConfirm (MlmeStartConfirmParams params)
+{
+  m_startStatus = params.m_status;
+}
+
+void
+VlcMacSuperframeTestCase::GtsConfirm (MlmeGtsConfirmParams params)
+{
+  m_gtsConfirms.push_back (params);
+}
+
+void
+VlcMacSuperframeTestCase::GtsIndication (MlmeGtsIndicationParams params)
+{
+  m_gtsIndications.push_back (params);
+}
+
+void
+VlcMacSuperframeTestCase::RecordFinalCapSlot (Ptr<VlcMac> mac)
+{
+  m_finalCapSlot = mac->GetGtsScheduler ()->GetFinalCapSlot ();
+}
+
+void
+VlcMacSuperframeTestCase::DoRun (void)
+{
+  // Test setup:
+  // A coordinator sends beacons with BO = SO = 8, superframes of 16 slots
+  // of 1.024 ms at PHY II OOK 6 Mb/s. The device synchronizes with the
+  // beacons and obtains a transmit GTS of two slots. Its GTS MSDUs arrive
+  // inside the GTS, its CAP MSDU inside the CAP. A receive GTS is denied,
+  // and the transmit GTS is released at the end.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestVpan (1);
+  Ptr<VlcMac> coordinator = devices[0]->GetMac ();
+  Ptr<VlcMac> device = devices[1]->GetMac ();
+  m_coordinatorPhy = devices[0]->GetPhy ();
+  Time slot = Seconds ((60 << 8) / m_coordinatorPhy->GetDataOrSymbolRate (false));
+
+  coordinator->TraceConnectWithoutContext ("MacBeaconTx", MakeCallback (&VlcMacSuperframeTestCase::BeaconTx, this));
+  coordinator->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacSuperframeTestCase::DataIndication, this));
+  coordinator->SetMlmeStartConfirmCallback (MakeCallback (&VlcMacSuperframeTestCase::StartConfirm, this));
+  coordinator->SetMlmeGtsIndicationCallback (MakeCallback (&VlcMacSuperframeTestCase::GtsIndication, this));
+  device->TraceConnectWithoutContext ("MacBeaconRx", MakeCallback (&VlcMacSuperframeTestCase::BeaconRx, this));
+  device->SetMcpsDataConfirmCallback (MakeCallback (&VlcMacSuperframeTestCase::DataConfirm, this));
+  device->SetMlmeGtsConfirmCallback (MakeCallback (&VlcMacSuperframeTestCase::GtsConfirm, this));
+
+  MlmeStartRequestParams startParams;
+  startParams.m_beaconOrder = 8;
+  startParams.m_superframeOrder = 8;
+  Simulator::Schedule (MilliSeconds (1), &VlcMac::MlmeStartRequest, coordinator, startParams);
+  Simulator::ScheduleNow (&VlcMac::MlmeSyncRequest, device, MlmeSyncRequestParams ());
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:01");
+  params.m_txOptions = TX_OPTION_ACK | TX_OPTION_GTS;
+  params.m_msduHandle = 100;
+  Simulator::Schedule (MilliSeconds (5), &VlcMac::McpsDataRequest, device, params, Create<Packet> (20));
+
+  MlmeGtsRequestParams gtsParams;
+  gtsParams.m_gtsLength = 2;
+  gtsParams.m_direction = GTS_TRANSMIT;
+  gtsParams.m_allocation = true;
+  Simulator::Schedule (MilliSeconds (20), &VlcMac::MlmeGtsRequest, device, gtsParams);
+  Simulator::Schedule (MilliSeconds (59), &VlcMacSuperframeTestCase::RecordFinalCapSlot, this, coordinator);
+
+  for (uint8_t i = 0; i < 3; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::Schedule (MilliSeconds (60), &VlcMac::McpsDataRequest, device, params, Create<Packet> (20));
+    }
+  params.m_msduHandle = 3;
+  params.m_txOptions = TX_OPTION_ACK;
+  Simulator::Schedule (MilliSeconds (60), &VlcMac::McpsDataRequest, device, params, Create<Packet> (30));
+
+  gtsParams.m_gtsLength = 1;
+  gtsParams.m_direction = GTS_RECEIVE;
+  Simulator::Schedule (MilliSeconds (120), &VlcMac::MlmeGtsRequest, device, gtsParams);
+  gtsParams.m_direction = GTS_TRANSMIT;
+  gtsParams.m_allocation = false;
+  Simulator::Schedule (MilliSeconds (160), &VlcMac::MlmeGtsRequest, device, gtsParams);
+
+  params.m_msduHandle = 101;
+  params.m_txOptions = TX_OPTION_ACK | TX_OPTION_GTS;
+  Simulator::Schedule (MilliSeconds (200), &VlcMac::McpsDataRequest, device, params, Create<Packet> (20));
+
+  Simulator::Stop (MilliSeconds (220));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_startStatus, MLME_SUCCESS, "VPAN not started");
+  NS_TEST_ASSERT_MSG_GT (m_superframeStarts.size (), 12, "Beacons not sent every beacon interval");
+  NS_TEST_ASSERT_MSG_EQ (m_beaconsReceived, m_superframeStarts.size (), "Beacons not received");
+
+  NS_TEST_ASSERT_MSG_EQ (m_gtsConfirms.size (), 3, "Wrong number of GTS confirms");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsConfirms[0].m_status, MLME_SUCCESS, "GTS not allocated");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsConfirms[1].m_status, MLME_DENIED, "Receive GTS not denied");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsConfirms[2].m_status, MLME_SUCCESS, "GTS not deallocated");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsConfirms[2].m_allocation, false, "Wrong request confirmed");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsIndications.size (), 2, "Wrong number of GTS indications");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsIndications[0].m_devAddress, Mac16Address ("00:02"), "Wrong device");
+  NS_TEST_ASSERT_MSG_EQ (m_gtsIndications[0].m_gtsLength, 2, "Wrong GTS length");
+  NS_TEST_ASSERT_MSG_EQ (m_finalCapSlot, 13, "CAP not shortened by the GTS");
+  NS_TEST_ASSERT_MSG_EQ (coordinator->GetGtsScheduler ()->GetAllocations ().size (), 0, "GTS not released");
+
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed.size (), 6, "Wrong number of MSDU confirms");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[100], IEEE_802_15_7_INVALID_GTS, "GTS MSDU accepted before the allocation");
+  NS_TEST_ASSERT_MSG_EQ (m_confirmed[101], IEEE_802_15_7_INVALID_GTS, "GTS MSDU accepted after the deallocation");
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_confirmed[i], IEEE_802_15_7_SUCCESS, "MSDU " << (uint32_t) i << " not acknowledged");
+    }
+
+  // GTS MSDUs are received in slots 14 and 15, the CAP MSDU before.
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 4, "Wrong number of received MSDUs");
+  uint32_t nGts = 0;
+  for (uint32_t i = 0; i < m_received.size (); i++)
+    {
+      Time start = m_superframeStarts.front ();
+      for (uint32_t j = 0; j < m_superframeStarts.size () && m_superframeStarts[j] < m_received[i].first; j++)
+        {
+          start = m_superframeStarts[j];
+        }
+      Time offset = m_received[i].first - start;
+      if (m_received[i].second == 20)
+        {
+          nGts++;
+          NS_TEST_ASSERT_MSG_GT (offset, 14 * slot, "GTS MSDU received before the GTS");
+          NS_TEST_ASSERT_MSG_LT (offset, 16 * slot, "GTS MSDU received after the GTS");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_LT (offset, 14 * slot, "CAP MSDU received outside of the CAP");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (nGts, 3, "Wrong number of GTS MSDUs");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Superframe TestSuite
+ */
+class VlcMacSuperframeTestSuite : public TestSuite
+{
+public:
+  VlcMacSuperframeTestSuite ();
+};
+
+VlcMacSuperframeTestSuite::VlcMacSuperframeTestSuite ()
+  : TestSuite ("vlc-mac-superframe", UNIT)
+{
+  AddTestCase (new VlcMacSuperframeHeaderTestCase, TestCase::QUICK);
+  AddTestCase (new VlcGtsSchedulerTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMacSuperframeTestCase, TestCase::QUICK);
+}
+
+static VlcMacSuperframeTestSuite g_vlcMacSuperframeTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Superframe Benchmark
+ *
+ * Compares the latency of a periodic flow of one device under the load of
+ * contending devices, with unslotted CSMA-CA, with slotted CSMA-CA in the
+ * CAP and with a GTS.
+ */
+class VlcMacSuperframeBenchmarkTestCase : public TestCase
+{
+public:
+  VlcMacSuperframeBenchmarkTestCase ();
+  virtual ~VlcMacSuperframeBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * The channel access of the periodic flow.
+   */
+  enum Access
+  {
+    UNSLOTTED,   //!< unslotted CSMA-CA without beacons
+    SLOTTED,     //!< slotted CSMA-CA in the CAP
+    GTS          //!< GTS of the device
+  };
+
+  /**
+   * Run the scenario.
+   *
+   * \param access the channel access of the periodic flow
+   * \param nContenders the number of contending devices
+   */
+  void Run (enum Access access, uint32_t nContenders);
+
+  /**
+   * Send an MSDU of the periodic flow.
+   *
+   * \param mac the MAC of the device
+   * \param params the MCPS params
+   */
+  void SendPeriodic (Ptr<VlcMac> mac, McpsDataRequestParams params);
+
+  /**
+   * Record the latency of an MSDU of the periodic flow.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  std::vector<Time> m_sent;       //!< the request times of the periodic MSDUs
+  std::set<uint32_t> m_received;  //!< the indices of the received periodic MSDUs
+  Time m_totalLatency;            //!< the sum of their latencies
+  Time m_maxLatency;              //!< the largest latency
+};
+
+VlcMacSuperframeBenchmarkTestCase::VlcMacSuperframeBenchmarkTestCase ()
+  : TestCase ("Benchmark the latency of CAP and GTS transmissions")
+{
+}
+
+VlcMacSuperframeBenchmarkTestCase::~VlcMacSuperframeBenchmarkTestCase ()
+{
+}
+
+void
+VlcMacSuperframeBenchmarkTestCase::SendPeriodic (Ptr<VlcMac> mac, McpsDataRequestParams params)
+{
+  // The payload carries the index of the MSDU.
+  uint32_t index = m_sent.size ();
+  uint8_t payload[20] = {0};
+  payload[0] = index & 0xff;
+  payload[1] = (index >> 8) & 0xff;
+  m_sent.push_back (Simulator::Now ());
+  mac->McpsDataRequest (params, Create<Packet> (payload, sizeof (payload)));
+}
+
+void
+VlcMacSuperframeBenchmarkTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  if (params.m_srcAddr != Mac16Address ("00:02"))
+    {
+      return;
+    }
+  uint8_t payload[2];
+  p->CopyData (payload, 2);
+  uint32_t index = payload[0] | (payload[1] << 8);
+  if (!m_received.insert (index).second)
+    {
+      // A retransmission after a lost acknowledgment.
+      return;
+    }
+  Time latency = Simulator::Now () - m_sent[index];
+  m_totalLatency += latency;
+  m_maxLatency = std::max (m_maxLatency, latency);
+}
+
+void
+VlcMacSuperframeBenchmarkTestCase::Run (enum Access access, uint32_t nContenders)
+{
+  m_sent.clear ();
+  m_received.clear ();
+  m_totalLatency = Seconds (0);
+  m_maxLatency = Seconds (0);
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestVpan (nContenders + 1);
+  Ptr<VlcMac> coordinator = devices[0]->GetMac ();
+  coordinator->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacSuperframeBenchmarkTestCase::DataIndication, this));
+
+  if (access != UNSLOTTED)
+    {
+      MlmeStartRequestParams startParams;
+      startParams.m_beaconOrder = 8;
+      startParams.m_superframeOrder = 8;
+      Simulator::Schedule (MilliSeconds (1), &VlcMac::MlmeStartRequest, coordinator, startParams);
+      for (uint32_t i = 1; i < devices.size (); i++)
+        {
+          Simulator::ScheduleNow (&VlcMac::MlmeSyncRequest, devices[i]->GetMac (), MlmeSyncRequestParams ());
+        }
+    }
+  if (access == GTS)
+    {
+      MlmeGtsRequestParams gtsParams;
+      gtsParams.m_gtsLength = 2;
+      Simulator::Schedule (MilliSeconds (20), &VlcMac::MlmeGtsRequest, devices[1]->GetMac (), gtsParams);
+    }
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:01");
+  params.m_txOptions = TX_OPTION_ACK;
+
+  // The contenders send an MSDU of 80 octets every 10 ms each.
+  Time stop = Seconds (2.1);
+  for (uint32_t i = 2; i < devices.size (); i++)
+    {
+      for (Time t = MilliSeconds (100) + MicroSeconds (1300 * i); t < stop; t += MilliSeconds (10))
+        {
+          Simulator::Schedule (t, &VlcMac::McpsDataRequest, devices[i]->GetMac (), params, Create<Packet> (80));
+        }
+    }
+
+  // The periodic flow sends an MSDU of 20 octets every 15 ms, a bit less
+  // than the beacon interval.
+  if (access == GTS)
+    {
+      params.m_txOptions = TX_OPTION_ACK | TX_OPTION_GTS;
+    }
+  for (Time t = MilliSeconds (100); t < Seconds (2); t += MilliSeconds (15))
+    {
+      Simulator::Schedule (t, &VlcMacSuperframeBenchmarkTestCase::SendPeriodic, this, devices[1]->GetMac (), params);
+    }
+
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+VlcMacSuperframeBenchmarkTestCase::DoRun (void)
+{
+  const char *names[] = {"unslotted", "slotted CAP", "GTS"};
+  uint32_t contenders[] = {0, 2, 4, 8};
+
+  std::cout << std::setw (15) << "access"
+            << std::setw (15) << "contenders"
+            << std::setw (15) << "delivered"
+            << std::setw (20) << "mean latency (ms)"
+            << std::setw (20) << "max latency (ms)"
+            << std::setw (15) << "wall (ms)" << std::endl;
+  for (uint32_t access = UNSLOTTED; access <= GTS; access++)
+    {
+      for (uint32_t i = 0; i < sizeof (contenders) / sizeof (contenders[0]); i++)
+        {
+          SystemWallClockMs clock;
+          clock.Start ();
+          Run (static_cast<enum Access> (access), contenders[i]);
+          int64_t wallMs = clock.End ();
+
+          double meanMs = m_received.empty () ? 0 : m_totalLatency.GetSeconds () * 1e3 / m_received.size ();
+          std::ostringstream delivered;
+          delivered << m_received.size () << "/" << m_sent.size ();
+          std::cout << std::setw (15) << names[access]
+                    << std::setw (15) << contenders[i]
+                    << std::setw (15) << delivered.str ()
+                    << std::setw (20) << meanMs
+                    << std::setw (20) << m_maxLatency.GetSeconds () * 1e3
+                    << std::setw (15) << wallMs << std::endl;
+
+          if (access == GTS)
+            {
+              // The GTS is not shared, the latency does not depend on the load.
+              NS_TEST_EXPECT_MSG_EQ (m_received.size (), m_sent.size (), "GTS MSDUs lost");
+              NS_TEST_EXPECT_MSG_LT (m_maxLatency, Seconds (0.0165), "GTS MSDU waited for more than a superframe");
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Superframe Benchmark TestSuite
+ */
+class VlcMacSuperframeBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcMacSuperframeBenchmarkTestSuite ();
+};
+
+VlcMacSuperframeBenchmarkTestSuite::VlcMacSuperframeBenchmarkTestSuite ()
+  : TestSuite ("vlc-mac-superframe-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcMacSuperframeBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcMacSuperframeBenchmarkTestSuite g_vlcMacSuperframeBenchmarkTestSuite; //!< Static variable for test initialization
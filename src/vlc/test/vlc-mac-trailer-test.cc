@@ -0,0 +1,246 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/packet.h>
+#include <ns3/system-wall-clock-ms.h>
+#include <ns3/vlc-mac-header.h>
+#include <ns3/vlc-mac-trailer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * The byte-wise CRC-16 formerly used by VlcMacTrailer, on a flattened copy
+ * of the packet.
+ *
+ * \param p the packet
+ * \return the CRC
+ */
+static uint16_t
+ReferenceCrc16 (Ptr<const Packet> p)
+{
+  uint32_t size = p->GetSize ();
+  uint8_t *data = new uint8_t[size];
+  p->CopyData (data, size);
+
+  uint16_t accumulator = 0;
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      accumulator ^= data[i];
+      accumulator  = (accumulator >> 8) | (accumulator << 8);
+      accumulator ^= (accumulator & 0xff00) << 4;
+      accumulator ^= (accumulator >> 8) >> 4;
+      accumulator ^= (accumulator & 0xff00) >> 5;
+    }
+  delete[] data;
+  return accumulator;
+}
+
+/**
+ * Create a packet made of a MAC header, a payload with a data and a zero
+ * area and a second appended payload, so that it spans several fragments.
+ *
+ * \param size the size of the random payload
+ * \param seed the seed of the payload bytes
+ * \return the packet
+ */
+static Ptr<Packet>
+CreateFramePacket (uint32_t size, uint32_t seed)
+{
+  std::vector<uint8_t> payload (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      payload[i] = (seed >> 16) & 0xff;
+    }
+  Ptr<Packet> p = Create<Packet> (payload.data (), size);
+  p->AddAtEnd (Create<Packet> (size / 3));
+
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_DATA, 0);
+  macHdr.SetSrcAddrMode (VlcMacHeader::SHORTADDR);
+  macHdr.SetDstAddrMode (VlcMacHeader::SHORTADDR);
+  macHdr.SetSrcAddrFields (1, Mac16Address ("00:01"));
+  macHdr.SetDstAddrFields (1, Mac16Address ("00:02"));
+  p->AddHeader (macHdr);
+  return p;
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Trailer FCS Test
+ */
+class VlcMacTrailerTestCase : public TestCase
+{
+public:
+  VlcMacTrailerTestCase ();
+  virtual ~VlcMacTrailerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcMacTrailerTestCase::VlcMacTrailerTestCase ()
+  : TestCase ("Test the table driven CRC-16 of the MAC trailer")
+{
+}
+
+VlcMacTrailerTestCase::~VlcMacTrailerTestCase ()
+{
+}
+
+void
+VlcMacTrailerTestCase::DoRun (void)
+{
+  // Check value of CRC-16/KERMIT for "123456789".
+  const uint8_t check[] = "123456789";
+  Ptr<Packet> p = Create<Packet> (check, 9);
+  VlcMacTrailer trailer;
+  trailer.EnableFcs (true);
+  trailer.SetFcs (p);
+  NS_TEST_ASSERT_MSG_EQ (trailer.GetFcs (), 0x2189, "Wrong CRC of the check string");
+
+  // All lengths up to two slices and some frame sizes, over fragmented packets.
+  for (uint32_t size = 0; size < 300; size += (size < 20 ? 1 : 37))
+    {
+      p = CreateFramePacket (size, size);
+      trailer.SetFcs (p);
+      NS_TEST_ASSERT_MSG_EQ (trailer.GetFcs (), ReferenceCrc16 (p), "CRC differs from the reference for size " << size);
+    }
+
+  // A corrupted frame fails the check.
+  p = CreateFramePacket (100, 1);
+  trailer.SetFcs (p);
+  p->AddTrailer (trailer);
+  VlcMacTrailer received;
+  p->RemoveTrailer (received);
+  received.EnableFcs (true);
+  NS_TEST_ASSERT_MSG_EQ (received.CheckFcs (p), true, "FCS check failed");
+  NS_TEST_ASSERT_MSG_EQ (received.CheckFcs (CreateFramePacket (100, 2)), false, "Corrupted frame passed the FCS check");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Trailer TestSuite
+ */
+class VlcMacTrailerTestSuite : public TestSuite
+{
+public:
+  VlcMacTrailerTestSuite ();
+};
+
+VlcMacTrailerTestSuite::VlcMacTrailerTestSuite ()
+  : TestSuite ("vlc-mac-trailer", UNIT)
+{
+  AddTestCase (new VlcMacTrailerTestCase, TestCase::QUICK);
+}
+
+static VlcMacTrailerTestSuite g_vlcMacTrailerTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Benchmark of the table driven CRC-16 against the byte-wise one on a
+ * flattened copy of the packet
+ */
+class VlcMacTrailerBenchmarkTestCase : public TestCase
+{
+public:
+  VlcMacTrailerBenchmarkTestCase ();
+  virtual ~VlcMacTrailerBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcMacTrailerBenchmarkTestCase::VlcMacTrailerBenchmarkTestCase ()
+  : TestCase ("Benchmark the CRC-16 of the MAC trailer")
+{
+}
+
+VlcMacTrailerBenchmarkTestCase::~VlcMacTrailerBenchmarkTestCase ()
+{
+}
+
+void
+VlcMacTrailerBenchmarkTestCase::DoRun (void)
+{
+  const uint32_t sizes[] = { 16, 128, 512, 1024 };
+  const uint32_t bytes = 4 * 1024 * 1024;
+
+  std::cout << std::setw (12) << "frame size"
+            << std::setw (20) << "table (ns/frame)"
+            << std::setw (20) << "byte-wise (ns/frame)" << std::endl;
+  for (uint32_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+    {
+      Ptr<Packet> p = CreateFramePacket (sizes[s], s);
+      uint32_t frames = bytes / p->GetSize ();
+      VlcMacTrailer trailer;
+      trailer.EnableFcs (true);
+      uint32_t sum = 0;
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      for (uint32_t i = 0; i < frames; i++)
+        {
+          trailer.SetFcs (p);
+          sum += trailer.GetFcs ();
+        }
+      double table = clock.End () * 1e6 / frames;
+
+      clock.Start ();
+      for (uint32_t i = 0; i < frames; i++)
+        {
+          sum -= ReferenceCrc16 (p);
+        }
+      double byteWise = clock.End () * 1e6 / frames;
+
+      NS_TEST_ASSERT_MSG_EQ (sum, 0, "CRC differs from the reference");
+      std::cout << std::setw (12) << p->GetSize ()
+                << std::setw (20) << table
+                << std::setw (20) << byteWise << std::endl;
+    }
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Trailer benchmark TestSuite
+ */
+class VlcMacTrailerBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcMacTrailerBenchmarkTestSuite ();
+};
+
+VlcMacTrailerBenchmarkTestSuite::VlcMacTrailerBenchmarkTestSuite ()
+  : TestSuite ("vlc-mac-trailer-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcMacTrailerBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcMacTrailerBenchmarkTestSuite g_vlcMacTrailerBenchmarkTestSuite; //!< Static variable for test initialization
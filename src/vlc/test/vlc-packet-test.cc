@@ -107,6 +107,69 @@ VlcPacketTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC header security flag and VPAN Id elision Test
+ */
+class VlcMacHeaderElisionTestCase : public TestCase
+{
+public:
+  VlcMacHeaderElisionTestCase ();
+  virtual ~VlcMacHeaderElisionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcMacHeaderElisionTestCase::VlcMacHeaderElisionTestCase ()
+  : TestCase ("Test the security flag and the elision of the source VPAN Id")
+{
+}
+
+VlcMacHeaderElisionTestCase::~VlcMacHeaderElisionTestCase ()
+{
+}
+
+void
+VlcMacHeaderElisionTestCase::DoRun (void)
+{
+  // Test setup:
+  // The security flag reads back as set. A frame with a destination carries
+  // a single VPAN Id, so GetSerializedSize agrees with Serialize and the
+  // source VPAN Id is restored from the destination one; without a
+  // destination the source VPAN Id is sent.
+  VlcMacHeader macHdr (VlcMacHeader::VLC_MAC_DATA, 7);
+  macHdr.SetSecEnable ();
+  NS_TEST_ASSERT_MSG_EQ (macHdr.IsSecEnable (), true, "Security flag not set");
+  macHdr.SetSecDisable ();
+  NS_TEST_ASSERT_MSG_EQ (macHdr.IsSecEnable (), false, "Security flag not cleared");
+
+  macHdr.SetSrcAddrMode (VlcMacHeader::SHORTADDR);
+  macHdr.SetSrcAddrFields (100, Mac16Address ("00:11"));
+  macHdr.SetDstAddrMode (VlcMacHeader::SHORTADDR);
+  macHdr.SetDstAddrFields (100, Mac16Address ("00:22"));
+  // Frame control, sequence number, destination VPAN Id and addresses.
+  NS_TEST_ASSERT_MSG_EQ (macHdr.GetSerializedSize (), 9, "Source VPAN Id not elided");
+
+  Ptr<Packet> p = Create<Packet> (20);
+  p->AddHeader (macHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 29, "Serialized header size differs from GetSerializedSize");
+  VlcMacHeader receivedMacHdr;
+  p->RemoveHeader (receivedMacHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 20, "Header not fully removed");
+  NS_TEST_ASSERT_MSG_EQ (receivedMacHdr.GetSrcVpanId (), 100, "Source VPAN Id not restored");
+  NS_TEST_ASSERT_MSG_EQ (receivedMacHdr.GetShortSrcAddr (), Mac16Address ("00:11"), "Wrong source address");
+  NS_TEST_ASSERT_MSG_EQ (receivedMacHdr.GetShortDstAddr (), Mac16Address ("00:22"), "Wrong destination address");
+
+  macHdr.SetSrcAddrMode (VlcMacHeader::EXTADDR);
+  macHdr.SetSrcAddrFields (100, Mac64Address ("00:00:00:00:00:00:00:11"));
+  NS_TEST_ASSERT_MSG_EQ (macHdr.GetSerializedSize (), 15, "Source VPAN Id of an extended source not elided");
+  p->AddHeader (macHdr);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 35, "Serialized header size differs from GetSerializedSize");
+}
+
 /**
  * \ingroup vlc-test
  * \ingroup tests
@@ -123,6 +186,7 @@ VlcPacketTestSuite::VlcPacketTestSuite ()
   : TestSuite ("vlc-packet", UNIT)
 {
   AddTestCase (new VlcPacketTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMacHeaderElisionTestCase, TestCase::QUICK);
 }
 
 static VlcPacketTestSuite g_vlcPacketTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,400 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/packet.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY Dimming Rate Test
+ */
+class VlcPhyDimmingRateTestCase : public TestCase
+{
+public:
+  VlcPhyDimmingRateTestCase ();
+  virtual ~VlcPhyDimmingRateTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the result of a set attribute request.
+   *
+   * \param status the status of the request
+   * \param id the attribute
+   */
+  void SetAttributeConfirm (VlcPhyEnumeration status, VlcPibAttributeIdentifier id);
+
+  VlcPhyEnumeration m_status;   //!< the status of the last request
+};
+
+VlcPhyDimmingRateTestCase::VlcPhyDimmingRateTestCase ()
+  : TestCase ("Test the data rate, the airtime and the power of dimmed frames")
+{
+}
+
+VlcPhyDimmingRateTestCase::~VlcPhyDimmingRateTestCase ()
+{
+}
+
+void
+VlcPhyDimmingRateTestCase::SetAttributeConfirm (VlcPhyEnumeration status, VlcPibAttributeIdentifier id)
+{
+  m_status = status;
+}
+
+void
+VlcPhyDimmingRateTestCase::DoRun (void)
+{
+  // Test setup:
+  // The phyDim PIB attribute sets the dimming level in steps of 0.1%. At a
+  // level of 20%, OOK spends 60% of the PSDU airtime on compensation
+  // symbols, while VPPM narrows its pulses at the same data rate. The power
+  // spectral density of the frames is 0.4 times the undimmed one.
+  Ptr<VlcPhy> phy = CreateObject<VlcPhy> ();
+  phy->SetPlmeSetAttributeConfirmCallback (MakeCallback (&VlcPhyDimmingRateTestCase::SetAttributeConfirm, this));
+  phy->SetMcs (IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (phy->GetDimmingLevel (), 0.5, "Frames dimmed by default");
+  Ptr<const SpectrumValue> undimmed = phy->GetDimmedTxPowerSpectralDensity ();
+  NS_TEST_ASSERT_MSG_EQ (undimmed, phy->GetTxPowerSpectralDensity (), "Undimmed power spectral density copied");
+  double undimmedPower = Sum (*undimmed);
+
+  VlcPhyPibAttributes attributes;
+  attributes.phyDim = 200;
+  phy->PlmeSetAttributeRequest (phyDim, &attributes);
+  NS_TEST_ASSERT_MSG_EQ (m_status, IEEE_802_15_7_PHY_SUCCESS, "Dimming level not set");
+  NS_TEST_ASSERT_MSG_EQ_TOL (phy->GetDimmingLevel (), 0.2, 1e-12, "Wrong dimming level");
+  attributes.phyDim = 1000;
+  phy->PlmeSetAttributeRequest (phyDim, &attributes);
+  NS_TEST_ASSERT_MSG_EQ (m_status, IEEE_802_15_7_PHY_INVALID_PARAMETER, "Full power accepted");
+  NS_TEST_ASSERT_MSG_EQ_TOL (phy->GetDimmingLevel (), 0.2, 1e-12, "Dimming level changed by an invalid request");
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (phy->GetDataOrSymbolRate (true), 2.4e6, 1e-3, "Wrong OOK data rate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (phy->GetDataOrSymbolRate (false), 15e6, 1e-3, "Optical clock dimmed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (Sum (*phy->GetDimmedTxPowerSpectralDensity ()), 0.4 * undimmedPower, 1e-9 * undimmedPower,
+                             "Wrong power of the dimmed frames");
+
+  Time header = VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 0);
+  NS_TEST_ASSERT_MSG_EQ (VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 100, 0.2),
+                         header + Seconds (800 / 2.4e6), "Wrong airtime of dimmed OOK");
+  NS_TEST_ASSERT_MSG_EQ_TOL (VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 100, 0.8),
+                             VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 100, 0.2), NanoSeconds (1),
+                             "Dimming of OOK not symmetric");
+  NS_TEST_ASSERT_MSG_EQ (VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 100, 0.5),
+                         VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 100), "Undimmed airtime changed");
+  NS_TEST_ASSERT_MSG_EQ (VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_VPPM_5_MBPS, 100, 0.2),
+                         VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_VPPM_5_MBPS, 100), "VPPM data rate dimmed");
+
+  phy->SetMcs (IEEE_802_15_7_PHY_II_VPPM_5_MBPS);
+  NS_TEST_ASSERT_MSG_EQ_TOL (phy->GetDataOrSymbolRate (true), 5e6, 1e-3, "Wrong VPPM data rate");
+
+  phy->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY Dimming Error Model Test
+ */
+class VlcPhyDimmingErrorModelTestCase : public TestCase
+{
+public:
+  VlcPhyDimmingErrorModelTestCase ();
+  virtual ~VlcPhyDimmingErrorModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcPhyDimmingErrorModelTestCase::VlcPhyDimmingErrorModelTestCase ()
+  : TestCase ("Test the bit error rate of dimmed frames")
+{
+}
+
+VlcPhyDimmingErrorModelTestCase::~VlcPhyDimmingErrorModelTestCase ()
+{
+}
+
+void
+VlcPhyDimmingErrorModelTestCase::DoRun (void)
+{
+  // Test setup:
+  // The SNR is the one of the average power of a frame. Dimmed OOK sends
+  // the data at the undimmed power, so its bit error rate at 0.4 times the
+  // SNR is the undimmed one at the full SNR. The two pulse positions of
+  // VPPM differ over 20% of a bit at a level of 80%, which at 1.6 times the
+  // average power leaves 0.4 times the undimmed SNR.
+  Ptr<VlcErrorModel> model = CreateObject<VlcErrorModel> ();
+  const double snr = 10.0;
+
+  model->SetModulation (VLC_MODULATION_OOK);
+  double undimmed = model->GetBer (snr);
+  model->SetDimmingLevel (0.2);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetBer (0.4 * snr), undimmed, 1e-12, "Wrong BER of dimmed OOK");
+
+  model->SetModulation (VLC_MODULATION_VPPM);
+  model->SetDimmingLevel (0.5);
+  double reference = model->GetBer (0.4 * snr);
+  NS_TEST_ASSERT_MSG_GT (reference, model->GetBer (snr), "BER not increasing at lower SNR");
+  model->SetDimmingLevel (0.8);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetBer (1.6 * snr), reference, 1e-12, "Wrong BER of dimmed VPPM");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTabulatedBer (1.6 * snr), reference, 1e-3 * reference,
+                             "Table not rebuilt for the dimming level");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY Dimming Frame Test
+ */
+class VlcPhyDimmingFrameTestCase : public TestCase
+{
+public:
+  VlcPhyDimmingFrameTestCase ();
+  virtual ~VlcPhyDimmingFrameTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Send a frame from node 1 to node 2 at a dimming level.
+   *
+   * \param dim the phyDim PIB attribute of node 1
+   */
+  void RunFrame (uint32_t dim);
+
+  /**
+   * Record the start of a frame.
+   *
+   * \param p the frame
+   */
+  void TxBegin (Ptr<const Packet> p);
+
+  /**
+   * Record the end of a frame.
+   *
+   * \param p the frame
+   */
+  void TxEnd (Ptr<const Packet> p);
+
+  /**
+   * Function called when a frame is received.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  Time m_txBegin;           //!< the start of the frame on air
+  Time m_airtime;           //!< the airtime of the frame
+  uint32_t m_psduSize;      //!< the size of the PSDU
+  uint32_t m_received;      //!< the number of frames received
+  double m_rxPower;         //!< the received power of the frame
+  double m_rxDimmingLevel;  //!< the dimming level of the frame at node 2
+  uint64_t m_ackWaitTime;   //!< the ACK wait duration of node 1 in symbols
+  Ptr<VlcPhy> m_rxPhy;      //!< the PHY of node 2
+};
+
+VlcPhyDimmingFrameTestCase::VlcPhyDimmingFrameTestCase ()
+  : TestCase ("Test the airtime and the reception of a dimmed frame")
+{
+}
+
+VlcPhyDimmingFrameTestCase::~VlcPhyDimmingFrameTestCase ()
+{
+}
+
+void
+VlcPhyDimmingFrameTestCase::TxBegin (Ptr<const Packet> p)
+{
+  m_txBegin = Simulator::Now ();
+  m_psduSize = p->GetSize ();
+}
+
+void
+VlcPhyDimmingFrameTestCase::TxEnd (Ptr<const Packet> p)
+{
+  m_airtime = Simulator::Now () - m_txBegin;
+}
+
+void
+VlcPhyDimmingFrameTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received++;
+  m_rxDimmingLevel = m_rxPhy->GetRxDimmingLevel ();
+}
+
+void
+VlcPhyDimmingFrameTestCase::RunFrame (uint32_t dim)
+{
+  m_received = 0;
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestLink ();
+  Ptr<VlcNetDevice> dev0 = devices[0];
+  Ptr<VlcNetDevice> dev1 = devices[1];
+
+  dev0->GetPhy ()->SetMcs (IEEE_802_15_7_PHY_I_OOK_100_KBPS);
+  VlcPhyPibAttributes attributes;
+  attributes.phyDim = dim;
+  dev0->GetPhy ()->PlmeSetAttributeRequest (phyDim, &attributes);
+  dev0->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcPhyDimmingFrameTestCase::TxBegin, this));
+  dev0->GetPhy ()->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&VlcPhyDimmingFrameTestCase::TxEnd, this));
+  dev1->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcPhyDimmingFrameTestCase::DataIndication, this));
+  m_rxPhy = dev1->GetPhy ();
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_msduHandle = 0;
+  params.m_txOptions = TX_OPTION_NONE;
+  Simulator::ScheduleWithContext (1, Seconds (0.1), &VlcMac::McpsDataRequest, dev0->GetMac (), params, Create<Packet> (50));
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  m_rxPower = dev1->GetPhy ()->GetRxPower ();
+  m_ackWaitTime = dev0->GetMac ()->GetMacAckWaitDuration ();
+  m_rxPhy = 0;
+  Simulator::Destroy ();
+}
+
+void
+VlcPhyDimmingFrameTestCase::DoRun (void)
+{
+  // Test setup:
+  // Node 1 sends a frame to node 2 with OOK, undimmed and at a dimming
+  // level of 10%. The dimmed frame is on air for the airtime of the
+  // dimming level, is received at 0.2 times the undimmed power and still
+  // decoded without a noise model. Node 2, undimmed itself, learns the
+  // dimming level of the frame from its signal. The ACK wait time of the MAC grows with
+  // the compensation symbols of the ACK.
+  RunFrame (0);
+  NS_TEST_ASSERT_MSG_EQ (m_received, 1, "Undimmed frame not received");
+  NS_TEST_ASSERT_MSG_EQ (m_airtime, VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_I_OOK_100_KBPS, m_psduSize),
+                         "Wrong airtime of the undimmed frame");
+  double undimmedPower = m_rxPower;
+  uint64_t undimmedAckWaitTime = m_ackWaitTime;
+
+  RunFrame (100);
+  NS_TEST_ASSERT_MSG_EQ (m_received, 1, "Dimmed frame not received");
+  NS_TEST_ASSERT_MSG_EQ (m_airtime, VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_I_OOK_100_KBPS, m_psduSize, 0.1),
+                         "Wrong airtime of the dimmed frame");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rxPower, 0.2 * undimmedPower, 1e-9 * undimmedPower, "Wrong received power");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rxDimmingLevel, 0.1, 1e-12, "Wrong dimming level of the received frame");
+  NS_TEST_ASSERT_MSG_GT (m_ackWaitTime, undimmedAckWaitTime, "ACK wait time not dimmed");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY Dimming Scheme Selection Test
+ */
+class VlcPhyDimmingMcsSelectionTestCase : public TestCase
+{
+public:
+  VlcPhyDimmingMcsSelectionTestCase ();
+  virtual ~VlcPhyDimmingMcsSelectionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcPhyDimmingMcsSelectionTestCase::VlcPhyDimmingMcsSelectionTestCase ()
+  : TestCase ("Test the selection of the scheme with the highest goodput at a dimming target")
+{
+}
+
+VlcPhyDimmingMcsSelectionTestCase::~VlcPhyDimmingMcsSelectionTestCase ()
+{
+}
+
+void
+VlcPhyDimmingMcsSelectionTestCase::DoRun (void)
+{
+  // Test setup:
+  // Without a noise model every frame is received, and the goodput only
+  // depends on the airtime. The 96 Mb/s OOK scheme of PHY II is the fastest
+  // down to a dimming level of about 2.6%, below which its compensation
+  // symbols make the 5 Mb/s VPPM scheme faster. The fastest VPPM scheme of
+  // PHY I wins at any level.
+  Ptr<VlcPhy> tx = CreateObject<VlcPhy> ();
+  Ptr<VlcPhy> rx = CreateObject<VlcPhy> ();
+  tx->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  rx->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  Ptr<VlcLinkBudget> linkBudget = CreateObject<VlcLinkBudget> ();
+  const uint32_t psduSize = 100;
+
+  tx->SetMcs (IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (linkBudget->GetBestMcs (tx, rx, psduSize, 0.5), IEEE_802_15_7_PHY_II_OOK_96_MBPS,
+                         "Wrong scheme undimmed");
+  NS_TEST_ASSERT_MSG_EQ (linkBudget->GetBestMcs (tx, rx, psduSize, 0.1), IEEE_802_15_7_PHY_II_OOK_96_MBPS,
+                         "Wrong scheme at 10%");
+  NS_TEST_ASSERT_MSG_EQ (linkBudget->GetBestMcs (tx, rx, psduSize, 0.02), IEEE_802_15_7_PHY_II_VPPM_5_MBPS,
+                         "Wrong scheme at 2%");
+  NS_TEST_ASSERT_MSG_EQ (linkBudget->GetBestMcs (tx, rx, psduSize, 0.98), IEEE_802_15_7_PHY_II_VPPM_5_MBPS,
+                         "Wrong scheme at 98%");
+  double goodput = linkBudget->GetGoodput (tx, rx, psduSize, IEEE_802_15_7_PHY_II_VPPM_5_MBPS, 0.02);
+  NS_TEST_ASSERT_MSG_EQ_TOL (goodput, psduSize * 8.0 / VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_VPPM_5_MBPS,
+                                                                                 psduSize).GetSeconds (),
+                             1e-6 * goodput, "Wrong goodput");
+
+  tx->SetMcs (IEEE_802_15_7_PHY_I_OOK_11_67_KBPS);
+  NS_TEST_ASSERT_MSG_EQ (linkBudget->GetBestMcs (tx, rx, psduSize, 0.5), IEEE_802_15_7_PHY_I_VPPM_266_6_KBPS,
+                         "Wrong scheme of PHY I");
+
+  tx->Dispose ();
+  rx->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY Dimming TestSuite
+ */
+class VlcPhyDimmingTestSuite : public TestSuite
+{
+public:
+  VlcPhyDimmingTestSuite ();
+};
+
+VlcPhyDimmingTestSuite::VlcPhyDimmingTestSuite ()
+  : TestSuite ("vlc-phy-dimming", UNIT)
+{
+  AddTestCase (new VlcPhyDimmingRateTestCase, TestCase::QUICK);
+  AddTestCase (new VlcPhyDimmingErrorModelTestCase, TestCase::QUICK);
+  AddTestCase (new VlcPhyDimmingFrameTestCase, TestCase::QUICK);
+  AddTestCase (new VlcPhyDimmingMcsSelectionTestCase, TestCase::QUICK);
+}
+
+static VlcPhyDimmingTestSuite g_vlcPhyDimmingTestSuite; //!< Static variable for test initialization
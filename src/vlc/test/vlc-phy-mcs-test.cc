@@ -0,0 +1,317 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/system-wall-clock-ms.h>
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Compute the airtime of a PPDU from the MCS parameters.
+ *
+ * \param mcs the modulation and coding scheme
+ * \param psduSize the size of the PSDU in octets
+ * \return the airtime
+ */
+static Time
+ReferencePpduDuration (VlcPhyMcs mcs, uint32_t psduSize)
+{
+  const VlcPhyMcsParameters &params = VlcPhy::GetMcsParameters (mcs);
+  return Seconds ((124.0 + 32.0 + 16.0) / (params.opticalClockRate * 1000.0)
+                  + psduSize * 8.0 / (params.bitRate * 1000.0));
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY MCS Table Test
+ */
+class VlcPhyMcsTableTestCase : public TestCase
+{
+public:
+  VlcPhyMcsTableTestCase ();
+  virtual ~VlcPhyMcsTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcPhyMcsTableTestCase::VlcPhyMcsTableTestCase ()
+  : TestCase ("Test the MCS table and the airtime table of the PHY")
+{
+}
+
+VlcPhyMcsTableTestCase::~VlcPhyMcsTableTestCase ()
+{
+}
+
+void
+VlcPhyMcsTableTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < IEEE_802_15_7_INVALID_MCS; i++)
+    {
+      VlcPhyMcs mcs = static_cast<VlcPhyMcs> (i);
+      const VlcPhyMcsParameters &params = VlcPhy::GetMcsParameters (mcs);
+      NS_TEST_ASSERT_MSG_LT (params.phyOption, IEEE_802_15_7_INVALID_PHY_OPTION, "Invalid PHY option of MCS " << i);
+      NS_TEST_ASSERT_MSG_LT (params.fecK, params.fecN + 1, "Invalid FEC of MCS " << i);
+      NS_TEST_ASSERT_MSG_EQ ((params.phyType == 3), (params.phyOption == IEEE_802_15_7_CSK), "CSK outside of PHY III for MCS " << i);
+      for (uint32_t size = 0; size <= 1024; size += 31)
+        {
+          NS_TEST_ASSERT_MSG_EQ (VlcPhy::GetPpduDuration (mcs, size), ReferencePpduDuration (mcs, size),
+                                 "Wrong airtime of MCS " << i << " for size " << size);
+        }
+    }
+
+  // Spot check of PHY II OOK at 6 Mb/s with a 15 MHz optical clock.
+  NS_TEST_ASSERT_MSG_EQ (VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, 75),
+                         NanoSeconds (11466 + 100000), "Wrong airtime at 6 Mb/s");
+
+  Ptr<VlcPhy> phy = CreateObject<VlcPhy> ();
+  NS_TEST_ASSERT_MSG_EQ (phy->GetMcs (), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Wrong default MCS");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetDataOrSymbolRate (true), 6e6, "Wrong data rate");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetDataOrSymbolRate (false), 15e6, "Wrong optical clock rate");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetPhySymbolsPerOctet (), 20, "Wrong number of clocks per octet");
+  phy->SetAttribute ("Mcs", EnumValue (IEEE_802_15_7_PHY_I_VPPM_266_6_KBPS));
+  NS_TEST_ASSERT_MSG_EQ (phy->GetDataOrSymbolRate (false), 400e3, "MCS not set");
+  phy->Dispose ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY per-frame MCS Test
+ */
+class VlcPhyMcsTagTestCase : public TestCase
+{
+public:
+  VlcPhyMcsTagTestCase ();
+  virtual ~VlcPhyMcsTagTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the start of a transmission.
+   *
+   * \param p the packet
+   */
+  void TxBegin (Ptr<const Packet> p);
+
+  /**
+   * Record the end of a transmission.
+   *
+   * \param p the packet
+   */
+  void TxEnd (Ptr<const Packet> p);
+
+  /**
+   * Record a received MSDU.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  Time m_txBegin;                  //!< the start of the last transmission
+  std::vector<Time> m_durations;   //!< the durations of the transmissions
+  std::vector<uint32_t> m_sizes;   //!< the sizes of the transmitted PSDUs
+  uint32_t m_received;             //!< the number of received MSDUs
+};
+
+VlcPhyMcsTagTestCase::VlcPhyMcsTagTestCase ()
+  : TestCase ("Test the selection of the MCS per frame"),
+    m_received (0)
+{
+}
+
+VlcPhyMcsTagTestCase::~VlcPhyMcsTagTestCase ()
+{
+}
+
+void
+VlcPhyMcsTagTestCase::TxBegin (Ptr<const Packet> p)
+{
+  m_txBegin = Simulator::Now ();
+  m_sizes.push_back (p->GetSize ());
+}
+
+void
+VlcPhyMcsTagTestCase::TxEnd (Ptr<const Packet> p)
+{
+  m_durations.push_back (Simulator::Now () - m_txBegin);
+}
+
+void
+VlcPhyMcsTagTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received++;
+}
+
+void
+VlcPhyMcsTagTestCase::DoRun (void)
+{
+  // Test setup:
+  // Two nodes well in communication range. Node 1 sends a frame with the
+  // default MCS of the PHY, then a frame tagged with the 96 Mb/s MCS of
+  // PHY II. Both are received and last as long as the airtime table says.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestLink ();
+  Ptr<VlcNetDevice> dev0 = devices[0];
+  Ptr<VlcNetDevice> dev1 = devices[1];
+
+  dev0->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcPhyMcsTagTestCase::TxBegin, this));
+  dev0->GetPhy ()->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&VlcPhyMcsTagTestCase::TxEnd, this));
+  dev1->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcPhyMcsTagTestCase::DataIndication, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_msduHandle = 0;
+  params.m_txOptions = TX_OPTION_NONE;
+  Simulator::ScheduleNow (&VlcMac::McpsDataRequest, dev0->GetMac (), params, Create<Packet> (100));
+
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddPacketTag (VlcMcsTag (IEEE_802_15_7_PHY_II_OOK_96_MBPS));
+  params.m_msduHandle = 1;
+  Simulator::Schedule (MilliSeconds (10), &VlcMac::McpsDataRequest, dev0->GetMac (), params, p);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 2, "Frames lost");
+  NS_TEST_ASSERT_MSG_EQ (m_durations.size (), 2, "Wrong number of transmissions");
+  NS_TEST_ASSERT_MSG_EQ (m_durations[0], VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_6_MBPS, m_sizes[0]),
+                         "Wrong airtime with the default MCS");
+  NS_TEST_ASSERT_MSG_EQ (m_durations[1], VlcPhy::GetPpduDuration (IEEE_802_15_7_PHY_II_OOK_96_MBPS, m_sizes[1]),
+                         "Wrong airtime with the tagged MCS");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY MCS TestSuite
+ */
+class VlcPhyMcsTestSuite : public TestSuite
+{
+public:
+  VlcPhyMcsTestSuite ();
+};
+
+VlcPhyMcsTestSuite::VlcPhyMcsTestSuite ()
+  : TestSuite ("vlc-phy-mcs", UNIT)
+{
+  AddTestCase (new VlcPhyMcsTableTestCase, TestCase::QUICK);
+  AddTestCase (new VlcPhyMcsTagTestCase, TestCase::QUICK);
+}
+
+static VlcPhyMcsTestSuite g_vlcPhyMcsTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Benchmark of the tabulated airtime against its computation on every
+ * call
+ */
+class VlcPhyMcsBenchmarkTestCase : public TestCase
+{
+public:
+  VlcPhyMcsBenchmarkTestCase ();
+  virtual ~VlcPhyMcsBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcPhyMcsBenchmarkTestCase::VlcPhyMcsBenchmarkTestCase ()
+  : TestCase ("Benchmark the airtime computation of the PHY")
+{
+}
+
+VlcPhyMcsBenchmarkTestCase::~VlcPhyMcsBenchmarkTestCase ()
+{
+}
+
+void
+VlcPhyMcsBenchmarkTestCase::DoRun (void)
+{
+  uint32_t nEvaluations = 200000;
+
+  Time tabulated;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nEvaluations; i++)
+    {
+      tabulated += VlcPhy::GetPpduDuration (static_cast<VlcPhyMcs> (i % IEEE_802_15_7_INVALID_MCS), i % 1024);
+    }
+  int64_t tabulatedMs = clock.End ();
+
+  Time computed;
+  clock.Start ();
+  for (uint32_t i = 0; i < nEvaluations; i++)
+    {
+      computed += ReferencePpduDuration (static_cast<VlcPhyMcs> (i % IEEE_802_15_7_INVALID_MCS), i % 1024);
+    }
+  int64_t computedMs = clock.End ();
+
+  std::cout << std::setw (15) << "evaluations"
+            << std::setw (20) << "tabulated (ns)"
+            << std::setw (20) << "computed (ns)" << std::endl;
+  std::cout << std::setw (15) << nEvaluations
+            << std::setw (20) << tabulatedMs * 1e6 / nEvaluations
+            << std::setw (20) << computedMs * 1e6 / nEvaluations << std::endl;
+
+  NS_TEST_EXPECT_MSG_EQ (tabulated, computed, "Tabulated and computed airtimes differ");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY MCS Benchmark TestSuite
+ */
+class VlcPhyMcsBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcPhyMcsBenchmarkTestSuite ();
+};
+
+VlcPhyMcsBenchmarkTestSuite::VlcPhyMcsBenchmarkTestSuite ()
+  : TestSuite ("vlc-phy-mcs-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcPhyMcsBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcPhyMcsBenchmarkTestSuite g_vlcPhyMcsBenchmarkTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,133 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/vlc-phy.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY PIB Attributes Test
+ */
+class VlcPhyPibTestCase : public TestCase
+{
+public:
+  VlcPhyPibTestCase ();
+  virtual ~VlcPhyPibTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the result of a get attribute request.
+   *
+   * \param status the status of the request
+   * \param id the requested attribute
+   * \param attribute the attribute values
+   */
+  void GetAttributeConfirm (VlcPhyEnumeration status, VlcPibAttributeIdentifier id,
+                            VlcPhyPibAttributes* attribute);
+
+  VlcPhyEnumeration m_status;                        //!< the status of the last request
+  VlcPhyPibAttributes m_attributes;                  //!< the returned attribute values
+};
+
+VlcPhyPibTestCase::VlcPhyPibTestCase ()
+  : TestCase ("Test the sharing of the PHY colour function and the get attribute request")
+{
+}
+
+VlcPhyPibTestCase::~VlcPhyPibTestCase ()
+{
+}
+
+void
+VlcPhyPibTestCase::GetAttributeConfirm (VlcPhyEnumeration status, VlcPibAttributeIdentifier id,
+                                        VlcPhyPibAttributes* attribute)
+{
+  m_status = status;
+  m_attributes = *attribute;
+}
+
+void
+VlcPhyPibTestCase::DoRun (void)
+{
+  Ptr<VlcPhy> phy1 = CreateObject<VlcPhy> ();
+  Ptr<VlcPhy> phy2 = CreateObject<VlcPhy> ();
+  phy1->SetPlmeGetAttributeConfirmCallback (MakeCallback (&VlcPhyPibTestCase::GetAttributeConfirm, this));
+  phy2->SetPlmeGetAttributeConfirmCallback (MakeCallback (&VlcPhyPibTestCase::GetAttributeConfirm, this));
+
+  // Both PHYs share the default colour function.
+  phy1->PlmeGetAttributeRequest (phyColorFunction);
+  NS_TEST_ASSERT_MSG_EQ (m_status, IEEE_802_15_7_PHY_SUCCESS, "Get attribute failed");
+  Ptr<const VlcPhyColorFunction> colorFunction1 = m_attributes.phyColorFunction;
+  phy2->PlmeGetAttributeRequest (phyColorFunction);
+  NS_TEST_ASSERT_MSG_EQ (m_attributes.phyColorFunction, colorFunction1, "Default colour function not shared");
+  NS_TEST_ASSERT_MSG_EQ (colorFunction1->Get (255, 2), 0, "Default colour function not zero");
+
+  // Other attributes do not return the colour function.
+  phy1->PlmeGetAttributeRequest (phyCCAMode);
+  NS_TEST_ASSERT_MSG_EQ (m_attributes.phyCCAMode, 1, "Wrong CCA mode");
+  NS_TEST_ASSERT_MSG_EQ (m_attributes.phyColorFunction, 0, "Unrequested attribute returned");
+
+  // Modifying the colour function of one PHY does not change the other one.
+  Ptr<VlcPhyColorFunction> modified = colorFunction1->Copy ();
+  modified->Set (7, 1, 42);
+  VlcPhyPibAttributes attributes;
+  attributes.phyColorFunction = modified;
+  phy1->PlmeSetAttributeRequest (phyColorFunction, &attributes);
+  phy1->PlmeGetAttributeRequest (phyColorFunction);
+  NS_TEST_ASSERT_MSG_EQ (m_attributes.phyColorFunction->Get (7, 1), 42, "Colour function not set");
+  phy2->PlmeGetAttributeRequest (phyColorFunction);
+  NS_TEST_ASSERT_MSG_EQ (m_attributes.phyColorFunction->Get (7, 1), 0, "Colour function of another PHY changed");
+  NS_TEST_ASSERT_MSG_EQ (colorFunction1->Get (7, 1), 0, "Shared default modified");
+
+  // Setting a table equal to the default shares the default again.
+  attributes.phyColorFunction = Create<VlcPhyColorFunction> ();
+  phy1->PlmeSetAttributeRequest (phyColorFunction, &attributes);
+  phy1->PlmeGetAttributeRequest (phyColorFunction);
+  NS_TEST_ASSERT_MSG_EQ (m_attributes.phyColorFunction, colorFunction1, "Default colour function not shared");
+
+  phy1->Dispose ();
+  phy2->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY PIB Attributes TestSuite
+ */
+class VlcPhyPibTestSuite : public TestSuite
+{
+public:
+  VlcPhyPibTestSuite ();
+};
+
+VlcPhyPibTestSuite::VlcPhyPibTestSuite ()
+  : TestSuite ("vlc-phy-pib", UNIT)
+{
+  AddTestCase (new VlcPhyPibTestCase, TestCase::QUICK);
+}
+
+static VlcPhyPibTestSuite g_vlcPhyPibTestSuite; //!< Static variable for test initialization
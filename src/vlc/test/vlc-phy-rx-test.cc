@@ -0,0 +1,250 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/system-wall-clock-ms.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Test the signal parameters of VLC frames
+ */
+class VlcSpectrumSignalParametersTestCase : public TestCase
+{
+public:
+  VlcSpectrumSignalParametersTestCase ();
+  virtual ~VlcSpectrumSignalParametersTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcSpectrumSignalParametersTestCase::VlcSpectrumSignalParametersTestCase ()
+  : TestCase ("Test the identification and the copy of VLC signal parameters")
+{
+}
+
+VlcSpectrumSignalParametersTestCase::~VlcSpectrumSignalParametersTestCase ()
+{
+}
+
+void
+VlcSpectrumSignalParametersTestCase::DoRun (void)
+{
+  VlcSpectrumValueHelper psdHelper;
+  Ptr<VlcSpectrumSignalParameters> params = Create<VlcSpectrumSignalParameters> ();
+  params->psd = psdHelper.CreateTxPowerSpectralDensity (0, 1);
+  params->duration = MicroSeconds (100);
+  params->packet = Create<Packet> (20);
+
+  Ptr<SpectrumSignalParameters> copy = params->Copy ();
+  NS_TEST_ASSERT_MSG_EQ (VlcSpectrumSignalParameters::IsVlcSignal (params), true, "VLC frame not identified");
+  NS_TEST_ASSERT_MSG_EQ (VlcSpectrumSignalParameters::IsVlcSignal (copy), true, "Copy of a VLC frame not identified");
+  NS_TEST_ASSERT_MSG_EQ (VlcSpectrumSignalParameters::IsVlcSignal (Create<SpectrumSignalParameters> ()), false,
+                         "Foreign signal taken for a VLC frame");
+
+  // Every receiver gets its own copy of the packet, to tag it.
+  Ptr<Packet> packet = StaticCast<VlcSpectrumSignalParameters> (copy)->packet;
+  NS_TEST_ASSERT_MSG_NE (packet, params->packet, "Packet shared by the copies");
+  NS_TEST_ASSERT_MSG_EQ (packet->GetUid (), params->packet->GetUid (), "Copy of another packet");
+  NS_TEST_ASSERT_MSG_EQ (copy->duration, params->duration, "Duration not copied");
+  NS_TEST_ASSERT_MSG_EQ ((*copy->psd)[1], (*params->psd)[1], "PSD not copied");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY receive path TestSuite
+ */
+class VlcPhyRxTestSuite : public TestSuite
+{
+public:
+  VlcPhyRxTestSuite ();
+};
+
+VlcPhyRxTestSuite::VlcPhyRxTestSuite ()
+  : TestSuite ("vlc-phy-rx", UNIT)
+{
+  AddTestCase (new VlcSpectrumSignalParametersTestCase, TestCase::QUICK);
+}
+
+static VlcPhyRxTestSuite g_vlcPhyRxTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Benchmark of the receive path of the PHY
+ */
+class VlcPhyRxBenchmarkTestCase : public TestCase
+{
+public:
+  VlcPhyRxBenchmarkTestCase ();
+  virtual ~VlcPhyRxBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Let devices around a coordinator send frames to it, each frame reaches
+   * all other devices.
+   *
+   * \param nDevices the number of devices besides the coordinator
+   * \param clock the clock measuring the simulation
+   * \return the wall clock time in ms
+   */
+  int64_t Run (uint32_t nDevices, SystemWallClockMs &clock);
+
+  /**
+   * Count a transmitted frame.
+   *
+   * \param p the frame
+   */
+  void PhyTxBegin (Ptr<const Packet> p);
+
+  uint32_t m_nTx;   //!< The number of frames transmitted
+};
+
+VlcPhyRxBenchmarkTestCase::VlcPhyRxBenchmarkTestCase ()
+  : TestCase ("Benchmark the frames received per second in a star"),
+    m_nTx (0)
+{
+}
+
+VlcPhyRxBenchmarkTestCase::~VlcPhyRxBenchmarkTestCase ()
+{
+}
+
+void
+VlcPhyRxBenchmarkTestCase::PhyTxBegin (Ptr<const Packet> p)
+{
+  m_nTx++;
+}
+
+int64_t
+VlcPhyRxBenchmarkTestCase::Run (uint32_t nDevices, SystemWallClockMs &clock)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (11);
+  m_nTx = 0;
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:01");
+  params.m_txOptions = 0;
+  for (uint32_t i = 0; i <= nDevices; i++)
+    {
+      Ptr<Node> node = CreateObject <Node> ();
+      Ptr<VlcNetDevice> dev = CreateObject<VlcNetDevice> ();
+      dev->AssignStreams (10 * i);
+      uint8_t address[2] = {static_cast<uint8_t> ((i + 1) >> 8), static_cast<uint8_t> (i + 1)};
+      Mac16Address shortAddress;
+      shortAddress.CopyFrom (address);
+      dev->SetAddress (shortAddress);
+      dev->SetChannel (channel);
+      node->AddDevice (dev);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      double angle = 2 * M_PI * i / nDevices;
+      mobility->SetPosition (i == 0 ? Vector (0, 0, 0) : Vector (5 * std::cos (angle), 5 * std::sin (angle), 0));
+      dev->GetPhy ()->SetMobility (mobility);
+      dev->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcPhyRxBenchmarkTestCase::PhyTxBegin, this));
+      if (i > 0)
+        {
+          for (uint32_t k = 0; k < 20; k++)
+            {
+              params.m_msduHandle = k;
+              Simulator::Schedule (MilliSeconds (10 * k + i % 10), &VlcMac::McpsDataRequest, dev->GetMac (), params,
+                                   Create<Packet> (50));
+            }
+        }
+    }
+
+  Simulator::Stop (MilliSeconds (250));
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+void
+VlcPhyRxBenchmarkTestCase::DoRun (void)
+{
+  const uint32_t nDevices[] = { 10, 50, 100 };
+
+  std::cout << std::setw (12) << "devices"
+            << std::setw (16) << "frames sent"
+            << std::setw (20) << "signals received"
+            << std::setw (20) << "signals/s" << std::endl;
+  for (uint32_t s = 0; s < sizeof (nDevices) / sizeof (nDevices[0]); s++)
+    {
+      SystemWallClockMs clock;
+      int64_t elapsed = Run (nDevices[s], clock);
+      NS_TEST_ASSERT_MSG_GT (m_nTx, 0, "No frame sent");
+      // Every frame reaches every other PHY of the star.
+      uint64_t signals = static_cast<uint64_t> (m_nTx) * nDevices[s];
+      std::cout << std::setw (12) << nDevices[s]
+                << std::setw (16) << m_nTx
+                << std::setw (20) << signals
+                << std::setw (20) << static_cast<uint64_t> (signals * 1000.0 / std::max<int64_t> (elapsed, 1))
+                << std::endl;
+    }
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc PHY receive path benchmark TestSuite
+ */
+class VlcPhyRxBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcPhyRxBenchmarkTestSuite ();
+};
+
+VlcPhyRxBenchmarkTestSuite::VlcPhyRxBenchmarkTestSuite ()
+  : TestSuite ("vlc-phy-rx-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcPhyRxBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcPhyRxBenchmarkTestSuite g_vlcPhyRxBenchmarkTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,272 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/energy-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/packet.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Radio Energy Model LED Test
+ */
+class VlcRadioEnergyLedTestCase : public TestCase
+{
+public:
+  VlcRadioEnergyLedTestCase ();
+  virtual ~VlcRadioEnergyLedTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario: node 1 broadcasts frames with a modulation and
+   * coding scheme.
+   *
+   * \param mcs the modulation and coding scheme
+   * \param dimmingLevel the dimming level set on the PHY of node 1
+   * \return the energy consumed by the transceiver of node 1 in J
+   */
+  double RunFrames (VlcPhyMcs mcs, double dimmingLevel);
+
+  /**
+   * Record the start of a frame.
+   *
+   * \param p the frame
+   */
+  void TxBegin (Ptr<const Packet> p);
+
+  /**
+   * Record the end of a frame.
+   *
+   * \param p the frame
+   */
+  void TxEnd (Ptr<const Packet> p);
+
+  Time m_txBegin;   //!< the start of the frame on air
+  Time m_txTime;    //!< the airtime of the frames
+};
+
+VlcRadioEnergyLedTestCase::VlcRadioEnergyLedTestCase ()
+  : TestCase ("Test the LED energy against the dimming level")
+{
+}
+
+VlcRadioEnergyLedTestCase::~VlcRadioEnergyLedTestCase ()
+{
+}
+
+void
+VlcRadioEnergyLedTestCase::TxBegin (Ptr<const Packet> p)
+{
+  m_txBegin = Simulator::Now ();
+}
+
+void
+VlcRadioEnergyLedTestCase::TxEnd (Ptr<const Packet> p)
+{
+  m_txTime += Simulator::Now () - m_txBegin;
+}
+
+double
+VlcRadioEnergyLedTestCase::RunFrames (VlcPhyMcs mcs, double dimmingLevel)
+{
+  m_txTime = Time (0);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestLink ();
+  Ptr<VlcNetDevice> dev0 = devices[0];
+  Ptr<VlcNetDevice> dev1 = devices[1];
+  dev0->GetPhy ()->SetMcs (mcs);
+  VlcPhyPibAttributes attributes;
+  attributes.phyDim = static_cast<uint16_t> (dimmingLevel * 1000 + 0.5);
+  dev0->GetPhy ()->PlmeSetAttributeRequest (phyDim, &attributes);
+  dev0->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&VlcRadioEnergyLedTestCase::TxBegin, this));
+  dev0->GetPhy ()->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&VlcRadioEnergyLedTestCase::TxEnd, this));
+
+  BasicEnergySourceHelper sourceHelper;
+  EnergySourceContainer sources = sourceHelper.Install (dev0->GetNode ());
+  VlcRadioEnergyModelHelper radioHelper;
+  DeviceEnergyModelContainer models = radioHelper.Install (dev0, sources.Get (0));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("ff:ff");
+  params.m_txOptions = TX_OPTION_NONE;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::Schedule (Seconds (i * 0.1), &VlcMac::McpsDataRequest, dev0->GetMac (), params, Create<Packet> (20));
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  double energy = models.Get (0)->GetTotalEnergyConsumption ();
+  Simulator::Destroy ();
+  return energy;
+}
+
+void
+VlcRadioEnergyLedTestCase::DoRun (void)
+{
+  // Test setup:
+  // Node 1 broadcasts five frames in one second. The LED is on for the
+  // dimming level of the PHY, through the pulse width of VPPM and the
+  // compensation symbols of OOK, so the LED energy of the frames grows with
+  // it: the difference between two dimming levels is the LED current times
+  // the difference of the levels, the supply voltage and the airtime. OOK
+  // compensates 0.2 and 0.8 with the same share of idle symbols, so both
+  // levels give the same airtime.
+  const double voltage = 3.0;
+  const double ledCurrent = 0.1;
+
+  double low = RunFrames (IEEE_802_15_7_PHY_I_VPPM_35_56_KBPS, 0.2);
+  double high = RunFrames (IEEE_802_15_7_PHY_I_VPPM_35_56_KBPS, 0.8);
+  NS_TEST_ASSERT_MSG_GT (m_txTime, MilliSeconds (5), "Frames not sent");
+  NS_TEST_ASSERT_MSG_EQ_TOL (high - low, ledCurrent * 0.6 * voltage * m_txTime.GetSeconds (), 1e-9,
+                             "Wrong LED energy of VPPM frames");
+
+  low = RunFrames (IEEE_802_15_7_PHY_I_OOK_11_67_KBPS, 0.2);
+  Time lowTxTime = m_txTime;
+  high = RunFrames (IEEE_802_15_7_PHY_I_OOK_11_67_KBPS, 0.8);
+  NS_TEST_ASSERT_MSG_EQ (m_txTime, lowTxTime, "OOK airtime not symmetric in the dimming level");
+  NS_TEST_ASSERT_MSG_EQ_TOL (high - low, ledCurrent * 0.6 * voltage * m_txTime.GetSeconds (), 1e-9,
+                             "Wrong LED energy of OOK frames");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Radio Energy Model Depletion Test
+ */
+class VlcRadioEnergyDepletionTestCase : public TestCase
+{
+public:
+  VlcRadioEnergyDepletionTestCase ();
+  virtual ~VlcRadioEnergyDepletionTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the transceiver state and the energy consumed.
+   *
+   * \param i the index of the record
+   */
+  void Record (uint32_t i);
+
+  Ptr<VlcPhy> m_phy;                    //!< the PHY of the node
+  Ptr<DeviceEnergyModel> m_model;       //!< the energy model of the node
+  VlcPhyEnumeration m_state[4];         //!< the recorded transceiver states
+  bool m_off[4];                        //!< the recorded off modes
+  double m_energy[4];                   //!< the recorded energy consumptions
+};
+
+VlcRadioEnergyDepletionTestCase::VlcRadioEnergyDepletionTestCase ()
+  : TestCase ("Test the energy depletion and the off mode of the PHY")
+{
+}
+
+VlcRadioEnergyDepletionTestCase::~VlcRadioEnergyDepletionTestCase ()
+{
+}
+
+void
+VlcRadioEnergyDepletionTestCase::Record (uint32_t i)
+{
+  m_state[i] = m_phy->GetTrxState ();
+  m_off[i] = m_phy->IsOff ();
+  m_energy[i] = m_model->GetTotalEnergyConsumption ();
+}
+
+void
+VlcRadioEnergyDepletionTestCase::DoRun (void)
+{
+  // Test setup:
+  // A node listens with its receiver on, drawing 5 mA at 3 V from a source
+  // of 0.03 J that is depleted at 10% of its energy, after 1.8 s. The PHY
+  // is then switched off and draws nothing. A request to switch the
+  // receiver on waits for ResumeFromOff. The receiver is switched on after
+  // the turnaround time.
+  std::vector<Ptr<MobilityModel> > mobility (1, CreateObject<ConstantPositionMobilityModel> ());
+  Ptr<VlcNetDevice> dev0 = CreateVlcTestDevices (mobility)[0];
+  m_phy = dev0->GetPhy ();
+
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (0.03));
+  sourceHelper.Set ("BasicEnergySupplyVoltageV", DoubleValue (3.0));
+  sourceHelper.Set ("PeriodicEnergyUpdateInterval", TimeValue (MilliSeconds (10)));
+  EnergySourceContainer sources = sourceHelper.Install (dev0->GetNode ());
+  VlcRadioEnergyModelHelper radioHelper;
+  radioHelper.Set ("RxCurrentA", DoubleValue (0.005));
+  m_model = radioHelper.Install (dev0, sources.Get (0)).Get (0);
+
+  Simulator::Schedule (Seconds (1.7), &VlcRadioEnergyDepletionTestCase::Record, this, 0);
+  Simulator::Schedule (Seconds (1.9), &VlcRadioEnergyDepletionTestCase::Record, this, 1);
+  Simulator::Schedule (Seconds (2.5), &VlcPhy::PlmeSetTRXStateRequest, m_phy, IEEE_802_15_7_PHY_RX_ON);
+  Simulator::Schedule (Seconds (3), &VlcRadioEnergyDepletionTestCase::Record, this, 2);
+  Simulator::Schedule (Seconds (3.5), &VlcPhy::ResumeFromOff, m_phy);
+  Simulator::Schedule (Seconds (4), &VlcRadioEnergyDepletionTestCase::Record, this, 3);
+  Simulator::Stop (Seconds (4.5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_state[0], IEEE_802_15_7_PHY_RX_ON, "Receiver off before the depletion");
+  NS_TEST_ASSERT_MSG_EQ (m_off[0], false, "PHY off before the depletion");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_energy[0], 0.005 * 3.0 * 1.7, 1e-5, "Wrong receiver energy");
+  NS_TEST_ASSERT_MSG_EQ (m_state[1], IEEE_802_15_7_PHY_TRX_OFF, "PHY on after the depletion");
+  NS_TEST_ASSERT_MSG_EQ (m_off[1], true, "PHY not in the off mode after the depletion");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_energy[1], 0.027, 0.005 * 3.0 * 0.01, "Energy not depleted at the threshold");
+  NS_TEST_ASSERT_MSG_EQ (m_state[2], IEEE_802_15_7_PHY_TRX_OFF, "Receiver switched on in the off mode");
+  NS_TEST_ASSERT_MSG_EQ (m_energy[2], m_energy[1], "Energy consumed after the depletion");
+  NS_TEST_ASSERT_MSG_EQ (m_state[3], IEEE_802_15_7_PHY_RX_ON, "Deferred request not carried out");
+  NS_TEST_ASSERT_MSG_EQ (m_off[3], false, "PHY still in the off mode");
+
+  m_phy = 0;
+  m_model = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Radio Energy Model TestSuite
+ */
+class VlcRadioEnergyModelTestSuite : public TestSuite
+{
+public:
+  VlcRadioEnergyModelTestSuite ();
+};
+
+VlcRadioEnergyModelTestSuite::VlcRadioEnergyModelTestSuite ()
+  : TestSuite ("vlc-radio-energy-model", UNIT)
+{
+  AddTestCase (new VlcRadioEnergyLedTestCase, TestCase::QUICK);
+  AddTestCase (new VlcRadioEnergyDepletionTestCase, TestCase::QUICK);
+}
+
+static VlcRadioEnergyModelTestSuite g_vlcRadioEnergyModelTestSuite; //!< Static variable for test initialization
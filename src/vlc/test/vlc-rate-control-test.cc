@@ -0,0 +1,371 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include "vlc-test-helper.h"
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc ARF and AARF Rate Control Test
+ */
+class VlcArfRateControlTestCase : public TestCase
+{
+public:
+  VlcArfRateControlTestCase ();
+  virtual ~VlcArfRateControlTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a selected scheme.
+   *
+   * \param station the destination
+   * \param mcs the scheme
+   */
+  void TxMcs (Address station, VlcPhyMcs mcs);
+
+  uint32_t m_nSelected;          //!< the number of selected schemes
+};
+
+VlcArfRateControlTestCase::VlcArfRateControlTestCase ()
+  : TestCase ("Test the ARF and AARF rate control"),
+    m_nSelected (0)
+{
+}
+
+VlcArfRateControlTestCase::~VlcArfRateControlTestCase ()
+{
+}
+
+void
+VlcArfRateControlTestCase::TxMcs (Address station, VlcPhyMcs mcs)
+{
+  m_nSelected++;
+}
+
+void
+VlcArfRateControlTestCase::DoRun (void)
+{
+  Mac16Address station ("00:02");
+  std::vector<VlcPhyMcs> mcsSet;
+  mcsSet.push_back (IEEE_802_15_7_PHY_II_OOK_12_MBPS);
+  mcsSet.push_back (IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+  mcsSet.push_back (IEEE_802_15_7_PHY_II_OOK_9_6_MBPS);
+
+  Ptr<VlcArfRateControl> arf = CreateObject<VlcArfRateControl> ();
+  arf->TraceConnectWithoutContext ("TxMcs", MakeCallback (&VlcArfRateControlTestCase::TxMcs, this));
+  arf->SetMcsSet (mcsSet);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetNMcs (), 3, "Wrong number of candidates");
+  NS_TEST_ASSERT_MSG_EQ (arf->GetMcs (0), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Candidates not ordered by data rate");
+  NS_TEST_ASSERT_MSG_EQ (arf->GetMcs (2), IEEE_802_15_7_PHY_II_OOK_12_MBPS, "Candidates not ordered by data rate");
+
+  // The slowest scheme first, a probe after 10 successes.
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Not starting at the slowest scheme");
+  for (uint32_t i = 0; i < 9; i++)
+    {
+      arf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+    }
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Probe too early");
+  arf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_9_6_MBPS, "No probe after 10 successes");
+
+  // A failed probe falls back at once.
+  arf->ReportDataFailed (station, IEEE_802_15_7_PHY_II_OOK_9_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 1), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "No fallback after a failed probe");
+
+  // A successful probe is kept, two failures fall back.
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      arf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+    }
+  arf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_9_6_MBPS);
+  arf->ReportDataFailed (station, IEEE_802_15_7_PHY_II_OOK_9_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 1), IEEE_802_15_7_PHY_II_OOK_9_6_MBPS, "Fallback after a single failure");
+  arf->ReportDataFailed (station, IEEE_802_15_7_PHY_II_OOK_9_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 2), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "No fallback after two failures");
+
+  // A degraded WQI prevents probing.
+  arf->ReportRxWqi (station, 100);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetMeanWqi (station), 100, "Wrong first WQI sample");
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      arf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+    }
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Probe despite a low WQI");
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      arf->ReportRxWqi (station, 255);
+    }
+  NS_TEST_ASSERT_MSG_GT (arf->GetMeanWqi (station), 250, "WQI average not updated");
+  arf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (arf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_9_6_MBPS, "No probe once the WQI recovered");
+
+  // Statistics per scheme.
+  NS_TEST_ASSERT_MSG_EQ (arf->GetAttempts (IEEE_802_15_7_PHY_II_OOK_9_6_MBPS), 4, "Wrong number of attempts");
+  NS_TEST_ASSERT_MSG_EQ (arf->GetSuccesses (IEEE_802_15_7_PHY_II_OOK_9_6_MBPS), 1, "Wrong number of successes");
+  NS_TEST_ASSERT_MSG_EQ (m_nSelected, 8, "Wrong number of traced selections");
+
+  // AARF doubles the success threshold after a failed probe.
+  Ptr<VlcArfRateControl> aarf = CreateObject<VlcArfRateControl> ();
+  aarf->SetAttribute ("Adaptive", BooleanValue (true));
+  aarf->SetMcsSet (mcsSet);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      aarf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+    }
+  aarf->ReportDataFailed (station, IEEE_802_15_7_PHY_II_OOK_9_6_MBPS);
+  for (uint32_t i = 0; i < 19; i++)
+    {
+      aarf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+    }
+  NS_TEST_ASSERT_MSG_EQ (aarf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Success threshold not doubled");
+  aarf->ReportDataOk (station, IEEE_802_15_7_PHY_II_OOK_6_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (aarf->GetDataMcs (station, 100, 0), IEEE_802_15_7_PHY_II_OOK_9_6_MBPS, "No probe after 20 successes");
+
+  // The constant rate control uses its scheme only.
+  Ptr<VlcConstantRateControl> constant = CreateObject<VlcConstantRateControl> ();
+  constant->SetAttribute ("DataMcs", EnumValue (IEEE_802_15_7_PHY_II_OOK_48_MBPS));
+  constant->ReportDataFailed (station, IEEE_802_15_7_PHY_II_OOK_48_MBPS);
+  NS_TEST_ASSERT_MSG_EQ (constant->GetDataMcs (station, 100, 1), IEEE_802_15_7_PHY_II_OOK_48_MBPS, "Wrong constant scheme");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Minstrel Rate Control Test
+ */
+class VlcMinstrelRateControlTestCase : public TestCase
+{
+public:
+  VlcMinstrelRateControlTestCase ();
+  virtual ~VlcMinstrelRateControlTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Transmit a frame, which is acknowledged up to 24 Mb/s only.
+   */
+  void SendFrame (void);
+
+  Ptr<VlcMinstrelRateControl> m_minstrel;    //!< the rate control
+};
+
+VlcMinstrelRateControlTestCase::VlcMinstrelRateControlTestCase ()
+  : TestCase ("Test the convergence of the Minstrel rate control")
+{
+}
+
+VlcMinstrelRateControlTestCase::~VlcMinstrelRateControlTestCase ()
+{
+}
+
+void
+VlcMinstrelRateControlTestCase::SendFrame (void)
+{
+  Mac16Address station ("00:02");
+  for (uint32_t retry = 0; retry < 4; retry++)
+    {
+      VlcPhyMcs mcs = m_minstrel->GetDataMcs (station, 100, retry);
+      if (VlcPhy::GetMcsParameters (mcs).bitRate <= 24000)
+        {
+          m_minstrel->ReportDataOk (station, mcs);
+          return;
+        }
+      m_minstrel->ReportDataFailed (station, mcs);
+    }
+  m_minstrel->ReportFinalDataFailed (station);
+}
+
+void
+VlcMinstrelRateControlTestCase::DoRun (void)
+{
+  m_minstrel = CreateObject<VlcMinstrelRateControl> ();
+  m_minstrel->AssignStreams (0);
+  Ptr<VlcPhy> phy = CreateObject<VlcPhy> ();
+  m_minstrel->SetupPhy (phy);
+  NS_TEST_ASSERT_MSG_EQ (m_minstrel->GetNMcs (), 9, "Not all PHY II OOK schemes are candidates");
+
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &VlcMinstrelRateControlTestCase::SendFrame, this);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_minstrel->GetMcs (m_minstrel->GetMaxThroughputIndex (Mac16Address ("00:02"))),
+                         IEEE_802_15_7_PHY_II_OOK_24_MBPS, "Not converged to the fastest working scheme");
+  NS_TEST_ASSERT_MSG_GT (m_minstrel->GetSuccesses (IEEE_802_15_7_PHY_II_OOK_24_MBPS), 1500,
+                         "Most frames not sent at the fastest working scheme");
+  NS_TEST_ASSERT_MSG_GT (m_minstrel->GetAttempts (IEEE_802_15_7_PHY_II_OOK_96_MBPS), 0, "Fastest scheme never sampled");
+
+  phy->Dispose ();
+  m_minstrel = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc MAC Rate Control Test
+ */
+class VlcMacRateControlTestCase : public TestCase
+{
+public:
+  VlcMacRateControlTestCase ();
+  virtual ~VlcMacRateControlTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a received MSDU.
+   *
+   * \param params the MCPS params
+   * \param p the MSDU
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  /**
+   * Record a confirmed MSDU.
+   *
+   * \param params the MCPS params
+   */
+  void DataConfirm (McpsDataConfirmParams params);
+
+  /**
+   * Record a selected scheme.
+   *
+   * \param station the destination
+   * \param mcs the scheme
+   */
+  void TxMcs (Address station, VlcPhyMcs mcs);
+
+  uint32_t m_nReceived;                    //!< the number of received MSDUs
+  uint32_t m_nSucceeded;                   //!< the number of successful confirms
+  std::vector<VlcPhyMcs> m_txMcs;          //!< the selected schemes
+};
+
+VlcMacRateControlTestCase::VlcMacRateControlTestCase ()
+  : TestCase ("Test the link adaptation of the MAC with ARF"),
+    m_nReceived (0),
+    m_nSucceeded (0)
+{
+}
+
+VlcMacRateControlTestCase::~VlcMacRateControlTestCase ()
+{
+}
+
+void
+VlcMacRateControlTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_nReceived++;
+}
+
+void
+VlcMacRateControlTestCase::DataConfirm (McpsDataConfirmParams params)
+{
+  if (params.m_status == IEEE_802_15_7_SUCCESS)
+    {
+      m_nSucceeded++;
+    }
+}
+
+void
+VlcMacRateControlTestCase::TxMcs (Address station, VlcPhyMcs mcs)
+{
+  NS_TEST_EXPECT_MSG_EQ (station, Address (Mac16Address ("00:02")), "Wrong destination");
+  m_txMcs.push_back (mcs);
+}
+
+void
+VlcMacRateControlTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  std::vector<Ptr<VlcNetDevice> > devices = CreateVlcTestLink ();
+  Ptr<VlcNetDevice> dev0 = devices[0];
+  Ptr<VlcNetDevice> dev1 = devices[1];
+
+  Ptr<VlcArfRateControl> arf = CreateObject<VlcArfRateControl> ();
+  arf->TraceConnectWithoutContext ("TxMcs", MakeCallback (&VlcMacRateControlTestCase::TxMcs, this));
+  dev0->GetMac ()->SetAttribute ("RateControl", PointerValue (arf));
+  // The new rate control draws its own random numbers.
+  dev0->AssignStreams (0);
+  dev0->GetMac ()->SetMcpsDataConfirmCallback (MakeCallback (&VlcMacRateControlTestCase::DataConfirm, this));
+  dev1->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcMacRateControlTestCase::DataIndication, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = TX_OPTION_ACK;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::Schedule (MilliSeconds (i), &VlcMac::McpsDataRequest, dev0->GetMac (), params, Create<Packet> (50));
+    }
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nReceived, 40, "Not all MSDUs received");
+  NS_TEST_ASSERT_MSG_EQ (m_nSucceeded, 40, "Not all MSDUs confirmed");
+  NS_TEST_ASSERT_MSG_GT (m_txMcs.size (), 39, "Scheme not selected for every attempt");
+  NS_TEST_ASSERT_MSG_EQ (m_txMcs.front (), IEEE_802_15_7_PHY_II_OOK_6_MBPS, "Not starting at the slowest scheme");
+  NS_TEST_ASSERT_MSG_GT (m_txMcs.back (), IEEE_802_15_7_PHY_II_OOK_9_6_MBPS, "Scheme not increased");
+  NS_TEST_ASSERT_MSG_GT (arf->GetMeanWqi (Mac16Address ("00:02")), 0, "No WQI of the ACKs");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Rate Control TestSuite
+ */
+class VlcRateControlTestSuite : public TestSuite
+{
+public:
+  VlcRateControlTestSuite ();
+};
+
+VlcRateControlTestSuite::VlcRateControlTestSuite ()
+  : TestSuite ("vlc-rate-control", UNIT)
+{
+  AddTestCase (new VlcArfRateControlTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMinstrelRateControlTestCase, TestCase::QUICK);
+  AddTestCase (new VlcMacRateControlTestCase, TestCase::QUICK);
+}
+
+static VlcRateControlTestSuite g_vlcRateControlTestSuite; //!< Static variable for test initialization
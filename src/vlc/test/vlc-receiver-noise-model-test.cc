@@ -0,0 +1,244 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test the noise variance of the receiver noise model.
+ */
+class VlcReceiverNoiseModelTestCase : public TestCase
+{
+public:
+  VlcReceiverNoiseModelTestCase ();
+  virtual ~VlcReceiverNoiseModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcReceiverNoiseModelTestCase::VlcReceiverNoiseModelTestCase ()
+  : TestCase ("Test the shot and thermal noise of the receiver noise model")
+{
+}
+
+VlcReceiverNoiseModelTestCase::~VlcReceiverNoiseModelTestCase ()
+{
+}
+
+void
+VlcReceiverNoiseModelTestCase::DoRun (void)
+{
+  const double q = 1.602176634e-19;
+  const double k = 1.380649e-23;
+
+  Ptr<VlcReceiverNoiseModel> model = CreateObject<VlcReceiverNoiseModel> ();
+  model->SetResponsivity (0.5);
+  model->SetBandwidth (10e6);
+  model->SetAmbientPower (1e-4);
+  model->SetDarkCurrent (1e-9);
+  model->SetTemperature (300);
+  model->SetFeedbackResistance (1e3);
+
+  // Shot noise of the signal, the ambient light and the dark current, plus
+  // the thermal noise of the feedback resistor.
+  double rxPower = 1e-5;
+  double expected = 2 * q * (0.5 * (rxPower + 1e-4) + 1e-9) * 10e6 + 4 * k * 300 * 10e6 / 1e3;
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetNoiseVariance (rxPower), expected, expected * 1e-9, "Wrong noise variance");
+  double snr = (0.5 * rxPower) * (0.5 * rxPower) / expected;
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetSnr (rxPower), snr, snr * 1e-9, "Wrong SNR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rxPower / model->GetNoisePower (rxPower), snr, snr * 1e-9,
+                             "Noise power does not give the SNR");
+
+  // The signal independent terms follow a change of the configuration.
+  model->SetAmbientPower (0);
+  model->SetDarkCurrent (0);
+  model->SetFeedbackResistance (1e12);
+  expected = 2 * q * 0.5 * rxPower * 10e6 + 4 * k * 300 * 10e6 / 1e12;
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetNoiseVariance (rxPower), expected, expected * 1e-9,
+                             "Cached noise not updated");
+  model->SetAttribute ("Bandwidth", DoubleValue (20e6));
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetNoiseVariance (rxPower), 2 * expected, expected * 1e-6,
+                             "Cached noise not updated by the attribute");
+
+  // More signal, more SNR.
+  NS_TEST_ASSERT_MSG_GT (model->GetSnr (2 * rxPower), model->GetSnr (rxPower), "SNR not increasing with the signal");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test the packet success rate of a link with and without receiver noise.
+ */
+class VlcReceiverNoiseLinkTestCase : public TestCase
+{
+public:
+  VlcReceiverNoiseLinkTestCase ();
+  virtual ~VlcReceiverNoiseLinkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Send frames over a link and count the frames received.
+   *
+   * \param distance the length of the link in m
+   * \param noiseModel the noise model of the receiver, or 0
+   * \param nFrames the number of frames to send
+   * \return the number of frames received
+   */
+  uint32_t RunLink (double distance, Ptr<VlcReceiverNoiseModel> noiseModel, uint32_t nFrames);
+
+  /**
+   * Function called when a frame is received.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  uint32_t m_received;  //!< The number of frames received
+};
+
+VlcReceiverNoiseLinkTestCase::VlcReceiverNoiseLinkTestCase ()
+  : TestCase ("Test the packet success rate with receiver noise"),
+    m_received (0)
+{
+}
+
+VlcReceiverNoiseLinkTestCase::~VlcReceiverNoiseLinkTestCase ()
+{
+}
+
+void
+VlcReceiverNoiseLinkTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received++;
+}
+
+uint32_t
+VlcReceiverNoiseLinkTestCase::RunLink (double distance, Ptr<VlcReceiverNoiseModel> noiseModel, uint32_t nFrames)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (9);
+  m_received = 0;
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<VlcLambertianPropagationLossModel> ());
+  Ptr<VlcNetDevice> devices[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      devices[i] = CreateObject<VlcNetDevice> ();
+      devices[i]->AssignStreams (10 * i);
+      devices[i]->SetAddress (i == 0 ? Mac16Address ("00:01") : Mac16Address ("00:02"));
+      devices[i]->SetChannel (channel);
+      node->AddDevice (devices[i]);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i * distance, 0, 0));
+      devices[i]->GetPhy ()->SetMobility (mobility);
+    }
+  devices[0]->GetPhy ()->SetTxPower (30);
+  devices[1]->GetPhy ()->SetNoiseModel (noiseModel);
+  devices[1]->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcReceiverNoiseLinkTestCase::DataIndication, this));
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = 0;
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      params.m_msduHandle = i;
+      Simulator::Schedule (MilliSeconds (i), &VlcMac::McpsDataRequest, devices[0]->GetMac (), params, Create<Packet> (20));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_received;
+}
+
+void
+VlcReceiverNoiseLinkTestCase::DoRun (void)
+{
+  // Test setup:
+  // A 1 W emitter faces a photodiode with the default receiver noise over a
+  // Lambertian channel. Without noise every frame is received at any
+  // distance. With noise, the packet success rate falls from 1 to 0 between
+  // 30 and 35 m, and more ambient light shortens the range.
+  Ptr<VlcReceiverNoiseModel> noiseModel = CreateObject<VlcReceiverNoiseModel> ();
+  double distances[] = { 1, 10, 30, 32, 35, 40 };
+  uint32_t previous = 100;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (RunLink (distances[i], 0, 100), 100, "Frames lost without noise at " << distances[i] << " m");
+      uint32_t received = RunLink (distances[i], noiseModel, 100);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (received, previous, "Success rate increasing with the distance at " << distances[i] << " m");
+      previous = received;
+      if (distances[i] <= 30)
+        {
+          NS_TEST_ASSERT_MSG_EQ (received, 100, "Frames lost with a high SNR at " << distances[i] << " m");
+        }
+      else if (distances[i] >= 35)
+        {
+          NS_TEST_ASSERT_MSG_EQ (received, 0, "Frames received with a low SNR at " << distances[i] << " m");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_GT (received, 0, "No frame received at the edge of the range");
+          NS_TEST_ASSERT_MSG_LT (received, 100, "No frame lost at the edge of the range");
+        }
+    }
+
+  noiseModel->SetAmbientPower (1e-3);
+  NS_TEST_ASSERT_MSG_LT (RunLink (30, noiseModel, 100), 100, "Ambient light does not reduce the range");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Receiver noise model test suite
+ */
+class VlcReceiverNoiseModelTestSuite : public TestSuite
+{
+public:
+  VlcReceiverNoiseModelTestSuite ();
+};
+
+VlcReceiverNoiseModelTestSuite::VlcReceiverNoiseModelTestSuite ()
+  : TestSuite ("vlc-receiver-noise-model", UNIT)
+{
+  AddTestCase (new VlcReceiverNoiseModelTestCase, TestCase::QUICK);
+  AddTestCase (new VlcReceiverNoiseLinkTestCase, TestCase::QUICK);
+}
+
+static VlcReceiverNoiseModelTestSuite g_vlcReceiverNoiseModelTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,574 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/node-container.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/internet-stack-helper.h>
+#include <ns3/ipv6-address-helper.h>
+#include <ns3/icmpv6-l4-protocol.h>
+#include <ns3/udp-socket-factory.h>
+#include <ns3/inet6-socket-address.h>
+#include <ns3/socket.h>
+#include <ns3/sixlowpan-net-device.h>
+
+#include <iomanip>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create two nodes with an IPv6 stack over 6LoWPAN over a VLC link, 5 m
+ * apart.
+ *
+ * \param helper the helper creating the devices
+ * \param nodes the nodes
+ * \return the 6LoWPAN devices
+ */
+static NetDeviceContainer
+CreateSixLowPanLink (VlcHelper &helper, NodeContainer &nodes)
+{
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  helper.SetChannel (channel);
+
+  nodes.Create (2);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (5.0 * i, 0, 0));
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  NetDeviceContainer vlcDevices = helper.Install (nodes);
+  helper.AssociateToVpan (vlcDevices, 0);
+  helper.AssignStreams (vlcDevices, 0);
+
+  InternetStackHelper internet;
+  internet.SetIpv4StackInstall (false);
+  internet.Install (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodes.Get (i)->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+    }
+  return helper.InstallSixLowPan (vlcDevices);
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Net Device Protocol Test
+ *
+ * Tests the MTU, the protocol numbers carried in the LLC/SNAP header and
+ * SendFrom of the VlcNetDevice.
+ */
+class VlcNetDeviceProtocolTestCase : public TestCase
+{
+public:
+  VlcNetDeviceProtocolTestCase ();
+  virtual ~VlcNetDeviceProtocolTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a packet delivered to a protocol handler.
+   *
+   * \param device the device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the source address
+   * \param to the destination address
+   * \param type the packet type
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType type);
+
+  std::vector<std::pair<uint16_t, uint32_t> > m_received; //!< the protocols and sizes of the received packets
+};
+
+VlcNetDeviceProtocolTestCase::VlcNetDeviceProtocolTestCase ()
+  : TestCase ("Test the protocol numbers and SendFrom of the VLC net device")
+{
+}
+
+VlcNetDeviceProtocolTestCase::~VlcNetDeviceProtocolTestCase ()
+{
+}
+
+void
+VlcNetDeviceProtocolTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                                       const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  m_received.push_back (std::make_pair (protocol, p->GetSize ()));
+}
+
+void
+VlcNetDeviceProtocolTestCase::DoRun (void)
+{
+  // Test setup:
+  // Two devices carry the protocol numbers in an LLC/SNAP header. The
+  // receiving node has a handler for each of two protocols.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  VlcHelper helper;
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  helper.SetChannel (channel);
+  NodeContainer nodes;
+  nodes.Create (2);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (5.0 * i, 0, 0));
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  NetDeviceContainer devices = helper.Install (nodes);
+  helper.AssociateToVpan (devices, 0);
+  Ptr<NetDevice> sender = devices.Get (0);
+  Ptr<NetDevice> receiver = devices.Get (1);
+
+  // The default PHY carries PSDUs of 200 octets, 13 of which are taken by the
+  // MAC header and the FCS.
+  NS_TEST_ASSERT_MSG_EQ (sender->GetMtu (), 187, "Wrong MTU");
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetAttribute ("UseLlcSnap", BooleanValue (true));
+    }
+  NS_TEST_ASSERT_MSG_EQ (sender->GetMtu (), 179, "LLC/SNAP header not accounted in the MTU");
+  NS_TEST_ASSERT_MSG_EQ (sender->SetMtu (180), false, "MTU larger than the largest MSDU accepted");
+  NS_TEST_ASSERT_MSG_EQ (sender->SetMtu (100), true, "Smaller MTU rejected");
+  NS_TEST_ASSERT_MSG_EQ (sender->GetMtu (), 100, "Smaller MTU not used");
+  NS_TEST_ASSERT_MSG_EQ (sender->SetMtu (0), true, "Largest MTU rejected");
+  NS_TEST_ASSERT_MSG_EQ (sender->GetMtu (), 179, "Largest MTU not restored");
+  DynamicCast<VlcNetDevice> (sender)->GetPhy ()->SetAttribute ("MaxPsduSize", UintegerValue (15));
+  NS_TEST_ASSERT_MSG_EQ (sender->GetMtu (), 0, "MTU wrapped around below the MAC overhead");
+  DynamicCast<VlcNetDevice> (sender)->GetPhy ()->SetAttribute ("MaxPsduSize", UintegerValue (200));
+
+  nodes.Get (1)->RegisterProtocolHandler (MakeCallback (&VlcNetDeviceProtocolTestCase::Receive, this),
+                                          0x1234, receiver);
+  nodes.Get (1)->RegisterProtocolHandler (MakeCallback (&VlcNetDeviceProtocolTestCase::Receive, this),
+                                          0x86DD, receiver);
+
+  NS_TEST_ASSERT_MSG_EQ (sender->Send (Create<Packet> (180), receiver->GetAddress (), 0x1234), false,
+                         "Packet larger than the MTU sent");
+  NS_TEST_ASSERT_MSG_EQ (sender->SendFrom (Create<Packet> (10), Mac16Address ("00:07"), receiver->GetAddress (), 0x1234),
+                         false, "Packet sent from a foreign address");
+  NS_TEST_ASSERT_MSG_EQ (sender->SupportsSendFrom (), false, "Bridging supported");
+  Simulator::Schedule (MilliSeconds (1), &NetDevice::Send, sender, Create<Packet> (179), receiver->GetAddress (), 0x1234);
+  Simulator::Schedule (MilliSeconds (2), &NetDevice::SendFrom, sender, Create<Packet> (20),
+                       sender->GetAddress (), receiver->GetAddress (), 0x86DD);
+  Simulator::Schedule (MilliSeconds (3), &NetDevice::Send, sender, Create<Packet> (30), receiver->GetAddress (), 0x0800);
+
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "Wrong number of packets delivered");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0].first, 0x1234, "Wrong protocol of the first packet");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0].second, 179, "Wrong size of the first packet");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1].first, 0x86DD, "Wrong protocol of the second packet");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1].second, 20, "Wrong size of the second packet");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc 6LoWPAN Test
+ *
+ * Tests UDP over IPv6 over 6LoWPAN over a VLC link, with datagrams that fit
+ * in a frame and datagrams that must be fragmented.
+ */
+class VlcSixLowPanTestCase : public TestCase
+{
+public:
+  VlcSixLowPanTestCase ();
+  virtual ~VlcSixLowPanTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Send a datagram.
+   *
+   * \param socket the socket
+   * \param payloadSize the size of the UDP payload
+   */
+  void SendDatagram (Ptr<Socket> socket, uint32_t payloadSize);
+
+  /**
+   * Record the datagrams received by a socket.
+   *
+   * \param socket the socket
+   */
+  void ReceiveDatagrams (Ptr<Socket> socket);
+
+  /**
+   * Record a frame sent by the 6LoWPAN device of the sender.
+   *
+   * \param p the frame, including the 6LoWPAN headers
+   * \param device the 6LoWPAN device
+   * \param ifIndex the interface index
+   */
+  void SixLowPanTx (Ptr<const Packet> p, Ptr<SixLowPanNetDevice> device, uint32_t ifIndex);
+
+  std::vector<uint32_t> m_received;                    //!< the sizes of the received datagrams
+  std::vector<std::pair<Time, uint32_t> > m_frames;    //!< the times and sizes of the frames sent
+};
+
+VlcSixLowPanTestCase::VlcSixLowPanTestCase ()
+  : TestCase ("Test UDP over IPv6 over 6LoWPAN over a VLC link")
+{
+}
+
+VlcSixLowPanTestCase::~VlcSixLowPanTestCase ()
+{
+}
+
+void
+VlcSixLowPanTestCase::SendDatagram (Ptr<Socket> socket, uint32_t payloadSize)
+{
+  socket->Send (Create<Packet> (payloadSize));
+}
+
+void
+VlcSixLowPanTestCase::ReceiveDatagrams (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      m_received.push_back (p->GetSize ());
+    }
+}
+
+void
+VlcSixLowPanTestCase::SixLowPanTx (Ptr<const Packet> p, Ptr<SixLowPanNetDevice> device, uint32_t ifIndex)
+{
+  m_frames.push_back (std::make_pair (Simulator::Now (), p->GetSize ()));
+}
+
+void
+VlcSixLowPanTestCase::DoRun (void)
+{
+  // Test setup:
+  // A node sends a UDP datagram of 20 octets, which fits in one frame once
+  // compressed, and one of 400 octets, which is split into 6LoWPAN
+  // fragments, to another node.
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  VlcHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = CreateSixLowPanLink (helper, nodes);
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:2::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer interfaces = ipv6.Assign (devices);
+  NS_TEST_ASSERT_MSG_EQ (devices.Get (0)->GetMtu (), 1280, "IPv6 minimum MTU not offered");
+  devices.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&VlcSixLowPanTestCase::SixLowPanTx, this));
+
+  TypeId tid = UdpSocketFactory::GetTypeId ();
+  Ptr<Socket> receiver = Socket::CreateSocket (nodes.Get (1), tid);
+  receiver->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  receiver->SetRecvCallback (MakeCallback (&VlcSixLowPanTestCase::ReceiveDatagrams, this));
+  Ptr<Socket> sender = Socket::CreateSocket (nodes.Get (0), tid);
+  sender->Bind6 ();
+  sender->Connect (Inet6SocketAddress (interfaces.GetAddress (1, 1), 1234));
+
+  Simulator::Schedule (MilliSeconds (100), &VlcSixLowPanTestCase::SendDatagram, this, sender, 20);
+  Simulator::Schedule (MilliSeconds (200), &VlcSixLowPanTestCase::SendDatagram, this, sender, 400);
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "Wrong number of datagrams received");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], 20, "Wrong size of the small datagram");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 400, "Wrong size of the fragmented datagram");
+
+  // The small datagram is sent in one compressed frame, after the neighbor
+  // discovery, the large one in fragments that fit in the MTU.
+  uint32_t mtu = DynamicCast<SixLowPanNetDevice> (devices.Get (0))->GetNetDevice ()->GetMtu ();
+  uint32_t smallFrame = 0;
+  uint32_t nFragments = 0;
+  uint32_t fragmentedSize = 0;
+  for (uint32_t i = 0; i < m_frames.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_frames[i].second, mtu, "Frame larger than the MTU");
+      if (m_frames[i].first < MilliSeconds (200))
+        {
+          smallFrame = m_frames[i].second;
+        }
+      else
+        {
+          nFragments++;
+          fragmentedSize += m_frames[i].second;
+        }
+    }
+  // Uncompressed, the small datagram takes 1 + 40 + 8 + 20 octets.
+  NS_TEST_ASSERT_MSG_GT (smallFrame, 20, "Small datagram not sent");
+  NS_TEST_ASSERT_MSG_LT (smallFrame, 69 - 8, "Small datagram not compressed");
+  NS_TEST_ASSERT_MSG_GT (nFragments, 2, "Large datagram not fragmented");
+  NS_TEST_ASSERT_MSG_GT (fragmentedSize, 400, "Fragments do not carry the datagram");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc 6LoWPAN TestSuite
+ */
+class VlcSixLowPanTestSuite : public TestSuite
+{
+public:
+  VlcSixLowPanTestSuite ();
+};
+
+VlcSixLowPanTestSuite::VlcSixLowPanTestSuite ()
+  : TestSuite ("vlc-sixlowpan", UNIT)
+{
+  AddTestCase (new VlcNetDeviceProtocolTestCase, TestCase::QUICK);
+  AddTestCase (new VlcSixLowPanTestCase, TestCase::QUICK);
+}
+
+static VlcSixLowPanTestSuite g_vlcSixLowPanTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc 6LoWPAN Benchmark
+ *
+ * Measures the UDP goodput over a saturated VLC link, with uncompressed
+ * IPv6 headers, HC1 and IPHC. The nodes use their link-local addresses,
+ * which both schemes derive from the MAC addresses. The sender keeps a few
+ * MSDUs in the MAC queue, so that no fragment is dropped by the queue.
+ */
+class VlcSixLowPanBenchmarkTestCase : public TestCase
+{
+public:
+  VlcSixLowPanBenchmarkTestCase ();
+  virtual ~VlcSixLowPanBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// The header compression schemes
+  enum Compression
+  {
+    UNCOMPRESSED,
+    HC1,
+    IPHC
+  };
+
+  /**
+   * Run a saturated UDP flow.
+   *
+   * \param compression the header compression scheme
+   * \param payloadSize the size of the UDP payload
+   */
+  void Run (enum Compression compression, uint32_t payloadSize);
+
+  /**
+   * Send a datagram unless the MAC queue already holds a few MSDUs, and
+   * check again a bit later.
+   *
+   * \param socket the socket
+   * \param queue the MAC queue of the sender
+   * \param payloadSize the size of the UDP payload
+   */
+  void SendDatagram (Ptr<Socket> socket, Ptr<VlcMacQueue> queue, uint32_t payloadSize);
+
+  /**
+   * Count the datagrams received by a socket.
+   *
+   * \param socket the socket
+   */
+  void ReceiveDatagrams (Ptr<Socket> socket);
+
+  /**
+   * Count the octets sent by the 6LoWPAN device of the sender.
+   *
+   * \param p the frame, including the 6LoWPAN headers
+   * \param device the 6LoWPAN device
+   * \param ifIndex the interface index
+   */
+  void SixLowPanTx (Ptr<const Packet> p, Ptr<SixLowPanNetDevice> device, uint32_t ifIndex);
+
+  uint32_t m_sent;          //!< the number of datagrams sent
+  uint64_t m_receivedBytes; //!< the payload octets received
+  uint64_t m_txBytes;       //!< the octets handed to the VLC device
+  Time m_start;             //!< the start of the measurement
+  Time m_stop;              //!< the end of the flow
+};
+
+VlcSixLowPanBenchmarkTestCase::VlcSixLowPanBenchmarkTestCase ()
+  : TestCase ("Benchmark the UDP goodput with and without header compression")
+{
+}
+
+VlcSixLowPanBenchmarkTestCase::~VlcSixLowPanBenchmarkTestCase ()
+{
+}
+
+void
+VlcSixLowPanBenchmarkTestCase::SendDatagram (Ptr<Socket> socket, Ptr<VlcMacQueue> queue, uint32_t payloadSize)
+{
+  if (Simulator::Now () >= m_stop)
+    {
+      return;
+    }
+  if (queue->GetNPackets () < 4)
+    {
+      socket->Send (Create<Packet> (payloadSize));
+      if (Simulator::Now () >= m_start)
+        {
+          m_sent++;
+        }
+    }
+  Simulator::Schedule (MicroSeconds (50), &VlcSixLowPanBenchmarkTestCase::SendDatagram, this, socket, queue, payloadSize);
+}
+
+void
+VlcSixLowPanBenchmarkTestCase::ReceiveDatagrams (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      if (Simulator::Now () >= m_start)
+        {
+          m_receivedBytes += p->GetSize ();
+        }
+    }
+}
+
+void
+VlcSixLowPanBenchmarkTestCase::SixLowPanTx (Ptr<const Packet> p, Ptr<SixLowPanNetDevice> device, uint32_t ifIndex)
+{
+  if (Simulator::Now () >= m_start)
+    {
+      m_txBytes += p->GetSize ();
+    }
+}
+
+void
+VlcSixLowPanBenchmarkTestCase::Run (enum Compression compression, uint32_t payloadSize)
+{
+  m_sent = 0;
+  m_receivedBytes = 0;
+  m_txBytes = 0;
+  m_start = MilliSeconds (100);
+  m_stop = m_start + Seconds (2);
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (6);
+
+  VlcHelper helper;
+  if (compression == UNCOMPRESSED)
+    {
+      // Compressed packets below the threshold are sent uncompressed.
+      helper.SetSixLowPanAttribute ("CompressionThreshold", UintegerValue (65535));
+    }
+  helper.SetSixLowPanAttribute ("Rfc6282", BooleanValue (compression != HC1));
+  helper.SetSixLowPanAttribute ("OmitUdpChecksum", BooleanValue (false));
+  NodeContainer nodes;
+  NetDeviceContainer devices = CreateSixLowPanLink (helper, nodes);
+  Ipv6AddressHelper ipv6;
+  ipv6.AssignWithoutAddress (devices);
+  devices.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&VlcSixLowPanBenchmarkTestCase::SixLowPanTx, this));
+
+  TypeId tid = UdpSocketFactory::GetTypeId ();
+  Ptr<Socket> receiver = Socket::CreateSocket (nodes.Get (1), tid);
+  receiver->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  receiver->SetRecvCallback (MakeCallback (&VlcSixLowPanBenchmarkTestCase::ReceiveDatagrams, this));
+  Ptr<Socket> sender = Socket::CreateSocket (nodes.Get (0), tid);
+  sender->Bind6 ();
+  sender->BindToNetDevice (devices.Get (0));
+  Ipv6Address destination = Ipv6Address::MakeAutoconfiguredLinkLocalAddress (Mac16Address::ConvertFrom (devices.Get (1)->GetAddress ()));
+  sender->Connect (Inet6SocketAddress (destination, 1234));
+
+  Ptr<VlcMacQueue> queue = DynamicCast<VlcNetDevice> (DynamicCast<SixLowPanNetDevice> (devices.Get (0))->GetNetDevice ())->GetMac ()->GetTxQueue ();
+  // The datagrams sent before the neighbor is resolved are not measured.
+  Simulator::Schedule (MilliSeconds (10), &VlcSixLowPanBenchmarkTestCase::SendDatagram, this, sender, queue, payloadSize);
+  Simulator::Stop (m_stop);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+VlcSixLowPanBenchmarkTestCase::DoRun (void)
+{
+  const char *names[] = {"uncompressed", "HC1", "IPHC"};
+  uint32_t payloadSizes[] = {10, 50, 100, 500};
+
+  std::cout << std::setw (15) << "header"
+            << std::setw (15) << "payload"
+            << std::setw (20) << "octets/datagram"
+            << std::setw (20) << "goodput (kb/s)"
+            << std::setw (15) << "wall (ms)" << std::endl;
+  for (uint32_t i = 0; i < sizeof (payloadSizes) / sizeof (payloadSizes[0]); i++)
+    {
+      double goodput[IPHC + 1];
+      for (uint32_t compression = UNCOMPRESSED; compression <= IPHC; compression++)
+        {
+          SystemWallClockMs clock;
+          clock.Start ();
+          Run (static_cast<enum Compression> (compression), payloadSizes[i]);
+          int64_t wallMs = clock.End ();
+
+          goodput[compression] = m_receivedBytes * 8 / (m_stop - m_start).GetSeconds () / 1e3;
+          std::cout << std::setw (15) << names[compression]
+                    << std::setw (15) << payloadSizes[i]
+                    << std::setw (20) << static_cast<double> (m_txBytes) / m_sent
+                    << std::setw (20) << goodput[compression]
+                    << std::setw (15) << wallMs << std::endl;
+        }
+      NS_TEST_EXPECT_MSG_GT (goodput[IPHC], goodput[UNCOMPRESSED], "IPHC does not improve the goodput");
+    }
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc 6LoWPAN Benchmark TestSuite
+ */
+class VlcSixLowPanBenchmarkTestSuite : public TestSuite
+{
+public:
+  VlcSixLowPanBenchmarkTestSuite ();
+};
+
+VlcSixLowPanBenchmarkTestSuite::VlcSixLowPanBenchmarkTestSuite ()
+  : TestSuite ("vlc-sixlowpan-benchmark", PERFORMANCE)
+{
+  AddTestCase (new VlcSixLowPanBenchmarkTestCase, TestCase::QUICK);
+}
+
+static VlcSixLowPanBenchmarkTestSuite g_vlcSixLowPanBenchmarkTestSuite; //!< Static variable for test initialization
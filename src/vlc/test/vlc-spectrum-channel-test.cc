@@ -0,0 +1,239 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/vector.h>
+#include <ns3/box.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/antenna-model.h>
+#include <ns3/net-device.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/vlc-spectrum-channel.h>
+#include <ns3/vlc-spectrum-value-helper.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief SpectrumPhy counting the received signals
+ */
+class VlcCountingPhy : public SpectrumPhy
+{
+public:
+  VlcCountingPhy ()
+    : m_rx (0)
+  {
+  }
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return 0;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_rx++;
+  }
+
+  uint32_t m_rx; //!< number of received signals
+
+private:
+  Ptr<MobilityModel> m_mobility; //!< the mobility model
+};
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Spectrum Channel Test
+ */
+class VlcSpectrumChannelTestCase : public TestCase
+{
+public:
+  VlcSpectrumChannelTestCase ();
+  virtual ~VlcSpectrumChannelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Transmit a signal from the first PHY and count the receptions.
+   *
+   * \return the number of PHYs that received the signal
+   */
+  uint32_t Transmit (void);
+
+  Ptr<VlcSpectrumChannel> m_channel;                   //!< the channel
+  std::vector<Ptr<VlcCountingPhy> > m_phys;            //!< the PHYs, the first one transmits
+};
+
+VlcSpectrumChannelTestCase::VlcSpectrumChannelTestCase ()
+  : TestCase ("Test the receiver culling of the VLC spectrum channel")
+{
+}
+
+VlcSpectrumChannelTestCase::~VlcSpectrumChannelTestCase ()
+{
+}
+
+uint32_t
+VlcSpectrumChannelTestCase::Transmit (void)
+{
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      m_phys[i]->m_rx = 0;
+    }
+
+  VlcSpectrumValueHelper psdHelper;
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = psdHelper.CreateTxPowerSpectralDensity (0, 0);
+  params->duration = MilliSeconds (1);
+  params->txPhy = m_phys[0];
+  m_channel->StartTx (params);
+  Simulator::Run ();
+
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      received += m_phys[i]->m_rx;
+    }
+  return received;
+}
+
+void
+VlcSpectrumChannelTestCase::DoRun (void)
+{
+  m_channel = CreateObject<VlcSpectrumChannel> ();
+
+  // A luminaire at 3 m above a 10 x 10 grid of receivers with 2 m spacing.
+  Vector txPosition (9, 9, 3);
+  Ptr<VlcCountingPhy> tx = CreateObject<VlcCountingPhy> ();
+  Ptr<ConstantPositionMobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txMobility->SetPosition (txPosition);
+  tx->SetMobility (txMobility);
+  m_phys.push_back (tx);
+  m_channel->AddRx (tx);
+
+  std::vector<Ptr<ConstantPositionMobilityModel> > mobility;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<VlcCountingPhy> phy = CreateObject<VlcCountingPhy> ();
+      m_channel->AddRx (phy);
+      // The mobility model is set after attaching the PHY to the channel.
+      Ptr<ConstantPositionMobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      m->SetPosition (Vector (2.0 * (i % 10), 2.0 * (i / 10), 0));
+      phy->SetMobility (m);
+      mobility.push_back (m);
+      m_phys.push_back (phy);
+    }
+
+  // Without a range, the channel behaves like a SingleModelSpectrumChannel.
+  NS_TEST_ASSERT_MSG_EQ (Transmit (), 100, "Not every receiver reached without culling");
+  NS_TEST_ASSERT_MSG_EQ (m_channel->GetNVisitedReceivers (), 100, "Wrong number of visited receivers");
+
+  double maxRange = 5.0;
+  double coneHalfAngle = 45.0;
+  m_channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  m_channel->SetAttribute ("CellSize", DoubleValue (3.0));
+  m_channel->SetAttribute ("TxNormal", VectorValue (Vector (0, 0, -1)));
+  m_channel->SetAttribute ("ConeHalfAngle", DoubleValue (coneHalfAngle));
+
+  uint32_t expected = 0;
+  for (uint32_t i = 0; i < mobility.size (); i++)
+    {
+      Vector los = mobility[i]->GetPosition () - txPosition;
+      if (los.GetLength () <= maxRange && -los.z / los.GetLength () >= std::cos (coneHalfAngle * M_PI / 180.0))
+        {
+          expected++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (expected, 0, "Test geometry without receivers in range");
+  NS_TEST_ASSERT_MSG_EQ (Transmit (), expected, "Wrong number of receivers in the illumination cone");
+  NS_TEST_ASSERT_MSG_EQ (m_channel->GetNVisitedReceivers (), expected, "Culled receivers visited");
+
+  // Moving a receiver right below the luminaire adds it to the reached ones.
+  mobility[0]->SetPosition (Vector (9, 9, 0));
+  NS_TEST_ASSERT_MSG_EQ (Transmit (), expected + 1, "Moved receiver not reached");
+
+  // A wall at x = 9.5 blocks the receivers on the other side.
+  m_channel->AddRoom (Box (-10, 9.5, -10, 30, -1, 4));
+  m_channel->AddRoom (Box (9.5, 30, -10, 30, -1, 4));
+  uint32_t sameRoom = 0;
+  for (uint32_t i = 1; i < m_phys.size (); i++)
+    {
+      if (m_phys[i]->m_rx > 0 && m_phys[i]->GetMobility ()->GetPosition ().x < 9.5)
+        {
+          sameRoom++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (Transmit (), sameRoom, "Light passed a wall");
+
+  m_phys.clear ();
+  m_channel->Dispose ();
+  m_channel = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Vlc Spectrum Channel TestSuite
+ */
+class VlcSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  VlcSpectrumChannelTestSuite ();
+};
+
+VlcSpectrumChannelTestSuite::VlcSpectrumChannelTestSuite ()
+  : TestSuite ("vlc-spectrum-channel", UNIT)
+{
+  AddTestCase (new VlcSpectrumChannelTestCase, TestCase::QUICK);
+}
+
+static VlcSpectrumChannelTestSuite g_vlcSpectrumChannelTestSuite; //!< Static variable for test initialization
@@ -19,6 +19,7 @@
 #include <ns3/test.h>
 #include <ns3/vlc-spectrum-value-helper.h>
 #include <ns3/spectrum-value.h>
+#include <ns3/spectrum-model.h>
 
 #include <cmath>
 
@@ -55,19 +56,90 @@ VlcSpectrumValueHelperTestCase::DoRun (void)
   VlcSpectrumValueHelper helper;
   Ptr<SpectrumValue> value;
   double pwrWatts;
-  for (uint32_t chan = 11; chan <= 26; chan++)
+  for (uint32_t chan = 0; chan < VlcSpectrumValueHelper::GetNChannels (); chan++)
     {
       // 50dBm = 100 W, -50dBm = 0.01 mW
       for (double pwrdBm = -50; pwrdBm < 50; pwrdBm += 10)
         {
           value = helper.CreateTxPowerSpectralDensity (pwrdBm, chan);
           pwrWatts = pow (10.0, pwrdBm / 10.0) / 1000;
-          // Test that average power calculation is within +/- 25% of expected
-          NS_TEST_ASSERT_MSG_EQ_TOL (helper.TotalAvgPower (value, chan), pwrWatts, pwrWatts / 4.0, "Not equal for channel " << chan << " pwrdBm " << pwrdBm);
+          // All power is within the colour band of the channel.
+          NS_TEST_ASSERT_MSG_EQ_TOL (helper.TotalAvgPower (value, chan), pwrWatts, pwrWatts * 1e-9, "Not equal for channel " << chan << " pwrdBm " << pwrdBm);
         }
     }
 }
 
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * \brief Test the mapping of the channels onto the colour bands
+ */
+class VlcSpectrumValueHelperChannelTestCase : public TestCase
+{
+public:
+  VlcSpectrumValueHelperChannelTestCase ();
+  virtual ~VlcSpectrumValueHelperChannelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcSpectrumValueHelperChannelTestCase::VlcSpectrumValueHelperChannelTestCase ()
+  : TestCase ("Test the channel indexing of the colour bands")
+{
+}
+
+VlcSpectrumValueHelperChannelTestCase::~VlcSpectrumValueHelperChannelTestCase ()
+{
+}
+
+void
+VlcSpectrumValueHelperChannelTestCase::DoRun (void)
+{
+  const double c = 299792458.0;
+  const double limits[] = { 380, 478, 540, 588, 633, 679, 726, 780 };
+
+  // One band per colour band of IEEE 802.15.7, band i is channel i.
+  Ptr<const SpectrumModel> model = VlcSpectrumValueHelper::GetSpectrumModel ();
+  NS_TEST_ASSERT_MSG_EQ (VlcSpectrumValueHelper::GetNChannels (), 7, "Wrong number of channels");
+  NS_TEST_ASSERT_MSG_EQ (model->GetNumBands (), 7, "Wrong number of bands");
+  uint32_t chan = 0;
+  for (Bands::const_iterator it = model->Begin (); it != model->End (); it++, chan++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (it->fh, c / (limits[chan] * 1e-9), 1e3, "Wrong upper limit of channel " << chan);
+      NS_TEST_ASSERT_MSG_EQ_TOL (it->fl, c / (limits[chan + 1] * 1e-9), 1e3, "Wrong lower limit of channel " << chan);
+    }
+
+  VlcSpectrumValueHelper helper;
+  for (chan = 0; chan < VlcSpectrumValueHelper::GetNChannels (); chan++)
+    {
+      Ptr<SpectrumValue> value = helper.CreateTxPowerSpectralDensity (0, chan);
+      for (uint32_t other = 0; other < VlcSpectrumValueHelper::GetNChannels (); other++)
+        {
+          if (other != chan)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((*value)[other], 0, "Power of channel " << chan << " in band " << other);
+              NS_TEST_ASSERT_MSG_EQ (helper.TotalAvgPower (value, other), 0, "Channel " << chan << " seen on channel " << other);
+            }
+        }
+
+      // An ideal filter only passes its own band, a leaky one passes a share
+      // of the neighbouring bands.
+      Ptr<SpectrumValue> ideal = VlcSpectrumValueHelper::CreateRxFilterResponse (chan, 0);
+      NS_TEST_ASSERT_MSG_EQ_TOL (helper.TotalAvgPower (value, *ideal), 1e-3, 1e-12, "Ideal filter of channel " << chan);
+      Ptr<SpectrumValue> leaky = VlcSpectrumValueHelper::CreateRxFilterResponse (chan, 0.1);
+      for (uint32_t other = 0; other < VlcSpectrumValueHelper::GetNChannels (); other++)
+        {
+          double expected = other == chan ? 1e-3 : (other + 1 == chan || other == chan + 1) ? 1e-4 : 0;
+          Ptr<SpectrumValue> filter = VlcSpectrumValueHelper::CreateRxFilterResponse (other, 0.1);
+          NS_TEST_ASSERT_MSG_EQ_TOL (helper.TotalAvgPower (value, *filter), expected, 1e-12,
+                                     "Channel " << chan << " behind the filter of channel " << other);
+        }
+      NS_TEST_ASSERT_MSG_EQ_TOL (helper.TotalAvgPower (value, *leaky), 1e-3, 1e-12, "Leaky filter of channel " << chan);
+    }
+}
+
 /**
  * \ingroup vlc-test
  * \ingroup tests
@@ -84,6 +156,7 @@ VlcSpectrumValueHelperTestSuite::VlcSpectrumValueHelperTestSuite ()
   : TestSuite ("vlc-spectrum-value-helper", UNIT)
 {
   AddTestCase (new VlcSpectrumValueHelperTestCase, TestCase::QUICK);
+  AddTestCase (new VlcSpectrumValueHelperChannelTestCase, TestCase::QUICK);
 }
 
 static VlcSpectrumValueHelperTestSuite g_vlcSpectrumValueHelperTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,246 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/simulator.h>
+#include <ns3/vlc-sweep-helper.h>
+
+#include <cmath>
+#include <sstream>
+#ifdef VLC_SWEEP_FORK
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+using namespace ns3;
+
+/**
+ * Trial returning the sweep value plus the run number.
+ * \param x the sweep value
+ * \param run the run number
+ * \return x + run
+ */
+static double
+VlcSweepLinearTrial (double x, uint32_t run)
+{
+  return x + run;
+}
+
+/**
+ * Trial returning a uniform sample drawn after a simulation.
+ * \param x the sweep value
+ * \param run the run number
+ * \return x plus a sample in [0, 1)
+ */
+static double
+VlcSweepRandomTrial (double x, uint32_t run)
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  double y = x + uniform->GetValue ();
+  Simulator::Destroy ();
+  return y;
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test the statistics of the sweep helper.
+ */
+class VlcSweepHelperStatisticsTestCase : public TestCase
+{
+public:
+  VlcSweepHelperStatisticsTestCase ();
+  virtual ~VlcSweepHelperStatisticsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcSweepHelperStatisticsTestCase::VlcSweepHelperStatisticsTestCase ()
+  : TestCase ("Test the mean and confidence interval of the sweep helper")
+{
+}
+
+VlcSweepHelperStatisticsTestCase::~VlcSweepHelperStatisticsTestCase ()
+{
+}
+
+void
+VlcSweepHelperStatisticsTestCase::DoRun (void)
+{
+  // Test setup: 11 points from 0 to 1, runs 1 to 5 each, on 3 workers.
+  VlcSweepHelper sweep;
+  sweep.SetTrialCallback (MakeCallback (&VlcSweepLinearTrial));
+  sweep.SetWorkers (3);
+  sweep.SetRuns (1, 5);
+  sweep.AddPoints (0, 1, 0.1);
+  sweep.Run ();
+
+  const std::vector<VlcSweepHelper::Result> &results = sweep.GetResults ();
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 11, "Wrong number of points");
+
+  // Runs 1..5 give a mean of x + 3 and a sample standard deviation of
+  // sqrt (2.5).
+  double halfWidth = 2.776 * std::sqrt (2.5) / std::sqrt (5.0);
+  for (uint32_t i = 0; i < results.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (results[i].x, i * 0.1, 1e-9, "Wrong sweep value");
+      NS_TEST_ASSERT_MSG_EQ (results[i].runs, 5, "Wrong number of runs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (results[i].mean, i * 0.1 + 3, 1e-9, "Wrong mean");
+      NS_TEST_ASSERT_MSG_EQ_TOL (results[i].halfWidth, halfWidth, 1e-9, "Wrong confidence interval");
+    }
+
+  std::ostringstream csv;
+  sweep.WriteCsv (csv);
+  NS_TEST_ASSERT_MSG_EQ (csv.str ().substr (0, 22), "x,mean,ci95,runs\n0,3,1", "Wrong CSV output");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test that the results do not depend on the number of workers.
+ */
+class VlcSweepHelperWorkersTestCase : public TestCase
+{
+public:
+  VlcSweepHelperWorkersTestCase ();
+  virtual ~VlcSweepHelperWorkersTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcSweepHelperWorkersTestCase::VlcSweepHelperWorkersTestCase ()
+  : TestCase ("Test that the sweep results do not depend on the number of workers")
+{
+}
+
+VlcSweepHelperWorkersTestCase::~VlcSweepHelperWorkersTestCase ()
+{
+}
+
+void
+VlcSweepHelperWorkersTestCase::DoRun (void)
+{
+  // Test setup: 4 points with 8 runs each, swept on 1 and on 4 workers.
+  std::vector<VlcSweepHelper::Result> results[2];
+  uint32_t workers[2] = { 1, 4 };
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      VlcSweepHelper sweep;
+      sweep.SetTrialCallback (MakeCallback (&VlcSweepRandomTrial));
+      sweep.SetWorkers (workers[k]);
+      sweep.SetRuns (1, 8);
+      sweep.AddPoints (0, 3, 1);
+      sweep.Run ();
+      results[k] = sweep.GetResults ();
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (results[0].size (), 4, "Wrong number of points");
+  NS_TEST_ASSERT_MSG_EQ (results[1].size (), 4, "Wrong number of points");
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (results[0][i].mean, results[1][i].mean, "Results depend on the number of workers");
+      NS_TEST_ASSERT_MSG_EQ (results[0][i].halfWidth, results[1][i].halfWidth, "Results depend on the number of workers");
+      NS_TEST_ASSERT_MSG_GT (results[0][i].halfWidth, 0, "Runs share the same random stream");
+    }
+  // Every point starts from the same stream state, so the spread around
+  // the sweep value is the same for every point.
+  NS_TEST_ASSERT_MSG_EQ_TOL (results[0][3].mean - results[0][0].mean, 3, 1e-9, "Trials are not independent of each other");
+}
+
+#ifdef VLC_SWEEP_FORK
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test that the sweep helper only reaps its own workers.
+ */
+class VlcSweepHelperChildrenTestCase : public TestCase
+{
+public:
+  VlcSweepHelperChildrenTestCase ();
+  virtual ~VlcSweepHelperChildrenTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VlcSweepHelperChildrenTestCase::VlcSweepHelperChildrenTestCase ()
+  : TestCase ("Test that the sweep helper leaves the other children of the caller alone")
+{
+}
+
+VlcSweepHelperChildrenTestCase::~VlcSweepHelperChildrenTestCase ()
+{
+}
+
+void
+VlcSweepHelperChildrenTestCase::DoRun (void)
+{
+  // Test setup: a child of the caller exits with status 7 while a sweep of
+  // 4 points is running on 2 workers.
+  pid_t child = fork ();
+  NS_TEST_ASSERT_MSG_NE (child, -1, "fork () failed");
+  if (child == 0)
+    {
+      _exit (7);
+    }
+
+  VlcSweepHelper sweep;
+  sweep.SetTrialCallback (MakeCallback (&VlcSweepRandomTrial));
+  sweep.SetWorkers (2);
+  sweep.SetRuns (1, 1);
+  sweep.AddPoints (0, 3, 1);
+  sweep.Run ();
+  NS_TEST_ASSERT_MSG_EQ (sweep.GetResults ().size (), 4, "Wrong number of points");
+
+  int status = 0;
+  NS_TEST_ASSERT_MSG_EQ (waitpid (child, &status, 0), child, "The sweep reaped a child of the caller");
+  NS_TEST_ASSERT_MSG_EQ (WIFEXITED (status) && WEXITSTATUS (status) == 7, true, "Wrong exit status of the child");
+}
+#endif
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Sweep helper test suite
+ */
+class VlcSweepHelperTestSuite : public TestSuite
+{
+public:
+  VlcSweepHelperTestSuite ();
+};
+
+VlcSweepHelperTestSuite::VlcSweepHelperTestSuite ()
+  : TestSuite ("vlc-sweep-helper", UNIT)
+{
+  AddTestCase (new VlcSweepHelperStatisticsTestCase, TestCase::QUICK);
+  AddTestCase (new VlcSweepHelperWorkersTestCase, TestCase::QUICK);
+#ifdef VLC_SWEEP_FORK
+  AddTestCase (new VlcSweepHelperChildrenTestCase, TestCase::QUICK);
+#endif
+}
+
+static VlcSweepHelperTestSuite g_vlcSweepHelperTestSuite; //!< Static variable for test initialization
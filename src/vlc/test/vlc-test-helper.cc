@@ -0,0 +1,79 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include "vlc-test-helper.h"
+#include <ns3/node.h>
+#include <ns3/mac16-address.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+
+namespace ns3 {
+
+std::vector<Ptr<VlcNetDevice> >
+CreateVlcTestDevices (const std::vector<Ptr<MobilityModel> > &mobility)
+{
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  std::vector<Ptr<VlcNetDevice> > devices;
+  for (uint32_t i = 0; i < mobility.size (); i++)
+    {
+      Ptr<Node> node = CreateObject <Node> ();
+      Ptr<VlcNetDevice> dev = CreateObject<VlcNetDevice> ();
+      dev->AssignStreams (10 * i);
+      uint8_t address[2] = {0, static_cast<uint8_t> (i + 1)};
+      Mac16Address shortAddress;
+      shortAddress.CopyFrom (address);
+      dev->SetAddress (shortAddress);
+      dev->SetChannel (channel);
+      node->AddDevice (dev);
+      dev->GetPhy ()->SetMobility (mobility[i]);
+      devices.push_back (dev);
+    }
+  return devices;
+}
+
+std::vector<Ptr<VlcNetDevice> >
+CreateVlcTestVpan (uint32_t nDevices)
+{
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i <= nDevices; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> model = CreateObject<ConstantPositionMobilityModel> ();
+      model->SetPosition (i == 0 ? Vector (0, 0, 0) : Vector (i % 3, 10, 0));
+      mobility.push_back (model);
+    }
+  return CreateVlcTestDevices (mobility);
+}
+
+std::vector<Ptr<VlcNetDevice> >
+CreateVlcTestLink (void)
+{
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> model = CreateObject<ConstantPositionMobilityModel> ();
+      model->SetPosition (Vector (0, 10 * i, 0));
+      mobility.push_back (model);
+    }
+  return CreateVlcTestDevices (mobility);
+}
+
+} // namespace ns3
@@ -0,0 +1,65 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#ifndef VLC_TEST_HELPER_H
+#define VLC_TEST_HELPER_H
+
+#include <ns3/ptr.h>
+#include <ns3/mobility-model.h>
+#include <ns3/vlc-net-device.h>
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup vlc-test
+ *
+ * Create a device per mobility model, with the short addresses 00:01,
+ * 00:02, ... in that order, on a shared channel with log-distance loss and
+ * a constant speed delay. The random streams of the i-th device start at
+ * 10 i.
+ *
+ * \param mobility the mobility models of the devices
+ * \return the devices
+ */
+std::vector<Ptr<VlcNetDevice> > CreateVlcTestDevices (const std::vector<Ptr<MobilityModel> > &mobility);
+
+/**
+ * \ingroup vlc-test
+ *
+ * Create a coordinator (00:01) and devices (00:02, ...) around it, well in
+ * communication range of each other.
+ *
+ * \param nDevices the number of devices besides the coordinator
+ * \return the coordinator followed by the devices
+ */
+std::vector<Ptr<VlcNetDevice> > CreateVlcTestVpan (uint32_t nDevices);
+
+/**
+ * \ingroup vlc-test
+ *
+ * Create two devices 10 m apart, 00:01 at the origin and 00:02 on the y
+ * axis.
+ *
+ * \return the two devices
+ */
+std::vector<Ptr<VlcNetDevice> > CreateVlcTestLink (void);
+
+} // namespace ns3
+
+#endif /* VLC_TEST_HELPER_H */
@@ -0,0 +1,194 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Abhay Sheel Anand <abhaysheelanand@gmail.com>
+ */
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/vlc-module.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/packet.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Test parallel links on the colour bands of a shared optical channel.
+ */
+class VlcWdmTestCase : public TestCase
+{
+public:
+  VlcWdmTestCase ();
+  virtual ~VlcWdmTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Saturate links between pairs of devices sharing an optical channel and
+   * count the frames received.
+   *
+   * \param channels the colour band of each link
+   * \param adjacentBandGain the gain of the filters of the receivers in the
+   * neighbouring bands
+   * \return the number of frames received over all links
+   */
+  uint32_t RunLinks (const std::vector<uint8_t> &channels, double adjacentBandGain);
+
+  /**
+   * Function called when a frame is received.
+   *
+   * \param params the MCPS params
+   * \param p the packet
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  uint32_t m_received;  //!< The number of frames received
+};
+
+VlcWdmTestCase::VlcWdmTestCase ()
+  : TestCase ("Test the aggregate throughput of links on several colour bands"),
+    m_received (0)
+{
+}
+
+VlcWdmTestCase::~VlcWdmTestCase ()
+{
+}
+
+void
+VlcWdmTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received++;
+}
+
+uint32_t
+VlcWdmTestCase::RunLinks (const std::vector<uint8_t> &channels, double adjacentBandGain)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (10);
+  m_received = 0;
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstVpanId = 0;
+  params.m_txOptions = 0;
+  for (uint32_t i = 0; i < channels.size (); i++)
+    {
+      // A sender and a receiver, all within range of each other.
+      Ptr<VlcNetDevice> devices[2];
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          Ptr<Node> node = CreateObject<Node> ();
+          devices[j] = CreateObject<VlcNetDevice> ();
+          devices[j]->AssignStreams (20 * i + 10 * j);
+          uint8_t address[2] = {0, static_cast<uint8_t> (2 * i + j + 1)};
+          Mac16Address shortAddress;
+          shortAddress.CopyFrom (address);
+          devices[j]->SetAddress (shortAddress);
+          devices[j]->SetChannel (channel);
+          node->AddDevice (devices[j]);
+          Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (j, i, 0));
+          devices[j]->GetPhy ()->SetMobility (mobility);
+
+          VlcPhyPibAttributes pib;
+          pib.phyCurrentChannel = channels[i];
+          devices[j]->GetPhy ()->PlmeSetAttributeRequest (phyCurrentChannel, &pib);
+          devices[j]->GetPhy ()->SetAdjacentBandGain (adjacentBandGain);
+        }
+      devices[1]->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&VlcWdmTestCase::DataIndication, this));
+
+      // Offer more frames than a single link carries.
+      params.m_dstAddr = Mac16Address::ConvertFrom (devices[1]->GetAddress ());
+      for (uint32_t k = 0; k < 200; k++)
+        {
+          params.m_msduHandle = k;
+          Simulator::Schedule (MicroSeconds (250 * k), &VlcMac::McpsDataRequest, devices[0]->GetMac (), params,
+                               Create<Packet> (100));
+        }
+    }
+
+  Simulator::Stop (MilliSeconds (50));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_received;
+}
+
+void
+VlcWdmTestCase::DoRun (void)
+{
+  // Test setup:
+  // Saturated links share an optical channel. On different colour bands,
+  // behind ideal filters, they do not interfere and the aggregate
+  // throughput scales with the number of colours. On the same colour band
+  // they share the capacity of a single link. Filters passing the
+  // neighbouring bands let adjacent colours interfere again.
+  std::vector<uint8_t> channels (1, 1);
+  uint32_t single = RunLinks (channels, 0);
+  NS_TEST_ASSERT_MSG_GT (single, 0, "No frame received on a single link");
+
+  channels.clear ();
+  for (uint8_t i = 0; i < 3; i++)
+    {
+      channels.push_back (2 * i);
+    }
+  uint32_t colours = RunLinks (channels, 0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (colours, 3 * single, 0.05 * 3 * single, "Throughput not scaling with the number of colours");
+
+  channels.assign (3, 1);
+  uint32_t shared = RunLinks (channels, 0);
+  NS_TEST_ASSERT_MSG_LT (shared, 1.5 * single, "Links on the same colour not sharing the capacity");
+
+  channels.clear ();
+  for (uint8_t i = 0; i < 3; i++)
+    {
+      channels.push_back (i + 1);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (RunLinks (channels, 0), 3 * single, 0.05 * 3 * single, "Adjacent colours interfering behind ideal filters");
+  NS_TEST_ASSERT_MSG_LT (RunLinks (channels, 1), 0.9 * 3 * single, "Adjacent colours not interfering behind leaky filters");
+}
+
+/**
+ * \ingroup vlc-test
+ * \ingroup tests
+ *
+ * Wavelength division multiplexing test suite
+ */
+class VlcWdmTestSuite : public TestSuite
+{
+public:
+  VlcWdmTestSuite ();
+};
+
+VlcWdmTestSuite::VlcWdmTestSuite ()
+  : TestSuite ("vlc-wdm", UNIT)
+{
+  AddTestCase (new VlcWdmTestCase, TestCase::QUICK);
+}
+
+static VlcWdmTestSuite g_vlcWdmTestSuite; //!< Static variable for test initialization